@@ -26,6 +26,10 @@
 */
 
 XPArray_PT xparray_new(int size) {
+    return xparray_new_allocator(size, NULL);
+}
+
+XPArray_PT xparray_new_allocator(int size, XMem_Allocator_PT allocator) {
     xassert(0 <= size);
 
     if (size < 0) {
@@ -33,20 +37,21 @@ XPArray_PT xparray_new(int size) {
     }
 
     {
-        XPArray_PT array = XMEM_CALLOC(1, sizeof(*array));
+        XPArray_PT array = XMEM_ALLOC_BY(allocator, sizeof(*array));
         if (!array) {
             return NULL;
         }
 
         if (0 < size) {
-            array->datas = XMEM_CALLOC(size, sizeof(void*));
+            array->datas = XMEM_ALLOC_BY(allocator, size * sizeof(void*));
             if (!array->datas) {
-                XMEM_FREE(array);
+                XMEM_FREE_BY(allocator, array, sizeof(*array));
                 return NULL;
             }
         }
 
         array->size = size;
+        array->allocator = allocator;
 
         return array;
     }
@@ -54,7 +59,7 @@ XPArray_PT xparray_new(int size) {
 
 XPArray_PT xparray_copyn_impl(XPArray_PT array, int start, int count, int elem_size, bool deep) {
     /* keep the new array the same size as source array */
-    XPArray_PT narray = xparray_new(array->size);
+    XPArray_PT narray = xparray_new_allocator(array->size, array->allocator);
     if (!narray) {
         return NULL;
     }
@@ -535,7 +540,7 @@ void xparray_free_datas_impl(XPArray_PT array, bool deep, bool (*apply)(void *x,
             }
         }
 
-        XMEM_FREE(array->datas);
+        XMEM_FREE_BY(array->allocator, array->datas, array->size * sizeof(void*));
         array->size = 0;
     }
 }
@@ -545,7 +550,7 @@ void xparray_free(XPArray_PT *parray) {
         return;
     }
     xparray_free_datas_impl(*parray, false, NULL, NULL);
-    XMEM_FREE(*parray);
+    XMEM_FREE_BY((*parray)->allocator, *parray, sizeof(**parray));
 }
 
 void xparray_free_apply(XPArray_PT *parray, bool (*apply)(void *x, void *cl), void *cl) {
@@ -553,7 +558,7 @@ void xparray_free_apply(XPArray_PT *parray, bool (*apply)(void *x, void *cl), vo
         return;
     }
     xparray_free_datas_impl(*parray, false, apply, cl);
-    XMEM_FREE(*parray);
+    XMEM_FREE_BY((*parray)->allocator, *parray, sizeof(**parray));
 }
 
 void xparray_deep_free(XPArray_PT *parray) {
@@ -561,7 +566,7 @@ void xparray_deep_free(XPArray_PT *parray) {
         return;
     }
     xparray_free_datas_impl(*parray, true, NULL, NULL);
-    XMEM_FREE(*parray);
+    XMEM_FREE_BY((*parray)->allocator, *parray, sizeof(**parray));
 }
 
 static
@@ -663,7 +668,7 @@ bool xparray_resize_impl_apply(XPArray_PT array, int new_size, bool deep) {
         xparray_free_datas_impl(array, deep, NULL, NULL);
     }
     else if (array->size == 0) {
-        array->datas = XMEM_CALLOC(new_size, sizeof(void*));
+        array->datas = XMEM_ALLOC_BY(array->allocator, new_size * sizeof(void*));
         if (!array->datas) {
             return false;
         }
@@ -682,7 +687,7 @@ bool xparray_resize_impl_apply(XPArray_PT array, int new_size, bool deep) {
         }
 
         {
-            void* ndatas = xmem_resize(array->datas, (new_size * sizeof(void*)), __FILE__, __LINE__);
+            void* ndatas = XMEM_RESIZE_BY(array->allocator, array->datas, (array->size * sizeof(void*)), (new_size * sizeof(void*)));
             if (!ndatas) {
                 return false;
             }
@@ -759,8 +764,10 @@ bool xparray_is_empty(XPArray_PT array) {
 bool xparray_swap(XPArray_PT array1, XPArray_PT array2) {
     xassert(array1);
     xassert(array2);
+    /* datas can't move to an array which releases memory to another allocator */
+    xassert(array1->allocator == array2->allocator);
 
-    if (!array1 || !array2) {
+    if (!array1 || !array2 || (array1->allocator != array2->allocator)) {
         return false;
     }
 
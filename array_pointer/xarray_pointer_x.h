@@ -21,6 +21,8 @@ struct XPArray {
     void **datas;        /* memory to save the pointers */
 
     int    size;         /* capacity : how many pointers can be saved */
+
+    XMem_Allocator_PT allocator;  /* where datas and the array come from, NULL : XMEM */
 };
 
 /* O(N) */
@@ -27,6 +27,10 @@ XDigraph_PT xdigraph_new(int(*cmp)(void *vertex1, void *vertex2, void *cl), void
     return xgraph_new(cmp, cl);
 }
 
+XDigraph_PT xdigraph_new_allocator(int(*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    return xgraph_new_allocator(cmp, cl, allocator);
+}
+
 void xdigraph_free(XDigraph_PT *graph) {
     xgraph_free(graph);
 }
@@ -64,7 +68,7 @@ XDigraph_PT xdigraph_reverse(XDigraph_PT graph) {
     }
 
     {
-        XDigraph_PT ngraph = xdigraph_new(graph->cmp, graph->cl);
+        XDigraph_PT ngraph = xdigraph_new_allocator(graph->cmp, graph->cl, graph->allocator);
         if (!ngraph) {
             return NULL;
         }
@@ -954,7 +958,7 @@ XDList_PT xdigraph_all_strongly_connected_dfs(XDigraph_PT graph) {
 }
 
 bool xdigraph_is_strongly_connected_dfs(XDigraph_PT graph) {
-    XSet_PT ccset = xdigraph_strongly_connected_dfs(graph, xmap_select(graph ? graph->adjsets : NULL, 0));
+    XSet_PT ccset = xdigraph_strongly_connected_dfs(graph, xmap_min(graph ? graph->adjsets : NULL));
     int size = xset_size(ccset);
     xset_free(&ccset);
     return size == xdigraph_vertex_size(graph);
@@ -967,7 +971,7 @@ bool xdigraph_is_connected_dfs(XDigraph_PT graph) {
     }
 
     {
-        XSet_PT ccset = xgraph_union_dfs(ngraph, xmap_select(ngraph->adjsets, 0));
+        XSet_PT ccset = xgraph_union_dfs(ngraph, xmap_min(ngraph->adjsets));
         int size = xset_size(ccset);
 
         if (ccset) {
@@ -1016,7 +1020,7 @@ XDigraph_PT xdigraph_transitive_closure(XDigraph_PT graph) {
     }
 
     {
-        XDigraph_PT ngraph = xdigraph_new(graph->cmp, graph->cl);
+        XDigraph_PT ngraph = xdigraph_new_allocator(graph->cmp, graph->cl, graph->allocator);
         if (!ngraph) {
             return NULL;
         }
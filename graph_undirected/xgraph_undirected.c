@@ -26,6 +26,10 @@
 #include "xgraph_undirected_x.h"
 
 XGraph_PT xgraph_new(int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl) {
+    return xgraph_new_allocator(cmp, cl, NULL);
+}
+
+XGraph_PT xgraph_new_allocator(int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     xassert(cmp);
 
     if (!cmp) {
@@ -33,19 +37,20 @@ XGraph_PT xgraph_new(int (*cmp)(void *vertex1, void *vertex2, void *cl), void *c
     }
 
     {
-        XGraph_PT graph = (XGraph_PT)XMEM_CALLOC(1, sizeof(*graph));
+        XGraph_PT graph = (XGraph_PT)XMEM_ALLOC_BY(allocator, sizeof(*graph));
         if (!graph) {
             return NULL;
         }
 
-        graph->adjsets = xmap_new(cmp, cl);
+        graph->adjsets = xmap_new_allocator(cmp, cl, allocator);
         if (!graph->adjsets) {
-            XMEM_FREE(graph);
+            XMEM_FREE_BY(allocator, graph, sizeof(*graph));
             return NULL;
         }
 
         graph->cmp = cmp;
         graph->cl = cl;
+        graph->allocator = allocator;
 
         return graph;
     }
@@ -69,7 +74,7 @@ void xgraph_free(XGraph_PT *graph) {
     }
 
     xgraph_free_impl(*graph, false);
-    XMEM_FREE(*graph);
+    XMEM_FREE_BY((*graph)->allocator, *graph, sizeof(**graph));
 }
 
 void xgraph_deep_free(XGraph_PT *graph) {
@@ -78,7 +83,7 @@ void xgraph_deep_free(XGraph_PT *graph) {
     }
 
     xgraph_free_impl(*graph, true);
-    XMEM_FREE(*graph);
+    XMEM_FREE_BY((*graph)->allocator, *graph, sizeof(**graph));
 }
 
 static
@@ -106,7 +111,7 @@ XGraph_PT xgraph_copy(XGraph_PT graph) {
     }
 
     {
-        XGraph_PT ngraph = xgraph_new(graph->cmp, graph->cl);
+        XGraph_PT ngraph = xgraph_new_allocator(graph->cmp, graph->cl, graph->allocator);
         if (!ngraph) {
             return NULL;
         }
@@ -122,7 +127,7 @@ XGraph_PT xgraph_copy(XGraph_PT graph) {
 
 bool xgraph_add_vertex(XGraph_PT graph, void *vertex) {
     if (!xmap_find(graph ? graph->adjsets : NULL, vertex)) {
-        XSet_PT adjset = xset_new(graph->cmp, graph->cl);
+        XSet_PT adjset = xset_new_allocator(graph->cmp, graph->cl, graph->allocator);
         if (!adjset) {
             return false;
         }
@@ -1482,7 +1487,7 @@ bool xgraph_is_tree(XGraph_PT graph) {
 
     /* check if all vertexes are connected */
     {
-        XSet_PT ccset = xgraph_union_dfs(graph, xmap_select(graph->adjsets, 0));
+        XSet_PT ccset = xgraph_union_dfs(graph, xmap_min(graph->adjsets));
         if (ccset) {
             int size = xset_size(ccset);
             xset_free(&ccset);
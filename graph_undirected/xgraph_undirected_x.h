@@ -22,6 +22,8 @@ struct XGraph {
 
     int (*cmp)(void *vertex1, void *vertex2, void *cl);
     void *cl;
+
+    XMem_Allocator_PT allocator;  /* the graph, adjsets and all the XSet_PT in it come from it, NULL : XMEM */
 };
 
 /* used for internal implementations */
@@ -33,6 +33,10 @@ XWDigraph_PT xwdigraph_new(int (*cmp)(void *vertex1, void *vertex2, void *cl), v
     return xwgraph_new(cmp, cl);
 }
 
+XWDigraph_PT xwdigraph_new_allocator(int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    return xwgraph_new_allocator(cmp, cl, allocator);
+}
+
 XDigraph_PT xwgraph_native_digraph(XWDigraph_PT graph) {
     return graph ? graph->native_graph : NULL;
 }
@@ -57,7 +61,7 @@ bool xwdigraph_add_edge_repeat(XWDigraph_PT graph, void *svertex, void *tvertex,
     {
         XSet_PT adjset_vertex = xwdigraph_adjset(graph, svertex);
         if (!adjset_vertex) {
-            adjset_vertex = xset_new(xwedge_cmp_directed, graph->native_graph->cl);
+            adjset_vertex = xset_new_allocator(xwedge_cmp_directed, graph->native_graph->cl, graph->native_graph->allocator);
             if (!adjset_vertex) {
                 return false;
             }
@@ -29,21 +29,25 @@
 #include "xgraph_weight_undirected_x.h"
 
 XWGraph_PT xwgraph_new(int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl) {
-    XWGraph_PT graph = (XWGraph_PT)XMEM_CALLOC(1, sizeof(*graph));
+    return xwgraph_new_allocator(cmp, cl, NULL);
+}
+
+XWGraph_PT xwgraph_new_allocator(int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    XWGraph_PT graph = (XWGraph_PT)XMEM_ALLOC_BY(allocator, sizeof(*graph));
     if (!graph) {
         return NULL;
     }
 
-    graph->wadjsets = xmap_new(cmp, cl);
+    graph->wadjsets = xmap_new_allocator(cmp, cl, allocator);
     if (!graph->wadjsets) {
-        XMEM_FREE(graph);
+        XMEM_FREE_BY(allocator, graph, sizeof(*graph));
         return NULL;
     }
 
-    graph->native_graph = xgraph_new(cmp, cl);
+    graph->native_graph = xgraph_new_allocator(cmp, cl, allocator);
     if (!graph->native_graph) {
         xmap_free(&graph->wadjsets);
-        XMEM_FREE(graph);
+        XMEM_FREE_BY(allocator, graph, sizeof(*graph));
         return NULL;
     }
 
@@ -69,12 +73,14 @@ bool xwgraph_free_vertex_adjsets_apply(void *vertex, void **adjset, void *cl) {
 
 void xwgraph_free(XWGraph_PT *graph) {
     if (graph && *graph) {
+        XMem_Allocator_PT allocator = (*graph)->native_graph->allocator;
+
         xgraph_free(&(*graph)->native_graph);
 
         xmap_map((*graph)->wadjsets, xwgraph_free_vertex_adjsets_apply, NULL);
         xmap_free(&(*graph)->wadjsets);
 
-        XMEM_FREE(*graph);
+        XMEM_FREE_BY(allocator, *graph, sizeof(**graph));
     }
 }
 
@@ -85,7 +91,7 @@ bool xwgraph_add_vertex(XWGraph_PT graph, void *vertex) {
         }
 
         {
-            XSet_PT adjset = xset_new(xwedge_cmp_undirected, graph->native_graph->cl);
+            XSet_PT adjset = xset_new_allocator(xwedge_cmp_undirected, graph->native_graph->cl, graph->native_graph->allocator);
             if (!adjset) {
                 xgraph_remove_vertex(graph->native_graph, vertex);
                 return false;
@@ -116,7 +122,7 @@ bool xwgraph_add_edge_repeat(XWGraph_PT graph, void *vertex1, void *vertex2, dou
         XSet_PT adjset_vertex2 = xwgraph_adjset(graph, vertex2);
 
         if (!adjset_vertex1) {
-            adjset_vertex1 = xset_new(xwedge_cmp_undirected, graph->native_graph->cl);
+            adjset_vertex1 = xset_new_allocator(xwedge_cmp_undirected, graph->native_graph->cl, graph->native_graph->allocator);
             if (!adjset_vertex1) {
                 xgraph_remove_edge(graph->native_graph, vertex1, vertex2);
                 return false;
@@ -128,7 +134,7 @@ bool xwgraph_add_edge_repeat(XWGraph_PT graph, void *vertex1, void *vertex2, dou
             }
         }
         if (!adjset_vertex2) {
-            adjset_vertex2 = xset_new(xwedge_cmp_undirected, graph->native_graph->cl);
+            adjset_vertex2 = xset_new_allocator(xwedge_cmp_undirected, graph->native_graph->cl, graph->native_graph->allocator);
             if (!adjset_vertex2) {
                 xmap_remove(graph->wadjsets, vertex1);
                 xset_free(&adjset_vertex1);
@@ -18,7 +18,7 @@
 #include "../include/xgraph_weight_undirected.h"
 
 struct XWGraph {
-    XGraph_PT native_graph;     /* can re-use all the methods of XGraph_PT */
+    XGraph_PT native_graph;     /* can re-use all the methods of XGraph_PT, native_graph->allocator is used by the XWGraph_PT too */
 
     XMap_PT   wadjsets;       /* key   : vertex;
                                * value : XSet_PT  {XWEdge_PT, XWEdge_PT, ...} */
@@ -0,0 +1,983 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+/*  Refer to :
+*       Swiss Tables design notes (abseil.io/about/design/swisstables)
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../include/xassert.h"
+#include "../include/xmem.h"
+#include "../utils/xutils.h"
+#include "xhash_flat_x.h"
+
+/* max loading factor is 7/8 */
+static
+int xflathash_max_load(int capacity) {
+    return capacity - capacity / 8;
+}
+
+static
+int xflathash_capacity(int hint) {
+    int capacity = XFLATHASH_GROUP_WIDTH;
+
+    while ((xflathash_max_load(capacity) < hint) && (capacity < (1 << 30))) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+/* the user hash function may be weak in the low/high bits, mix all bits before use them */
+static
+unsigned int xflathash_hash(XFlatHash_PT table, void *key) {
+    return xutils_hash_mix32((unsigned int)(*table->hash)(key));
+}
+
+static
+int xflathash_h1(unsigned int h) {
+    return (int)(h >> 7);
+}
+
+static
+signed char xflathash_h2(unsigned int h) {
+    return (signed char)(h & 0x7f);
+}
+
+static
+int xflathash_lowest_bit(unsigned int mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int i = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+/* bit i is set if ctrl[i] == h2 */
+static
+unsigned int xflathash_group_match(const signed char *ctrl, signed char h2) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < XFLATHASH_GROUP_WIDTH; ++i) {
+        if (ctrl[i] == h2) {
+            mask |= 1U << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/* bit i is set if ctrl[i] is empty or deleted (the highest bit is set) */
+static
+unsigned int xflathash_group_match_empty_or_deleted(const signed char *ctrl) {
+#if defined(__SSE2__)
+    return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < XFLATHASH_GROUP_WIDTH; ++i) {
+        if (ctrl[i] < 0) {
+            mask |= 1U << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+static
+unsigned int xflathash_group_match_empty(const signed char *ctrl) {
+    return xflathash_group_match(ctrl, XFLATHASH_CTRL_EMPTY);
+}
+
+static
+bool xflathash_alloc_slots(XFlatHash_PT table, int capacity) {
+    signed char *ctrl = XMEM_ALLOC_BY(table->allocator, capacity);
+    if (!ctrl) {
+        return false;
+    }
+
+    {
+        XFlatHash_Slot_PT slots = XMEM_ALLOC_BY(table->allocator, capacity * (long)sizeof(XFlatHash_Slot_T));
+        if (!slots) {
+            XMEM_FREE_BY(table->allocator, ctrl, capacity);
+            return false;
+        }
+
+        memset(ctrl, XFLATHASH_CTRL_EMPTY, capacity);
+
+        table->ctrl = ctrl;
+        table->slots = slots;
+        table->capacity = capacity;
+        table->size = 0;
+        table->growth_left = xflathash_max_load(capacity);
+    }
+
+    return true;
+}
+
+XFlatHash_PT xflathash_new(int hint, int(*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    return xflathash_new_allocator(hint, hash, cmp, cl, NULL);
+}
+
+XFlatHash_PT xflathash_new_allocator(int hint, int(*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    xassert(0 <= hint);
+    xassert(cmp);
+    xassert(hash);
+
+    if ((hint < 0) || !cmp || !hash) {
+        return NULL;
+    }
+
+    {
+        XFlatHash_PT table = XMEM_ALLOC_BY(allocator, sizeof(*table));
+        if (!table) {
+            return NULL;
+        }
+
+        table->allocator = allocator;
+        if (!xflathash_alloc_slots(table, xflathash_capacity(hint))) {
+            XMEM_FREE_BY(allocator, table, sizeof(*table));
+            return NULL;
+        }
+
+        table->hash = hash;
+        table->cmp = cmp;
+        table->cl = cl;
+
+        return table;
+    }
+}
+
+/* return the first empty or deleted slot for the hash code h */
+static
+int xflathash_find_insert_slot(XFlatHash_PT table, unsigned int h) {
+    int group_mask = table->capacity / XFLATHASH_GROUP_WIDTH - 1;
+    int group = xflathash_h1(h) & group_mask;
+
+    /* triangular probing visits every group once since the group number is power of 2 */
+    for (int step = 1; ; ++step) {
+        unsigned int mask = xflathash_group_match_empty_or_deleted(table->ctrl + group * XFLATHASH_GROUP_WIDTH);
+        if (mask) {
+            return group * XFLATHASH_GROUP_WIDTH + xflathash_lowest_bit(mask);
+        }
+
+        group = (group + step) & group_mask;
+    }
+}
+
+static
+void xflathash_set_slot(XFlatHash_PT table, int i, unsigned int h, void *key, void *value) {
+    if (table->ctrl[i] == XFLATHASH_CTRL_EMPTY) {
+        --table->growth_left;
+    }
+
+    table->ctrl[i] = xflathash_h2(h);
+    table->slots[i].key = key;
+    table->slots[i].value = value;
+
+    ++table->size;
+}
+
+/* move all elements into a new slot array, deleted slots are dropped at the same time */
+static
+bool xflathash_rehash(XFlatHash_PT table, int capacity) {
+    signed char *old_ctrl = table->ctrl;
+    XFlatHash_Slot_PT old_slots = table->slots;
+    int old_capacity = table->capacity;
+
+    if (!xflathash_alloc_slots(table, capacity)) {
+        return false;
+    }
+
+    for (int i = 0; i < old_capacity; ++i) {
+        if (0 <= old_ctrl[i]) {
+            unsigned int h = xflathash_hash(table, old_slots[i].key);
+            xflathash_set_slot(table, xflathash_find_insert_slot(table, h), h, old_slots[i].key, old_slots[i].value);
+        }
+    }
+
+    XMEM_FREE_BY(table->allocator, old_ctrl, old_capacity);
+    XMEM_FREE_BY(table->allocator, old_slots, old_capacity * (long)sizeof(XFlatHash_Slot_T));
+
+    return true;
+}
+
+static
+bool xflathash_reserve_one(XFlatHash_PT table) {
+    if (0 < table->growth_left) {
+        return true;
+    }
+
+    /* too many deleted slots, just clean them up, otherwise double the capacity */
+    if (table->size < xflathash_max_load(table->capacity) / 2) {
+        return xflathash_rehash(table, table->capacity);
+    }
+
+    return xflathash_rehash(table, table->capacity * 2);
+}
+
+/* return the index of the first slot saving key, or -1 if not found */
+static
+int xflathash_find_impl(XFlatHash_PT table, void *key, unsigned int h) {
+    int group_mask = table->capacity / XFLATHASH_GROUP_WIDTH - 1;
+    int group = xflathash_h1(h) & group_mask;
+    signed char h2 = xflathash_h2(h);
+
+    for (int step = 1; step <= group_mask + 1; ++step) {
+        const signed char *ctrl = table->ctrl + group * XFLATHASH_GROUP_WIDTH;
+
+        unsigned int mask = xflathash_group_match(ctrl, h2);
+        while (mask) {
+            int i = group * XFLATHASH_GROUP_WIDTH + xflathash_lowest_bit(mask);
+            if (table->cmp(key, table->slots[i].key, table->cl) == 0) {
+                return i;
+            }
+            mask &= mask - 1;
+        }
+
+        /* the key would have been saved in this group if it is in the table */
+        if (xflathash_group_match_empty(ctrl)) {
+            return -1;
+        }
+
+        group = (group + step) & group_mask;
+    }
+
+    return -1;
+}
+
+/* call apply for all slots saving key, stop if apply return false */
+static
+int xflathash_find_all_impl(XFlatHash_PT table, void *key, unsigned int h, bool (*apply)(XFlatHash_PT table, int i, void *cl), void *cl) {
+    int group_mask = table->capacity / XFLATHASH_GROUP_WIDTH - 1;
+    int group = xflathash_h1(h) & group_mask;
+    signed char h2 = xflathash_h2(h);
+    int count = 0;
+
+    for (int step = 1; step <= group_mask + 1; ++step) {
+        const signed char *ctrl = table->ctrl + group * XFLATHASH_GROUP_WIDTH;
+
+        /* check it before apply, since apply may erase the slots in this group */
+        bool last_group = xflathash_group_match_empty(ctrl) ? true : false;
+
+        unsigned int mask = xflathash_group_match(ctrl, h2);
+        while (mask) {
+            int i = group * XFLATHASH_GROUP_WIDTH + xflathash_lowest_bit(mask);
+            if (table->cmp(key, table->slots[i].key, table->cl) == 0) {
+                ++count;
+                if (!apply(table, i, cl)) {
+                    return count;
+                }
+            }
+            mask &= mask - 1;
+        }
+
+        if (last_group) {
+            break;
+        }
+
+        group = (group + step) & group_mask;
+    }
+
+    return count;
+}
+
+static
+void xflathash_erase_slot(XFlatHash_PT table, int i) {
+    /* the slot can be marked as empty if no probing went across its group */
+    if (xflathash_group_match_empty(table->ctrl + (i / XFLATHASH_GROUP_WIDTH) * XFLATHASH_GROUP_WIDTH)) {
+        table->ctrl[i] = XFLATHASH_CTRL_EMPTY;
+        ++table->growth_left;
+    }
+    else {
+        table->ctrl[i] = XFLATHASH_CTRL_DELETED;
+    }
+
+    table->slots[i].key = NULL;
+    table->slots[i].value = NULL;
+
+    --table->size;
+}
+
+static 
+XFlatHash_PT xflathash_copy_impl(XFlatHash_PT table, int key_size, int value_size, bool deep) {
+    xassert(table);
+
+    if (!table) {
+        return NULL;
+    }
+
+    {
+        XFlatHash_PT ntable = XMEM_ALLOC_BY(table->allocator, sizeof(*ntable));
+        if (!ntable) {
+            return NULL;
+        }
+
+        ntable->allocator = table->allocator;
+        if (!xflathash_alloc_slots(ntable, table->capacity)) {
+            XMEM_FREE_BY(table->allocator, ntable, sizeof(*ntable));
+            return NULL;
+        }
+
+        ntable->hash = table->hash;
+        ntable->cmp = table->cmp;
+        ntable->cl = table->cl;
+
+        /* same capacity, the slot positions can be kept */
+        memcpy(ntable->ctrl, table->ctrl, table->capacity);
+        memcpy(ntable->slots, table->slots, table->capacity * sizeof(XFlatHash_Slot_T));
+        ntable->size = table->size;
+        ntable->growth_left = table->growth_left;
+
+        if (deep) {
+            for (int i = 0; i < ntable->capacity; ++i) {
+                if (ntable->ctrl[i] < 0) {
+                    continue;
+                }
+
+                {
+                    void *key = xutils_deep_copy(table->slots[i].key, key_size);
+                    void *value = (0 < value_size) ? xutils_deep_copy(table->slots[i].value, value_size) : NULL;
+
+                    if (!key || (table->slots[i].value && (0 < value_size) && !value)) {
+                        XMEM_FREE(key);
+                        XMEM_FREE(value);
+
+                        /* the left slots are still shared with table */
+                        for (int j = i; j < ntable->capacity; ++j) {
+                            ntable->ctrl[j] = XFLATHASH_CTRL_EMPTY;
+                        }
+                        xflathash_deep_free(&ntable);
+                        return NULL;
+                    }
+
+                    ntable->slots[i].key = key;
+                    ntable->slots[i].value = value;
+                }
+            }
+        }
+
+        return ntable;
+    }
+}
+
+XFlatHash_PT xflathash_copy(XFlatHash_PT table) {
+    return xflathash_copy_impl(table, 0, 0, false);
+}
+
+XFlatHash_PT xflathash_deep_copy(XFlatHash_PT table, int key_size, int value_size) {
+    xassert(0 < key_size);
+    xassert(0 <= value_size);
+
+    if ((key_size <= 0) || (value_size < 0)) {
+        return NULL;
+    }
+
+    return xflathash_copy_impl(table, key_size, value_size, true);
+}
+
+bool xflathash_put_repeat(XFlatHash_PT table, void *key, void *value) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return false;
+    }
+
+    if (!xflathash_reserve_one(table)) {
+        return false;
+    }
+
+    {
+        unsigned int h = xflathash_hash(table, key);
+        xflathash_set_slot(table, xflathash_find_insert_slot(table, h), h, key, value);
+    }
+
+    return true;
+}
+
+static
+bool xflathash_put_unique_hashed(XFlatHash_PT table, void *key, void *value, unsigned int h) {
+    if (0 <= xflathash_find_impl(table, key, h)) {
+        return true;
+    }
+
+    if (!xflathash_reserve_one(table)) {
+        return false;
+    }
+
+    xflathash_set_slot(table, xflathash_find_insert_slot(table, h), h, key, value);
+    return true;
+}
+
+bool xflathash_put_unique(XFlatHash_PT table, void *key, void *value) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return false;
+    }
+
+    return xflathash_put_unique_hashed(table, key, value, xflathash_hash(table, key));
+}
+
+static
+bool xflathash_put_replace_hashed(XFlatHash_PT table, void *key, void *value, unsigned int h, bool deep) {
+    int i = xflathash_find_impl(table, key, h);
+
+    if (0 <= i) {
+        if (deep) {
+            XMEM_FREE(table->slots[i].value);
+        }
+        table->slots[i].value = value;
+        return true;
+    }
+
+    if (!xflathash_reserve_one(table)) {
+        return false;
+    }
+
+    xflathash_set_slot(table, xflathash_find_insert_slot(table, h), h, key, value);
+    return true;
+}
+
+static 
+bool xflathash_put_replace_impl(XFlatHash_PT table, void *key, void *value, bool deep) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return false;
+    }
+
+    return xflathash_put_replace_hashed(table, key, value, xflathash_hash(table, key), deep);
+}
+
+bool xflathash_put_replace(XFlatHash_PT table, void *key, void *value) {
+    return xflathash_put_replace_impl(table, key, value, false);
+}
+
+bool xflathash_put_deep_replace(XFlatHash_PT table, void *key, void *value) {
+    return xflathash_put_replace_impl(table, key, value, true);
+}
+
+void* xflathash_get(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return NULL;
+    }
+
+    {
+        int i = xflathash_find_impl(table, key, xflathash_hash(table, key));
+        return (0 <= i) ? table->slots[i].value : NULL;
+    }
+}
+
+bool xflathash_find(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return false;
+    }
+
+    return 0 <= xflathash_find_impl(table, key, xflathash_hash(table, key));
+}
+
+/* hash all keys of one batch and prefetch the first probed group (control bytes and slots) of each key,
+ * so the memory loads of different keys are overlapped before the keys are searched one by one
+ */
+static
+void xflathash_batch_prefetch(XFlatHash_PT table, void **keys, int count, unsigned int *hashes) {
+    int group_mask = table->capacity / XFLATHASH_GROUP_WIDTH - 1;
+
+    for (int i = 0; i < count; ++i) {
+        int first = (xflathash_h1(hashes[i] = xflathash_hash(table, keys[i])) & group_mask) * XFLATHASH_GROUP_WIDTH;
+
+        XUTILS_PREFETCH(table->ctrl + first);
+        XUTILS_PREFETCH(table->slots + first);
+    }
+}
+
+int xflathash_get_many(XFlatHash_PT table, void **keys, int count, void **values) {
+    xassert(table);
+    xassert(keys);
+    xassert(values);
+    xassert(0 <= count);
+
+    if (!table || !keys || !values || (count < 0)) {
+        return 0;
+    }
+
+    {
+        unsigned int hashes[XUTILS_HASH_BATCH_SIZE];
+        int found = 0;
+
+        for (int start = 0; start < count; start += XUTILS_HASH_BATCH_SIZE) {
+            int batch = (count - start < XUTILS_HASH_BATCH_SIZE) ? (count - start) : XUTILS_HASH_BATCH_SIZE;
+
+            xflathash_batch_prefetch(table, keys + start, batch, hashes);
+
+            for (int i = 0; i < batch; ++i) {
+                int k = xflathash_find_impl(table, keys[start + i], hashes[i]);
+
+                values[start + i] = (0 <= k) ? table->slots[k].value : NULL;
+                if (0 <= k) {
+                    ++found;
+                }
+            }
+        }
+
+        return found;
+    }
+}
+
+int xflathash_find_many(XFlatHash_PT table, void **keys, int count, bool *founds) {
+    xassert(table);
+    xassert(keys);
+    xassert(0 <= count);
+
+    if (!table || !keys || (count < 0)) {
+        return 0;
+    }
+
+    {
+        unsigned int hashes[XUTILS_HASH_BATCH_SIZE];
+        int found = 0;
+
+        for (int start = 0; start < count; start += XUTILS_HASH_BATCH_SIZE) {
+            int batch = (count - start < XUTILS_HASH_BATCH_SIZE) ? (count - start) : XUTILS_HASH_BATCH_SIZE;
+
+            xflathash_batch_prefetch(table, keys + start, batch, hashes);
+
+            for (int i = 0; i < batch; ++i) {
+                bool ret = 0 <= xflathash_find_impl(table, keys[start + i], hashes[i]);
+
+                if (founds) {
+                    founds[start + i] = ret;
+                }
+                if (ret) {
+                    ++found;
+                }
+            }
+        }
+
+        return found;
+    }
+}
+
+static
+int xflathash_put_many_impl(XFlatHash_PT table, void **keys, void **values, int count, bool replace) {
+    xassert(table);
+    xassert(keys);
+    xassert(0 <= count);
+
+    if (!table || !keys || (count < 0)) {
+        return 0;
+    }
+
+    {
+        unsigned int hashes[XUTILS_HASH_BATCH_SIZE];
+        int put = 0;
+
+        for (int start = 0; start < count; start += XUTILS_HASH_BATCH_SIZE) {
+            int batch = (count - start < XUTILS_HASH_BATCH_SIZE) ? (count - start) : XUTILS_HASH_BATCH_SIZE;
+
+            /* the table may grow in the batch, so only the hash codes are kept, not the slot indexes */
+            xflathash_batch_prefetch(table, keys + start, batch, hashes);
+
+            for (int i = 0; i < batch; ++i) {
+                void *value = values ? values[start + i] : NULL;
+                bool ret = replace ? xflathash_put_replace_hashed(table, keys[start + i], value, hashes[i], false)
+                                   : xflathash_put_unique_hashed(table, keys[start + i], value, hashes[i]);
+                if (ret) {
+                    ++put;
+                }
+            }
+        }
+
+        return put;
+    }
+}
+
+int xflathash_put_unique_many(XFlatHash_PT table, void **keys, void **values, int count) {
+    return xflathash_put_many_impl(table, keys, values, count, false);
+}
+
+int xflathash_put_replace_many(XFlatHash_PT table, void **keys, void **values, int count) {
+    return xflathash_put_many_impl(table, keys, values, count, true);
+}
+
+static
+bool xflathash_get_all_apply(XFlatHash_PT table, int i, void *cl) {
+    return xslist_push_back_repeat((XSList_PT)cl, table->slots[i].value);
+}
+
+XSList_PT xflathash_get_all(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return NULL;
+    }
+
+    {
+        XSList_PT list = xslist_new();
+        if (!list) {
+            return NULL;
+        }
+
+        if (xflathash_find_all_impl(table, key, xflathash_hash(table, key), xflathash_get_all_apply, (void*)list) != xslist_size(list)) {
+            xslist_free(&list);
+            return NULL;
+        }
+
+        return list;
+    }
+}
+
+static
+bool xflathash_remove_apply(XFlatHash_PT table, int i, void *cl) {
+    if (*(bool*)cl) {
+        XMEM_FREE(table->slots[i].key);
+        XMEM_FREE(table->slots[i].value);
+    }
+
+    xflathash_erase_slot(table, i);
+    return true;
+}
+
+static
+bool xflathash_remove_one_apply(XFlatHash_PT table, int i, void *cl) {
+    xflathash_remove_apply(table, i, cl);
+    return false;
+}
+
+bool xflathash_remove(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return false;
+    }
+
+    {
+        bool deep = false;
+        xflathash_find_all_impl(table, key, xflathash_hash(table, key), xflathash_remove_one_apply, (void*)&deep);
+    }
+
+    return true;
+}
+
+bool xflathash_deep_remove(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return false;
+    }
+
+    {
+        bool deep = true;
+        xflathash_find_all_impl(table, key, xflathash_hash(table, key), xflathash_remove_one_apply, (void*)&deep);
+    }
+
+    return true;
+}
+
+int xflathash_remove_all(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return 0;
+    }
+
+    {
+        bool deep = false;
+        return xflathash_find_all_impl(table, key, xflathash_hash(table, key), xflathash_remove_apply, (void*)&deep);
+    }
+}
+
+int xflathash_deep_remove_all(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return 0;
+    }
+
+    {
+        bool deep = true;
+        return xflathash_find_all_impl(table, key, xflathash_hash(table, key), xflathash_remove_apply, (void*)&deep);
+    }
+}
+
+static 
+void xflathash_clear_impl(XFlatHash_PT table, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(table);
+
+    if (!table) {
+        return;
+    }
+
+    if (deep || apply) {
+        for (int i = 0; i < table->capacity; ++i) {
+            if (table->ctrl[i] < 0) {
+                continue;
+            }
+
+            if (deep) {
+                XMEM_FREE(table->slots[i].key);
+                XMEM_FREE(table->slots[i].value);
+            }
+            else {
+                apply(table->slots[i].key, &table->slots[i].value, cl);
+            }
+        }
+    }
+
+    memset(table->ctrl, XFLATHASH_CTRL_EMPTY, table->capacity);
+    table->size = 0;
+    table->growth_left = xflathash_max_load(table->capacity);
+}
+
+void xflathash_clear(XFlatHash_PT table) {
+    xflathash_clear_impl(table, false, NULL, NULL);
+}
+
+void xflathash_clear_apply(XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xflathash_clear_impl(table, false, apply, cl);
+}
+
+void xflathash_deep_clear(XFlatHash_PT table) {
+    xflathash_clear_impl(table, true, NULL, NULL);
+}
+
+static 
+void xflathash_free_impl(XFlatHash_PT *table, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(table);
+    xassert(*table);
+
+    if (!table || !(*table)) {
+        return;
+    }
+
+    if (deep || apply) {
+        xflathash_clear_impl(*table, deep, apply, cl);
+    }
+
+    XMEM_FREE_BY((*table)->allocator, (*table)->ctrl, (*table)->capacity);
+    XMEM_FREE_BY((*table)->allocator, (*table)->slots, (*table)->capacity * (long)sizeof(XFlatHash_Slot_T));
+    XMEM_FREE_BY((*table)->allocator, *table, sizeof(**table));
+}
+
+void xflathash_free(XFlatHash_PT *table) {
+    xflathash_free_impl(table, false, NULL, NULL);
+}
+
+void xflathash_free_apply(XFlatHash_PT *table, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xflathash_free_impl(table, false, apply, cl);
+}
+
+void xflathash_deep_free(XFlatHash_PT *table) {
+    xflathash_free_impl(table, true, NULL, NULL);
+}
+
+int xflathash_map(XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(table);
+    xassert(apply);
+
+    if (!table || !apply) {
+        return -1;
+    }
+
+    {
+        int total = 0;
+
+        for (int i = 0; i < table->capacity; ++i) {
+            if ((0 <= table->ctrl[i]) && apply(table->slots[i].key, &table->slots[i].value, cl)) {
+                ++total;
+            }
+        }
+
+        return total;
+    }
+}
+
+bool xflathash_map_break_if_true(XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(table);
+    xassert(apply);
+
+    if (!table || !apply) {
+        return false;
+    }
+
+    for (int i = 0; i < table->capacity; ++i) {
+        if ((0 <= table->ctrl[i]) && apply(table->slots[i].key, &table->slots[i].value, cl)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool xflathash_map_break_if_false(XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(apply);
+
+    if (!table || !apply) {
+        return true;
+    }
+
+    for (int i = 0; i < table->capacity; ++i) {
+        if ((0 <= table->ctrl[i]) && !apply(table->slots[i].key, &table->slots[i].value, cl)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int xflathash_map_key(XFlatHash_PT table, bool (*apply)(void *key, void *cl), void *cl) {
+    xassert(table);
+    xassert(apply);
+
+    if (!table || !apply) {
+        return -1;
+    }
+
+    {
+        int total = 0;
+
+        for (int i = 0; i < table->capacity; ++i) {
+            if ((0 <= table->ctrl[i]) && apply(table->slots[i].key, cl)) {
+                ++total;
+            }
+        }
+
+        return total;
+    }
+}
+
+bool xflathash_map_key_break_if_true(XFlatHash_PT table, bool (*apply)(void *key, void *cl), void *cl) {
+    xassert(table);
+    xassert(apply);
+
+    if (!table || !apply) {
+        return false;
+    }
+
+    for (int i = 0; i < table->capacity; ++i) {
+        if ((0 <= table->ctrl[i]) && apply(table->slots[i].key, cl)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool xflathash_map_key_break_if_false(XFlatHash_PT table, bool (*apply)(void *key, void *cl), void *cl) {
+    xassert(apply);
+
+    if (!table || !apply) {
+        return true;
+    }
+
+    for (int i = 0; i < table->capacity; ++i) {
+        if ((0 <= table->ctrl[i]) && !apply(table->slots[i].key, cl)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool xflathash_swap(XFlatHash_PT table1, XFlatHash_PT table2) {
+    xassert(table1);
+    xassert(table2);
+    xassert(table1->allocator == table2->allocator);
+
+    if (!table1 || !table2 || (table1->allocator != table2->allocator)) {
+        return false;
+    }
+
+    {
+        struct XFlatHash tmp = *table1;
+        *table1 = *table2;
+        *table2 = tmp;
+    }
+
+    return true;
+}
+
+int xflathash_size(XFlatHash_PT table) {
+    return (table ? table->size : 0);
+}
+
+bool xflathash_is_empty(XFlatHash_PT table) {
+    return (table ? (table->size == 0) : true);
+}
+
+static
+bool xflathash_key_size_apply(XFlatHash_PT table, int i, void *cl) {
+    (void)table;
+    (void)i;
+    (void)cl;
+    return true;
+}
+
+int xflathash_key_size(XFlatHash_PT table, void *key) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
+        return 0;
+    }
+
+    return xflathash_find_all_impl(table, key, xflathash_hash(table, key), xflathash_key_size_apply, NULL);
+}
+
+double xflathash_loading_factor(XFlatHash_PT table) {
+    return (table ? (double)table->size / table->capacity : 0.0);
+}
+
+int xflathash_bucket_size(XFlatHash_PT table) {
+    return (table ? table->capacity : 0);
+}
+
+bool xflathash_resize(XFlatHash_PT table, int new_hint) {
+    xassert(table);
+    xassert(0 <= new_hint);
+
+    if (!table || (new_hint < 0)) {
+        return false;
+    }
+
+    /* never shrink below the current member number */
+    return xflathash_rehash(table, xflathash_capacity(new_hint < table->size ? table->size : new_hint));
+}
@@ -0,0 +1,57 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XFLATHASHX_INCLUDED
+#define XFLATHASHX_INCLUDED
+
+#include "../include/xhash_flat.h"
+
+/* Note :
+*    1. open addressing table, every slot saves the key and value inline, no memory allocated for each element.
+*    2. ctrl[i] is the control byte of slots[i] :
+*         empty   : 1000 0000
+*         deleted : 1111 1110
+*         full    : 0xxx xxxx  (the low 7 bits of the hash code)
+*    3. slots are probed group by group (XFLATHASH_GROUP_WIDTH slots), the control bytes of one group
+*       are compared in one SSE2 instruction if __SSE2__ is defined.
+*/
+
+#define XFLATHASH_GROUP_WIDTH  16
+
+#define XFLATHASH_CTRL_EMPTY   ((signed char)-128)
+#define XFLATHASH_CTRL_DELETED ((signed char)-2)
+
+typedef struct XFlatHash_Slot  XFlatHash_Slot_T;
+typedef struct XFlatHash_Slot* XFlatHash_Slot_PT;
+
+struct XFlatHash_Slot {
+    void *key;
+    void *value;
+};
+
+struct XFlatHash {
+    signed char      *ctrl;                  /* ctrl[i] is the control byte of slots[i] */
+    XFlatHash_Slot_PT slots;
+
+    int capacity;                            /* slot number : power of 2, at least XFLATHASH_GROUP_WIDTH */
+    int size;                                /* member number */
+    int growth_left;                         /* empty slots can be used before the table grows */
+
+    int  (*hash)(void *key);                 /* hash function */
+
+    int  (*cmp)(void *key1, void *key2, void *cl);   /* compare the key */
+    void  *cl;
+
+    XMem_Allocator_PT allocator;             /* the table, ctrl and slots come from it, NULL : XMEM */
+};
+
+#endif
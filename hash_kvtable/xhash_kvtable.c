@@ -16,47 +16,202 @@
 #include "../include/xassert.h"
 #include "../include/xmem.h"
 #include "../utils/xutils.h"
+#include "../include/xpair.h"
 #include "../include/xlist_kvd.h"
 #include "../include/xqueue_deque.h"
 #include "../array_pointer/xarray_pointer_x.h"
 #include "xhash_kvtable_x.h"
 
 static
-XKVHashtab_PT xkvhashtab_new_impl(int hint, int(*hash)(void *key), int(*cmp)(void *key1, void *key2, void *cl), void *cl, bool init_list) {
+XKVHashtab_PT xkvhashtab_new_impl(int hint, int(*hash)(void *key), int(*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     int slot = xutils_hash_buckets_num(hint);
 
-    XKVHashtab_PT table = XMEM_CALLOC(1, sizeof(*table));
+    XKVHashtab_PT table = XMEM_ALLOC_BY(allocator, sizeof(*table));
     if (!table) {
         return NULL;
     }
 
-    table->buckets = xparray_new(slot);
+    /* all buckets are NULL now, the list of a bucket is created by the first put into it */
+    table->buckets = xparray_new_allocator(slot, allocator);
     if (!table->buckets) {
-        XMEM_FREE(table);
+        XMEM_FREE_BY(allocator, table, sizeof(*table));
         return NULL;
     }
 
+    table->allocator = allocator;
+
     table->slot = slot;
     table->size = 0;
     table->cmp = cmp;
     table->cl = cl;
     table->hash = hash;
 
-    if (init_list) {
-        for (int i = 0; i < table->slot; i++) {
-            XKVDList_PT list = xkvdlist_new();
-            if (!list) {
-                xkvhashtab_free(&table);
-                return NULL;
-            }
+    return table;
+}
+
+static
+XKVDList_PT xkvhashtab_bucket(XKVHashtab_PT table, int i, bool create) {
+    XKVDList_PT list = (XKVDList_PT)xparray_get_impl(table->buckets, i);
+
+    if (!list && create) {
+        list = xkvdlist_new();
+        if (list) {
             xparray_put_impl(table->buckets, i, (void*)list);
         }
     }
 
-    return table;
+    return list;
+}
+
+/* i is in [0, slot + old_slot), the old buckets follow the current buckets */
+static
+XKVDList_PT xkvhashtab_bucket_at(XKVHashtab_PT table, int i) {
+    return (XKVDList_PT)((i < table->slot) ? xparray_get_impl(table->buckets, i) : xparray_get_impl(table->old_buckets, i - table->slot));
+}
+
+static
+void xkvhashtab_buckets_free(XPArray_PT buckets, int slot, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    for (int i = 0; i < slot; i++) {
+        XKVDList_PT list = (XKVDList_PT)xparray_get_impl(buckets, i);
+        if (!list) {
+            continue;
+        }
+
+        deep ? xkvdlist_deep_free(&list) : (apply ? xkvdlist_free_apply(&list, apply, cl) : xkvdlist_free(&list));
+        xparray_put_impl(buckets, i, NULL);
+    }
+}
+
+static
+void xkvhashtab_rehash_end(XKVHashtab_PT table) {
+    xparray_free(&table->old_buckets);
+    table->old_slot = 0;
+    table->rehash_index = 0;
+}
+
+/* move all elements in old_buckets[i] into buckets */
+static
+bool xkvhashtab_rehash_bucket(XKVHashtab_PT table, int i) {
+    XKVDList_PT list = (XKVDList_PT)xparray_get_impl(table->old_buckets, i);
+    if (!list) {
+        return true;
+    }
+
+    /* from back to front to keep the order of the same keys,
+     * and put the element into buckets before removing it, nothing is lost if the put fails
+     */
+    while (!xkvdlist_is_empty(list)) {
+        XPair_PT pair = xkvdlist_back(list);
+        XKVDList_PT nlist = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(xpair_first(pair)), table->slot), true);
+        if (!nlist || !xkvdlist_push_front_repeat(nlist, xpair_first(pair), xpair_second(pair))) {
+            return false;
+        }
+
+        xkvdlist_pop_back(list, NULL, NULL);
+    }
+
+    xkvdlist_free(&list);
+    xparray_put_impl(table->old_buckets, i, NULL);
+
+    return true;
+}
+
+/* move at most "steps" not empty buckets */
+static
+bool xkvhashtab_rehash_steps(XKVHashtab_PT table, int steps) {
+    int visits = steps * XUTILS_HASH_REHASH_EMPTY_VISITS;
+
+    for (; (table->rehash_index < table->old_slot) && (0 < steps) && (0 < visits); ++table->rehash_index, --visits) {
+        if (xparray_get_impl(table->old_buckets, table->rehash_index)) {
+            if (!xkvhashtab_rehash_bucket(table, table->rehash_index)) {
+                return false;
+            }
+            --steps;
+        }
+    }
+
+    if (table->old_buckets && (table->old_slot <= table->rehash_index)) {
+        xkvhashtab_rehash_end(table);
+    }
+
+    return true;
+}
+
+static
+bool xkvhashtab_rehash_all(XKVHashtab_PT table) {
+    for (; table->rehash_index < table->old_slot; ++table->rehash_index) {
+        if (!xkvhashtab_rehash_bucket(table, table->rehash_index)) {
+            return false;
+        }
+    }
+
+    if (table->old_buckets) {
+        xkvhashtab_rehash_end(table);
+    }
+
+    return true;
+}
+
+/* move the old bucket of key first to make sure all elements with the same key are in buckets,
+ * then move several other buckets to finish the resize step by step
+ */
+static
+bool xkvhashtab_rehash_key(XKVHashtab_PT table, void *key) {
+    if (!table->old_buckets) {
+        return true;
+    }
+
+    if (!xkvhashtab_rehash_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->old_slot))) {
+        return false;
+    }
+
+    xkvhashtab_rehash_steps(table, XUTILS_HASH_REHASH_STEPS);
+
+    return true;
+}
+
+static
+bool xkvhashtab_resize_impl(XKVHashtab_PT table, int new_hint) {
+    /* only one resize can be in progress */
+    if (!xkvhashtab_rehash_all(table)) {
+        return false;
+    }
+
+    {
+        int slot = xutils_hash_buckets_num(new_hint);
+        if (slot == table->slot) {
+            return true;
+        }
+
+        XPArray_PT buckets = xparray_new_allocator(slot, table->allocator);
+        if (!buckets) {
+            return false;
+        }
+
+        table->old_buckets = table->buckets;
+        table->old_slot = table->slot;
+        table->rehash_index = 0;
+
+        table->buckets = buckets;
+        table->slot = slot;
+    }
+
+    return true;
+}
+
+static
+void xkvhashtab_grow_if(XKVHashtab_PT table) {
+    if ((0 < table->max_loading_factor) && !table->old_buckets && (table->slot < xutils_max_hash_buckets_size()) && (table->max_loading_factor * table->slot < table->size)) {
+        /* keep the current buckets if failed, try it again by next put */
+        xkvhashtab_resize_impl(table, 2 * table->slot);
+    }
 }
 
 XKVHashtab_PT xkvhashtab_new(int hint, int(*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    return xkvhashtab_new_allocator(hint, hash, cmp, cl, NULL);
+}
+
+XKVHashtab_PT xkvhashtab_new_allocator(int hint, int(*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     xassert(0 <= hint);
     xassert(cmp);
     xassert(hash);
@@ -65,7 +220,7 @@ XKVHashtab_PT xkvhashtab_new(int hint, int(*hash)(void *key), int (*cmp)(void *k
         return NULL;
     }
 
-    return xkvhashtab_new_impl(hint, hash, cmp, cl, true);
+    return xkvhashtab_new_impl(hint, hash, cmp, cl, allocator);
 }
 
 // in order to support x2kvhashtab_copy, do not use xassert(table) here
@@ -78,14 +233,25 @@ XKVHashtab_PT xkvhashtab_copy_impl(XKVHashtab_PT table, int key_size, int value_
         return NULL;
     }
 
+    if (!xkvhashtab_rehash_all(table)) {
+        return NULL;
+    }
+
     {
-        XKVHashtab_PT ntable = xkvhashtab_new_impl(table->slot, table->hash, table->cmp, table->cl, false);
+        XKVHashtab_PT ntable = xkvhashtab_new_impl(table->slot, table->hash, table->cmp, table->cl, table->allocator);
         if (!ntable) {
             return NULL;
         }
 
+        ntable->max_loading_factor = table->max_loading_factor;
+
         for (int i = 0; i < table->slot; i++) {
-            XKVDList_PT list = deep ? xkvdlist_deep_copy((XKVDList_PT)xparray_get_impl(table->buckets, i), key_size, value_size) : xkvdlist_copy((XKVDList_PT)xparray_get_impl(table->buckets, i));
+            XKVDList_PT list = (XKVDList_PT)xparray_get_impl(table->buckets, i);
+            if (!list || xkvdlist_is_empty(list)) {
+                continue;
+            }
+
+            list = deep ? xkvdlist_deep_copy(list, key_size, value_size) : xkvdlist_copy(list);
             if (!list) {
                 deep ? xkvhashtab_deep_free(&ntable) : xkvhashtab_free(&ntable);
                 return NULL;
@@ -122,11 +288,16 @@ int xkvhashtab_put_repeat(XKVHashtab_PT table, void *key, void *value) {
         return -1;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), true);
 
-        if (xkvdlist_push_front_repeat((XKVDList_PT)xparray_get_impl(table->buckets, i), key, value)) {
+        if (list && xkvdlist_push_front_repeat(list, key, value)) {
             table->size++;
+            xkvhashtab_grow_if(table);
             return 1;
         }
     }
@@ -142,12 +313,20 @@ int xkvhashtab_put_unique(XKVHashtab_PT table, void *key, void *value) {
         return -1;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), true);
+        if (!list) {
+            return 0;
+        }
 
-        int count = xkvdlist_push_front_unique_if((XKVDList_PT)xparray_get_impl(table->buckets, i), key, value, table->cmp, table->cl);
+        int count = xkvdlist_push_front_unique_if(list, key, value, table->cmp, table->cl);
         if (0 < count) {
             table->size++;
+            xkvhashtab_grow_if(table);
         }
 
         return count;
@@ -163,19 +342,28 @@ int xkvhashtab_put_replace_impl(XKVHashtab_PT table, void *key, void *value, boo
         return -1;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), true);
         int count = 0;
 
+        if (!list) {
+            return 0;
+        }
+
         if (deep) {
-            count = xkvdlist_push_front_deep_replace_if((XKVDList_PT)xparray_get_impl(table->buckets, i), key, value, table->cmp, table->cl);
+            count = xkvdlist_push_front_deep_replace_if(list, key, value, table->cmp, table->cl);
         }
         else {
-            count = xkvdlist_push_front_replace_if((XKVDList_PT)xparray_get_impl(table->buckets, i), key, value, table->cmp, table->cl);
+            count = xkvdlist_push_front_replace_if(list, key, value, table->cmp, table->cl);
         }
 
         if (0 < count) {
             table->size++;
+            xkvhashtab_grow_if(table);
         }
 
         return count;
@@ -198,7 +386,14 @@ XRDList_PT xkvhashtab_get(XKVHashtab_PT table, void *key) {
         return NULL;
     }
 
-    return xkvdlist_find_equal_if((XKVDList_PT)xparray_get_impl(table->buckets, (*table->hash)(key) % table->slot), key, table->cmp, table->cl);
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return NULL;
+    }
+
+    {
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), false);
+        return list ? xkvdlist_find_equal_if(list, key, table->cmp, table->cl) : NULL;
+    }
 }
 
 static
@@ -223,8 +418,12 @@ XDeque_PT xkvhashtab_get_all(XKVHashtab_PT table, void *key) {
         return NULL;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return NULL;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        int i = xutils_hash_bucket_index((*table->hash)(key), table->slot);
 
         XDeque_PT deque = xdeque_new(XUTILS_DEQUE_LAYER2_DEFAULT_LENGTH);
         if (!deque) {
@@ -233,7 +432,8 @@ XDeque_PT xkvhashtab_get_all(XKVHashtab_PT table, void *key) {
 
         {
             XKVHashtab_Cmp_Keys_Paras_T paras = { table->cmp, key, (void*)deque, table->cl };
-            bool ret = xkvdlist_map_key_break_if_false((XKVDList_PT)xparray_get_impl(table->buckets, i), xkvhashtab_get_all_apply, &paras);
+            XKVDList_PT list = xkvhashtab_bucket(table, i, false);
+            bool ret = list ? xkvdlist_map_key_break_if_false(list, xkvhashtab_get_all_apply, &paras) : false;
             if (ret) {
                 xdeque_free(&deque);
                 return NULL;
@@ -259,13 +459,21 @@ bool xkvhashtab_remove(XKVHashtab_PT table, void *key) {
         return false;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return false;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
-        int count = xkvdlist_size((XKVDList_PT)xparray_get_impl(table->buckets, i));
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), false);
+        if (!list) {
+            return false;
+        }
 
-        bool ret = xkvdlist_remove_equal_break_if((XKVDList_PT)xparray_get_impl(table->buckets, i), key, table->cmp, table->cl);
+        int count = xkvdlist_size(list);
+
+        bool ret = xkvdlist_remove_equal_break_if(list, key, table->cmp, table->cl);
         if (ret) {
-            table->size -= count - xkvdlist_size((XKVDList_PT)xparray_get_impl(table->buckets, i));
+            table->size -= count - xkvdlist_size(list);
         }
 
         return ret;
@@ -283,10 +491,14 @@ int xkvhashtab_remove_all(XKVHashtab_PT table, void *key) {
         return -1;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), false);
 
-        int count = xkvdlist_remove_equal_if((XKVDList_PT)xparray_get_impl(table->buckets, i), key, table->cmp, table->cl);
+        int count = list ? xkvdlist_remove_equal_if(list, key, table->cmp, table->cl) : 0;
         if (0 < count) {
             table->size -= count;
         }
@@ -302,13 +514,14 @@ void xkvhashtab_clear_impl(XKVHashtab_PT table, bool deep, bool (*apply)(void *k
         return;
     }
 
+    /* give the buckets back, they will be created again by the next put into them */
     if (0 < table->size) {
-        for (int i = 0; i < table->slot; i++) {
-            XKVDList_PT list = (XKVDList_PT)xparray_get_impl(table->buckets, i);
-            if (list) {
-                deep ? xkvdlist_deep_clear(list) : (apply ? xkvdlist_clear_apply(list, apply, cl) : xkvdlist_clear(list));
-            }
-        }
+        xkvhashtab_buckets_free(table->buckets, table->slot, deep, apply, cl);
+    }
+
+    if (table->old_buckets) {
+        xkvhashtab_buckets_free(table->old_buckets, table->old_slot, deep, apply, cl);
+        xkvhashtab_rehash_end(table);
     }
 
     table->size = 0;
@@ -334,15 +547,15 @@ void xkvhashtab_free_impl(XKVHashtab_PT *table, bool deep, bool (*apply)(void *k
         return;
     }
 
-    for (int i = 0; i < (*table)->slot; i++) {
-        XKVDList_PT list = (XKVDList_PT)xparray_get_impl((*table)->buckets, i);
-        if (list) {
-            deep ? xkvdlist_deep_free(&list) : (apply ? xkvdlist_free_apply(&list, apply, cl) : xkvdlist_free(&list));
-        }
+    xkvhashtab_buckets_free((*table)->buckets, (*table)->slot, deep, apply, cl);
+    xparray_free(&((*table)->buckets));
+
+    if ((*table)->old_buckets) {
+        xkvhashtab_buckets_free((*table)->old_buckets, (*table)->old_slot, deep, apply, cl);
+        xparray_free(&((*table)->old_buckets));
     }
 
-    xparray_free(&((*table)->buckets));
-    XMEM_FREE(*table);
+    XMEM_FREE_BY((*table)->allocator, *table, sizeof(**table));
 }
 
 void xkvhashtab_free(XKVHashtab_PT *table) {
@@ -369,8 +582,11 @@ int xkvhashtab_map(XKVHashtab_PT table, bool (*apply)(void *key, void **value, v
     {
         int total = 0;
 
-        for (int i = 0; i < table->slot; i++) {
-            total += xkvdlist_map((XKVDList_PT)xparray_get_impl(table->buckets, i), apply, cl);
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XKVDList_PT list = xkvhashtab_bucket_at(table, i);
+            if (list) {
+                total += xkvdlist_map(list, apply, cl);
+            }
         }
 
         return total;
@@ -389,8 +605,9 @@ bool xkvhashtab_map_break_if_true(XKVHashtab_PT table, bool (*apply)(void *key,
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xkvdlist_map_break_if_true((XKVDList_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XKVDList_PT list = xkvhashtab_bucket_at(table, i);
+            if (list && xkvdlist_map_break_if_true(list, apply, cl)) {
                 return true;
             }
         }
@@ -407,8 +624,9 @@ bool xkvhashtab_map_break_if_false(XKVHashtab_PT table, bool (*apply)(void *key,
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xkvdlist_map_break_if_false((XKVDList_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XKVDList_PT list = xkvhashtab_bucket_at(table, i);
+            if (list && xkvdlist_map_break_if_false(list, apply, cl)) {
                 return true;
             }
         }
@@ -428,8 +646,11 @@ int xkvhashtab_map_key(XKVHashtab_PT table, bool (*apply)(void *key, void *cl),
     {
         int total = 0;
 
-        for (int i = 0; i < table->slot; i++) {
-            total += xkvdlist_map_key((XKVDList_PT)xparray_get_impl(table->buckets, i), apply, cl);
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XKVDList_PT list = xkvhashtab_bucket_at(table, i);
+            if (list) {
+                total += xkvdlist_map_key(list, apply, cl);
+            }
         }
 
         return total;
@@ -448,8 +669,9 @@ bool xkvhashtab_map_key_break_if_true(XKVHashtab_PT table, bool (*apply)(void *k
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xkvdlist_map_key_break_if_true((XKVDList_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XKVDList_PT list = xkvhashtab_bucket_at(table, i);
+            if (list && xkvdlist_map_key_break_if_true(list, apply, cl)) {
                 return true;
             }
         }
@@ -466,8 +688,9 @@ bool xkvhashtab_map_key_break_if_false(XKVHashtab_PT table, bool (*apply)(void *
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xkvdlist_map_key_break_if_false((XKVDList_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XKVDList_PT list = xkvhashtab_bucket_at(table, i);
+            if (list && xkvdlist_map_key_break_if_false(list, apply, cl)) {
                 return true;
             }
         }
@@ -479,8 +702,9 @@ bool xkvhashtab_map_key_break_if_false(XKVHashtab_PT table, bool (*apply)(void *
 bool xkvhashtab_swap(XKVHashtab_PT table1, XKVHashtab_PT table2) {
     xassert(table1);
     xassert(table2);
+    xassert(table1->allocator == table2->allocator);
 
-    if (!table1 || !table2) {
+    if (!table1 || !table2 || (table1->allocator != table2->allocator)) {
         return false;
     }
 
@@ -491,6 +715,10 @@ bool xkvhashtab_swap(XKVHashtab_PT table1, XKVHashtab_PT table2) {
         void *cl = table1->cl;
         int(*hash)(void *key) = table1->hash;
         XPArray_PT buckets = table1->buckets;
+        XPArray_PT old_buckets = table1->old_buckets;
+        int old_slot = table1->old_slot;
+        int rehash_index = table1->rehash_index;
+        double max_loading_factor = table1->max_loading_factor;
 
         table1->slot = table2->slot;
         table1->size = table2->size;
@@ -498,6 +726,10 @@ bool xkvhashtab_swap(XKVHashtab_PT table1, XKVHashtab_PT table2) {
         table1->cl = table2->cl;
         table1->hash = table2->hash;
         table1->buckets = table2->buckets;
+        table1->old_buckets = table2->old_buckets;
+        table1->old_slot = table2->old_slot;
+        table1->rehash_index = table2->rehash_index;
+        table1->max_loading_factor = table2->max_loading_factor;
 
         table2->slot = slot;
         table2->size = size;
@@ -505,6 +737,10 @@ bool xkvhashtab_swap(XKVHashtab_PT table1, XKVHashtab_PT table2) {
         table2->cl = cl;
         table2->hash = hash;
         table2->buckets = buckets;
+        table2->old_buckets = old_buckets;
+        table2->old_slot = old_slot;
+        table2->rehash_index = rehash_index;
+        table2->max_loading_factor = max_loading_factor;
     }
 
     return true;
@@ -539,7 +775,7 @@ int xkvhashtab_elems_in_bucket(XKVHashtab_PT table, int bucket) {
         return 0;
     }
 
-    return xkvdlist_size((XKVDList_PT)xparray_get_impl(table->buckets, bucket)) ;
+    return xkvdlist_size(xkvhashtab_bucket(table, bucket, false));
 }
 
 static
@@ -556,27 +792,30 @@ int xkvhashtab_key_size(XKVHashtab_PT table, void *key) {
         return 0;
     }
 
+    if (!xkvhashtab_rehash_key(table, key)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XKVDList_PT list = xkvhashtab_bucket(table, xutils_hash_bucket_index((*table->hash)(key), table->slot), false);
         XKVHashtab_Cmp_Keys_Paras_T paras = { table->cmp, key, NULL, table->cl };
 
-        return xkvdlist_map_key((XKVDList_PT)xparray_get_impl(table->buckets, i), xkvhashtab_key_size_apply, &paras);
+        return list ? xkvdlist_map_key(list, xkvhashtab_key_size_apply, &paras) : 0;
     }
 }
 
-static 
-bool xkvhashtab_resize_map_apply(void *key, void **value, void *cl) {
-    XKVHashtab_PT ntable = (XKVHashtab_PT)cl;
+bool xkvhashtab_resize(XKVHashtab_PT table, int new_hint) {
+    xassert(table);
+    xassert(0 < new_hint);
 
-    if (!xkvhashtab_put_repeat(ntable, key, *value)) {
+    if (!table || (new_hint <= 0)) {
         return false;
     }
 
-    return true;
+    return xkvhashtab_resize_impl(table, new_hint) && xkvhashtab_rehash_all(table);
 }
 
-/* if use rbtree instead, we will not need this function */
-bool xkvhashtab_resize(XKVHashtab_PT table, int new_hint) {
+bool xkvhashtab_resize_incremental(XKVHashtab_PT table, int new_hint) {
     xassert(table);
     xassert(0 < new_hint);
 
@@ -584,26 +823,20 @@ bool xkvhashtab_resize(XKVHashtab_PT table, int new_hint) {
         return false;
     }
 
-    {
-        XKVHashtab_PT ntable = xkvhashtab_new(new_hint, table->hash, table->cmp, table->cl);
-        if (!ntable) {
-            return false;
-        }
-
-        bool ret = false;
-        for (int i = 0; i < table->slot; i++) {
-            ret = xkvdlist_map_break_if_false((XKVDList_PT)xparray_get_impl(table->buckets, i), xkvhashtab_resize_map_apply, ntable);
-            if (ret) {
-                break;
-            }
-        }
+    return xkvhashtab_resize_impl(table, new_hint);
+}
 
-        if (!ret) {
-            xkvhashtab_swap(table, ntable);
-        }
+bool xkvhashtab_is_rehashing(XKVHashtab_PT table) {
+    return (table ? (table->old_buckets != NULL) : false);
+}
 
-        xkvhashtab_free(&ntable);
+void xkvhashtab_set_max_loading_factor(XKVHashtab_PT table, double factor) {
+    xassert(table);
+    xassert(0 <= factor);
 
-        return !ret;
+    if (!table || (factor < 0)) {
+        return;
     }
+
+    table->max_loading_factor = factor;
 }
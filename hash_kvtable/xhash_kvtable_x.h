@@ -26,6 +26,14 @@ struct XKVHashtab {
 
     int  (*cmp)  (void *key1, void *key2, void *cl);   /* compare the key in XRBTree_PT */
     void  *cl;
+
+    XPArray_PT old_buckets;                  /* buckets before incremental resize, NULL if no resize is in progress */
+    int    old_slot;                         /* == old_buckets->size */
+    int    rehash_index;                     /* old_buckets[0, rehash_index) are all moved into buckets */
+
+    double max_loading_factor;               /* resize automatically when size / slot exceeds it, 0 : never */
+
+    XMem_Allocator_PT allocator;             /* the table and its bucket arrays come from it, NULL : XMEM */
 };
 
 
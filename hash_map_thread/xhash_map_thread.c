@@ -0,0 +1,419 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#if defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../include/xassert.h"
+#include "../include/xmem.h"
+#include "../utils/xutils.h"
+#include "xhash_map_thread_x.h"
+
+/* the segment grows when its loading factor exceeds it, the pause is limited to one segment */
+static const double XTS_HASHMAP_MAX_LOADING_FACTOR = 4.0;
+
+/* the segment is picked by its own seeded hash, so it never shares the bits with the bucket inside the segment */
+static const uint64_t XTS_HASHMAP_SEGMENT_SEED = 0x5851f42d4c957f2dULL;
+
+static
+XTS_HashMap_Segment_PT xts_hashmap_segment(XTS_HashMap_PT map, void *key) {
+    uint64_t h = xutils_hash64_int((int64_t)(unsigned int)(*map->hash)(key), XTS_HASHMAP_SEGMENT_SEED);
+    return &map->segments[(unsigned int)(h >> 32) & (unsigned int)(map->segment_num - 1)];
+}
+
+/* write lock must be held : a resize failed in the middle (out of memory) is finished first */
+static
+void xts_hashmap_grow_if(XTS_HashMap_Segment_PT segment) {
+    if (xrbtreehash_is_rehashing(segment->table)) {
+        xrbtreehash_resize(segment->table, xrbtreehash_bucket_size(segment->table));
+    }
+    else if (XTS_HASHMAP_MAX_LOADING_FACTOR < xrbtreehash_loading_factor(segment->table)) {
+        /* keep the current buckets if failed */
+        xrbtreehash_resize(segment->table, 2 * xrbtreehash_bucket_size(segment->table));
+    }
+}
+
+/* xrbtreehash_get and xrbtreehash_find move the nodes of a table being rehashed,
+ * so the read lock is changed to the write lock and the rehash is finished if the table is left in the middle
+ */
+static
+bool xts_hashmap_read_lock(XTS_HashMap_Segment_PT segment) {
+    if (pthread_rwlock_rdlock(&segment->lock) != 0) {
+        return false;
+    }
+
+    if (!xrbtreehash_is_rehashing(segment->table)) {
+        return true;
+    }
+
+    pthread_rwlock_unlock(&segment->lock);
+
+    if (pthread_rwlock_wrlock(&segment->lock) != 0) {
+        return false;
+    }
+
+    xts_hashmap_grow_if(segment);
+
+    return true;
+}
+
+static
+void xts_hashmap_free_impl(XTS_HashMap_PT *pmap, bool deep) {
+    for (int i = 0; i < (*pmap)->segment_num; i++) {
+        XTS_HashMap_Segment_PT segment = &(*pmap)->segments[i];
+        if (!segment->table) {
+            break;
+        }
+
+        deep ? xrbtreehash_deep_free(&segment->table) : xrbtreehash_free(&segment->table);
+        pthread_rwlock_destroy(&segment->lock);
+    }
+
+    XMEM_FREE((*pmap)->segments);
+    XMEM_FREE(*pmap);
+}
+
+XTS_HashMap_PT xts_hashmap_new(int segments, int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    xassert(0 < segments);
+    xassert(0 <= hint);
+    xassert(hash);
+    xassert(cmp);
+
+    if ((segments <= 0) || (hint < 0) || !hash || !cmp) {
+        return NULL;
+    }
+
+    {
+        int num = 1;
+        while ((num < segments) && (num < (1 << 16))) {
+            num <<= 1;
+        }
+
+        XTS_HashMap_PT map = XMEM_CALLOC(1, sizeof(*map));
+        if (!map) {
+            return NULL;
+        }
+
+        map->segments = XMEM_CALLOC(num, sizeof(*map->segments));
+        if (!map->segments) {
+            XMEM_FREE(map);
+            return NULL;
+        }
+
+        map->segment_num = num;
+        map->hash = hash;
+
+        for (int i = 0; i < num; i++) {
+            XTS_HashMap_Segment_PT segment = &map->segments[i];
+
+            if (pthread_rwlock_init(&segment->lock, NULL) != 0) {
+                xts_hashmap_free_impl(&map, false);
+                return NULL;
+            }
+
+            segment->table = xrbtreehash_new(hint / num, hash, cmp, cl);
+            if (!segment->table) {
+                pthread_rwlock_destroy(&segment->lock);
+                xts_hashmap_free_impl(&map, false);
+                return NULL;
+            }
+        }
+
+        return map;
+    }
+}
+
+bool xts_hashmap_put_replace(XTS_HashMap_PT map, void *key, void *value) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    {
+        XTS_HashMap_Segment_PT segment = xts_hashmap_segment(map, key);
+        bool ret = false;
+
+        if (pthread_rwlock_wrlock(&segment->lock) != 0) {
+            return false;
+        }
+
+        ret = xrbtreehash_put_replace(segment->table, key, value);
+        if (ret) {
+            xts_hashmap_grow_if(segment);
+        }
+
+        pthread_rwlock_unlock(&segment->lock);
+
+        return ret;
+    }
+}
+
+bool xts_hashmap_put_if_absent(XTS_HashMap_PT map, void *key, void *value) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    {
+        XTS_HashMap_Segment_PT segment = xts_hashmap_segment(map, key);
+        bool ret = false;
+
+        if (pthread_rwlock_wrlock(&segment->lock) != 0) {
+            return false;
+        }
+
+        if (!xrbtreehash_find(segment->table, key)) {
+            ret = xrbtreehash_put_repeat(segment->table, key, value);
+            if (ret) {
+                xts_hashmap_grow_if(segment);
+            }
+        }
+
+        pthread_rwlock_unlock(&segment->lock);
+
+        return ret;
+    }
+}
+
+bool xts_hashmap_compute(XTS_HashMap_PT map, void *key, void* (*remap)(void *key, void *value, bool found, void *cl), void *cl) {
+    xassert(map);
+    xassert(key);
+    xassert(remap);
+
+    if (!map || !key || !remap) {
+        return false;
+    }
+
+    {
+        XTS_HashMap_Segment_PT segment = xts_hashmap_segment(map, key);
+        bool ret = true;
+
+        if (pthread_rwlock_wrlock(&segment->lock) != 0) {
+            return false;
+        }
+
+        {
+            bool found = xrbtreehash_find(segment->table, key);
+            void *value = remap(key, (found ? xrbtreehash_get(segment->table, key) : NULL), found, cl);
+
+            if (value) {
+                ret = xrbtreehash_put_replace(segment->table, key, value);
+                if (ret) {
+                    xts_hashmap_grow_if(segment);
+                }
+            }
+            else if (found) {
+                xrbtreehash_remove(segment->table, key);
+            }
+        }
+
+        pthread_rwlock_unlock(&segment->lock);
+
+        return ret;
+    }
+}
+
+void* xts_hashmap_get(XTS_HashMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return NULL;
+    }
+
+    {
+        XTS_HashMap_Segment_PT segment = xts_hashmap_segment(map, key);
+        void *value = NULL;
+
+        if (!xts_hashmap_read_lock(segment)) {
+            return NULL;
+        }
+
+        value = xrbtreehash_get(segment->table, key);
+
+        pthread_rwlock_unlock(&segment->lock);
+
+        return value;
+    }
+}
+
+bool xts_hashmap_find(XTS_HashMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    {
+        XTS_HashMap_Segment_PT segment = xts_hashmap_segment(map, key);
+        bool ret = false;
+
+        if (!xts_hashmap_read_lock(segment)) {
+            return false;
+        }
+
+        ret = xrbtreehash_find(segment->table, key);
+
+        pthread_rwlock_unlock(&segment->lock);
+
+        return ret;
+    }
+}
+
+static
+bool xts_hashmap_remove_impl(XTS_HashMap_PT map, void *key, bool deep) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    {
+        XTS_HashMap_Segment_PT segment = xts_hashmap_segment(map, key);
+        int size = 0;
+
+        if (pthread_rwlock_wrlock(&segment->lock) != 0) {
+            return false;
+        }
+
+        size = xrbtreehash_size(segment->table);
+        deep ? xrbtreehash_deep_remove(segment->table, key) : xrbtreehash_remove(segment->table, key);
+        size -= xrbtreehash_size(segment->table);
+
+        pthread_rwlock_unlock(&segment->lock);
+
+        return (0 < size);
+    }
+}
+
+bool xts_hashmap_remove(XTS_HashMap_PT map, void *key) {
+    return xts_hashmap_remove_impl(map, key, false);
+}
+
+bool xts_hashmap_deep_remove(XTS_HashMap_PT map, void *key) {
+    return xts_hashmap_remove_impl(map, key, true);
+}
+
+static
+void xts_hashmap_clear_impl(XTS_HashMap_PT map, bool deep) {
+    xassert(map);
+
+    if (!map) {
+        return;
+    }
+
+    for (int i = 0; i < map->segment_num; i++) {
+        XTS_HashMap_Segment_PT segment = &map->segments[i];
+
+        if (pthread_rwlock_wrlock(&segment->lock) != 0) {
+            continue;
+        }
+
+        deep ? xrbtreehash_deep_clear(segment->table) : xrbtreehash_clear(segment->table);
+
+        pthread_rwlock_unlock(&segment->lock);
+    }
+}
+
+void xts_hashmap_clear(XTS_HashMap_PT map) {
+    xts_hashmap_clear_impl(map, false);
+}
+
+void xts_hashmap_deep_clear(XTS_HashMap_PT map) {
+    xts_hashmap_clear_impl(map, true);
+}
+
+void xts_hashmap_free(XTS_HashMap_PT *pmap) {
+    if (!pmap || !*pmap) {
+        return;
+    }
+
+    xts_hashmap_free_impl(pmap, false);
+}
+
+void xts_hashmap_deep_free(XTS_HashMap_PT *pmap) {
+    if (!pmap || !*pmap) {
+        return;
+    }
+
+    xts_hashmap_free_impl(pmap, true);
+}
+
+int xts_hashmap_map(XTS_HashMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(map);
+    xassert(apply);
+
+    if (!map || !apply) {
+        return -1;
+    }
+
+    {
+        int total = 0;
+
+        for (int i = 0; i < map->segment_num; i++) {
+            XTS_HashMap_Segment_PT segment = &map->segments[i];
+
+            if (pthread_rwlock_rdlock(&segment->lock) != 0) {
+                continue;
+            }
+
+            total += xrbtreehash_map(segment->table, apply, cl);
+
+            pthread_rwlock_unlock(&segment->lock);
+        }
+
+        return total;
+    }
+}
+
+int xts_hashmap_size(XTS_HashMap_PT map) {
+    if (!map) {
+        return 0;
+    }
+
+    {
+        int total = 0;
+
+        for (int i = 0; i < map->segment_num; i++) {
+            XTS_HashMap_Segment_PT segment = &map->segments[i];
+
+            if (pthread_rwlock_rdlock(&segment->lock) != 0) {
+                continue;
+            }
+
+            total += xrbtreehash_size(segment->table);
+
+            pthread_rwlock_unlock(&segment->lock);
+        }
+
+        return total;
+    }
+}
+
+bool xts_hashmap_is_empty(XTS_HashMap_PT map) {
+    return (xts_hashmap_size(map) == 0);
+}
+
+int xts_hashmap_segments(XTS_HashMap_PT map) {
+    return (map ? map->segment_num : 0);
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XTS_HASHMAPX_INCLUDED
+#define XTS_HASHMAPX_INCLUDED
+
+#if defined(__linux__)
+
+#include <pthread.h>
+
+#include "../include/xhash_rbtree.h"
+#include "../include/xhash_map_thread.h"
+
+typedef struct XTS_HashMap_Segment* XTS_HashMap_Segment_PT;
+
+struct XTS_HashMap_Segment {
+    pthread_rwlock_t lock;
+    XRBTreeHash_PT   table;          /* never resized incrementally, a failed resize is finished under write lock before it is read */
+
+    char             pad[64];        /* keep the locks of neighbor segments out of one cache line */
+};
+
+struct XTS_HashMap {
+    XTS_HashMap_Segment_PT segments;
+    int                    segment_num;   /* power of 2 */
+
+    int                  (*hash)(void *key);
+};
+
+#endif
+#endif
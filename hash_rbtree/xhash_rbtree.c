@@ -17,45 +17,216 @@
 #include "../include/xmem.h"
 #include "../utils/xutils.h"
 #include "../array_pointer/xarray_pointer_x.h"
-#include "../include/xtree_redblack.h"
+#include "../tree_redblack/xtree_redblack_x.h"
 #include "xhash_rbtree_x.h"
 
 static
-XRBTreeHash_PT xrbtreehash_new_impl(int hint, int(*hash)(void *key), int(*cmp)(void *key1, void *key2, void *cl), void *cl, bool init_list) {
+XRBTreeHash_PT xrbtreehash_new_impl(int hint, int(*hash)(void *key), int(*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     int slot = xutils_hash_buckets_num(hint);
 
-    XRBTreeHash_PT table = XMEM_CALLOC(1, sizeof(*table));
+    XRBTreeHash_PT table = XMEM_ALLOC_BY(allocator, sizeof(*table));
     if (!table) {
         return NULL;
     }
 
     {
-        table->buckets = xparray_new(slot);
+        /* all buckets are NULL now, the tree of a bucket is created by the first put into it */
+        table->buckets = xparray_new_allocator(slot, allocator);
         if (!table->buckets) {
-            XMEM_FREE(table);
+            XMEM_FREE_BY(allocator, table, sizeof(*table));
             return NULL;
         }
 
+        table->slab = xslab_new_allocator(XRBTREE_HASHED_NODE_SIZE, allocator);
+        if (!table->slab) {
+            xparray_free(&table->buckets);
+            XMEM_FREE_BY(allocator, table, sizeof(*table));
+            return NULL;
+        }
+
+        table->allocator = allocator;
+
         table->slot = slot;
         table->size = 0;
         table->cmp = cmp;
         table->cl = cl;
         table->hash = hash;
+    }
 
-        if (init_list) {
-            for (int i = 0; i < table->slot; i++) {
-                XRBTree_PT tree = xrbtree_new(cmp, cl);
-                if (!tree) {
-                    xrbtreehash_free(&table);
-                    return NULL;
-                }
+    return table;
+}
+
+static
+XRBTree_PT xrbtreehash_bucket(XRBTreeHash_PT table, int i, bool create) {
+    XRBTree_PT tree = (XRBTree_PT)xparray_get_impl(table->buckets, i);
+
+    if (!tree && create) {
+        tree = xrbtree_new_allocator(table->cmp, table->cl, table->allocator);
+        if (tree) {
+            xrbtree_set_hashed(tree);
+            tree->slab = xslab_share(table->slab);
+            xparray_put_impl(table->buckets, i, (void*)tree);
+        }
+    }
+
+    return tree;
+}
+
+/* i is in [0, slot + old_slot), the old buckets follow the current buckets */
+static
+XRBTree_PT xrbtreehash_bucket_at(XRBTreeHash_PT table, int i) {
+    return (XRBTree_PT)((i < table->slot) ? xparray_get_impl(table->buckets, i) : xparray_get_impl(table->old_buckets, i - table->slot));
+}
+
+static
+void xrbtreehash_buckets_free(XPArray_PT buckets, int slot, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    for (int i = 0; i < slot; i++) {
+        XRBTree_PT tree = (XRBTree_PT)xparray_get_impl(buckets, i);
+        if (!tree) {
+            continue;
+        }
+
+        deep ? xrbtree_deep_free(&tree) : (apply ? xrbtree_free_apply(&tree, apply, cl) : xrbtree_free(&tree));
+        xparray_put_impl(buckets, i, NULL);
+    }
+}
+
+static
+void xrbtreehash_rehash_end(XRBTreeHash_PT table) {
+    xparray_free(&table->old_buckets);
+    table->old_slot = 0;
+    table->rehash_index = 0;
+}
 
-                xparray_put_impl(table->buckets, i, (void*)tree);
+/* move all elements in old_buckets[i] into buckets */
+static
+bool xrbtreehash_rehash_bucket(XRBTreeHash_PT table, int i) {
+    XRBTree_PT tree = (XRBTree_PT)xparray_get_impl(table->old_buckets, i);
+    if (!tree) {
+        return true;
+    }
+
+    while (!xrbtree_is_empty(tree)) {
+        /* put the minimum one into buckets before removing it, nothing is lost if the put fails */
+        XRBTree_Node_PT node = tree->root;
+        while (node->left) {
+            node = node->left;
+        }
+
+        {
+            /* the saved hash code is used, no need to call the hash function again */
+            int hash = xrbtree_node_hash(node);
+            XRBTree_PT ntree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), true);
+            if (!ntree || !xrbtree_put_repeat_hash(ntree, node->key, node->value, hash, false)) {
+                return false;
             }
         }
+
+        xrbtree_remove_min(tree);
     }
 
-    return table;
+    xrbtree_free(&tree);
+    xparray_put_impl(table->old_buckets, i, NULL);
+
+    return true;
+}
+
+/* move at most "steps" not empty buckets */
+static
+bool xrbtreehash_rehash_steps(XRBTreeHash_PT table, int steps) {
+    int visits = steps * XUTILS_HASH_REHASH_EMPTY_VISITS;
+
+    for (; (table->rehash_index < table->old_slot) && (0 < steps) && (0 < visits); ++table->rehash_index, --visits) {
+        if (xparray_get_impl(table->old_buckets, table->rehash_index)) {
+            if (!xrbtreehash_rehash_bucket(table, table->rehash_index)) {
+                return false;
+            }
+            --steps;
+        }
+    }
+
+    if (table->old_buckets && (table->old_slot <= table->rehash_index)) {
+        xrbtreehash_rehash_end(table);
+    }
+
+    return true;
+}
+
+static
+bool xrbtreehash_rehash_all(XRBTreeHash_PT table) {
+    for (; table->rehash_index < table->old_slot; ++table->rehash_index) {
+        if (!xrbtreehash_rehash_bucket(table, table->rehash_index)) {
+            return false;
+        }
+    }
+
+    if (table->old_buckets) {
+        xrbtreehash_rehash_end(table);
+    }
+
+    return true;
+}
+
+/* move the old bucket of key first to make sure all elements with the same key are in buckets,
+ * then move several other buckets to finish the resize step by step
+ */
+static
+bool xrbtreehash_rehash_hash(XRBTreeHash_PT table, int hash) {
+    if (!table->old_buckets) {
+        return true;
+    }
+
+    if (!xrbtreehash_rehash_bucket(table, xutils_hash_bucket_index(hash, table->old_slot))) {
+        return false;
+    }
+
+    xrbtreehash_rehash_steps(table, XUTILS_HASH_REHASH_STEPS);
+
+    return true;
+}
+
+/* the hash code of key is calculated only once for each operation, then saved in the tree node */
+static
+bool xrbtreehash_hash_key(XRBTreeHash_PT table, void *key, int *hash) {
+    *hash = (*table->hash)(key);
+    return xrbtreehash_rehash_hash(table, *hash);
+}
+
+static
+bool xrbtreehash_resize_impl(XRBTreeHash_PT table, int new_hint) {
+    /* only one resize can be in progress */
+    if (!xrbtreehash_rehash_all(table)) {
+        return false;
+    }
+
+    {
+        int slot = xutils_hash_buckets_num(new_hint);
+        if (slot == table->slot) {
+            return true;
+        }
+
+        XPArray_PT buckets = xparray_new_allocator(slot, table->allocator);
+        if (!buckets) {
+            return false;
+        }
+
+        table->old_buckets = table->buckets;
+        table->old_slot = table->slot;
+        table->rehash_index = 0;
+
+        table->buckets = buckets;
+        table->slot = slot;
+    }
+
+    return true;
+}
+
+static
+void xrbtreehash_grow_if(XRBTreeHash_PT table) {
+    if ((0 < table->max_loading_factor) && !table->old_buckets && (table->slot < xutils_max_hash_buckets_size()) && (table->max_loading_factor * table->slot < table->size)) {
+        /* keep the current buckets if failed, try it again by next put */
+        xrbtreehash_resize_impl(table, 2 * table->slot);
+    }
 }
 
 XRBTreeHash_PT xrbtreehash_new(int hint, int(*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
@@ -67,7 +238,19 @@ XRBTreeHash_PT xrbtreehash_new(int hint, int(*hash)(void *key), int (*cmp)(void
         return NULL;
     }
 
-    return xrbtreehash_new_impl(hint, hash, cmp, cl, true);
+    return xrbtreehash_new_impl(hint, hash, cmp, cl, NULL);
+}
+
+XRBTreeHash_PT xrbtreehash_new_allocator(int hint, int(*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    xassert(0 <= hint);
+    xassert(cmp);
+    xassert(hash);
+
+    if ((hint < 0) || !cmp || !hash) {
+        return NULL;
+    }
+
+    return xrbtreehash_new_impl(hint, hash, cmp, cl, allocator);
 }
 
 static 
@@ -78,14 +261,25 @@ XRBTreeHash_PT xrbtreehash_copy_impl(XRBTreeHash_PT table, int key_size, int val
         return NULL;
     }
 
+    if (!xrbtreehash_rehash_all(table)) {
+        return NULL;
+    }
+
     {
-        XRBTreeHash_PT ntable = xrbtreehash_new_impl(table->slot, table->hash, table->cmp, table->cl, false);
+        XRBTreeHash_PT ntable = xrbtreehash_new_impl(table->slot, table->hash, table->cmp, table->cl, table->allocator);
         if (!ntable) {
             return NULL;
         }
 
+        ntable->max_loading_factor = table->max_loading_factor;
+
         for (int i = 0; i < table->slot; i++) {
-            XRBTree_PT tree = deep ? xrbtree_deep_copy((XRBTree_PT)xparray_get_impl(table->buckets, i), key_size, value_size) : xrbtree_copy((XRBTree_PT)xparray_get_impl(table->buckets, i));
+            XRBTree_PT tree = (XRBTree_PT)xparray_get_impl(table->buckets, i);
+            if (!tree || xrbtree_is_empty(tree)) {
+                continue;
+            }
+
+            tree = deep ? xrbtree_deep_copy(tree, key_size, value_size) : xrbtree_copy(tree);
             if (!tree) {
                 deep ? xrbtreehash_deep_free(&ntable) : xrbtreehash_free(&ntable);
                 return NULL;
@@ -122,11 +316,17 @@ bool xrbtreehash_put_repeat(XRBTreeHash_PT table, void *key, void *value) {
         return false;
     }
 
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return false;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), true);
 
-        if (xrbtree_put_repeat((XRBTree_PT)xparray_get_impl(table->buckets, i), key, value)) {
+        if (tree && xrbtree_put_repeat_hash(tree, key, value, hash, false)) {
             ++table->size;
+            xrbtreehash_grow_if(table);
             return true;
         }
     }
@@ -134,25 +334,39 @@ bool xrbtreehash_put_repeat(XRBTreeHash_PT table, void *key, void *value) {
     return false;
 }
 
-bool xrbtreehash_put_unique(XRBTreeHash_PT table, void *key, void *value) {
-    xassert(table);
-    xassert(key);
-
-    if (!table || !key) {
+static
+bool xrbtreehash_put_hashed(XRBTreeHash_PT table, void *key, void *value, int hash, bool replace) {
+    if (!xrbtreehash_rehash_hash(table, hash)) {
         return false;
     }
 
     {
-        int i = (*table->hash)(key) % table->slot;
-        int size = xrbtree_size((XRBTree_PT)xparray_get_impl(table->buckets, i));
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), true);
+        if (!tree) {
+            return false;
+        }
 
-        if(xrbtree_put_unique((XRBTree_PT)xparray_get_impl(table->buckets, i), key, value)) {
-            table->size += xrbtree_size((XRBTree_PT)xparray_get_impl(table->buckets, i)) - size;
-            return true;
+        int size = xrbtree_size(tree);
+        bool ret = replace ? xrbtree_put_replace_hash(tree, key, value, hash, NULL, false) : xrbtree_put_repeat_hash(tree, key, value, hash, true);
+
+        if (ret) {
+            table->size += xrbtree_size(tree) - size;
+            xrbtreehash_grow_if(table);
         }
 
+        return ret;
+    }
+}
+
+bool xrbtreehash_put_unique(XRBTreeHash_PT table, void *key, void *value) {
+    xassert(table);
+    xassert(key);
+
+    if (!table || !key) {
         return false;
     }
+
+    return xrbtreehash_put_hashed(table, key, value, (*table->hash)(key), false);
 }
 
 static 
@@ -164,20 +378,23 @@ bool xrbtreehash_put_replace_impl(XRBTreeHash_PT table, void *key, void *value,
         return false;
     }
 
-    {
-        int i = (*table->hash)(key) % table->slot;
-        int size = xrbtree_size((XRBTree_PT)xparray_get_impl(table->buckets, i));
-        bool ret = false;
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return false;
+    }
 
-        if (deep) {
-            ret = xrbtree_put_deep_replace((XRBTree_PT)xparray_get_impl(table->buckets, i), key, value);
-        }
-        else {
-            ret = xrbtree_put_replace((XRBTree_PT)xparray_get_impl(table->buckets, i), key, value, NULL);
+    {
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), true);
+        if (!tree) {
+            return false;
         }
 
+        int size = xrbtree_size(tree);
+        bool ret = xrbtree_put_replace_hash(tree, key, value, hash, NULL, deep);
+
         if (ret) {
-            table->size += xrbtree_size((XRBTree_PT)xparray_get_impl(table->buckets, i)) - size;
+            table->size += xrbtree_size(tree) - size;
+            xrbtreehash_grow_if(table);
             return ret;
         }
 
@@ -201,7 +418,16 @@ void* xrbtreehash_get(XRBTreeHash_PT table, void *key) {
         return NULL;
     }
 
-    return xrbtree_get((XRBTree_PT)xparray_get_impl(table->buckets, (*table->hash)(key) % table->slot), key);
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return NULL;
+    }
+
+    {
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
+        XRBTree_Node_PT node = tree ? xrbtree_get_hash_impl(tree, tree->root, key, hash) : NULL;
+        return node ? node->value : NULL;
+    }
 }
 
 XSList_PT xrbtreehash_get_all(XRBTreeHash_PT table, void *key) {
@@ -212,11 +438,168 @@ XSList_PT xrbtreehash_get_all(XRBTreeHash_PT table, void *key) {
         return NULL;
     }
 
-    return xrbtree_get_all((XRBTree_PT)xparray_get_impl(table->buckets, (*table->hash)(key) % table->slot), key);
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return NULL;
+    }
+
+    {
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
+        return tree ? xrbtree_get_all_hash(tree, key, hash) : NULL;
+    }
 }
 
 bool xrbtreehash_find(XRBTreeHash_PT table, void *key) {
-    return xrbtree_find((XRBTree_PT)xparray_get_impl(table->buckets, (*table->hash)(key) % table->slot), key);
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return false;
+    }
+
+    XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
+    return tree ? (xrbtree_get_hash_impl(tree, tree->root, key, hash) != NULL) : false;
+}
+
+/* hash all keys of one batch, and prefetch their buckets, the trees and the tree roots level by level,
+ * so the memory loads of different keys are overlapped before the trees are searched one by one
+ */
+static
+void xrbtreehash_batch_prefetch(XRBTreeHash_PT table, void **keys, int count, int *hashes) {
+    for (int i = 0; i < count; ++i) {
+        hashes[i] = (*table->hash)(keys[i]);
+        XUTILS_PREFETCH(table->buckets->datas + xutils_hash_bucket_index(hashes[i], table->slot));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        XRBTree_PT tree = (XRBTree_PT)table->buckets->datas[xutils_hash_bucket_index(hashes[i], table->slot)];
+        if (tree) {
+            XUTILS_PREFETCH(tree);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        XRBTree_PT tree = (XRBTree_PT)table->buckets->datas[xutils_hash_bucket_index(hashes[i], table->slot)];
+        if (tree && tree->root) {
+            XUTILS_PREFETCH(tree->root);
+        }
+    }
+}
+
+/* the tree of key, NULL if it is not in the table */
+static
+XRBTree_PT xrbtreehash_batch_bucket(XRBTreeHash_PT table, int hash) {
+    if (!xrbtreehash_rehash_hash(table, hash)) {
+        return NULL;
+    }
+
+    return xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
+}
+
+int xrbtreehash_get_many(XRBTreeHash_PT table, void **keys, int count, void **values) {
+    xassert(table);
+    xassert(keys);
+    xassert(values);
+    xassert(0 <= count);
+
+    if (!table || !keys || !values || (count < 0)) {
+        return 0;
+    }
+
+    {
+        int hashes[XUTILS_HASH_BATCH_SIZE];
+        int found = 0;
+
+        for (int start = 0; start < count; start += XUTILS_HASH_BATCH_SIZE) {
+            int batch = (count - start < XUTILS_HASH_BATCH_SIZE) ? (count - start) : XUTILS_HASH_BATCH_SIZE;
+
+            xrbtreehash_batch_prefetch(table, keys + start, batch, hashes);
+
+            for (int i = 0; i < batch; ++i) {
+                XRBTree_PT tree = xrbtreehash_batch_bucket(table, hashes[i]);
+                XRBTree_Node_PT node = tree ? xrbtree_get_hash_impl(tree, tree->root, keys[start + i], hashes[i]) : NULL;
+
+                values[start + i] = node ? node->value : NULL;
+                if (node) {
+                    ++found;
+                }
+            }
+        }
+
+        return found;
+    }
+}
+
+int xrbtreehash_find_many(XRBTreeHash_PT table, void **keys, int count, bool *founds) {
+    xassert(table);
+    xassert(keys);
+    xassert(0 <= count);
+
+    if (!table || !keys || (count < 0)) {
+        return 0;
+    }
+
+    {
+        int hashes[XUTILS_HASH_BATCH_SIZE];
+        int found = 0;
+
+        for (int start = 0; start < count; start += XUTILS_HASH_BATCH_SIZE) {
+            int batch = (count - start < XUTILS_HASH_BATCH_SIZE) ? (count - start) : XUTILS_HASH_BATCH_SIZE;
+
+            xrbtreehash_batch_prefetch(table, keys + start, batch, hashes);
+
+            for (int i = 0; i < batch; ++i) {
+                XRBTree_PT tree = xrbtreehash_batch_bucket(table, hashes[i]);
+                bool ret = tree ? (xrbtree_get_hash_impl(tree, tree->root, keys[start + i], hashes[i]) != NULL) : false;
+
+                if (founds) {
+                    founds[start + i] = ret;
+                }
+                if (ret) {
+                    ++found;
+                }
+            }
+        }
+
+        return found;
+    }
+}
+
+static
+int xrbtreehash_put_many_impl(XRBTreeHash_PT table, void **keys, void **values, int count, bool replace) {
+    xassert(table);
+    xassert(keys);
+    xassert(0 <= count);
+
+    if (!table || !keys || (count < 0)) {
+        return 0;
+    }
+
+    {
+        int hashes[XUTILS_HASH_BATCH_SIZE];
+        int put = 0;
+
+        for (int start = 0; start < count; start += XUTILS_HASH_BATCH_SIZE) {
+            int batch = (count - start < XUTILS_HASH_BATCH_SIZE) ? (count - start) : XUTILS_HASH_BATCH_SIZE;
+
+            /* the table may grow in the batch, so only the hash codes are kept, not the bucket indexes */
+            xrbtreehash_batch_prefetch(table, keys + start, batch, hashes);
+
+            for (int i = 0; i < batch; ++i) {
+                if (xrbtreehash_put_hashed(table, keys[start + i], values ? values[start + i] : NULL, hashes[i], replace)) {
+                    ++put;
+                }
+            }
+        }
+
+        return put;
+    }
+}
+
+int xrbtreehash_put_unique_many(XRBTreeHash_PT table, void **keys, void **values, int count) {
+    return xrbtreehash_put_many_impl(table, keys, values, count, false);
+}
+
+int xrbtreehash_put_replace_many(XRBTreeHash_PT table, void **keys, void **values, int count) {
+    return xrbtreehash_put_many_impl(table, keys, values, count, true);
 }
 
 bool xrbtreehash_remove(XRBTreeHash_PT table, void *key) {
@@ -227,10 +610,15 @@ bool xrbtreehash_remove(XRBTreeHash_PT table, void *key) {
         return false;
     }
 
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return false;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
 
-        int count = xrbtree_remove((XRBTree_PT)xparray_get_impl(table->buckets, i), key);
+        int count = tree ? xrbtree_remove_hash(tree, key, hash, false) : 0;
 
         table->size -= count;
 
@@ -246,10 +634,15 @@ bool xrbtreehash_deep_remove(XRBTreeHash_PT table, void *key) {
         return false;
     }
 
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return false;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
 
-        int count = xrbtree_deep_remove((XRBTree_PT)xparray_get_impl(table->buckets, i), key);
+        int count = tree ? xrbtree_remove_hash(tree, key, hash, true) : 0;
 
         table->size -= count;
 
@@ -265,10 +658,15 @@ int xrbtreehash_remove_all(XRBTreeHash_PT table, void *key) {
         return 0;
     }
 
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
 
-        int count = xrbtree_remove_all((XRBTree_PT)xparray_get_impl(table->buckets, i), key);
+        int count = tree ? xrbtree_remove_all_hash(tree, key, hash, false) : 0;
 
         table->size -= count;
 
@@ -284,10 +682,15 @@ int xrbtreehash_deep_remove_all(XRBTreeHash_PT table, void *key) {
         return 0;
     }
 
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return 0;
+    }
+
     {
-        int i = (*table->hash)(key) % table->slot;
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
 
-        int count = xrbtree_deep_remove_all((XRBTree_PT)xparray_get_impl(table->buckets, i), key);
+        int count = tree ? xrbtree_remove_all_hash(tree, key, hash, true) : 0;
 
         table->size -= count;
 
@@ -303,13 +706,19 @@ void xrbtreehash_clear_impl(XRBTreeHash_PT table, bool deep, bool (*apply)(void
         return;
     }
 
+    /* give the buckets back, they will be created again by the next put into them */
     if (0 < table->size) {
-        for (int i = 0; i < table->slot; i++) {
-            XRBTree_PT tree = (XRBTree_PT)xparray_get_impl(table->buckets, i);
-            deep ? xrbtree_deep_clear(tree) : (apply ? xrbtree_clear_apply(tree, apply, cl) : xrbtree_clear(tree));
-        }
+        xrbtreehash_buckets_free(table->buckets, table->slot, deep, apply, cl);
     }
 
+    if (table->old_buckets) {
+        xrbtreehash_buckets_free(table->old_buckets, table->old_slot, deep, apply, cl);
+        xrbtreehash_rehash_end(table);
+    }
+
+    /* all the trees sharing the slab are gone */
+    xslab_clear(table->slab);
+
     table->size = 0;
 }
 
@@ -334,13 +743,16 @@ void xrbtreehash_free_impl(XRBTreeHash_PT *table, bool deep, bool (*apply)(void
         return;
     }
 
-    for (int i = 0; i < (*table)->slot; i++) {
-        XRBTree_PT tree = (XRBTree_PT)xparray_get_impl((*table)->buckets, i);
-        deep ? xrbtree_deep_free(&tree) : (apply ? xrbtree_free_apply(&tree, apply, cl) : xrbtree_free(&tree));
+    xrbtreehash_buckets_free((*table)->buckets, (*table)->slot, deep, apply, cl);
+    xparray_free(&((*table)->buckets));
+
+    if ((*table)->old_buckets) {
+        xrbtreehash_buckets_free((*table)->old_buckets, (*table)->old_slot, deep, apply, cl);
+        xparray_free(&((*table)->old_buckets));
     }
 
-    xparray_free(&((*table)->buckets));
-    XMEM_FREE(*table);
+    xslab_free(&((*table)->slab));
+    XMEM_FREE_BY((*table)->allocator, *table, sizeof(**table));
 }
 
 void xrbtreehash_free(XRBTreeHash_PT *table) {
@@ -366,8 +778,11 @@ int xrbtreehash_map(XRBTreeHash_PT table, bool (*apply)(void *key, void **value,
     {
         int total = 0;
 
-        for (int i = 0; i < table->slot; i++) {
-            total += xrbtree_map_min_to_max((XRBTree_PT)xparray_get_impl(table->buckets, i), apply, cl);
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XRBTree_PT tree = xrbtreehash_bucket_at(table, i);
+            if (tree) {
+                total += xrbtree_map_min_to_max(tree, apply, cl);
+            }
         }
 
         return total;
@@ -383,8 +798,9 @@ bool xrbtreehash_map_break_if_true(XRBTreeHash_PT table, bool (*apply)(void *key
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xrbtree_map_min_to_max_break_if_true((XRBTree_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XRBTree_PT tree = xrbtreehash_bucket_at(table, i);
+            if (tree && xrbtree_map_min_to_max_break_if_true(tree, apply, cl)) {
                 return true;
             }
         }
@@ -401,8 +817,9 @@ bool xrbtreehash_map_break_if_false(XRBTreeHash_PT table, bool (*apply)(void *ke
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xrbtree_map_min_to_max_break_if_false((XRBTree_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XRBTree_PT tree = xrbtreehash_bucket_at(table, i);
+            if (tree && xrbtree_map_min_to_max_break_if_false(tree, apply, cl)) {
                 return true;
             }
         }
@@ -422,8 +839,11 @@ int xrbtreehash_map_key(XRBTreeHash_PT table, bool (*apply)(void *key, void *cl)
     {
         int total = 0;
 
-        for (int i = 0; i < table->slot; i++) {
-            total += xrbtree_map_key_min_to_max((XRBTree_PT)xparray_get_impl(table->buckets, i), apply, cl);
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XRBTree_PT tree = xrbtreehash_bucket_at(table, i);
+            if (tree) {
+                total += xrbtree_map_key_min_to_max(tree, apply, cl);
+            }
         }
 
         return total;
@@ -439,8 +859,9 @@ bool xrbtreehash_map_key_break_if_true(XRBTreeHash_PT table, bool (*apply)(void
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xrbtree_map_key_min_to_max_break_if_true((XRBTree_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XRBTree_PT tree = xrbtreehash_bucket_at(table, i);
+            if (tree && xrbtree_map_key_min_to_max_break_if_true(tree, apply, cl)) {
                 return true;
             }
         }
@@ -457,8 +878,9 @@ bool xrbtreehash_map_key_break_if_false(XRBTreeHash_PT table, bool (*apply)(void
     }
 
     {
-        for (int i = 0; i < table->slot; i++) {
-            if (xrbtree_map_key_min_to_max_break_if_false((XRBTree_PT)xparray_get_impl(table->buckets, i), apply, cl)) {
+        for (int i = 0; i < table->slot + table->old_slot; i++) {
+            XRBTree_PT tree = xrbtreehash_bucket_at(table, i);
+            if (tree && xrbtree_map_key_min_to_max_break_if_false(tree, apply, cl)) {
                 return true;
             }
         }
@@ -470,8 +892,10 @@ bool xrbtreehash_map_key_break_if_false(XRBTreeHash_PT table, bool (*apply)(void
 bool xrbtreehash_swap(XRBTreeHash_PT table1, XRBTreeHash_PT table2) {
     xassert(table1);
     xassert(table2);
+    /* buckets, trees and slab can't move to a table which allocates from another allocator */
+    xassert(table1->allocator == table2->allocator);
 
-    if (!table1 || !table2) {
+    if (!table1 || !table2 || (table1->allocator != table2->allocator)) {
         return false;
     }
 
@@ -482,6 +906,11 @@ bool xrbtreehash_swap(XRBTreeHash_PT table1, XRBTreeHash_PT table2) {
         void *cl = table1->cl;
         int(*hash)(void *key) = table1->hash;
         XPArray_PT buckets = table1->buckets;
+        XPArray_PT old_buckets = table1->old_buckets;
+        int old_slot = table1->old_slot;
+        int rehash_index = table1->rehash_index;
+        double max_loading_factor = table1->max_loading_factor;
+        XSlab_PT slab = table1->slab;
 
         table1->slot = table2->slot;
         table1->size = table2->size;
@@ -489,6 +918,11 @@ bool xrbtreehash_swap(XRBTreeHash_PT table1, XRBTreeHash_PT table2) {
         table1->cl = table2->cl;
         table1->hash = table2->hash;
         table1->buckets = table2->buckets;
+        table1->old_buckets = table2->old_buckets;
+        table1->old_slot = table2->old_slot;
+        table1->rehash_index = table2->rehash_index;
+        table1->max_loading_factor = table2->max_loading_factor;
+        table1->slab = table2->slab;
 
         table2->slot = slot;
         table2->size = size;
@@ -496,6 +930,11 @@ bool xrbtreehash_swap(XRBTreeHash_PT table1, XRBTreeHash_PT table2) {
         table2->cl = cl;
         table2->hash = hash;
         table2->buckets = buckets;
+        table2->old_buckets = old_buckets;
+        table2->old_slot = old_slot;
+        table2->rehash_index = rehash_index;
+        table2->max_loading_factor = max_loading_factor;
+        table2->slab = slab;
     }
 
     return true;
@@ -517,7 +956,15 @@ int xrbtreehash_key_size(XRBTreeHash_PT table, void *key) {
         return 0;
     }
 
-    return xrbtree_keys_size((XRBTree_PT)xparray_get_impl(table->buckets, (*table->hash)(key) % table->slot), key, key);
+    int hash = 0;
+    if (!xrbtreehash_hash_key(table, key, &hash)) {
+        return 0;
+    }
+
+    {
+        XRBTree_PT tree = xrbtreehash_bucket(table, xutils_hash_bucket_index(hash, table->slot), false);
+        return tree ? xrbtree_key_size_hash(tree, key, hash) : 0;
+    }
 }
 
 double xrbtreehash_loading_factor(XRBTreeHash_PT table) {
@@ -537,5 +984,42 @@ int xrbtreehash_elems_in_bucket(XRBTreeHash_PT table, int bucket) {
         return 0;
     }
 
-    return xrbtree_size((XRBTree_PT)xparray_get_impl(table->buckets, bucket)) ;
+    return xrbtree_size(xrbtreehash_bucket(table, bucket, false));
+}
+
+bool xrbtreehash_resize(XRBTreeHash_PT table, int new_hint) {
+    xassert(table);
+    xassert(0 < new_hint);
+
+    if (!table || (new_hint <= 0)) {
+        return false;
+    }
+
+    return xrbtreehash_resize_impl(table, new_hint) && xrbtreehash_rehash_all(table);
+}
+
+bool xrbtreehash_resize_incremental(XRBTreeHash_PT table, int new_hint) {
+    xassert(table);
+    xassert(0 < new_hint);
+
+    if (!table || (new_hint <= 0)) {
+        return false;
+    }
+
+    return xrbtreehash_resize_impl(table, new_hint);
+}
+
+bool xrbtreehash_is_rehashing(XRBTreeHash_PT table) {
+    return (table ? (table->old_buckets != NULL) : false);
+}
+
+void xrbtreehash_set_max_loading_factor(XRBTreeHash_PT table, double factor) {
+    xassert(table);
+    xassert(0 <= factor);
+
+    if (!table || (factor < 0)) {
+        return;
+    }
+
+    table->max_loading_factor = factor;
 }
@@ -15,6 +15,7 @@
 
 #include "../include/xarray_pointer.h"
 #include "../include/xhash_rbtree.h"
+#include "../include/xmem_slab.h"
 
 struct XRBTreeHash {
     XPArray_PT buckets;                      /* buckets[i] is type of XRBTree_PT */
@@ -26,6 +27,16 @@ struct XRBTreeHash {
 
     int  (*cmp)(void *key1, void *key2, void *cl);   /* compare the key in XRBTree_PT */
     void  *cl;
+
+    XPArray_PT old_buckets;                  /* buckets before incremental resize, NULL if no resize is in progress */
+    int old_slot;                            /* == old_buckets->size */
+    int rehash_index;                        /* old_buckets[0, rehash_index) are all moved into buckets */
+
+    double max_loading_factor;               /* resize automatically when size / slot exceeds it, 0 : never */
+
+    XSlab_PT slab;                           /* shared by the trees of all buckets, the nodes moved by rehash are recycled in it */
+
+    XMem_Allocator_PT allocator;             /* the table, buckets and trees come from it, NULL : XMEM */
 };
 
 #endif
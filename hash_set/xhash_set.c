@@ -13,97 +13,112 @@
 #include <stddef.h>
 
 #include "../include/xhash_rbtree.h"
+#include "../include/xhash_flat.h"
 #include "../include/xhash_set.h"
 
+#ifdef XHASH_FLAT
+#define XHASH_IMPL(name)  xflathash_##name
+#else
+#define XHASH_IMPL(name)  xrbtreehash_##name
+#endif
+
 XHashSet_PT xhashset_new(int hint, int(*hash)(void *elem), int (*cmp)(void *elem1, void *elem2, void *cl), void *cl) {
-    return xrbtreehash_new(hint, hash, cmp, cl);
+    return XHASH_IMPL(new)(hint, hash, cmp, cl);
 }
 
 XHashSet_PT xhashset_copy(XHashSet_PT set) {
-    return xrbtreehash_copy(set);
+    return XHASH_IMPL(copy)(set);
 }
 
 XHashSet_PT xhashset_deep_copy(XHashSet_PT set, int elem_size) {
-    return xrbtreehash_deep_copy(set, elem_size, 0);
+    return XHASH_IMPL(deep_copy)(set, elem_size, 0);
 }
 
 bool xhashset_put_repeat(XHashSet_PT set, void *elem) {
-    return xrbtreehash_put_repeat(set, elem, NULL);
+    return XHASH_IMPL(put_repeat)(set, elem, NULL);
 }
 
 int xhashset_put_unique(XHashSet_PT set, void *elem) {
-    return xrbtreehash_put_unique(set, elem, NULL);
+    return XHASH_IMPL(put_unique)(set, elem, NULL);
 }
 
 bool xhashset_find(XHashSet_PT set, void *elem) {
-    return xrbtreehash_find(set, elem);
+    return XHASH_IMPL(find)(set, elem);
+}
+
+int xhashset_put_many(XHashSet_PT set, void **elems, int count) {
+    return XHASH_IMPL(put_unique_many)(set, elems, NULL, count);
+}
+
+int xhashset_find_many(XHashSet_PT set, void **elems, int count, bool *founds) {
+    return XHASH_IMPL(find_many)(set, elems, count, founds);
 }
 
 bool xhashset_remove(XHashSet_PT set, void *elem) {
-    return xrbtreehash_remove(set, elem);
+    return XHASH_IMPL(remove)(set, elem);
 }
 
 bool xhashset_deep_remove(XHashSet_PT set, void *elem) {
-    return xrbtreehash_deep_remove(set, elem);
+    return XHASH_IMPL(deep_remove)(set, elem);
 }
 
 int xhashset_remove_all(XHashSet_PT set, void *elem) {
-    return xrbtreehash_remove_all(set, elem);
+    return XHASH_IMPL(remove_all)(set, elem);
 }
 
 int xhashset_deep_remove_all(XHashSet_PT set, void *elem) {
-    return xrbtreehash_deep_remove_all(set, elem);
+    return XHASH_IMPL(deep_remove_all)(set, elem);
 }
 
 void xhashset_clear(XHashSet_PT set) {
-    xrbtreehash_clear(set);
+    XHASH_IMPL(clear)(set);
 }
 
 void xhashset_deep_clear(XHashSet_PT set) {
-    xrbtreehash_deep_clear(set);
+    XHASH_IMPL(deep_clear)(set);
 }
 
 void xhashset_free(XHashSet_PT *set) {
-    xrbtreehash_free(set);
+    XHASH_IMPL(free)(set);
 }
 
 void xhashset_deep_free(XHashSet_PT *set) {
-    xrbtreehash_deep_free(set);
+    XHASH_IMPL(deep_free)(set);
 }
 
 int xhashset_map(XHashSet_PT set, bool (*apply)(void *elem, void *cl), void *cl) {
-    return xrbtreehash_map_key(set, apply, cl);
+    return XHASH_IMPL(map_key)(set, apply, cl);
 }
 
 bool xhashset_map_break_if_true(XHashSet_PT set, bool (*apply)(void *elem, void *cl), void *cl) {
-    return xrbtreehash_map_key_break_if_true(set, apply, cl);
+    return XHASH_IMPL(map_key_break_if_true)(set, apply, cl);
 }
 
 bool xhashset_map_break_if_false(XHashSet_PT set, bool (*apply)(void *elem, void *cl), void *cl) {
-    return xrbtreehash_map_key_break_if_false(set, apply, cl);
+    return XHASH_IMPL(map_key_break_if_false)(set, apply, cl);
 }
 
 bool xhashset_swap(XHashSet_PT set1, XHashSet_PT set2) {
-    return xrbtreehash_swap(set1, set2);
+    return XHASH_IMPL(swap)(set1, set2);
 }
 
 int xhashset_size(XHashSet_PT set) {
-    return xrbtreehash_size(set);
+    return XHASH_IMPL(size)(set);
 }
 
 bool xhashset_is_empty(XHashSet_PT set) {
-    return xrbtreehash_is_empty(set);
+    return XHASH_IMPL(is_empty)(set);
 }
 
 int xhashset_count(XHashSet_PT set, void *elem) {
-    return xrbtreehash_key_size(set, elem);
+    return XHASH_IMPL(key_size)(set, elem);
 }
 
 double xhashset_loading_factor(XHashSet_PT set) {
-    return xrbtreehash_loading_factor(set);
+    return XHASH_IMPL(loading_factor)(set);
 }
 
 int xhashset_elem_size(XHashSet_PT set, void *elem) {
-    return xrbtreehash_key_size(set, elem);
+    return XHASH_IMPL(key_size)(set, elem);
 }
 
@@ -37,11 +37,13 @@
  *          XMEM_NEW0N
  *          XMEM_RESIZE
  *          XMEM_RESIZE0
+ *          XMem_Allocator_T  (*_new_allocator, xarena_allocator)
  *
  *  Data Structures           (directory name)                 (header file)     test
  *
  *      Memory Arena :
- *          XArena_PT         (mem_arena)                      xmem_arena.h     
+ *          XArena_PT         (mem_arena)                      xmem_arena.h      Tested
+ *          XSlab_PT          (mem_slab)                       xmem_slab.h       Tested
  *
  *      Bit :
  *          XBit_PT           (bit)                            xbit.h            Tested
@@ -100,18 +102,24 @@
  *          XKVHashtab_PT     (hash_kvtable)                   xhash_kvtable.h   Tested
  *          XHashtab_PT       (hash_table)                     xhash_table.h     Tested by XRBTreeHash_PT
  *          XRBTreeHash_PT    (hash_rbtree)                    xhash_rbtree.h    Tested
+ *          XFlatHash_PT      (hash_flat)                      xhash_flat.h      Tested
  *
  *      Tree :
  *          XBinTree_PT       (tree_binary)                    xtree_binary.h          Tested
  *          XBSTree_PT        (tree_binary_search)             xtree_binary_search.h   Tested
- *          XRBTree_PT        (tree_redblack)                  xtree_redblack.h        Tested
+ *          XRBTree_PT        (tree_redblack)                  xtree_redblack.h        Tested      (color packed in the parent pointer if XRBTREE_COMPACT_NODE is defined)
  *          XListRBTree_PT    (tree_redblack_list)             xtree_redblack_list.h   Tested      (all values for the "same" key are saved in a XRSList_PT)
  *          XAVLTree_PT       (tree_avl)                       xtree_avl.h             Tested
+ *          XBPTree_PT        (tree_bplus)                     xtree_bplus.h           Tested      (XMap_PT uses it if XMAP_BPTREE is defined)
+ *          XARTree_PT        (tree_adaptive_radix)            xtree_adaptive_radix.h  Tested      (keys are strings, ordered by bytes)
  *          XMTree_PT         (tree_multiple_branch)           xmtree.h
+ *          XPRBTree_PT       (tree_redblack_persistent)       xtree_redblack_persistent.h  Tested      (linux only, snapshots for lock-free readers)
  *
  *      Map :
  *          XHashMap_PT       (hash_map)                       xhash_map.h
  *          XMap_PT           (tree_map)                       xmap.h
+ *          XTS_HashMap_PT    (hash_map_thread)                xhash_map_thread.h     Tested      (linux only, thread safe)
+ *          XTS_SkipMap_PT    (skiplist_map_thread)            xskiplist_map_thread.h Tested      (linux only, lock-free, ordered)
  *
  *      Set :
  *          XHashSet_PT       (hash_set)                       xhash_set.h            Tested 
@@ -236,6 +244,7 @@
 /* memory */
 #include "xmem.h"
 #include "xmem_arena.h"
+#include "xmem_slab.h"
 
 /* pair */
 #include "xpair.h"
@@ -300,6 +309,7 @@
 #include "xhash_kvtable.h"
 #include "xhash_table.h"
 #include "xhash_rbtree.h"
+#include "xhash_flat.h"
 
 /* tree */
 #include "xtree_binary.h"
@@ -307,6 +317,8 @@
 #include "xtree_redblack.h"
 #include "xtree_redblack_list.h"
 #include "xtree_avl.h"
+#include "xtree_bplus.h"
+#include "xtree_adaptive_radix.h"
 #include "xtree_multiple_branch.h"
 
 /* map */
@@ -332,6 +344,15 @@
 #include "xlist_s_thread.h"
 #include "xlist_d_thread.h"
 
+/* thread safe hash map */
+#include "xhash_map_thread.h"
+
+/* lock-free ordered map */
+#include "xskiplist_map_thread.h"
+
+/* persistent red-black tree */
+#include "xtree_redblack_persistent.h"
+
 /* semaphore */
 #include "xthread_sem.h"
 
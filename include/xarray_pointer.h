@@ -14,6 +14,7 @@
 #define XPARRAY_INCLUDED
 
 #include <stdbool.h>
+#include "xmem.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +24,8 @@ typedef struct XPArray* XPArray_PT;
 
 /* O(1) */
 extern XPArray_PT  xparray_new                   (int size);
+/* the array and its pointer memory come from allocator (NULL : XMEM), the elements themselves are not touched */
+extern XPArray_PT  xparray_new_allocator         (int size, XMem_Allocator_PT allocator);
 
 /* O(N) */
 extern XPArray_PT  xparray_copy                  (XPArray_PT array);
@@ -99,7 +102,7 @@ extern bool        xparray_deep_remove_resize    (XPArray_PT array, int i);
 extern int         xparray_size                  (XPArray_PT array);
 extern bool        xparray_is_empty              (XPArray_PT array);
 
-/* O(1) */
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool        xparray_swap                  (XPArray_PT array1, XPArray_PT array2);
 
 /* O(1) */
@@ -25,6 +25,8 @@ extern "C" {
 typedef XGraph_PT XDigraph_PT;
 
 extern XDigraph_PT  xdigraph_new                   (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl);
+/* O(1), the graph and its adjacent sets come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XDigraph_PT  xdigraph_new_allocator         (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 extern void         xdigraph_free                  (XDigraph_PT *graph);
 extern void         xdigraph_deep_free             (XDigraph_PT *graph);
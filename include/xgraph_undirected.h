@@ -39,6 +39,8 @@ typedef struct XGraph *XGraph_PT;
 
 /* O(1) */
 extern XGraph_PT  xgraph_new                    (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl);
+/* O(1), the graph and its adjacent sets come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XGraph_PT  xgraph_new_allocator          (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(ElgE+VlgV) */
 extern void       xgraph_free                   (XGraph_PT *graph);
@@ -29,6 +29,8 @@ typedef XWGraph_PT XWDigraph_PT;
 
 /* O(1) */
 extern XWDigraph_PT  xwdigraph_new                    (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl);
+/* O(1), the graph and its adjacent sets come from allocator (NULL : XMEM), the edges still come from XMEM */
+extern XWDigraph_PT  xwdigraph_new_allocator          (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(1) */
 extern XDigraph_PT   xwgraph_native_digraph           (XWDigraph_PT graph);   /* We can get all same functions as XDigraph_PT by this interface */
@@ -28,6 +28,8 @@ typedef struct XWGraph *XWGraph_PT;
 
 /* O(1) */
 extern XWGraph_PT  xwgraph_new                    (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl);
+/* O(1), the graph and its adjacent sets come from allocator (NULL : XMEM), the edges still come from XMEM */
+extern XWGraph_PT  xwgraph_new_allocator          (int (*cmp)(void *vertex1, void *vertex2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(1) */
 extern XGraph_PT   xwgraph_native_graph           (XWGraph_PT graph);  /* We can get all same functions as XGraph_PT by this interface */
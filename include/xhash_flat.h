@@ -0,0 +1,106 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XFLATHASH_INCLUDED
+#define XFLATHASH_INCLUDED
+
+#include <stdbool.h>
+#include "xlist_s.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct XFlatHash* XFlatHash_PT;
+
+/* O(1) */
+extern XFlatHash_PT      xflathash_new                (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the table and its slots come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XFlatHash_PT      xflathash_new_allocator      (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
+
+/* O(N) */
+extern XFlatHash_PT      xflathash_copy               (XFlatHash_PT table);
+extern XFlatHash_PT      xflathash_deep_copy          (XFlatHash_PT table, int key_size, int value_size);
+
+/* O(1) */
+extern bool              xflathash_put_repeat         (XFlatHash_PT table, void *key, void *value);
+extern bool              xflathash_put_unique         (XFlatHash_PT table, void *key, void *value);
+extern bool              xflathash_put_replace        (XFlatHash_PT table, void *key, void *value);
+extern bool              xflathash_put_deep_replace   (XFlatHash_PT table, void *key, void *value);
+
+/* O(1) */
+extern void*             xflathash_get                (XFlatHash_PT table, void *key);
+extern bool              xflathash_find               (XFlatHash_PT table, void *key);
+
+/* O(M) : M keys are hashed and their first probed groups are prefetched batch by batch before searching,
+ *        values[i] (NULL if keys[i] is not found) or founds[i] (could be NULL) saves the result of keys[i],
+ *        return how many keys are found (or put successfully)
+ */
+extern int               xflathash_get_many           (XFlatHash_PT table, void **keys, int count, void **values);
+extern int               xflathash_find_many          (XFlatHash_PT table, void **keys, int count, bool *founds);
+extern int               xflathash_put_unique_many    (XFlatHash_PT table, void **keys, void **values, int count);
+extern int               xflathash_put_replace_many   (XFlatHash_PT table, void **keys, void **values, int count);
+
+/* O(1) */
+extern XSList_PT         xflathash_get_all            (XFlatHash_PT table, void *key);
+
+/* O(1) */
+extern bool              xflathash_remove             (XFlatHash_PT table, void *key);
+extern bool              xflathash_deep_remove        (XFlatHash_PT table, void *key);
+
+/* O(1) */
+extern int               xflathash_remove_all         (XFlatHash_PT table, void *key);
+extern int               xflathash_deep_remove_all    (XFlatHash_PT table, void *key);
+
+/* O(N) */
+extern void              xflathash_clear              (XFlatHash_PT table);
+extern void              xflathash_clear_apply        (XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern void              xflathash_deep_clear         (XFlatHash_PT table);
+
+/* O(N) */
+extern void              xflathash_free               (XFlatHash_PT *table);
+extern void              xflathash_free_apply         (XFlatHash_PT *table, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern void              xflathash_deep_free          (XFlatHash_PT *table);
+
+/* O(N) : all map interfaces */
+extern int               xflathash_map                (XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool              xflathash_map_break_if_true  (XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool              xflathash_map_break_if_false (XFlatHash_PT table, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+extern int               xflathash_map_key                (XFlatHash_PT table, bool (*apply)(void *key, void *cl), void *cl);
+extern bool              xflathash_map_key_break_if_true  (XFlatHash_PT table, bool (*apply)(void *key, void *cl), void *cl);
+extern bool              xflathash_map_key_break_if_false (XFlatHash_PT table, bool (*apply)(void *key, void *cl), void *cl);
+
+/* O(1), both must use the same allocator (see *_new_allocator) */
+extern bool              xflathash_swap               (XFlatHash_PT table1, XFlatHash_PT table2);
+
+/* O(1) */
+extern int               xflathash_size               (XFlatHash_PT table);
+extern bool              xflathash_is_empty           (XFlatHash_PT table);
+
+/* O(1) */
+extern int               xflathash_key_size           (XFlatHash_PT table, void *key);
+
+/* O(1) */
+extern double            xflathash_loading_factor     (XFlatHash_PT table);
+
+/* O(1) */
+extern int               xflathash_bucket_size        (XFlatHash_PT table);
+
+/* O(N) */
+extern bool              xflathash_resize             (XFlatHash_PT table, int new_hint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,6 +26,10 @@ typedef struct XKVHashtab* XKVHashtab_PT;
 
 /* O(hint) */
 extern XKVHashtab_PT     xkvhashtab_new                (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(hint), the table and its bucket arrays come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h,
+ * the lists in the buckets still come from XMEM
+ */
+extern XKVHashtab_PT     xkvhashtab_new_allocator      (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(N) */
 extern XKVHashtab_PT     xkvhashtab_copy               (XKVHashtab_PT table);
@@ -72,7 +76,7 @@ extern int               xkvhashtab_map_key                (XKVHashtab_PT table,
 extern bool              xkvhashtab_map_key_break_if_true  (XKVHashtab_PT table, bool (*apply)(void *key, void *cl), void *cl);
 extern bool              xkvhashtab_map_key_break_if_false (XKVHashtab_PT table, bool (*apply)(void *key, void *cl), void *cl);
 
-/* O(1) */
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool              xkvhashtab_swap               (XKVHashtab_PT table1, XKVHashtab_PT table2);
 
 /* O(1) */
@@ -95,6 +99,13 @@ extern int               xkvhashtab_key_size           (XKVHashtab_PT table, voi
 /* O(N) */
 extern bool              xkvhashtab_resize             (XKVHashtab_PT table, int new_hint);
 
+/* O(1) : elements are moved into the new buckets by the following put/get/remove, several buckets each time */
+extern bool              xkvhashtab_resize_incremental (XKVHashtab_PT table, int new_hint);
+extern bool              xkvhashtab_is_rehashing       (XKVHashtab_PT table);
+
+/* O(1) : 0 means never resize automatically, otherwise resize incrementally when loading factor exceeds it */
+extern void              xkvhashtab_set_max_loading_factor (XKVHashtab_PT table, double factor);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,12 +16,22 @@
 #include <stdbool.h>
 #include "xqueue_deque.h"
 #include "xhash_rbtree.h"
+#include "xhash_flat.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* macro definition :
+*    XHASH_FLAT :
+*      with this macro defined, XHashMap_PT is implemented by XFlatHash_PT (open addressing, SSE2 group probing),
+*      if not defined (default), XHashMap_PT is implemented by XRBTreeHash_PT.
+*/
+#ifdef XHASH_FLAT
+typedef XFlatHash_PT   XHashMap_PT;
+#else
 typedef XRBTreeHash_PT XHashMap_PT;
+#endif
 
 /* O(1) */
 extern XHashMap_PT  xhashmap_new                 (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl);
@@ -36,6 +46,10 @@ extern bool         xhashmap_put_unique          (XHashMap_PT map, void *key, vo
 extern bool         xhashmap_put_replace         (XHashMap_PT map, void *key, void *value);
 extern bool         xhashmap_put_deep_replace    (XHashMap_PT map, void *key, void *value);
 
+/* O(MlgN) : put/get M keys together, keys are hashed and prefetched batch by batch, return the number put/found */
+extern int          xhashmap_put_many            (XHashMap_PT map, void **keys, void **values, int count);
+extern int          xhashmap_get_many            (XHashMap_PT map, void **keys, int count, void **values);
+
 /* O(lgN) */
 extern bool         xhashmap_remove              (XHashMap_PT map, void *key);
 extern bool         xhashmap_remove_all          (XHashMap_PT map, void *key);
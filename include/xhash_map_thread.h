@@ -0,0 +1,72 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XTS_HASHMAP_INCLUDED
+#define XTS_HASHMAP_INCLUDED
+
+#if defined(__linux__)
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* keys are unique, the map is split into "segments" independent parts by the hash value of key,
+ * each part is protected by one reader-writer lock, so threads working on different parts do not block each other
+ */
+typedef struct XTS_HashMap*    XTS_HashMap_PT;
+
+/* O(1) */
+extern XTS_HashMap_PT    xts_hashmap_new                 (int segments, int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+
+/* O(lgN) */
+extern bool              xts_hashmap_put_replace         (XTS_HashMap_PT map, void *key, void *value);
+extern bool              xts_hashmap_put_if_absent       (XTS_HashMap_PT map, void *key, void *value);   /* false if key exists already */
+
+/* O(lgN) : new value = remap(key, old value, found or not), the key is removed if the new value is NULL,
+ *          remap is called with the part locked, do not use the map in it
+ */
+extern bool              xts_hashmap_compute             (XTS_HashMap_PT map, void *key, void* (*remap)(void *key, void *value, bool found, void *cl), void *cl);
+
+/* O(lgN) */
+extern void*             xts_hashmap_get                 (XTS_HashMap_PT map, void *key);
+extern bool              xts_hashmap_find                (XTS_HashMap_PT map, void *key);
+
+/* O(lgN) : true if key is found and removed */
+extern bool              xts_hashmap_remove              (XTS_HashMap_PT map, void *key);
+extern bool              xts_hashmap_deep_remove         (XTS_HashMap_PT map, void *key);
+
+/* O(N) : lock the parts one by one */
+extern void              xts_hashmap_clear               (XTS_HashMap_PT map);
+extern void              xts_hashmap_deep_clear          (XTS_HashMap_PT map);
+
+/* O(N) : no other thread should use the map any more */
+extern void              xts_hashmap_free                (XTS_HashMap_PT *pmap);
+extern void              xts_hashmap_deep_free           (XTS_HashMap_PT *pmap);
+
+/* O(N) : lock the parts one by one for reading, do not use the map in apply */
+extern int               xts_hashmap_map                 (XTS_HashMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(segments) */
+extern int               xts_hashmap_size                (XTS_HashMap_PT map);
+extern bool              xts_hashmap_is_empty            (XTS_HashMap_PT map);
+
+/* O(1) */
+extern int               xts_hashmap_segments            (XTS_HashMap_PT map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+#endif
@@ -24,6 +24,8 @@ typedef struct XRBTreeHash* XRBTreeHash_PT;
 
 /* O(1) */
 extern XRBTreeHash_PT    xrbtreehash_new                (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the table, its buckets and the trees in them come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XRBTreeHash_PT    xrbtreehash_new_allocator      (int hint, int (*hash)(void *key), int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(NlgN) */
 extern XRBTreeHash_PT    xrbtreehash_copy               (XRBTreeHash_PT table);
@@ -39,6 +41,15 @@ extern bool              xrbtreehash_put_deep_replace   (XRBTreeHash_PT table, v
 extern void*             xrbtreehash_get                (XRBTreeHash_PT table, void *key);
 extern bool              xrbtreehash_find               (XRBTreeHash_PT table, void *key);
 
+/* O(MlgN) : M keys are hashed and their buckets are prefetched batch by batch before searching,
+ *           values[i] (NULL if keys[i] is not found) or founds[i] (could be NULL) saves the result of keys[i],
+ *           return how many keys are found (or put successfully)
+ */
+extern int               xrbtreehash_get_many           (XRBTreeHash_PT table, void **keys, int count, void **values);
+extern int               xrbtreehash_find_many          (XRBTreeHash_PT table, void **keys, int count, bool *founds);
+extern int               xrbtreehash_put_unique_many    (XRBTreeHash_PT table, void **keys, void **values, int count);
+extern int               xrbtreehash_put_replace_many   (XRBTreeHash_PT table, void **keys, void **values, int count);
+
 /* O(NlgN) */
 extern XSList_PT         xrbtreehash_get_all            (XRBTreeHash_PT table, void *key);
 
@@ -69,7 +80,7 @@ extern int               xrbtreehash_map_key                (XRBTreeHash_PT tabl
 extern bool              xrbtreehash_map_key_break_if_true  (XRBTreeHash_PT table, bool (*apply)(void *key, void *cl), void *cl);
 extern bool              xrbtreehash_map_key_break_if_false (XRBTreeHash_PT table, bool (*apply)(void *key, void *cl), void *cl);
 
-/* O(1) */
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool              xrbtreehash_swap               (XRBTreeHash_PT table1, XRBTreeHash_PT table2);
 
 /* O(1) */
@@ -88,6 +99,16 @@ extern int               xrbtreehash_bucket_size        (XRBTreeHash_PT table);
 /* O(1) */
 extern int               xrbtreehash_elems_in_bucket    (XRBTreeHash_PT table, int bucket);
 
+/* O(NlgN) */
+extern bool              xrbtreehash_resize             (XRBTreeHash_PT table, int new_hint);
+
+/* O(1) : elements are moved into the new buckets by the following put/get/remove, several buckets each time */
+extern bool              xrbtreehash_resize_incremental (XRBTreeHash_PT table, int new_hint);
+extern bool              xrbtreehash_is_rehashing       (XRBTreeHash_PT table);
+
+/* O(1) : 0 means never resize automatically, otherwise resize incrementally when loading factor exceeds it */
+extern void              xrbtreehash_set_max_loading_factor (XRBTreeHash_PT table, double factor);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,12 +16,22 @@
 #include <stdbool.h>
 #include "xqueue_deque.h"
 #include "xhash_rbtree.h"
+#include "xhash_flat.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* macro definition :
+*    XHASH_FLAT :
+*      with this macro defined, XHashSet_PT is implemented by XFlatHash_PT (open addressing, SSE2 group probing),
+*      if not defined (default), XHashSet_PT is implemented by XRBTreeHash_PT.
+*/
+#ifdef XHASH_FLAT
+typedef XFlatHash_PT   XHashSet_PT;
+#else
 typedef XRBTreeHash_PT XHashSet_PT;
+#endif
 
 /* O(1) */
 extern XHashSet_PT  xhashset_new                (int hint, int (*hash)(void *elem), int (*cmp)(void *elem1, void *elem2, void *cl), void *cl);
@@ -37,6 +47,10 @@ extern int          xhashset_put_unique         (XHashSet_PT set, void *elem);
 /* O(lgN) */
 extern bool         xhashset_find               (XHashSet_PT set, void *elem);
 
+/* O(MlgN) : put/find M elements together, elements are hashed and prefetched batch by batch, return the number put/found */
+extern int          xhashset_put_many           (XHashSet_PT set, void **elems, int count);
+extern int          xhashset_find_many          (XHashSet_PT set, void **elems, int count, bool *founds);
+
 /* O(lgN) */
 extern bool         xhashset_remove             (XHashSet_PT set, void *elem);
 extern bool         xhashset_deep_remove        (XHashSet_PT set, void *elem);
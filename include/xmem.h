@@ -16,6 +16,7 @@
 /* macro definition : 
 *    XDEBUG :
 *      with this macro defined, file xmemchk.c will implement all interfaces,
+*      all the pointers are tracked for xmem_leak and checked by xmem_free (thread safe on linux),
 *      if not defined, xmem.c will implement all interfaces.
 *
 *    XMEM_RAISE_EXCEPT :
@@ -59,6 +60,28 @@ extern void  __real_free    (void *ptr);
 #define XMEM_RESIZE0(ptr, obytes, nbytes)   ((ptr) = xmem_resize0((ptr), (obytes), (nbytes), __FILE__, __LINE__))
 
 
+/* Allocator given to the *_new_allocator functions, all the memory of the container (and of the containers inside it)
+ * comes from it, so the container can live in an arena or a pool. A NULL allocator means the functions above.
+ *    alloc  : returns zeroed memory
+ *    resize : keeps the content like realloc, the old size of the block is given
+ *    free   : the size of the block is given
+ * The allocator must live longer than the containers using it.
+ * The bucket lists of XKVHashtab and the edges of the weighted graphs still come from XMEM.
+ */
+typedef struct XMem_Allocator  XMem_Allocator_T;
+typedef struct XMem_Allocator* XMem_Allocator_PT;
+struct XMem_Allocator {
+    void* (*alloc) (void *ctx, long nbytes);
+    void* (*resize)(void *ctx, void *ptr, long obytes, long nbytes);
+    void  (*free)  (void *ctx, void *ptr, long nbytes);
+    void   *ctx;
+};
+
+#define XMEM_ALLOC_BY(allocator, nbytes)                ((allocator) ? (allocator)->alloc((allocator)->ctx, (nbytes)) : XMEM_CALLOC(1, (nbytes)))
+#define XMEM_RESIZE_BY(allocator, ptr, obytes, nbytes)  ((allocator) ? (allocator)->resize((allocator)->ctx, (ptr), (obytes), (nbytes)) : xmem_resize((ptr), (nbytes), __FILE__, __LINE__))
+#define XMEM_FREE_BY(allocator, ptr, nbytes)            ((void)((allocator) ? (allocator)->free((allocator)->ctx, (ptr), (nbytes)) : xmem_free((ptr), __FILE__, __LINE__)), (void)((ptr) = 0))
+
+
 /* xmem_leak is used for memory leak checking */
 extern void  xmem_leak(void(*apply)  (const void *ptr, long size, const char *file, int line, void *cl), void *cl);
 
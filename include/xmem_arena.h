@@ -13,23 +13,87 @@
 #ifndef XARENA_INCLUDED
 #define XARENA_INCLUDED
 
+#include <stdio.h>
+#include <stdbool.h>
+#include "xmem.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct XArena* XArena_PT;
 
+/* statistics of the objects with the same rounded size (<= XUTILS_ARENA_MAX_BYTES) */
+typedef struct XArena_Class_Stats  XArena_Class_Stats_T;
+typedef struct XArena_Class_Stats* XArena_Class_Stats_PT;
+struct XArena_Class_Stats {
+    int   size;           /* rounded size of the objects */
+
+    long  allocs;
+    long  frees;
+    long  refills;        /* times new objects are carved from the chunks */
+
+    long  waste_bytes;    /* bytes lost by rounding up the sizes asked */
+    long  live_bytes;
+    long  peak_bytes;     /* thread safe arenas : the objects kept by the thread caches are counted too */
+};
+
+typedef struct XArena_Stats  XArena_Stats_T;
+typedef struct XArena_Stats* XArena_Stats_PT;
+struct XArena_Stats {
+    int   chunks;         /* chunks held for the small objects (all the objects of a region arena) */
+    long  chunk_bytes;
+
+    long  allocs;         /* sum of all the classes */
+    long  frees;
+    long  waste_bytes;
+    long  live_bytes;
+
+    long  big_allocs;     /* objects bigger than XUTILS_ARENA_MAX_BYTES, taken from malloc one by one */
+    long  big_frees;
+    long  big_live_bytes;
+    long  big_peak_bytes;
+};
+
 extern XArena_PT xarena_new    (void);
 
+/* The arena returned only bumps a pointer in its chunks. xarena_freep does nothing,
+ * all the objects are released at once by xarena_reset or xarena_clear.
+ */
+extern XArena_PT xarena_new_region(void);
+
+#if defined(__linux__)
+/* The arena returned can be shared by threads. Each thread keeps small objects of each size in its own cache,
+ * so most xarena_alloc and xarena_freep calls take no lock. Objects move between the caches and the arena in batches.
+ * xarena_clear and xarena_free must not run while other threads still use the arena.
+ */
+extern XArena_PT xarena_new_thread_safe(void);
+#endif
+
 extern void*     xarena_alloc  (XArena_PT  arena, int nbytes);
 extern void*     xarena_calloc (XArena_PT  arena, int count, int nbytes);
 extern void*     xarena_realloc(XArena_PT  arena, void* p, int old_sz, int new_sz);
 
 extern void      xarena_freep  (XArena_PT  arena, void** p, int n);
 
+/* O(1) for a region arena, the chunks are kept and used again, same as xarena_clear for other arenas */
+extern void      xarena_reset  (XArena_PT  arena);
+
 extern void      xarena_clear  (XArena_PT  arena);
 extern void      xarena_free   (XArena_PT* parena);
 
+/* fill allocator to let containers allocate from the arena, see XMem_Allocator in xmem.h */
+extern void      xarena_allocator(XArena_PT arena, XMem_Allocator_PT allocator);
+
+/* The statistics are collected unless XARENA_NO_STATS is defined, in which case these return false and no counter
+ * is kept at all. The counters of a thread safe arena are exact only while no other thread is using it.
+ */
+extern bool      xarena_stats      (XArena_PT  arena, XArena_Stats_PT stats);
+extern bool      xarena_class_stats(XArena_PT  arena, int size, XArena_Class_Stats_PT stats);
+
+/* print the statistics of the arena, and of each class ever used */
+extern void      xarena_stats_dump (XArena_PT  arena, FILE *fp);
+
 #ifdef __cplusplus
 }
 #endif
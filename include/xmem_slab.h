@@ -0,0 +1,58 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XSLAB_INCLUDED
+#define XSLAB_INCLUDED
+
+#include <stdbool.h>
+#include "xmem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pool of objects with the same size, used by the node based containers for their nodes.
+ * Objects are carved from slabs which grow geometrically, released objects are recycled
+ * through a free list, and all the slabs are released at once by xslab_clear/xslab_free.
+ */
+typedef struct XSlab* XSlab_PT;
+
+/* O(1) */
+extern XSlab_PT xslab_new       (int obj_size);
+/* O(1), the slab and all its slabs come from allocator (NULL : XMEM) */
+extern XSlab_PT xslab_new_allocator(int obj_size, XMem_Allocator_PT allocator);
+
+/* O(1), the object returned is zeroed */
+extern void*    xslab_alloc     (XSlab_PT slab);
+
+/* O(1), give the object back to the slab for reuse, *pobj will be set to NULL */
+extern void     xslab_freep     (XSlab_PT slab, void **pobj);
+
+/* O(1), add one more owner to the slab, xslab_free releases the slab when the last owner is gone */
+extern XSlab_PT xslab_share     (XSlab_PT slab);
+extern bool     xslab_is_shared (XSlab_PT slab);
+
+/* O(S), S is the count of slabs, all the objects are released */
+extern void     xslab_clear     (XSlab_PT slab);
+extern void     xslab_free      (XSlab_PT *pslab);
+
+/* O(1) */
+extern int      xslab_obj_size  (XSlab_PT slab);
+extern int      xslab_slab_count(XSlab_PT slab);
+extern int      xslab_used_count(XSlab_PT slab);
+extern long     xslab_bytes     (XSlab_PT slab);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -24,6 +24,8 @@ typedef struct XDeque* XDeque_PT;
 
 /* O(1) */
 extern XDeque_PT xdeque_new                   (int capacity);    /* capacity = 0 means no limitation */
+/* O(1), the deque and its sequences come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XDeque_PT xdeque_new_allocator         (int capacity, XMem_Allocator_PT allocator);
 
 /* O(N) */
 extern XDeque_PT xdeque_copy                  (XDeque_PT deque);
@@ -78,7 +80,7 @@ extern bool      xdeque_is_empty              (XDeque_PT deque);
 extern int       xdeque_capacity              (XDeque_PT deque);
 extern bool      xdeque_set_capacity_no_limit (XDeque_PT deque);
 
-/* O(1) */
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool      xdeque_swap                  (XDeque_PT deque1, XDeque_PT deque2);
 
 /* O(N) */
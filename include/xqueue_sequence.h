@@ -24,6 +24,8 @@ typedef struct XPSeq* XPSeq_PT;
 
 /* O(1) */
 extern XPSeq_PT xpseq_new              (int capacity);  /* 0 < capacity */
+/* O(1), the sequence and its array come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XPSeq_PT xpseq_new_allocator    (int capacity, XMem_Allocator_PT allocator);
 
 /* O(N) */
 extern XPSeq_PT xpseq_copy             (XPSeq_PT seq);
@@ -75,7 +77,7 @@ extern int     xpseq_capacity          (XPSeq_PT seq);
 /* O(N) */
 extern bool    xpseq_expand            (XPSeq_PT seq, int expand_size);
 
-/* O(1) */
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool    xpseq_swap              (XPSeq_PT seq1, XPSeq_PT seq2);
 
 /* O(N) */
@@ -0,0 +1,69 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XTS_SKIPMAP_INCLUDED
+#define XTS_SKIPMAP_INCLUDED
+
+#if defined(__linux__)
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ordered map, keys are unique, lock-free skip list :
+ *    threads get/put/remove at the same time without any lock,
+ *    the removed nodes are freed when no thread can see them any more (epoch based reclamation),
+ *    each map uses one pthread key to find the reclamation record of the calling thread
+ */
+typedef struct XTS_SkipMap*    XTS_SkipMap_PT;
+
+/* O(1) */
+extern XTS_SkipMap_PT    xts_skipmap_new                 (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+
+/* O(lgN) */
+extern bool              xts_skipmap_put_replace         (XTS_SkipMap_PT map, void *key, void *value);
+extern bool              xts_skipmap_put_if_absent       (XTS_SkipMap_PT map, void *key, void *value);   /* false if key exists already */
+
+/* O(lgN) */
+extern void*             xts_skipmap_get                 (XTS_SkipMap_PT map, void *key);
+extern bool              xts_skipmap_find                (XTS_SkipMap_PT map, void *key);
+
+/* O(lgN) */
+extern bool              xts_skipmap_remove              (XTS_SkipMap_PT map, void *key);   /* true if key is found and removed by this call */
+
+/* O(1) */
+extern void*             xts_skipmap_min                 (XTS_SkipMap_PT map);
+
+/* O(lgN) */
+extern void*             xts_skipmap_max                 (XTS_SkipMap_PT map);
+extern void*             xts_skipmap_floor               (XTS_SkipMap_PT map, void *key);   /* the maximum key <= key */
+extern void*             xts_skipmap_ceiling             (XTS_SkipMap_PT map, void *key);   /* the minimum key >= key */
+
+/* O(N) : keys in [low, high] from min to max, the keys put or removed by other threads during the iteration may be seen or not */
+extern int               xts_skipmap_map_range           (XTS_SkipMap_PT map, void *low, void *high, bool (*apply)(void *key, void *value, void *cl), void *cl);
+extern int               xts_skipmap_map_min_to_max      (XTS_SkipMap_PT map, bool (*apply)(void *key, void *value, void *cl), void *cl);
+
+/* O(N) : no other thread should use the map any more */
+extern void              xts_skipmap_free                (XTS_SkipMap_PT *pmap);
+
+/* O(1) */
+extern int               xts_skipmap_size                (XTS_SkipMap_PT map);
+extern bool              xts_skipmap_is_empty            (XTS_SkipMap_PT map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+#endif
@@ -0,0 +1,89 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XARTREE_INCLUDED
+#define XARTREE_INCLUDED
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Note :
+*    1. adaptive radix tree, keys are C strings (bytes end with '\0'), and ordered the same as strcmp.
+*    2. L is the length of key, no key comparison callback is needed, a lookup touches at most L nodes.
+*    3. the key is not copied, it must be kept unchanged while it is in the tree.
+*/
+
+typedef struct XARTree*  XARTree_PT;
+
+/* O(1) */
+extern XARTree_PT   xartree_new                 (void);
+
+/* O(N) */
+extern XARTree_PT   xartree_copy                (XARTree_PT tree);
+extern XARTree_PT   xartree_deep_copy           (XARTree_PT tree, int value_size);
+
+/* O(L) */
+extern bool         xartree_put_unique          (XARTree_PT tree, void *key, void *value);
+extern bool         xartree_put_replace         (XARTree_PT tree, void *key, void *value, void **old_value);
+extern bool         xartree_put_deep_replace    (XARTree_PT tree, void *key, void *value);
+
+/* O(L) */
+extern void*        xartree_get                 (XARTree_PT tree, void *key);
+extern bool         xartree_find                (XARTree_PT tree, void *key);
+
+/* O(L) : return the key */
+extern void*        xartree_min                 (XARTree_PT tree);
+extern void*        xartree_max                 (XARTree_PT tree);
+
+/* O(L) : return the key */
+extern void*        xartree_floor               (XARTree_PT tree, void *key);
+extern void*        xartree_ceiling             (XARTree_PT tree, void *key);
+
+/* O(L) */
+extern bool         xartree_remove              (XARTree_PT tree, void *key);
+extern bool         xartree_remove_save         (XARTree_PT tree, void *key, void **value);
+extern bool         xartree_deep_remove         (XARTree_PT tree, void *key);
+
+/* O(N) */
+extern void         xartree_clear               (XARTree_PT tree);
+extern void         xartree_clear_apply         (XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern void         xartree_deep_clear          (XARTree_PT tree);
+
+/* O(N) */
+extern void         xartree_free                (XARTree_PT *ptree);
+extern void         xartree_free_apply          (XARTree_PT *ptree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern void         xartree_deep_free           (XARTree_PT *ptree);
+
+/* O(N) : keys are visited from min to max */
+extern int          xartree_map                 (XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xartree_map_break_if_true   (XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xartree_map_break_if_false  (XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(L + M) : M keys starting with prefix are visited from min to max */
+extern int          xartree_prefix_map          (XARTree_PT tree, void *prefix, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xartree_prefix_map_break_if_true  (XARTree_PT tree, void *prefix, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(1) */
+extern bool         xartree_swap                (XARTree_PT tree1, XARTree_PT tree2);
+
+/* O(1) */
+extern int          xartree_size                (XARTree_PT tree);
+extern bool         xartree_is_empty            (XARTree_PT tree);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -21,8 +21,18 @@ extern "C" {
 
 typedef struct XAVLTree*  XAVLTree_PT;
 
+/* define XAVLTree_Cursor_T here to make a cursor can be created on the stack, its members are used internally only */
+typedef struct XAVLTree_Cursor   XAVLTree_Cursor_T;
+typedef struct XAVLTree_Cursor*  XAVLTree_Cursor_PT;
+struct XAVLTree_Cursor {
+    XAVLTree_PT  tree;
+    void        *node;   /* NULL if the cursor is not on any key */
+};
+
 /* O(1) */
 extern XAVLTree_PT  xavltree_new                (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the tree and its nodes come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XAVLTree_PT  xavltree_new_allocator      (int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(lgN) */
 extern bool         xavltree_put_repeat         (XAVLTree_PT tree, void *key, void *value);
@@ -30,6 +40,9 @@ extern bool         xavltree_put_unique         (XAVLTree_PT tree, void *key, vo
 extern bool         xavltree_put_replace        (XAVLTree_PT tree, void *key, void *value, void **old_value);
 extern bool         xavltree_put_deep_replace   (XAVLTree_PT tree, void *key, void *value);
 
+/* O(N) : build the balanced tree directly, tree must be empty, keys must be sorted from min to max, values can be NULL */
+extern bool         xavltree_build_sorted       (XAVLTree_PT tree, void **keys, void **values, int count);
+
 /* O(lgN) */
 extern void*        xavltree_min                (XAVLTree_PT tree);
 extern void*        xavltree_max                (XAVLTree_PT tree);
@@ -76,7 +89,24 @@ extern int          xavltree_map_min_to_max     (XAVLTree_PT tree, bool (*apply)
 extern bool         xavltree_map_min_to_max_break_if_true  (XAVLTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern bool         xavltree_map_min_to_max_break_if_false (XAVLTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
 
+/* O(1) : put or remove to the tree makes its cursors invalid, they must be moved by first, last or seek again */
+extern void         xavltree_cursor_init        (XAVLTree_Cursor_PT cursor, XAVLTree_PT tree);
+
+/* O(lgN) */
+extern bool         xavltree_cursor_first       (XAVLTree_Cursor_PT cursor);
+extern bool         xavltree_cursor_last        (XAVLTree_Cursor_PT cursor);
+extern bool         xavltree_cursor_seek        (XAVLTree_Cursor_PT cursor, void *key);   /* the first key >= key */
+
+/* amortized O(1) */
+extern bool         xavltree_cursor_next        (XAVLTree_Cursor_PT cursor);
+extern bool         xavltree_cursor_prev        (XAVLTree_Cursor_PT cursor);
+
 /* O(1) */
+extern bool         xavltree_cursor_valid       (XAVLTree_Cursor_PT cursor);
+extern void*        xavltree_cursor_key         (XAVLTree_Cursor_PT cursor);
+extern void*        xavltree_cursor_value       (XAVLTree_Cursor_PT cursor);
+
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool         xavltree_swap               (XAVLTree_PT tree1, XAVLTree_PT tree2);
 
 /* O(1) */
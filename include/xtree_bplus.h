@@ -0,0 +1,169 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XBPTREE_INCLUDED
+#define XBPTREE_INCLUDED
+
+#include "xlist_s.h"
+#include "xarray_pointer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct XBPTree*      XBPTree_PT;
+
+/* define XBPTree_Cursor_T here to make a cursor can be created on the stack, its members are used internally only */
+typedef struct XBPTree_Cursor   XBPTree_Cursor_T;
+typedef struct XBPTree_Cursor*  XBPTree_Cursor_PT;
+struct XBPTree_Cursor {
+    XBPTree_PT  tree;
+    void       *leaf;   /* NULL if the cursor is not on any key */
+    int         pos;    /* key position in the leaf */
+};
+
+/* O(1) */
+extern XBPTree_PT   xbptree_new               (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the tree and its nodes come from allocator (NULL : XMEM), the trees copied or split from it use it too */
+extern XBPTree_PT   xbptree_new_allocator     (int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
+
+/* O(N) */
+extern XBPTree_PT   xbptree_copy              (XBPTree_PT tree);
+extern XBPTree_PT   xbptree_deep_copy         (XBPTree_PT tree, int key_size, int value_size);
+
+/* O(lgN) : all put interfaces */
+extern bool         xbptree_put_repeat        (XBPTree_PT tree, void *key, void *value);
+extern bool         xbptree_put_unique        (XBPTree_PT tree, void *key, void *value);
+extern bool         xbptree_put_replace       (XBPTree_PT tree, void *key, void *value, void **old_value);
+extern bool         xbptree_put_deep_replace  (XBPTree_PT tree, void *key, void *value);
+
+/* O(N) : bulk load, tree must be empty, keys must be sorted from min to max ("repeat" keys are allowed),
+ *        values can be NULL (all values are NULL then)
+ */
+extern bool         xbptree_build_sorted      (XBPTree_PT tree, void **keys, void **values, int count);
+extern bool         xbptree_build_sorted_parray(XBPTree_PT tree, XPArray_PT keys, XPArray_PT values);
+
+/* O(1) */
+extern void*        xbptree_min               (XBPTree_PT tree);
+extern void*        xbptree_max               (XBPTree_PT tree);
+
+/* O(lgN) */
+extern void*        xbptree_floor             (XBPTree_PT tree, void *key);
+extern void*        xbptree_ceiling           (XBPTree_PT tree, void *key);
+
+/* O(lgN) */
+extern void*        xbptree_select            (XBPTree_PT tree, int k);
+extern int          xbptree_rank              (XBPTree_PT tree, void *key);
+
+/* O(lgN) */
+extern void*        xbptree_get               (XBPTree_PT tree, void *key);
+
+/* O(lgN) */
+extern bool         xbptree_find              (XBPTree_PT tree, void *key);
+extern bool         xbptree_find_replace      (XBPTree_PT tree, void *key, void *value, void **old_value);
+extern bool         xbptree_find_deep_replace (XBPTree_PT tree, void *key, void *value);
+
+/* O(lgN) */
+extern bool         xbptree_index_replace     (XBPTree_PT tree, int k, void *value, void **old_value);
+extern bool         xbptree_index_deep_replace(XBPTree_PT tree, int k, void *value);
+
+/* O(lgN + M) */
+extern XSList_PT    xbptree_keys              (XBPTree_PT tree, void *low, void *high);
+
+/* O(N) */
+extern void         xbptree_clear             (XBPTree_PT tree);
+extern void         xbptree_clear_apply       (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern void         xbptree_deep_clear        (XBPTree_PT tree);
+
+/* O(N) */
+extern void         xbptree_free              (XBPTree_PT *ptree);
+extern void         xbptree_free_apply        (XBPTree_PT *ptree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern void         xbptree_deep_free         (XBPTree_PT *ptree);
+
+/* O(lgN) */
+extern void         xbptree_remove_min        (XBPTree_PT tree);
+extern void         xbptree_remove_max        (XBPTree_PT tree);
+
+/* O(lgN) */
+extern void         xbptree_remove_save_min   (XBPTree_PT tree, void **key, void **value);
+extern void         xbptree_remove_save_max   (XBPTree_PT tree, void **key, void **value);
+
+/* O(lgN) */
+extern void         xbptree_deep_remove_min   (XBPTree_PT tree);
+extern void         xbptree_deep_remove_max   (XBPTree_PT tree);
+
+/* O(lgN) */
+extern int          xbptree_remove            (XBPTree_PT tree, void *key);
+extern int          xbptree_remove_save       (XBPTree_PT tree, void *key, void **value);
+extern int          xbptree_deep_remove       (XBPTree_PT tree, void *key);
+
+/* O(K + min(KlgN, N)) : the keys >= key (K keys) are moved to the new tree returned */
+extern XBPTree_PT   xbptree_split             (XBPTree_PT tree, void *key);
+
+/* O(K + min(KlgN, N)) : the keys in [low, high] (K keys) are moved to the new tree returned */
+extern XBPTree_PT   xbptree_remove_range      (XBPTree_PT tree, void *low, void *high);
+
+/* O(N) */
+extern int          xbptree_map_min_to_max                      (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xbptree_map_min_to_max_break_if_true        (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xbptree_map_min_to_max_break_if_false       (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(N) */
+extern int          xbptree_map_max_to_min                      (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xbptree_map_max_to_min_break_if_true        (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xbptree_map_max_to_min_break_if_false       (XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(lgN + M) : keys in [low, high] are visited through the linked leaves */
+extern int          xbptree_scope_map_min_to_max                (XBPTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xbptree_scope_map_min_to_max_break_if_true  (XBPTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
+extern bool         xbptree_scope_map_min_to_max_break_if_false (XBPTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(1) : put or remove to the tree makes its cursors invalid, they must be moved by first, last or seek again */
+extern void         xbptree_cursor_init                         (XBPTree_Cursor_PT cursor, XBPTree_PT tree);
+
+/* O(1) */
+extern bool         xbptree_cursor_first                        (XBPTree_Cursor_PT cursor);
+extern bool         xbptree_cursor_last                         (XBPTree_Cursor_PT cursor);
+
+/* O(lgN) */
+extern bool         xbptree_cursor_seek                         (XBPTree_Cursor_PT cursor, void *key);   /* the first key >= key */
+
+/* O(1) */
+extern bool         xbptree_cursor_next                         (XBPTree_Cursor_PT cursor);
+extern bool         xbptree_cursor_prev                         (XBPTree_Cursor_PT cursor);
+
+/* O(1) */
+extern bool         xbptree_cursor_valid                        (XBPTree_Cursor_PT cursor);
+extern void*        xbptree_cursor_key                          (XBPTree_Cursor_PT cursor);
+extern void*        xbptree_cursor_value                        (XBPTree_Cursor_PT cursor);
+
+/* O(1), both must use the same allocator (see *_new_allocator) */
+extern bool         xbptree_swap                                (XBPTree_PT tree1, XBPTree_PT tree2);
+
+/* O(1) */
+extern int          xbptree_size                                (XBPTree_PT tree);
+extern bool         xbptree_is_empty                            (XBPTree_PT tree);
+
+/* O(lgN) */
+extern int          xbptree_keys_size                           (XBPTree_PT tree, void *low, void *high);
+
+/* O(1) */
+extern int          xbptree_height                              (XBPTree_PT tree);
+
+/* O(N) */
+extern bool         xbptree_is_bptree                           (XBPTree_PT tree);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,15 +15,31 @@
 
 #include "xlist_s.h"
 #include "xtree_redblack.h"
+#include "xtree_bplus.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* macro definition :
+*    XMAP_BPTREE :
+*      with this macro defined, XMap_PT is implemented by XBPTree_PT (B+ tree, wide nodes and linked leaves),
+*      if not defined (default), XMap_PT is implemented by XRBTree_PT.
+*/
+#ifdef XMAP_BPTREE
+typedef XBPTree_PT XMap_PT;
+typedef XBPTree_Cursor_T  XMap_Cursor_T;
+typedef XBPTree_Cursor_PT XMap_Cursor_PT;
+#else
 typedef XRBTree_PT XMap_PT;
+typedef XRBTree_Cursor_T  XMap_Cursor_T;
+typedef XRBTree_Cursor_PT XMap_Cursor_PT;
+#endif
 
 /* O(1) */
 extern XMap_PT    xmap_new               (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the map and its nodes come from allocator (NULL : XMEM), see XMem_Allocator in xmem.h */
+extern XMap_PT    xmap_new_allocator     (int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(NlgN) */
 extern XMap_PT    xmap_copy              (XMap_PT map);
@@ -35,8 +51,18 @@ extern bool       xmap_put_unique        (XMap_PT map, void *key, void *value);
 extern bool       xmap_put_replace       (XMap_PT map, void *key, void *value, void **old_value);
 extern bool       xmap_put_deep_replace  (XMap_PT map, void *key, void *value);
 
+/* O(N) : map must be empty, keys must be sorted from min to max, values can be NULL */
+extern bool       xmap_build_sorted      (XMap_PT map, void **keys, void **values, int count);
+extern bool       xmap_build_sorted_parray(XMap_PT map, XPArray_PT keys, XPArray_PT values);
+
+/* O(lgN) */
+extern void*      xmap_min               (XMap_PT map);
+extern void*      xmap_max               (XMap_PT map);
+
+#if defined(XMAP_BPTREE) || !defined(XRBTREE_NO_SIZE)
 /* O(lgN) */
 extern void*      xmap_select            (XMap_PT map, int k);
+#endif
 
 /* O(lgN) */
 extern void*      xmap_get               (XMap_PT map, void *key);
@@ -63,12 +89,37 @@ extern void       xmap_remove            (XMap_PT map, void *key);
 extern void       xmap_remove_save       (XMap_PT map, void *key, void **value);
 extern void       xmap_deep_remove       (XMap_PT map, void *key);
 
+#if defined(XMAP_BPTREE) || !defined(XRBTREE_NO_SIZE)
+/* O(lgN) (O(K + min(KlgN, N)) for XMAP_BPTREE) : the keys >= key (K keys) are moved to the new map returned */
+extern XMap_PT    xmap_split             (XMap_PT map, void *key);
+
+/* O(lgN) (O(K + min(KlgN, N)) for XMAP_BPTREE) : the keys in [low, high] (K keys) are moved to the new map returned */
+extern XMap_PT    xmap_remove_range      (XMap_PT map, void *low, void *high);
+#endif
+
 /* O(N) */
 extern int        xmap_map               (XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern bool       xmap_map_break_if_true (XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern bool       xmap_map_break_if_false(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl);
 
+/* O(1) : put or remove to the map makes its cursors invalid, they must be moved by first, last or seek again */
+extern void       xmap_cursor_init       (XMap_Cursor_PT cursor, XMap_PT map);
+
+/* O(lgN) */
+extern bool       xmap_cursor_first      (XMap_Cursor_PT cursor);
+extern bool       xmap_cursor_last       (XMap_Cursor_PT cursor);
+extern bool       xmap_cursor_seek       (XMap_Cursor_PT cursor, void *key);   /* the first key >= key */
+
+/* amortized O(1) */
+extern bool       xmap_cursor_next       (XMap_Cursor_PT cursor);
+extern bool       xmap_cursor_prev       (XMap_Cursor_PT cursor);
+
 /* O(1) */
+extern bool       xmap_cursor_valid      (XMap_Cursor_PT cursor);
+extern void*      xmap_cursor_key        (XMap_Cursor_PT cursor);
+extern void*      xmap_cursor_value      (XMap_Cursor_PT cursor);
+
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool       xmap_swap              (XMap_PT map1, XMap_PT map2);
 
 /* O(1) */
@@ -14,15 +14,42 @@
 #define XRBTREE_INCLUDED
 
 #include "xlist_s.h"
+#include "xarray_pointer.h"
+#include "xthread_pool_static.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* macro definition :
+*    XRBTREE_COMPACT_NODE :
+*      with this macro defined, the color of node is saved in the lowest bit of its parent pointer.
+*    XRBTREE_NO_SIZE :
+*      with this macro defined, the nodes don't save the size of their subtrees, and the interfaces using it
+*      (select, rank, index_replace, split, remove_range, parallel_map, parallel_reduce) are not built,
+*      with both macros defined, one node uses 40 bytes instead of 48 bytes on 64 bits platforms.
+*/
+
 typedef struct XRBTree*      XRBTree_PT;
 
+/* define XRBTree_Cursor_T here to make a cursor can be created on the stack, its members are used internally only */
+typedef struct XRBTree_Cursor   XRBTree_Cursor_T;
+typedef struct XRBTree_Cursor*  XRBTree_Cursor_PT;
+struct XRBTree_Cursor {
+    XRBTree_PT  tree;
+    void       *node;   /* NULL if the cursor is not on any key */
+};
+
 /* O(1) */
 extern XRBTree_PT   xrbtree_new               (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the tree and its nodes come from allocator (NULL : XMEM), the trees copied or split from it use it too */
+extern XRBTree_PT   xrbtree_new_allocator     (int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
+
+/* O(1) : tree must be empty, aux_size bytes are saved in each node for the summary of its subtree (e.g. the max end of intervals),
+ *        augment recomputes aux from key, value and the summaries of the children (NULL if the child doesn't exist),
+ *        it's called whenever the node or its children are changed, except the values changed by apply of the map interfaces
+ */
+extern bool         xrbtree_set_augment       (XRBTree_PT tree, int aux_size, void (*augment)(void *key, void *value, void *aux, void *left_aux, void *right_aux, void *cl), void *cl);
 
 /* O(NlgN) */
 extern XRBTree_PT   xrbtree_copy              (XRBTree_PT tree);
@@ -34,6 +61,12 @@ extern bool         xrbtree_put_unique        (XRBTree_PT tree, void *key, void
 extern bool         xrbtree_put_replace       (XRBTree_PT tree, void *key, void *value, void **old_value);
 extern bool         xrbtree_put_deep_replace  (XRBTree_PT tree, void *key, void *value);
 
+/* O(N) : build the balanced tree directly, tree must be empty, keys must be sorted from min to max ("repeat" keys are allowed),
+ *        values can be NULL (all values are NULL then)
+ */
+extern bool         xrbtree_build_sorted      (XRBTree_PT tree, void **keys, void **values, int count);
+extern bool         xrbtree_build_sorted_parray(XRBTree_PT tree, XPArray_PT keys, XPArray_PT values);
+
 /* O(lgN) */
 extern void*        xrbtree_min               (XRBTree_PT tree);
 extern void*        xrbtree_max               (XRBTree_PT tree);
@@ -42,9 +75,11 @@ extern void*        xrbtree_max               (XRBTree_PT tree);
 extern void*        xrbtree_floor             (XRBTree_PT tree, void *key);
 extern void*        xrbtree_ceiling           (XRBTree_PT tree, void *key);
 
+#ifndef XRBTREE_NO_SIZE
 /* O(lgN) */
 extern void*        xrbtree_select            (XRBTree_PT tree, int k);
 extern int          xrbtree_rank              (XRBTree_PT tree, void *key);
+#endif
 
 /* O(lgN) */
 extern void*        xrbtree_get               (XRBTree_PT tree, void *key);
@@ -56,9 +91,11 @@ extern bool         xrbtree_find              (XRBTree_PT tree, void *key);
 extern bool         xrbtree_find_replace      (XRBTree_PT tree, void *key, void *value, void **old_value);
 extern bool         xrbtree_find_deep_replace (XRBTree_PT tree, void *key, void *value);
 
+#ifndef XRBTREE_NO_SIZE
 /* O(lgN) */
 extern bool         xrbtree_index_replace     (XRBTree_PT tree, int k, void *value, void **old_value);
 extern bool         xrbtree_index_deep_replace(XRBTree_PT tree, int k, void *value);
+#endif
 
 /* O(N) */
 extern XSList_PT    xrbtree_keys              (XRBTree_PT tree, void *low, void *high);
@@ -98,6 +135,14 @@ extern int          xrbtree_deep_remove       (XRBTree_PT tree, void *key);
 /* O(NlgN) */
 extern int          xrbtree_deep_remove_all   (XRBTree_PT tree, void *key);
 
+#ifndef XRBTREE_NO_SIZE
+/* O(lgN) : the keys >= key are moved to the new tree returned */
+extern XRBTree_PT   xrbtree_split             (XRBTree_PT tree, void *key);
+
+/* O(lgN) : the keys in [low, high] are moved to the new tree returned */
+extern XRBTree_PT   xrbtree_remove_range      (XRBTree_PT tree, void *low, void *high);
+#endif
+
 /* O(N) */
 extern int          xrbtree_map_preorder      (XRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern int          xrbtree_map_inorder       (XRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
@@ -129,13 +174,56 @@ extern int          xrbtree_scope_map_min_to_max                (XRBTree_PT tree
 extern bool         xrbtree_scope_map_min_to_max_break_if_true  (XRBTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern bool         xrbtree_scope_map_min_to_max_break_if_false (XRBTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
 
+/* O(lgN + K) : K keys visited from min to max, the subtree is skipped if enter returns false for its summary */
+extern int          xrbtree_augment_map_min_to_max              (XRBTree_PT tree, bool (*enter)(void *aux, void *cl), bool (*apply)(void *key, void *value, void *aux, void *cl), void *cl);
+
+#if defined(__linux__) && !defined(XRBTREE_NO_SIZE)
+/* O(N/P) : keys are split into ranges of the same size by rank, and the ranges are done by the threads of "pool" and the caller,
+ *          "pool" can be NULL to do all of them in the caller, the tree must not be changed before they return.
+ *          apply is called concurrently, the same as xrbtree_map_min_to_max except the order of the calls
+ */
+extern int          xrbtree_parallel_map                        (XRBTree_PT tree, XSThreadPool_PT pool, bool (*apply)(void *key, void **value, void *cl), void *cl);
+
+/* O(N/P) : "result" (acc_size bytes) must be the identity of "combine" at first, each range accumulates its keys
+ *          from min to max into a copy of it, then the copies are combined into "result" from min to max,
+ *          so "combine" only needs to be associative
+ */
+extern bool         xrbtree_parallel_reduce                     (XRBTree_PT tree, XSThreadPool_PT pool, void *result, int acc_size, void (*accumulate)(void *acc, void *key, void *value, void *cl), void (*combine)(void *result, void *acc, void *cl), void *cl);
+#endif
+
+/* O(1) : put or remove to the tree makes its cursors invalid, they must be moved by first, last or seek again */
+extern void         xrbtree_cursor_init                         (XRBTree_Cursor_PT cursor, XRBTree_PT tree);
+
+/* O(lgN) */
+extern bool         xrbtree_cursor_first                        (XRBTree_Cursor_PT cursor);
+extern bool         xrbtree_cursor_last                         (XRBTree_Cursor_PT cursor);
+extern bool         xrbtree_cursor_seek                         (XRBTree_Cursor_PT cursor, void *key);   /* the first key >= key */
+
+/* amortized O(1) */
+extern bool         xrbtree_cursor_next                         (XRBTree_Cursor_PT cursor);
+extern bool         xrbtree_cursor_prev                         (XRBTree_Cursor_PT cursor);
+
 /* O(1) */
+extern bool         xrbtree_cursor_valid                        (XRBTree_Cursor_PT cursor);
+extern void*        xrbtree_cursor_key                          (XRBTree_Cursor_PT cursor);
+extern void*        xrbtree_cursor_value                        (XRBTree_Cursor_PT cursor);
+
+/* O(1) : walk down from the root, the summaries of the subtrees are used to answer the queries in O(lgN) */
+extern bool         xrbtree_cursor_root                         (XRBTree_Cursor_PT cursor);
+extern bool         xrbtree_cursor_left                         (XRBTree_Cursor_PT cursor);
+extern bool         xrbtree_cursor_right                        (XRBTree_Cursor_PT cursor);
+extern void*        xrbtree_cursor_aux                          (XRBTree_Cursor_PT cursor);   /* the summary of the subtree under the cursor */
+
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool         xrbtree_swap                                (XRBTree_PT tree1, XRBTree_PT tree2);
 
 /* O(1) */
 extern int          xrbtree_size                                (XRBTree_PT tree);
 extern bool         xrbtree_is_empty                            (XRBTree_PT tree);
 
+/* O(1) : the summary of the whole tree, NULL if the tree is empty or not augmented */
+extern void*        xrbtree_aux                                 (XRBTree_PT tree);
+
 /* O(lgN) */
 extern int          xrbtree_keys_size                           (XRBTree_PT tree, void *low, void *high);
 
@@ -23,6 +23,8 @@ typedef struct XListRBTree*      XListRBTree_PT;
 
 /* O(1) */
 extern XListRBTree_PT xlistrbtree_new               (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+/* O(1), the tree, its nodes and their values arrays come from allocator (NULL : XMEM), the trees copied or split from it use it too */
+extern XListRBTree_PT xlistrbtree_new_allocator     (int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(NlgN) */
 extern XListRBTree_PT xlistrbtree_copy              (XListRBTree_PT tree);
@@ -34,6 +36,11 @@ extern bool           xlistrbtree_put_unique        (XListRBTree_PT tree, void *
 extern bool           xlistrbtree_put_replace       (XListRBTree_PT tree, void *key, void *value, void **old_value);
 extern bool           xlistrbtree_put_deep_replace  (XListRBTree_PT tree, void *key, void *value);
 
+/* O(N) : build the balanced tree directly, tree must be empty, keys must be sorted from min to max,
+ *        all the "same" keys are saved in one node as xlistrbtree_put_repeat does, values can be NULL
+ */
+extern bool           xlistrbtree_build_sorted      (XListRBTree_PT tree, void **keys, void **values, int count);
+
 /* O(lgN) */
 extern void           xlistrbtree_key_unique        (XListRBTree_PT tree, void *key);
 /* O(NlgN) */
@@ -53,8 +60,12 @@ extern int            xlistrbtree_rank              (XListRBTree_PT tree, void *
 
 /* O(lgN) */
 extern void*          xlistrbtree_get               (XListRBTree_PT tree, void *key);
-/* O(NlgN) */
+/* O(lgN + K) */
 extern XSList_PT      xlistrbtree_get_all           (XListRBTree_PT tree, void *key);
+/* O(lgN) : no copy, the values are owned by the tree and the view is invalid after the tree is changed,
+*           values[count - 1] is the one xlistrbtree_get returns, values[0] is the first saved one
+*/
+extern void**         xlistrbtree_get_all_view      (XListRBTree_PT tree, void *key, int *count);
 
 /* O(lgN) */
 extern bool           xlistrbtree_find              (XListRBTree_PT tree, void *key);
@@ -99,6 +110,12 @@ extern int            xlistrbtree_deep_remove       (XListRBTree_PT tree, void *
 /* O(NlgN) */
 extern int            xlistrbtree_deep_remove_all   (XListRBTree_PT tree, void *key);
 
+/* O(lgN) : the keys >= key are moved to the new tree returned */
+extern XListRBTree_PT xlistrbtree_split             (XListRBTree_PT tree, void *key);
+
+/* O(lgN) : the keys in [low, high] are moved to the new tree returned */
+extern XListRBTree_PT xlistrbtree_remove_range      (XListRBTree_PT tree, void *low, void *high);
+
 /* O(N) */
 extern int            xlistrbtree_map_preorder      (XListRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern int            xlistrbtree_map_inorder       (XListRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
@@ -120,7 +137,7 @@ extern int            xlistrbtree_scope_map_min_to_max                (XListRBTr
 extern bool           xlistrbtree_scope_map_min_to_max_break_if_true  (XListRBTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern bool           xlistrbtree_scope_map_min_to_max_break_if_false (XListRBTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl);
 
-/* O(1) */
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool           xlistrbtree_swap              (XListRBTree_PT tree1, XListRBTree_PT tree2);
 
 /* O(NlgN) */
@@ -0,0 +1,81 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XPRBTREE_INCLUDED
+#define XPRBTREE_INCLUDED
+
+#if defined(__linux__)
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* persistent red-black tree, keys are unique :
+ *    an update builds a new version which shares all the untouched nodes with the old ones (path copying),
+ *    a snapshot is an immutable version, readers use it without any lock,
+ *    a version is freed when the tree and all the snapshots using it are gone (reference counting)
+ */
+typedef struct XPRBTree*       XPRBTree_PT;
+typedef struct XPRBTree_Snap*  XPRBTree_Snap_PT;
+
+/* O(1) */
+extern XPRBTree_PT       xprbtree_new                 (int (*cmp)(void *key1, void *key2, void *cl), void *cl);
+
+/* O(lgN) : updates are done one by one, each one copies O(lgN) nodes */
+extern bool              xprbtree_put_replace         (XPRBTree_PT tree, void *key, void *value, void **old_value);
+extern bool              xprbtree_remove              (XPRBTree_PT tree, void *key);   /* true if key is found and removed */
+
+/* O(1) : the current version, it's not changed by the updates later */
+extern XPRBTree_Snap_PT  xprbtree_snapshot            (XPRBTree_PT tree);
+
+/* O(1) : O(K) if K nodes are only used by this snapshot */
+extern void              xprbtree_snap_free           (XPRBTree_Snap_PT *psnap);
+
+/* O(lgN) */
+extern void*             xprbtree_snap_get            (XPRBTree_Snap_PT snap, void *key);
+extern bool              xprbtree_snap_find           (XPRBTree_Snap_PT snap, void *key);
+
+/* O(lgN) */
+extern void*             xprbtree_snap_min            (XPRBTree_Snap_PT snap);
+extern void*             xprbtree_snap_max            (XPRBTree_Snap_PT snap);
+extern void*             xprbtree_snap_floor          (XPRBTree_Snap_PT snap, void *key);
+extern void*             xprbtree_snap_ceiling        (XPRBTree_Snap_PT snap, void *key);
+
+/* O(lgN) */
+extern void*             xprbtree_snap_select         (XPRBTree_Snap_PT snap, int k);
+extern int               xprbtree_snap_rank           (XPRBTree_Snap_PT snap, void *key);
+
+/* O(N) : value can't be changed in apply since it's shared by the versions */
+extern int               xprbtree_snap_map_min_to_max (XPRBTree_Snap_PT snap, bool (*apply)(void *key, void *value, void *cl), void *cl);
+
+/* O(1) */
+extern int               xprbtree_snap_size           (XPRBTree_Snap_PT snap);
+extern bool              xprbtree_snap_is_empty       (XPRBTree_Snap_PT snap);
+
+/* O(N) */
+extern bool              xprbtree_snap_is_rbtree      (XPRBTree_Snap_PT snap);
+
+/* O(1) : the size of the current version */
+extern int               xprbtree_size                (XPRBTree_PT tree);
+extern bool              xprbtree_is_empty            (XPRBTree_PT tree);
+
+/* O(N) : no other thread should use the tree any more, the snapshots are still valid until they are freed */
+extern void              xprbtree_free                (XPRBTree_PT *ptree);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+#endif
@@ -15,6 +15,7 @@
 
 #include "xtree_redblack_list.h"
 #include "xlist_s.h"
+#include "xthread_pool_static.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,8 +23,19 @@ extern "C" {
 
 typedef XListRBTree_PT      XSet_PT;
 
+/* define XSet_Cursor_T here to make a cursor can be created on the stack, its members are used internally only */
+typedef struct XSet_Cursor   XSet_Cursor_T;
+typedef struct XSet_Cursor*  XSet_Cursor_PT;
+struct XSet_Cursor {
+    XSet_PT  set;
+    void    *node;   /* NULL if the cursor is not on any elem */
+    void    *elem;   /* "repeat" elems are saved in one node, the one the cursor is on */
+};
+
 /* O(1) */
 extern XSet_PT   xset_new               (int (*cmp)(void *elem1, void *elem2, void *cl), void *cl);
+/* O(1), the set and its nodes come from allocator (NULL : XMEM), the sets copied from it or returned by union ... use it too */
+extern XSet_PT   xset_new_allocator     (int (*cmp)(void *elem1, void *elem2, void *cl), void *cl, XMem_Allocator_PT allocator);
 
 /* O(NlgN) */
 extern XSet_PT   xset_copy              (XSet_PT set);
@@ -33,6 +45,9 @@ extern XSet_PT   xset_deep_copy         (XSet_PT set, int elem_size);
 extern bool      xset_put_repeat        (XSet_PT set, void *elem);
 extern bool      xset_put_unique        (XSet_PT set, void *elem);
 
+/* O(N) : set must be empty, elems must be sorted from min to max */
+extern bool      xset_build_sorted      (XSet_PT set, void **elems, int count);
+
 /* O(lgN) */
 extern void      xset_elem_unique       (XSet_PT set, void *elem);
 /* O(NlgN) */
@@ -65,6 +80,12 @@ extern void      xset_remove_all        (XSet_PT set, void *elem);
 extern void      xset_deep_remove       (XSet_PT set, void *elem);
 extern void      xset_deep_remove_all   (XSet_PT set, void *elem);
 
+/* O(lgN) : the elems >= elem are moved to the new set returned */
+extern XSet_PT   xset_split             (XSet_PT set, void *elem);
+
+/* O(lgN) : the elems in [low, high] are moved to the new set returned */
+extern XSet_PT   xset_remove_range      (XSet_PT set, void *low, void *high);
+
 /* O(N) */
 extern int       xset_map               (XSet_PT set, bool (*apply)(void *elem, void *cl), void *cl);
 extern bool      xset_map_break_if_true (XSet_PT set, bool (*apply)(void *elem, void *cl), void *cl);
@@ -74,7 +95,23 @@ extern bool      xset_map_break_if_false(XSet_PT set, bool (*apply)(void *elem,
 extern int       xset_map_min_to_max    (XSet_PT set, bool (*apply)(void *elem, void *cl), void *cl);
 extern int       xset_map_max_to_min    (XSet_PT set, bool (*apply)(void *elem, void *cl), void *cl);
 
+/* O(1) : put or remove to the set makes its cursors invalid, they must be moved by first, last or seek again */
+extern void      xset_cursor_init       (XSet_Cursor_PT cursor, XSet_PT set);
+
+/* O(lgN) */
+extern bool      xset_cursor_first      (XSet_Cursor_PT cursor);
+extern bool      xset_cursor_last       (XSet_Cursor_PT cursor);
+extern bool      xset_cursor_seek       (XSet_Cursor_PT cursor, void *elem);   /* the first elem >= elem */
+
+/* amortized O(1) */
+extern bool      xset_cursor_next       (XSet_Cursor_PT cursor);
+extern bool      xset_cursor_prev       (XSet_Cursor_PT cursor);
+
 /* O(1) */
+extern bool      xset_cursor_valid      (XSet_Cursor_PT cursor);
+extern void*     xset_cursor_elem       (XSet_Cursor_PT cursor);
+
+/* O(1), both must use the same allocator (see *_new_allocator) */
 extern bool      xset_swap              (XSet_PT set1, XSet_PT set2);
 
 /* O(NlgN) */
@@ -94,13 +131,27 @@ extern int       xset_elem_size         (XSet_PT set, void *elem);
 /* O(N) */
 extern int       xset_elems_size        (XSet_PT set, void *low, void *high);
 
-//extern bool      xset_subset            (XSet_PT set1, XSet_PT set2);     /* t is subset of s */
-//extern bool      xset_equal             (XSet_PT set1, XSet_PT set2);
-
-//extern XSet_PT   xset_union             (XSet_PT set1, XSet_PT set2);
-//extern XSet_PT   xset_inter             (XSet_PT set1, XSet_PT set2);
-//extern XSet_PT   xset_minus             (XSet_PT set1, XSet_PT set2);     /* s - t */
-//extern XSet_PT   xset_diff              (XSet_PT set1, XSet_PT set2);
+/* O(M + N), or O(MlgN) if the smaller set M is much smaller than N */
+extern bool      xset_subset            (XSet_PT set1, XSet_PT set2);     /* set2 is subset of set1 */
+extern bool      xset_equal             (XSet_PT set1, XSet_PT set2);
+
+/* O(M + N), or O(MlgN) for xset_inter and xset_minus if M is much smaller than N */
+extern XSet_PT   xset_union             (XSet_PT set1, XSet_PT set2);
+extern XSet_PT   xset_inter             (XSet_PT set1, XSet_PT set2);
+extern XSet_PT   xset_minus             (XSet_PT set1, XSet_PT set2);     /* set1 - set2 */
+extern XSet_PT   xset_diff              (XSet_PT set1, XSet_PT set2);
+
+#if defined(__linux__)
+/* O((M + N)/P) : both sets are split into ranges by the keys selected from the bigger set by rank, the ranges are merged
+ *                by the threads of "pool" and the caller, then the results are concatenated into the new set,
+ *                "pool" can be NULL to do all of them in the caller, the sets must not be changed before they return.
+ *                xset_parallel_inter and xset_parallel_minus call xset_inter and xset_minus if the search is cheaper
+ */
+extern XSet_PT   xset_parallel_union    (XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool);
+extern XSet_PT   xset_parallel_inter    (XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool);
+extern XSet_PT   xset_parallel_minus    (XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool);
+extern XSet_PT   xset_parallel_diff     (XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool);
+#endif
 
 #ifdef __cplusplus
 }
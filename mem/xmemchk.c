@@ -18,6 +18,8 @@
 
 #ifdef XDEBUG
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #if defined(__linux__)
@@ -30,9 +32,21 @@
 
 const XExcept_T xg_memory_failed = { "Memory Allocation Failed" };
 
-#define XMEM_HASH(p, t) (unsigned int)(((unsigned long long)(p)>>3) & (sizeof(t)/sizeof((t)[0]) - 1))
+#ifdef XWRAP_MALLOC
+#define XMEM_REAL_MALLOC(n)  __real_malloc(n)
+#define XMEM_REAL_FREE(p)    __real_free(p)
+#else
+#define XMEM_REAL_MALLOC(n)  malloc(n)
+#define XMEM_REAL_FREE(p)    free(p)
+#endif
 
-#define XMEM_HASHTAB_SIZE 2048
+/* the descriptors are saved in XMEM_SHARDS independent hash tables, each one has its own lock,
+ * so threads working on different pointers seldom wait for each other
+ */
+#define XMEM_SHARDS              64      /* power of 2 */
+#define XMEM_SHARD_MIN_SLOT      64      /* power of 2 */
+#define XMEM_SHARD_LOADING       2       /* the table of a shard is doubled when count > slot * XMEM_SHARD_LOADING */
+#define XMEM_DESC_CACHE_MAX      256     /* most released descriptors kept by each thread for reuse */
 
 typedef struct XMem_Descriptor* XMem_Descriptor_PT;
 struct XMem_Descriptor {
@@ -45,36 +59,134 @@ struct XMem_Descriptor {
     int         line;
 };
 
-static XMem_Descriptor_PT xmem_hashtab[XMEM_HASHTAB_SIZE] = { NULL };
+typedef struct XMem_Shard* XMem_Shard_PT;
+struct XMem_Shard {
 #if defined(__linux__)
-static pthread_mutex_t xmem_mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_t     lock;
 #endif
+    XMem_Descriptor_PT *buckets;        /* NULL before the first pointer comes */
+    unsigned int        slot;
+    unsigned int        count;
+};
+
+/* released descriptors of one thread */
+typedef struct XMem_Desc_Cache* XMem_Desc_Cache_PT;
+struct XMem_Desc_Cache {
+    XMem_Descriptor_PT head;
+    int                count;
+};
+
+static struct XMem_Shard xmem_shards[XMEM_SHARDS];
 
-static
-XMem_Descriptor_PT xmem_find(const void *ptr) {
 #if defined(__linux__)
-    pthread_mutex_lock(&xmem_mutex);
+static pthread_once_t xmem_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  xmem_cache_key;
+#else
+static struct XMem_Desc_Cache xmem_cache = { NULL, 0 };
 #endif
 
-    XMem_Descriptor_PT bp = xmem_hashtab[XMEM_HASH(ptr, xmem_hashtab)];
+/* mix all the bits of the pointer, the highest bits select the shard, the middle bits select the bucket
+ * (the lowest bits are poor since the pointers are aligned)
+ */
+static inline
+unsigned long long xmem_hash(const void *ptr) {
+    return ((unsigned long long)(uintptr_t)ptr >> 3) * 0x9E3779B97F4A7C15ULL;
+}
+
+static inline
+XMem_Shard_PT xmem_shard(unsigned long long hash) {
+    return &xmem_shards[(hash >> 58) & (XMEM_SHARDS - 1)];
+}
+
+static inline
+unsigned int xmem_bucket(unsigned long long hash, unsigned int slot) {
+    return (unsigned int)(hash >> 24) & (slot - 1);
+}
+
+#if defined(__linux__)
+/* called when a thread exits */
+static
+void xmem_cache_release(void *cl) {
+    XMem_Desc_Cache_PT cache = (XMem_Desc_Cache_PT)cl;
+
+    while (cache->head) {
+        XMem_Descriptor_PT next = cache->head->next;
+        XMEM_REAL_FREE(cache->head);
+        cache->head = next;
+    }
+
+    XMEM_REAL_FREE(cache);
+}
 
-    while (bp && bp->ptr != ptr)
-        bp = bp->next;
+static
+void xmem_init(void) {
+    for (int i = 0; i < XMEM_SHARDS; ++i) {
+        pthread_mutex_init(&xmem_shards[i].lock, NULL);
+    }
 
+    pthread_key_create(&xmem_cache_key, xmem_cache_release);
+}
+#endif
+
+static inline
+void xmem_shard_lock(XMem_Shard_PT shard) {
 #if defined(__linux__)
-    pthread_mutex_unlock(&xmem_mutex);
+    pthread_once(&xmem_once, xmem_init);
+    pthread_mutex_lock(&shard->lock);
 #endif
+}
 
-    return bp;
+static inline
+void xmem_shard_unlock(XMem_Shard_PT shard) {
+#if defined(__linux__)
+    pthread_mutex_unlock(&shard->lock);
+#endif
 }
 
+/* NULL if the cache of current thread can't be created */
 static
-XMem_Descriptor_PT xmem_dalloc(void *ptr, long size, const char *file, int line) {
-#ifdef XWRAP_MALLOC
-    XMem_Descriptor_PT descriptor = __real_malloc(sizeof(*descriptor));
+XMem_Desc_Cache_PT xmem_cache_get(void) {
+#if defined(__linux__)
+    pthread_once(&xmem_once, xmem_init);
+
+    {
+        XMem_Desc_Cache_PT cache = (XMem_Desc_Cache_PT)pthread_getspecific(xmem_cache_key);
+        if (!cache) {
+            cache = XMEM_REAL_MALLOC(sizeof(*cache));
+            if (!cache) {
+                return NULL;
+            }
+
+            cache->head = NULL;
+            cache->count = 0;
+
+            if (pthread_setspecific(xmem_cache_key, cache)) {
+                XMEM_REAL_FREE(cache);
+                return NULL;
+            }
+        }
+
+        return cache;
+    }
 #else
-    XMem_Descriptor_PT descriptor = malloc(sizeof(*descriptor));
+    return &xmem_cache;
 #endif
+}
+
+static
+XMem_Descriptor_PT xmem_dalloc(void *ptr, long size, const char *file, int line) {
+    XMem_Desc_Cache_PT cache = xmem_cache_get();
+    XMem_Descriptor_PT descriptor = NULL;
+
+    if (cache && cache->head) {
+        descriptor = cache->head;
+        cache->head = descriptor->next;
+        --cache->count;
+    }
+    else {
+        descriptor = XMEM_REAL_MALLOC(sizeof(*descriptor));
+    }
+
     if (!descriptor) {
 #ifdef XMEM_RAISE_EXCEPT
         if (file && line == 0)
@@ -95,40 +207,148 @@ XMem_Descriptor_PT xmem_dalloc(void *ptr, long size, const char *file, int line)
     return descriptor;
 }
 
-/* malloc nbytes memory, then save the memory info into the hash table : xmem_hashtab */
+static
+void xmem_dfree(XMem_Descriptor_PT descriptor) {
+    XMem_Desc_Cache_PT cache = xmem_cache_get();
+
+    if (cache && (cache->count < XMEM_DESC_CACHE_MAX)) {
+        descriptor->next = cache->head;
+        cache->head = descriptor;
+        ++cache->count;
+        return;
+    }
+
+    XMEM_REAL_FREE(descriptor);
+}
+
+/* shard->lock is held, the table keeps its size if no memory for a bigger one */
+static
+void xmem_shard_grow(XMem_Shard_PT shard) {
+    unsigned int slot = shard->slot ? shard->slot * 2 : XMEM_SHARD_MIN_SLOT;
+
+    XMem_Descriptor_PT *buckets = XMEM_REAL_MALLOC(slot * sizeof(XMem_Descriptor_PT));
+    if (!buckets) {
+        return;
+    }
+    memset(buckets, 0, slot * sizeof(XMem_Descriptor_PT));
+
+    for (unsigned int i = 0; i < shard->slot; ++i) {
+        while (shard->buckets[i]) {
+            XMem_Descriptor_PT bp = shard->buckets[i];
+            unsigned int h = xmem_bucket(xmem_hash(bp->ptr), slot);
+
+            shard->buckets[i] = bp->next;
+            bp->next = buckets[h];
+            buckets[h] = bp;
+        }
+    }
+
+    XMEM_REAL_FREE(shard->buckets);
+    shard->buckets = buckets;
+    shard->slot = slot;
+}
+
+/* save bp into its shard, false if the shard has no table and can't create it */
+static
+bool xmem_put(XMem_Descriptor_PT bp) {
+    unsigned long long hash = xmem_hash(bp->ptr);
+    XMem_Shard_PT shard = xmem_shard(hash);
+
+    xmem_shard_lock(shard);
+
+    if (!shard->buckets || (shard->slot * XMEM_SHARD_LOADING < shard->count)) {
+        xmem_shard_grow(shard);
+    }
+
+    if (!shard->buckets) {
+        xmem_shard_unlock(shard);
+        return false;
+    }
+
+    {
+        unsigned int h = xmem_bucket(hash, shard->slot);
+        bp->next = shard->buckets[h];
+        shard->buckets[h] = bp;
+        ++shard->count;
+    }
+
+    xmem_shard_unlock(shard);
+    return true;
+}
+
+/* remove the descriptor of ptr from its shard, NULL if ptr is not allocated by xmem.h (or released already) */
+static
+XMem_Descriptor_PT xmem_take(const void *ptr) {
+    unsigned long long hash = xmem_hash(ptr);
+    XMem_Shard_PT shard = xmem_shard(hash);
+    XMem_Descriptor_PT bp = NULL;
+
+    xmem_shard_lock(shard);
+
+    if (shard->buckets) {
+        XMem_Descriptor_PT *pp = &shard->buckets[xmem_bucket(hash, shard->slot)];
+
+        for (; *pp; pp = &(*pp)->next) {
+            if ((*pp)->ptr == ptr) {
+                bp = *pp;
+                *pp = bp->next;
+                --shard->count;
+                break;
+            }
+        }
+    }
+
+    xmem_shard_unlock(shard);
+
+    return bp;
+}
+
+/* the size of ptr when it's allocated, -1 if ptr is not allocated by xmem.h */
+static
+long xmem_size(const void *ptr) {
+    unsigned long long hash = xmem_hash(ptr);
+    XMem_Shard_PT shard = xmem_shard(hash);
+    long size = -1;
+
+    xmem_shard_lock(shard);
+
+    if (shard->buckets) {
+        for (XMem_Descriptor_PT bp = shard->buckets[xmem_bucket(hash, shard->slot)]; bp; bp = bp->next) {
+            if (bp->ptr == ptr) {
+                size = bp->size;
+                break;
+            }
+        }
+    }
+
+    xmem_shard_unlock(shard);
+
+    return size;
+}
+
+/* malloc nbytes memory, then save the memory info into the shard of the pointer */
 void* xmem_malloc(long nbytes, const char *file, int line) {
     xassert(0 < nbytes);
 
-
     {
-#ifdef XWRAP_MALLOC
-        void *ptr = __real_malloc(nbytes);
-#else
-        void *ptr = malloc(nbytes);
-#endif
+        void *ptr = XMEM_REAL_MALLOC(nbytes);
         if (ptr) {
-#if defined(__linux__)
-            pthread_mutex_lock(&xmem_mutex);
-#endif
-
             XMem_Descriptor_PT bp = xmem_dalloc(ptr, nbytes, file, line);
-            unsigned int h = XMEM_HASH(ptr, xmem_hashtab);
-            bp->next = xmem_hashtab[h];
-            xmem_hashtab[h] = bp;
 
-#if defined(__linux__)
-            pthread_mutex_unlock(&xmem_mutex);
-#endif
-            return ptr;
+            if (xmem_put(bp)) {
+                return ptr;
+            }
+
+            xmem_dfree(bp);
+            XMEM_REAL_FREE(ptr);
         }
-        else {
+
 #ifdef XMEM_RAISE_EXCEPT
-            if (file && (line == 0))
-                XEXCEPT_RAISE(xg_memory_failed);
-            else
-                xexcept_raise(&xg_memory_failed, file, line);
+        if (file && (line == 0))
+            XEXCEPT_RAISE(xg_memory_failed);
+        else
+            xexcept_raise(&xg_memory_failed, file, line);
 #endif
-        }
     }
 
     xassert(0);
@@ -141,56 +361,19 @@ void xmem_free(void *ptr, const char *file, int line) {
         return;
     }
 
-#if defined(__linux__)
-    pthread_mutex_lock(&xmem_mutex);
-#endif
-
     {
-        unsigned int h = XMEM_HASH(ptr, xmem_hashtab);
-        XMem_Descriptor_PT bp = xmem_hashtab[h];
+        /* the lock is released already, so raising for a bad pointer (or a double free) is safe here */
+        XMem_Descriptor_PT bp = xmem_take(ptr);
         xassert(bp);
 
-        if (bp->ptr == ptr) {
-            xmem_hashtab[h] = bp->next;
-#ifdef XWRAP_MALLOC
-            __real_free(bp);
-#else
-            free(bp);
-#endif
-            bp = NULL;
+        if (!bp) {
+            return;
         }
-        else {
-            XMem_Descriptor_PT np = bp->next;
-            while (np) {
-                if (np->ptr == ptr) {
-                    bp->next = np->next;
-                    break;
-                }
-                else {
-                    bp = np;
-                    np = np->next;
-                }
-            }
 
-            xassert(np);
-#ifdef XWRAP_MALLOC
-            __real_free(np);
-#else
-            free(np);
-#endif
-            np = NULL;
-        }
+        xmem_dfree(bp);
     }
 
-#ifdef XWRAP_MALLOC
-    __real_free(ptr);
-#else
-    free(ptr);
-#endif
-
-#if defined(__linux__)
-    pthread_mutex_unlock(&xmem_mutex);
-#endif
+    XMEM_REAL_FREE(ptr);
     return;
 }
 
@@ -214,12 +397,12 @@ void* xmem_resize(void *ptr, long nbytes, const char *file, int line) {
 
     {
         /* check the ptr is allocated by xmem.h */
-        XMem_Descriptor_PT bp = xmem_find(ptr);
-        xassert(bp);
+        long size = xmem_size(ptr);
+        xassert(0 < size);
 
         {
             void *newptr = xmem_calloc(1, nbytes, file, line);
-            memcpy(newptr, ptr, nbytes < bp->size ? nbytes : bp->size);
+            memcpy(newptr, ptr, nbytes < size ? nbytes : size);
 
             xmem_free(ptr, file, line);
 
@@ -235,15 +418,15 @@ void* xmem_resize0(void *ptr, long obytes, long nbytes, const char *file, int li
 
     {
         /* check the ptr is allocated by xmem.h */
-        XMem_Descriptor_PT bp = xmem_find(ptr);
-        xassert(bp);
+        long size = xmem_size(ptr);
+        xassert(0 < size);
 
         {
             void *newptr = xmem_calloc(1, nbytes, file, line);
-            memcpy(newptr, ptr, nbytes < bp->size ? nbytes : bp->size);
+            memcpy(newptr, ptr, nbytes < size ? nbytes : size);
 
-            if (bp->size < nbytes) {
-                memset((char*)newptr + bp->size, 0, nbytes - bp->size);
+            if (size < nbytes) {
+                memset((char*)newptr + size, 0, nbytes - size);
             }
 
             xmem_free(ptr, file, line);
@@ -264,20 +447,20 @@ void __wrap_free(void *ptr) {
 #endif
 
 void xmem_leak(void(*apply)(const void *ptr, long size, const char *file, int line, void *cl), void *cl) {
-    XMem_Descriptor_PT bp = NULL;
     xassert(apply);
 
-#if defined(__linux__)
-    pthread_mutex_lock(&xmem_mutex);
-#endif
-    for (int i = 0; i < XMEM_HASHTAB_SIZE; i++) {
-        for (bp = xmem_hashtab[i]; bp; bp = bp->next) {
-            apply(bp->ptr, bp->size, bp->file, bp->line, cl);
+    /* one shard is locked at a time, so apply must not allocate or release memory of the same shard */
+    for (int i = 0; i < XMEM_SHARDS; i++) {
+        XMem_Shard_PT shard = &xmem_shards[i];
+
+        xmem_shard_lock(shard);
+        for (unsigned int j = 0; j < shard->slot; j++) {
+            for (XMem_Descriptor_PT bp = shard->buckets[j]; bp; bp = bp->next) {
+                apply(bp->ptr, bp->size, bp->file, bp->line, cl);
+            }
         }
+        xmem_shard_unlock(shard);
     }
-#if defined(__linux__)
-    pthread_mutex_unlock(&xmem_mutex);
-#endif
 }
 
 #endif
@@ -16,6 +16,7 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <limits.h>
 
 #include "../include/xassert.h"
 #include "../include/xexcept.h"
@@ -36,6 +37,80 @@ int xarena_index(int bytes) {
     return (((bytes) + XUTILS_ARENA_MIN_ALIGN_SIZE - 1) / XUTILS_ARENA_MIN_ALIGN_SIZE - 1);
 }
 
+/* the statistics below do nothing if XARENA_NO_STATS is defined */
+#ifndef XARENA_NO_STATS
+static
+void xarena_count_hold(XArena_Counter_PT counter, long bytes) {
+    counter->live_bytes += bytes;
+    if (counter->peak_bytes < counter->live_bytes) {
+        counter->peak_bytes = counter->live_bytes;
+    }
+}
+#endif
+
+static
+void xarena_count_chunk(XArena_PT arena, int bytes) {
+#ifndef XARENA_NO_STATS
+    ++arena->stats.chunks;
+    arena->stats.chunk_bytes += bytes;
+#endif
+}
+
+static
+void xarena_count_refill(XArena_PT arena, int nbytes) {
+#ifndef XARENA_NO_STATS
+    ++arena->counters[xarena_index(nbytes)].refills;
+#endif
+}
+
+/* an object of nbytes is allocated (alloc is true) or released */
+static
+void xarena_count_object(XArena_PT arena, int nbytes, bool alloc) {
+#ifndef XARENA_NO_STATS
+    if (XUTILS_ARENA_MAX_BYTES < nbytes) {
+        if (alloc) {
+            ++arena->stats.big_allocs;
+            arena->stats.big_live_bytes += nbytes;
+            if (arena->stats.big_peak_bytes < arena->stats.big_live_bytes) {
+                arena->stats.big_peak_bytes = arena->stats.big_live_bytes;
+            }
+        }
+        else {
+            ++arena->stats.big_frees;
+            arena->stats.big_live_bytes -= nbytes;
+        }
+    }
+    else {
+        XArena_Counter_PT counter = &arena->counters[xarena_index(nbytes)];
+        int size = xarena_round_up(nbytes);
+
+        if (alloc) {
+            ++counter->allocs;
+            counter->waste_bytes += size - nbytes;
+            xarena_count_hold(counter, size);
+        }
+        else {
+            ++counter->frees;
+            xarena_count_hold(counter, -size);
+        }
+    }
+#endif
+}
+
+/* all the objects are released by xarena_clear or xarena_reset */
+static
+void xarena_count_release_all(XArena_PT arena) {
+#ifndef XARENA_NO_STATS
+    for (int i = 0; i < XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE; ++i) {
+        arena->counters[i].frees = arena->counters[i].allocs;
+        arena->counters[i].live_bytes = 0;
+    }
+
+    arena->stats.big_frees = arena->stats.big_allocs;
+    arena->stats.big_live_bytes = 0;
+#endif
+}
+
 /* allocate memory in large chunks in order to avoid fragmenting the malloc heap too much.
  * assume that size is properly aligned.
  */
@@ -69,7 +144,16 @@ char* xarena_chunk_alloc(XArena_PT arena, int size, int* nobjs)
         }
 
         /* try to allocate new block of memorys */
-        arena->start_free = (char*)XMEM_MALLOC(bytes_to_get);
+        {
+            XArena_Chunk_PT chunk = XMEM_MALLOC(sizeof(union XArena_Chunk) + bytes_to_get);
+            if (chunk) {
+                chunk->head.next = arena->chunks;
+                chunk->head.size = bytes_to_get;
+                arena->chunks = chunk;
+                xarena_count_chunk(arena, bytes_to_get);
+            }
+            arena->start_free = chunk ? (char*)(chunk + 1) : NULL;
+        }
         if (!arena->start_free) {
             /* failed to allocate new block of memorys, try to get memory from the exist blocks which is bigger than the size needed */
             for (int i = size; i <= XUTILS_ARENA_MAX_BYTES; i += XUTILS_ARENA_MIN_ALIGN_SIZE) {
@@ -92,10 +176,6 @@ char* xarena_chunk_alloc(XArena_PT arena, int size, int* nobjs)
         }
 
         {
-            if(!xhashtab_put_repeat(arena->mem_track, arena->start_free)) {
-                xassert(false);
-            }
-
             arena->end_free = arena->start_free + bytes_to_get;
 
             return(xarena_chunk_alloc(arena, size, nobjs));
@@ -111,6 +191,9 @@ void* xarena_refill(XArena_PT arena, int nbytes)
 {
     int nobjs[1] = { 32 };
     char* chunk = xarena_chunk_alloc(arena, nbytes, nobjs);
+    if (chunk) {
+        xarena_count_refill(arena, nbytes);
+    }
     if (1 == nobjs[0]) {
         return chunk;
     }
@@ -138,6 +221,96 @@ void* xarena_refill(XArena_PT arena, int nbytes)
     return chunk;
 }
 
+static
+void xarena_big_link(XArena_PT arena, XArena_Chunk_PT big) {
+    big->head.prev = NULL;
+    big->head.next = arena->bigs;
+    if (arena->bigs) {
+        arena->bigs->head.prev = big;
+    }
+    arena->bigs = big;
+}
+
+static
+void xarena_big_unlink(XArena_PT arena, XArena_Chunk_PT big) {
+    if (big->head.prev) {
+        big->head.prev->head.next = big->head.next;
+    }
+    else {
+        arena->bigs = big->head.next;
+    }
+    if (big->head.next) {
+        big->head.next->head.prev = big->head.prev;
+    }
+}
+
+/* blocks bigger than XUTILS_ARENA_MAX_BYTES are taken from malloc one by one */
+static
+void* xarena_big_alloc(XArena_PT arena, int nbytes, bool zero) {
+    XArena_Chunk_PT big = zero ? XMEM_CALLOC(1, sizeof(union XArena_Chunk) + nbytes) : XMEM_MALLOC(sizeof(union XArena_Chunk) + nbytes);
+    if (!big) {
+        return NULL;
+    }
+
+    big->head.size = nbytes;
+    xarena_big_link(arena, big);
+    xarena_count_object(arena, nbytes, true);
+
+    return big + 1;
+}
+
+static
+void xarena_chunks_free(XArena_Chunk_PT chunk) {
+    while (chunk) {
+        XArena_Chunk_PT next = chunk->head.next;
+        XMEM_FREE(chunk);
+        chunk = next;
+    }
+}
+
+/* bump nbytes in the current chunk, go to the next chunk if it is full */
+static
+void* xarena_region_alloc(XArena_PT arena, int nbytes) {
+    int size = xarena_round_up(nbytes);
+
+    if ((int)(arena->end_free - arena->start_free) < size) {
+        XArena_Chunk_PT chunk = arena->current ? arena->current->head.next : arena->chunks;
+
+        /* the chunks kept by xarena_reset are used again if they are big enough */
+        if (!chunk || (chunk->head.size < size)) {
+            int bytes = (size < XUTILS_ARENA_REGION_CHUNK_BYTES) ? XUTILS_ARENA_REGION_CHUNK_BYTES : size;
+
+            XArena_Chunk_PT nchunk = XMEM_MALLOC(sizeof(union XArena_Chunk) + bytes);
+            if (!nchunk) {
+                return NULL;
+            }
+
+            nchunk->head.size = bytes;
+            nchunk->head.next = chunk;
+            xarena_count_chunk(arena, bytes);
+            if (arena->current) {
+                arena->current->head.next = nchunk;
+            }
+            else {
+                arena->chunks = nchunk;
+            }
+
+            chunk = nchunk;
+        }
+
+        arena->current = chunk;
+        arena->start_free = (char*)(chunk + 1);
+        arena->end_free = arena->start_free + chunk->head.size;
+    }
+
+    {
+        void *ret = arena->start_free;
+        arena->start_free += size;
+        xarena_count_object(arena, nbytes, true);
+        return ret;
+    }
+}
+
 XArena_PT xarena_new(void) {
     XArena_PT arena = XMEM_CALLOC(1, sizeof(*arena));
     if (!arena) {
@@ -150,12 +323,14 @@ XArena_PT xarena_new(void) {
         return NULL;
     }
 
-    arena->mem_track = xhashtab_new(XUTILS_HASH_SLOTS_DEFAULT_HINT, xutils_hash_pointer, xutils_pointer_equal, NULL);
-    if (!arena->mem_track) {
+#ifndef XARENA_NO_STATS
+    arena->counters = XMEM_CALLOC(XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE, sizeof(XArena_Counter_T));
+    if (!arena->counters) {
         xparray_free(&arena->free_list);
         XMEM_FREE(arena);
         return NULL;
     }
+#endif
 
     arena->start_free = NULL;
     arena->end_free = NULL;
@@ -163,6 +338,276 @@ XArena_PT xarena_new(void) {
     return arena;
 }
 
+/* the shared members of a thread safe arena are protected by arena->lock */
+static
+void xarena_lock(XArena_PT arena) {
+#if defined(__linux__)
+    if (arena->thread_safe) {
+        pthread_mutex_lock(&arena->lock);
+    }
+#endif
+}
+
+static
+void xarena_unlock(XArena_PT arena) {
+#if defined(__linux__)
+    if (arena->thread_safe) {
+        pthread_mutex_unlock(&arena->lock);
+    }
+#endif
+}
+
+XArena_PT xarena_new_region(void) {
+    XArena_PT arena = xarena_new();
+    if (!arena) {
+        return NULL;
+    }
+
+    arena->region = true;
+
+    return arena;
+}
+
+#if defined(__linux__)
+/* move the first n objects of cls into the shared free list, arena->lock is held */
+static
+void xarena_cache_give_back(XArena_PT arena, XArena_Cache_Class_PT cls, int index, int n) {
+    if (n <= 0) {
+        return;
+    }
+
+    {
+        XArena_Obj_PT head = cls->head;
+        XArena_Obj_PT tail = head;
+
+        for (int i = 1; i < n; ++i) {
+            tail = tail->next;
+        }
+
+        cls->head = tail->next;
+        cls->count -= n;
+#ifndef XARENA_NO_STATS
+        xarena_count_hold(&arena->counters[index], -(long)n * (index + 1) * XUTILS_ARENA_MIN_ALIGN_SIZE);
+#endif
+
+        tail->next = (XArena_Obj_PT)xparray_get_impl(arena->free_list, index);
+        xparray_put_impl(arena->free_list, index, (void*)head);
+    }
+}
+
+/* add the counters of the cache into the arena, arena->lock is held */
+static
+void xarena_cache_count_fold(XArena_PT arena, XArena_Cache_PT cache) {
+#ifndef XARENA_NO_STATS
+    for (int i = 0; i < XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE; ++i) {
+        arena->counters[i].allocs += cache->classes[i].allocs;
+        arena->counters[i].frees += cache->classes[i].frees;
+        arena->counters[i].waste_bytes += cache->classes[i].waste_bytes;
+
+        __atomic_store_n(&cache->classes[i].allocs, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&cache->classes[i].frees, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&cache->classes[i].waste_bytes, 0, __ATOMIC_RELAXED);
+    }
+#endif
+}
+
+/* called when the thread exits, all the cached objects go back to the arena */
+static
+void xarena_cache_release(void *ptr) {
+    XArena_Cache_PT cache = (XArena_Cache_PT)ptr;
+    XArena_PT arena = cache->arena;
+
+    pthread_mutex_lock(&arena->lock);
+    {
+        for (int i = 0; i < XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE; ++i) {
+            xarena_cache_give_back(arena, &cache->classes[i], i, cache->classes[i].count);
+        }
+        xarena_cache_count_fold(arena, cache);
+
+        if (cache->prev) {
+            cache->prev->next = cache->next;
+        }
+        else {
+            arena->caches = cache->next;
+        }
+        if (cache->next) {
+            cache->next->prev = cache->prev;
+        }
+
+        XMEM_FREE(cache);
+    }
+    pthread_mutex_unlock(&arena->lock);
+}
+
+/* cache of the calling thread, created at the first call */
+static
+XArena_Cache_PT xarena_cache(XArena_PT arena) {
+    XArena_Cache_PT cache = (XArena_Cache_PT)pthread_getspecific(arena->cache_key);
+    if (cache) {
+        return cache;
+    }
+
+    pthread_mutex_lock(&arena->lock);
+    {
+        cache = XMEM_CALLOC(1, sizeof(*cache) + (XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE) * sizeof(XArena_Cache_Class_T));
+        if (cache) {
+            cache->arena = arena;
+            cache->next = arena->caches;
+            if (arena->caches) {
+                arena->caches->prev = cache;
+            }
+            arena->caches = cache;
+        }
+    }
+    pthread_mutex_unlock(&arena->lock);
+
+    if (cache && (pthread_setspecific(arena->cache_key, cache) != 0)) {
+        xarena_cache_release(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+/* take at most XUTILS_ARENA_CACHE_BATCH objects from the shared free list, or from a new chunk if the list is empty */
+static
+bool xarena_cache_fill(XArena_PT arena, XArena_Cache_Class_PT cls, int index, int size) {
+    pthread_mutex_lock(&arena->lock);
+    {
+        XArena_Obj_PT head = (XArena_Obj_PT)xparray_get_impl(arena->free_list, index);
+        if (head) {
+            XArena_Obj_PT tail = head;
+            int count = 1;
+
+            while ((count < XUTILS_ARENA_CACHE_BATCH) && tail->next) {
+                tail = tail->next;
+                ++count;
+            }
+
+            xparray_put_impl(arena->free_list, index, (void*)tail->next);
+            tail->next = NULL;
+
+            cls->head = head;
+            cls->count = count;
+#ifndef XARENA_NO_STATS
+            xarena_count_hold(&arena->counters[index], (long)count * size);
+#endif
+        }
+        else {
+            int nobjs[1] = { XUTILS_ARENA_CACHE_BATCH };
+            char *chunk = xarena_chunk_alloc(arena, size, nobjs);
+            if (chunk) {
+                for (int i = 0; i < nobjs[0]; ++i) {
+                    XArena_Obj_PT obj = (XArena_Obj_PT)(chunk + i * size);
+                    obj->next = (i + 1 < nobjs[0]) ? (XArena_Obj_PT)(chunk + (i + 1) * size) : NULL;
+                }
+
+                cls->head = (XArena_Obj_PT)chunk;
+                cls->count = nobjs[0];
+                xarena_count_refill(arena, size);
+#ifndef XARENA_NO_STATS
+                xarena_count_hold(&arena->counters[index], (long)nobjs[0] * size);
+#endif
+            }
+        }
+    }
+    pthread_mutex_unlock(&arena->lock);
+
+    return cls->head != NULL;
+}
+
+/* no lock is needed unless the cache of the thread is empty */
+static
+void* xarena_cache_alloc(XArena_PT arena, int nbytes) {
+    int index = xarena_index(nbytes);
+
+    XArena_Cache_PT cache = xarena_cache(arena);
+    if (!cache) {
+        return NULL;
+    }
+
+    {
+        XArena_Cache_Class_PT cls = &cache->classes[index];
+        XArena_Obj_PT obj = cls->head;
+
+        if (!obj) {
+            if (!xarena_cache_fill(arena, cls, index, xarena_round_up(nbytes))) {
+                return NULL;
+            }
+            obj = cls->head;
+        }
+
+        cls->head = obj->next;
+        --cls->count;
+
+#ifndef XARENA_NO_STATS
+        /* only this thread writes them, xarena_stats may read them at any time */
+        __atomic_store_n(&cls->allocs, cls->allocs + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&cls->waste_bytes, cls->waste_bytes + xarena_round_up(nbytes) - nbytes, __ATOMIC_RELAXED);
+#endif
+
+        return obj;
+    }
+}
+
+/* no lock is needed unless the cache of the thread is full */
+static
+void xarena_cache_free(XArena_PT arena, void *ptr, int nbytes) {
+    int index = xarena_index(nbytes);
+    XArena_Obj_PT obj = (XArena_Obj_PT)ptr;
+
+    XArena_Cache_PT cache = xarena_cache(arena);
+    if (!cache) {
+        pthread_mutex_lock(&arena->lock);
+        obj->next = (XArena_Obj_PT)xparray_get_impl(arena->free_list, index);
+        xparray_put_impl(arena->free_list, index, (void*)obj);
+        xarena_count_object(arena, nbytes, false);
+        pthread_mutex_unlock(&arena->lock);
+        return;
+    }
+
+    {
+        XArena_Cache_Class_PT cls = &cache->classes[index];
+
+        obj->next = cls->head;
+        cls->head = obj;
+        ++cls->count;
+
+#ifndef XARENA_NO_STATS
+        __atomic_store_n(&cls->frees, cls->frees + 1, __ATOMIC_RELAXED);
+#endif
+
+        if (XUTILS_ARENA_CACHE_MAX <= cls->count) {
+            pthread_mutex_lock(&arena->lock);
+            xarena_cache_give_back(arena, cls, index, XUTILS_ARENA_CACHE_BATCH);
+            pthread_mutex_unlock(&arena->lock);
+        }
+    }
+}
+
+XArena_PT xarena_new_thread_safe(void) {
+    XArena_PT arena = xarena_new();
+    if (!arena) {
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&arena->lock, NULL) != 0) {
+        xarena_free(&arena);
+        return NULL;
+    }
+
+    if (pthread_key_create(&arena->cache_key, xarena_cache_release) != 0) {
+        pthread_mutex_destroy(&arena->lock);
+        xarena_free(&arena);
+        return NULL;
+    }
+
+    arena->thread_safe = true;
+
+    return arena;
+}
+#endif
+
 void* xarena_alloc(XArena_PT arena, int nbytes) {
     xassert(arena);
     xassert(0 < nbytes);
@@ -175,24 +620,37 @@ void* xarena_alloc(XArena_PT arena, int nbytes) {
 #endif
     }
 
+    if (arena->region) {
+        return xarena_region_alloc(arena, nbytes);
+    }
+
     if (XUTILS_ARENA_MAX_BYTES < nbytes) {
-        void* ret = XMEM_MALLOC(nbytes);
-        if (ret) {
-            if (!xhashtab_put_repeat(arena->mem_track, ret)) {
-                xassert(false);
-            }
-        }
+        void* ret = NULL;
+
+        xarena_lock(arena);
+        ret = xarena_big_alloc(arena, nbytes, false);
+        xarena_unlock(arena);
+
         return ret;
     }
     else {
+#if defined(__linux__)
+        if (arena->thread_safe) {
+            return xarena_cache_alloc(arena, nbytes);
+        }
+#endif
         XArena_Obj_PT result = (XArena_Obj_PT)xparray_get_impl(arena->free_list, xarena_index(nbytes));
         if (!result) {
-            return xarena_refill(arena, xarena_round_up(nbytes));
+            result = (XArena_Obj_PT)xarena_refill(arena, xarena_round_up(nbytes));
         }
         else {
             xparray_put_impl(arena->free_list, xarena_index(nbytes), result->next);
-            return result;
         }
+
+        if (result) {
+            xarena_count_object(arena, nbytes, true);
+        }
+        return result;
     }
 }
 
@@ -211,13 +669,13 @@ void* xarena_calloc(XArena_PT arena, int count, int nbytes) {
 
     {
         int total = count * nbytes;
-        if (XUTILS_ARENA_MAX_BYTES < total) {
-            void *ret = XMEM_CALLOC(count, nbytes);
-            if (ret ) {
-                if (!xhashtab_put_repeat(arena->mem_track, ret)) {
-                    xassert(false);
-                }
-            }
+        if ((XUTILS_ARENA_MAX_BYTES < total) && !arena->region) {
+            void *ret = NULL;
+
+            xarena_lock(arena);
+            ret = xarena_big_alloc(arena, total, true);
+            xarena_unlock(arena);
+
             return ret;
         }
         else {
@@ -248,27 +706,45 @@ void* xarena_realloc(XArena_PT arena, void* p,  int old_sz, int new_sz) {
     }
 
     {
-        if ((XUTILS_ARENA_MAX_BYTES < old_sz) && (XUTILS_ARENA_MAX_BYTES < new_sz)) {
-            /* new p may equal to old p, so delete it from the mem_track at first */
-            xhashtab_remove(arena->mem_track, p);
+        if (!arena->region && (XUTILS_ARENA_MAX_BYTES < old_sz) && (XUTILS_ARENA_MAX_BYTES < new_sz)) {
+            XArena_Chunk_PT big = (XArena_Chunk_PT)p - 1;
+            XArena_Chunk_PT old_big = big;
+
+            xarena_lock(arena);
 
-            XMEM_RESIZE(p, new_sz);
-            if (!p) {
+            /* the block may be moved */
+            xarena_big_unlink(arena, big);
+
+            XMEM_RESIZE(big, sizeof(union XArena_Chunk) + new_sz);
+            if (!big) {
+                xarena_big_link(arena, old_big);
+                xarena_unlock(arena);
                 xassert(false);
                 return NULL;
             }
 
-            if (!xhashtab_put_repeat(arena->mem_track, p)) {
-                xassert(false);
-            }
+            big->head.size = new_sz;
+            xarena_big_link(arena, big);
+            xarena_count_object(arena, old_sz, false);
+            xarena_count_object(arena, new_sz, true);
 
-            return p;
+            xarena_unlock(arena);
+
+            return big + 1;
         }
 
         if (xarena_round_up(old_sz) == xarena_round_up(new_sz)) {
             return p;
         }
 
+        /* the last object of a region grows or shrinks in place if the current chunk is big enough */
+        if (arena->region && ((char*)p + xarena_round_up(old_sz) == arena->start_free) && ((char*)p + xarena_round_up(new_sz) <= arena->end_free)) {
+            arena->start_free = (char*)p + xarena_round_up(new_sz);
+            xarena_count_object(arena, old_sz, false);
+            xarena_count_object(arena, new_sz, true);
+            return p;
+        }
+
         {
             void *ptr = xarena_calloc(arena, 1, new_sz);
             if (!ptr) {
@@ -278,7 +754,7 @@ void* xarena_realloc(XArena_PT arena, void* p,  int old_sz, int new_sz) {
 
             memcpy(ptr, p, (old_sz < new_sz ? old_sz : new_sz));
 
-            xarena_freep(arena, p, old_sz);
+            xarena_freep(arena, &p, old_sz);
 
             return ptr;
         }
@@ -296,25 +772,38 @@ void xarena_freep(XArena_PT arena, void** p, int nbytes)
         return;
     }
 
-    if (XUTILS_ARENA_MAX_BYTES < nbytes) {
-        xhashtab_remove(arena->mem_track, *p);
-        XMEM_FREE(*p);
+    /* objects of a region are released all together */
+    if (arena->region) {
+        *p = NULL;
     }
+    else if (XUTILS_ARENA_MAX_BYTES < nbytes) {
+        XArena_Chunk_PT big = (XArena_Chunk_PT)*p - 1;
+
+        xarena_lock(arena);
+        xarena_big_unlink(arena, big);
+        xarena_count_object(arena, big->head.size, false);
+        XMEM_FREE(big);
+        xarena_unlock(arena);
+
+        *p = NULL;
+    }
+#if defined(__linux__)
+    else if (arena->thread_safe) {
+        xarena_cache_free(arena, *p, nbytes);
+        *p = NULL;
+    }
+#endif
     else {
         XArena_Obj_PT q = (XArena_Obj_PT)*p;
         q->next = (XArena_Obj_PT)xparray_get_impl(arena->free_list, xarena_index(nbytes));
         xparray_put_impl(arena->free_list, xarena_index(nbytes), q);
+        xarena_count_object(arena, nbytes, false);
+        *p = NULL;
     }
 
     return;
 }
 
-static
-bool xarena_clear_free(void *member, void *cl) {
-    XMEM_FREE(member);
-    return true;
-}
-
 void xarena_clear(XArena_PT arena) {
     xassert(arena);
 
@@ -322,17 +811,58 @@ void xarena_clear(XArena_PT arena) {
         return;
     }
 
+    xarena_lock(arena);
+
+#if defined(__linux__)
+    /* the objects cached by the threads are released with the chunks */
+    for (XArena_Cache_PT cache = arena->caches; cache; cache = cache->next) {
+        xarena_cache_count_fold(arena, cache);
+        memset(cache->classes, 0, (XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE) * sizeof(XArena_Cache_Class_T));
+    }
+#endif
+
     xparray_clear(arena->free_list);
 
-    xhashtab_map(arena->mem_track, xarena_clear_free, NULL);
-    xhashtab_clear(arena->mem_track);
+    xarena_chunks_free(arena->chunks);
+    xarena_chunks_free(arena->bigs);
+    arena->chunks = NULL;
+    arena->bigs = NULL;
+    arena->current = NULL;
+
+    xarena_count_release_all(arena);
+#ifndef XARENA_NO_STATS
+    arena->stats.chunks = 0;
+    arena->stats.chunk_bytes = 0;
+#endif
 
     arena->start_free = NULL;
     arena->end_free = NULL;
 
+    xarena_unlock(arena);
+
     return;
 }
 
+void xarena_reset(XArena_PT arena) {
+    xassert(arena);
+
+    if (!arena) {
+        return;
+    }
+
+    if (!arena->region) {
+        xarena_clear(arena);
+        return;
+    }
+
+    /* all the chunks are kept, allocate from the first one again */
+    arena->current = arena->chunks;
+    arena->start_free = arena->chunks ? (char*)(arena->chunks + 1) : NULL;
+    arena->end_free = arena->chunks ? arena->start_free + arena->chunks->head.size : NULL;
+
+    xarena_count_release_all(arena);
+}
+
 void xarena_free(XArena_PT *parena) {
     xassert(parena);
     xassert(*parena);
@@ -341,11 +871,188 @@ void xarena_free(XArena_PT *parena) {
         return;
     }
 
-    xhashtab_deep_free(&(*parena)->mem_track);
+#if defined(__linux__)
+    if ((*parena)->thread_safe) {
+        /* no destructor is called for the threads exiting later */
+        pthread_key_delete((*parena)->cache_key);
+
+        while ((*parena)->caches) {
+            XArena_Cache_PT next = (*parena)->caches->next;
+            XMEM_FREE((*parena)->caches);
+            (*parena)->caches = next;
+        }
+
+        pthread_mutex_destroy(&(*parena)->lock);
+    }
+#endif
+
+    xarena_chunks_free((*parena)->chunks);
+    xarena_chunks_free((*parena)->bigs);
 
     xparray_free(&(*parena)->free_list);
 
+#ifndef XARENA_NO_STATS
+    XMEM_FREE((*parena)->counters);
+#endif
+
     XMEM_FREE(*parena);
 
     return;
 }
+
+/* the arena takes int sizes, a bigger block can't come from it */
+static
+void* xarena_allocator_alloc(void *ctx, long nbytes) {
+    xassert(nbytes <= INT_MAX);
+
+    if (INT_MAX < nbytes) {
+        return NULL;
+    }
+
+    return xarena_calloc((XArena_PT)ctx, 1, (int)nbytes);
+}
+
+static
+void* xarena_allocator_resize(void *ctx, void *ptr, long obytes, long nbytes) {
+    xassert(obytes <= INT_MAX);
+    xassert(nbytes <= INT_MAX);
+
+    if ((INT_MAX < obytes) || (INT_MAX < nbytes)) {
+        return NULL;
+    }
+
+    return xarena_realloc((XArena_PT)ctx, ptr, (int)obytes, (int)nbytes);
+}
+
+static
+void xarena_allocator_free(void *ctx, void *ptr, long nbytes) {
+    xassert(nbytes <= INT_MAX);
+
+    if (INT_MAX < nbytes) {
+        return;
+    }
+
+    xarena_freep((XArena_PT)ctx, &ptr, (int)nbytes);
+}
+
+void xarena_allocator(XArena_PT arena, XMem_Allocator_PT allocator) {
+    xassert(arena);
+    xassert(allocator);
+
+    if (!arena || !allocator) {
+        return;
+    }
+
+    allocator->alloc = xarena_allocator_alloc;
+    allocator->resize = xarena_allocator_resize;
+    allocator->free = xarena_allocator_free;
+    allocator->ctx = (void*)arena;
+}
+
+#ifndef XARENA_NO_STATS
+/* arena->lock is held */
+static
+void xarena_class_stats_impl(XArena_PT arena, int index, XArena_Class_Stats_PT stats) {
+    XArena_Counter_PT counter = &arena->counters[index];
+
+    stats->size = (index + 1) * XUTILS_ARENA_MIN_ALIGN_SIZE;
+    stats->allocs = counter->allocs;
+    stats->frees = counter->frees;
+    stats->refills = counter->refills;
+    stats->waste_bytes = counter->waste_bytes;
+    stats->peak_bytes = counter->peak_bytes;
+
+#if defined(__linux__)
+    for (XArena_Cache_PT cache = arena->caches; cache; cache = cache->next) {
+        stats->allocs += __atomic_load_n(&cache->classes[index].allocs, __ATOMIC_RELAXED);
+        stats->frees += __atomic_load_n(&cache->classes[index].frees, __ATOMIC_RELAXED);
+        stats->waste_bytes += __atomic_load_n(&cache->classes[index].waste_bytes, __ATOMIC_RELAXED);
+    }
+#endif
+
+    stats->live_bytes = (stats->allocs - stats->frees) * stats->size;
+}
+#endif
+
+bool xarena_stats(XArena_PT arena, XArena_Stats_PT stats) {
+    xassert(arena);
+    xassert(stats);
+
+    if (!arena || !stats) {
+        return false;
+    }
+
+#ifdef XARENA_NO_STATS
+    return false;
+#else
+    xarena_lock(arena);
+    {
+        *stats = arena->stats;
+        stats->allocs = 0;
+        stats->frees = 0;
+        stats->waste_bytes = 0;
+        stats->live_bytes = 0;
+
+        for (int i = 0; i < XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE; ++i) {
+            XArena_Class_Stats_T class_stats;
+            xarena_class_stats_impl(arena, i, &class_stats);
+
+            stats->allocs += class_stats.allocs;
+            stats->frees += class_stats.frees;
+            stats->waste_bytes += class_stats.waste_bytes;
+            stats->live_bytes += class_stats.live_bytes;
+        }
+    }
+    xarena_unlock(arena);
+
+    return true;
+#endif
+}
+
+bool xarena_class_stats(XArena_PT arena, int size, XArena_Class_Stats_PT stats) {
+    xassert(arena);
+    xassert(0 < size);
+    xassert(size <= XUTILS_ARENA_MAX_BYTES);
+    xassert(stats);
+
+    if (!arena || (size <= 0) || (XUTILS_ARENA_MAX_BYTES < size) || !stats) {
+        return false;
+    }
+
+#ifdef XARENA_NO_STATS
+    return false;
+#else
+    xarena_lock(arena);
+    xarena_class_stats_impl(arena, xarena_index(size), stats);
+    xarena_unlock(arena);
+
+    return true;
+#endif
+}
+
+void xarena_stats_dump(XArena_PT arena, FILE *fp) {
+    XArena_Stats_T stats;
+
+    if (!fp) {
+        fp = stdout;
+    }
+
+    if (!xarena_stats(arena, &stats)) {
+        fprintf(fp, "no arena statistics\n");
+        return;
+    }
+
+    fprintf(fp, "chunks : %d, chunk bytes : %ld\n", stats.chunks, stats.chunk_bytes);
+    fprintf(fp, "small objects : allocs %ld, frees %ld, waste bytes %ld, live bytes %ld\n", stats.allocs, stats.frees, stats.waste_bytes, stats.live_bytes);
+    fprintf(fp, "big objects   : allocs %ld, frees %ld, live bytes %ld, peak bytes %ld\n", stats.big_allocs, stats.big_frees, stats.big_live_bytes, stats.big_peak_bytes);
+    fprintf(fp, "%6s %12s %12s %10s %12s %12s %12s\n", "size", "allocs", "frees", "refills", "waste", "live", "peak");
+
+    for (int size = XUTILS_ARENA_MIN_ALIGN_SIZE; size <= XUTILS_ARENA_MAX_BYTES; size += XUTILS_ARENA_MIN_ALIGN_SIZE) {
+        XArena_Class_Stats_T class_stats;
+        if (!xarena_class_stats(arena, size, &class_stats) || (class_stats.allocs == 0)) {
+            continue;
+        }
+
+        fprintf(fp, "%6d %12ld %12ld %10ld %12ld %12ld %12ld\n", class_stats.size, class_stats.allocs, class_stats.frees, class_stats.refills, class_stats.waste_bytes, class_stats.live_bytes, class_stats.peak_bytes);
+    }
+}
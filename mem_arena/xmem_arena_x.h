@@ -13,7 +13,7 @@
 #ifndef XARENAX_INCLUDED
 #define XARENAX_INCLUDED
 
-#include "../include/xhash_table.h"
+#include <stdbool.h>
 #include "../include/xarray_pointer.h"
 #include "../include/xmem_arena.h"
 
@@ -23,13 +23,86 @@ union XArena_Obj {
     char          data[1];
 };
 
+/* header of each block taken from malloc, the blocks of an arena are chained through it */
+typedef union XArena_Chunk* XArena_Chunk_PT;
+union XArena_Chunk {
+    struct {
+        XArena_Chunk_PT next;
+        XArena_Chunk_PT prev;    /* only used by the big blocks, they are released one by one */
+        int             size;    /* bytes following the header */
+    } head;
+    double              align;
+    long long           align2;
+};
+
+#ifndef XARENA_NO_STATS
+/* counters of one class, live_bytes and peak_bytes are about the objects taken out of the shared free list */
+typedef struct XArena_Counter  XArena_Counter_T;
+typedef struct XArena_Counter* XArena_Counter_PT;
+struct XArena_Counter {
+    long allocs;
+    long frees;
+    long refills;
+    long waste_bytes;
+    long live_bytes;
+    long peak_bytes;
+};
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+
+/* objects of one size cached by a thread */
+typedef struct XArena_Cache_Class  XArena_Cache_Class_T;
+typedef struct XArena_Cache_Class* XArena_Cache_Class_PT;
+struct XArena_Cache_Class {
+    XArena_Obj_PT head;
+    int           count;
+
+#ifndef XARENA_NO_STATS
+    /* only written by the owner thread, added into the arena when the thread exits */
+    long          allocs;
+    long          frees;
+    long          waste_bytes;
+#endif
+};
+
+/* thread local cache of a thread safe arena, created by the first allocation of the thread,
+ * given back to the arena when the thread exits
+ */
+typedef struct XArena_Cache* XArena_Cache_PT;
+struct XArena_Cache {
+    XArena_PT             arena;
+    XArena_Cache_PT       prev;       /* caches of all threads are linked for xarena_clear and xarena_free */
+    XArena_Cache_PT       next;
+
+    XArena_Cache_Class_T  classes[];  /* XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE classes */
+};
+#endif
+
 struct XArena {
     char*         start_free;
     char*         end_free;
     
     XPArray_PT    free_list;
 
-    XHashtab_PT   mem_track;  /* save the allocated memory pointer for free */
+    XArena_Chunk_PT chunks;      /* chunks of the small objects (all the objects in region mode) */
+    XArena_Chunk_PT bigs;        /* blocks bigger than XUTILS_ARENA_MAX_BYTES */
+
+    bool            region;      /* bump allocation only, nothing is released until xarena_reset or xarena_clear */
+    XArena_Chunk_PT current;     /* region mode : the chunk start_free points into, the chunks after it are kept for reuse */
+
+#ifndef XARENA_NO_STATS
+    XArena_Counter_PT counters;  /* XUTILS_ARENA_MAX_BYTES / XUTILS_ARENA_MIN_ALIGN_SIZE classes */
+    XArena_Stats_T    stats;     /* allocs, frees, waste_bytes and live_bytes are summed up by xarena_stats */
+#endif
+
+#if defined(__linux__)
+    bool            thread_safe;
+    pthread_mutex_t lock;        /* protects all the members above, the thread caches are accessed without it */
+    pthread_key_t   cache_key;
+    XArena_Cache_PT caches;
+#endif
 };
 
 #endif
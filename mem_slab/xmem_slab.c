@@ -0,0 +1,192 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/xassert.h"
+#include "../utils/xutils.h"
+#include "../include/xmem.h"
+#include "xmem_slab_x.h"
+
+static
+int xslab_round_up(int bytes) {
+    return (((bytes) + XUTILS_ARENA_MIN_ALIGN_SIZE - 1) & ~(XUTILS_ARENA_MIN_ALIGN_SIZE - 1));
+}
+
+XSlab_PT xslab_new(int obj_size) {
+    return xslab_new_allocator(obj_size, NULL);
+}
+
+XSlab_PT xslab_new_allocator(int obj_size, XMem_Allocator_PT allocator) {
+    xassert(0 < obj_size);
+
+    if (obj_size <= 0) {
+        return NULL;
+    }
+
+    {
+        XSlab_PT slab = XMEM_ALLOC_BY(allocator, sizeof(*slab));
+        if (!slab) {
+            return NULL;
+        }
+
+        slab->obj_size = xslab_round_up(obj_size < (int)sizeof(union XSlab_Obj) ? (int)sizeof(union XSlab_Obj) : obj_size);
+        slab->refs = 1;
+        slab->next_objs = XUTILS_SLAB_MIN_OBJS;
+        slab->allocator = allocator;
+
+        return slab;
+    }
+}
+
+/* add a new slab in front of the others, its objects are handed out from start_free */
+static
+bool xslab_grow(XSlab_PT slab) {
+    int bytes = (int)sizeof(union XSlab_Chunk) + slab->next_objs * slab->obj_size;
+
+    XSlab_Chunk_PT chunk = slab->allocator ? slab->allocator->alloc(slab->allocator->ctx, bytes) : XMEM_MALLOC(bytes);
+    if (!chunk) {
+        return false;
+    }
+
+    chunk->head.next = slab->slabs;
+    chunk->head.bytes = bytes;
+    slab->slabs = chunk;
+
+    slab->start_free = (char*)(chunk + 1);
+    slab->end_free = slab->start_free + slab->next_objs * slab->obj_size;
+
+    ++slab->slab_count;
+    slab->bytes += bytes;
+
+    if (slab->next_objs * 2 * slab->obj_size <= XUTILS_SLAB_MAX_BYTES) {
+        slab->next_objs *= 2;
+    }
+
+    return true;
+}
+
+void* xslab_alloc(XSlab_PT slab) {
+    xassert(slab);
+
+    if (!slab) {
+        return NULL;
+    }
+
+    {
+        void *obj = NULL;
+
+        if (slab->free_list) {
+            obj = slab->free_list;
+            slab->free_list = slab->free_list->next;
+        }
+        else {
+            if ((slab->start_free == slab->end_free) && !xslab_grow(slab)) {
+                return NULL;
+            }
+
+            obj = slab->start_free;
+            slab->start_free += slab->obj_size;
+        }
+
+        ++slab->used_count;
+        memset(obj, 0, slab->obj_size);
+
+        return obj;
+    }
+}
+
+void xslab_freep(XSlab_PT slab, void **pobj) {
+    xassert(slab);
+    xassert(pobj);
+
+    if (!slab || !pobj || !*pobj) {
+        return;
+    }
+
+    {
+        XSlab_Obj_PT obj = (XSlab_Obj_PT)*pobj;
+        obj->next = slab->free_list;
+        slab->free_list = obj;
+
+        --slab->used_count;
+        *pobj = NULL;
+    }
+}
+
+XSlab_PT xslab_share(XSlab_PT slab) {
+    xassert(slab);
+
+    if (!slab) {
+        return NULL;
+    }
+
+    ++slab->refs;
+    return slab;
+}
+
+bool xslab_is_shared(XSlab_PT slab) {
+    return slab ? (1 < slab->refs) : false;
+}
+
+void xslab_clear(XSlab_PT slab) {
+    xassert(slab);
+
+    if (!slab) {
+        return;
+    }
+
+    while (slab->slabs) {
+        XSlab_Chunk_PT next = slab->slabs->head.next;
+        XMEM_FREE_BY(slab->allocator, slab->slabs, slab->slabs->head.bytes);
+        slab->slabs = next;
+    }
+
+    slab->start_free = NULL;
+    slab->end_free = NULL;
+    slab->free_list = NULL;
+
+    slab->next_objs = XUTILS_SLAB_MIN_OBJS;
+    slab->slab_count = 0;
+    slab->used_count = 0;
+    slab->bytes = 0;
+}
+
+void xslab_free(XSlab_PT *pslab) {
+    if (!pslab || !*pslab) {
+        return;
+    }
+
+    if (--(*pslab)->refs <= 0) {
+        xslab_clear(*pslab);
+        XMEM_FREE_BY((*pslab)->allocator, *pslab, sizeof(**pslab));
+    }
+
+    *pslab = NULL;
+}
+
+int xslab_obj_size(XSlab_PT slab) {
+    return slab ? slab->obj_size : 0;
+}
+
+int xslab_slab_count(XSlab_PT slab) {
+    return slab ? slab->slab_count : 0;
+}
+
+int xslab_used_count(XSlab_PT slab) {
+    return slab ? slab->used_count : 0;
+}
+
+long xslab_bytes(XSlab_PT slab) {
+    return slab ? slab->bytes : 0;
+}
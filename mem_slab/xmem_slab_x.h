@@ -0,0 +1,53 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XSLABX_INCLUDED
+#define XSLABX_INCLUDED
+
+#include "../include/xmem_slab.h"
+
+typedef union XSlab_Obj* XSlab_Obj_PT;
+union XSlab_Obj {
+    XSlab_Obj_PT next;
+    char         data[1];
+};
+
+/* header of each slab, the objects follow it */
+typedef union XSlab_Chunk* XSlab_Chunk_PT;
+union XSlab_Chunk {
+    struct {
+        XSlab_Chunk_PT next;     /* slabs are linked from the newest one to the oldest one */
+        int            bytes;
+    } head;
+    double             align;
+    long long          align2;
+};
+
+struct XSlab {
+    int            obj_size;     /* aligned size of each object */
+    int            refs;         /* count of the containers sharing this slab */
+
+    XSlab_Chunk_PT slabs;
+    char*          start_free;   /* objects never used in the newest slab */
+    char*          end_free;
+
+    XSlab_Obj_PT   free_list;    /* objects released by xslab_freep */
+
+    int            next_objs;    /* count of objects in the next new slab */
+    int            slab_count;
+    int            used_count;
+    long           bytes;
+
+    XMem_Allocator_PT allocator; /* NULL : XMEM */
+};
+
+#endif
@@ -22,6 +22,10 @@
 #include "xqueue_deque_x.h"
 
 XDeque_PT xdeque_new(int capacity) {
+    return xdeque_new_allocator(capacity, NULL);
+}
+
+XDeque_PT xdeque_new_allocator(int capacity, XMem_Allocator_PT allocator) {
     xassert(0 <= capacity);
 
     if (capacity < 0) {
@@ -29,17 +33,18 @@ XDeque_PT xdeque_new(int capacity) {
     }
 
     {
-        XDeque_PT deque = XMEM_CALLOC(1, sizeof(*deque));
+        XDeque_PT deque = XMEM_ALLOC_BY(allocator, sizeof(*deque));
         if (!deque) {
             return NULL;
         }
 
-        deque->layer1_seq = xpseq_new((capacity == 0) ? XUTILS_DEQUE_LAYER1_DEFAULT_LENGTH : capacity);
+        deque->layer1_seq = xpseq_new_allocator((capacity == 0) ? XUTILS_DEQUE_LAYER1_DEFAULT_LENGTH : capacity, allocator);
         if (!deque->layer1_seq) {
-            XMEM_FREE(deque);
+            XMEM_FREE_BY(allocator, deque, sizeof(*deque));
             return NULL;
         }
         
+        deque->allocator = allocator;
         deque->size = 0;
         deque->capacity = capacity;
         deque->discard_strategy = XUTILS_QUEUE_STRATEGY_DISCARD_NEW;
@@ -55,7 +60,7 @@ XDeque_PT xdeque_copy_impl(XDeque_PT deque, int count, int elem_size, bool deep)
     }
 
     {
-        XDeque_PT ndeque = xdeque_new(deque->capacity);
+        XDeque_PT ndeque = xdeque_new_allocator(deque->capacity, deque->allocator);
         if (!ndeque) {
             return NULL;
         }
@@ -241,7 +246,7 @@ bool xdeque_push_front(XDeque_PT deque, void *x) {
 
         {
             // add one new XPSeq_PT to layer 1 XPSeq_PT front
-            XPSeq_PT nseq = xpseq_new(seq ? seq->array->size : XUTILS_DEQUE_LAYER2_DEFAULT_LENGTH);
+            XPSeq_PT nseq = xpseq_new_allocator(seq ? seq->array->size : XUTILS_DEQUE_LAYER2_DEFAULT_LENGTH, deque->allocator);
             if (!nseq) {
                 return false;
             }
@@ -375,7 +380,7 @@ bool xdeque_push_back(XDeque_PT deque, void *x) {
         }
 
         // add one new XPSeq_PT to layer 1 XPSeq_PT back
-        XPSeq_PT nseq = xpseq_new(seq ? seq->array->size : XUTILS_DEQUE_LAYER2_DEFAULT_LENGTH);
+        XPSeq_PT nseq = xpseq_new_allocator(seq ? seq->array->size : XUTILS_DEQUE_LAYER2_DEFAULT_LENGTH, deque->allocator);
         if (!nseq) {
             return false;
         }
@@ -644,7 +649,7 @@ void xdeque_free(XDeque_PT *pdeque) {
 
     // free layer 1 XPSeq_PT
     xpseq_free(&((*pdeque)->layer1_seq));
-    XMEM_FREE(*pdeque);
+    XMEM_FREE_BY((*pdeque)->allocator, *pdeque, sizeof(**pdeque));
 }
 
 void xdeque_free_apply(XDeque_PT *pdeque, bool (*apply)(void *x, void *cl), void *cl) {
@@ -658,7 +663,7 @@ void xdeque_free_apply(XDeque_PT *pdeque, bool (*apply)(void *x, void *cl), void
 
     // free layer 1 XPSeq_PT
     xpseq_free(&((*pdeque)->layer1_seq));
-    XMEM_FREE(*pdeque);
+    XMEM_FREE_BY((*pdeque)->allocator, *pdeque, sizeof(**pdeque));
 }
 
 void xdeque_deep_free(XDeque_PT *pdeque) {
@@ -673,7 +678,7 @@ void xdeque_deep_free(XDeque_PT *pdeque) {
     else {
         xpseq_deep_free(&((*pdeque)->layer1_seq));
     }
-    XMEM_FREE(*pdeque);
+    XMEM_FREE_BY((*pdeque)->allocator, *pdeque, sizeof(**pdeque));
 }
 
 static 
@@ -718,7 +723,7 @@ int xdeque_capacity(XDeque_PT deque) {
 /* save the first layer XPSeq_PT into the second layer, make the capacity no limit */
 bool xdeque_set_capacity_no_limit(XDeque_PT deque) {
     if (deque->capacity != 0) {
-        XPSeq_PT nseq = xpseq_new(XUTILS_DEQUE_LAYER1_DEFAULT_LENGTH);
+        XPSeq_PT nseq = xpseq_new_allocator(XUTILS_DEQUE_LAYER1_DEFAULT_LENGTH, deque->allocator);
         if (!nseq) {
             return false;
         }
@@ -742,8 +747,9 @@ bool xdeque_is_empty(XDeque_PT deque) {
 bool xdeque_swap(XDeque_PT deque1, XDeque_PT deque2) {
     xassert(deque1);
     xassert(deque2);
+    xassert(deque1->allocator == deque2->allocator);
 
-    if (!deque1 || !deque2) {
+    if (!deque1 || !deque2 || (deque1->allocator != deque2->allocator)) {
         return false;
     }
 
@@ -46,6 +46,8 @@ struct XDeque {
                                 *   2 : discard back
                                 */
     XPSeq_PT layer1_seq;
+
+    XMem_Allocator_PT allocator;  /* the deque and all its XPSeq_PT come from it, NULL : XMEM */
 };
 
 /* used to transfer one kind of interface to another */
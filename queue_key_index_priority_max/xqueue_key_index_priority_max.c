@@ -36,7 +36,7 @@ bool xkeyindexmaxpq_pop(XKeyIndexMaxPQ_PT queue, void **key, void **value) {
 
     {
         void *nkey = NULL;
-        void *nvalue = xmap_select(queue->value_map, (xmap_size(queue->value_map) -1));
+        void *nvalue = xmap_max(queue->value_map);
 
         xmap_remove_save(queue->value_map, nvalue, &nkey);
         xmap_remove(queue->key_map, nkey);
@@ -60,7 +60,7 @@ bool xkeyindexmaxpq_peek(XKeyIndexMaxPQ_PT queue, void **key, void **value) {
     }
 
     {
-        void *nvalue = xmap_select(queue->value_map, (xmap_size(queue->value_map) - 1));
+        void *nvalue = xmap_max(queue->value_map);
         void *nkey = xmap_get(queue->value_map, nvalue);
 
         if (key) {
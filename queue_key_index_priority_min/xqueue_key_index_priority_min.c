@@ -132,7 +132,7 @@ bool xkeyindexminpq_pop(XKeyIndexMinPQ_PT queue, void **key, void **value) {
 
     {
         void *nkey = NULL;
-        void *nvalue = xmap_select(queue->value_map, 0);
+        void *nvalue = xmap_min(queue->value_map);
 
         xmap_remove_save(queue->value_map, nvalue, &nkey);
         xmap_remove(queue->key_map, nkey);
@@ -156,7 +156,7 @@ bool xkeyindexminpq_peek(XKeyIndexMinPQ_PT queue, void **key, void **value) {
     }
 
     {
-        void *nvalue = xmap_select(queue->value_map, 0);
+        void *nvalue = xmap_min(queue->value_map);
         void *nkey = xmap_get(queue->value_map, nvalue);
 
         if (key) {
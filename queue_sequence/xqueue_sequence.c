@@ -25,6 +25,10 @@
 #include "xqueue_sequence_x.h"
 
 XPSeq_PT xpseq_new(int capacity) {
+    return xpseq_new_allocator(capacity, NULL);
+}
+
+XPSeq_PT xpseq_new_allocator(int capacity, XMem_Allocator_PT allocator) {
     xassert(0 < capacity);
 
     if (capacity <= 0) {
@@ -32,17 +36,19 @@ XPSeq_PT xpseq_new(int capacity) {
     }
 
     {
-        XPSeq_PT seq = XMEM_CALLOC(1, sizeof(*seq));
+        XPSeq_PT seq = XMEM_ALLOC_BY(allocator, sizeof(*seq));
         if (!seq) {
             return NULL;
         }
 
-        seq->array = xparray_new(capacity);
+        seq->array = xparray_new_allocator(capacity, allocator);
         if (!seq->array) {
-            XMEM_FREE(seq);
+            XMEM_FREE_BY(allocator, seq, sizeof(*seq));
             return NULL;
         }
 
+        seq->allocator = allocator;
+
         //seq->size = 0;
         //seq->head = 0;
 
@@ -56,17 +62,19 @@ XPSeq_PT xpseq_copyn_impl(XPSeq_PT seq, int count, int elem_size, bool deep) {
     }
 
     {
-        XPSeq_PT nseq = XMEM_CALLOC(1, sizeof(*seq));
+        XPSeq_PT nseq = XMEM_ALLOC_BY(seq->allocator, sizeof(*seq));
         if (!nseq) {
             return NULL;
         }
 
+        nseq->allocator = seq->allocator;
+
         if (seq->head == 0) {
             nseq->array = deep ? xparray_deep_copyn(seq->array, count, elem_size) : xparray_copyn(seq->array, count);
         }
         else {
             if (count == 0) {
-                nseq->array = xparray_new(count);
+                nseq->array = xparray_new_allocator(count, seq->allocator);
             }
             else if (count <= (seq->array->size - seq->head)) {
                 nseq->array = deep ? xparray_scope_deep_copy(seq->array, seq->head, seq->head + count - 1, elem_size) : xparray_scope_copy(seq->array, seq->head, seq->head + count - 1);
@@ -74,7 +82,7 @@ XPSeq_PT xpseq_copyn_impl(XPSeq_PT seq, int count, int elem_size, bool deep) {
             else {
                 nseq->array = deep ? xparray_scope_deep_copy(seq->array, seq->head, seq->array->size - 1, elem_size) : xparray_scope_copy(seq->array, seq->head, seq->array->size - 1);
                 if (!nseq->array) {
-                    XMEM_FREE(nseq);
+                    XMEM_FREE_BY(seq->allocator, nseq, sizeof(*nseq));
                     return NULL;
                 }
                 nseq->size = seq->array->size - seq->head;
@@ -95,7 +103,7 @@ XPSeq_PT xpseq_copyn_impl(XPSeq_PT seq, int count, int elem_size, bool deep) {
         }
 
         if (!nseq->array) {
-            XMEM_FREE(nseq);
+            XMEM_FREE_BY(seq->allocator, nseq, sizeof(*nseq));
             return NULL;
         }
 
@@ -362,7 +370,7 @@ void xpseq_free_impl(XPSeq_PT *pseq, bool deep, bool (*apply)(void *x, void *cl)
     }
 
     xparray_free(&((*pseq)->array));
-    XMEM_FREE(*pseq);
+    XMEM_FREE_BY((*pseq)->allocator, *pseq, sizeof(**pseq));
 }
 
 void xpseq_free(XPSeq_PT *pseq) {
@@ -455,8 +463,9 @@ bool xpseq_is_full(XPSeq_PT seq) {
 bool xpseq_swap(XPSeq_PT seq1, XPSeq_PT seq2) {
     xassert(seq1);
     xassert(seq2);
+    xassert(seq1->allocator == seq2->allocator);
 
-    if (!seq1 || !seq2) {
+    if (!seq1 || !seq2 || (seq1->allocator != seq2->allocator)) {
         return false;
     }
 
@@ -21,6 +21,8 @@ struct XPSeq {
     int   size;     /* number of valid elements in sequence (not the memory size) */
 
     XPArray_PT array;
+
+    XMem_Allocator_PT allocator;  /* the sequence and its array come from it, NULL : XMEM */
 };
 
 /* O(N) */
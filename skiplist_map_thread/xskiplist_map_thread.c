@@ -0,0 +1,756 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#if defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../include/xassert.h"
+#include "../include/xmem.h"
+#include "xskiplist_map_thread_x.h"
+
+/* the retired nodes of one record are checked after so many nodes are retired */
+static const int XTS_SKIPMAP_RETIRE_BATCH = 64;
+
+static
+bool xts_skipmap_marked(uintptr_t next) {
+    return (next & 1) != 0;
+}
+
+static
+XTS_SkipMap_Node_PT xts_skipmap_ptr(uintptr_t next) {
+    return (XTS_SkipMap_Node_PT)(next & ~(uintptr_t)1);
+}
+
+static
+uintptr_t xts_skipmap_load(uintptr_t *next) {
+    return __atomic_load_n(next, __ATOMIC_ACQUIRE);
+}
+
+static
+bool xts_skipmap_cas(uintptr_t *next, uintptr_t expected, uintptr_t desired) {
+    return __atomic_compare_exchange_n(next, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static
+XTS_SkipMap_Node_PT xts_skipmap_node_new(int level) {
+    /* the next pointers are just after the node */
+    XTS_SkipMap_Node_PT node = XMEM_CALLOC(1, sizeof(*node) + level * sizeof(uintptr_t));
+    if (!node) {
+        return NULL;
+    }
+
+    node->level = level;
+    node->next = (uintptr_t*)(node + 1);
+
+    return node;
+}
+
+static
+void xts_skipmap_record_release(void *record) {
+    /* the thread exits, the retired nodes are kept for the next thread using the record */
+    __atomic_store_n(&((XTS_SkipMap_Record_PT)record)->in_use, false, __ATOMIC_RELEASE);
+}
+
+static
+XTS_SkipMap_Record_PT xts_skipmap_record(XTS_SkipMap_PT map) {
+    XTS_SkipMap_Record_PT record = pthread_getspecific(map->record_key);
+    if (record) {
+        return record;
+    }
+
+    /* reuse the record of one exited thread */
+    for (record = __atomic_load_n(&map->records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        bool expected = false;
+        if (!__atomic_load_n(&record->in_use, __ATOMIC_ACQUIRE)
+            && __atomic_compare_exchange_n(&record->in_use, &expected, true, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+    }
+
+    if (!record) {
+        record = XMEM_CALLOC(1, sizeof(*record));
+        if (!record) {
+            return NULL;
+        }
+
+        record->in_use = true;
+        record->seed = (unsigned int)((uintptr_t)record >> 4) ^ (unsigned int)time(NULL);
+        if (record->seed == 0) {
+            record->seed = 1;
+        }
+
+        record->next = __atomic_load_n(&map->records, __ATOMIC_ACQUIRE);
+        while (!__atomic_compare_exchange_n(&map->records, &record->next, record, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        }
+    }
+
+    if (pthread_setspecific(map->record_key, record) != 0) {
+        xts_skipmap_record_release(record);
+        return NULL;
+    }
+
+    return record;
+}
+
+/* the nodes seen after it can't be freed until xts_skipmap_exit is called */
+static
+XTS_SkipMap_Record_PT xts_skipmap_enter(XTS_SkipMap_PT map) {
+    XTS_SkipMap_Record_PT record = xts_skipmap_record(map);
+    if (!record) {
+        return NULL;
+    }
+
+    if (record->nest++ == 0) {
+        __atomic_store_n(&record->epoch, __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+        __atomic_store_n(&record->active, true, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    return record;
+}
+
+static
+void xts_skipmap_exit(XTS_SkipMap_Record_PT record) {
+    if (--record->nest == 0) {
+        __atomic_store_n(&record->active, false, __ATOMIC_RELEASE);
+    }
+}
+
+/* the global epoch moves forward only if all the active threads have seen it */
+static
+void xts_skipmap_try_advance(XTS_SkipMap_PT map) {
+    unsigned long epoch = __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST);
+
+    for (XTS_SkipMap_Record_PT record = __atomic_load_n(&map->records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        if (__atomic_load_n(&record->active, __ATOMIC_SEQ_CST) && (__atomic_load_n(&record->epoch, __ATOMIC_SEQ_CST) != epoch)) {
+            return;
+        }
+    }
+
+    __atomic_compare_exchange_n(&map->epoch, &epoch, epoch + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* a node retired in epoch E can't be seen by any thread when the global epoch is E + 2 */
+static
+void xts_skipmap_reclaim(XTS_SkipMap_PT map, XTS_SkipMap_Record_PT record) {
+    unsigned long epoch = __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST);
+    XTS_SkipMap_Node_PT *pnode = &record->retired;
+
+    while (*pnode) {
+        XTS_SkipMap_Node_PT node = *pnode;
+
+        if (node->retire_epoch + 2 <= epoch) {
+            *pnode = node->retire_next;
+            --record->retired_size;
+            XMEM_FREE(node);
+        }
+        else {
+            pnode = &node->retire_next;
+        }
+    }
+}
+
+static
+void xts_skipmap_retire(XTS_SkipMap_PT map, XTS_SkipMap_Record_PT record, XTS_SkipMap_Node_PT node) {
+    node->retire_epoch = __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST);
+    node->retire_next = record->retired;
+    record->retired = node;
+
+    if (XTS_SKIPMAP_RETIRE_BATCH <= ++record->retired_size) {
+        xts_skipmap_try_advance(map);
+        xts_skipmap_reclaim(map, record);
+    }
+}
+
+/* the inserter and the remover both call it when they don't touch the node any more */
+static
+void xts_skipmap_node_release(XTS_SkipMap_PT map, XTS_SkipMap_Record_PT record, XTS_SkipMap_Node_PT node) {
+    if (__atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        xts_skipmap_retire(map, record, node);
+    }
+}
+
+static
+int xts_skipmap_random_level(XTS_SkipMap_Record_PT record) {
+    int level = 1;
+
+    while (level < XTS_SKIPMAP_MAX_LEVEL) {
+        /* xorshift32 */
+        record->seed ^= record->seed << 13;
+        record->seed ^= record->seed >> 17;
+        record->seed ^= record->seed << 5;
+
+        /* 1/4 nodes go to the upper level */
+        if ((record->seed & 3) != 0) {
+            break;
+        }
+        ++level;
+    }
+
+    return level;
+}
+
+/* returns -1 if one marked node can't be unlinked since its predecessor is changed, then the search restarts */
+static
+int xts_skipmap_find_once(XTS_SkipMap_PT map, void *key, XTS_SkipMap_Node_PT target, XTS_SkipMap_Node_PT *preds, XTS_SkipMap_Node_PT *succs) {
+    XTS_SkipMap_Node_PT pred = map->head;
+    XTS_SkipMap_Node_PT curr = NULL;
+
+    for (int level = XTS_SKIPMAP_MAX_LEVEL - 1; 0 <= level; --level) {
+        curr = xts_skipmap_ptr(xts_skipmap_load(&pred->next[level]));
+
+        while (curr) {
+            uintptr_t succ = xts_skipmap_load(&curr->next[level]);
+
+            /* curr is removed, unlink it on this level */
+            if (xts_skipmap_marked(succ)) {
+                if (!xts_skipmap_cas(&pred->next[level], (uintptr_t)curr, (uintptr_t)xts_skipmap_ptr(succ))) {
+                    return -1;
+                }
+
+                curr = xts_skipmap_ptr(succ);
+                continue;
+            }
+
+            {
+                int ret = map->cmp(curr->key, key, map->cl);
+                if ((0 < ret) || ((ret == 0) && (!target || (curr == target)))) {
+                    break;
+                }
+            }
+
+            pred = curr;
+            curr = xts_skipmap_ptr(succ);
+        }
+
+        if (preds) {
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+    }
+
+    return (curr && (map->cmp(curr->key, key, map->cl) == 0)) ? 1 : 0;
+}
+
+/* succs[i] is the first node whose key >= key on level i, all marked nodes on the path are unlinked,
+*  if target is not NULL, the nodes with the same key are skipped until target is met
+*  (a removed node may be after one new node with the same key on the upper levels)
+*/
+static
+bool xts_skipmap_find_impl(XTS_SkipMap_PT map, void *key, XTS_SkipMap_Node_PT target, XTS_SkipMap_Node_PT *preds, XTS_SkipMap_Node_PT *succs) {
+    int ret = -1;
+
+    while (ret < 0) {
+        ret = xts_skipmap_find_once(map, key, target, preds, succs);
+    }
+
+    return ret == 1;
+}
+
+/* make sure the marked node is not linked on any level */
+static
+void xts_skipmap_unlink(XTS_SkipMap_PT map, XTS_SkipMap_Node_PT node) {
+    xts_skipmap_find_impl(map, node->key, node, NULL, NULL);
+}
+
+/* link the upper levels of the new node, stop if it's removed by other thread */
+static
+void xts_skipmap_link_upper(XTS_SkipMap_PT map, XTS_SkipMap_Node_PT node, XTS_SkipMap_Node_PT *preds, XTS_SkipMap_Node_PT *succs) {
+    for (int level = 1; level < node->level; ++level) {
+        while (true) {
+            uintptr_t next = xts_skipmap_load(&node->next[level]);
+            if (xts_skipmap_marked(next)) {
+                return;
+            }
+
+            if ((next != (uintptr_t)succs[level]) && !xts_skipmap_cas(&node->next[level], next, (uintptr_t)succs[level])) {
+                continue;
+            }
+
+            if (xts_skipmap_cas(&preds[level]->next[level], (uintptr_t)succs[level], (uintptr_t)node)) {
+                break;
+            }
+
+            /* node is removed if it's not found any more */
+            if (!xts_skipmap_find_impl(map, node->key, NULL, preds, succs) || (succs[0] != node)) {
+                return;
+            }
+        }
+    }
+}
+
+static
+bool xts_skipmap_put_impl(XTS_SkipMap_PT map, void *key, void *value, bool replace) {
+    XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+    XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+    XTS_SkipMap_Node_PT node = NULL;
+    bool ret = false;
+
+    XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+    if (!record) {
+        return false;
+    }
+
+    while (true) {
+        if (xts_skipmap_find_impl(map, key, NULL, preds, succs)) {
+            if (replace) {
+                __atomic_store_n(&succs[0]->value, value, __ATOMIC_RELEASE);
+                ret = true;
+            }
+
+            /* nobody has seen it */
+            if (node) {
+                XMEM_FREE(node);
+            }
+            break;
+        }
+
+        if (!node) {
+            node = xts_skipmap_node_new(xts_skipmap_random_level(record));
+            if (!node) {
+                break;
+            }
+
+            node->key = key;
+            node->value = value;
+            node->refs = 2;
+        }
+
+        for (int level = 0; level < node->level; ++level) {
+            node->next[level] = (uintptr_t)succs[level];
+        }
+
+        /* the node is in the map once it's linked on level 0 */
+        if (xts_skipmap_cas(&preds[0]->next[0], (uintptr_t)succs[0], (uintptr_t)node)) {
+            __atomic_add_fetch(&map->size, 1, __ATOMIC_RELAXED);
+
+            xts_skipmap_link_upper(map, node, preds, succs);
+
+            /* it's removed while linking, maybe linked again on some level after the remover unlinked it */
+            if (xts_skipmap_marked(xts_skipmap_load(&node->next[0]))) {
+                xts_skipmap_unlink(map, node);
+            }
+
+            xts_skipmap_node_release(map, record, node);
+            ret = true;
+            break;
+        }
+    }
+
+    xts_skipmap_exit(record);
+    return ret;
+}
+
+XTS_SkipMap_PT xts_skipmap_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    xassert(cmp);
+
+    if (!cmp) {
+        return NULL;
+    }
+
+    {
+        XTS_SkipMap_PT map = XMEM_CALLOC(1, sizeof(*map));
+        if (!map) {
+            return NULL;
+        }
+
+        map->head = xts_skipmap_node_new(XTS_SKIPMAP_MAX_LEVEL);
+        if (!map->head) {
+            XMEM_FREE(map);
+            return NULL;
+        }
+
+        if (pthread_key_create(&map->record_key, xts_skipmap_record_release) != 0) {
+            XMEM_FREE(map->head);
+            XMEM_FREE(map);
+            return NULL;
+        }
+
+        map->cmp = cmp;
+        map->cl = cl;
+
+        return map;
+    }
+}
+
+bool xts_skipmap_put_replace(XTS_SkipMap_PT map, void *key, void *value) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    return xts_skipmap_put_impl(map, key, value, true);
+}
+
+bool xts_skipmap_put_if_absent(XTS_SkipMap_PT map, void *key, void *value) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    return xts_skipmap_put_impl(map, key, value, false);
+}
+
+void* xts_skipmap_get(XTS_SkipMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return NULL;
+    }
+
+    {
+        XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+        XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+        void *value = NULL;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return NULL;
+        }
+
+        if (xts_skipmap_find_impl(map, key, NULL, preds, succs)) {
+            value = __atomic_load_n(&succs[0]->value, __ATOMIC_ACQUIRE);
+        }
+
+        xts_skipmap_exit(record);
+        return value;
+    }
+}
+
+bool xts_skipmap_find(XTS_SkipMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    {
+        XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+        XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+        bool found = false;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return false;
+        }
+
+        found = xts_skipmap_find_impl(map, key, NULL, preds, succs);
+
+        xts_skipmap_exit(record);
+        return found;
+    }
+}
+
+bool xts_skipmap_remove(XTS_SkipMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return false;
+    }
+
+    {
+        XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+        XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+        XTS_SkipMap_Node_PT node = NULL;
+        bool ret = false;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return false;
+        }
+
+        if (xts_skipmap_find_impl(map, key, NULL, preds, succs)) {
+            node = succs[0];
+
+            /* mark the upper levels first, then the inserter stops linking it */
+            for (int level = node->level - 1; 1 <= level; --level) {
+                uintptr_t next = xts_skipmap_load(&node->next[level]);
+                while (!xts_skipmap_marked(next) && !xts_skipmap_cas(&node->next[level], next, next | 1)) {
+                    next = xts_skipmap_load(&node->next[level]);
+                }
+            }
+
+            /* the node is removed by the thread who marks level 0 */
+            while (true) {
+                uintptr_t next = xts_skipmap_load(&node->next[0]);
+                if (xts_skipmap_marked(next)) {
+                    break;
+                }
+
+                if (xts_skipmap_cas(&node->next[0], next, next | 1)) {
+                    ret = true;
+                    break;
+                }
+            }
+
+            if (ret) {
+                __atomic_sub_fetch(&map->size, 1, __ATOMIC_RELAXED);
+
+                xts_skipmap_unlink(map, node);
+                xts_skipmap_node_release(map, record, node);
+            }
+        }
+
+        xts_skipmap_exit(record);
+        return ret;
+    }
+}
+
+/* the first node not removed, NULL if none */
+static
+XTS_SkipMap_Node_PT xts_skipmap_first_from(XTS_SkipMap_Node_PT node) {
+    while (node && xts_skipmap_marked(xts_skipmap_load(&node->next[0]))) {
+        node = xts_skipmap_ptr(xts_skipmap_load(&node->next[0]));
+    }
+
+    return node;
+}
+
+void* xts_skipmap_min(XTS_SkipMap_PT map) {
+    xassert(map);
+
+    if (!map) {
+        return NULL;
+    }
+
+    {
+        XTS_SkipMap_Node_PT node = NULL;
+        void *key = NULL;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return NULL;
+        }
+
+        node = xts_skipmap_first_from(xts_skipmap_ptr(xts_skipmap_load(&map->head->next[0])));
+        key = node ? node->key : NULL;
+
+        xts_skipmap_exit(record);
+        return key;
+    }
+}
+
+void* xts_skipmap_max(XTS_SkipMap_PT map) {
+    xassert(map);
+
+    if (!map) {
+        return NULL;
+    }
+
+    {
+        XTS_SkipMap_Node_PT pred = map->head;
+        void *key = NULL;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return NULL;
+        }
+
+        /* go right on each level, the removed nodes are passed but never kept as the result */
+        for (int level = XTS_SKIPMAP_MAX_LEVEL - 1; 0 <= level; --level) {
+            XTS_SkipMap_Node_PT curr = xts_skipmap_ptr(xts_skipmap_load(&pred->next[level]));
+
+            while (curr) {
+                if (!xts_skipmap_marked(xts_skipmap_load(&curr->next[0]))) {
+                    pred = curr;
+                }
+                curr = xts_skipmap_ptr(xts_skipmap_load(&curr->next[level]));
+            }
+        }
+
+        key = (pred != map->head) ? pred->key : NULL;
+
+        xts_skipmap_exit(record);
+        return key;
+    }
+}
+
+void* xts_skipmap_floor(XTS_SkipMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return NULL;
+    }
+
+    {
+        XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+        XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+        void *result = NULL;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return NULL;
+        }
+
+        if (xts_skipmap_find_impl(map, key, NULL, preds, succs)) {
+            result = succs[0]->key;
+        }
+        else if (preds[0] != map->head) {
+            result = preds[0]->key;
+        }
+
+        xts_skipmap_exit(record);
+        return result;
+    }
+}
+
+void* xts_skipmap_ceiling(XTS_SkipMap_PT map, void *key) {
+    xassert(map);
+    xassert(key);
+
+    if (!map || !key) {
+        return NULL;
+    }
+
+    {
+        XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+        XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+        void *result = NULL;
+
+        XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+        if (!record) {
+            return NULL;
+        }
+
+        xts_skipmap_find_impl(map, key, NULL, preds, succs);
+        result = succs[0] ? succs[0]->key : NULL;
+
+        xts_skipmap_exit(record);
+        return result;
+    }
+}
+
+static
+int xts_skipmap_map_range_impl(XTS_SkipMap_PT map, void *low, void *high, bool (*apply)(void *key, void *value, void *cl), void *cl) {
+    XTS_SkipMap_Node_PT preds[XTS_SKIPMAP_MAX_LEVEL];
+    XTS_SkipMap_Node_PT succs[XTS_SKIPMAP_MAX_LEVEL];
+    XTS_SkipMap_Node_PT node = NULL;
+    int count = 0;
+
+    XTS_SkipMap_Record_PT record = xts_skipmap_enter(map);
+    if (!record) {
+        return 0;
+    }
+
+    if (low) {
+        xts_skipmap_find_impl(map, low, NULL, preds, succs);
+        node = succs[0];
+    }
+    else {
+        node = xts_skipmap_ptr(xts_skipmap_load(&map->head->next[0]));
+    }
+
+    while (node) {
+        uintptr_t next = xts_skipmap_load(&node->next[0]);
+
+        if (!xts_skipmap_marked(next)) {
+            if (high && (0 < map->cmp(node->key, high, map->cl))) {
+                break;
+            }
+
+            if (apply(node->key, __atomic_load_n(&node->value, __ATOMIC_ACQUIRE), cl)) {
+                ++count;
+            }
+        }
+
+        node = xts_skipmap_ptr(next);
+    }
+
+    xts_skipmap_exit(record);
+    return count;
+}
+
+int xts_skipmap_map_range(XTS_SkipMap_PT map, void *low, void *high, bool (*apply)(void *key, void *value, void *cl), void *cl) {
+    xassert(map);
+    xassert(low);
+    xassert(high);
+    xassert(apply);
+
+    if (!map || !low || !high || !apply) {
+        return 0;
+    }
+
+    if (map->cmp(high, low, map->cl) < 0) {
+        void *tmp = low;
+        low = high;
+        high = tmp;
+    }
+
+    return xts_skipmap_map_range_impl(map, low, high, apply, cl);
+}
+
+int xts_skipmap_map_min_to_max(XTS_SkipMap_PT map, bool (*apply)(void *key, void *value, void *cl), void *cl) {
+    xassert(map);
+    xassert(apply);
+
+    if (!map || !apply) {
+        return 0;
+    }
+
+    return xts_skipmap_map_range_impl(map, NULL, NULL, apply, cl);
+}
+
+void xts_skipmap_free(XTS_SkipMap_PT *pmap) {
+    if (!pmap || !*pmap) {
+        return;
+    }
+
+    /* no destructor is called for the map any more */
+    pthread_key_delete((*pmap)->record_key);
+
+    /* all removed nodes are unlinked and retired already */
+    {
+        XTS_SkipMap_Node_PT node = xts_skipmap_ptr((*pmap)->head->next[0]);
+        while (node) {
+            XTS_SkipMap_Node_PT next = xts_skipmap_ptr(node->next[0]);
+            XMEM_FREE(node);
+            node = next;
+        }
+    }
+
+    while ((*pmap)->records) {
+        XTS_SkipMap_Record_PT record = (*pmap)->records;
+        (*pmap)->records = record->next;
+
+        while (record->retired) {
+            XTS_SkipMap_Node_PT node = record->retired;
+            record->retired = node->retire_next;
+            XMEM_FREE(node);
+        }
+
+        XMEM_FREE(record);
+    }
+
+    XMEM_FREE((*pmap)->head);
+    XMEM_FREE(*pmap);
+}
+
+int xts_skipmap_size(XTS_SkipMap_PT map) {
+    return map ? __atomic_load_n(&map->size, __ATOMIC_RELAXED) : 0;
+}
+
+bool xts_skipmap_is_empty(XTS_SkipMap_PT map) {
+    return xts_skipmap_size(map) == 0;
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XTS_SKIPMAPX_INCLUDED
+#define XTS_SKIPMAPX_INCLUDED
+
+#if defined(__linux__)
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "../include/xskiplist_map_thread.h"
+
+#define XTS_SKIPMAP_MAX_LEVEL  32
+
+typedef struct XTS_SkipMap_Node*    XTS_SkipMap_Node_PT;
+typedef struct XTS_SkipMap_Record*  XTS_SkipMap_Record_PT;
+
+struct XTS_SkipMap_Node {
+    void                 *key;
+    void                 *value;
+
+    int                   level;          /* number of next pointers */
+    int                   refs;           /* the inserter and the remover, the last one retires the node */
+
+    XTS_SkipMap_Node_PT   retire_next;    /* link in the retired list of one record */
+    unsigned long         retire_epoch;
+
+    uintptr_t            *next;           /* next[level], the lowest bit is set when the node is removed at that level */
+};
+
+/* one record for each thread using the map */
+struct XTS_SkipMap_Record {
+    XTS_SkipMap_Record_PT next;
+
+    bool                  in_use;         /* owned by a living thread */
+    bool                  active;         /* the thread is in an operation */
+    int                   nest;           /* apply may call the map again */
+    unsigned long         epoch;          /* the global epoch seen when the operation started */
+
+    unsigned int          seed;           /* to get the level of the new node */
+
+    XTS_SkipMap_Node_PT   retired;        /* removed nodes which may still be seen by other threads */
+    int                   retired_size;
+};
+
+struct XTS_SkipMap {
+    XTS_SkipMap_Node_PT   head;           /* XTS_SKIPMAP_MAX_LEVEL levels, no key */
+
+    XTS_SkipMap_Record_PT records;        /* never removed before the map is freed */
+    pthread_key_t         record_key;
+    unsigned long         epoch;
+
+    int                   size;
+
+    int                 (*cmp)(void *key1, void *key2, void *cl);
+    void                 *cl;
+};
+
+#endif
+#endif
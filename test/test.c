@@ -5,6 +5,11 @@
 extern void test_xexcept();
 extern void test_xassert();
 
+extern void test_xmem();
+
+extern void test_xarena();
+extern void test_xslab();
+
 extern void test_xbit();
 extern void test_xpair();
 
@@ -55,6 +60,7 @@ extern void test_xkeyindexmaxpq();
 
 extern void test_xkvhashtab();
 extern void test_xrbtreehash();
+extern void test_xflathash();
 
 extern void test_xbintree();
 extern void test_xbstree();
@@ -62,6 +68,8 @@ extern void test_t234bstree();
 extern void test_xrbtree();
 extern void test_xlistrbtree();
 extern void test_xavltree();
+extern void test_xartree();
+extern void test_xbptree();
 extern void test_xmtree();
 
 extern void test_xset();
@@ -75,6 +83,9 @@ extern void test_xwdigraph();
 #if defined(__linux__)
 extern void test_xlist_s_thread();
 extern void test_xlist_d_thread();
+extern void test_xts_hashmap();
+extern void test_xprbtree();
+extern void test_xts_skipmap();
 
 extern void test_xthread_sem();
 
@@ -92,6 +103,11 @@ int main(void){
 
     test_xassert();
 
+    test_xmem();
+
+    test_xarena();
+    test_xslab();
+
     test_xbit();
     test_xpair();
 
@@ -147,6 +163,8 @@ int main(void){
     test_xrbtree();
     test_xlistrbtree();
     test_xavltree();
+    test_xartree();
+    test_xbptree();
     test_xmtree();
 
     test_xset();
@@ -154,6 +172,7 @@ int main(void){
 
     test_xkvhashtab();
     test_xrbtreehash();
+    test_xflathash();
 
     test_xgraph();
     test_xdigraph();
@@ -163,6 +182,9 @@ int main(void){
 #if defined(__linux__)
     // test_xlist_s_thread();
     // test_xlist_d_thread();
+    test_xts_hashmap();
+    test_xprbtree();
+    test_xts_skipmap();
 
     // test_xthread_sem();
 
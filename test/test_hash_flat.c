@@ -0,0 +1,373 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "../utils/xutils.h"
+#include "../hash_flat/xhash_flat_x.h"
+#include "../include/xalgos.h"
+
+static
+int test_hash_string(void *str)
+{
+    char *nstr = (char*)str;
+    int h = 0;
+    for (; *nstr; ++nstr)
+        h = 5 * h + *nstr;
+
+    return h;
+}
+
+/* all keys fall into the same group to test the probing */
+static
+int test_hash_const(void *str)
+{
+    return 7;
+}
+
+static
+int xflathash_equal(void *x, void *y, void *cl) {
+    return strcmp((char*)x, (char*)y);
+}
+
+static 
+bool xflathash_copy_check(void *key, void **value, void *cl)
+{
+    XFlatHash_PT ntable = (XFlatHash_PT)cl;
+    xassert(xflathash_find(ntable, key));
+    return true;
+}
+
+static
+bool xflathash_map_apply_true(void *key, void **value, void *cl)
+{
+    return true;
+}
+
+static
+bool xflathash_map_aab_false(void *key, void **value, void *cl)
+{
+    if (!strcmp((char*)key, "aab")) {
+        return false;
+    }
+
+    return true;
+}
+
+static
+XFlatHash_PT xflathash_random_string(int hint, int(*hash)(void *key), int total_size, int string_length) {
+    XFlatHash_PT table = xflathash_new(hint, hash, xflathash_equal, NULL);
+    if (!table) {
+        return NULL;
+    }
+
+    {
+        const char charsets[] = "0123456789";
+
+        for (int i = 0; i < total_size; i++) {
+            char* key = XMEM_MALLOC(string_length + 1);
+            char* value = XMEM_MALLOC(string_length + 1);
+
+            for (int j = 0; j < string_length; ++j) {
+                key[j] = charsets[rand() % (sizeof(charsets) - 1)];
+                value[j] = charsets[rand() % (sizeof(charsets) - 1)];
+            }
+            key[string_length] = '\0';
+            value[string_length] = '\0';
+
+            if (!xflathash_put_repeat(table, key, value)) {
+                xflathash_deep_free(&table);
+                return NULL;
+            }
+        }
+    }
+
+    return table;
+}
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xflathash() {
+
+    /* xflathash_new */
+    {
+        XFlatHash_PT table = NULL;
+
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                table = xflathash_new(-1, test_hash_string, xflathash_equal, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                table = xflathash_new(10, NULL, xflathash_equal, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        {
+            table = xflathash_new(0, test_hash_string, xflathash_equal, NULL);
+            xassert(table);
+            xassert(table->capacity == XFLATHASH_GROUP_WIDTH);
+            xflathash_free(&table);
+        }
+
+        {
+            table = xflathash_new(1000, test_hash_string, xflathash_equal, NULL);
+            xassert(table);
+            xassert(table->capacity == 2048);
+            xassert(1000 <= table->growth_left);
+            xflathash_free(&table);
+        }
+    }
+
+    /* xflathash_copy */
+    /* xflathash_deep_copy */
+    {
+        XFlatHash_PT table = xflathash_random_string(10, test_hash_string, 300, 8);
+
+        {
+            XFlatHash_PT ntable = xflathash_copy(table);
+            xassert(ntable->size == table->size);
+            xassert(ntable->capacity == table->capacity);
+            xflathash_map(table, xflathash_copy_check, ntable);
+            xflathash_free(&ntable);
+        }
+
+        {
+            XFlatHash_PT ntable = xflathash_deep_copy(table, 9, 9);
+            xassert(ntable->size == table->size);
+            xflathash_map(table, xflathash_copy_check, ntable);
+            xflathash_deep_free(&ntable);
+        }
+
+        {
+            XFlatHash_PT ntable = xflathash_deep_copy(table, 9, 0);
+            xassert(ntable->size == table->size);
+            xflathash_map(table, xflathash_copy_check, ntable);
+            xflathash_deep_free(&ntable);
+        }
+
+        xflathash_deep_free(&table);
+    }
+
+    /* xflathash_put_repeat */
+    {
+        XFlatHash_PT table = xflathash_new(100, test_hash_string, xflathash_equal, NULL);
+
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xflathash_put_repeat(table, NULL, "def");
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        xassert(xflathash_put_repeat(table, "aaa", "abc"));
+        xassert(xflathash_put_repeat(table, "aab", "abd"));
+        xassert(xflathash_put_repeat(table, "aac", "abe"));
+        xassert(xflathash_put_repeat(table, "aaa", "def"));
+        xassert(xflathash_put_repeat(table, "aab", "deg"));
+        xassert(xflathash_put_repeat(table, "aac", "deh"));
+
+        xassert(xflathash_size(table) == 6);
+        xassert(xflathash_key_size(table, "aab") == 2);
+
+        {
+            XSList_PT list = xflathash_get_all(table, "aaa");
+            xassert(xslist_size(list) == 2);
+            xslist_free(&list);
+        }
+
+        xflathash_remove(table, "aab");
+        xassert(xflathash_key_size(table, "aab") == 1);
+        xassert(xflathash_size(table) == 5);
+
+        xassert(xflathash_remove_all(table, "aac") == 2);
+        xassert_false(xflathash_find(table, "aac"));
+        xassert(xflathash_size(table) == 3);
+
+        xflathash_free(&table);
+    }
+
+    /* xflathash_put_unique */
+    /* xflathash_put_replace */
+    {
+        XFlatHash_PT table = xflathash_new(100, test_hash_string, xflathash_equal, NULL);
+
+        xassert(xflathash_put_unique(table, "aaa", NULL));
+        xassert(xflathash_put_unique(table, "aab", NULL));
+        xassert(xflathash_put_unique(table, "aaa", "def"));
+        xassert(xflathash_size(table) == 2);
+        xassert_false(xflathash_get(table, "aaa"));
+
+        xassert(xflathash_put_replace(table, "aaa", "def"));
+        xassert(xflathash_put_replace(table, "aac", "deh"));
+        xassert(xflathash_size(table) == 3);
+        xassert(!strcmp((char*)xflathash_get(table, "aaa"), "def"));
+        xassert(!strcmp((char*)xflathash_get(table, "aac"), "deh"));
+
+        xflathash_free(&table);
+    }
+
+    /* probing across groups, tombstones and growth */
+    {
+        XFlatHash_PT table = xflathash_new(0, test_hash_const, xflathash_equal, NULL);
+        char keys[200][8];
+
+        for (int i = 0; i < 200; ++i) {
+            sprintf(keys[i], "k%d", i);
+            xassert(xflathash_put_unique(table, keys[i], keys[i]));
+        }
+        xassert(xflathash_size(table) == 200);
+        xassert(200 < table->capacity);
+
+        for (int i = 0; i < 200; i += 2) {
+            xassert(xflathash_remove(table, keys[i]));
+        }
+        xassert(xflathash_size(table) == 100);
+
+        for (int i = 0; i < 200; ++i) {
+            xassert((i % 2) ? (xflathash_get(table, keys[i]) == keys[i]) : !xflathash_find(table, keys[i]));
+        }
+
+        /* reuse the deleted slots many times, table never overflows */
+        for (int k = 0; k < 10; ++k) {
+            for (int i = 0; i < 200; i += 2) {
+                xassert(xflathash_put_unique(table, keys[i], keys[i]));
+            }
+            for (int i = 0; i < 200; i += 2) {
+                xassert(xflathash_remove(table, keys[i]));
+            }
+        }
+        xassert(xflathash_size(table) == 100);
+        xassert(xflathash_map(table, xflathash_map_apply_true, NULL) == 100);
+
+        xassert(xflathash_resize(table, 1000));
+        xassert(xflathash_size(table) == 100);
+        for (int i = 1; i < 200; i += 2) {
+            xassert(xflathash_get(table, keys[i]) == keys[i]);
+        }
+
+        xflathash_clear(table);
+        xassert(xflathash_is_empty(table));
+        xassert_false(xflathash_find(table, keys[1]));
+
+        xflathash_free(&table);
+    }
+
+    /* xflathash_deep_remove */
+    /* xflathash_deep_remove_all */
+    /* xflathash_deep_clear */
+    {
+        XFlatHash_PT table = xflathash_random_string(100, test_hash_string, 500, 2);
+
+        xflathash_deep_remove(table, "00");
+        xflathash_deep_remove_all(table, "11");
+        xassert(xflathash_key_size(table, "11") == 0);
+
+        xflathash_deep_clear(table);
+        xassert(xflathash_size(table) == 0);
+
+        xflathash_free(&table);
+    }
+
+    /* xflathash_map_break_if_true */
+    /* xflathash_map_break_if_false */
+    {
+        XFlatHash_PT table = xflathash_new(100, test_hash_string, xflathash_equal, NULL);
+
+        xassert(xflathash_put_repeat(table, "aaa", NULL));
+        xassert(xflathash_put_repeat(table, "aab", NULL));
+        xassert(xflathash_put_repeat(table, "aac", NULL));
+
+        xassert_false(xflathash_map_break_if_false(table, xflathash_map_apply_true, NULL));
+        xassert(xflathash_map_break_if_false(table, xflathash_map_aab_false, NULL));
+        xassert(xflathash_map_break_if_true(table, xflathash_map_apply_true, NULL));
+
+        xflathash_free(&table);
+    }
+
+    /* xflathash_swap */
+    {
+        XFlatHash_PT table1 = xflathash_new(100, test_hash_string, xflathash_equal, NULL);
+        XFlatHash_PT table2 = xflathash_new(10, test_hash_string, xflathash_equal, NULL);
+
+        xassert(xflathash_put_repeat(table1, "aaa", NULL));
+        xassert(xflathash_swap(table1, table2));
+        xassert(xflathash_size(table1) == 0);
+        xassert(xflathash_find(table2, "aaa"));
+
+        xflathash_free(&table1);
+        xflathash_free(&table2);
+    }
+
+    /* xflathash_get_many */
+    /* xflathash_find_many */
+    /* xflathash_put_unique_many */
+    /* xflathash_put_replace_many */
+    {
+        char keys[100][8];
+        void *pkeys[100];
+        void *values[100];
+        bool founds[100];
+
+        for (int i = 0; i < 100; ++i) {
+            sprintf(keys[i], "%d", i);
+            pkeys[i] = keys[i];
+        }
+
+        /* a small table, it grows several times in the batches */
+        XFlatHash_PT table = xflathash_new(1, test_hash_string, xflathash_equal, NULL);
+
+        xassert(xflathash_put_unique_many(table, pkeys, NULL, 50) == 50);
+        xassert(xflathash_put_unique_many(table, pkeys, NULL, 50) == 50);
+        xassert(xflathash_size(table) == 50);
+
+        xassert(xflathash_find_many(table, pkeys, 100, founds) == 50);
+        xassert(xflathash_find_many(table, pkeys, 100, NULL) == 50);
+        for (int i = 0; i < 100; ++i) {
+            xassert(founds[i] == (i < 50));
+        }
+
+        xassert(xflathash_put_replace_many(table, pkeys, pkeys, 100) == 100);
+        xassert(xflathash_size(table) == 100);
+
+        xassert(xflathash_get_many(table, pkeys, 100, values) == 100);
+        for (int i = 0; i < 100; ++i) {
+            xassert(values[i] == keys[i]);
+        }
+
+        xassert(xflathash_remove(table, keys[3]));
+        xassert(xflathash_get_many(table, pkeys, 100, values) == 99);
+        xassert_false(values[3]);
+
+        xflathash_free(&table);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
@@ -180,14 +180,32 @@ void test_xkvhashtab() {
         {
             table = xkvhashtab_new(0, test_hash_string, xkvhashtab_equal, NULL);
             xassert(table);
-            xassert(table->slot == 53);
+            xassert(table->slot == xutils_hash_buckets_num(0));
             xkvhashtab_free(&table);
         }
 
         {
             table = xkvhashtab_new(6151, test_hash_string, xkvhashtab_equal, NULL);
             xassert(table);
-            xassert(table->slot == 6151);
+            xassert(table->slot == xutils_hash_buckets_num(6151));
+            xkvhashtab_free(&table);
+        }
+
+        /* buckets are created by the first put and given back by clear */
+        {
+            table = xkvhashtab_new(100, test_hash_string, xkvhashtab_equal, NULL);
+            for (int i = 0; i < table->slot; i++) {
+                xassert_false(xparray_get(table->buckets, i));
+            }
+
+            xkvhashtab_put_repeat(table, "abc", NULL);
+            xassert(xparray_get(table->buckets, xutils_hash_bucket_index(test_hash_string("abc"), table->slot)));
+            xassert(xkvhashtab_find(table, "abc"));
+            xassert_false(xkvhashtab_find(table, "abd"));
+
+            xkvhashtab_clear(table);
+            xassert_false(xparray_get(table->buckets, xutils_hash_bucket_index(test_hash_string("abc"), table->slot)));
+            xassert_false(xkvhashtab_find(table, "abc"));
             xkvhashtab_free(&table);
         }
 
@@ -196,14 +214,14 @@ void test_xkvhashtab() {
         {
             table = xkvhashtab_new(1000000, test_hash_string, xkvhashtab_equal, NULL);
             xassert(table);
-            xassert(table->slot == 1572869);
+            xassert(table->slot == xutils_hash_buckets_num(1000000));
             xkvhashtab_free(&table);
         }
 
         {
             table = xkvhashtab_new(1000000000, test_hash_string, xkvhashtab_equal, NULL);
             xassert(table);
-            xassert(table->slot == 100663319);
+            xassert(table->slot == xutils_max_hash_buckets_size());
             xkvhashtab_free(&table);
         }
 #endif
@@ -881,11 +899,56 @@ void test_xkvhashtab() {
     {
         XKVHashtab_PT table1 = xkvhashtab_new(100, test_hash_string, xkvhashtab_equal, NULL);
 
-        xassert(xkvhashtab_max_bucket_size(table1) == 100663319);
+        xassert(xkvhashtab_max_bucket_size(table1) == xutils_max_hash_buckets_size());
 
         xkvhashtab_free(&table1);
     }
         
+    /* xutils_hash_buckets_num */
+    /* xutils_hash_bucket_index */
+    {
+        int hashs[] = { 0, 1, -1, 64, -64, 12345, -12345, 0x7fffffff, (int)0x80000000 };
+        int max = xutils_max_hash_buckets_size();
+
+        for (int hint = 0; hint < 3000000; hint = hint * 2 + 1) {
+            int buckets = xutils_hash_buckets_num(hint);
+            xassert(hint <= buckets);
+
+            for (int i = 0; i < (int)(sizeof(hashs) / sizeof(hashs[0])); ++i) {
+                int index = xutils_hash_bucket_index(hashs[i], buckets);
+                xassert((0 <= index) && (index < buckets));
+#ifdef XHASH_BUCKETS_POWER_OF_2
+                xassert(index == (int)(xutils_hash_mix32((unsigned int)hashs[i]) & (unsigned int)(buckets - 1)));
+#else
+                xassert(index == (int)((unsigned int)hashs[i] % (unsigned int)buckets));
+#endif
+            }
+        }
+
+        xassert(xutils_hash_buckets_num(max) == max);
+        xassert(xutils_hash_buckets_num(max + 1) == max);
+
+#ifdef XHASH_BUCKETS_POWER_OF_2
+        /* power of 2, and the hashes differing only in the high bits still spread over the buckets */
+        {
+            bool used[64] = { false };
+            int count = 0;
+
+            xassert((max & (max - 1)) == 0);
+            xassert(xutils_hash_buckets_num(0) == 64);
+
+            for (int i = 0; i < 64; ++i) {
+                int index = xutils_hash_bucket_index(i << 24, 64);
+                if (!used[index]) {
+                    used[index] = true;
+                    ++count;
+                }
+            }
+            xassert(32 < count);
+        }
+#endif
+    }
+
     /* xkvhashtab_elems_in_bucket */
     {
         XKVHashtab_PT table1 = xkvhashtab_new(100, test_hash_string, xkvhashtab_equal, NULL);
@@ -1043,6 +1106,81 @@ void test_xkvhashtab() {
         xkvhashtab_free(&table1);
     }
 
+    /* xkvhashtab_resize */
+    /* xkvhashtab_resize_incremental */
+    /* xkvhashtab_set_max_loading_factor */
+    {
+        char keys[1000][8];
+        for (int i = 0; i < 1000; ++i) {
+            sprintf(keys[i], "%d", i);
+        }
+
+        {
+            XKVHashtab_PT table = xkvhashtab_new(0, test_hash_string, xkvhashtab_equal, NULL);
+            for (int i = 0; i < 1000; ++i) {
+                xkvhashtab_put_repeat(table, keys[i], keys[i]);
+            }
+            xkvhashtab_put_repeat(table, keys[7], keys[7]);
+
+            xassert(xkvhashtab_resize_incremental(table, 1000));
+            xassert(xkvhashtab_is_rehashing(table));
+            xassert(xkvhashtab_bucket_size(table) == xutils_hash_buckets_num(1000));
+            xassert(xkvhashtab_size(table) == 1001);
+            xassert(xkvhashtab_map(table, xkvhashtab_map_apply_true, NULL) == 1001);
+
+            /* copy finishes the resize of table first */
+            {
+                XKVHashtab_PT ntable = xkvhashtab_copy(table);
+                xassert_false(xkvhashtab_is_rehashing(table));
+                xassert(xkvhashtab_size(ntable) == 1001);
+                xkvhashtab_free(&ntable);
+            }
+
+            xassert(xkvhashtab_resize_incremental(table, 100));
+            for (int i = 0; i < 1000; ++i) {
+                xassert(xkvhashtab_find(table, keys[i]));
+            }
+            xassert(xkvhashtab_key_size(table, keys[7]) == 2);
+            xassert_false(xkvhashtab_is_rehashing(table));
+
+            xassert(xkvhashtab_resize(table, 3000));
+            xassert_false(xkvhashtab_is_rehashing(table));
+            xassert(xkvhashtab_bucket_size(table) == xutils_hash_buckets_num(3000));
+            xassert(xkvhashtab_size(table) == 1001);
+            xassert(xkvhashtab_remove_all(table, keys[7]) == 2);
+            xassert(xkvhashtab_size(table) == 999);
+
+            /* clear and free in the middle of resize */
+            xassert(xkvhashtab_resize_incremental(table, 100));
+            xkvhashtab_put_repeat(table, keys[7], keys[7]);
+            xkvhashtab_clear(table);
+            xassert_false(xkvhashtab_is_rehashing(table));
+            xassert(xkvhashtab_size(table) == 0);
+
+            xkvhashtab_put_repeat(table, keys[7], keys[7]);
+            xassert(xkvhashtab_resize_incremental(table, 1000));
+            xkvhashtab_free(&table);
+        }
+
+        {
+            XKVHashtab_PT table = xkvhashtab_new(0, test_hash_string, xkvhashtab_equal, NULL);
+            xkvhashtab_set_max_loading_factor(table, 2);
+
+            for (int i = 0; i < 1000; ++i) {
+                xkvhashtab_put_unique(table, keys[i], keys[i]);
+            }
+
+            xassert(xkvhashtab_size(table) == 1000);
+            xassert(xutils_hash_buckets_num(0) < xkvhashtab_bucket_size(table));
+            for (int i = 0; i < 1000; ++i) {
+                xassert(xkvhashtab_find(table, keys[i]));
+            }
+            xassert(xkvhashtab_map(table, xkvhashtab_map_apply_true, NULL) == 1000);
+
+            xkvhashtab_free(&table);
+        }
+    }
+
     {
         int count = 0;
         xmem_leak(check_mem_leak, &count);
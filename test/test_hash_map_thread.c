@@ -0,0 +1,251 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*    without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*    See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#if defined(__linux__)
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "../utils/xutils.h"
+#include "../hash_map_thread/xhash_map_thread_x.h"
+#include "../include/xalgos.h"
+
+#define NUM_THREADS 8
+#define NUM_KEYS 1000
+
+static char keys[NUM_KEYS][8];
+
+static
+int test_hash_string(void *str) {
+    return xutils_hash_string((char*)str);
+}
+
+static
+int test_cmp_string(void *x, void *y, void *cl) {
+    return strcmp((char*)x, (char*)y);
+}
+
+static
+void* increase_remap(void *key, void *value, bool found, void *cl) {
+    return (void*)((intptr_t)value + 1);
+}
+
+static
+void* remove_remap(void *key, void *value, bool found, void *cl) {
+    return NULL;
+}
+
+static
+void* put_if_absent_thread(void* arg) {
+    XTS_HashMap_PT map = (XTS_HashMap_PT)arg;
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        xts_hashmap_put_if_absent(map, keys[i], (void*)(intptr_t)(i + 1));
+    }
+    return NULL;
+}
+
+static
+void* compute_thread(void* arg) {
+    XTS_HashMap_PT map = (XTS_HashMap_PT)arg;
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        xassert(xts_hashmap_compute(map, keys[i], increase_remap, NULL));
+        xassert(xts_hashmap_get(map, keys[i]));
+    }
+    return NULL;
+}
+
+static
+void* remove_thread(void* arg) {
+    XTS_HashMap_PT map = (XTS_HashMap_PT)arg;
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        xts_hashmap_remove(map, keys[i]);
+    }
+    return NULL;
+}
+
+static
+void* get_thread(void* arg) {
+    XTS_HashMap_PT map = (XTS_HashMap_PT)arg;
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        xassert(xts_hashmap_get(map, keys[i]) == (void*)(intptr_t)(i + 1));
+        xassert(xts_hashmap_find(map, keys[i]));
+    }
+    return NULL;
+}
+
+static
+bool check_value_apply(void *key, void **value, void *cl) {
+    return (intptr_t)(*value) == *(intptr_t*)cl;
+}
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xts_hashmap() {
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        sprintf(keys[i], "%d", i);
+    }
+
+    /* xts_hashmap_new */
+    {
+        XTS_HashMap_PT map = xts_hashmap_new(5, 100, test_hash_string, test_cmp_string, NULL);
+        xassert(map);
+        xassert(xts_hashmap_segments(map) == 8);
+        xassert(xts_hashmap_is_empty(map));
+        xts_hashmap_free(&map);
+        xassert_false(map);
+    }
+
+    /* xts_hashmap_put_if_absent */
+    /* xts_hashmap_put_replace */
+    /* xts_hashmap_remove */
+    {
+        XTS_HashMap_PT map = xts_hashmap_new(4, 0, test_hash_string, test_cmp_string, NULL);
+
+        xassert(xts_hashmap_put_if_absent(map, "abc", (void*)1));
+        xassert_false(xts_hashmap_put_if_absent(map, "abc", (void*)2));
+        xassert(xts_hashmap_get(map, "abc") == (void*)1);
+
+        xassert(xts_hashmap_put_replace(map, "abc", (void*)3));
+        xassert(xts_hashmap_get(map, "abc") == (void*)3);
+        xassert(xts_hashmap_size(map) == 1);
+
+        xassert(xts_hashmap_compute(map, "abc", remove_remap, NULL));
+        xassert_false(xts_hashmap_find(map, "abc"));
+        xassert(xts_hashmap_compute(map, "abd", increase_remap, NULL));
+        xassert(xts_hashmap_get(map, "abd") == (void*)1);
+
+        xassert(xts_hashmap_remove(map, "abd"));
+        xassert_false(xts_hashmap_remove(map, "abd"));
+        xassert(xts_hashmap_is_empty(map));
+
+        xts_hashmap_free(&map);
+    }
+
+    /* all threads work on the same keys */
+    {
+        XTS_HashMap_PT map = xts_hashmap_new(16, 0, test_hash_string, test_cmp_string, NULL);
+        pthread_t threads[NUM_THREADS];
+
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_create(&threads[i], NULL, put_if_absent_thread, (void*)map);
+        }
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        xassert(xts_hashmap_size(map) == NUM_KEYS);
+
+        for (int i = 0; i < NUM_KEYS; ++i) {
+            xassert(xts_hashmap_put_replace(map, keys[i], (void*)0));
+        }
+
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_create(&threads[i], NULL, compute_thread, (void*)map);
+        }
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        {
+            /* no increment is lost */
+            intptr_t expected = NUM_THREADS;
+            xassert(xts_hashmap_map(map, check_value_apply, &expected) == NUM_KEYS);
+        }
+
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_create(&threads[i], NULL, (i % 2) ? remove_thread : put_if_absent_thread, (void*)map);
+        }
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        xts_hashmap_clear(map);
+        xassert(xts_hashmap_is_empty(map));
+
+        xts_hashmap_free(&map);
+    }
+
+    /* the readers finish the rehash left by a failed resize under the write lock */
+    {
+        XTS_HashMap_PT map = xts_hashmap_new(4, 0, test_hash_string, test_cmp_string, NULL);
+        pthread_t threads[NUM_THREADS];
+
+        for (int i = 0; i < NUM_KEYS; ++i) {
+            xassert(xts_hashmap_put_replace(map, keys[i], (void*)(intptr_t)(i + 1)));
+        }
+
+        for (int i = 0; i < map->segment_num; ++i) {
+            XRBTreeHash_PT table = map->segments[i].table;
+            xassert(xrbtreehash_resize_incremental(table, 4 * xrbtreehash_bucket_size(table)));
+            xassert(xrbtreehash_is_rehashing(table));
+        }
+
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_create(&threads[i], NULL, get_thread, (void*)map);
+        }
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        for (int i = 0; i < map->segment_num; ++i) {
+            xassert_false(xrbtreehash_is_rehashing(map->segments[i].table));
+        }
+        xassert(xts_hashmap_size(map) == NUM_KEYS);
+
+        xts_hashmap_free(&map);
+    }
+
+#ifdef XHASH_BUCKETS_POWER_OF_2
+    /* the segment bits never overlap the bucket bits : a segment with more than 1 << 16 buckets uses all of them */
+    {
+        static char bkeys[20000][8];
+        XTS_HashMap_PT map = xts_hashmap_new(2, 1 << 19, test_hash_string, test_cmp_string, NULL);
+
+        for (int i = 0; i < 20000; ++i) {
+            sprintf(bkeys[i], "b%d", i);
+            xassert(xts_hashmap_put_replace(map, bkeys[i], NULL));
+        }
+
+        for (int i = 0; i < map->segment_num; ++i) {
+            XRBTreeHash_PT table = map->segments[i].table;
+            int total = 0;
+            int high = 0;   /* the elems in the buckets with bit 16 set */
+
+            xassert((1 << 16) < xrbtreehash_bucket_size(table));
+            for (int k = 0; k < xrbtreehash_bucket_size(table); ++k) {
+                int size = xrbtreehash_elems_in_bucket(table, k);
+                total += size;
+                high += (k & (1 << 16)) ? size : 0;
+            }
+
+            xassert(total == xrbtreehash_size(table));
+            xassert((total < 4 * high) && (4 * high < 3 * total));
+        }
+
+        xts_hashmap_free(&map);
+    }
+#endif
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
+
+#endif
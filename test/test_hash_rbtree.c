@@ -115,6 +115,21 @@ XRBTreeHash_PT xrbtreehash_random_string(int hint, int(*hash)(void *key), int(*c
     }
 }
 
+static int test_hash_calls = 0;
+static int test_cmp_calls = 0;
+
+static
+int test_hash_string_count(void *str) {
+    ++test_hash_calls;
+    return test_hash_string(str);
+}
+
+static
+int test_cmp_string_count(void *x, void *y, void *cl) {
+    ++test_cmp_calls;
+    return strcmp((char*)x, (char*)y);
+}
+
 static
 void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
     (*(int*)cl) += 1;
@@ -179,14 +194,32 @@ void test_xrbtreehash() {
         {
             table = xrbtreehash_new(0, test_hash_string, xrbtreehash_equal, NULL);
             xassert(table);
-            xassert(table->slot == 53);
+            xassert(table->slot == xutils_hash_buckets_num(0));
             xrbtreehash_free(&table);
         }
 
         {
             table = xrbtreehash_new(6151, test_hash_string, xrbtreehash_equal, NULL);
             xassert(table);
-            xassert(table->slot == 6151);
+            xassert(table->slot == xutils_hash_buckets_num(6151));
+            xrbtreehash_free(&table);
+        }
+
+        /* buckets are created by the first put and given back by clear */
+        {
+            table = xrbtreehash_new(100, test_hash_string, xrbtreehash_equal, NULL);
+            for (int i = 0; i < table->slot; i++) {
+                xassert_false(xparray_get(table->buckets, i));
+            }
+
+            xrbtreehash_put_repeat(table, "abc", NULL);
+            xassert(xparray_get(table->buckets, xutils_hash_bucket_index(test_hash_string("abc"), table->slot)));
+            xassert(xrbtreehash_find(table, "abc"));
+            xassert_false(xrbtreehash_find(table, "abd"));
+
+            xrbtreehash_clear(table);
+            xassert_false(xparray_get(table->buckets, xutils_hash_bucket_index(test_hash_string("abc"), table->slot)));
+            xassert_false(xrbtreehash_find(table, "abc"));
             xrbtreehash_free(&table);
         }
     }
@@ -928,6 +961,203 @@ void test_xrbtreehash() {
         xrbtreehash_free(&table1);
     }
 
+    /* xrbtreehash_resize */
+    /* xrbtreehash_resize_incremental */
+    /* xrbtreehash_set_max_loading_factor */
+    {
+        char keys[1000][8];
+        for (int i = 0; i < 1000; ++i) {
+            sprintf(keys[i], "%d", i);
+        }
+
+        {
+            XRBTreeHash_PT table = xrbtreehash_new(0, test_hash_string, xrbtreehash_equal, NULL);
+            for (int i = 0; i < 1000; ++i) {
+                xrbtreehash_put_repeat(table, keys[i], keys[i]);
+            }
+            xrbtreehash_put_repeat(table, keys[7], keys[7]);
+
+            xassert(xrbtreehash_resize_incremental(table, 1000));
+            xassert(xrbtreehash_is_rehashing(table));
+            xassert(xrbtreehash_bucket_size(table) == xutils_hash_buckets_num(1000));
+            xassert(xrbtreehash_size(table) == 1001);
+            xassert(xrbtreehash_map(table, xrbtreehash_map_apply_true, NULL) == 1001);
+
+            /* copy finishes the resize of table first */
+            {
+                XRBTreeHash_PT ntable = xrbtreehash_copy(table);
+                xassert_false(xrbtreehash_is_rehashing(table));
+                xassert(xrbtreehash_size(ntable) == 1001);
+                xrbtreehash_free(&ntable);
+            }
+
+            xassert(xrbtreehash_resize_incremental(table, 100));
+            for (int i = 0; i < 1000; ++i) {
+                xassert(xrbtreehash_find(table, keys[i]));
+            }
+            xassert(xrbtreehash_key_size(table, keys[7]) == 2);
+            xassert_false(xrbtreehash_is_rehashing(table));
+
+            xassert(xrbtreehash_resize(table, 3000));
+            xassert_false(xrbtreehash_is_rehashing(table));
+            xassert(xrbtreehash_bucket_size(table) == xutils_hash_buckets_num(3000));
+            xassert(xrbtreehash_size(table) == 1001);
+            xassert(xrbtreehash_remove_all(table, keys[7]) == 2);
+            xassert(xrbtreehash_size(table) == 999);
+
+            /* clear and free in the middle of resize */
+            xassert(xrbtreehash_resize_incremental(table, 100));
+            xrbtreehash_put_repeat(table, keys[7], keys[7]);
+            xrbtreehash_clear(table);
+            xassert_false(xrbtreehash_is_rehashing(table));
+            xassert(xrbtreehash_size(table) == 0);
+
+            xrbtreehash_put_repeat(table, keys[7], keys[7]);
+            xassert(xrbtreehash_resize_incremental(table, 1000));
+            xrbtreehash_free(&table);
+        }
+
+        {
+            XRBTreeHash_PT table = xrbtreehash_new(0, test_hash_string, xrbtreehash_equal, NULL);
+            xrbtreehash_set_max_loading_factor(table, 2);
+
+            for (int i = 0; i < 1000; ++i) {
+                xrbtreehash_put_unique(table, keys[i], keys[i]);
+            }
+
+            xassert(xrbtreehash_size(table) == 1000);
+            xassert(xutils_hash_buckets_num(0) < xrbtreehash_bucket_size(table));
+            for (int i = 0; i < 1000; ++i) {
+                xassert(xrbtreehash_find(table, keys[i]));
+            }
+            xassert(xrbtreehash_map(table, xrbtreehash_map_apply_true, NULL) == 1000);
+
+            xrbtreehash_free(&table);
+        }
+    }
+
+    /* the saved hash codes */
+    {
+        char keys[100][8];
+        for (int i = 0; i < 100; ++i) {
+            sprintf(keys[i], "%d", i);
+        }
+
+        {
+            XRBTreeHash_PT table = xrbtreehash_new(1, test_hash_string_count, test_cmp_string_count, NULL);
+
+            test_hash_calls = 0;
+            for (int i = 0; i < 100; ++i) {
+                xassert(xrbtreehash_put_unique(table, keys[i], keys[i]));
+            }
+            xassert(test_hash_calls == 100);
+
+            /* resize and copy use the saved hash codes */
+            xassert(xrbtreehash_resize(table, 1000));
+            xassert(xrbtreehash_resize_incremental(table, 10));
+            {
+                XRBTreeHash_PT ntable = xrbtreehash_copy(table);
+                xassert(xrbtreehash_size(ntable) == 100);
+                xrbtreehash_free(&ntable);
+            }
+            xassert(test_hash_calls == 100);
+
+            /* the least buckets : the keys with different hash codes are skipped without calling cmp */
+            xassert(xrbtreehash_resize(table, 1));
+            for (int i = 0; i < 100; ++i) {
+                xassert(xrbtreehash_get(table, keys[i]) == keys[i]);
+                xassert(xrbtreehash_key_size(table, keys[i]) == 1);
+            }
+
+            test_cmp_calls = 0;
+            xassert_false(xrbtreehash_find(table, "100"));
+            xassert(test_cmp_calls == 0);
+
+            for (int i = 0; i < 100; i += 2) {
+                xassert(xrbtreehash_remove(table, keys[i]));
+            }
+            xassert(xrbtreehash_size(table) == 50);
+            for (int i = 0; i < 100; ++i) {
+                xassert(xrbtreehash_find(table, keys[i]) == (i % 2 == 1));
+            }
+
+            xrbtreehash_free(&table);
+        }
+    }
+
+    /* xrbtreehash_get_many */
+    /* xrbtreehash_find_many */
+    /* xrbtreehash_put_unique_many */
+    /* xrbtreehash_put_replace_many */
+    {
+        char keys[100][8];
+        void *pkeys[100];
+        void *values[100];
+        bool founds[100];
+
+        for (int i = 0; i < 100; ++i) {
+            sprintf(keys[i], "%d", i);
+            pkeys[i] = keys[i];
+        }
+
+        {
+            XRBTreeHash_PT table = xrbtreehash_new(0, test_hash_string, xrbtreehash_equal, NULL);
+
+            /* put the even keys only */
+            for (int i = 0; i < 50; ++i) {
+                values[i] = keys[2 * i];
+                pkeys[i] = keys[2 * i];
+            }
+            xassert(xrbtreehash_put_unique_many(table, pkeys, values, 50) == 50);
+            xassert(xrbtreehash_put_unique_many(table, pkeys, values, 50) == 50);
+            xassert(xrbtreehash_size(table) == 50);
+
+            for (int i = 0; i < 100; ++i) {
+                pkeys[i] = keys[i];
+            }
+
+            xassert(xrbtreehash_get_many(table, pkeys, 100, values) == 50);
+            xassert(xrbtreehash_find_many(table, pkeys, 100, founds) == 50);
+            xassert(xrbtreehash_find_many(table, pkeys, 100, NULL) == 50);
+            for (int i = 0; i < 100; ++i) {
+                xassert((values[i] == ((i % 2 == 0) ? keys[i] : NULL)));
+                xassert(founds[i] == (i % 2 == 0));
+            }
+
+            /* replace all values by the next key, and put the odd keys */
+            for (int i = 0; i < 100; ++i) {
+                values[i] = keys[(i + 1) % 100];
+            }
+            xassert(xrbtreehash_put_replace_many(table, pkeys, values, 100) == 100);
+            xassert(xrbtreehash_size(table) == 100);
+
+            xassert(xrbtreehash_get_many(table, pkeys, 100, values) == 100);
+            for (int i = 0; i < 100; ++i) {
+                xassert(values[i] == keys[(i + 1) % 100]);
+            }
+
+            xassert(xrbtreehash_get_many(table, pkeys, 0, values) == 0);
+
+            xrbtreehash_free(&table);
+        }
+
+        /* the table grows and rehashes incrementally in the batch */
+        {
+            XRBTreeHash_PT table = xrbtreehash_new(0, test_hash_string, xrbtreehash_equal, NULL);
+            xrbtreehash_set_max_loading_factor(table, 0.1);
+
+            xassert(xrbtreehash_put_replace_many(table, pkeys, pkeys, 100) == 100);
+            xassert(xrbtreehash_find_many(table, pkeys, 100, founds) == 100);
+            xassert(xrbtreehash_get_many(table, pkeys, 100, values) == 100);
+            for (int i = 0; i < 100; ++i) {
+                xassert(founds[i]);
+                xassert(values[i] == keys[i]);
+            }
+
+            xrbtreehash_free(&table);
+        }
+    }
+
     {
         int count = 0;
         xmem_leak(check_mem_leak, &count);
@@ -302,6 +302,23 @@ void test_xhashset() {
         xhashset_free(&set);
     }
 
+    /* xhashset_put_many */
+    /* xhashset_find_many */
+    {
+        XHashSet_PT set = xhashset_new(100, test_hash_string, test_cmpk, NULL);
+        void *elems[] = { "a", "b", "c", "a", "d" };
+        bool founds[5];
+
+        xassert(xhashset_put_many(set, elems, 3) == 3);
+        xassert(xhashset_size(set) == 3);
+
+        xassert(xhashset_find_many(set, elems, 5, founds) == 4);
+        xassert(founds[0] && founds[1] && founds[2] && founds[3]);
+        xassert_false(founds[4]);
+
+        xhashset_free(&set);
+    }
+
     /* xhashset_swap */
     {
     }
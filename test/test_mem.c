@@ -11,9 +11,82 @@
 */
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <pthread.h>
+#endif
 
 #include "../include/xalgos.h"
 
+#ifdef XDEBUG
+static
+void test_xmem_count(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+}
+
+#if defined(__linux__)
+#define TEST_XMEM_THREADS  16
+#define TEST_XMEM_PTRS     2000
+
+static void *test_xmem_ptrs[TEST_XMEM_THREADS][TEST_XMEM_PTRS];
+
+/* each thread allocates its own pointers */
+static
+void* test_xmem_alloc_thread(void *arg) {
+    void **ptrs = test_xmem_ptrs[(int)(intptr_t)arg];
+
+    for (int i = 0; i < TEST_XMEM_PTRS; ++i) {
+        ptrs[i] = (i % 2) ? xmem_calloc(1, 1 + i % 128, __FILE__, __LINE__) : xmem_malloc(1 + i % 128, __FILE__, __LINE__);
+        memset(ptrs[i], (int)(intptr_t)arg, 1 + i % 128);
+    }
+
+    /* some of them are freed by the same thread */
+    for (int i = 0; i < TEST_XMEM_PTRS; i += 4) {
+        xmem_free(ptrs[i], __FILE__, __LINE__);
+        ptrs[i] = NULL;
+    }
+
+    return NULL;
+}
+
+/* resize and free the pointers allocated by the other thread */
+static
+void* test_xmem_free_thread(void *arg) {
+    int t = (int)(intptr_t)arg;
+    void **ptrs = test_xmem_ptrs[(t + 1) % TEST_XMEM_THREADS];
+
+    for (int i = 0; i < TEST_XMEM_PTRS; ++i) {
+        if (!ptrs[i]) {
+            continue;
+        }
+
+        if (i % 3 == 0) {
+            ptrs[i] = xmem_resize(ptrs[i], 256, __FILE__, __LINE__);
+            xassert(((char*)ptrs[i])[0] == (char)((t + 1) % TEST_XMEM_THREADS));
+        }
+
+        xmem_free(ptrs[i], __FILE__, __LINE__);
+        ptrs[i] = NULL;
+    }
+
+    return NULL;
+}
+
+/* walk all the shards while the other threads are working */
+static
+void* test_xmem_leak_thread(void *arg) {
+    for (int i = 0; i < 20; ++i) {
+        int count = 0;
+        xmem_leak(test_xmem_count, &count);
+    }
+
+    return NULL;
+}
+#endif
+#endif
+
 void test_xmem() {
 
     /* xmem.c*/
@@ -118,16 +191,47 @@ void test_xmem() {
         }
 
         /* xmem_resize */
+#ifdef XDEBUG
         {
+            char *ptr = xmem_malloc(8, __FILE__, __LINE__);
+            memcpy(ptr, "1234567", 8);
+
+            ptr = xmem_resize(ptr, 100, __FILE__, __LINE__);
+            xassert(strcmp(ptr, "1234567") == 0);
+
+            ptr = xmem_resize(ptr, 4, __FILE__, __LINE__);
+            xassert(memcmp(ptr, "1234", 4) == 0);
+
+            xmem_free(ptr, __FILE__, __LINE__);
         }
+#endif
 
         /* xmem_resize0 */
         {
         }
 
         /* xmem_free */
+#ifdef XDEBUG
         {
+            /* pointer not allocated by xmem.h */
+            bool except = false;
+            char local = 0;
+
+            XEXCEPT_TRY
+                xmem_free(&local, __FILE__, __LINE__);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+
+            /* the checker still works after the exception */
+            {
+                void *ptr = xmem_malloc(16, __FILE__, __LINE__);
+                xmem_free(ptr, __FILE__, __LINE__);
+            }
         }
+#endif
 
         /* XMEM_MALLOC */
         {
@@ -166,8 +270,69 @@ void test_xmem() {
         }
 
         /* xmem_leak */
+#ifdef XDEBUG
         {
+            /* much more pointers than the first tables of all shards can hold */
+            int base = 0;
+            int count = 0;
+            void **ptrs = malloc(20000 * sizeof(void*));
+
+            xmem_leak(test_xmem_count, &base);
+
+            for (int i = 0; i < 20000; ++i) {
+                ptrs[i] = xmem_malloc(1 + i % 64, __FILE__, __LINE__);
+            }
+
+            xmem_leak(test_xmem_count, &count);
+            xassert(count == base + 20000);
+
+            for (int i = 0; i < 20000; ++i) {
+                xmem_free(ptrs[i], __FILE__, __LINE__);
+            }
+            free(ptrs);
+
+            count = 0;
+            xmem_leak(test_xmem_count, &count);
+            xassert(count == base);
+        }
+#endif
+
+        /* used by many threads together */
+#if defined(XDEBUG) && defined(__linux__)
+        {
+            int base = 0;
+            int count = 0;
+            pthread_t threads[TEST_XMEM_THREADS];
+            pthread_t leak_thread;
+
+            xmem_leak(test_xmem_count, &base);
+
+            pthread_create(&leak_thread, NULL, test_xmem_leak_thread, NULL);
+            for (int i = 0; i < TEST_XMEM_THREADS; ++i) {
+                pthread_create(&threads[i], NULL, test_xmem_alloc_thread, (void*)(intptr_t)i);
+            }
+            for (int i = 0; i < TEST_XMEM_THREADS; ++i) {
+                pthread_join(threads[i], NULL);
+            }
+            pthread_join(leak_thread, NULL);
+
+            xmem_leak(test_xmem_count, &count);
+            xassert(count == base + TEST_XMEM_THREADS * (TEST_XMEM_PTRS - TEST_XMEM_PTRS / 4));
+
+            pthread_create(&leak_thread, NULL, test_xmem_leak_thread, NULL);
+            for (int i = 0; i < TEST_XMEM_THREADS; ++i) {
+                pthread_create(&threads[i], NULL, test_xmem_free_thread, (void*)(intptr_t)i);
+            }
+            for (int i = 0; i < TEST_XMEM_THREADS; ++i) {
+                pthread_join(threads[i], NULL);
+            }
+            pthread_join(leak_thread, NULL);
+
+            count = 0;
+            xmem_leak(test_xmem_count, &count);
+            xassert(count == base);
         }
+#endif
     }
 
 }
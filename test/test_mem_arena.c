@@ -0,0 +1,679 @@
+#include <stdio.h>
+#include <string.h>
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "../include/xalgos.h"
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+static
+int test_xarena_cmp(void *key1, void *key2, void *cl) {
+    return *(int*)key1 - *(int*)key2;
+}
+
+static
+int test_xarena_hash(void *key) {
+    return *(int*)key;
+}
+
+#if defined(__linux__)
+#define TEST_XARENA_THREADS  8
+#define TEST_XARENA_OBJS     3000
+#define TEST_XARENA_KEEPS    100
+
+typedef struct {
+    XArena_PT  arena;
+    int        id;
+    char      *keeps[TEST_XARENA_KEEPS];   /* left to the main thread */
+} Test_XArena_Thread_T;
+
+static
+int test_xarena_thread_size(int i) {
+    return (i % 3 == 0) ? 8 : ((i % 3 == 1) ? 24 : 64);
+}
+
+/* small objects go through the thread cache : more are freed than the cache holds, so they are given back in batches,
+ * the thread exits with objects in its cache, which are given back to the arena by xarena_cache_release
+ */
+static
+void* test_xarena_thread(void *arg) {
+    Test_XArena_Thread_T *paras = (Test_XArena_Thread_T*)arg;
+    char *objs[TEST_XARENA_OBJS];
+
+    for (int r = 0; r < 3; ++r) {
+        for (int i = 0; i < TEST_XARENA_OBJS; ++i) {
+            int size = test_xarena_thread_size(i);
+            objs[i] = (char*)xarena_alloc(paras->arena, size);
+            xassert(objs[i]);
+            memset(objs[i], paras->id, size);
+        }
+
+        for (int i = 0; i < TEST_XARENA_OBJS; ++i) {
+            int size = test_xarena_thread_size(i);
+            xassert(objs[i][0] == (char)paras->id);
+            xassert(objs[i][size - 1] == (char)paras->id);
+
+            if ((r < 2) || (TEST_XARENA_KEEPS <= i)) {
+                xarena_freep(paras->arena, (void**)&objs[i], size);
+            }
+            else {
+                paras->keeps[i] = objs[i];
+            }
+        }
+    }
+
+    /* a big one from malloc */
+    {
+        void *big = xarena_alloc(paras->arena, 5000);
+        xassert(big);
+        xarena_freep(paras->arena, &big, 5000);
+    }
+
+    return NULL;
+}
+#endif
+
+static
+void test_xarena_alloc_free(XArena_PT arena) {
+    char *objs[200];
+
+    /* small objects of different sizes, and a big one */
+    for (int i = 0; i < 200; ++i) {
+        int size = (i % 3 == 0) ? 8 : ((i % 3 == 1) ? 24 : 1000);
+        objs[i] = (char*)xarena_calloc(arena, 1, size);
+        xassert(objs[i]);
+        xassert(objs[i][0] == 0);
+        xassert(objs[i][size - 1] == 0);
+        memset(objs[i], i, size);
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        int size = (i % 3 == 0) ? 8 : ((i % 3 == 1) ? 24 : 1000);
+        xassert((unsigned char)objs[i][0] == (unsigned char)i);
+        xassert((unsigned char)objs[i][size - 1] == (unsigned char)i);
+    }
+
+    for (int i = 0; i < 200; i += 2) {
+        int size = (i % 3 == 0) ? 8 : ((i % 3 == 1) ? 24 : 1000);
+        xarena_freep(arena, (void**)&objs[i], size);
+        xassert(!objs[i]);
+    }
+
+    /* the released ones are used again */
+    for (int i = 0; i < 200; i += 2) {
+        int size = (i % 3 == 0) ? 8 : ((i % 3 == 1) ? 24 : 1000);
+        objs[i] = (char*)xarena_alloc(arena, size);
+        xassert(objs[i]);
+    }
+
+    /* xarena_realloc */
+    {
+        char *ptr = (char*)xarena_alloc(arena, 16);
+        memcpy(ptr, "0123456789", 11);
+
+        ptr = (char*)xarena_realloc(arena, ptr, 16, 100);
+        xassert(strcmp(ptr, "0123456789") == 0);
+
+        ptr = (char*)xarena_realloc(arena, ptr, 100, 2000);
+        xassert(strcmp(ptr, "0123456789") == 0);
+
+        ptr = (char*)xarena_realloc(arena, ptr, 2000, 4000);
+        xassert(strcmp(ptr, "0123456789") == 0);
+    }
+
+    xarena_clear(arena);
+
+    /* still usable */
+    xassert(xarena_alloc(arena, 8));
+    xassert(xarena_alloc(arena, 1000));
+}
+
+void test_xarena() {
+
+    /* xarena_new */
+    {
+        XArena_PT arena = xarena_new();
+        test_xarena_alloc_free(arena);
+        xarena_free(&arena);
+        xassert(!arena);
+    }
+
+    /* xarena_new_region */
+    /* xarena_reset */
+    {
+        XArena_PT arena = xarena_new_region();
+        test_xarena_alloc_free(arena);
+
+        xarena_reset(arena);
+        {
+            char *first = (char*)xarena_alloc(arena, 10);
+            char *second = (char*)xarena_alloc(arena, 10);
+            char *big = NULL;
+
+            /* bumped one by one */
+            xassert(second == first + 16);
+
+            /* the last object grows in place */
+            xassert(xarena_realloc(arena, second, 10, 100) == second);
+
+            /* bigger than a chunk */
+            big = (char*)xarena_calloc(arena, 1, 100000);
+            xassert(big && (big[99999] == 0));
+
+            for (int i = 0; i < 10000; ++i) {
+                xassert(xarena_alloc(arena, 24));
+            }
+
+            /* the chunks are used again after reset */
+            xarena_reset(arena);
+            xassert(xarena_alloc(arena, 10) == first);
+        }
+
+        xarena_free(&arena);
+        xassert(!arena);
+    }
+
+#if defined(__linux__)
+    /* xarena_new_thread_safe */
+    {
+        XArena_PT arena = xarena_new_thread_safe();
+        test_xarena_alloc_free(arena);
+        xarena_free(&arena);
+        xassert(!arena);
+    }
+
+    /* the thread cache is full, half of it goes back to the arena */
+    {
+        XArena_PT arena = xarena_new_thread_safe();
+        void *objs[100];
+
+        for (int i = 0; i < 100; ++i) {
+            objs[i] = xarena_alloc(arena, 16);
+        }
+        for (int i = 0; i < 100; ++i) {
+            xarena_freep(arena, &objs[i], 16);
+        }
+        for (int i = 0; i < 100; ++i) {
+            objs[i] = xarena_alloc(arena, 16);
+            xassert(objs[i]);
+        }
+
+        xarena_free(&arena);
+    }
+#endif
+
+#ifndef XARENA_NO_STATS
+    /* xarena_stats */
+    /* xarena_class_stats */
+    /* xarena_stats_dump */
+    {
+        XArena_PT arena = xarena_new();
+        XArena_Stats_T stats;
+        XArena_Class_Stats_T class_stats;
+        void *objs[10];
+        void *big = NULL;
+
+        for (int i = 0; i < 10; ++i) {
+            objs[i] = xarena_alloc(arena, 13);
+        }
+        big = xarena_alloc(arena, 1000);
+        xarena_freep(arena, &objs[0], 13);
+
+        xassert(xarena_class_stats(arena, 13, &class_stats));
+        xassert(class_stats.size == 16);
+        xassert(class_stats.allocs == 10);
+        xassert(class_stats.frees == 1);
+        xassert(class_stats.refills == 1);
+        xassert(class_stats.waste_bytes == 30);
+        xassert(class_stats.live_bytes == 9 * 16);
+        xassert(class_stats.peak_bytes == 10 * 16);
+
+        xassert(xarena_stats(arena, &stats));
+        xassert(stats.chunks == 1);
+        xassert(stats.allocs == 10);
+        xassert(stats.live_bytes == 9 * 16);
+        xassert(stats.big_allocs == 1);
+        xassert(stats.big_live_bytes == 1000);
+
+        xarena_freep(arena, &big, 1000);
+        xassert(xarena_stats(arena, &stats));
+        xassert(stats.big_frees == 1);
+        xassert(stats.big_live_bytes == 0);
+        xassert(stats.big_peak_bytes == 1000);
+
+        /* all released */
+        xarena_clear(arena);
+        xassert(xarena_stats(arena, &stats));
+        xassert(stats.chunks == 0);
+        xassert(stats.allocs == stats.frees);
+        xassert(stats.live_bytes == 0);
+
+        xarena_free(&arena);
+    }
+
+#if defined(__linux__)
+    /* counted by the thread cache */
+    {
+        XArena_PT arena = xarena_new_thread_safe();
+        XArena_Class_Stats_T class_stats;
+        void *obj = xarena_alloc(arena, 24);
+
+        xarena_freep(arena, &obj, 24);
+        obj = xarena_alloc(arena, 20);
+
+        xassert(xarena_class_stats(arena, 24, &class_stats));
+        xassert(class_stats.allocs == 2);
+        xassert(class_stats.frees == 1);
+        xassert(class_stats.waste_bytes == 4);
+        xassert(class_stats.live_bytes == 24);
+
+        xarena_free(&arena);
+    }
+#endif
+#endif
+
+#if defined(__linux__)
+    /* used by many threads, and the threads exit before the arena is freed */
+    {
+        XArena_PT arena = xarena_new_thread_safe();
+        pthread_t threads[TEST_XARENA_THREADS];
+        static Test_XArena_Thread_T paras[TEST_XARENA_THREADS];
+        long keep_bytes = 0;
+
+        for (int i = 0; i < TEST_XARENA_THREADS; ++i) {
+            paras[i].arena = arena;
+            paras[i].id = i + 1;
+            pthread_create(&threads[i], NULL, test_xarena_thread, (void*)&paras[i]);
+        }
+        for (int i = 0; i < TEST_XARENA_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        for (int k = 0; k < TEST_XARENA_KEEPS; ++k) {
+            keep_bytes += test_xarena_thread_size(k);
+        }
+
+#ifndef XARENA_NO_STATS
+        {
+            XArena_Stats_T stats;
+
+            xassert(xarena_stats(arena, &stats));
+            xassert(stats.allocs == (long)TEST_XARENA_THREADS * 3 * TEST_XARENA_OBJS);
+            xassert(stats.frees == stats.allocs - (long)TEST_XARENA_THREADS * TEST_XARENA_KEEPS);
+            xassert(stats.live_bytes == TEST_XARENA_THREADS * keep_bytes);
+            xassert(stats.big_allocs == TEST_XARENA_THREADS);
+            xassert(stats.big_frees == TEST_XARENA_THREADS);
+            xassert(stats.big_live_bytes == 0);
+        }
+#endif
+
+        /* the objects kept by the exited threads are still valid, and freed by this thread */
+        for (int i = 0; i < TEST_XARENA_THREADS; ++i) {
+            for (int k = 0; k < TEST_XARENA_KEEPS; ++k) {
+                int size = test_xarena_thread_size(k);
+                xassert(paras[i].keeps[k][0] == (char)paras[i].id);
+                xassert(paras[i].keeps[k][size - 1] == (char)paras[i].id);
+                xarena_freep(arena, (void**)&paras[i].keeps[k], size);
+            }
+        }
+
+#ifndef XARENA_NO_STATS
+        {
+            XArena_Stats_T stats;
+
+            xassert(xarena_stats(arena, &stats));
+            xassert(stats.allocs == stats.frees);
+            xassert(stats.live_bytes == 0);
+        }
+#endif
+
+        xarena_free(&arena);
+        xassert(!arena);
+    }
+#endif
+
+    /* xarena_allocator */
+    {
+        XArena_PT arena = xarena_new();
+        XMem_Allocator_T allocator;
+        int keys[300];
+
+        xarena_allocator(arena, &allocator);
+
+        for (int i = 0; i < 300; ++i) {
+            keys[i] = i;
+        }
+
+        {
+            XPArray_PT array = xparray_new_allocator(4, &allocator);
+            xassert(xparray_put(array, 3, &keys[3], NULL));
+            xassert(xparray_resize(array, 100));
+            xassert(xparray_get(array, 3) == &keys[3]);
+            xparray_free(&array);
+        }
+
+        {
+            XRBTree_PT tree = xrbtree_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XRBTree_PT ntree = NULL;
+
+            for (int i = 0; i < 300; ++i) {
+                xassert(xrbtree_put_unique(tree, &keys[i], &keys[i]));
+            }
+            xassert(xrbtree_remove(tree, &keys[10]) == 1);
+
+            ntree = xrbtree_copy(tree);
+            xassert(xrbtree_size(ntree) == 299);
+            xassert(*(int*)xrbtree_get(ntree, &keys[200]) == 200);
+
+            xrbtree_free(&ntree);
+            xrbtree_free(&tree);
+        }
+
+        {
+            XAVLTree_PT tree = xavltree_new_allocator(test_xarena_cmp, NULL, &allocator);
+
+            for (int i = 0; i < 300; ++i) {
+                xassert(xavltree_put_unique(tree, &keys[i], &keys[i]));
+            }
+            xassert(*(int*)xavltree_get(tree, &keys[100]) == 100);
+
+            xavltree_free(&tree);
+        }
+
+        {
+            XRBTreeHash_PT table = xrbtreehash_new_allocator(4, test_xarena_hash, test_xarena_cmp, NULL, &allocator);
+
+            /* the buckets are resized from the allocator too */
+            xrbtreehash_set_max_loading_factor(table, 1.0);
+            for (int i = 0; i < 300; ++i) {
+                xassert(xrbtreehash_put_unique(table, &keys[i], &keys[i]));
+            }
+            xassert(*(int*)xrbtreehash_get(table, &keys[299]) == 299);
+
+            xrbtreehash_free(&table);
+        }
+
+        {
+            XDeque_PT deque = xdeque_new_allocator(0, &allocator);
+            XDeque_PT ndeque = NULL;
+
+            /* the layer-2 sequences come from the allocator too */
+            for (int i = 0; i < 300; ++i) {
+                xassert(xdeque_push_back(deque, &keys[i]));
+            }
+
+            ndeque = xdeque_copy(deque);
+            xassert(xdeque_size(ndeque) == 300);
+            xassert(*(int*)xdeque_get(ndeque, 200) == 200);
+
+            xdeque_free(&ndeque);
+            xdeque_free(&deque);
+        }
+
+        {
+            XSet_PT set1 = xset_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XSet_PT set2 = xset_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XSet_PT nset = NULL;
+
+            /* repeated elements keep the values arrays in the allocator */
+            for (int i = 0; i < 100; ++i) {
+                xassert(xset_put_repeat(set1, &keys[i]));
+                xassert(xset_put_repeat(set1, &keys[i]));
+                xassert(xset_put_repeat(set1, &keys[i]));
+                xassert(xset_put_repeat(set2, &keys[i + 50]));
+            }
+
+            nset = xset_copy(set1);
+            xassert(xset_size(nset) == 300);
+            xset_free(&nset);
+
+            nset = xset_union(set1, set2);
+            xassert(nset);
+            xset_free(&nset);
+
+            xset_free(&set1);
+            xset_free(&set2);
+        }
+
+        {
+            XListRBTree_PT tree = xlistrbtree_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XListRBTree_PT ntree = NULL;
+
+            for (int i = 0; i < 100; ++i) {
+                for (int j = 0; j < 5; ++j) {
+                    xassert(xlistrbtree_put_repeat(tree, &keys[i], &keys[j]));
+                }
+            }
+            xassert(xlistrbtree_remove(tree, &keys[10]) == 1);
+
+            ntree = xlistrbtree_copy(tree);
+            xassert(xlistrbtree_size(ntree) == 499);
+
+            xlistrbtree_free(&ntree);
+            xlistrbtree_free(&tree);
+        }
+
+        {
+            XKVHashtab_PT table = xkvhashtab_new_allocator(4, test_xarena_hash, test_xarena_cmp, NULL, &allocator);
+
+            /* the buckets are resized from the allocator, the bucket lists still come from XMEM */
+            xkvhashtab_set_max_loading_factor(table, 1.0);
+            for (int i = 0; i < 300; ++i) {
+                xassert(xkvhashtab_put_repeat(table, &keys[i], &keys[i]) == 1);
+            }
+            xassert(xkvhashtab_size(table) == 300);
+
+            xkvhashtab_free(&table);
+        }
+
+        {
+            XFlatHash_PT table = xflathash_new_allocator(4, test_xarena_hash, test_xarena_cmp, NULL, &allocator);
+            XFlatHash_PT ntable = NULL;
+
+            /* the control bytes and the slots are rehashed in the allocator */
+            for (int i = 0; i < 300; ++i) {
+                xassert(xflathash_put_unique(table, &keys[i], &keys[i]));
+            }
+            xassert(xflathash_remove(table, &keys[10]));
+
+            ntable = xflathash_copy(table);
+            xassert(xflathash_size(ntable) == 299);
+            xassert(*(int*)xflathash_get(ntable, &keys[200]) == 200);
+
+            xflathash_free(&ntable);
+            xflathash_free(&table);
+        }
+
+        {
+            XBPTree_PT tree = xbptree_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XBPTree_PT ntree = NULL;
+            XBPTree_PT stree = NULL;
+
+            for (int i = 0; i < 300; ++i) {
+                xassert(xbptree_put_unique(tree, &keys[i], &keys[i]));
+            }
+            xassert(xbptree_remove(tree, &keys[10]) == 1);
+
+            ntree = xbptree_copy(tree);
+            xassert(xbptree_size(ntree) == 299);
+
+            /* the split tree inherits the allocator */
+            stree = xbptree_split(ntree, &keys[200]);
+            xassert(xbptree_size(stree) == 100);
+            xassert(xbptree_size(ntree) == 199);
+            xassert(*(int*)xbptree_get(stree, &keys[250]) == 250);
+
+            xbptree_free(&stree);
+            xbptree_free(&ntree);
+            xbptree_free(&tree);
+        }
+
+        {
+            XMap_PT map = xmap_new_allocator(test_xarena_cmp, NULL, &allocator);
+
+            for (int i = 0; i < 300; ++i) {
+                xassert(xmap_put_unique(map, &keys[i], &keys[i]));
+            }
+            xassert(xmap_size(map) == 300);
+            xassert(*(int*)xmap_get(map, &keys[100]) == 100);
+
+            xmap_free(&map);
+        }
+
+        {
+            XGraph_PT graph = xgraph_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XGraph_PT ngraph = NULL;
+            XDigraph_PT digraph = xdigraph_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XDigraph_PT rgraph = NULL;
+            XWGraph_PT wgraph = xwgraph_new_allocator(test_xarena_cmp, NULL, &allocator);
+
+            /* the adjacency sets come from the allocator too, the weighted edges from XMEM */
+            for (int i = 0; i < 99; ++i) {
+                xassert(xgraph_add_edge_unique(graph, &keys[i], &keys[i + 1]));
+                xassert(xdigraph_add_edge_unique(digraph, &keys[i], &keys[i + 1]));
+                xassert(xwgraph_add_edge_unique(wgraph, &keys[i], &keys[i + 1], 1.0));
+            }
+
+            ngraph = xgraph_copy(graph);
+            xassert(xgraph_edge_size(ngraph) == 99);
+
+            rgraph = xdigraph_reverse(digraph);
+            xassert(xdigraph_edge_size(rgraph) == 99);
+
+            xgraph_free(&ngraph);
+            xgraph_free(&graph);
+            xdigraph_free(&rgraph);
+            xdigraph_free(&digraph);
+            xwgraph_free(&wgraph);
+        }
+
+        /* swap refuses containers of different allocators, both are still released to their own allocators */
+        {
+            XRBTree_PT tree1 = xrbtree_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XRBTree_PT tree2 = xrbtree_new(test_xarena_cmp, NULL);
+            XRBTree_PT tree3 = xrbtree_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XAVLTree_PT avl1 = xavltree_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XAVLTree_PT avl2 = xavltree_new(test_xarena_cmp, NULL);
+            XRBTreeHash_PT table1 = xrbtreehash_new_allocator(4, test_xarena_hash, test_xarena_cmp, NULL, &allocator);
+            XRBTreeHash_PT table2 = xrbtreehash_new(4, test_xarena_hash, test_xarena_cmp, NULL);
+            XDeque_PT deque1 = xdeque_new_allocator(0, &allocator);
+            XDeque_PT deque2 = xdeque_new(0);
+            XSet_PT set1 = xset_new_allocator(test_xarena_cmp, NULL, &allocator);
+            XSet_PT set2 = xset_new(test_xarena_cmp, NULL);
+            bool swapped = true;
+            int except = 0;
+
+            for (int i = 0; i < 100; ++i) {
+                xrbtree_put_unique(tree1, &keys[i], &keys[i]);
+                xrbtree_put_unique(tree2, &keys[i + 100], &keys[i + 100]);
+                xavltree_put_unique(avl1, &keys[i], &keys[i]);
+                xavltree_put_unique(avl2, &keys[i + 100], &keys[i + 100]);
+                xrbtreehash_put_unique(table1, &keys[i], &keys[i]);
+                xrbtreehash_put_unique(table2, &keys[i + 100], &keys[i + 100]);
+                xdeque_push_back(deque1, &keys[i]);
+                xdeque_push_back(deque2, &keys[i + 100]);
+                xset_put_unique(set1, &keys[i]);
+                xset_put_unique(set2, &keys[i + 100]);
+            }
+
+            XEXCEPT_TRY
+                swapped = xrbtree_swap(tree1, tree2);
+            XEXCEPT_ELSE
+                ++except;
+            XEXCEPT_END_TRY
+
+            XEXCEPT_TRY
+                swapped = xavltree_swap(avl1, avl2);
+            XEXCEPT_ELSE
+                ++except;
+            XEXCEPT_END_TRY
+
+            XEXCEPT_TRY
+                swapped = xrbtreehash_swap(table1, table2);
+            XEXCEPT_ELSE
+                ++except;
+            XEXCEPT_END_TRY
+
+            XEXCEPT_TRY
+                swapped = xdeque_swap(deque1, deque2);
+            XEXCEPT_ELSE
+                ++except;
+            XEXCEPT_END_TRY
+
+            XEXCEPT_TRY
+                swapped = xset_swap(set1, set2);
+            XEXCEPT_ELSE
+                ++except;
+            XEXCEPT_END_TRY
+
+            xassert(except == 5);
+            xassert(swapped);
+            xassert(*(int*)xrbtree_min(tree1) == 0);
+            xassert(*(int*)xrbtree_min(tree2) == 100);
+
+            /* the same allocator */
+            xassert(xrbtree_swap(tree1, tree3));
+            xassert(xrbtree_is_empty(tree1));
+            xassert(xrbtree_size(tree3) == 100);
+
+            xrbtree_free(&tree1);
+            xrbtree_free(&tree2);
+            xrbtree_free(&tree3);
+            xavltree_free(&avl1);
+            xavltree_free(&avl2);
+            xrbtreehash_free(&table1);
+            xrbtreehash_free(&table2);
+            xdeque_free(&deque1);
+            xdeque_free(&deque2);
+            xset_free(&set1);
+            xset_free(&set2);
+        }
+
+#ifndef XARENA_NO_STATS
+        /* all the containers give their memory back */
+        {
+            XArena_Stats_T stats;
+            xassert(xarena_stats(arena, &stats));
+            xassert(stats.live_bytes == 0);
+            xassert(stats.big_live_bytes == 0);
+        }
+#endif
+
+        xarena_free(&arena);
+    }
+
+    /* containers in a region arena are dropped at once by xarena_reset */
+    {
+        XArena_PT arena = xarena_new_region();
+        XMem_Allocator_T allocator;
+        int keys[100];
+
+        xarena_allocator(arena, &allocator);
+
+        for (int round = 0; round < 2; ++round) {
+            XRBTreeHash_PT table = xrbtreehash_new_allocator(16, test_xarena_hash, test_xarena_cmp, NULL, &allocator);
+
+            for (int i = 0; i < 100; ++i) {
+                keys[i] = i;
+                xassert(xrbtreehash_put_unique(table, &keys[i], &keys[i]));
+            }
+            xassert(xrbtreehash_size(table) == 100);
+
+            xarena_reset(arena);
+        }
+
+        xarena_free(&arena);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
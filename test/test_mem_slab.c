@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../mem_slab/xmem_slab_x.h"
+#include "../include/xalgos.h"
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xslab() {
+
+    /* xslab_new */
+    {
+        /* obj_size <= 0 */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xslab_new(0);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        /* normal */
+        {
+            XSlab_PT slab = xslab_new(3);
+            xassert(xslab_obj_size(slab) == 8);
+            xassert(xslab_slab_count(slab) == 0);
+            xassert(xslab_used_count(slab) == 0);
+            xassert(xslab_bytes(slab) == 0);
+            xslab_free(&slab);
+            xassert(!slab);
+        }
+    }
+
+    /* xslab_alloc */
+    {
+        /* slab == NULL */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xslab_alloc(NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        /* normal : the objects are zeroed and aligned, slabs grow geometrically */
+        {
+            XSlab_PT slab = xslab_new(20);
+            char *objs[100];
+
+            for (int i = 0; i < 100; ++i) {
+                objs[i] = (char*)xslab_alloc(slab);
+                xassert(objs[i]);
+                xassert(((size_t)objs[i] % 8) == 0);
+                for (int j = 0; j < 20; ++j) {
+                    xassert(objs[i][j] == 0);
+                }
+                memset(objs[i], 0xff, 20);
+            }
+
+            /* 4 + 8 + 16 + 32 + 64 */
+            xassert(xslab_slab_count(slab) == 5);
+            xassert(xslab_used_count(slab) == 100);
+            xassert(0 < xslab_bytes(slab));
+
+            for (int i = 0; i < 100; ++i) {
+                for (int j = i + 1; j < 100; ++j) {
+                    xassert(objs[i] != objs[j]);
+                }
+            }
+
+            xslab_free(&slab);
+        }
+    }
+
+    /* xslab_freep */
+    {
+        XSlab_PT slab = xslab_new(16);
+        void *obj1 = xslab_alloc(slab);
+        void *obj2 = xslab_alloc(slab);
+        void *saved = obj1;
+        long bytes = xslab_bytes(slab);
+
+        memset(obj1, 0xff, 16);
+        xslab_freep(slab, &obj1);
+        xassert(!obj1);
+        xassert(xslab_used_count(slab) == 1);
+
+        /* the released one is used again and zeroed */
+        obj1 = xslab_alloc(slab);
+        xassert(obj1 == saved);
+        xassert(((char*)obj1)[0] == 0);
+        xassert(((char*)obj1)[15] == 0);
+        xassert(xslab_bytes(slab) == bytes);
+        xassert(xslab_used_count(slab) == 2);
+
+        xslab_freep(slab, &obj1);
+        xslab_freep(slab, &obj2);
+        xassert(xslab_used_count(slab) == 0);
+
+        xslab_free(&slab);
+    }
+
+    /* xslab_clear */
+    {
+        XSlab_PT slab = xslab_new(sizeof(void*));
+
+        for (int i = 0; i < 1000; ++i) {
+            xassert(xslab_alloc(slab));
+        }
+
+        xslab_clear(slab);
+        xassert(xslab_slab_count(slab) == 0);
+        xassert(xslab_used_count(slab) == 0);
+        xassert(xslab_bytes(slab) == 0);
+
+        /* still usable */
+        xassert(xslab_alloc(slab));
+        xassert(xslab_slab_count(slab) == 1);
+
+        xslab_free(&slab);
+    }
+
+    /* xslab_share */
+    {
+        XSlab_PT slab = xslab_new(8);
+        XSlab_PT shared = xslab_share(slab);
+        xassert(shared == slab);
+        xassert(xslab_is_shared(slab));
+
+        xassert(xslab_alloc(shared));
+
+        xslab_free(&shared);
+        xassert(!shared);
+        xassert(!xslab_is_shared(slab));
+        xassert(xslab_used_count(slab) == 1);
+
+        xslab_free(&slab);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
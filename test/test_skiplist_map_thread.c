@@ -0,0 +1,309 @@
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "../skiplist_map_thread/xskiplist_map_thread_x.h"
+#include "../include/xalgos.h"
+
+static
+int test_cmpi(void *key1, void *key2, void *cl) {
+    return *(int*)key1 - *(int*)key2;
+}
+
+static
+bool xts_skipmap_test_map_ordered(void *key, void *value, void *cl) {
+    int *last = (int*)cl;
+    xassert(*last < *(int*)key);
+    xassert(key == value);
+    *last = *(int*)key;
+    return true;
+}
+
+static
+bool xts_skipmap_test_map_remove(void *key, void *value, void *cl) {
+    /* apply can use the map too */
+    return xts_skipmap_remove((XTS_SkipMap_PT)cl, key);
+}
+
+#define XTS_SKIPMAP_TEST_THREADS  8
+#define XTS_SKIPMAP_TEST_KEYS     4000
+#define XTS_SKIPMAP_TEST_ROUNDS   20
+
+static int xts_skipmap_test_keys[XTS_SKIPMAP_TEST_KEYS];
+
+typedef struct {
+    XTS_SkipMap_PT map;
+    int            id;
+    int            puts;     /* the count of the successful puts */
+    int            removes;  /* the count of the successful removes */
+} XTS_SkipMap_Test_Thread_T;
+
+/* each thread owns the keys of its id, the other keys are changed by the other threads at the same time */
+static
+void* xts_skipmap_test_own_thread(void *arg) {
+    XTS_SkipMap_Test_Thread_T *paras = (XTS_SkipMap_Test_Thread_T*)arg;
+    XTS_SkipMap_PT map = paras->map;
+
+    for (int r = 0; r < XTS_SKIPMAP_TEST_ROUNDS; ++r) {
+        for (int i = paras->id; i < XTS_SKIPMAP_TEST_KEYS; i += XTS_SKIPMAP_TEST_THREADS) {
+            int *key = &xts_skipmap_test_keys[i];
+            int odd = *key + 1;
+
+            xassert(xts_skipmap_put_if_absent(map, key, key));
+            xassert(xts_skipmap_get(map, key) == key);
+
+            /* the neighbors may be changed by the others, but the result is still ordered */
+            {
+                int *floor = (int*)xts_skipmap_floor(map, &odd);
+                int *ceiling = (int*)xts_skipmap_ceiling(map, &odd);
+                xassert(floor && (*key <= *floor) && (*floor < odd));
+                xassert(!ceiling || (odd < *ceiling));
+            }
+
+            if ((i + r) % 2) {
+                xassert(xts_skipmap_remove(map, key));
+                xassert(!xts_skipmap_find(map, key));
+                xassert(!xts_skipmap_remove(map, key));
+            }
+        }
+
+        /* the keys left by this round are removed before the next one */
+        for (int i = paras->id; i < XTS_SKIPMAP_TEST_KEYS; i += XTS_SKIPMAP_TEST_THREADS) {
+            int *key = &xts_skipmap_test_keys[i];
+            xassert(xts_skipmap_find(map, key) == ((i + r) % 2 == 0));
+            if ((i + r) % 2 == 0) {
+                xassert(xts_skipmap_remove(map, key));
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* all threads put and remove the same keys */
+static
+void* xts_skipmap_test_shared_thread(void *arg) {
+    XTS_SkipMap_Test_Thread_T *paras = (XTS_SkipMap_Test_Thread_T*)arg;
+    XTS_SkipMap_PT map = paras->map;
+
+    for (int r = 0; r < XTS_SKIPMAP_TEST_ROUNDS; ++r) {
+        for (int i = 0; i < XTS_SKIPMAP_TEST_KEYS; ++i) {
+            int k = (i * 1447 + paras->id * 7) % XTS_SKIPMAP_TEST_KEYS;
+            int *key = &xts_skipmap_test_keys[k];
+            void *value = NULL;
+
+            if ((k + paras->id + r) % 3) {
+                paras->puts += xts_skipmap_put_if_absent(map, key, key) ? 1 : 0;
+            }
+            else {
+                paras->removes += xts_skipmap_remove(map, key) ? 1 : 0;
+            }
+
+            value = xts_skipmap_get(map, key);
+            xassert(!value || (value == key));
+        }
+    }
+
+    return NULL;
+}
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xts_skipmap() {
+    enum { TEST_N = 3000 };
+
+    static int keys[TEST_N];
+    for (int i = 0; i < TEST_N; ++i) {
+        keys[i] = 2 * i;
+    }
+
+    /* xts_skipmap_new */
+    {
+        /* cmp == NULL */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xts_skipmap_new(NULL, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        {
+            XTS_SkipMap_PT map = xts_skipmap_new(test_cmpi, NULL);
+            xassert(map);
+            xassert(xts_skipmap_is_empty(map));
+            xassert(!xts_skipmap_min(map));
+            xassert(!xts_skipmap_max(map));
+            xts_skipmap_free(&map);
+            xassert(!map);
+        }
+    }
+
+    /* xts_skipmap_put_replace */
+    /* xts_skipmap_put_if_absent */
+    /* xts_skipmap_get */
+    /* xts_skipmap_find */
+    {
+        XTS_SkipMap_PT map = xts_skipmap_new(test_cmpi, NULL);
+
+        /* put in a shuffled order */
+        for (int i = 0; i < TEST_N; ++i) {
+            int k = (i * 1447) % TEST_N;
+            xassert(xts_skipmap_put_if_absent(map, &keys[k], &keys[k]));
+            xassert(!xts_skipmap_put_if_absent(map, &keys[k], NULL));
+        }
+        xassert(xts_skipmap_size(map) == TEST_N);
+
+        for (int i = 0; i < TEST_N; ++i) {
+            int key = 2 * i + 1;
+            xassert(xts_skipmap_get(map, &keys[i]) == &keys[i]);
+            xassert(!xts_skipmap_find(map, &key));
+        }
+
+        xassert(xts_skipmap_put_replace(map, &keys[9], NULL));
+        xassert(xts_skipmap_find(map, &keys[9]));
+        xassert(!xts_skipmap_get(map, &keys[9]));
+        xassert(xts_skipmap_put_replace(map, &keys[9], &keys[9]));
+        xassert(xts_skipmap_size(map) == TEST_N);
+
+        /* xts_skipmap_min */
+        /* xts_skipmap_max */
+        /* xts_skipmap_floor */
+        /* xts_skipmap_ceiling */
+        {
+            int key = -1;
+            xassert(xts_skipmap_min(map) == &keys[0]);
+            xassert(xts_skipmap_max(map) == &keys[TEST_N - 1]);
+            xassert(!xts_skipmap_floor(map, &key));
+            xassert(xts_skipmap_ceiling(map, &key) == &keys[0]);
+
+            for (int i = 0; i < TEST_N; ++i) {
+                key = 2 * i + 1;
+                xassert(xts_skipmap_floor(map, &key) == &keys[i]);
+                xassert(xts_skipmap_floor(map, &keys[i]) == &keys[i]);
+                xassert(xts_skipmap_ceiling(map, &keys[i]) == &keys[i]);
+                xassert((i == TEST_N - 1) ? !xts_skipmap_ceiling(map, &key) : (xts_skipmap_ceiling(map, &key) == &keys[i + 1]));
+            }
+        }
+
+        /* xts_skipmap_map_range */
+        /* xts_skipmap_map_min_to_max */
+        {
+            int last = -1;
+            int low = 101;
+            int high = 200;
+
+            xassert(xts_skipmap_map_min_to_max(map, xts_skipmap_test_map_ordered, &last) == TEST_N);
+            xassert(last == keys[TEST_N - 1]);
+
+            last = -1;
+            xassert(xts_skipmap_map_range(map, &high, &low, xts_skipmap_test_map_ordered, &last) == 50);
+            xassert(last == 200);
+        }
+
+        /* xts_skipmap_remove */
+        {
+            int key = 1;
+            xassert(!xts_skipmap_remove(map, &key));
+
+            for (int i = 0; i < TEST_N; i += 2) {
+                int k = (i * 1447) % TEST_N;
+                xassert(xts_skipmap_remove(map, &keys[k]));
+                xassert(!xts_skipmap_remove(map, &keys[k]));
+                xassert(!xts_skipmap_find(map, &keys[k]));
+            }
+            xassert(xts_skipmap_size(map) == TEST_N / 2);
+
+            for (int i = 0; i < TEST_N; ++i) {
+                int k = (i * 1447) % TEST_N;
+                xassert(xts_skipmap_find(map, &keys[k]) == (i % 2 == 1));
+            }
+
+            /* put again after removed */
+            for (int i = 0; i < TEST_N; i += 2) {
+                int k = (i * 1447) % TEST_N;
+                xassert(xts_skipmap_put_if_absent(map, &keys[k], &keys[k]));
+            }
+            xassert(xts_skipmap_size(map) == TEST_N);
+
+            /* remove all in apply */
+            xassert(xts_skipmap_map_min_to_max(map, xts_skipmap_test_map_remove, map) == TEST_N);
+            xassert(xts_skipmap_is_empty(map));
+            xassert(!xts_skipmap_min(map));
+            xassert(!xts_skipmap_max(map));
+        }
+
+        xts_skipmap_free(&map);
+    }
+
+    /* many threads */
+    {
+        XTS_SkipMap_PT map = xts_skipmap_new(test_cmpi, NULL);
+        pthread_t threads[XTS_SKIPMAP_TEST_THREADS];
+        XTS_SkipMap_Test_Thread_T paras[XTS_SKIPMAP_TEST_THREADS];
+
+        for (int i = 0; i < XTS_SKIPMAP_TEST_KEYS; ++i) {
+            xts_skipmap_test_keys[i] = 2 * i;
+        }
+
+        for (int i = 0; i < XTS_SKIPMAP_TEST_THREADS; ++i) {
+            paras[i].map = map;
+            paras[i].id = i;
+            paras[i].puts = 0;
+            paras[i].removes = 0;
+            pthread_create(&threads[i], NULL, xts_skipmap_test_own_thread, (void*)&paras[i]);
+        }
+        for (int i = 0; i < XTS_SKIPMAP_TEST_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        xassert(xts_skipmap_is_empty(map));
+
+        for (int i = 0; i < XTS_SKIPMAP_TEST_THREADS; ++i) {
+            pthread_create(&threads[i], NULL, xts_skipmap_test_shared_thread, (void*)&paras[i]);
+        }
+        for (int i = 0; i < XTS_SKIPMAP_TEST_THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        /* each key is put once more than it's removed if it's in the map */
+        {
+            int puts = 0;
+            int removes = 0;
+            int last = -1;
+
+            for (int i = 0; i < XTS_SKIPMAP_TEST_THREADS; ++i) {
+                puts += paras[i].puts;
+                removes += paras[i].removes;
+            }
+            xassert(xts_skipmap_size(map) == puts - removes);
+            xassert(xts_skipmap_map_min_to_max(map, xts_skipmap_test_map_ordered, &last) == puts - removes);
+
+            for (int i = 0; i < XTS_SKIPMAP_TEST_KEYS; ++i) {
+                int *key = &xts_skipmap_test_keys[i];
+                xassert(xts_skipmap_find(map, key) == (xts_skipmap_get(map, key) == key));
+            }
+        }
+
+        xts_skipmap_free(&map);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
+
+#endif
@@ -0,0 +1,309 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "../utils/xutils.h"
+#include "../tree_adaptive_radix/xtree_adaptive_radix_x.h"
+#include "../include/xalgos.h"
+
+static
+bool xartree_test_map_applykv_true(void *key, void **value, void *cl) {
+    return true;
+}
+
+static
+bool xartree_test_map_cmpkv(void *key, void **value, void *cl) {
+    return strcmp((char*)key, (char*)cl) == 0;
+}
+
+/* keys must be visited in order, cl saves the last key */
+static
+bool xartree_test_map_in_order(void *key, void **value, void *cl) {
+    char **last = (char**)cl;
+    xassert(!*last || (strcmp(*last, (char*)key) < 0));
+    *last = (char*)key;
+    return true;
+}
+
+static
+bool xartree_test_map_free_value(void *key, void **value, void *cl) {
+    XMEM_FREE(*value);
+    return true;
+}
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xartree() {
+    /* xartree_new */
+    {
+        XARTree_PT tree = xartree_new();
+        xassert(tree);
+        xassert(tree->root == NULL);
+        xassert(tree->size == 0);
+        xartree_free(&tree);
+    }
+
+    /* xartree_put_unique */
+    /* xartree_get */
+    /* xartree_find */
+    {
+        XARTree_PT tree = xartree_new();
+
+        xassert(xartree_put_unique(tree, "a", "1"));
+        xassert(xartree_put_unique(tree, "", "0"));
+        xassert(xartree_put_unique(tree, "ab", "2"));
+        xassert(xartree_put_unique(tree, "abc", "3"));
+        xassert(xartree_put_unique(tree, "abd", "4"));
+        xassert(xartree_put_unique(tree, "b", "5"));
+        xassert(xartree_put_unique(tree, "abcdefghijklmnopqrstuvwxyz1", "6"));
+        xassert(xartree_put_unique(tree, "abcdefghijklmnopqrstuvwxyz2", "7"));
+        xassert(xartree_size(tree) == 8);
+
+        /* the same key will not be saved again */
+        xassert(xartree_put_unique(tree, "ab", "22"));
+        xassert(xartree_size(tree) == 8);
+
+        xassert(strcmp(xartree_get(tree, ""), "0") == 0);
+        xassert(strcmp(xartree_get(tree, "a"), "1") == 0);
+        xassert(strcmp(xartree_get(tree, "ab"), "2") == 0);
+        xassert(strcmp(xartree_get(tree, "abc"), "3") == 0);
+        xassert(strcmp(xartree_get(tree, "abd"), "4") == 0);
+        xassert(strcmp(xartree_get(tree, "b"), "5") == 0);
+        xassert(strcmp(xartree_get(tree, "abcdefghijklmnopqrstuvwxyz1"), "6") == 0);
+        xassert(strcmp(xartree_get(tree, "abcdefghijklmnopqrstuvwxyz2"), "7") == 0);
+
+        xassert(!xartree_get(tree, "abcdefghijklmnopqrstuvwxyz"));
+        xassert(!xartree_get(tree, "abcdefghijklmnopqrstuvwxyz3"));
+        xassert(!xartree_get(tree, "abcdefghijklmnopqrstuvwxy"));
+        xassert(!xartree_find(tree, "c"));
+        xassert(!xartree_find(tree, "abe"));
+        xassert(xartree_find(tree, "abd"));
+
+        xartree_free(&tree);
+    }
+
+    /* xartree_put_replace */
+    /* xartree_put_deep_replace */
+    {
+        XARTree_PT tree = xartree_new();
+        void *old_value = NULL;
+
+        xassert(xartree_put_replace(tree, "abc", "1", &old_value));
+        xassert(!old_value);
+        xassert(xartree_put_replace(tree, "abc", "2", &old_value));
+        xassert(strcmp(old_value, "1") == 0);
+        xassert(strcmp(xartree_get(tree, "abc"), "2") == 0);
+        xassert(xartree_size(tree) == 1);
+
+        xartree_free(&tree);
+    }
+    {
+        XARTree_PT tree = xartree_new();
+
+        xassert(xartree_put_deep_replace(tree, "abc", xutils_deep_copy("1", 2)));
+        xassert(xartree_put_deep_replace(tree, "abc", xutils_deep_copy("2", 2)));
+        xassert(strcmp(xartree_get(tree, "abc"), "2") == 0);
+
+        xartree_free_apply(&tree, xartree_test_map_free_value, NULL);
+    }
+
+    /* node grows and shrinks */
+    /* xartree_remove */
+    /* xartree_map */
+    {
+        XARTree_PT tree = xartree_new();
+        char *keys[300];
+
+        for (int i = 0; i < 300; ++i) {
+            keys[i] = XMEM_CALLOC(1, 32);
+            sprintf(keys[i], "prefix_common_path_%c%d", (char)(1 + (i * 7) % 255), i / 255);
+            xassert(xartree_put_unique(tree, keys[i], keys[i]));
+        }
+        xassert(xartree_size(tree) == 300);
+        xassert(tree->root->type == XARTREE_NODE256);
+
+        for (int i = 0; i < 300; ++i) {
+            xassert(xartree_get(tree, keys[i]) == keys[i]);
+        }
+
+        {
+            char *last = NULL;
+            xassert(xartree_map(tree, xartree_test_map_in_order, &last) == 300);
+        }
+
+        for (int i = 0; i < 290; ++i) {
+            void *value = NULL;
+            xassert(xartree_remove_save(tree, keys[i], &value));
+            xassert(value == keys[i]);
+            xassert(!xartree_remove(tree, keys[i]));
+            xassert(!xartree_find(tree, keys[i]));
+
+            for (int j = i + 1; j < 300; j += 17) {
+                xassert(xartree_get(tree, keys[j]) == keys[j]);
+            }
+        }
+        xassert(xartree_size(tree) == 10);
+
+        {
+            char *last = NULL;
+            xassert(xartree_map(tree, xartree_test_map_in_order, &last) == 10);
+        }
+
+        for (int i = 0; i < 290; ++i) {
+            XMEM_FREE(keys[i]);
+        }
+        xartree_free(&tree);
+        for (int i = 290; i < 300; ++i) {
+            XMEM_FREE(keys[i]);
+        }
+    }
+
+    /* xartree_remove */
+    {
+        XARTree_PT tree = xartree_new();
+
+        xartree_put_unique(tree, "abcdefghijklmnopqrstuvwxyz1", NULL);
+        xartree_put_unique(tree, "abcdefghijklmnopqrstuvwxyz2", NULL);
+        xartree_put_unique(tree, "abcdefghijklmnopq", NULL);
+        xartree_put_unique(tree, "abc", NULL);
+
+        xassert(xartree_remove(tree, "abcdefghijklmnopq"));
+        xassert(xartree_find(tree, "abcdefghijklmnopqrstuvwxyz1"));
+        xassert(xartree_find(tree, "abcdefghijklmnopqrstuvwxyz2"));
+        xassert(xartree_remove(tree, "abc"));
+        xassert(xartree_remove(tree, "abcdefghijklmnopqrstuvwxyz1"));
+        xassert(xartree_find(tree, "abcdefghijklmnopqrstuvwxyz2"));
+        xassert(xartree_remove(tree, "abcdefghijklmnopqrstuvwxyz2"));
+        xassert(xartree_is_empty(tree));
+        xassert(!tree->root);
+
+        xartree_free(&tree);
+    }
+
+    /* xartree_min */
+    /* xartree_max */
+    /* xartree_floor */
+    /* xartree_ceiling */
+    {
+        XARTree_PT tree = xartree_new();
+
+        xassert(!xartree_min(tree));
+        xassert(!xartree_max(tree));
+        xassert(!xartree_floor(tree, "a"));
+        xassert(!xartree_ceiling(tree, "a"));
+
+        xartree_put_unique(tree, "b", NULL);
+        xartree_put_unique(tree, "bcd", NULL);
+        xartree_put_unique(tree, "bcf", NULL);
+        xartree_put_unique(tree, "d", NULL);
+        xartree_put_unique(tree, "dddddddddddddddddddddd", NULL);
+
+        xassert(strcmp(xartree_min(tree), "b") == 0);
+        xassert(strcmp(xartree_max(tree), "dddddddddddddddddddddd") == 0);
+
+        xassert(!xartree_floor(tree, "a"));
+        xassert(strcmp(xartree_floor(tree, "b"), "b") == 0);
+        xassert(strcmp(xartree_floor(tree, "bc"), "b") == 0);
+        xassert(strcmp(xartree_floor(tree, "bce"), "bcd") == 0);
+        xassert(strcmp(xartree_floor(tree, "bcz"), "bcf") == 0);
+        xassert(strcmp(xartree_floor(tree, "c"), "bcf") == 0);
+        xassert(strcmp(xartree_floor(tree, "ddd"), "d") == 0);
+        xassert(strcmp(xartree_floor(tree, "e"), "dddddddddddddddddddddd") == 0);
+
+        xassert(strcmp(xartree_ceiling(tree, "a"), "b") == 0);
+        xassert(strcmp(xartree_ceiling(tree, "b"), "b") == 0);
+        xassert(strcmp(xartree_ceiling(tree, "bc"), "bcd") == 0);
+        xassert(strcmp(xartree_ceiling(tree, "bce"), "bcf") == 0);
+        xassert(strcmp(xartree_ceiling(tree, "bcz"), "d") == 0);
+        xassert(strcmp(xartree_ceiling(tree, "ddd"), "dddddddddddddddddddddd") == 0);
+        xassert(!xartree_ceiling(tree, "e"));
+
+        xartree_free(&tree);
+    }
+
+    /* xartree_prefix_map */
+    /* xartree_map_break_if_true */
+    /* xartree_map_break_if_false */
+    {
+        XARTree_PT tree = xartree_new();
+
+        xartree_put_unique(tree, "app", NULL);
+        xartree_put_unique(tree, "apple", NULL);
+        xartree_put_unique(tree, "application", NULL);
+        xartree_put_unique(tree, "applications", NULL);
+        xartree_put_unique(tree, "banana", NULL);
+
+        xassert(xartree_prefix_map(tree, "", xartree_test_map_applykv_true, NULL) == 5);
+        xassert(xartree_prefix_map(tree, "a", xartree_test_map_applykv_true, NULL) == 4);
+        xassert(xartree_prefix_map(tree, "app", xartree_test_map_applykv_true, NULL) == 4);
+        xassert(xartree_prefix_map(tree, "appl", xartree_test_map_applykv_true, NULL) == 3);
+        xassert(xartree_prefix_map(tree, "applic", xartree_test_map_applykv_true, NULL) == 2);
+        xassert(xartree_prefix_map(tree, "applications", xartree_test_map_applykv_true, NULL) == 1);
+        xassert(xartree_prefix_map(tree, "applicationsx", xartree_test_map_applykv_true, NULL) == 0);
+        xassert(xartree_prefix_map(tree, "b", xartree_test_map_applykv_true, NULL) == 1);
+        xassert(xartree_prefix_map(tree, "c", xartree_test_map_applykv_true, NULL) == 0);
+
+        xassert(xartree_prefix_map_break_if_true(tree, "app", xartree_test_map_cmpkv, "application"));
+        xassert(!xartree_prefix_map_break_if_true(tree, "app", xartree_test_map_cmpkv, "banana"));
+
+        xassert(xartree_map_break_if_true(tree, xartree_test_map_cmpkv, "banana"));
+        xassert(!xartree_map_break_if_true(tree, xartree_test_map_cmpkv, "ban"));
+        xassert(xartree_map_break_if_false(tree, xartree_test_map_cmpkv, "app"));
+        xassert(!xartree_map_break_if_false(tree, xartree_test_map_applykv_true, NULL));
+
+        xartree_free(&tree);
+    }
+
+    /* xartree_copy */
+    /* xartree_deep_copy */
+    /* xartree_swap */
+    {
+        XARTree_PT tree = xartree_new();
+        XARTree_PT tree2 = xartree_new();
+
+        for (int i = 0; i < 100; ++i) {
+            char key[16];
+            sprintf(key, "key%d", i);
+            xartree_put_unique(tree, xutils_deep_copy(key, (int)strlen(key) + 1), xutils_deep_copy(&i, sizeof(int)));
+        }
+
+        {
+            XARTree_PT ntree = xartree_copy(tree);
+            xassert(xartree_size(ntree) == 100);
+            xassert(xartree_get(ntree, "key50") == xartree_get(tree, "key50"));
+            xartree_free(&ntree);
+        }
+
+        {
+            XARTree_PT ntree = xartree_deep_copy(tree, sizeof(int));
+            xassert(xartree_size(ntree) == 100);
+            xassert(xartree_get(ntree, "key50") != xartree_get(tree, "key50"));
+            xassert(*(int*)xartree_get(ntree, "key50") == 50);
+            xassert(strcmp(xartree_min(ntree), "key0") == 0);
+            xassert(strcmp(xartree_max(ntree), "key99") == 0);
+
+            xassert(xartree_deep_remove(ntree, "key50"));
+            xassert(!xartree_find(ntree, "key50"));
+            xassert(xartree_find(tree, "key50"));
+
+            xassert(xartree_swap(ntree, tree2));
+            xassert(xartree_is_empty(ntree));
+            xassert(xartree_size(tree2) == 99);
+            xartree_free(&ntree);
+        }
+
+        xartree_deep_free(&tree);
+        xartree_deep_free(&tree2);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
@@ -2848,6 +2848,164 @@ void test_xavltree() {
     {
     }
 
+    /* xavltree_build_sorted */
+    {
+        char strs[1000][8];
+        void *keys[1000];
+
+        for (int i = 0; i < 1000; ++i) {
+            sprintf(strs[i], "%04d", i);
+            keys[i] = strs[i];
+        }
+
+        {
+            XAVLTree_PT tree = xavltree_new(test_cmpk, NULL);
+            xassert(xavltree_build_sorted(tree, keys, keys, 0));
+            xassert(xavltree_is_empty(tree));
+            xavltree_free(&tree);
+        }
+
+        for (int count = 1; count <= 64; ++count) {
+            XAVLTree_PT tree = xavltree_new(test_cmpk, NULL);
+            xassert(xavltree_build_sorted(tree, keys, keys, count));
+            xassert(xavltree_size(tree) == count);
+            xassert(xavltree_is_avltree(tree));
+            xavltree_free(&tree);
+        }
+
+        {
+            XAVLTree_PT tree = xavltree_new(test_cmpk, NULL);
+            xassert(xavltree_build_sorted(tree, keys, keys, 1000));
+            xassert(xavltree_size(tree) == 1000);
+            xassert(xavltree_is_avltree(tree));
+
+            for (int i = 0; i < 1000; ++i) {
+                xassert(xavltree_select(tree, i) == keys[i]);
+                xassert(xavltree_rank(tree, keys[i]) == i);
+            }
+            xassert(xavltree_get(tree, "0500") == keys[500]);
+
+            /* the tree works as usual after building */
+            xassert(xavltree_put_unique(tree, "1000", NULL));
+            xavltree_remove(tree, "0500");
+            xassert(xavltree_size(tree) == 1000);
+            xassert(xavltree_is_avltree(tree));
+
+            /* tree is not empty */
+            {
+                bool except = false;
+
+                XEXCEPT_TRY
+                    xavltree_build_sorted(tree, keys, keys, 1000);
+                XEXCEPT_ELSE
+                    except = true;
+                XEXCEPT_END_TRY
+
+                xassert(except);
+            }
+
+            xavltree_free(&tree);
+        }
+
+        /* keys are not sorted */
+        {
+            XAVLTree_PT tree = xavltree_new(test_cmpk, NULL);
+            void *tkeys[3] = { "1", "3", "2" };
+            xassert_false(xavltree_build_sorted(tree, tkeys, NULL, 3));
+            xassert(xavltree_is_empty(tree));
+            xavltree_free(&tree);
+        }
+    }
+
+    /* xavltree_cursor_init */
+    /* xavltree_cursor_first */
+    /* xavltree_cursor_last */
+    /* xavltree_cursor_seek */
+    /* xavltree_cursor_next */
+    /* xavltree_cursor_prev */
+    {
+        char strs[200][8];
+        XAVLTree_PT tree = xavltree_new(test_cmpk, NULL);
+        XAVLTree_Cursor_T cursor;
+
+        xavltree_cursor_init(&cursor, tree);
+        xassert_false(xavltree_cursor_valid(&cursor));
+        xassert_false(xavltree_cursor_first(&cursor));
+        xassert_false(xavltree_cursor_last(&cursor));
+        xassert_false(xavltree_cursor_seek(&cursor, "0000"));
+        xassert_false(xavltree_cursor_next(&cursor));
+        xassert(!xavltree_cursor_key(&cursor));
+
+        /* "0000" "0000" "0002" "0002" ... "0198" "0198" */
+        for (int i = 0; i < 200; ++i) {
+            sprintf(strs[i], "%04d", i / 2 * 2);
+            xavltree_put_repeat(tree, strs[i], strs[i]);
+        }
+
+        {
+            int count = 0;
+            char *last = NULL;
+            for (bool ok = xavltree_cursor_first(&cursor); ok; ok = xavltree_cursor_next(&cursor)) {
+                xassert(!last || (strcmp(last, xavltree_cursor_key(&cursor)) <= 0));
+                xassert(xavltree_cursor_key(&cursor) == xavltree_cursor_value(&cursor));
+                last = xavltree_cursor_key(&cursor);
+                ++count;
+            }
+            xassert(count == 200);
+            xassert_false(xavltree_cursor_valid(&cursor));
+        }
+
+        {
+            int count = 0;
+            for (bool ok = xavltree_cursor_last(&cursor); ok; ok = xavltree_cursor_prev(&cursor)) {
+                ++count;
+            }
+            xassert(count == 200);
+        }
+
+        /* seek to the first one of the "repeat" keys */
+        xassert(xavltree_cursor_seek(&cursor, "0100"));
+        xassert(strcmp(xavltree_cursor_key(&cursor), "0100") == 0);
+        xassert(xavltree_cursor_prev(&cursor));
+        xassert(strcmp(xavltree_cursor_key(&cursor), "0098") == 0);
+
+        /* seek to the next key if not found */
+        xassert(xavltree_cursor_seek(&cursor, "0101"));
+        xassert(strcmp(xavltree_cursor_key(&cursor), "0102") == 0);
+        xassert(xavltree_cursor_next(&cursor));
+        xassert(xavltree_cursor_next(&cursor));
+        xassert(strcmp(xavltree_cursor_key(&cursor), "0104") == 0);
+
+        xassert_false(xavltree_cursor_seek(&cursor, "0199"));
+
+        /* two cursors can be interleaved : merge join with itself */
+        {
+            XAVLTree_Cursor_T cursor2;
+            int count = 0;
+
+            xavltree_cursor_init(&cursor2, tree);
+            xavltree_cursor_first(&cursor);
+            xavltree_cursor_seek(&cursor2, "0100");
+            while (xavltree_cursor_valid(&cursor) && xavltree_cursor_valid(&cursor2)) {
+                int ret = strcmp(xavltree_cursor_key(&cursor), xavltree_cursor_key(&cursor2));
+                if (ret < 0) {
+                    xavltree_cursor_next(&cursor);
+                }
+                else if (0 < ret) {
+                    xavltree_cursor_next(&cursor2);
+                }
+                else {
+                    ++count;
+                    xavltree_cursor_next(&cursor);
+                    xavltree_cursor_next(&cursor2);
+                }
+            }
+            xassert(count == 100);
+        }
+
+        xavltree_free(&tree);
+    }
+
     {
         int count = 0;
         xmem_leak(check_mem_leak, &count);
@@ -0,0 +1,541 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "../utils/xutils.h"
+#include "../tree_bplus/xtree_bplus_x.h"
+#include "../include/xalgos.h"
+
+static
+int test_cmpi(void *key1, void *key2, void *cl) {
+    return *(int*)key1 - *(int*)key2;
+}
+
+static
+bool xbptree_test_map_applykv_true(void *key, void **value, void *cl) {
+    return true;
+}
+
+static
+bool xbptree_test_map_cmpkv(void *key, void **value, void *cl) {
+    return *(int*)key == *(int*)cl;
+}
+
+/* keys must be visited in order, cl saves the last key */
+static
+bool xbptree_test_map_ascending(void *key, void **value, void *cl) {
+    int **last = (int**)cl;
+    xassert(!*last || (**last <= *(int*)key));
+    *last = (int*)key;
+    return true;
+}
+
+static
+bool xbptree_test_map_descending(void *key, void **value, void *cl) {
+    int **last = (int**)cl;
+    xassert(!*last || (*(int*)key <= **last));
+    *last = (int*)key;
+    return true;
+}
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xbptree() {
+    enum { TEST_N = 3000 };
+
+    static int keys[TEST_N];
+    for (int i = 0; i < TEST_N; ++i) {
+        keys[i] = i;
+    }
+
+    /* xbptree_new */
+    {
+        /* cmp == NULL */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xbptree_new(NULL, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+        xassert(tree);
+        xassert(tree->root == NULL);
+        xassert(xbptree_is_empty(tree));
+        xassert(xbptree_height(tree) == 0);
+        xassert(xbptree_is_bptree(tree));
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_put_unique */
+    /* xbptree_get */
+    /* xbptree_select */
+    /* xbptree_rank */
+    /* xbptree_remove */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+
+        /* put in a shuffled order */
+        for (int i = 0; i < TEST_N; ++i) {
+            int k = (int)(((long)i * 1237) % TEST_N);
+            xassert(xbptree_put_unique(tree, &keys[k], &keys[k]));
+        }
+        xassert(xbptree_size(tree) == TEST_N);
+        xassert(xbptree_is_bptree(tree));
+        xassert(1 < xbptree_height(tree));
+
+        /* the same key will not be saved again */
+        xassert(xbptree_put_unique(tree, &keys[5], NULL));
+        xassert(xbptree_size(tree) == TEST_N);
+        xassert(xbptree_get(tree, &keys[5]) == &keys[5]);
+
+        for (int i = 0; i < TEST_N; ++i) {
+            xassert(xbptree_get(tree, &keys[i]) == &keys[i]);
+            xassert(*(int*)xbptree_select(tree, i) == i);
+            xassert(xbptree_rank(tree, &keys[i]) == i);
+        }
+
+        {
+            int key = TEST_N;
+            xassert(!xbptree_find(tree, &key));
+            xassert(xbptree_rank(tree, &key) == -1);
+        }
+
+        xassert(*(int*)xbptree_min(tree) == 0);
+        xassert(*(int*)xbptree_max(tree) == TEST_N - 1);
+
+        /* remove the odd ones, then the even ones */
+        for (int i = 1; i < TEST_N; i += 2) {
+            xassert(xbptree_remove(tree, &keys[i]) == 1);
+            xassert(xbptree_remove(tree, &keys[i]) == 0);
+        }
+        xassert(xbptree_size(tree) == TEST_N / 2);
+        xassert(xbptree_is_bptree(tree));
+
+        for (int i = 0; i < TEST_N / 2; ++i) {
+            xassert(*(int*)xbptree_select(tree, i) == 2 * i);
+            xassert(xbptree_rank(tree, &keys[2 * i]) == i);
+        }
+
+        for (int i = TEST_N - 2; 0 <= i; i -= 2) {
+            xassert(xbptree_remove(tree, &keys[i]) == 1);
+            if (i % 128 == 0) {
+                xassert(xbptree_is_bptree(tree));
+            }
+        }
+        xassert(xbptree_is_empty(tree));
+        xassert(xbptree_is_bptree(tree));
+
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_put_repeat */
+    /* xbptree_keys_size */
+    /* xbptree_remove_min */
+    /* xbptree_remove_max */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+
+        /* 100 "repeat" keys will cross several leaves */
+        for (int i = 0; i < 100; ++i) {
+            xassert(xbptree_put_repeat(tree, &keys[1], NULL));
+            xassert(xbptree_put_repeat(tree, &keys[i % 3], NULL));
+        }
+        xassert(xbptree_size(tree) == 200);
+        xassert(xbptree_is_bptree(tree));
+
+        xassert(xbptree_rank(tree, &keys[0]) == 0);
+        xassert(xbptree_rank(tree, &keys[1]) == 34);
+        xassert(xbptree_rank(tree, &keys[2]) == 34 + 133);
+        xassert(xbptree_keys_size(tree, &keys[1], &keys[1]) == 133);
+        xassert(xbptree_keys_size(tree, &keys[0], &keys[2]) == 200);
+        xassert(xbptree_keys_size(tree, &keys[3], &keys[9]) == 0);
+
+        for (int i = 0; i < 133; ++i) {
+            xassert(xbptree_remove(tree, &keys[1]) == 1);
+        }
+        xassert(!xbptree_find(tree, &keys[1]));
+        xassert(xbptree_size(tree) == 67);
+        xassert(xbptree_is_bptree(tree));
+
+        xbptree_remove_min(tree);
+        xbptree_remove_max(tree);
+        xassert(xbptree_keys_size(tree, &keys[0], &keys[0]) == 33);
+        xassert(xbptree_keys_size(tree, &keys[2], &keys[2]) == 32);
+
+        {
+            void *key = NULL;
+            xbptree_remove_save_max(tree, &key, NULL);
+            xassert(key == &keys[2]);
+            xbptree_remove_save_min(tree, &key, NULL);
+            xassert(key == &keys[0]);
+        }
+        xassert(xbptree_is_bptree(tree));
+
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_put_replace */
+    /* xbptree_find_replace */
+    /* xbptree_index_replace */
+    /* xbptree_remove_save */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+        void *old_value = NULL;
+
+        for (int i = 0; i < 200; ++i) {
+            xassert(xbptree_put_replace(tree, &keys[i], &keys[0], NULL));
+        }
+
+        xassert(xbptree_put_replace(tree, &keys[64], &keys[1], &old_value));
+        xassert(old_value == &keys[0]);
+        xassert(xbptree_get(tree, &keys[64]) == &keys[1]);
+        xassert(xbptree_size(tree) == 200);
+
+        xassert(xbptree_find_replace(tree, &keys[65], &keys[2], &old_value));
+        xassert(old_value == &keys[0]);
+        xassert(!xbptree_find_replace(tree, &keys[300], &keys[2], &old_value));
+
+        xassert(xbptree_index_replace(tree, 66, &keys[3], &old_value));
+        xassert(xbptree_get(tree, &keys[66]) == &keys[3]);
+
+        xassert(xbptree_remove_save(tree, &keys[65], &old_value) == 1);
+        xassert(old_value == &keys[2]);
+        xassert(xbptree_is_bptree(tree));
+
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_floor */
+    /* xbptree_ceiling */
+    /* xbptree_keys */
+    /* xbptree_scope_map_min_to_max */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+
+        for (int i = 0; i < TEST_N; i += 10) {
+            xbptree_put_unique(tree, &keys[i], NULL);
+        }
+
+        xassert(*(int*)xbptree_floor(tree, &keys[0]) == 0);
+        xassert(*(int*)xbptree_floor(tree, &keys[15]) == 10);
+        xassert(*(int*)xbptree_floor(tree, &keys[20]) == 20);
+        xassert(*(int*)xbptree_floor(tree, &keys[TEST_N - 1]) == TEST_N - 10);
+        xassert(*(int*)xbptree_ceiling(tree, &keys[15]) == 20);
+        xassert(*(int*)xbptree_ceiling(tree, &keys[20]) == 20);
+        xassert(!xbptree_ceiling(tree, &keys[TEST_N - 1]));
+
+        {
+            int key = -1;
+            xassert(!xbptree_floor(tree, &key));
+            xassert(*(int*)xbptree_ceiling(tree, &key) == 0);
+        }
+
+        {
+            XSList_PT list = xbptree_keys(tree, &keys[1005], &keys[95]);
+            xassert(xslist_size(list) == 91);
+            xassert(*(int*)xslist_front(list) == 100);
+            xassert(*(int*)xslist_back(list) == 1000);
+            xslist_free(&list);
+        }
+
+        xassert(xbptree_scope_map_min_to_max(tree, &keys[95], &keys[1005], xbptree_test_map_applykv_true, NULL) == 91);
+        xassert(xbptree_scope_map_min_to_max_break_if_true(tree, &keys[95], &keys[1005], xbptree_test_map_cmpkv, &keys[500]));
+        xassert(!xbptree_scope_map_min_to_max_break_if_true(tree, &keys[95], &keys[1005], xbptree_test_map_cmpkv, &keys[1010]));
+        xassert(xbptree_keys_size(tree, &keys[95], &keys[1005]) == 91);
+
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_map_min_to_max */
+    /* xbptree_map_max_to_min */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+
+        for (int i = 0; i < TEST_N; ++i) {
+            int k = (int)(((long)i * 7919) % TEST_N);
+            xbptree_put_repeat(tree, &keys[k / 2], NULL);
+        }
+
+        {
+            int *last = NULL;
+            xassert(xbptree_map_min_to_max(tree, xbptree_test_map_ascending, &last) == TEST_N);
+        }
+        {
+            int *last = NULL;
+            xassert(xbptree_map_max_to_min(tree, xbptree_test_map_descending, &last) == TEST_N);
+        }
+
+        xassert(xbptree_map_min_to_max_break_if_true(tree, xbptree_test_map_cmpkv, &keys[100]));
+        xassert(!xbptree_map_min_to_max_break_if_false(tree, xbptree_test_map_applykv_true, NULL));
+        xassert(xbptree_map_max_to_min_break_if_false(tree, xbptree_test_map_cmpkv, &keys[0]));
+
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_copy */
+    /* xbptree_deep_copy */
+    /* xbptree_swap */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+        XBPTree_PT tree2 = xbptree_new(test_cmpi, NULL);
+
+        for (int i = 0; i < 500; ++i) {
+            xbptree_put_unique(tree, xutils_deep_copy(&keys[i], sizeof(int)), xutils_deep_copy(&keys[i], sizeof(int)));
+        }
+
+        {
+            XBPTree_PT ntree = xbptree_copy(tree);
+            xassert(xbptree_is_bptree(ntree));
+            xassert(xbptree_get(ntree, &keys[50]) == xbptree_get(tree, &keys[50]));
+            xbptree_free(&ntree);
+        }
+
+        {
+            XBPTree_PT ntree = xbptree_deep_copy(tree, sizeof(int), sizeof(int));
+            xassert(xbptree_is_bptree(ntree));
+            xassert(xbptree_size(ntree) == 500);
+            xassert(xbptree_get(ntree, &keys[50]) != xbptree_get(tree, &keys[50]));
+            xassert(*(int*)xbptree_get(ntree, &keys[50]) == 50);
+
+            xassert(xbptree_deep_remove(ntree, &keys[50]) == 1);
+            xbptree_deep_remove_min(ntree);
+            xbptree_deep_remove_max(ntree);
+            xassert(xbptree_size(ntree) == 497);
+            xassert(xbptree_is_bptree(ntree));
+
+            xassert(xbptree_swap(ntree, tree2));
+            xassert(xbptree_is_empty(ntree));
+            xassert(xbptree_size(tree2) == 497);
+            xbptree_free(&ntree);
+        }
+
+        xbptree_deep_free(&tree);
+        xbptree_deep_free(&tree2);
+    }
+
+    /* xbptree_build_sorted */
+    /* xbptree_build_sorted_parray */
+    {
+        static void *pkeys[TEST_N];
+        for (int i = 0; i < TEST_N; ++i) {
+            pkeys[i] = &keys[i];
+        }
+
+        for (int count = 0; count <= 2 * XBPTREE_MAX_KEYS + 3; ++count) {
+            XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+            xassert(xbptree_build_sorted(tree, pkeys, pkeys, count));
+            xassert(xbptree_size(tree) == count);
+            xassert(xbptree_is_bptree(tree));
+            xbptree_free(&tree);
+        }
+
+        {
+            XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+            xassert(xbptree_build_sorted(tree, pkeys, pkeys, TEST_N));
+            xassert(xbptree_size(tree) == TEST_N);
+            xassert(xbptree_is_bptree(tree));
+
+            for (int i = 0; i < TEST_N; ++i) {
+                xassert(xbptree_get(tree, &keys[i]) == &keys[i]);
+                xassert(xbptree_select(tree, i) == &keys[i]);
+                xassert(xbptree_rank(tree, &keys[i]) == i);
+            }
+
+            /* the tree works as usual after building */
+            for (int i = 0; i < TEST_N; i += 2) {
+                xassert(xbptree_remove(tree, &keys[i]) == 1);
+            }
+            xassert(xbptree_put_repeat(tree, &keys[1], NULL));
+            xassert(xbptree_size(tree) == TEST_N / 2 + 1);
+            xassert(xbptree_is_bptree(tree));
+
+            /* tree is not empty */
+            {
+                bool except = false;
+
+                XEXCEPT_TRY
+                    xbptree_build_sorted(tree, pkeys, pkeys, TEST_N);
+                XEXCEPT_ELSE
+                    except = true;
+                XEXCEPT_END_TRY
+
+                xassert(except);
+            }
+
+            xbptree_free(&tree);
+        }
+
+        /* repeat keys */
+        {
+            XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+            void *tkeys[100];
+            for (int i = 0; i < 100; ++i) {
+                tkeys[i] = &keys[i / 10];
+            }
+            xassert(xbptree_build_sorted(tree, tkeys, NULL, 100));
+            xassert(xbptree_size(tree) == 100);
+            xassert(xbptree_is_bptree(tree));
+            xassert(xbptree_rank(tree, &keys[5]) == 50);
+            xbptree_free(&tree);
+        }
+
+        /* keys are not sorted */
+        {
+            XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+            void *tkeys[3] = { &keys[1], &keys[3], &keys[2] };
+            xassert_false(xbptree_build_sorted(tree, tkeys, NULL, 3));
+            xassert(xbptree_is_empty(tree));
+            xbptree_free(&tree);
+        }
+
+        {
+            XPArray_PT array = xparray_new(TEST_N);
+            XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+
+            for (int i = 0; i < TEST_N; ++i) {
+                xparray_put(array, i, pkeys[i], NULL);
+            }
+
+            xassert(xbptree_build_sorted_parray(tree, array, array));
+            xassert(xbptree_size(tree) == TEST_N);
+            xassert(xbptree_is_bptree(tree));
+            xassert(xbptree_get(tree, &keys[7]) == &keys[7]);
+
+            xbptree_free(&tree);
+            xparray_free(&array);
+        }
+    }
+
+    /* xbptree_cursor_init */
+    /* xbptree_cursor_first */
+    /* xbptree_cursor_last */
+    /* xbptree_cursor_seek */
+    /* xbptree_cursor_next */
+    /* xbptree_cursor_prev */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+        XBPTree_Cursor_T cursor;
+
+        xbptree_cursor_init(&cursor, tree);
+        xassert_false(xbptree_cursor_valid(&cursor));
+        xassert_false(xbptree_cursor_first(&cursor));
+        xassert_false(xbptree_cursor_last(&cursor));
+        xassert_false(xbptree_cursor_seek(&cursor, &keys[0]));
+        xassert_false(xbptree_cursor_prev(&cursor));
+        xassert(!xbptree_cursor_value(&cursor));
+
+        /* even keys, "repeat" key 100 crosses several leaves */
+        for (int i = 0; i < TEST_N; i += 2) {
+            xassert(xbptree_put_repeat(tree, &keys[i], &keys[i]));
+        }
+        for (int i = 0; i < 3 * XBPTREE_MAX_KEYS; ++i) {
+            xassert(xbptree_put_repeat(tree, &keys[100], NULL));
+        }
+
+        {
+            int count = 0;
+            int last = -1;
+            for (bool ok = xbptree_cursor_first(&cursor); ok; ok = xbptree_cursor_next(&cursor)) {
+                xassert(last <= *(int*)xbptree_cursor_key(&cursor));
+                last = *(int*)xbptree_cursor_key(&cursor);
+                ++count;
+            }
+            xassert(count == xbptree_size(tree));
+        }
+
+        {
+            int count = 0;
+            int last = TEST_N;
+            for (bool ok = xbptree_cursor_last(&cursor); ok; ok = xbptree_cursor_prev(&cursor)) {
+                xassert(*(int*)xbptree_cursor_key(&cursor) <= last);
+                last = *(int*)xbptree_cursor_key(&cursor);
+                ++count;
+            }
+            xassert(count == xbptree_size(tree));
+        }
+
+        /* seek to the first one of the "repeat" keys */
+        xassert(xbptree_cursor_seek(&cursor, &keys[100]));
+        xassert(xbptree_cursor_prev(&cursor));
+        xassert(*(int*)xbptree_cursor_key(&cursor) == 98);
+
+        /* seek to the next key if not found */
+        xassert(xbptree_cursor_seek(&cursor, &keys[1001]));
+        xassert(xbptree_cursor_value(&cursor) == &keys[1002]);
+        xassert(xbptree_cursor_next(&cursor));
+        xassert(xbptree_cursor_value(&cursor) == &keys[1004]);
+
+        xassert_false(xbptree_cursor_seek(&cursor, &keys[TEST_N - 1]));
+
+        xbptree_free(&tree);
+    }
+
+    /* xbptree_split */
+    /* xbptree_remove_range */
+    {
+        XBPTree_PT tree = xbptree_new(test_cmpi, NULL);
+
+        /* 0 0 2 2 4 4 ... */
+        for (int i = 0; i < TEST_N; ++i) {
+            int k = (int)(((long)i * 1237) % TEST_N);
+            xassert(xbptree_put_repeat(tree, &keys[k / 2 * 2], &keys[k]));
+        }
+
+        for (int i = 0; i <= TEST_N; i += 97) {
+            XBPTree_PT tree1 = xbptree_copy(tree);
+            XBPTree_PT tree2 = (i < TEST_N) ? xbptree_split(tree1, &keys[i]) : xbptree_split(tree1, &keys[TEST_N - 1]);
+
+            xassert(xbptree_is_bptree(tree1));
+            xassert(xbptree_is_bptree(tree2));
+            xassert(xbptree_size(tree1) == ((i < TEST_N) ? (i + 1) / 2 * 2 : TEST_N));
+            xassert(xbptree_size(tree1) + xbptree_size(tree2) == TEST_N);
+
+            xbptree_free(&tree1);
+            xbptree_free(&tree2);
+        }
+
+        /* small ranges are removed one by one, large ones make the tree rebuilt */
+        for (int i = 0; i < TEST_N; i += 331) {
+            for (int w = 0; w < TEST_N; w = w * 3 + 7) {
+                int j = (i + w < TEST_N) ? (i + w) : (TEST_N - 1);
+                XBPTree_PT tree1 = xbptree_copy(tree);
+                XBPTree_PT tree2 = xbptree_remove_range(tree1, &keys[j], &keys[i]);
+
+                xassert(xbptree_is_bptree(tree1));
+                xassert(xbptree_is_bptree(tree2));
+                xassert(xbptree_size(tree2) == (j / 2 - (i + 1) / 2 + 1) * 2);
+                xassert(xbptree_size(tree1) + xbptree_size(tree2) == TEST_N);
+                xassert(xbptree_is_empty(tree2) || ((i <= *(int*)xbptree_min(tree2)) && (*(int*)xbptree_max(tree2) <= j)));
+                xassert(xbptree_keys_size(tree1, &keys[i], &keys[j]) == 0);
+
+                /* the trees work as usual */
+                xassert(xbptree_put_repeat(tree1, &keys[i], NULL));
+                xassert(xbptree_put_repeat(tree2, &keys[i], NULL));
+                xassert(xbptree_is_bptree(tree1));
+                xassert(xbptree_is_bptree(tree2));
+
+                xbptree_free(&tree1);
+                xbptree_free(&tree2);
+            }
+        }
+
+        xbptree_free(&tree);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
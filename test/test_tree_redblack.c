@@ -53,6 +53,15 @@ bool xrbtree_test_map_applyk(void *key, void *cl) {
     return true;
 }
 
+static
+int xrbtree_test_node_size(XRBTree_Node_PT node) {
+#ifndef XRBTREE_NO_SIZE
+    return node ? node->size : 0;
+#else
+    return node ? xrbtree_test_node_size(node->left) + xrbtree_test_node_size(node->right) + 1 : 0;
+#endif
+}
+
 static
 XRBTree_PT xrbtree_random_string(int(*cmp)(void *key1, void *key2, void *cl), void *cl, int total_size, int string_length) {
     xassert(cmp);
@@ -119,7 +128,7 @@ void xrbtree_print_impl(XRBTree_Node_PT node, int h) {
 
     xrbtree_print_impl(node->right, h + 3);
 
-    xrbtree_printnode((char*)node->key, (char*)node->value, node->color, h);
+    xrbtree_printnode((char*)node->key, (char*)node->value, xrbtree_node_color(node), h);
 
     xrbtree_print_impl(node->left, h + 3);
 }
@@ -141,6 +150,224 @@ void xrbtree_print(XRBTree_PT tree, int start_blank) {
     xrbtree_print_impl(tree->root, start_blank + 3);
 }
 
+/* the key number in [low, high] counted by cursor */
+static
+int xrbtree_test_range_size(XRBTree_PT tree, void *low, void *high) {
+    int count = 0;
+
+    XRBTree_Cursor_T cursor;
+    xrbtree_cursor_init(&cursor, tree);
+    for (bool ok = xrbtree_cursor_seek(&cursor, low); ok && (strcmp(xrbtree_cursor_key(&cursor), high) <= 0); ok = xrbtree_cursor_next(&cursor)) {
+        ++count;
+    }
+
+    return count;
+}
+
+/* interval tree : key is the low end, value is the high end */
+typedef struct {
+    int  max_high;
+    int  min_low;
+    long sum_low;
+} XRBTree_Test_Aux_T;
+
+typedef struct {
+    int  low;
+    int  high;
+} XRBTree_Test_Query_T;
+
+static
+int test_cmpi(void *key1, void *key2, void *cl) {
+    return *(int*)key1 - *(int*)key2;
+}
+
+static
+void xrbtree_test_augment(void *key, void *value, void *aux, void *left_aux, void *right_aux, void *cl) {
+    XRBTree_Test_Aux_T *node = (XRBTree_Test_Aux_T*)aux;
+
+    node->max_high = *(int*)value;
+    node->min_low = *(int*)key;
+    node->sum_low = *(int*)key;
+
+    if (left_aux) {
+        XRBTree_Test_Aux_T *left = (XRBTree_Test_Aux_T*)left_aux;
+        node->max_high = (node->max_high < left->max_high) ? left->max_high : node->max_high;
+        node->min_low = (left->min_low < node->min_low) ? left->min_low : node->min_low;
+        node->sum_low += left->sum_low;
+    }
+
+    if (right_aux) {
+        XRBTree_Test_Aux_T *right = (XRBTree_Test_Aux_T*)right_aux;
+        node->max_high = (node->max_high < right->max_high) ? right->max_high : node->max_high;
+        node->min_low = (right->min_low < node->min_low) ? right->min_low : node->min_low;
+        node->sum_low += right->sum_low;
+    }
+}
+
+static
+bool xrbtree_test_augment_enter(void *aux, void *cl) {
+    XRBTree_Test_Aux_T *summary = (XRBTree_Test_Aux_T*)aux;
+    XRBTree_Test_Query_T *query = (XRBTree_Test_Query_T*)cl;
+
+    return (query->low <= summary->max_high) && (summary->min_low <= query->high);
+}
+
+static
+bool xrbtree_test_augment_overlap(void *key, void *value, void *aux, void *cl) {
+    XRBTree_Test_Query_T *query = (XRBTree_Test_Query_T*)cl;
+    return (*(int*)key <= query->high) && (query->low <= *(int*)value);
+}
+
+static
+bool xrbtree_test_overlap(void *key, void **value, void *cl) {
+    XRBTree_Test_Query_T *query = (XRBTree_Test_Query_T*)cl;
+    return (*(int*)key <= query->high) && (query->low <= *(int*)*value);
+}
+
+/* check the summaries of all the subtrees, returns the size of the subtree */
+static
+int xrbtree_test_check_aux(XRBTree_Cursor_T cursor, XRBTree_Test_Aux_T *result) {
+    XRBTree_Test_Aux_T left_aux, right_aux;
+    XRBTree_Cursor_T left = cursor;
+    XRBTree_Cursor_T right = cursor;
+    int size = 1;
+
+    bool has_left = xrbtree_cursor_left(&left);
+    bool has_right = xrbtree_cursor_right(&right);
+
+    if (has_left) {
+        size += xrbtree_test_check_aux(left, &left_aux);
+    }
+    if (has_right) {
+        size += xrbtree_test_check_aux(right, &right_aux);
+    }
+
+    xrbtree_test_augment(xrbtree_cursor_key(&cursor), xrbtree_cursor_value(&cursor), result, (has_left ? &left_aux : NULL), (has_right ? &right_aux : NULL), NULL);
+
+    {
+        XRBTree_Test_Aux_T *aux = (XRBTree_Test_Aux_T*)xrbtree_cursor_aux(&cursor);
+        xassert(aux->max_high == result->max_high);
+        xassert(aux->min_low == result->min_low);
+        xassert(aux->sum_low == result->sum_low);
+    }
+
+    return size;
+}
+
+static
+bool xrbtree_test_augment_valid(XRBTree_PT tree) {
+    XRBTree_Test_Aux_T aux;
+    XRBTree_Cursor_T cursor;
+
+    xrbtree_cursor_init(&cursor, tree);
+    if (!xrbtree_cursor_root(&cursor)) {
+        return !xrbtree_aux(tree);
+    }
+
+    return xrbtree_is_rbtree(tree) && (xrbtree_test_check_aux(cursor, &aux) == xrbtree_size(tree));
+}
+
+/* the sum of the keys < key, walk down from the root */
+static
+long xrbtree_test_prefix_sum(XRBTree_PT tree, int key) {
+    long sum = 0;
+
+    XRBTree_Cursor_T cursor;
+    xrbtree_cursor_init(&cursor, tree);
+
+    for (bool ok = xrbtree_cursor_root(&cursor); ok; ) {
+        if (*(int*)xrbtree_cursor_key(&cursor) < key) {
+            XRBTree_Cursor_T left = cursor;
+            if (xrbtree_cursor_left(&left)) {
+                sum += ((XRBTree_Test_Aux_T*)xrbtree_cursor_aux(&left))->sum_low;
+            }
+
+            sum += *(int*)xrbtree_cursor_key(&cursor);
+            ok = xrbtree_cursor_right(&cursor);
+        }
+        else {
+            ok = xrbtree_cursor_left(&cursor);
+        }
+    }
+
+    return sum;
+}
+
+static
+void xrbtree_test_augment_queries(XRBTree_PT tree) {
+    xassert(xrbtree_test_augment_valid(tree));
+
+    for (int i = 0; i < 3000; i += 97) {
+        XRBTree_Test_Query_T query = { i, i + 50 };
+
+        /* the same result with the full scan */
+        xassert(xrbtree_augment_map_min_to_max(tree, xrbtree_test_augment_enter, xrbtree_test_augment_overlap, &query) == xrbtree_map_min_to_max(tree, xrbtree_test_overlap, &query));
+
+        {
+            long sum = 0;
+
+            XRBTree_Cursor_T cursor;
+            xrbtree_cursor_init(&cursor, tree);
+            for (bool ok = xrbtree_cursor_first(&cursor); ok && (*(int*)xrbtree_cursor_key(&cursor) < i); ok = xrbtree_cursor_next(&cursor)) {
+                sum += *(int*)xrbtree_cursor_key(&cursor);
+            }
+
+            xassert(xrbtree_test_prefix_sum(tree, i) == sum);
+        }
+    }
+}
+
+#if defined(__linux__) && !defined(XRBTREE_NO_SIZE)
+/* the keys accumulated by the ranges : sum of the values, and whether the keys are visited from min to max */
+typedef struct {
+    long sum;
+    int  first;
+    int  last;
+    int  count;
+    bool sorted;
+} XRBTree_Test_Reduce_T;
+
+static
+bool xrbtree_test_parallel_apply(void *key, void **value, void *cl) {
+    *(int*)(*value) *= 2;
+    return (*(int*)key % 2) == 0;
+}
+
+static
+void xrbtree_test_parallel_accumulate(void *acc, void *key, void *value, void *cl) {
+    XRBTree_Test_Reduce_T *result = (XRBTree_Test_Reduce_T*)acc;
+
+    if (result->count == 0) {
+        result->first = *(int*)key;
+    }
+    else if (*(int*)key <= result->last) {
+        result->sorted = false;
+    }
+
+    result->last = *(int*)key;
+    result->sum += *(int*)value;
+    ++result->count;
+}
+
+static
+void xrbtree_test_parallel_combine(void *result, void *acc, void *cl) {
+    XRBTree_Test_Reduce_T *total = (XRBTree_Test_Reduce_T*)result;
+    XRBTree_Test_Reduce_T *range = (XRBTree_Test_Reduce_T*)acc;
+
+    if (range->count == 0) {
+        return;
+    }
+
+    total->sorted = total->sorted && range->sorted && ((total->count == 0) || (total->last < range->first));
+    if (total->count == 0) {
+        total->first = range->first;
+    }
+    total->last = range->last;
+    total->sum += range->sum;
+    total->count += range->count;
+}
+#endif
+
 static
 void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
     (*(int*)cl) += 1;
@@ -243,9 +470,9 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 1);
-            xassert_false(tree->root->parent);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
+            xassert_false(xrbtree_node_parent(tree->root));
             xassert_false(tree->root->left);
             xassert_false(tree->root->right);
 
@@ -267,16 +494,16 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 2);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
             xassert_false(tree->root->right);
-            xassert_false(tree->root->parent);
+            xassert_false(xrbtree_node_parent(tree->root));
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "5") == 0);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->left)->key, "5") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
@@ -298,15 +525,15 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 2);
-            xassert_false(tree->root->parent);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
+            xassert_false(xrbtree_node_parent(tree->root));
             xassert_false(tree->root->left);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == false);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -331,23 +558,23 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "3") == 0);
             xassert(strcmp(tree->root->value, "3v") == 0);
-            xassert_false(tree->root->parent);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert_false(xrbtree_node_parent(tree->root));
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "3") == 0);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->left)->key, "3") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
             xassert(strcmp(tree->root->right->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
-            xassert(strcmp(tree->root->right->parent->key, "3") == 0);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->right)->key, "3") == 0);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -372,20 +599,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "4") == 0);
             xassert(strcmp(tree->root->value, "4v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
             xassert(strcmp(tree->root->right->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -410,23 +637,23 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "6") == 0);
             xassert(strcmp(tree->root->value, "6v") == 0);
-            xassert_false(tree->root->parent);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert_false(xrbtree_node_parent(tree->root));
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
             xassert(strcmp(tree->root->left->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "6") == 0);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->left)->key, "6") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
-            xassert(strcmp(tree->root->right->parent->key, "6") == 0);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->right)->key, "6") == 0);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -451,23 +678,23 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "8") == 0);
             xassert(strcmp(tree->root->value, "8v") == 0);
-            xassert_false(tree->root->parent);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert_false(xrbtree_node_parent(tree->root));
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
             xassert(strcmp(tree->root->left->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "8") == 0);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->left)->key, "8") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
-            xassert(strcmp(tree->root->right->parent->key, "8") == 0);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
+            xassert(strcmp(xrbtree_node_parent(tree->root->right)->key, "8") == 0);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -490,20 +717,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -529,26 +756,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
@@ -573,26 +800,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->left);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
             xassert(strcmp(tree->root->left->right->value, "4v") == 0);
-            xassert(tree->root->left->right->color == false);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
@@ -618,26 +845,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
             xassert(strcmp(tree->root->right->left->value, "6v") == 0);
-            xassert(tree->root->right->left->color == false);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
@@ -663,26 +890,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->left);
 
             xassert(strcmp(tree->root->right->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->right->value, "9v") == 0);
-            xassert(tree->root->right->right->color == false);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
 
@@ -711,32 +938,32 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "0") == 0);
             xassert(strcmp(tree->root->left->left->value, "0v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "3") == 0);
             xassert(strcmp(tree->root->left->right->value, "3v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
@@ -765,32 +992,32 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "15") == 0);
             xassert(strcmp(tree->root->left->value, "15v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "3") == 0);
             xassert(strcmp(tree->root->left->right->value, "3v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
@@ -819,30 +1046,30 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
 
             xassert(strcmp(tree->root->right->key, "7") == 0);
             xassert(strcmp(tree->root->right->value, "7v") == 0);
-            xassert(tree->root->right->color == false);
-            xassert(tree->root->right->size == 3);
+            xassert(xrbtree_node_color(tree->root->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right) == 3);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
             xassert(strcmp(tree->root->right->left->value, "6v") == 0);
-            xassert(tree->root->right->left->color == true);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->right->value, "8v") == 0);
-            xassert(tree->root->right->right->color == true);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
 
@@ -871,30 +1098,30 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
 
             xassert(strcmp(tree->root->right->key, "7") == 0);
             xassert(strcmp(tree->root->right->value, "7v") == 0);
-            xassert(tree->root->right->color == false);
-            xassert(tree->root->right->size == 3);
+            xassert(xrbtree_node_color(tree->root->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right) == 3);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
             xassert(strcmp(tree->root->right->left->value, "6v") == 0);
-            xassert(tree->root->right->left->color == true);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->right->value, "8v") == 0);
-            xassert(tree->root->right->right->color == true);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
 
@@ -921,32 +1148,32 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
             xassert(strcmp(tree->root->left->right->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
@@ -973,31 +1200,31 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
             xassert(strcmp(tree->root->right->left->value, "6v") == 0);
-            xassert(tree->root->right->left->color == false);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
@@ -1024,32 +1251,32 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 5);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->left);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->right->value, "9v") == 0);
-            xassert(tree->root->right->right->color == false);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
 
@@ -1085,44 +1312,44 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 7);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 7);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 3);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 3);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
             xassert(strcmp(tree->root->left->right->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
             xassert(strcmp(tree->root->right->left->value, "6v") == 0);
-            xassert(tree->root->right->left->color == true);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->right->value, "9v") == 0);
-            xassert(tree->root->right->right->color == true);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
 
@@ -1150,36 +1377,36 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "9") == 0);
             xassert(strcmp(tree->root->value, "9v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 6);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 6);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
             xassert(strcmp(tree->root->left->value, "5v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 4);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 4);
 
             xassert(strcmp(tree->root->right->key, "95") == 0);
             xassert(strcmp(tree->root->right->value, "95v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
 
             xassert(strcmp(tree->root->left->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->left->value, "3v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 2);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "8") == 0);
             xassert(strcmp(tree->root->left->right->value, "8v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->left->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->left->color == false);
-            xassert(tree->root->left->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left->left) == 1);
             xassert_false(tree->root->left->left->left->left);
             xassert_false(tree->root->left->left->left->right);
 
@@ -1198,44 +1425,44 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 7);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 7);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 3);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 3);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
             xassert(strcmp(tree->root->left->right->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "8") == 0);
             xassert(strcmp(tree->root->right->left->value, "8v") == 0);
-            xassert(tree->root->right->left->color == true);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "95") == 0);
             xassert(strcmp(tree->root->right->right->value, "95v") == 0);
-            xassert(tree->root->right->right->color == true);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
 
@@ -1392,6 +1619,7 @@ void test_xrbtree() {
         /* xrbtree_ceiling */
         xassert(strcmp(xrbtree_ceiling(tree, "s"), "t") == 0);
 
+#ifndef XRBTREE_NO_SIZE
         /* xrbtree_select */
         xassert(strcmp(xrbtree_select(tree, 0), "a") == 0);
         xassert(strcmp(xrbtree_select(tree, 5), "f") == 0);
@@ -1402,6 +1630,7 @@ void test_xrbtree() {
         xassert(xrbtree_rank(tree, "e") == 4);
         xassert(xrbtree_rank(tree, "m") == 12);
         xassert(xrbtree_rank(tree, "y") == 22);
+#endif
 
         /* xrbtree_get */
         xassert(strcmp(xrbtree_get(tree, "g"), "vg") == 0);
@@ -1467,7 +1696,7 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "d", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 1);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
             xassert(strcmp(tree->root->key, "h") == 0);
             xassert_false(tree->root->left);
 
@@ -1487,7 +1716,7 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "m", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 1);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
             xassert(strcmp(tree->root->key, "m") == 0);
             xassert_false(tree->root->right);
 
@@ -1508,9 +1737,9 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "m", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 2);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
             xassert_false(tree->root->left);
-            xassert_false(tree->root->right->color);
+            xassert_false(xrbtree_node_color(tree->root->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_min(tree);
@@ -1533,10 +1762,10 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "a", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 3);
-            xassert(tree->root->left->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
+            xassert(xrbtree_node_color(tree->root->left));
+            xassert(xrbtree_node_color(tree->root->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_min(tree);
@@ -1560,10 +1789,10 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "f", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 3);
-            xassert(tree->root->left->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
+            xassert(xrbtree_node_color(tree->root->left));
+            xassert(xrbtree_node_color(tree->root->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_min(tree);
@@ -1588,11 +1817,11 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "f", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 4);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->left);
-            xassert(tree->root->left->color);
-            xassert_false(tree->root->left->right->color);
+            xassert(xrbtree_node_color(tree->root->left));
+            xassert_false(xrbtree_node_color(tree->root->left->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_min(tree);
@@ -1621,12 +1850,12 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "a", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 5);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
             xassert(tree->root->left->left);
-            xassert_false(tree->root->left->color);
-            xassert(tree->root->left->left->color);
-            xassert(tree->root->left->right->color);
+            xassert_false(xrbtree_node_color(tree->root->left));
+            xassert(xrbtree_node_color(tree->root->left->left));
+            xassert(xrbtree_node_color(tree->root->left->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_min(tree);
@@ -1665,12 +1894,12 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "p", NULL);
             xrbtree_remove_min(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 14);
-            xassert(tree->root->left->size == 6);
-            xassert(tree->root->left->left->color);
-            xassert_false(tree->root->right->color);
-            xassert_false(tree->root->left->left->right->color);
-            xassert_false(tree->root->left->right->color);
+            xassert(xrbtree_test_node_size(tree->root) == 14);
+            xassert(xrbtree_test_node_size(tree->root->left) == 6);
+            xassert(xrbtree_node_color(tree->root->left->left));
+            xassert_false(xrbtree_node_color(tree->root->right));
+            xassert_false(xrbtree_node_color(tree->root->left->left->right));
+            xassert_false(xrbtree_node_color(tree->root->left->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_min(tree);
@@ -1713,7 +1942,7 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "d", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 1);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
             xassert(strcmp(tree->root->key, "d") == 0);
             xassert_false(tree->root->left);
 
@@ -1733,7 +1962,7 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "m", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 1);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
             xassert(strcmp(tree->root->key, "h") == 0);
             xassert_false(tree->root->right);
 
@@ -1753,9 +1982,9 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "m", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 2);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
             xassert_false(tree->root->right);
-            xassert_false(tree->root->left->color);
+            xassert_false(xrbtree_node_color(tree->root->left));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -1778,10 +2007,10 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "n", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 3);
-            xassert(tree->root->right->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
+            xassert(xrbtree_node_color(tree->root->left));
+            xassert(xrbtree_node_color(tree->root->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -1805,10 +2034,10 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "k", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 3);
-            xassert(tree->root->right->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
+            xassert(xrbtree_node_color(tree->root->left));
+            xassert(xrbtree_node_color(tree->root->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -1833,11 +2062,11 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "n", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 4);
-            xassert(tree->root->right->size == 1);
-            xassert(tree->root->left->color);
-            xassert_false(tree->root->left->left->color);
-            xassert(tree->root->right->color);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
+            xassert(xrbtree_node_color(tree->root->left));
+            xassert_false(xrbtree_node_color(tree->root->left->left));
+            xassert(xrbtree_node_color(tree->root->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -1863,11 +2092,11 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "n", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 4);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->right);
-            xassert(tree->root->right->color);
-            xassert_false(tree->root->right->left->color);
+            xassert(xrbtree_node_color(tree->root->right));
+            xassert_false(xrbtree_node_color(tree->root->right->left));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -1896,12 +2125,12 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "o", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 5);
-            xassert(tree->root->right->size == 3);
+            xassert(xrbtree_test_node_size(tree->root) == 5);
+            xassert(xrbtree_test_node_size(tree->root->right) == 3);
             xassert(tree->root->right->left);
-            xassert_false(tree->root->right->color);
-            xassert(tree->root->right->left->color);
-            xassert(tree->root->right->right->color);
+            xassert_false(xrbtree_node_color(tree->root->right));
+            xassert(xrbtree_node_color(tree->root->right->left));
+            xassert(xrbtree_node_color(tree->root->right->right));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -1941,12 +2170,12 @@ void test_xrbtree() {
             xrbtree_put_repeat(tree, "p", NULL);
             xrbtree_remove_max(tree);
             xassert(tree->root);
-            xassert(tree->root->size == 14);
-            xassert(tree->root->right->size == 6);
-            xassert_false(tree->root->left->color);
-            xassert_false(tree->root->right->left->color);
-            xassert(tree->root->right->right->color);
-            xassert_false(tree->root->right->right->left->color);
+            xassert(xrbtree_test_node_size(tree->root) == 14);
+            xassert(xrbtree_test_node_size(tree->root->right) == 6);
+            xassert_false(xrbtree_node_color(tree->root->left));
+            xassert_false(xrbtree_node_color(tree->root->right->left));
+            xassert(xrbtree_node_color(tree->root->right->right));
+            xassert_false(xrbtree_node_color(tree->root->right->right->left));
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_remove_max(tree);
@@ -2067,8 +2296,8 @@ void test_xrbtree() {
             xrbtree_remove(tree, "5");
             xassert(strcmp(tree->root->key, "3") == 0);
             xassert(strcmp(tree->root->value, "3v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 1);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
             xassert_false(tree->root->left);
             xassert_false(tree->root->right);
             xassert(xrbtree_is_rbtree(tree));
@@ -2089,8 +2318,8 @@ void test_xrbtree() {
             xrbtree_remove(tree, "3");
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 1);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 1);
             xassert_false(tree->root->left);
             xassert_false(tree->root->right);
             xassert(xrbtree_is_rbtree(tree));
@@ -2113,14 +2342,14 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "3") == 0);
             xassert(strcmp(tree->root->value, "3v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 2);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
             xassert_false(tree->root->left);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
             xassert(strcmp(tree->root->right->value, "5v") == 0);
-            xassert(tree->root->right->color == false);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
             xassert(xrbtree_is_rbtree(tree));
@@ -2144,14 +2373,14 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 2);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
             xassert_false(tree->root->right);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert_false(tree->root->left->color);
-            xassert(tree->root->left->size == 1);
+            xassert_false(xrbtree_node_color(tree->root->left));
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
@@ -2176,14 +2405,14 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "3") == 0);
             xassert(strcmp(tree->root->value, "3v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 2);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 2);
             xassert_false(tree->root->right);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
@@ -2211,20 +2440,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -2252,20 +2481,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -2293,20 +2522,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "3") == 0);
             xassert(strcmp(tree->root->value, "3v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -2334,20 +2563,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "3") == 0);
             xassert(strcmp(tree->root->value, "3v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
             xassert(strcmp(tree->root->right->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -2375,20 +2604,20 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 3);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -2417,26 +2646,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->left);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->right->key, "3") == 0);
             xassert(strcmp(tree->root->left->right->value, "3v") == 0);
-            xassert_false(tree->root->left->right->color);
-            xassert(tree->root->left->right->size == 1);
+            xassert_false(xrbtree_node_color(tree->root->left->right));
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
 
             xassert(xrbtree_is_rbtree(tree));
             xrbtree_free(&tree);
@@ -2463,26 +2692,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "0") == 0);
             xassert(strcmp(tree->root->left->left->value, "0v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
@@ -2511,26 +2740,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "0") == 0);
             xassert(strcmp(tree->root->left->left->value, "0v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
@@ -2559,26 +2788,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "1") == 0);
             xassert(strcmp(tree->root->value, "1v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "0") == 0);
             xassert(strcmp(tree->root->left->value, "0v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "3") == 0);
             xassert(strcmp(tree->root->right->left->value, "3v") == 0);
-            xassert(tree->root->right->left->color == false);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
@@ -2607,26 +2836,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "1") == 0);
             xassert(strcmp(tree->root->value, "1v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "0") == 0);
             xassert(strcmp(tree->root->left->value, "0v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
             xassert(strcmp(tree->root->right->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "3") == 0);
             xassert(strcmp(tree->root->right->left->value, "3v") == 0);
-            xassert(tree->root->right->left->color == false);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
@@ -2655,26 +2884,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "8") == 0);
             xassert(strcmp(tree->root->value, "8v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
             xassert(strcmp(tree->root->left->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
@@ -2703,26 +2932,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "6") == 0);
             xassert(strcmp(tree->root->value, "6v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
             xassert(strcmp(tree->root->left->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
             xassert(strcmp(tree->root->right->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
@@ -2751,26 +2980,26 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "6") == 0);
             xassert(strcmp(tree->root->value, "6v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 4);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 4);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
             xassert(strcmp(tree->root->left->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
-            xassert(tree->root->left->size == 2);
+            xassert(xrbtree_node_color(tree->root->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left) == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
@@ -2801,39 +3030,39 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "8") == 0);
             xassert(strcmp(tree->root->value, "8v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 6);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 6);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->left);
             xassert(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
             xassert(strcmp(tree->root->left->right->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->right->right->key, "95") == 0);
             xassert(strcmp(tree->root->right->right->value, "95v") == 0);
-            xassert(tree->root->right->right->color == false);
-            xassert(tree->root->right->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->right) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->right) == 1);
             xassert_false(tree->root->right->left);
 
             xassert(xrbtree_is_rbtree(tree));
@@ -2863,38 +3092,38 @@ void test_xrbtree() {
 
             xassert(strcmp(tree->root->key, "5") == 0);
             xassert(strcmp(tree->root->value, "5v") == 0);
-            xassert(tree->root->color == true);
-            xassert(tree->root->size == 6);
+            xassert(xrbtree_node_color(tree->root) == true);
+            xassert(xrbtree_test_node_size(tree->root) == 6);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
             xassert(strcmp(tree->root->left->value, "3v") == 0);
-            xassert(tree->root->left->color == false);
-            xassert(tree->root->left->size == 3);
+            xassert(xrbtree_node_color(tree->root->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->left) == 3);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
             xassert(strcmp(tree->root->right->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
-            xassert(tree->root->right->size == 2);
+            xassert(xrbtree_node_color(tree->root->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->right) == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
             xassert(strcmp(tree->root->left->left->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
-            xassert(tree->root->left->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->left) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->left) == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
             xassert(strcmp(tree->root->left->right->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
-            xassert(tree->root->left->right->size == 1);
+            xassert(xrbtree_node_color(tree->root->left->right) == true);
+            xassert(xrbtree_test_node_size(tree->root->left->right) == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "8") == 0);
             xassert(strcmp(tree->root->right->left->value, "8v") == 0);
-            xassert(tree->root->right->left->color == false);
-            xassert(tree->root->right->left->size == 1);
+            xassert(xrbtree_node_color(tree->root->right->left) == false);
+            xassert(xrbtree_test_node_size(tree->root->right->left) == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
@@ -3116,6 +3345,449 @@ void test_xrbtree() {
         xrbtree_deep_free(&tree);
     }
 
+    /* xrbtree_build_sorted */
+    /* xrbtree_build_sorted_parray */
+    {
+        char strs[1000][8];
+        void *keys[1000];
+        void *values[1000];
+
+        for (int i = 0; i < 1000; ++i) {
+            sprintf(strs[i], "%04d", i / 2 * 2);  /* "repeat" keys : 0000 0000 0002 0002 ... */
+            keys[i] = strs[i];
+            values[i] = strs[i];
+        }
+
+        for (int count = 0; count <= 64; ++count) {
+            XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+            xassert(xrbtree_build_sorted(tree, keys, values, count));
+            xassert(xrbtree_size(tree) == count);
+            xassert(xrbtree_is_rbtree(tree));
+            xrbtree_free(&tree);
+        }
+
+        {
+            XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+            xassert(xrbtree_build_sorted(tree, keys, values, 1000));
+            xassert(xrbtree_size(tree) == 1000);
+            xassert(xrbtree_is_rbtree(tree));
+
+#ifndef XRBTREE_NO_SIZE
+            for (int i = 0; i < 1000; ++i) {
+                xassert(strcmp(xrbtree_select(tree, i), keys[i]) == 0);
+            }
+            xassert(xrbtree_rank(tree, "0998") / 2 == 499);
+#endif
+            xassert(strcmp(xrbtree_get(tree, "0500"), "0500") == 0);
+
+            /* the tree works as usual after building */
+            xassert(xrbtree_put_repeat(tree, "0001", NULL));
+            xassert(0 < xrbtree_remove(tree, "0500"));
+            xassert(xrbtree_is_rbtree(tree));
+
+            /* tree is not empty */
+            {
+                bool except = false;
+
+                XEXCEPT_TRY
+                    xrbtree_build_sorted(tree, keys, values, 1000);
+                XEXCEPT_ELSE
+                    except = true;
+                XEXCEPT_END_TRY
+
+                xassert(except);
+            }
+
+            xrbtree_free(&tree);
+        }
+
+        /* keys are not sorted */
+        {
+            XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+            void *tkeys[3] = { "1", "3", "2" };
+            xassert_false(xrbtree_build_sorted(tree, tkeys, NULL, 3));
+            xassert(xrbtree_is_empty(tree));
+            xrbtree_free(&tree);
+        }
+
+        {
+            XPArray_PT array = xparray_new(1000);
+            XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+
+            for (int i = 0; i < 1000; ++i) {
+                xparray_put(array, i, keys[i], NULL);
+            }
+
+            xassert(xrbtree_build_sorted_parray(tree, array, NULL));
+            xassert(xrbtree_size(tree) == 1000);
+            xassert(xrbtree_is_rbtree(tree));
+            xassert(!xrbtree_get(tree, "0500"));
+
+            xrbtree_free(&tree);
+            xparray_free(&array);
+        }
+    }
+
+    /* xrbtree_cursor_init */
+    /* xrbtree_cursor_first */
+    /* xrbtree_cursor_last */
+    /* xrbtree_cursor_seek */
+    /* xrbtree_cursor_next */
+    /* xrbtree_cursor_prev */
+    {
+        char strs[200][8];
+        XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+        XRBTree_Cursor_T cursor;
+
+        xrbtree_cursor_init(&cursor, tree);
+        xassert_false(xrbtree_cursor_valid(&cursor));
+        xassert_false(xrbtree_cursor_first(&cursor));
+        xassert_false(xrbtree_cursor_last(&cursor));
+        xassert_false(xrbtree_cursor_seek(&cursor, "0000"));
+        xassert_false(xrbtree_cursor_next(&cursor));
+        xassert(!xrbtree_cursor_key(&cursor));
+
+        /* "0000" "0000" "0002" "0002" ... "0198" "0198" */
+        for (int i = 0; i < 200; ++i) {
+            sprintf(strs[i], "%04d", i / 2 * 2);
+            xrbtree_put_repeat(tree, strs[i], strs[i]);
+        }
+
+        {
+            int count = 0;
+            char *last = NULL;
+            for (bool ok = xrbtree_cursor_first(&cursor); ok; ok = xrbtree_cursor_next(&cursor)) {
+                xassert(!last || (strcmp(last, xrbtree_cursor_key(&cursor)) <= 0));
+                xassert(xrbtree_cursor_key(&cursor) == xrbtree_cursor_value(&cursor));
+                last = xrbtree_cursor_key(&cursor);
+                ++count;
+            }
+            xassert(count == 200);
+            xassert_false(xrbtree_cursor_valid(&cursor));
+        }
+
+        {
+            int count = 0;
+            for (bool ok = xrbtree_cursor_last(&cursor); ok; ok = xrbtree_cursor_prev(&cursor)) {
+                ++count;
+            }
+            xassert(count == 200);
+        }
+
+        /* seek to the first one of the "repeat" keys */
+        xassert(xrbtree_cursor_seek(&cursor, "0100"));
+        xassert(strcmp(xrbtree_cursor_key(&cursor), "0100") == 0);
+        xassert(xrbtree_cursor_prev(&cursor));
+        xassert(strcmp(xrbtree_cursor_key(&cursor), "0098") == 0);
+
+        /* seek to the next key if not found */
+        xassert(xrbtree_cursor_seek(&cursor, "0101"));
+        xassert(strcmp(xrbtree_cursor_key(&cursor), "0102") == 0);
+        xassert(xrbtree_cursor_next(&cursor));
+        xassert(xrbtree_cursor_next(&cursor));
+        xassert(strcmp(xrbtree_cursor_key(&cursor), "0104") == 0);
+
+        xassert_false(xrbtree_cursor_seek(&cursor, "0199"));
+
+        /* two cursors can be interleaved : merge join with itself */
+        {
+            XRBTree_Cursor_T cursor2;
+            int count = 0;
+
+            xrbtree_cursor_init(&cursor2, tree);
+            xrbtree_cursor_first(&cursor);
+            xrbtree_cursor_seek(&cursor2, "0100");
+            while (xrbtree_cursor_valid(&cursor) && xrbtree_cursor_valid(&cursor2)) {
+                int ret = strcmp(xrbtree_cursor_key(&cursor), xrbtree_cursor_key(&cursor2));
+                if (ret < 0) {
+                    xrbtree_cursor_next(&cursor);
+                }
+                else if (0 < ret) {
+                    xrbtree_cursor_next(&cursor2);
+                }
+                else {
+                    ++count;
+                    xrbtree_cursor_next(&cursor);
+                    xrbtree_cursor_next(&cursor2);
+                }
+            }
+            xassert(count == 100);
+        }
+
+        xrbtree_free(&tree);
+    }
+
+#ifndef XRBTREE_NO_SIZE
+    /* xrbtree_split */
+    /* xrbtree_remove_range */
+    {
+        char strs[1000][8];
+        XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+
+        /* "0000" "0000" "0002" "0002" ... put in a shuffled order */
+        for (int i = 0; i < 1000; ++i) {
+            int k = (i * 337) % 1000;
+            sprintf(strs[k], "%04d", k / 2 * 2);
+            xrbtree_put_repeat(tree, strs[k], NULL);
+        }
+
+        for (int i = 0; i <= 1000; i += 37) {
+            char key[8];
+            XRBTree_PT tree1 = xrbtree_copy(tree);
+            XRBTree_PT tree2 = NULL;
+
+            sprintf(key, "%04d", i);
+            tree2 = xrbtree_split(tree1, key);
+
+            xassert(xrbtree_is_rbtree(tree1));
+            xassert(xrbtree_is_rbtree(tree2));
+            xassert(xrbtree_size(tree1) == (i + 1) / 2 * 2);
+            xassert(xrbtree_size(tree1) + xrbtree_size(tree2) == 1000);
+            xassert(xrbtree_is_empty(tree1) || (strcmp(xrbtree_max(tree1), key) < 0));
+            xassert(xrbtree_is_empty(tree2) || (strcmp(key, xrbtree_min(tree2)) <= 0));
+
+            xrbtree_free(&tree1);
+            xrbtree_free(&tree2);
+        }
+
+        for (int i = 0; i < 1000; i += 53) {
+            for (int j = i; j < 1100; j += 97) {
+                char low[8], high[8];
+                XRBTree_PT tree1 = xrbtree_copy(tree);
+                XRBTree_PT tree2 = NULL;
+
+                sprintf(low, "%04d", i);
+                sprintf(high, "%04d", j);
+                tree2 = ((i + j) % 2) ? xrbtree_remove_range(tree1, low, high) : xrbtree_remove_range(tree1, high, low);
+
+                xassert(xrbtree_is_rbtree(tree1));
+                xassert(xrbtree_is_rbtree(tree2));
+                xassert(xrbtree_size(tree1) + xrbtree_size(tree2) == 1000);
+                xassert(xrbtree_test_range_size(tree, low, high) == xrbtree_size(tree2));
+                xassert(xrbtree_test_range_size(tree1, low, high) == 0);
+                xassert(xrbtree_is_empty(tree2) || (strcmp(low, xrbtree_min(tree2)) <= 0));
+                xassert(xrbtree_is_empty(tree2) || (strcmp(xrbtree_max(tree2), high) <= 0));
+
+                /* the trees work as usual */
+                xassert(xrbtree_put_repeat(tree1, "0001", NULL));
+                xassert(xrbtree_put_repeat(tree2, "0001", NULL));
+                xassert(xrbtree_is_rbtree(tree1));
+                xassert(xrbtree_is_rbtree(tree2));
+
+                xrbtree_free(&tree1);
+                xrbtree_free(&tree2);
+            }
+        }
+
+        /* remove all */
+        {
+            XRBTree_PT tree2 = xrbtree_remove_range(tree, "0000", "9999");
+            xassert(xrbtree_is_empty(tree));
+            xassert(xrbtree_size(tree2) == 1000);
+            xassert(xrbtree_is_rbtree(tree2));
+            xrbtree_free(&tree2);
+        }
+
+        xrbtree_free(&tree);
+    }
+
+    /* the nodes of the split trees stay in one slab */
+    {
+        char strs[100][8];
+        XRBTree_PT tree = xrbtree_new(test_cmpk, NULL);
+        XRBTree_PT tree2 = NULL;
+
+        for (int i = 0; i < 100; ++i) {
+            sprintf(strs[i], "%04d", i);
+            xrbtree_put_repeat(tree, strs[i], NULL);
+        }
+        xassert(xslab_used_count(tree->slab) == 100);
+
+        tree2 = xrbtree_split(tree, "0040");
+        xassert(tree2->slab == tree->slab);
+        xassert(xslab_is_shared(tree->slab));
+
+        /* recycled one by one, tree2 still uses the slab */
+        xrbtree_clear(tree);
+        xassert(xslab_used_count(tree2->slab) == 60);
+        xassert(0 < xslab_slab_count(tree2->slab));
+
+        xrbtree_free(&tree);
+        xassert(!xslab_is_shared(tree2->slab));
+
+        /* released at once */
+        xrbtree_clear(tree2);
+        xassert(xslab_used_count(tree2->slab) == 0);
+        xassert(xslab_slab_count(tree2->slab) == 0);
+
+        xassert(xrbtree_put_repeat(tree2, "0001", NULL));
+        xassert(xrbtree_size(tree2) == 1);
+
+        xrbtree_free(&tree2);
+    }
+#endif
+
+    /* xrbtree_set_augment */
+    /* xrbtree_augment_map_min_to_max */
+    /* xrbtree_cursor_root */
+    /* xrbtree_cursor_left */
+    /* xrbtree_cursor_right */
+    /* xrbtree_cursor_aux */
+    /* xrbtree_aux */
+    {
+        static int lows[2000];
+        static int highs[2000];
+
+        XRBTree_PT tree = xrbtree_new(test_cmpi, NULL);
+
+        /* tree is not empty */
+        {
+            bool except = false;
+
+            xrbtree_put_repeat(tree, &lows[0], &highs[0]);
+
+            XEXCEPT_TRY
+                xrbtree_set_augment(tree, sizeof(XRBTree_Test_Aux_T), xrbtree_test_augment, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+            xassert(!xrbtree_aux(tree));
+            xrbtree_clear(tree);
+        }
+
+        xassert(xrbtree_set_augment(tree, sizeof(XRBTree_Test_Aux_T), xrbtree_test_augment, NULL));
+        xassert(!xrbtree_aux(tree));
+
+        for (int i = 0; i < 2000; ++i) {
+            lows[i] = (i * 7919) % 3000;
+            highs[i] = lows[i] + (i * 31) % 100;
+            xassert(xrbtree_put_repeat(tree, &lows[i], &highs[i]));
+        }
+        xrbtree_test_augment_queries(tree);
+        xassert(((XRBTree_Test_Aux_T*)xrbtree_aux(tree))->min_low == *(int*)xrbtree_min(tree));
+
+        /* the values are replaced */
+        for (int i = 0; i < 2000; i += 3) {
+            xassert(xrbtree_find_replace(tree, &lows[i], &highs[(i + 1) % 2000], NULL));
+#ifndef XRBTREE_NO_SIZE
+            xassert(xrbtree_index_replace(tree, i / 2, &highs[i], NULL));
+#endif
+        }
+        xrbtree_test_augment_queries(tree);
+
+        for (int i = 0; i < 2000; i += 2) {
+            xassert(0 < xrbtree_remove(tree, &lows[i]));
+        }
+        xrbtree_remove_min(tree);
+        xrbtree_remove_max(tree);
+        xrbtree_test_augment_queries(tree);
+
+        /* xrbtree_copy */
+        /* xrbtree_split */
+        /* xrbtree_remove_range */
+        {
+            int key = 1500;
+            XRBTree_PT tree1 = xrbtree_copy(tree);
+            XRBTree_PT tree2 = NULL;
+            xrbtree_test_augment_queries(tree1);
+
+#ifndef XRBTREE_NO_SIZE
+            tree2 = xrbtree_split(tree1, &key);
+            xrbtree_test_augment_queries(tree1);
+            xrbtree_test_augment_queries(tree2);
+            xrbtree_free(&tree2);
+
+            key = 100;
+            tree2 = xrbtree_remove_range(tree, &key, &lows[1]);
+            xrbtree_test_augment_queries(tree);
+            xrbtree_test_augment_queries(tree2);
+            xrbtree_free(&tree2);
+#endif
+
+            /* xrbtree_swap */
+            xrbtree_clear(tree);
+            xassert(xrbtree_swap(tree, tree1));
+            xrbtree_test_augment_queries(tree);
+            xrbtree_free(&tree1);
+        }
+
+        /* xrbtree_build_sorted */
+        {
+            static int sorted[2000];
+            void *keys[2000];
+            void *values[2000];
+            XRBTree_PT tree1 = xrbtree_new(test_cmpi, NULL);
+            xassert(xrbtree_set_augment(tree1, sizeof(XRBTree_Test_Aux_T), xrbtree_test_augment, NULL));
+
+            for (int i = 0; i < 2000; ++i) {
+                sorted[i] = i;
+                keys[i] = &sorted[i];
+                values[i] = &highs[i];
+            }
+            xassert(xrbtree_build_sorted(tree1, keys, values, 2000));
+            xrbtree_test_augment_queries(tree1);
+            xassert(((XRBTree_Test_Aux_T*)xrbtree_aux(tree1))->sum_low == 1999 * 1000);
+
+            xrbtree_free(&tree1);
+        }
+
+        xrbtree_free(&tree);
+    }
+
+#if defined(__linux__) && !defined(XRBTREE_NO_SIZE)
+    /* xrbtree_parallel_map */
+    /* xrbtree_parallel_reduce */
+    {
+        int keys[5000];
+        int values[5000];
+        XRBTree_PT tree = xrbtree_new(test_cmpi, NULL);
+        XRBTree_Test_Reduce_T result = { 0, 0, 0, 0, true };
+
+        /* tree == NULL */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xrbtree_parallel_map(NULL, NULL, xrbtree_test_parallel_apply, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        /* empty tree */
+        xassert(xrbtree_parallel_map(tree, NULL, xrbtree_test_parallel_apply, NULL) == 0);
+        xassert(xrbtree_parallel_reduce(tree, NULL, &result, sizeof(result), xrbtree_test_parallel_accumulate, xrbtree_test_parallel_combine, NULL));
+        xassert(result.count == 0);
+
+        /* put in a shuffled order */
+        for (int i = 0; i < 5000; ++i) {
+            int k = (int)((i * 2039L) % 5000);
+            keys[k] = k;
+            values[k] = k;
+            xassert(xrbtree_put_repeat(tree, &keys[k], &values[k]));
+        }
+
+        /* the keys are split into 4 ranges, all of them are done in the caller if pool is NULL */
+        xassert(xrbtree_parallel_map(tree, NULL, xrbtree_test_parallel_apply, NULL) == 2500);
+        for (int i = 0; i < 5000; ++i) {
+            xassert(values[i] == 2 * i);
+        }
+
+        xassert(xrbtree_parallel_reduce(tree, NULL, &result, sizeof(result), xrbtree_test_parallel_accumulate, xrbtree_test_parallel_combine, NULL));
+        xassert(result.sorted);
+        xassert(result.count == 5000);
+        xassert(result.first == 0);
+        xassert(result.last == 4999);
+        xassert(result.sum == 4999L * 5000);
+
+        xrbtree_free(&tree);
+    }
+#endif
+
     {
         int count = 0;
         xmem_leak(check_mem_leak, &count);
@@ -129,7 +129,7 @@ void xlistrbtree_print_impl(XListRBTree_Node_PT node, int h) {
 
     xlistrbtree_print_impl(node->right, h + 3);
 
-    xlistrbtree_printnode((char*)node->key, (char*)node->values->value, node->color, h);
+    xlistrbtree_printnode((char*)node->key, (char*)xlistrbtree_values_front(&node->values), xlistrbtree_node_color(node), h);
 
     xlistrbtree_print_impl(node->left, h + 3);
 }
@@ -252,10 +252,10 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "5", "5v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 1);
-            xassert_false(tree->root->parent);
+            xassert_false(xlistrbtree_node_parent(tree->root));
             xassert_false(tree->root->left);
             xassert_false(tree->root->right);
 
@@ -276,17 +276,17 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "3", "3v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 2);
             xassert_false(tree->root->right);
-            xassert_false(tree->root->parent);
+            xassert_false(xlistrbtree_node_parent(tree->root));
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == false);
             xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "5") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->left)->key, "5") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
@@ -307,15 +307,15 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "8", "8v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 2);
-            xassert_false(tree->root->parent);
+            xassert_false(xlistrbtree_node_parent(tree->root));
             xassert_false(tree->root->left);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == false);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -340,24 +340,24 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "1", "1v"));
 
             xassert(strcmp(tree->root->key, "3") == 0);
-            xassert(strcmp(tree->root->values->value, "3v") == 0);
-            xassert_false(tree->root->parent);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "3v") == 0);
+            xassert_false(xlistrbtree_node_parent(tree->root));
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "3") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->left)->key, "3") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
-            xassert(strcmp(tree->root->right->values->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
-            xassert(strcmp(tree->root->right->parent->key, "3") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->right)->key, "3") == 0);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -381,20 +381,20 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "4", "4v"));
 
             xassert(strcmp(tree->root->key, "4") == 0);
-            xassert(strcmp(tree->root->values->value, "4v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "4v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
-            xassert(strcmp(tree->root->right->values->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -419,24 +419,24 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "6", "6v"));
 
             xassert(strcmp(tree->root->key, "6") == 0);
-            xassert(strcmp(tree->root->values->value, "6v") == 0);
-            xassert_false(tree->root->parent);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "6v") == 0);
+            xassert_false(xlistrbtree_node_parent(tree->root));
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
-            xassert(strcmp(tree->root->left->values->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "6") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->left)->key, "6") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
-            xassert(strcmp(tree->root->right->parent->key, "6") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->right)->key, "6") == 0);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -460,24 +460,24 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "9", "9v"));
 
             xassert(strcmp(tree->root->key, "8") == 0);
-            xassert(strcmp(tree->root->values->value, "8v") == 0);
-            xassert_false(tree->root->parent);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "8v") == 0);
+            xassert_false(xlistrbtree_node_parent(tree->root));
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
-            xassert(strcmp(tree->root->left->values->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
-            xassert(strcmp(tree->root->left->parent->key, "8") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->left)->key, "8") == 0);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->values->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
-            xassert(strcmp(tree->root->right->parent->key, "8") == 0);
+            xassert(strcmp(xlistrbtree_node_parent(tree->root->right)->key, "8") == 0);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
@@ -499,20 +499,20 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "8", "8v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -538,26 +538,26 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "1", "1v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
@@ -582,26 +582,26 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "4", "4v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->left);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "4v") == 0);
-            xassert(tree->root->left->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "4v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == false);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
@@ -627,26 +627,26 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "6", "6v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "6v") == 0);
-            xassert(tree->root->right->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == false);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
@@ -672,26 +672,26 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "9", "9v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->left);
 
             xassert(strcmp(tree->root->right->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->right->values->value, "9v") == 0);
-            xassert(tree->root->right->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->right) == false);
             xassert(tree->root->right->right->size == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
@@ -720,32 +720,32 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "0", "0v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == false);
             xassert(tree->root->left->size == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "0") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "0v") == 0);
-            xassert(tree->root->left->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "0v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == true);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "3") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "3v") == 0);
-            xassert(tree->root->left->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == true);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
@@ -774,32 +774,32 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "15", "15v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "15") == 0);
-            xassert(strcmp(tree->root->left->values->value, "15v") == 0);
-            xassert(tree->root->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "15v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == false);
             xassert(tree->root->left->size == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == true);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "3") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "3v") == 0);
-            xassert(tree->root->left->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == true);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
@@ -828,30 +828,30 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "6", "6v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
 
             xassert(strcmp(tree->root->right->key, "7") == 0);
-            xassert(strcmp(tree->root->right->values->value, "7v") == 0);
-            xassert(tree->root->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "7v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == false);
             xassert(tree->root->right->size == 3);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "6v") == 0);
-            xassert(tree->root->right->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == true);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->right->values->value, "8v") == 0);
-            xassert(tree->root->right->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->right) == true);
             xassert(tree->root->right->right->size == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
@@ -880,30 +880,30 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "7", "7v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
 
             xassert(strcmp(tree->root->right->key, "7") == 0);
-            xassert(strcmp(tree->root->right->values->value, "7v") == 0);
-            xassert(tree->root->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "7v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == false);
             xassert(tree->root->right->size == 3);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "6v") == 0);
-            xassert(tree->root->right->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == true);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->right->values->value, "8v") == 0);
-            xassert(tree->root->right->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->right) == true);
             xassert(tree->root->right->right->size == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
@@ -930,32 +930,32 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "4", "4v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == false);
             xassert(tree->root->left->size == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == true);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "4v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == true);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
@@ -982,31 +982,31 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "6", "6v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "6v") == 0);
-            xassert(tree->root->right->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == false);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
@@ -1033,32 +1033,32 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "9", "9v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 5);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->left);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->right->values->value, "9v") == 0);
-            xassert(tree->root->right->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->right) == false);
             xassert(tree->root->right->right->size == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
@@ -1094,44 +1094,44 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "6", "6v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 7);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 3);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 3);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == true);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "4v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == true);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "6") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "6v") == 0);
-            xassert(tree->root->right->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == true);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->right->values->value, "9v") == 0);
-            xassert(tree->root->right->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->right) == true);
             xassert(tree->root->right->right->size == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
@@ -1159,36 +1159,36 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "1", "1v"));
 
             xassert(strcmp(tree->root->key, "9") == 0);
-            xassert(strcmp(tree->root->values->value, "9v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 6);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
-            xassert(strcmp(tree->root->left->values->value, "5v") == 0);
-            xassert(tree->root->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == false);
             xassert(tree->root->left->size == 4);
 
             xassert(strcmp(tree->root->right->key, "95") == 0);
-            xassert(strcmp(tree->root->right->values->value, "95v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "95v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
 
             xassert(strcmp(tree->root->left->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "3v") == 0);
-            xassert(tree->root->left->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == true);
             xassert(tree->root->left->left->size == 2);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "8") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "8v") == 0);
-            xassert(tree->root->left->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == true);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->left->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left->left) == false);
             xassert(tree->root->left->left->left->size == 1);
             xassert_false(tree->root->left->left->left->left);
             xassert_false(tree->root->left->left->left->right);
@@ -1207,44 +1207,44 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "4", "4v"));
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 7);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 3);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->values->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 3);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == true);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
 
             xassert(strcmp(tree->root->left->right->key, "4") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "4v") == 0);
-            xassert(tree->root->left->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "4v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->right) == true);
             xassert(tree->root->left->right->size == 1);
             xassert_false(tree->root->left->right->left);
             xassert_false(tree->root->left->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "8") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "8v") == 0);
-            xassert(tree->root->right->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == true);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
 
             xassert(strcmp(tree->root->right->right->key, "95") == 0);
-            xassert(strcmp(tree->root->right->right->values->value, "95v") == 0);
-            xassert(tree->root->right->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "95v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->right) == true);
             xassert(tree->root->right->right->size == 1);
             xassert_false(tree->root->right->right->left);
             xassert_false(tree->root->right->right->right);
@@ -1497,7 +1497,43 @@ void test_xlistrbtree() {
         {
             XSList_PT list = xlistrbtree_get_all(tree, "g");
             xassert(xslist_size(list) == 4);
+            xassert(strcmp(xslist_front(list), "vg4") == 0);
+            xassert(strcmp(xslist_back(list), "vg") == 0);
             xslist_free(&list);
+
+            xassert_false(xlistrbtree_get_all(tree, "a"));
+            xassert_false(xlistrbtree_get_all(tree, "s"));
+        }
+
+        /* xlistrbtree_get_all_view */
+        {
+            int count = -1;
+            void **values = xlistrbtree_get_all_view(tree, "g", &count);
+            xassert(count == 4);
+            xassert(strcmp(values[0], "vg") == 0);
+            xassert(strcmp(values[1], "vg2") == 0);
+            xassert(strcmp(values[2], "vg3") == 0);
+            xassert(strcmp(values[3], "vg4") == 0);
+
+            values = xlistrbtree_get_all_view(tree, "k", &count);
+            xassert(count == 3);
+            xassert(strcmp(values[2], xlistrbtree_get(tree, "k")) == 0);
+
+            xassert_false(xlistrbtree_get_all_view(tree, "a", &count));
+            xassert(count == 0);
+            xassert_false(xlistrbtree_get_all_view(tree, "s", &count));
+            xassert(count == 0);
+
+            /* the values are moved back to the node itself after they are removed */
+            xassert(xlistrbtree_remove(tree, "g") == 1);
+            xassert(xlistrbtree_remove(tree, "g") == 1);
+            values = xlistrbtree_get_all_view(tree, "g", &count);
+            xassert(count == 2);
+            xassert(strcmp(values[0], "vg") == 0);
+            xassert(strcmp(values[1], "vg2") == 0);
+            xassert(xlistrbtree_put_repeat(tree, "g", "vg3"));
+            xassert(xlistrbtree_put_repeat(tree, "g", "vg4"));
+            xassert(strcmp(xlistrbtree_get(tree, "g"), "vg4") == 0);
         }
 
         /* xlistrbtree_keys */
@@ -1585,7 +1621,7 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 2);
             xassert_false(tree->root->left);
-            xassert_false(tree->root->right->color);
+            xassert_false(xlistrbtree_node_color(tree->root->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_min(tree);
@@ -1610,8 +1646,8 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 3);
             xassert(tree->root->left->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left));
+            xassert(xlistrbtree_node_color(tree->root->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_min(tree);
@@ -1637,8 +1673,8 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 3);
             xassert(tree->root->left->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left));
+            xassert(xlistrbtree_node_color(tree->root->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_min(tree);
@@ -1666,8 +1702,8 @@ void test_xlistrbtree() {
             xassert(tree->root->size == 4);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->left);
-            xassert(tree->root->left->color);
-            xassert_false(tree->root->left->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left));
+            xassert_false(xlistrbtree_node_color(tree->root->left->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_min(tree);
@@ -1699,9 +1735,9 @@ void test_xlistrbtree() {
             xassert(tree->root->size == 5);
             xassert(tree->root->left->size == 3);
             xassert(tree->root->left->left);
-            xassert_false(tree->root->left->color);
-            xassert(tree->root->left->left->color);
-            xassert(tree->root->left->right->color);
+            xassert_false(xlistrbtree_node_color(tree->root->left));
+            xassert(xlistrbtree_node_color(tree->root->left->left));
+            xassert(xlistrbtree_node_color(tree->root->left->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_min(tree);
@@ -1742,10 +1778,10 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 14);
             xassert(tree->root->left->size == 6);
-            xassert(tree->root->left->left->color);
-            xassert_false(tree->root->right->color);
-            xassert_false(tree->root->left->left->right->color);
-            xassert_false(tree->root->left->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left->left));
+            xassert_false(xlistrbtree_node_color(tree->root->right));
+            xassert_false(xlistrbtree_node_color(tree->root->left->left->right));
+            xassert_false(xlistrbtree_node_color(tree->root->left->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_min(tree);
@@ -1830,7 +1866,7 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 2);
             xassert_false(tree->root->right);
-            xassert_false(tree->root->left->color);
+            xassert_false(xlistrbtree_node_color(tree->root->left));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -1855,8 +1891,8 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 3);
             xassert(tree->root->right->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left));
+            xassert(xlistrbtree_node_color(tree->root->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -1882,8 +1918,8 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 3);
             xassert(tree->root->right->size == 1);
-            xassert(tree->root->left->color);
-            xassert(tree->root->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left));
+            xassert(xlistrbtree_node_color(tree->root->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -1910,9 +1946,9 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 4);
             xassert(tree->root->right->size == 1);
-            xassert(tree->root->left->color);
-            xassert_false(tree->root->left->left->color);
-            xassert(tree->root->right->color);
+            xassert(xlistrbtree_node_color(tree->root->left));
+            xassert_false(xlistrbtree_node_color(tree->root->left->left));
+            xassert(xlistrbtree_node_color(tree->root->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -1941,8 +1977,8 @@ void test_xlistrbtree() {
             xassert(tree->root->size == 4);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->right);
-            xassert(tree->root->right->color);
-            xassert_false(tree->root->right->left->color);
+            xassert(xlistrbtree_node_color(tree->root->right));
+            xassert_false(xlistrbtree_node_color(tree->root->right->left));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -1974,9 +2010,9 @@ void test_xlistrbtree() {
             xassert(tree->root->size == 5);
             xassert(tree->root->right->size == 3);
             xassert(tree->root->right->left);
-            xassert_false(tree->root->right->color);
-            xassert(tree->root->right->left->color);
-            xassert(tree->root->right->right->color);
+            xassert_false(xlistrbtree_node_color(tree->root->right));
+            xassert(xlistrbtree_node_color(tree->root->right->left));
+            xassert(xlistrbtree_node_color(tree->root->right->right));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -2018,10 +2054,10 @@ void test_xlistrbtree() {
             xassert(tree->root);
             xassert(tree->root->size == 14);
             xassert(tree->root->right->size == 6);
-            xassert_false(tree->root->left->color);
-            xassert_false(tree->root->right->left->color);
-            xassert(tree->root->right->right->color);
-            xassert_false(tree->root->right->right->left->color);
+            xassert_false(xlistrbtree_node_color(tree->root->left));
+            xassert_false(xlistrbtree_node_color(tree->root->right->left));
+            xassert(xlistrbtree_node_color(tree->root->right->right));
+            xassert_false(xlistrbtree_node_color(tree->root->right->right->left));
 
             xassert(xlistrbtree_is_rbtree(tree));
             xlistrbtree_remove_max(tree);
@@ -2109,8 +2145,8 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "3", "3v"));
             xlistrbtree_remove(tree, "5");
             xassert(strcmp(tree->root->key, "3") == 0);
-            xassert(strcmp(tree->root->values->value, "3v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 1);
             xassert_false(tree->root->left);
             xassert_false(tree->root->right);
@@ -2131,8 +2167,8 @@ void test_xlistrbtree() {
             xassert(xlistrbtree_put_repeat(tree, "3", "3v"));
             xlistrbtree_remove(tree, "3");
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 1);
             xassert_false(tree->root->left);
             xassert_false(tree->root->right);
@@ -2155,14 +2191,14 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "1");
 
             xassert(strcmp(tree->root->key, "3") == 0);
-            xassert(strcmp(tree->root->values->value, "3v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 2);
             xassert_false(tree->root->left);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
-            xassert(strcmp(tree->root->right->values->value, "5v") == 0);
-            xassert(tree->root->right->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == false);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -2186,14 +2222,14 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "3");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 2);
             xassert_false(tree->root->right);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert_false(tree->root->left->color);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert_false(xlistrbtree_node_color(tree->root->left));
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
@@ -2218,14 +2254,14 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "5");
 
             xassert(strcmp(tree->root->key, "3") == 0);
-            xassert(strcmp(tree->root->values->value, "3v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 2);
             xassert_false(tree->root->right);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == false);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
@@ -2253,20 +2289,20 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "1");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -2294,20 +2330,20 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "3");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -2335,20 +2371,20 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "5");
 
             xassert(strcmp(tree->root->key, "3") == 0);
-            xassert(strcmp(tree->root->values->value, "3v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -2376,20 +2412,20 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "8");
 
             xassert(strcmp(tree->root->key, "3") == 0);
-            xassert(strcmp(tree->root->values->value, "3v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
-            xassert(strcmp(tree->root->right->values->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -2417,20 +2453,20 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "7");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 3);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
@@ -2459,26 +2495,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "0");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->left);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->right->key, "3") == 0);
-            xassert(strcmp(tree->root->left->right->values->value, "3v") == 0);
-            xassert_false(tree->root->left->right->color);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "3v") == 0);
+            xassert_false(xlistrbtree_node_color(tree->root->left->right));
             xassert(tree->root->left->right->size == 1);
 
             xassert(xlistrbtree_is_rbtree(tree));
@@ -2505,26 +2541,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "1");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "3") == 0);
-            xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "0") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "0v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "0v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
@@ -2553,26 +2589,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "3");
 
             xassert(strcmp(tree->root->key, "5") == 0);
-            xassert(strcmp(tree->root->values->value, "5v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->values->value, "1v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "0") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "0v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "0v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
@@ -2601,26 +2637,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "5");
 
             xassert(strcmp(tree->root->key, "1") == 0);
-            xassert(strcmp(tree->root->values->value, "1v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "0") == 0);
-            xassert(strcmp(tree->root->left->values->value, "0v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "0v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "3") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "3v") == 0);
-            xassert(tree->root->right->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == false);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
@@ -2649,26 +2685,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "8");
 
             xassert(strcmp(tree->root->key, "1") == 0);
-            xassert(strcmp(tree->root->values->value, "1v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "0") == 0);
-            xassert(strcmp(tree->root->left->values->value, "0v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "0v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 1);
             xassert_false(tree->root->left->left);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "5") == 0);
-            xassert(strcmp(tree->root->right->values->value, "5v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 2);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->right->left->key, "3") == 0);
-            xassert(strcmp(tree->root->right->left->values->value, "3v") == 0);
-            xassert(tree->root->right->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "3v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right->left) == false);
             xassert(tree->root->right->left->size == 1);
             xassert_false(tree->root->right->left->left);
             xassert_false(tree->root->right->left->right);
@@ -2697,26 +2733,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "6");
 
             xassert(strcmp(tree->root->key, "8") == 0);
-            xassert(strcmp(tree->root->values->value, "8v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
-            xassert(strcmp(tree->root->left->values->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->values->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
@@ -2745,26 +2781,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "9");
 
             xassert(strcmp(tree->root->key, "6") == 0);
-            xassert(strcmp(tree->root->values->value, "6v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
-            xassert(strcmp(tree->root->left->values->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "8") == 0);
-            xassert(strcmp(tree->root->right->values->value, "8v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
@@ -2793,26 +2829,26 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "8");
 
             xassert(strcmp(tree->root->key, "6") == 0);
-            xassert(strcmp(tree->root->values->value, "6v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "6v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 4);
 
             xassert(strcmp(tree->root->left->key, "5") == 0);
-            xassert(strcmp(tree->root->left->values->value, "5v") == 0);
-            xassert(tree->root->left->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "5v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left) == true);
             xassert(tree->root->left->size == 2);
             xassert_false(tree->root->left->right);
 
             xassert(strcmp(tree->root->right->key, "9") == 0);
-            xassert(strcmp(tree->root->right->values->value, "9v") == 0);
-            xassert(tree->root->right->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "9v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->right) == true);
             xassert(tree->root->right->size == 1);
             xassert_false(tree->root->right->left);
             xassert_false(tree->root->right->right);
 
             xassert(strcmp(tree->root->left->left->key, "1") == 0);
-            xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-            xassert(tree->root->left->left->color == false);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+            xassert(xlistrbtree_node_color(tree->root->left->left) == false);
             xassert(tree->root->left->left->size == 1);
             xassert_false(tree->root->left->left->left);
             xassert_false(tree->root->left->left->right);
@@ -2843,39 +2879,39 @@ void test_xlistrbtree() {
             xlistrbtree_remove(tree, "5");
 
             xassert(strcmp(tree->root->key, "8") == 0);
-            xassert(strcmp(tree->root->values->value, "8v") == 0);
-            xassert(tree->root->color == true);
+            xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "8v") == 0);
+            xassert(xlistrbtree_node_color(tree->root) == true);
             xassert(tree->root->size == 6);
 
 xassert(strcmp(tree->root->left->key, "3") == 0);
-xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-xassert(tree->root->left->color == false);
+xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+xassert(xlistrbtree_node_color(tree->root->left) == false);
 xassert(tree->root->left->size == 3);
 
 xassert(strcmp(tree->root->right->key, "9") == 0);
-xassert(strcmp(tree->root->right->values->value, "9v") == 0);
-xassert(tree->root->right->color == true);
+xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "9v") == 0);
+xassert(xlistrbtree_node_color(tree->root->right) == true);
 xassert(tree->root->right->size == 2);
 xassert_false(tree->root->right->left);
 xassert(tree->root->right->right);
 
 xassert(strcmp(tree->root->left->left->key, "1") == 0);
-xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-xassert(tree->root->left->left->color == true);
+xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+xassert(xlistrbtree_node_color(tree->root->left->left) == true);
 xassert(tree->root->left->left->size == 1);
 xassert_false(tree->root->left->left->left);
 xassert_false(tree->root->left->left->right);
 
 xassert(strcmp(tree->root->left->right->key, "4") == 0);
-xassert(strcmp(tree->root->left->right->values->value, "4v") == 0);
-xassert(tree->root->left->right->color == true);
+xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "4v") == 0);
+xassert(xlistrbtree_node_color(tree->root->left->right) == true);
 xassert(tree->root->left->right->size == 1);
 xassert_false(tree->root->left->right->left);
 xassert_false(tree->root->left->right->right);
 
 xassert(strcmp(tree->root->right->right->key, "95") == 0);
-xassert(strcmp(tree->root->right->right->values->value, "95v") == 0);
-xassert(tree->root->right->right->color == false);
+xassert(strcmp(xlistrbtree_values_front(&tree->root->right->right->values), "95v") == 0);
+xassert(xlistrbtree_node_color(tree->root->right->right) == false);
 xassert(tree->root->right->right->size == 1);
 xassert_false(tree->root->right->left);
 
@@ -2905,38 +2941,38 @@ xlistrbtree_free(&tree);
         xlistrbtree_remove(tree, "95");
 
         xassert(strcmp(tree->root->key, "5") == 0);
-        xassert(strcmp(tree->root->values->value, "5v") == 0);
-        xassert(tree->root->color == true);
+        xassert(strcmp(xlistrbtree_values_front(&tree->root->values), "5v") == 0);
+        xassert(xlistrbtree_node_color(tree->root) == true);
         xassert(tree->root->size == 6);
 
         xassert(strcmp(tree->root->left->key, "3") == 0);
-        xassert(strcmp(tree->root->left->values->value, "3v") == 0);
-        xassert(tree->root->left->color == false);
+        xassert(strcmp(xlistrbtree_values_front(&tree->root->left->values), "3v") == 0);
+        xassert(xlistrbtree_node_color(tree->root->left) == false);
         xassert(tree->root->left->size == 3);
 
         xassert(strcmp(tree->root->right->key, "9") == 0);
-        xassert(strcmp(tree->root->right->values->value, "9v") == 0);
-        xassert(tree->root->right->color == true);
+        xassert(strcmp(xlistrbtree_values_front(&tree->root->right->values), "9v") == 0);
+        xassert(xlistrbtree_node_color(tree->root->right) == true);
         xassert(tree->root->right->size == 2);
         xassert_false(tree->root->right->right);
 
         xassert(strcmp(tree->root->left->left->key, "1") == 0);
-        xassert(strcmp(tree->root->left->left->values->value, "1v") == 0);
-        xassert(tree->root->left->left->color == true);
+        xassert(strcmp(xlistrbtree_values_front(&tree->root->left->left->values), "1v") == 0);
+        xassert(xlistrbtree_node_color(tree->root->left->left) == true);
         xassert(tree->root->left->left->size == 1);
         xassert_false(tree->root->left->left->left);
         xassert_false(tree->root->left->left->right);
 
         xassert(strcmp(tree->root->left->right->key, "4") == 0);
-        xassert(strcmp(tree->root->left->right->values->value, "4v") == 0);
-        xassert(tree->root->left->right->color == true);
+        xassert(strcmp(xlistrbtree_values_front(&tree->root->left->right->values), "4v") == 0);
+        xassert(xlistrbtree_node_color(tree->root->left->right) == true);
         xassert(tree->root->left->right->size == 1);
         xassert_false(tree->root->left->right->left);
         xassert_false(tree->root->left->right->right);
 
         xassert(strcmp(tree->root->right->left->key, "8") == 0);
-        xassert(strcmp(tree->root->right->left->values->value, "8v") == 0);
-        xassert(tree->root->right->left->color == false);
+        xassert(strcmp(xlistrbtree_values_front(&tree->root->right->left->values), "8v") == 0);
+        xassert(xlistrbtree_node_color(tree->root->right->left) == false);
         xassert(tree->root->right->left->size == 1);
         xassert_false(tree->root->right->left->left);
         xassert_false(tree->root->right->left->right);
@@ -3093,9 +3129,22 @@ xlistrbtree_free(&tree);
         xassert(xlistrbtree_put_repeat(tree2, "f", "f2"));
         xassert(xlistrbtree_put_repeat(tree2, "g", "g2"));
 
+        xassert(xlistrbtree_put_repeat(tree2, "g", "g3"));
+        xassert(xlistrbtree_put_repeat(tree2, "g", "g4"));
+
         xlistrbtree_merge_repeat(tree1, &tree2);
 
-        xassert(xlistrbtree_size(tree1) == 14);
+        xassert(xlistrbtree_size(tree1) == 16);
+        {
+            /* the values of tree2 are behind the values of tree1 */
+            XSList_PT list = xlistrbtree_get_all(tree1, "g");
+            xassert(xslist_size(list) == 4);
+            xassert(strcmp(xslist_pop_front(list), "g1") == 0);
+            xassert(strcmp(xslist_pop_front(list), "g4") == 0);
+            xassert(strcmp(xslist_pop_front(list), "g3") == 0);
+            xassert(strcmp(xslist_pop_front(list), "g2") == 0);
+            xslist_free(&list);
+        }
 
         //xlistrbtree_print(tree1, 2);
 
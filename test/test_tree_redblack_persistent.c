@@ -0,0 +1,318 @@
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "../tree_redblack_persistent/xtree_redblack_persistent_x.h"
+#include "../include/xalgos.h"
+
+static
+int test_cmpi(void *key1, void *key2, void *cl) {
+    return *(int*)key1 - *(int*)key2;
+}
+
+static
+bool xprbtree_test_map_ordered(void *key, void *value, void *cl) {
+    int *last = (int*)cl;
+    xassert(*last < *(int*)key);
+    xassert(key == value);
+    *last = *(int*)key;
+    return true;
+}
+
+#define XPRBTREE_TEST_WRITERS  2
+#define XPRBTREE_TEST_READERS  4
+#define XPRBTREE_TEST_KEYS     2000
+#define XPRBTREE_TEST_ROUNDS   10
+
+static int xprbtree_test_keys[XPRBTREE_TEST_KEYS];
+static int xprbtree_test_writers_done = 0;
+
+typedef struct {
+    XPRBTree_PT tree;
+    int         id;
+    int         snaps;   /* the count of the snapshots checked by the reader */
+} XPRBTree_Test_Thread_T;
+
+static
+bool xprbtree_test_map_count(void *key, void *value, void *cl) {
+    xassert(key == value);
+    return true;
+}
+
+/* writer i puts (even round) or removes (odd round) the keys k (k % writers == i) in a shuffled order */
+static
+void* xprbtree_test_writer_thread(void *arg) {
+    XPRBTree_Test_Thread_T *paras = (XPRBTree_Test_Thread_T*)arg;
+
+    for (int r = 0; r < XPRBTREE_TEST_ROUNDS; ++r) {
+        for (int i = 0; i < XPRBTREE_TEST_KEYS; ++i) {
+            int k = (i * 769) % XPRBTREE_TEST_KEYS;
+            if (k % XPRBTREE_TEST_WRITERS != paras->id) {
+                continue;
+            }
+
+            if (r % 2 == 0) {
+                xassert(xprbtree_put_replace(paras->tree, &xprbtree_test_keys[k], &xprbtree_test_keys[k], NULL));
+            }
+            else {
+                xassert(xprbtree_remove(paras->tree, &xprbtree_test_keys[k]));
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* the snapshots taken while the writers are publishing the new versions are always valid red black trees */
+static
+void* xprbtree_test_reader_thread(void *arg) {
+    XPRBTree_Test_Thread_T *paras = (XPRBTree_Test_Thread_T*)arg;
+
+    while (!__atomic_load_n(&xprbtree_test_writers_done, __ATOMIC_ACQUIRE) || (paras->snaps == 0)) {
+        XPRBTree_Snap_PT snap = xprbtree_snapshot(paras->tree);
+        int size = xprbtree_snap_size(snap);
+        int last = -1;
+
+        xassert(xprbtree_snap_is_rbtree(snap));
+        xassert(xprbtree_snap_map_min_to_max(snap, xprbtree_test_map_count, NULL) == size);
+        xassert(xprbtree_snap_map_min_to_max(snap, xprbtree_test_map_ordered, &last) == size);
+
+        for (int i = 0; i < size; i += 1 + size / 16) {
+            int *key = (int*)xprbtree_snap_select(snap, i);
+            xassert(key);
+            xassert(xprbtree_snap_rank(snap, key) == i);
+            xassert(xprbtree_snap_get(snap, key) == key);
+        }
+
+        if (0 < size) {
+            xassert(xprbtree_snap_min(snap) == xprbtree_snap_select(snap, 0));
+            xassert(xprbtree_snap_max(snap) == xprbtree_snap_select(snap, size - 1));
+        }
+
+        xprbtree_snap_free(&snap);
+        ++paras->snaps;
+    }
+
+    return NULL;
+}
+
+static
+void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
+    (*(int*)cl) += 1;
+    printf("file:%s, line:%d, size:%ld\n", file, line, size);
+}
+
+void test_xprbtree() {
+    enum { TEST_N = 2000 };
+
+    static int keys[TEST_N];
+    for (int i = 0; i < TEST_N; ++i) {
+        keys[i] = i;
+    }
+
+    /* xprbtree_new */
+    {
+        /* cmp == NULL */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xprbtree_new(NULL, NULL);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        {
+            XPRBTree_PT tree = xprbtree_new(test_cmpi, NULL);
+            xassert(tree);
+            xassert(xprbtree_is_empty(tree));
+            xprbtree_free(&tree);
+            xassert(!tree);
+        }
+    }
+
+    /* xprbtree_put_replace */
+    /* xprbtree_snapshot */
+    {
+        XPRBTree_PT tree = xprbtree_new(test_cmpi, NULL);
+        XPRBTree_Snap_PT empty = xprbtree_snapshot(tree);
+        XPRBTree_Snap_PT half = NULL;
+        XPRBTree_Snap_PT full = NULL;
+
+        /* put in a shuffled order */
+        for (int i = 0; i < TEST_N; ++i) {
+            int k = (i * 769) % TEST_N;
+            xassert(xprbtree_put_replace(tree, &keys[k], &keys[k], NULL));
+
+            if (i == TEST_N / 2 - 1) {
+                half = xprbtree_snapshot(tree);
+            }
+        }
+        full = xprbtree_snapshot(tree);
+
+        /* replace */
+        {
+            void *old_value = NULL;
+            xassert(xprbtree_put_replace(tree, &keys[7], NULL, &old_value));
+            xassert(old_value == &keys[7]);
+            xassert(xprbtree_size(tree) == TEST_N);
+        }
+
+        /* the old versions are not changed */
+        xassert(xprbtree_snap_is_empty(empty));
+        xassert(xprbtree_snap_is_rbtree(empty));
+        xassert(!xprbtree_snap_min(empty));
+        xassert(xprbtree_snap_size(half) == TEST_N / 2);
+        xassert(xprbtree_snap_is_rbtree(half));
+        xassert(xprbtree_snap_size(full) == TEST_N);
+        xassert(xprbtree_snap_is_rbtree(full));
+        xassert(xprbtree_snap_get(full, &keys[7]) == &keys[7]);
+
+        for (int i = 0; i < TEST_N / 2; ++i) {
+            int k = (i * 769) % TEST_N;
+            xassert(xprbtree_snap_get(half, &keys[k]) == &keys[k]);
+        }
+        for (int i = TEST_N / 2; i < TEST_N; ++i) {
+            int k = (i * 769) % TEST_N;
+            xassert(!xprbtree_snap_find(half, &keys[k]));
+        }
+
+        /* xprbtree_snap_select */
+        /* xprbtree_snap_rank */
+        for (int i = 0; i < TEST_N; ++i) {
+            xassert(xprbtree_snap_select(full, i) == &keys[i]);
+            xassert(xprbtree_snap_rank(full, &keys[i]) == i);
+        }
+
+        /* xprbtree_snap_min */
+        /* xprbtree_snap_max */
+        /* xprbtree_snap_floor */
+        /* xprbtree_snap_ceiling */
+        {
+            int key = -1;
+            xassert(xprbtree_snap_min(full) == &keys[0]);
+            xassert(xprbtree_snap_max(full) == &keys[TEST_N - 1]);
+            xassert(!xprbtree_snap_floor(full, &key));
+            xassert(xprbtree_snap_ceiling(full, &key) == &keys[0]);
+
+            key = TEST_N;
+            xassert(xprbtree_snap_floor(full, &key) == &keys[TEST_N - 1]);
+            xassert(!xprbtree_snap_ceiling(full, &key));
+        }
+
+        /* xprbtree_snap_map_min_to_max */
+        {
+            int last = -1;
+            xassert(xprbtree_snap_map_min_to_max(full, xprbtree_test_map_ordered, &last) == TEST_N);
+            xassert(last == TEST_N - 1);
+        }
+
+        /* xprbtree_remove */
+        {
+            XPRBTree_Snap_PT snap = NULL;
+            int key = TEST_N;
+
+            xassert(!xprbtree_remove(tree, &key));
+
+            for (int i = 0; i < TEST_N; i += 2) {
+                int k = (i * 769) % TEST_N;
+                xassert(xprbtree_remove(tree, &keys[k]));
+                xassert(!xprbtree_remove(tree, &keys[k]));
+            }
+            xassert(xprbtree_size(tree) == TEST_N / 2);
+
+            snap = xprbtree_snapshot(tree);
+            xassert(xprbtree_snap_is_rbtree(snap));
+            xassert(xprbtree_snap_size(snap) == TEST_N / 2);
+            for (int i = 0; i < TEST_N; i += 2) {
+                int k = (i * 769) % TEST_N;
+                xassert(!xprbtree_snap_find(snap, &keys[k]));
+                xassert(xprbtree_snap_find(full, &keys[k]));
+            }
+
+            /* the old snapshots are still valid */
+            xassert(xprbtree_snap_size(full) == TEST_N);
+            xassert(xprbtree_snap_is_rbtree(full));
+            xassert(xprbtree_snap_size(half) == TEST_N / 2);
+            xassert(xprbtree_snap_is_rbtree(half));
+
+            /* remove all */
+            for (int i = 0; i < TEST_N; ++i) {
+                xprbtree_remove(tree, &keys[i]);
+            }
+            xassert(xprbtree_is_empty(tree));
+            xassert(xprbtree_snap_size(snap) == TEST_N / 2);
+            xassert(xprbtree_snap_is_rbtree(snap));
+
+            xprbtree_snap_free(&snap);
+        }
+
+        xprbtree_snap_free(&empty);
+        xprbtree_snap_free(&half);
+
+        /* the snapshot is valid after the tree is freed */
+        xprbtree_free(&tree);
+        xassert(xprbtree_snap_size(full) == TEST_N);
+        xassert(xprbtree_snap_is_rbtree(full));
+        xprbtree_snap_free(&full);
+    }
+
+    /* readers use the snapshots while the writers put and remove */
+    {
+        XPRBTree_PT tree = xprbtree_new(test_cmpi, NULL);
+        XPRBTree_Snap_PT empty = xprbtree_snapshot(tree);
+        pthread_t writers[XPRBTREE_TEST_WRITERS];
+        pthread_t readers[XPRBTREE_TEST_READERS];
+        XPRBTree_Test_Thread_T wparas[XPRBTREE_TEST_WRITERS];
+        XPRBTree_Test_Thread_T rparas[XPRBTREE_TEST_READERS];
+
+        for (int i = 0; i < XPRBTREE_TEST_KEYS; ++i) {
+            xprbtree_test_keys[i] = i;
+        }
+        __atomic_store_n(&xprbtree_test_writers_done, 0, __ATOMIC_RELEASE);
+
+        for (int i = 0; i < XPRBTREE_TEST_READERS; ++i) {
+            rparas[i].tree = tree;
+            rparas[i].id = i;
+            rparas[i].snaps = 0;
+            pthread_create(&readers[i], NULL, xprbtree_test_reader_thread, (void*)&rparas[i]);
+        }
+        for (int i = 0; i < XPRBTREE_TEST_WRITERS; ++i) {
+            wparas[i].tree = tree;
+            wparas[i].id = i;
+            wparas[i].snaps = 0;
+            pthread_create(&writers[i], NULL, xprbtree_test_writer_thread, (void*)&wparas[i]);
+        }
+
+        for (int i = 0; i < XPRBTREE_TEST_WRITERS; ++i) {
+            pthread_join(writers[i], NULL);
+        }
+        __atomic_store_n(&xprbtree_test_writers_done, 1, __ATOMIC_RELEASE);
+        for (int i = 0; i < XPRBTREE_TEST_READERS; ++i) {
+            pthread_join(readers[i], NULL);
+            xassert(0 < rparas[i].snaps);
+        }
+
+        /* the rounds end with removing */
+        xassert(xprbtree_is_empty(tree));
+        xassert(xprbtree_snap_is_empty(empty));
+
+        xprbtree_snap_free(&empty);
+        xprbtree_free(&tree);
+    }
+
+    {
+        int count = 0;
+        xmem_leak(check_mem_leak, &count);
+        xassert(count == 0);
+    }
+}
+
+#endif
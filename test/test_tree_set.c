@@ -99,7 +99,7 @@ void xset_print_impl(XSet_Node_PT node, int h) {
 
     xset_print_impl(node->right, h + 3);
 
-    xset_printnode((char*)node->key, (char*)node->values->value, node->color, h);
+    xset_printnode((char*)node->key, (char*)xlistrbtree_values_front(&node->values), xlistrbtree_node_color(node), h);
 
     xset_print_impl(node->left, h + 3);
 }
@@ -121,6 +121,28 @@ void xset_print(XSet_PT tree, int start_blank) {
     xset_print_impl(tree->root, start_blank + 3);
 }
 
+#if defined(__linux__)
+/* the parallel one returns the same nodes as the serial one */
+static
+void xset_test_parallel(XSet_PT (*parallel)(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool), XSet_PT (*serial)(XSet_PT set1, XSet_PT set2), XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool, int size) {
+    XSet_PT set = parallel(set1, set2, pool);
+    XSet_PT expect = serial(set1, set2);
+
+    xassert(xset_size(set) == size);
+    xassert(xset_size(expect) == size);
+    xassert(xset_equal(set, expect));
+    xassert(xlistrbtree_is_rbtree(set));
+
+    for (XSet_Node_PT node = xlistrbtree_min_impl(expect, expect->root); node; node = xlistrbtree_next_node(expect, node)) {
+        xassert(xset_elem_size(set, node->key) == node->node_size);
+        xassert(xset_get(set, node->key) == xset_get(expect, node->key));
+    }
+
+    xset_free(&set);
+    xset_free(&expect);
+}
+#endif
+
 static
 void check_mem_leak(const void *ptr, long size, const char *file, int line, void *cl) {
     (*(int*)cl) += 1;
@@ -541,6 +563,360 @@ void test_xset() {
     {
     }
 
+    /* xset_build_sorted */
+    {
+        char strs[300][8];
+        void *elems[300];
+
+        for (int i = 0; i < 300; ++i) {
+            sprintf(strs[i], "%03d", i / 3 * 3);  /* "repeat" elems : 000 000 000 003 003 003 ... */
+            elems[i] = strs[i];
+        }
+
+        for (int count = 0; count <= 64; ++count) {
+            XSet_PT set = xset_new(test_cmpk, NULL);
+            xassert(xset_build_sorted(set, elems, count));
+            xassert(xset_size(set) == count);
+            xassert(xlistrbtree_is_rbtree(set));
+            xset_free(&set);
+        }
+
+        {
+            XSet_PT set = xset_new(test_cmpk, NULL);
+            xassert(xset_build_sorted(set, elems, 300));
+            xassert(xset_size(set) == 300);
+            xassert(xlistrbtree_is_rbtree(set));
+
+            for (int i = 0; i < 300; i += 3) {
+                xassert(xset_elem_size(set, elems[i]) == 3);
+                xassert(strcmp(xset_select(set, i + 2), elems[i]) == 0);
+            }
+            xassert_false(xset_find(set, "001"));
+
+            /* the set works as usual after building */
+            xassert(xset_put_repeat(set, "001"));
+            xset_remove_all(set, "150");
+            xassert(xset_size(set) == 298);
+            xassert(xlistrbtree_is_rbtree(set));
+
+            /* set is not empty */
+            {
+                bool except = false;
+
+                XEXCEPT_TRY
+                    xset_build_sorted(set, elems, 300);
+                XEXCEPT_ELSE
+                    except = true;
+                XEXCEPT_END_TRY
+
+                xassert(except);
+            }
+
+            xset_free(&set);
+        }
+
+        /* elems are not sorted */
+        {
+            XSet_PT set = xset_new(test_cmpk, NULL);
+            void *telems[3] = { "1", "3", "2" };
+            xassert_false(xset_build_sorted(set, telems, 3));
+            xassert(xset_is_empty(set));
+            xset_free(&set);
+        }
+    }
+
+    /* xset_union */
+    /* xset_inter */
+    /* xset_minus */
+    /* xset_diff */
+    /* xset_subset */
+    /* xset_equal */
+    {
+        char strs[1000][8];
+        XSet_PT set2 = xset_new(test_cmpk, NULL);  /* 0, 2, 4, ... */
+        XSet_PT set3 = xset_new(test_cmpk, NULL);  /* 0, 3, 6, ... */
+        XSet_PT small = xset_new(test_cmpk, NULL); /* 6, 7 */
+        XSet_PT empty = xset_new(test_cmpk, NULL);
+
+        for (int i = 0; i < 1000; ++i) {
+            sprintf(strs[i], "%04d", i);
+            if (i % 2 == 0) {
+                xset_put_repeat(set2, strs[i]);
+            }
+            if (i % 3 == 0) {
+                xset_put_repeat(set3, strs[i]);
+            }
+        }
+        xset_put_repeat(set2, "0000");      /* "0000" is repeat in set2 */
+        xset_put_repeat(small, strs[6]);
+        xset_put_repeat(small, strs[7]);
+
+        {
+            XSet_PT set = xset_union(set2, set3);
+            xassert(xset_size(set) == 667 + 1);
+            xassert(xset_elem_size(set, "0000") == 2);
+            xassert(xset_find(set, "0003") && xset_find(set, "0004") && !xset_find(set, "0005"));
+            xassert(xlistrbtree_is_rbtree(set));
+            xassert(xset_subset(set, set2) && xset_subset(set, set3));
+            xset_free(&set);
+        }
+
+        {
+            XSet_PT set = xset_inter(set2, set3);
+            xassert(xset_size(set) == 167 + 1);
+            xassert(xset_find(set, "0006") && !xset_find(set, "0004") && !xset_find(set, "0003"));
+            xassert(xlistrbtree_is_rbtree(set));
+            xassert(xset_subset(set2, set) && xset_subset(set3, set));
+            xset_free(&set);
+        }
+
+        {
+            XSet_PT set = xset_minus(set2, set3);
+            xassert(xset_size(set) == 333);
+            xassert(xset_find(set, "0004") && !xset_find(set, "0006") && !xset_find(set, "0003"));
+            xassert(xlistrbtree_is_rbtree(set));
+            xset_free(&set);
+        }
+
+        {
+            XSet_PT set = xset_diff(set2, set3);
+            xassert(xset_size(set) == 500);
+            xassert(xset_find(set, "0004") && xset_find(set, "0003") && !xset_find(set, "0006"));
+            xassert(xlistrbtree_is_rbtree(set));
+            xset_free(&set);
+        }
+
+        /* the smaller set is searched in the bigger one */
+        {
+            XSet_PT set = xset_inter(small, set2);
+            xassert(xset_size(set) == 1);
+            xassert(xset_get(set, "0006") == strs[6]);
+            xset_free(&set);
+
+            set = xset_inter(set2, small);
+            xassert(xset_size(set) == 1);
+            xassert(xset_get(set, "0006") == strs[6]);
+            xset_free(&set);
+
+            set = xset_minus(small, set2);
+            xassert(xset_size(set) == 1);
+            xassert(xset_get(set, "0007") == strs[7]);
+            xset_free(&set);
+
+            xassert_false(xset_subset(set2, small));
+            xset_remove(small, "0007");
+            xassert(xset_subset(set2, small));
+            xassert_false(xset_subset(small, set2));
+        }
+
+        /* with empty set */
+        {
+            XSet_PT set = xset_inter(set2, empty);
+            xassert(xset_is_empty(set));
+            xset_free(&set);
+
+            set = xset_union(empty, set3);
+            xassert(xset_equal(set, set3));
+            xassert_false(xset_equal(set, set2));
+            xset_free(&set);
+
+            xassert(xset_subset(set2, empty));
+            xassert(xset_equal(empty, empty));
+        }
+
+        xset_free(&set2);
+        xset_free(&set3);
+        xset_free(&small);
+        xset_free(&empty);
+    }
+
+#if defined(__linux__)
+    /* xset_parallel_union */
+    /* xset_parallel_inter */
+    /* xset_parallel_minus */
+    /* xset_parallel_diff */
+    {
+        static char strs[30000][8];
+        XSet_PT set2 = xset_new(test_cmpk, NULL);  /* 0, 2, 4, ... */
+        XSet_PT set3 = xset_new(test_cmpk, NULL);  /* 0, 3, 6, ... */
+        XSet_PT small = xset_new(test_cmpk, NULL); /* 6, 7 */
+        XSet_PT empty = xset_new(test_cmpk, NULL);
+        XSThreadPool_PT pool = xsthreadpool_init(3, -1, 5000);
+        xassert(pool);
+
+        /* set1 == NULL */
+        {
+            bool except = false;
+
+            XEXCEPT_TRY
+                xset_parallel_union(NULL, set2, pool);
+            XEXCEPT_ELSE
+                except = true;
+            XEXCEPT_END_TRY
+
+            xassert(except);
+        }
+
+        for (int i = 0; i < 30000; ++i) {
+            sprintf(strs[i], "%05d", i);
+            if (i % 2 == 0) {
+                xset_put_repeat(set2, strs[i]);
+            }
+            if (i % 3 == 0) {
+                xset_put_repeat(set3, strs[i]);
+            }
+        }
+        xset_put_repeat(set2, "00000");     /* "00000" is repeat in set2 */
+        xset_put_repeat(small, strs[6]);
+        xset_put_repeat(small, strs[7]);
+
+        /* the ranges are all done in the caller if pool is NULL, the node of set1 is kept for the elems in both sets */
+        for (int i = 0; i < 2; ++i) {
+            XSThreadPool_PT tpool = i ? pool : NULL;
+
+            xset_test_parallel(xset_parallel_union, xset_union, set2, set3, tpool, 20000 + 1);
+            xset_test_parallel(xset_parallel_union, xset_union, set3, set2, tpool, 20000);
+            xset_test_parallel(xset_parallel_inter, xset_inter, set2, set3, tpool, 5000 + 1);
+            xset_test_parallel(xset_parallel_inter, xset_inter, set3, set2, tpool, 5000);
+            xset_test_parallel(xset_parallel_minus, xset_minus, set2, set3, tpool, 10000);
+            xset_test_parallel(xset_parallel_minus, xset_minus, set3, set2, tpool, 5000);
+            xset_test_parallel(xset_parallel_diff, xset_diff, set2, set3, tpool, 15000);
+            xset_test_parallel(xset_parallel_diff, xset_diff, set2, set2, tpool, 0);
+
+            /* the smaller set is searched in the bigger one */
+            xset_test_parallel(xset_parallel_inter, xset_inter, small, set2, tpool, 1);
+            xset_test_parallel(xset_parallel_minus, xset_minus, small, set2, tpool, 1);
+
+            /* with empty set */
+            xset_test_parallel(xset_parallel_union, xset_union, empty, set3, tpool, 10000);
+            xset_test_parallel(xset_parallel_diff, xset_diff, set2, empty, tpool, 15000 + 1);
+            xset_test_parallel(xset_parallel_union, xset_union, empty, empty, tpool, 0);
+        }
+
+        xsthreadpool_destroy(pool);
+        xset_free(&set2);
+        xset_free(&set3);
+        xset_free(&small);
+        xset_free(&empty);
+    }
+#endif
+
+    /* xset_cursor_init */
+    /* xset_cursor_first */
+    /* xset_cursor_last */
+    /* xset_cursor_seek */
+    /* xset_cursor_next */
+    /* xset_cursor_prev */
+    {
+        char strs[300][8];
+        XSet_PT set = xset_new(test_cmpk, NULL);
+        XSet_Cursor_T cursor;
+
+        xset_cursor_init(&cursor, set);
+        xassert_false(xset_cursor_valid(&cursor));
+        xassert_false(xset_cursor_first(&cursor));
+        xassert_false(xset_cursor_seek(&cursor, "000"));
+        xassert(!xset_cursor_elem(&cursor));
+
+        /* "000" "000" "000" "003" "003" "003" ... */
+        for (int i = 0; i < 300; ++i) {
+            sprintf(strs[i], "%03d", i / 3 * 3);
+            xset_put_repeat(set, strs[i]);
+        }
+
+        {
+            int count = 0;
+            char *last = NULL;
+            for (bool ok = xset_cursor_first(&cursor); ok; ok = xset_cursor_next(&cursor)) {
+                xassert(!last || (strcmp(last, xset_cursor_elem(&cursor)) <= 0));
+                last = xset_cursor_elem(&cursor);
+                ++count;
+            }
+            xassert(count == 300);
+        }
+
+        {
+            int count = 0;
+            char *last = NULL;
+            for (bool ok = xset_cursor_last(&cursor); ok; ok = xset_cursor_prev(&cursor)) {
+                xassert(!last || (strcmp(xset_cursor_elem(&cursor), last) <= 0));
+                last = xset_cursor_elem(&cursor);
+                ++count;
+            }
+            xassert(count == 300);
+        }
+
+        xassert(xset_cursor_seek(&cursor, "150"));
+        xassert(strcmp(xset_cursor_elem(&cursor), "150") == 0);
+        xassert(xset_cursor_next(&cursor) && xset_cursor_next(&cursor));
+        xassert(strcmp(xset_cursor_elem(&cursor), "150") == 0);
+        xassert(xset_cursor_next(&cursor));
+        xassert(strcmp(xset_cursor_elem(&cursor), "153") == 0);
+        xassert(xset_cursor_prev(&cursor));
+        xassert(strcmp(xset_cursor_elem(&cursor), "150") == 0);
+
+        xassert(xset_cursor_seek(&cursor, "151"));
+        xassert(strcmp(xset_cursor_elem(&cursor), "153") == 0);
+        xassert_false(xset_cursor_seek(&cursor, "298"));
+
+        xset_free(&set);
+    }
+
+    /* xset_split */
+    /* xset_remove_range */
+    {
+        char strs[600][8];
+        XSet_PT set = xset_new(test_cmpk, NULL);
+
+        /* "000" "000" "000" "003" "003" "003" ... put in a shuffled order */
+        for (int i = 0; i < 600; ++i) {
+            int k = (i * 337) % 600;
+            sprintf(strs[k], "%03d", k / 3 * 3);
+            xset_put_repeat(set, strs[k]);
+        }
+
+        for (int i = 0; i <= 600; i += 31) {
+            char elem[8];
+            XSet_PT set1 = xset_copy(set);
+            XSet_PT set2 = NULL;
+
+            sprintf(elem, "%03d", i);
+            set2 = xset_split(set1, elem);
+
+            xassert(xlistrbtree_is_rbtree(set1));
+            xassert(xlistrbtree_is_rbtree(set2));
+            xassert(xset_size(set1) == (i + 2) / 3 * 3);
+            xassert(xset_size(set1) + xset_size(set2) == 600);
+
+            xset_free(&set1);
+            xset_free(&set2);
+        }
+
+        for (int i = 0; i < 600; i += 41) {
+            for (int j = i; j < 700; j += 59) {
+                char low[8], high[8];
+                XSet_PT set1 = xset_copy(set);
+                XSet_PT set2 = NULL;
+
+                sprintf(low, "%03d", i);
+                sprintf(high, "%03d", j);
+                set2 = xset_remove_range(set1, high, low);
+
+                xassert(xlistrbtree_is_rbtree(set1));
+                xassert(xlistrbtree_is_rbtree(set2));
+                xassert(xset_size(set1) + xset_size(set2) == 600);
+                xassert(xset_size(set2) == ((j < 600 ? j : 599) / 3 - (i + 2) / 3 + 1) * 3);
+                xassert(xset_is_empty(set2) || (strcmp(low, xset_select(set2, 0)) <= 0));
+                xassert(xset_is_empty(set2) || (strcmp(xset_select(set2, xset_size(set2) - 1), high) <= 0));
+
+                xset_free(&set1);
+                xset_free(&set2);
+            }
+        }
+
+        xset_free(&set);
+    }
+
     {
         int count = 0;
         xmem_leak(check_mem_leak, &count);
@@ -0,0 +1,1353 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/xassert.h"
+#include "../include/xmem.h"
+#include "../utils/xutils.h"
+#include "xtree_adaptive_radix_x.h"
+
+typedef struct XARTree_Node4*   XARTree_Node4_PT;
+typedef struct XARTree_Node16*  XARTree_Node16_PT;
+typedef struct XARTree_Node48*  XARTree_Node48_PT;
+typedef struct XARTree_Node256* XARTree_Node256_PT;
+
+static
+int xartree_min_int(int x, int y) {
+    return (x < y) ? x : y;
+}
+
+static
+bool xartree_is_leaf(XARTree_Node_PT node) {
+    return ((uintptr_t)node & 1) != 0;
+}
+
+static
+XARTree_Leaf_PT xartree_to_leaf(XARTree_Node_PT node) {
+    return (XARTree_Leaf_PT)((uintptr_t)node & ~(uintptr_t)1);
+}
+
+static
+XARTree_Node_PT xartree_from_leaf(XARTree_Leaf_PT leaf) {
+    return (XARTree_Node_PT)((uintptr_t)leaf | 1);
+}
+
+static
+int xartree_key_len(void *key) {
+    return (int)strlen((char*)key) + 1;
+}
+
+static
+XARTree_Leaf_PT xartree_new_leaf(void *key, int key_len, void *value) {
+    XARTree_Leaf_PT leaf = XMEM_CALLOC(1, sizeof(*leaf));
+    if (!leaf) {
+        return NULL;
+    }
+
+    leaf->key = key;
+    leaf->value = value;
+    leaf->key_len = key_len;
+
+    return leaf;
+}
+
+static
+bool xartree_leaf_match(XARTree_Leaf_PT leaf, unsigned char *key, int key_len) {
+    return (leaf->key_len == key_len) && (memcmp(leaf->key, key, key_len) == 0);
+}
+
+static
+int xartree_node_size(unsigned char type) {
+    switch (type) {
+    case XARTREE_NODE4:
+        return sizeof(struct XARTree_Node4);
+    case XARTREE_NODE16:
+        return sizeof(struct XARTree_Node16);
+    case XARTREE_NODE48:
+        return sizeof(struct XARTree_Node48);
+    default:
+        return sizeof(struct XARTree_Node256);
+    }
+}
+
+static
+XARTree_Node_PT xartree_new_node(unsigned char type) {
+    XARTree_Node_PT node = XMEM_CALLOC(1, xartree_node_size(type));
+    if (!node) {
+        return NULL;
+    }
+
+    node->type = type;
+
+    return node;
+}
+
+static
+void xartree_copy_header(XARTree_Node_PT dest, XARTree_Node_PT src) {
+    dest->count = src->count;
+    dest->prefix_len = src->prefix_len;
+    memcpy(dest->prefix, src->prefix, xartree_min_int(src->prefix_len, XARTREE_MAX_PREFIX_LEN));
+}
+
+/* the children array of node, *num is the array length (not the children number) */
+static
+XARTree_Node_PT* xartree_children(XARTree_Node_PT node, int *num) {
+    switch (node->type) {
+    case XARTREE_NODE4:
+        *num = node->count;
+        return ((XARTree_Node4_PT)node)->children;
+    case XARTREE_NODE16:
+        *num = node->count;
+        return ((XARTree_Node16_PT)node)->children;
+    case XARTREE_NODE48:
+        *num = 48;
+        return ((XARTree_Node48_PT)node)->children;
+    default:
+        *num = 256;
+        return ((XARTree_Node256_PT)node)->children;
+    }
+}
+
+/* children are visited in key order by i in [0, xartree_child_end(node)) :
+ *   i is the position for node4 and node16, and the byte for node48 and node256
+ */
+static
+int xartree_child_end(XARTree_Node_PT node) {
+    return ((node->type == XARTREE_NODE4) || (node->type == XARTREE_NODE16)) ? node->count : 256;
+}
+
+static
+XARTree_Node_PT xartree_child(XARTree_Node_PT node, int i) {
+    switch (node->type) {
+    case XARTREE_NODE4:
+        return ((XARTree_Node4_PT)node)->children[i];
+    case XARTREE_NODE16:
+        return ((XARTree_Node16_PT)node)->children[i];
+    case XARTREE_NODE48:
+        {
+            XARTree_Node48_PT node48 = (XARTree_Node48_PT)node;
+            return node48->index[i] ? node48->children[node48->index[i] - 1] : NULL;
+        }
+    default:
+        return ((XARTree_Node256_PT)node)->children[i];
+    }
+}
+
+static
+unsigned char xartree_child_byte(XARTree_Node_PT node, int i) {
+    switch (node->type) {
+    case XARTREE_NODE4:
+        return ((XARTree_Node4_PT)node)->keys[i];
+    case XARTREE_NODE16:
+        return ((XARTree_Node16_PT)node)->keys[i];
+    default:
+        return (unsigned char)i;
+    }
+}
+
+static
+XARTree_Node_PT* xartree_find_child(XARTree_Node_PT node, unsigned char c) {
+    switch (node->type) {
+    case XARTREE_NODE4:
+        {
+            XARTree_Node4_PT node4 = (XARTree_Node4_PT)node;
+            for (int i = 0; i < node->count; ++i) {
+                if (node4->keys[i] == c) {
+                    return &node4->children[i];
+                }
+            }
+            return NULL;
+        }
+    case XARTREE_NODE16:
+        {
+            XARTree_Node16_PT node16 = (XARTree_Node16_PT)node;
+            for (int i = 0; i < node->count; ++i) {
+                if (node16->keys[i] == c) {
+                    return &node16->children[i];
+                }
+            }
+            return NULL;
+        }
+    case XARTREE_NODE48:
+        {
+            XARTree_Node48_PT node48 = (XARTree_Node48_PT)node;
+            return node48->index[c] ? &node48->children[node48->index[c] - 1] : NULL;
+        }
+    default:
+        {
+            XARTree_Node256_PT node256 = (XARTree_Node256_PT)node;
+            return node256->children[c] ? &node256->children[c] : NULL;
+        }
+    }
+}
+
+static
+XARTree_Leaf_PT xartree_minimum(XARTree_Node_PT node) {
+    while (node && !xartree_is_leaf(node)) {
+        XARTree_Node_PT child = NULL;
+        for (int i = 0; !child && (i < xartree_child_end(node)); ++i) {
+            child = xartree_child(node, i);
+        }
+        node = child;
+    }
+
+    return node ? xartree_to_leaf(node) : NULL;
+}
+
+static
+XARTree_Leaf_PT xartree_maximum(XARTree_Node_PT node) {
+    while (node && !xartree_is_leaf(node)) {
+        XARTree_Node_PT child = NULL;
+        for (int i = xartree_child_end(node) - 1; !child && (0 <= i); --i) {
+            child = xartree_child(node, i);
+        }
+        node = child;
+    }
+
+    return node ? xartree_to_leaf(node) : NULL;
+}
+
+/* the first "prefix_len" bytes of the path to node, starting from depth */
+static
+unsigned char* xartree_prefix_bytes(XARTree_Node_PT node, int depth) {
+    if (node->prefix_len <= XARTREE_MAX_PREFIX_LEN) {
+        return node->prefix;
+    }
+
+    return (unsigned char*)xartree_minimum(node)->key + depth;
+}
+
+/* how many bytes of the saved prefix are matched, the bytes not saved are skipped (checked by the leaf at last) */
+static
+int xartree_check_prefix(XARTree_Node_PT node, unsigned char *key, int key_len, int depth) {
+    int max = xartree_min_int(xartree_min_int(node->prefix_len, XARTREE_MAX_PREFIX_LEN), key_len - depth);
+
+    int i = 0;
+    for (; i < max; ++i) {
+        if (node->prefix[i] != key[depth + i]) {
+            return i;
+        }
+    }
+
+    return i;
+}
+
+/* how many bytes of the full prefix are matched */
+static
+int xartree_prefix_mismatch(XARTree_Node_PT node, unsigned char *key, int key_len, int depth) {
+    int max = xartree_min_int(node->prefix_len, key_len - depth);
+    unsigned char *bytes = xartree_prefix_bytes(node, depth);
+
+    int i = 0;
+    for (; i < max; ++i) {
+        if (bytes[i] != key[depth + i]) {
+            return i;
+        }
+    }
+
+    return i;
+}
+
+/* compare key[depth, ...) with the full prefix of node : -1 (less), 0 (equal), 1 (greater) */
+static
+int xartree_prefix_cmp(XARTree_Node_PT node, unsigned char *key, int key_len, int depth) {
+    unsigned char *bytes = xartree_prefix_bytes(node, depth);
+
+    for (int i = 0; i < node->prefix_len; ++i) {
+        if (key_len <= depth + i) {
+            return -1;
+        }
+        if (key[depth + i] != bytes[i]) {
+            return (key[depth + i] < bytes[i]) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+static
+bool xartree_add_child(XARTree_Node_PT node, XARTree_Node_PT *ref, unsigned char c, XARTree_Node_PT child);
+
+static
+bool xartree_add_child4(XARTree_Node4_PT node, XARTree_Node_PT *ref, unsigned char c, XARTree_Node_PT child) {
+    if (node->node.count < 4) {
+        int i = 0;
+        while ((i < node->node.count) && (node->keys[i] < c)) {
+            ++i;
+        }
+
+        memmove(node->keys + i + 1, node->keys + i, node->node.count - i);
+        memmove(node->children + i + 1, node->children + i, (node->node.count - i) * sizeof(node->children[0]));
+
+        node->keys[i] = c;
+        node->children[i] = child;
+        ++node->node.count;
+
+        return true;
+    }
+
+    {
+        XARTree_Node16_PT nnode = (XARTree_Node16_PT)xartree_new_node(XARTREE_NODE16);
+        if (!nnode) {
+            return false;
+        }
+
+        xartree_copy_header(&nnode->node, &node->node);
+        memcpy(nnode->keys, node->keys, 4);
+        memcpy(nnode->children, node->children, 4 * sizeof(node->children[0]));
+
+        *ref = (XARTree_Node_PT)nnode;
+        XMEM_FREE(node);
+
+        return xartree_add_child(*ref, ref, c, child);
+    }
+}
+
+static
+bool xartree_add_child16(XARTree_Node16_PT node, XARTree_Node_PT *ref, unsigned char c, XARTree_Node_PT child) {
+    if (node->node.count < 16) {
+        int i = 0;
+        while ((i < node->node.count) && (node->keys[i] < c)) {
+            ++i;
+        }
+
+        memmove(node->keys + i + 1, node->keys + i, node->node.count - i);
+        memmove(node->children + i + 1, node->children + i, (node->node.count - i) * sizeof(node->children[0]));
+
+        node->keys[i] = c;
+        node->children[i] = child;
+        ++node->node.count;
+
+        return true;
+    }
+
+    {
+        XARTree_Node48_PT nnode = (XARTree_Node48_PT)xartree_new_node(XARTREE_NODE48);
+        if (!nnode) {
+            return false;
+        }
+
+        xartree_copy_header(&nnode->node, &node->node);
+        for (int i = 0; i < 16; ++i) {
+            nnode->index[node->keys[i]] = (unsigned char)(i + 1);
+            nnode->children[i] = node->children[i];
+        }
+
+        *ref = (XARTree_Node_PT)nnode;
+        XMEM_FREE(node);
+
+        return xartree_add_child(*ref, ref, c, child);
+    }
+}
+
+static
+bool xartree_add_child48(XARTree_Node48_PT node, XARTree_Node_PT *ref, unsigned char c, XARTree_Node_PT child) {
+    if (node->node.count < 48) {
+        int i = 0;
+        while (node->children[i]) {
+            ++i;
+        }
+
+        node->index[c] = (unsigned char)(i + 1);
+        node->children[i] = child;
+        ++node->node.count;
+
+        return true;
+    }
+
+    {
+        XARTree_Node256_PT nnode = (XARTree_Node256_PT)xartree_new_node(XARTREE_NODE256);
+        if (!nnode) {
+            return false;
+        }
+
+        xartree_copy_header(&nnode->node, &node->node);
+        for (int i = 0; i < 256; ++i) {
+            if (node->index[i]) {
+                nnode->children[i] = node->children[node->index[i] - 1];
+            }
+        }
+
+        *ref = (XARTree_Node_PT)nnode;
+        XMEM_FREE(node);
+
+        return xartree_add_child(*ref, ref, c, child);
+    }
+}
+
+/* add child for byte c, node grows into a bigger one (*ref is changed) if it is full */
+static
+bool xartree_add_child(XARTree_Node_PT node, XARTree_Node_PT *ref, unsigned char c, XARTree_Node_PT child) {
+    switch (node->type) {
+    case XARTREE_NODE4:
+        return xartree_add_child4((XARTree_Node4_PT)node, ref, c, child);
+    case XARTREE_NODE16:
+        return xartree_add_child16((XARTree_Node16_PT)node, ref, c, child);
+    case XARTREE_NODE48:
+        return xartree_add_child48((XARTree_Node48_PT)node, ref, c, child);
+    default:
+        ((XARTree_Node256_PT)node)->children[c] = child;
+        ++node->count;
+        return true;
+    }
+}
+
+static
+void xartree_remove_child256(XARTree_Node256_PT node, XARTree_Node_PT *ref, unsigned char c) {
+    node->children[c] = NULL;
+    --node->node.count;
+
+    /* shrink a little later than the growth to avoid growing and shrinking again and again */
+    if (node->node.count == 37) {
+        XARTree_Node48_PT nnode = (XARTree_Node48_PT)xartree_new_node(XARTREE_NODE48);
+        if (!nnode) {
+            return;
+        }
+
+        xartree_copy_header(&nnode->node, &node->node);
+        for (int i = 0, pos = 0; i < 256; ++i) {
+            if (node->children[i]) {
+                nnode->children[pos] = node->children[i];
+                nnode->index[i] = (unsigned char)(++pos);
+            }
+        }
+
+        *ref = (XARTree_Node_PT)nnode;
+        XMEM_FREE(node);
+    }
+}
+
+static
+void xartree_remove_child48(XARTree_Node48_PT node, XARTree_Node_PT *ref, unsigned char c) {
+    node->children[node->index[c] - 1] = NULL;
+    node->index[c] = 0;
+    --node->node.count;
+
+    if (node->node.count == 12) {
+        XARTree_Node16_PT nnode = (XARTree_Node16_PT)xartree_new_node(XARTREE_NODE16);
+        if (!nnode) {
+            return;
+        }
+
+        xartree_copy_header(&nnode->node, &node->node);
+        for (int i = 0, pos = 0; i < 256; ++i) {
+            if (node->index[i]) {
+                nnode->keys[pos] = (unsigned char)i;
+                nnode->children[pos] = node->children[node->index[i] - 1];
+                ++pos;
+            }
+        }
+
+        *ref = (XARTree_Node_PT)nnode;
+        XMEM_FREE(node);
+    }
+}
+
+static
+void xartree_remove_child16(XARTree_Node16_PT node, XARTree_Node_PT *ref, XARTree_Node_PT *slot) {
+    int i = (int)(slot - node->children);
+
+    memmove(node->keys + i, node->keys + i + 1, node->node.count - 1 - i);
+    memmove(node->children + i, node->children + i + 1, (node->node.count - 1 - i) * sizeof(node->children[0]));
+    --node->node.count;
+
+    if (node->node.count == 3) {
+        XARTree_Node4_PT nnode = (XARTree_Node4_PT)xartree_new_node(XARTREE_NODE4);
+        if (!nnode) {
+            return;
+        }
+
+        xartree_copy_header(&nnode->node, &node->node);
+        memcpy(nnode->keys, node->keys, 3);
+        memcpy(nnode->children, node->children, 3 * sizeof(node->children[0]));
+
+        *ref = (XARTree_Node_PT)nnode;
+        XMEM_FREE(node);
+    }
+}
+
+static
+void xartree_remove_child4(XARTree_Node4_PT node, XARTree_Node_PT *ref, XARTree_Node_PT *slot) {
+    int i = (int)(slot - node->children);
+
+    memmove(node->keys + i, node->keys + i + 1, node->node.count - 1 - i);
+    memmove(node->children + i, node->children + i + 1, (node->node.count - 1 - i) * sizeof(node->children[0]));
+    --node->node.count;
+
+    /* only one child left, merge node into it */
+    if (node->node.count == 1) {
+        XARTree_Node_PT child = node->children[0];
+
+        if (!xartree_is_leaf(child)) {
+            int prefix = node->node.prefix_len;
+            if (prefix < XARTREE_MAX_PREFIX_LEN) {
+                node->node.prefix[prefix] = node->keys[0];
+                ++prefix;
+            }
+            if (prefix < XARTREE_MAX_PREFIX_LEN) {
+                int sub_prefix = xartree_min_int(child->prefix_len, XARTREE_MAX_PREFIX_LEN - prefix);
+                memcpy(node->node.prefix + prefix, child->prefix, sub_prefix);
+                prefix += sub_prefix;
+            }
+
+            memcpy(child->prefix, node->node.prefix, xartree_min_int(prefix, XARTREE_MAX_PREFIX_LEN));
+            child->prefix_len += node->node.prefix_len + 1;
+        }
+
+        *ref = child;
+        XMEM_FREE(node);
+    }
+}
+
+/* remove the child saved in slot for byte c, node shrinks into a smaller one (*ref is changed) if it is sparse */
+static
+void xartree_remove_child(XARTree_Node_PT node, XARTree_Node_PT *ref, unsigned char c, XARTree_Node_PT *slot) {
+    switch (node->type) {
+    case XARTREE_NODE4:
+        xartree_remove_child4((XARTree_Node4_PT)node, ref, slot);
+        break;
+    case XARTREE_NODE16:
+        xartree_remove_child16((XARTree_Node16_PT)node, ref, slot);
+        break;
+    case XARTREE_NODE48:
+        xartree_remove_child48((XARTree_Node48_PT)node, ref, c);
+        break;
+    default:
+        xartree_remove_child256((XARTree_Node256_PT)node, ref, c);
+        break;
+    }
+}
+
+static
+void xartree_free_impl(XARTree_Node_PT node, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!node) {
+        return;
+    }
+
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+        if (deep) {
+            XMEM_FREE(leaf->key);
+            XMEM_FREE(leaf->value);
+        }
+        else if (apply) {
+            apply(leaf->key, &leaf->value, cl);
+        }
+        XMEM_FREE(leaf);
+        return;
+    }
+
+    {
+        int num = 0;
+        XARTree_Node_PT *children = xartree_children(node, &num);
+        for (int i = 0; i < num; ++i) {
+            xartree_free_impl(children[i], deep, apply, cl);
+        }
+    }
+
+    XMEM_FREE(node);
+}
+
+XARTree_PT xartree_new(void) {
+    XARTree_PT tree = XMEM_CALLOC(1, sizeof(*tree));
+    if (!tree) {
+        return NULL;
+    }
+
+    //tree->root = NULL;
+    //tree->size = 0;
+
+    return tree;
+}
+
+static
+XARTree_Node_PT xartree_copy_impl(XARTree_Node_PT node, bool deep, int value_size) {
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+        XARTree_Leaf_PT nleaf = xartree_new_leaf(leaf->key, leaf->key_len, leaf->value);
+        if (!nleaf) {
+            return NULL;
+        }
+
+        if (deep) {
+            nleaf->key = xutils_deep_copy(leaf->key, leaf->key_len);
+            nleaf->value = (0 < value_size) ? xutils_deep_copy(leaf->value, value_size) : NULL;
+            if (!nleaf->key || (leaf->value && (0 < value_size) && !nleaf->value)) {
+                XMEM_FREE(nleaf->key);
+                XMEM_FREE(nleaf->value);
+                XMEM_FREE(nleaf);
+                return NULL;
+            }
+        }
+
+        return xartree_from_leaf(nleaf);
+    }
+
+    {
+        XARTree_Node_PT nnode = xartree_new_node(node->type);
+        if (!nnode) {
+            return NULL;
+        }
+
+        memcpy(nnode, node, xartree_node_size(node->type));
+
+        {
+            int num = 0;
+            XARTree_Node_PT *nchildren = xartree_children(nnode, &num);
+
+            for (int i = 0; i < num; ++i) {
+                if (!nchildren[i]) {
+                    continue;
+                }
+
+                nchildren[i] = xartree_copy_impl(nchildren[i], deep, value_size);
+                if (!nchildren[i]) {
+                    /* the children not copied yet still point to the source tree */
+                    for (int j = i + 1; j < num; ++j) {
+                        nchildren[j] = NULL;
+                    }
+                    xartree_free_impl(nnode, deep, NULL, NULL);
+                    return NULL;
+                }
+            }
+        }
+
+        return nnode;
+    }
+}
+
+XARTree_PT xartree_copy(XARTree_PT tree) {
+    xassert(tree);
+
+    if (!tree) {
+        return NULL;
+    }
+
+    {
+        XARTree_PT ntree = xartree_new();
+        if (!ntree) {
+            return NULL;
+        }
+
+        if (tree->root) {
+            ntree->root = xartree_copy_impl(tree->root, false, 0);
+            if (!ntree->root) {
+                xartree_free(&ntree);
+                return NULL;
+            }
+        }
+
+        ntree->size = tree->size;
+
+        return ntree;
+    }
+}
+
+XARTree_PT xartree_deep_copy(XARTree_PT tree, int value_size) {
+    xassert(tree);
+    xassert(0 <= value_size);
+
+    if (!tree || (value_size < 0)) {
+        return NULL;
+    }
+
+    {
+        XARTree_PT ntree = xartree_new();
+        if (!ntree) {
+            return NULL;
+        }
+
+        if (tree->root) {
+            ntree->root = xartree_copy_impl(tree->root, true, value_size);
+            if (!ntree->root) {
+                xartree_free(&ntree);
+                return NULL;
+            }
+        }
+
+        ntree->size = tree->size;
+
+        return ntree;
+    }
+}
+
+/* the key is saved already : 0 keep the old value, 1 replace the old value, 2 free the old value and replace it */
+static
+bool xartree_put_impl(XARTree_PT tree, XARTree_Node_PT *ref, int depth, unsigned char *key, int key_len, void *value, void **old_value, int replace) {
+    XARTree_Node_PT node = *ref;
+
+    if (!node) {
+        XARTree_Leaf_PT leaf = xartree_new_leaf(key, key_len, value);
+        if (!leaf) {
+            return false;
+        }
+
+        *ref = xartree_from_leaf(leaf);
+        ++tree->size;
+        return true;
+    }
+
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+
+        if (xartree_leaf_match(leaf, key, key_len)) {
+            if (replace == 2) {
+                XMEM_FREE(leaf->value);
+            }
+            else if ((replace == 1) && old_value) {
+                *old_value = leaf->value;
+            }
+
+            if (replace != 0) {
+                leaf->value = value;
+            }
+            return true;
+        }
+
+        /* split the leaf into a node4 with two leaves */
+        {
+            unsigned char *lkey = (unsigned char*)leaf->key;
+
+            XARTree_Node_PT nnode = xartree_new_node(XARTREE_NODE4);
+            XARTree_Leaf_PT nleaf = xartree_new_leaf(key, key_len, value);
+            if (!nnode || !nleaf) {
+                XMEM_FREE(nnode);
+                XMEM_FREE(nleaf);
+                return false;
+            }
+
+            {
+                int common = 0;
+                while ((depth + common < key_len) && (lkey[depth + common] == key[depth + common])) {
+                    ++common;
+                }
+
+                nnode->prefix_len = common;
+                memcpy(nnode->prefix, key + depth, xartree_min_int(common, XARTREE_MAX_PREFIX_LEN));
+
+                xartree_add_child(nnode, ref, lkey[depth + common], node);
+                xartree_add_child(nnode, ref, key[depth + common], xartree_from_leaf(nleaf));
+            }
+
+            *ref = nnode;
+            ++tree->size;
+            return true;
+        }
+    }
+
+    if (0 < node->prefix_len) {
+        int matched = xartree_prefix_mismatch(node, key, key_len, depth);
+
+        /* split the compressed path, the new node4 has node and the new leaf as children */
+        if (matched < node->prefix_len) {
+            XARTree_Node_PT nnode = xartree_new_node(XARTREE_NODE4);
+            XARTree_Leaf_PT nleaf = xartree_new_leaf(key, key_len, value);
+            if (!nnode || !nleaf) {
+                XMEM_FREE(nnode);
+                XMEM_FREE(nleaf);
+                return false;
+            }
+
+            nnode->prefix_len = matched;
+            memcpy(nnode->prefix, node->prefix, xartree_min_int(matched, XARTREE_MAX_PREFIX_LEN));
+
+            {
+                unsigned char *bytes = xartree_prefix_bytes(node, depth);
+                unsigned char c = bytes[matched];
+
+                node->prefix_len -= matched + 1;
+                memmove(node->prefix, bytes + matched + 1, xartree_min_int(node->prefix_len, XARTREE_MAX_PREFIX_LEN));
+
+                xartree_add_child(nnode, ref, c, node);
+                xartree_add_child(nnode, ref, key[depth + matched], xartree_from_leaf(nleaf));
+            }
+
+            *ref = nnode;
+            ++tree->size;
+            return true;
+        }
+
+        depth += node->prefix_len;
+    }
+
+    {
+        XARTree_Node_PT *slot = xartree_find_child(node, key[depth]);
+        if (slot) {
+            return xartree_put_impl(tree, slot, depth + 1, key, key_len, value, old_value, replace);
+        }
+    }
+
+    {
+        XARTree_Leaf_PT nleaf = xartree_new_leaf(key, key_len, value);
+        if (!nleaf) {
+            return false;
+        }
+
+        if (!xartree_add_child(node, ref, key[depth], xartree_from_leaf(nleaf))) {
+            XMEM_FREE(nleaf);
+            return false;
+        }
+
+        ++tree->size;
+        return true;
+    }
+}
+
+bool xartree_put_unique(XARTree_PT tree, void *key, void *value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_put_impl(tree, &tree->root, 0, (unsigned char*)key, xartree_key_len(key), value, NULL, 0);
+}
+
+bool xartree_put_replace(XARTree_PT tree, void *key, void *value, void **old_value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_put_impl(tree, &tree->root, 0, (unsigned char*)key, xartree_key_len(key), value, old_value, 1);
+}
+
+bool xartree_put_deep_replace(XARTree_PT tree, void *key, void *value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_put_impl(tree, &tree->root, 0, (unsigned char*)key, xartree_key_len(key), value, NULL, 2);
+}
+
+static
+XARTree_Leaf_PT xartree_get_impl(XARTree_PT tree, unsigned char *key) {
+    int key_len = xartree_key_len(key);
+    int depth = 0;
+
+    XARTree_Node_PT node = tree->root;
+    while (node) {
+        if (xartree_is_leaf(node)) {
+            XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+            return xartree_leaf_match(leaf, key, key_len) ? leaf : NULL;
+        }
+
+        if (0 < node->prefix_len) {
+            if (xartree_check_prefix(node, key, key_len, depth) != xartree_min_int(node->prefix_len, XARTREE_MAX_PREFIX_LEN)) {
+                return NULL;
+            }
+            depth += node->prefix_len;
+        }
+
+        if (key_len <= depth) {
+            return NULL;
+        }
+
+        {
+            XARTree_Node_PT *slot = xartree_find_child(node, key[depth]);
+            node = slot ? *slot : NULL;
+            ++depth;
+        }
+    }
+
+    return NULL;
+}
+
+void* xartree_get(XARTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        XARTree_Leaf_PT leaf = xartree_get_impl(tree, (unsigned char*)key);
+        return leaf ? leaf->value : NULL;
+    }
+}
+
+bool xartree_find(XARTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_get_impl(tree, (unsigned char*)key) ? true : false;
+}
+
+void* xartree_min(XARTree_PT tree) {
+    XARTree_Leaf_PT leaf = tree ? xartree_minimum(tree->root) : NULL;
+    return leaf ? leaf->key : NULL;
+}
+
+void* xartree_max(XARTree_PT tree) {
+    XARTree_Leaf_PT leaf = tree ? xartree_maximum(tree->root) : NULL;
+    return leaf ? leaf->key : NULL;
+}
+
+/* the minimum leaf which is not less than key */
+static
+XARTree_Leaf_PT xartree_ceiling_impl(XARTree_Node_PT node, unsigned char *key, int key_len, int depth) {
+    if (!node) {
+        return NULL;
+    }
+
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+        return (strcmp((char*)key, (char*)leaf->key) <= 0) ? leaf : NULL;
+    }
+
+    {
+        int ret = xartree_prefix_cmp(node, key, key_len, depth);
+        if (ret < 0) {
+            return xartree_minimum(node);
+        }
+        if (0 < ret) {
+            return NULL;
+        }
+    }
+
+    depth += node->prefix_len;
+
+    for (int i = 0; i < xartree_child_end(node); ++i) {
+        XARTree_Node_PT child = xartree_child(node, i);
+        if (!child) {
+            continue;
+        }
+
+        {
+            unsigned char c = xartree_child_byte(node, i);
+            if (c == key[depth]) {
+                XARTree_Leaf_PT leaf = xartree_ceiling_impl(child, key, key_len, depth + 1);
+                if (leaf) {
+                    return leaf;
+                }
+            }
+            else if (key[depth] < c) {
+                return xartree_minimum(child);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* the maximum leaf which is not greater than key */
+static
+XARTree_Leaf_PT xartree_floor_impl(XARTree_Node_PT node, unsigned char *key, int key_len, int depth) {
+    if (!node) {
+        return NULL;
+    }
+
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+        return (strcmp((char*)leaf->key, (char*)key) <= 0) ? leaf : NULL;
+    }
+
+    {
+        int ret = xartree_prefix_cmp(node, key, key_len, depth);
+        if (0 < ret) {
+            return xartree_maximum(node);
+        }
+        if (ret < 0) {
+            return NULL;
+        }
+    }
+
+    depth += node->prefix_len;
+
+    for (int i = xartree_child_end(node) - 1; 0 <= i; --i) {
+        XARTree_Node_PT child = xartree_child(node, i);
+        if (!child) {
+            continue;
+        }
+
+        {
+            unsigned char c = xartree_child_byte(node, i);
+            if (c == key[depth]) {
+                XARTree_Leaf_PT leaf = xartree_floor_impl(child, key, key_len, depth + 1);
+                if (leaf) {
+                    return leaf;
+                }
+            }
+            else if (c < key[depth]) {
+                return xartree_maximum(child);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void* xartree_floor(XARTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        XARTree_Leaf_PT leaf = xartree_floor_impl(tree->root, (unsigned char*)key, xartree_key_len(key), 0);
+        return leaf ? leaf->key : NULL;
+    }
+}
+
+void* xartree_ceiling(XARTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        XARTree_Leaf_PT leaf = xartree_ceiling_impl(tree->root, (unsigned char*)key, xartree_key_len(key), 0);
+        return leaf ? leaf->key : NULL;
+    }
+}
+
+/* return the removed leaf (not freed yet), or NULL if key is not found */
+static
+XARTree_Leaf_PT xartree_remove_impl(XARTree_Node_PT *ref, int depth, unsigned char *key, int key_len) {
+    XARTree_Node_PT node = *ref;
+    if (!node) {
+        return NULL;
+    }
+
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+        if (xartree_leaf_match(leaf, key, key_len)) {
+            *ref = NULL;
+            return leaf;
+        }
+        return NULL;
+    }
+
+    if (0 < node->prefix_len) {
+        if (xartree_check_prefix(node, key, key_len, depth) != xartree_min_int(node->prefix_len, XARTREE_MAX_PREFIX_LEN)) {
+            return NULL;
+        }
+        depth += node->prefix_len;
+    }
+
+    if (key_len <= depth) {
+        return NULL;
+    }
+
+    {
+        XARTree_Node_PT *slot = xartree_find_child(node, key[depth]);
+        if (!slot) {
+            return NULL;
+        }
+
+        if (xartree_is_leaf(*slot)) {
+            XARTree_Leaf_PT leaf = xartree_to_leaf(*slot);
+            if (!xartree_leaf_match(leaf, key, key_len)) {
+                return NULL;
+            }
+
+            xartree_remove_child(node, ref, key[depth], slot);
+            return leaf;
+        }
+
+        return xartree_remove_impl(slot, depth + 1, key, key_len);
+    }
+}
+
+static
+bool xartree_remove_save_impl(XARTree_PT tree, void *key, void **value, bool deep) {
+    XARTree_Leaf_PT leaf = xartree_remove_impl(&tree->root, 0, (unsigned char*)key, xartree_key_len(key));
+    if (!leaf) {
+        return false;
+    }
+
+    if (deep) {
+        XMEM_FREE(leaf->key);
+        XMEM_FREE(leaf->value);
+    }
+    else if (value) {
+        *value = leaf->value;
+    }
+
+    XMEM_FREE(leaf);
+    --tree->size;
+
+    return true;
+}
+
+bool xartree_remove(XARTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_remove_save_impl(tree, key, NULL, false);
+}
+
+bool xartree_remove_save(XARTree_PT tree, void *key, void **value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_remove_save_impl(tree, key, value, false);
+}
+
+bool xartree_deep_remove(XARTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xartree_remove_save_impl(tree, key, NULL, true);
+}
+
+void xartree_clear(XARTree_PT tree) {
+    if (tree) {
+        xartree_free_impl(tree->root, false, NULL, NULL);
+        tree->root = NULL;
+        tree->size = 0;
+    }
+}
+
+void xartree_clear_apply(XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (tree) {
+        xartree_free_impl(tree->root, false, apply, cl);
+        tree->root = NULL;
+        tree->size = 0;
+    }
+}
+
+void xartree_deep_clear(XARTree_PT tree) {
+    if (tree) {
+        xartree_free_impl(tree->root, true, NULL, NULL);
+        tree->root = NULL;
+        tree->size = 0;
+    }
+}
+
+void xartree_free(XARTree_PT *ptree) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xartree_clear(*ptree);
+    XMEM_FREE(*ptree);
+}
+
+void xartree_free_apply(XARTree_PT *ptree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xartree_clear_apply(*ptree, apply, cl);
+    XMEM_FREE(*ptree);
+}
+
+void xartree_deep_free(XARTree_PT *ptree) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xartree_deep_clear(*ptree);
+    XMEM_FREE(*ptree);
+}
+
+/* visit all leaves under node from min to max, return true if break_if and apply returns break_true */
+static
+bool xartree_map_impl(XARTree_Node_PT node, bool break_if, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl, int *count) {
+    if (!node) {
+        return false;
+    }
+
+    if (xartree_is_leaf(node)) {
+        XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+        bool ret = apply(leaf->key, &leaf->value, cl);
+        if (ret) {
+            ++*count;
+        }
+        return break_if && (ret == break_true);
+    }
+
+    for (int i = 0; i < xartree_child_end(node); ++i) {
+        if (xartree_map_impl(xartree_child(node, i), break_if, break_true, apply, cl, count)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int xartree_map(XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply) {
+        return 0;
+    }
+
+    {
+        int count = 0;
+        xartree_map_impl(tree->root, false, false, apply, cl, &count);
+        return count;
+    }
+}
+
+bool xartree_map_break_if_true(XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply) {
+        return false;
+    }
+
+    {
+        int count = 0;
+        return xartree_map_impl(tree->root, true, true, apply, cl, &count);
+    }
+}
+
+bool xartree_map_break_if_false(XARTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply) {
+        return false;
+    }
+
+    {
+        int count = 0;
+        return xartree_map_impl(tree->root, true, false, apply, cl, &count);
+    }
+}
+
+/* find the node whose keys all start with prefix, then visit them all */
+static
+bool xartree_prefix_map_impl(XARTree_PT tree, unsigned char *prefix, bool break_if, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl, int *count) {
+    int prefix_len = (int)strlen((char*)prefix);
+    int depth = 0;
+
+    XARTree_Node_PT node = tree->root;
+    while (node) {
+        if (xartree_is_leaf(node)) {
+            XARTree_Leaf_PT leaf = xartree_to_leaf(node);
+            if (strncmp((char*)leaf->key, (char*)prefix, prefix_len) == 0) {
+                return xartree_map_impl(node, break_if, break_true, apply, cl, count);
+            }
+            return false;
+        }
+
+        if (0 < node->prefix_len) {
+            int matched = xartree_prefix_mismatch(node, prefix, prefix_len, depth);
+            if (matched < node->prefix_len) {
+                /* prefix ends in the compressed path */
+                if (depth + matched == prefix_len) {
+                    return xartree_map_impl(node, break_if, break_true, apply, cl, count);
+                }
+                return false;
+            }
+            depth += node->prefix_len;
+        }
+
+        if (depth == prefix_len) {
+            return xartree_map_impl(node, break_if, break_true, apply, cl, count);
+        }
+
+        {
+            XARTree_Node_PT *slot = xartree_find_child(node, prefix[depth]);
+            node = slot ? *slot : NULL;
+            ++depth;
+        }
+    }
+
+    return false;
+}
+
+int xartree_prefix_map(XARTree_PT tree, void *prefix, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(prefix);
+    xassert(apply);
+
+    if (!tree || !prefix || !apply) {
+        return 0;
+    }
+
+    {
+        int count = 0;
+        xartree_prefix_map_impl(tree, (unsigned char*)prefix, false, false, apply, cl, &count);
+        return count;
+    }
+}
+
+bool xartree_prefix_map_break_if_true(XARTree_PT tree, void *prefix, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(prefix);
+    xassert(apply);
+
+    if (!tree || !prefix || !apply) {
+        return false;
+    }
+
+    {
+        int count = 0;
+        return xartree_prefix_map_impl(tree, (unsigned char*)prefix, true, true, apply, cl, &count);
+    }
+}
+
+bool xartree_swap(XARTree_PT tree1, XARTree_PT tree2) {
+    xassert(tree1);
+    xassert(tree2);
+
+    if (!tree1 || !tree2) {
+        return false;
+    }
+
+    {
+        XARTree_Node_PT root = tree1->root;
+        int size = tree1->size;
+
+        tree1->root = tree2->root;
+        tree1->size = tree2->size;
+
+        tree2->root = root;
+        tree2->size = size;
+    }
+
+    return true;
+}
+
+int xartree_size(XARTree_PT tree) {
+    return tree ? tree->size : 0;
+}
+
+bool xartree_is_empty(XARTree_PT tree) {
+    return tree ? (tree->size == 0) : true;
+}
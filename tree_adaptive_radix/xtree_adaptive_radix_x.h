@@ -0,0 +1,85 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XARTREEX_INCLUDED
+#define XARTREEX_INCLUDED
+
+#include "../include/xtree_adaptive_radix.h"
+
+/* Note :
+*    1. inner nodes grow and shrink among 4 kinds : node4, node16, node48 and node256 (how many children it can save).
+*    2. the common bytes of all keys under one node are saved in prefix (path compression), at most
+*       XARTREE_MAX_PREFIX_LEN bytes are saved, the left ones are read from the minimum leaf if needed.
+*    3. leaves are saved in the children pointers with the lowest bit set to 1.
+*/
+
+#define XARTREE_MAX_PREFIX_LEN  12
+
+#define XARTREE_NODE4           1
+#define XARTREE_NODE16          2
+#define XARTREE_NODE48          3
+#define XARTREE_NODE256         4
+
+typedef struct XARTree_Node     XARTree_Node_T;
+typedef struct XARTree_Node*    XARTree_Node_PT;
+
+typedef struct XARTree_Leaf*    XARTree_Leaf_PT;
+
+struct XARTree_Node {
+    unsigned char  type;                     /* XARTREE_NODE4 ... XARTREE_NODE256 */
+    short          count;                    /* children number */
+
+    int            prefix_len;               /* length of the compressed path */
+    unsigned char  prefix[XARTREE_MAX_PREFIX_LEN];
+};
+
+struct XARTree_Node4 {
+    XARTree_Node_T  node;
+
+    unsigned char   keys[4];                 /* sorted */
+    XARTree_Node_PT children[4];
+};
+
+struct XARTree_Node16 {
+    XARTree_Node_T  node;
+
+    unsigned char   keys[16];                /* sorted */
+    XARTree_Node_PT children[16];
+};
+
+struct XARTree_Node48 {
+    XARTree_Node_T  node;
+
+    unsigned char   index[256];              /* children[index[c] - 1] is the child of byte c, 0 : no child */
+    XARTree_Node_PT children[48];
+};
+
+struct XARTree_Node256 {
+    XARTree_Node_T  node;
+
+    XARTree_Node_PT children[256];
+};
+
+struct XARTree_Leaf {
+    void *key;
+    void *value;
+
+    int   key_len;                           /* strlen(key) + 1, '\0' is a part of the key */
+};
+
+struct XARTree {
+    XARTree_Node_PT root;                    /* a node or a leaf */
+
+    int size;                                /* key number */
+};
+
+#endif
@@ -326,9 +326,22 @@ bool xavltree_balance(XAVLTree_PT tree, XAVLTree_Node_PT node_N) {
     return true;
 }
 
+/* the node returned is zeroed */
 static
-XAVLTree_Node_PT xavltree_new_node(XAVLTree_Node_PT parent, void *key, void *value) {
-    XAVLTree_Node_PT node = XMEM_CALLOC(1, sizeof(*node));
+XAVLTree_Node_PT xavltree_alloc_node(XAVLTree_PT tree) {
+    if (!tree->slab) {
+        tree->slab = xslab_new_allocator((int)sizeof(struct XAVLTree_Node), tree->allocator);
+        if (!tree->slab) {
+            return NULL;
+        }
+    }
+
+    return (XAVLTree_Node_PT)xslab_alloc(tree->slab);
+}
+
+static
+XAVLTree_Node_PT xavltree_new_node(XAVLTree_PT tree, XAVLTree_Node_PT parent, void *key, void *value) {
+    XAVLTree_Node_PT node = xavltree_alloc_node(tree);
     if (!node) {
         return NULL;
     }
@@ -347,7 +360,7 @@ XAVLTree_Node_PT xavltree_new_node(XAVLTree_Node_PT parent, void *key, void *val
 }
 
 static
-void xavltree_free_node(XAVLTree_Node_PT node, void **old_key, void **old_value, bool deep) {
+void xavltree_free_node(XAVLTree_PT tree, XAVLTree_Node_PT node, void **old_key, void **old_value, bool deep) {
     if (deep) {
         XMEM_FREE(node->key);
         XMEM_FREE(node->value);
@@ -360,10 +373,14 @@ void xavltree_free_node(XAVLTree_Node_PT node, void **old_key, void **old_value,
             *old_value = node->value;
         }
     }
-    XMEM_FREE(node);
+    xslab_freep(tree->slab, (void**)&node);
 }
 
 XAVLTree_PT xavltree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    return xavltree_new_allocator(cmp, cl, NULL);
+}
+
+XAVLTree_PT xavltree_new_allocator(int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     xassert(cmp);
 
     if (!cmp) {
@@ -371,13 +388,14 @@ XAVLTree_PT xavltree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl)
     }
 
     {
-        XAVLTree_PT tree = XMEM_CALLOC(1, sizeof(*tree));
+        XAVLTree_PT tree = XMEM_ALLOC_BY(allocator, sizeof(*tree));
         if (!tree) {
             return NULL;
         }
 
         tree->cmp = cmp;
         tree->cl = cl;
+        tree->allocator = allocator;
         //tree->root = NULL;
 
         return tree;
@@ -395,7 +413,7 @@ bool xavltree_put_impl(XAVLTree_PT tree, void *key, void *value, bool unique, bo
 
     /* tree->root is NULL */
     if (!tree->root) {
-        tree->root = xavltree_new_node(NULL, key, value);
+        tree->root = xavltree_new_node(tree, NULL, key, value);
         return tree->root ? true : false;
     }
 
@@ -428,13 +446,13 @@ bool xavltree_put_impl(XAVLTree_PT tree, void *key, void *value, bool unique, bo
 
         /* reach the leaf node */
         if (ret < 0) {
-            parent->left = xavltree_new_node(parent, key, value);
+            parent->left = xavltree_new_node(tree, parent, key, value);
             if (!parent->left) {
                 return false;
             }
         }
         else {
-            parent->right = xavltree_new_node(parent, key, value);
+            parent->right = xavltree_new_node(tree, parent, key, value);
             if (!parent->right) {
                 return false;
             }
@@ -626,28 +644,37 @@ void xavltree_free_impl(XAVLTree_PT tree, XAVLTree_Node_PT node, bool deep, bool
     else if (apply) {
         apply(node->key, &node->value, cl);
     }
-    XMEM_FREE(node);
+    xslab_freep(tree->slab, (void**)&node);
 }
 
-void xavltree_clear(XAVLTree_PT tree) {
-    xavltree_free_impl(tree, (tree ? tree->root : NULL), false, NULL, NULL);
-    if (tree) {
-        tree->root = NULL;
+/* the nodes are walked only when their keys or values need to be handled, else they are all released at once with the slab */
+static
+void xavltree_clear_impl(XAVLTree_PT tree, bool deep, bool(*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!tree) {
+        return;
+    }
+
+    if (deep || apply) {
+        xavltree_free_impl(tree, tree->root, deep, apply, cl);
     }
+
+    if (tree->slab) {
+        xslab_clear(tree->slab);
+    }
+
+    tree->root = NULL;
+}
+
+void xavltree_clear(XAVLTree_PT tree) {
+    xavltree_clear_impl(tree, false, NULL, NULL);
 }
 
 void xavltree_clear_apply(XAVLTree_PT tree, bool(*apply)(void *key, void **value, void *cl), void *cl) {
-    xavltree_free_impl(tree, (tree ? tree->root : NULL), false, apply, cl);
-    if (tree) {
-        tree->root = NULL;
-    }
+    xavltree_clear_impl(tree, false, apply, cl);
 }
 
 void xavltree_deep_clear(XAVLTree_PT tree) {
-    xavltree_free_impl(tree, (tree ? tree->root : NULL), true, NULL, NULL);
-    if (tree) {
-        tree->root = NULL;
-    }
+    xavltree_clear_impl(tree, true, NULL, NULL);
 }
 
 void xavltree_free(XAVLTree_PT *ptree) {
@@ -655,8 +682,9 @@ void xavltree_free(XAVLTree_PT *ptree) {
         return;
     }
 
-    xavltree_free_impl(*ptree, (*ptree)->root, false, NULL, NULL);
-    XMEM_FREE(*ptree);
+    xavltree_clear_impl(*ptree, false, NULL, NULL);
+    xslab_free(&(*ptree)->slab);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
 }
 
 void xavltree_free_apply(XAVLTree_PT *ptree, bool(*apply)(void *key, void **value, void *cl), void *cl) {
@@ -664,8 +692,9 @@ void xavltree_free_apply(XAVLTree_PT *ptree, bool(*apply)(void *key, void **valu
         return;
     }
 
-    xavltree_free_impl(*ptree, (*ptree)->root, false, apply, cl);
-    XMEM_FREE(*ptree);
+    xavltree_clear_impl(*ptree, false, apply, cl);
+    xslab_free(&(*ptree)->slab);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
 }
 
 void xavltree_deep_free(XAVLTree_PT *ptree) {
@@ -673,8 +702,69 @@ void xavltree_deep_free(XAVLTree_PT *ptree) {
         return;
     }
 
-    xavltree_free_impl(*ptree, (*ptree)->root, true, NULL, NULL);
-    XMEM_FREE(*ptree);
+    xavltree_clear_impl(*ptree, true, NULL, NULL);
+    xslab_free(&(*ptree)->slab);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
+}
+
+/* build the balanced tree with keys[lo, hi] */
+static
+XAVLTree_Node_PT xavltree_build_sorted_impl(XAVLTree_PT tree, XAVLTree_Node_PT parent, void **keys, void **values, int lo, int hi, bool *false_found) {
+    if (hi < lo) {
+        return NULL;
+    }
+
+    {
+        int mid = lo + (hi - lo) / 2;
+
+        XAVLTree_Node_PT node = xavltree_alloc_node(tree);
+        if (!node) {
+            *false_found = true;
+            return NULL;
+        }
+
+        node->parent = parent;
+        node->key = keys[mid];
+        node->value = values ? values[mid] : NULL;
+        node->size = hi - lo + 1;
+
+        node->left = xavltree_build_sorted_impl(tree, node, keys, values, lo, mid - 1, false_found);
+        if (!*false_found) {
+            node->right = xavltree_build_sorted_impl(tree, node, keys, values, mid + 1, hi, false_found);
+        }
+
+        if (*false_found) {
+            xavltree_free_impl(tree, node, false, NULL, NULL);
+            return NULL;
+        }
+
+        node->height = 1 + xiarith_max(node->left ? node->left->height : 0, node->right ? node->right->height : 0);
+
+        return node;
+    }
+}
+
+bool xavltree_build_sorted(XAVLTree_PT tree, void **keys, void **values, int count) {
+    xassert(tree);
+    xassert(!tree->root);
+    xassert(keys || (count == 0));
+    xassert(0 <= count);
+
+    if (!tree || tree->root || (!keys && (0 < count)) || (count < 0)) {
+        return false;
+    }
+
+    for (int i = 1; i < count; ++i) {
+        if (0 < tree->cmp(keys[i - 1], keys[i], tree->cl)) {
+            return false;
+        }
+    }
+
+    {
+        bool false_found = false;
+        tree->root = xavltree_build_sorted_impl(tree, NULL, keys, values, 0, count - 1, &false_found);
+        return !false_found;
+    }
 }
 
 static
@@ -734,7 +824,7 @@ void xavltree_remove_min(XAVLTree_PT tree) {
 
     {
         XAVLTree_Node_PT min = xavltree_remove_min_impl(tree, tree->root);
-        xavltree_free_node(min, NULL, NULL, false);
+        xavltree_free_node(tree, min, NULL, NULL, false);
     }
 }
 
@@ -795,7 +885,7 @@ void xavltree_remove_max(XAVLTree_PT tree) {
 
     {
         XAVLTree_Node_PT max = xavltree_remove_max_impl(tree, tree->root);
-        xavltree_free_node(max, NULL, NULL, false);
+        xavltree_free_node(tree, max, NULL, NULL, false);
     }
 }
 
@@ -812,7 +902,7 @@ void xavltree_swap_node_key_value(XAVLTree_Node_PT node1, XAVLTree_Node_PT node2
 }
 
 static
-int xavltree_free_node_and_value(XAVLTree_Node_PT node, void **old_value, bool deep) {
+int xavltree_free_node_and_value(XAVLTree_PT tree, XAVLTree_Node_PT node, void **old_value, bool deep) {
     if (deep) {
         XMEM_FREE(node->value);
     }
@@ -821,7 +911,7 @@ int xavltree_free_node_and_value(XAVLTree_Node_PT node, void **old_value, bool d
             *old_value = node->value;
         }
     }
-    XMEM_FREE(node);
+    xslab_freep(tree->slab, (void**)&node);
 
     return 1;
 }
@@ -839,7 +929,7 @@ int xavltree_remove_impl(XAVLTree_PT tree, void *key, void **old_value, bool dee
         /* root */
         if (!node->parent) {
             tree->root = NULL;
-            return xavltree_free_node_and_value(node, old_value, deep);
+            return xavltree_free_node_and_value(tree, node, old_value, deep);
         }
 
         /* non-root */
@@ -851,13 +941,13 @@ int xavltree_remove_impl(XAVLTree_PT tree, void *key, void **old_value, bool dee
         }
         xavltree_balance(tree, node->parent);
 
-        return xavltree_free_node_and_value(node, old_value, deep);
+        return xavltree_free_node_and_value(tree, node, old_value, deep);
     }
 
     /* non-leaf node */
     XAVLTree_Node_PT swap = node->left ? xavltree_remove_max_impl(tree, node->left) : xavltree_remove_min_impl(tree, node->right);
     xavltree_swap_node_key_value(node, swap);
-    return xavltree_free_node_and_value(swap, old_value, deep);
+    return xavltree_free_node_and_value(tree, swap, old_value, deep);
 }
 
 int xavltree_remove(XAVLTree_PT tree, void *key) {
@@ -1067,11 +1157,110 @@ bool xavltree_map_min_to_max_break_if_false(XAVLTree_PT tree, bool(*apply)(void
     return xavltree_map_min_to_max_break_if_impl(tree, false, apply, cl);
 }
 
+void xavltree_cursor_init(XAVLTree_Cursor_PT cursor, XAVLTree_PT tree) {
+    xassert(cursor);
+    xassert(tree);
+
+    if (!cursor) {
+        return;
+    }
+
+    cursor->tree = tree;
+    cursor->node = NULL;
+}
+
+bool xavltree_cursor_first(XAVLTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->node = xavltree_min_impl(cursor->tree, cursor->tree->root);
+    return cursor->node != NULL;
+}
+
+bool xavltree_cursor_last(XAVLTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->node = xavltree_max_impl(cursor->tree, cursor->tree->root);
+    return cursor->node != NULL;
+}
+
+bool xavltree_cursor_seek(XAVLTree_Cursor_PT cursor, void *key) {
+    xassert(cursor);
+    xassert(key);
+
+    if (!cursor || !cursor->tree || !key) {
+        return false;
+    }
+
+    {
+        XAVLTree_PT tree = cursor->tree;
+        XAVLTree_Node_PT node = tree->root;
+        XAVLTree_Node_PT result = NULL;
+
+        /* not xavltree_ceiling_impl : the first one of the "repeat" keys is needed */
+        while (node) {
+            if (tree->cmp(node->key, key, tree->cl) < 0) {
+                node = node->right;
+            }
+            else {
+                result = node;
+                node = node->left;
+            }
+        }
+
+        cursor->node = result;
+        return result != NULL;
+    }
+}
+
+bool xavltree_cursor_next(XAVLTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    cursor->node = xavltree_next_node(cursor->tree, (XAVLTree_Node_PT)cursor->node);
+    return cursor->node != NULL;
+}
+
+bool xavltree_cursor_prev(XAVLTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    cursor->node = xavltree_prev_node(cursor->tree, (XAVLTree_Node_PT)cursor->node);
+    return cursor->node != NULL;
+}
+
+bool xavltree_cursor_valid(XAVLTree_Cursor_PT cursor) {
+    return cursor ? (cursor->node != NULL) : false;
+}
+
+void* xavltree_cursor_key(XAVLTree_Cursor_PT cursor) {
+    return (cursor && cursor->node) ? ((XAVLTree_Node_PT)cursor->node)->key : NULL;
+}
+
+void* xavltree_cursor_value(XAVLTree_Cursor_PT cursor) {
+    return (cursor && cursor->node) ? ((XAVLTree_Node_PT)cursor->node)->value : NULL;
+}
+
 bool xavltree_swap(XAVLTree_PT tree1, XAVLTree_PT tree2) {
     xassert(tree1);
     xassert(tree2);
+    /* nodes and slab can't move to a tree which allocates from another allocator */
+    xassert(tree1->allocator == tree2->allocator);
 
-    if (!tree1 || !tree2) {
+    if (!tree1 || !tree2 || (tree1->allocator != tree2->allocator)) {
         return false;
     }
 
@@ -1093,6 +1282,12 @@ bool xavltree_swap(XAVLTree_PT tree1, XAVLTree_PT tree2) {
             tree1->cl = tree2->cl;
             tree2->cl = cl;
         }
+
+        {
+            XSlab_PT slab = tree1->slab;
+            tree1->slab = tree2->slab;
+            tree2->slab = slab;
+        }
     }
 
     return true;
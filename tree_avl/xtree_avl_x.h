@@ -14,6 +14,7 @@
 #define XAVLTREEX_INCLUDED
 
 #include "../include/xtree_avl.h"
+#include "../include/xmem_slab.h"
 
 typedef struct XAVLTree_Node* XAVLTree_Node_PT;
 
@@ -34,6 +35,10 @@ struct XAVLTree {
 
     int (*cmp)(void *key1, void *key2, void *cl);
     void *cl;
+
+    XSlab_PT slab;    /* all the nodes come from it, created with the first node */
+
+    XMem_Allocator_PT allocator;  /* the tree and its slab come from it, NULL : XMEM */
 };
 
 #endif
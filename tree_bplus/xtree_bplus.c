@@ -0,0 +1,1915 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#include <string.h>
+
+#include "../include/xassert.h"
+#include "../include/xmem.h"
+#include "../utils/xutils.h"
+#include "../array_pointer/xarray_pointer_x.h"
+#include "xtree_bplus_x.h"
+
+#define XBPTREE_PUT_REPEAT          0
+#define XBPTREE_PUT_UNIQUE          1
+#define XBPTREE_PUT_REPLACE         2
+#define XBPTREE_PUT_DEEP_REPLACE    3
+
+XBPTree_PT xbptree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    return xbptree_new_allocator(cmp, cl, NULL);
+}
+
+XBPTree_PT xbptree_new_allocator(int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    xassert(cmp);
+
+    if (!cmp) {
+        return NULL;
+    }
+
+    {
+        XBPTree_PT tree = XMEM_ALLOC_BY(allocator, sizeof(*tree));
+        if (!tree) {
+            return NULL;
+        }
+
+        tree->cmp = cmp;
+        tree->cl = cl;
+        tree->allocator = allocator;
+
+        return tree;
+    }
+}
+
+static
+XBPTree_Leaf_PT xbptree_new_leaf(XBPTree_PT tree) {
+    XBPTree_Leaf_PT leaf = XMEM_ALLOC_BY(tree->allocator, sizeof(*leaf));
+    if (!leaf) {
+        return NULL;
+    }
+
+    leaf->node.leaf = true;
+
+    return leaf;
+}
+
+static
+XBPTree_Inner_PT xbptree_new_inner(XBPTree_PT tree) {
+    XBPTree_Inner_PT inner = XMEM_ALLOC_BY(tree->allocator, sizeof(*inner));
+    if (!inner) {
+        return NULL;
+    }
+
+    //inner->node.leaf = false;
+
+    return inner;
+}
+
+/* leaves and inner nodes have different sizes, node can be NULL */
+static
+void xbptree_free_node(XBPTree_PT tree, XBPTree_Node_PT node) {
+    if (node) {
+        XMEM_FREE_BY(tree->allocator, node, (node->leaf ? sizeof(XBPTree_Leaf_T) : sizeof(XBPTree_Inner_T)));
+    }
+}
+
+/* key number of the sub tree */
+static
+int xbptree_node_size(XBPTree_Node_PT node) {
+    if (node->leaf) {
+        return node->count;
+    }
+
+    {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        int size = 0;
+        for (int i = 0; i <= node->count; ++i) {
+            size += inner->counts[i];
+        }
+        return size;
+    }
+}
+
+/* first position in [0, count] whose key is greater than key (upper) or not less than key (!upper) */
+static
+int xbptree_node_bound(XBPTree_PT tree, XBPTree_Node_PT node, void *key, bool upper) {
+    int low = 0;
+    int high = node->count;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        int ret = tree->cmp(key, node->keys[mid], tree->cl);
+        if ((ret < 0) || (!upper && (ret == 0))) {
+            high = mid;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
+/* find the leaf and the bound position in it (pos may be leaf->count), *rank saves the key number before the position */
+static
+XBPTree_Leaf_PT xbptree_bound_impl(XBPTree_PT tree, void *key, bool upper, int *pos, int *rank) {
+    XBPTree_Node_PT node = tree->root;
+    int k = 0;
+
+    if (!node) {
+        return NULL;
+    }
+
+    while (!node->leaf) {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        int i = xbptree_node_bound(tree, node, key, upper);
+        for (int j = 0; j < i; ++j) {
+            k += inner->counts[j];
+        }
+
+        node = inner->children[i];
+    }
+
+    *pos = xbptree_node_bound(tree, node, key, upper);
+    if (rank) {
+        *rank = k + *pos;
+    }
+
+    return (XBPTree_Leaf_PT)node;
+}
+
+/* move to the next position if pos is out of the leaf */
+static
+XBPTree_Leaf_PT xbptree_normalize_pos(XBPTree_Leaf_PT leaf, int *pos) {
+    if (leaf && (leaf->node.count <= *pos)) {
+        leaf = leaf->next;
+        *pos = 0;
+    }
+
+    return leaf;
+}
+
+/* the first key which is not less than key */
+static
+XBPTree_Leaf_PT xbptree_lower_bound(XBPTree_PT tree, void *key, int *pos, int *rank) {
+    XBPTree_Leaf_PT leaf = xbptree_bound_impl(tree, key, false, pos, rank);
+    return xbptree_normalize_pos(leaf, pos);
+}
+
+/* the last key which is not greater than key */
+static
+XBPTree_Leaf_PT xbptree_floor_impl(XBPTree_PT tree, void *key, int *pos) {
+    XBPTree_Leaf_PT leaf = xbptree_bound_impl(tree, key, true, pos, NULL);
+    if (!leaf) {
+        return NULL;
+    }
+
+    if (0 < *pos) {
+        --*pos;
+        return leaf;
+    }
+
+    leaf = leaf->prev;
+    if (leaf) {
+        *pos = leaf->node.count - 1;
+    }
+    return leaf;
+}
+
+static
+XBPTree_Leaf_PT xbptree_get_impl(XBPTree_PT tree, void *key, int *pos, int *rank) {
+    XBPTree_Leaf_PT leaf = xbptree_lower_bound(tree, key, pos, rank);
+    if (leaf && (tree->cmp(key, leaf->node.keys[*pos], tree->cl) == 0)) {
+        return leaf;
+    }
+
+    return NULL;
+}
+
+/* the leaf saving the kth key */
+static
+XBPTree_Leaf_PT xbptree_select_impl(XBPTree_PT tree, int k, int *pos) {
+    XBPTree_Node_PT node = tree->root;
+
+    while (!node->leaf) {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        int i = 0;
+        while (inner->counts[i] <= k) {
+            k -= inner->counts[i];
+            ++i;
+        }
+
+        node = inner->children[i];
+    }
+
+    *pos = k;
+    return (XBPTree_Leaf_PT)node;
+}
+
+static
+void xbptree_free_impl(XBPTree_PT tree, XBPTree_Node_PT node, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!node) {
+        return;
+    }
+
+    if (node->leaf) {
+        XBPTree_Leaf_PT leaf = (XBPTree_Leaf_PT)node;
+        for (int i = 0; i < node->count; ++i) {
+            if (deep) {
+                XMEM_FREE(node->keys[i]);
+                XMEM_FREE(leaf->values[i]);
+            }
+            else if (apply) {
+                apply(node->keys[i], &leaf->values[i], cl);
+            }
+        }
+    }
+    else {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        for (int i = 0; i <= node->count; ++i) {
+            xbptree_free_impl(tree, inner->children[i], deep, apply, cl);
+        }
+    }
+
+    xbptree_free_node(tree, node);
+}
+
+/* copy the sub tree, *last is the last copied leaf to link with */
+static
+XBPTree_Node_PT xbptree_copy_impl(XBPTree_PT tree, XBPTree_Node_PT node, int key_size, int value_size, bool deep, XBPTree_Leaf_PT *last) {
+    if (node->leaf) {
+        XBPTree_Leaf_PT leaf = (XBPTree_Leaf_PT)node;
+        XBPTree_Leaf_PT nleaf = xbptree_new_leaf(tree);
+        if (!nleaf) {
+            return NULL;
+        }
+
+        if (!deep) {
+            memcpy(nleaf, leaf, sizeof(*leaf));
+        }
+        else {
+            for (int i = 0; i < node->count; ++i) {
+                nleaf->node.keys[i] = xutils_deep_copy(node->keys[i], key_size);
+                nleaf->values[i] = (0 < value_size) ? xutils_deep_copy(leaf->values[i], value_size) : NULL;
+
+                if (!nleaf->node.keys[i] || ((0 < value_size) && leaf->values[i] && !nleaf->values[i])) {
+                    nleaf->node.count = i + 1;
+                    xbptree_free_impl(tree, (XBPTree_Node_PT)nleaf, true, NULL, NULL);
+                    return NULL;
+                }
+            }
+            nleaf->node.count = node->count;
+        }
+
+        nleaf->prev = *last;
+        nleaf->next = NULL;
+        if (*last) {
+            (*last)->next = nleaf;
+        }
+        *last = nleaf;
+
+        return (XBPTree_Node_PT)nleaf;
+    }
+
+    {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        XBPTree_Inner_PT ninner = xbptree_new_inner(tree);
+        if (!ninner) {
+            return NULL;
+        }
+
+        memcpy(ninner, inner, sizeof(*inner));
+
+        for (int i = 0; i <= node->count; ++i) {
+            ninner->children[i] = xbptree_copy_impl(tree, inner->children[i], key_size, value_size, deep, last);
+            if (!ninner->children[i]) {
+                for (int j = 0; j < i; ++j) {
+                    xbptree_free_impl(tree, ninner->children[j], deep, NULL, NULL);
+                }
+                xbptree_free_node(tree, (XBPTree_Node_PT)ninner);
+                return NULL;
+            }
+        }
+
+        return (XBPTree_Node_PT)ninner;
+    }
+}
+
+static
+XBPTree_PT xbptree_copy_tree_impl(XBPTree_PT tree, int key_size, int value_size, bool deep) {
+    XBPTree_PT ntree = xbptree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+    if (!ntree) {
+        return NULL;
+    }
+
+    if (tree->root) {
+        XBPTree_Leaf_PT last = NULL;
+
+        ntree->root = xbptree_copy_impl(ntree, tree->root, key_size, value_size, deep, &last);
+        if (!ntree->root) {
+            XMEM_FREE_BY(ntree->allocator, ntree, sizeof(*ntree));
+            return NULL;
+        }
+
+        {
+            XBPTree_Node_PT node = ntree->root;
+            while (!node->leaf) {
+                node = ((XBPTree_Inner_PT)node)->children[0];
+            }
+            ntree->head = (XBPTree_Leaf_PT)node;
+            ntree->tail = last;
+        }
+    }
+
+    ntree->size = tree->size;
+    ntree->height = tree->height;
+
+    return ntree;
+}
+
+XBPTree_PT xbptree_copy(XBPTree_PT tree) {
+    xassert(tree);
+
+    if (!tree) {
+        return NULL;
+    }
+
+    return xbptree_copy_tree_impl(tree, 0, 0, false);
+}
+
+XBPTree_PT xbptree_deep_copy(XBPTree_PT tree, int key_size, int value_size) {
+    xassert(tree);
+    xassert(0 < key_size);
+    xassert(0 <= value_size);
+
+    if (!tree || (key_size <= 0) || (value_size < 0)) {
+        return NULL;
+    }
+
+    return xbptree_copy_tree_impl(tree, key_size, value_size, true);
+}
+
+/* the last key which is not greater than key is checked before inserting (except for "repeat"),
+ * return -1 : failed, 0 : key found (not inserted), 1 : inserted (*split is set if node is split into two)
+ */
+static
+int xbptree_put_leaf(XBPTree_PT tree, XBPTree_Leaf_PT leaf, void *key, void *value, int mode, void **old_value, void **split_key, XBPTree_Node_PT *split) {
+    int pos = xbptree_node_bound(tree, (XBPTree_Node_PT)leaf, key, true);
+
+    if (mode != XBPTREE_PUT_REPEAT) {
+        XBPTree_Leaf_PT prev = leaf;
+        int ppos = pos - 1;
+        if (ppos < 0) {
+            prev = leaf->prev;
+            ppos = prev ? prev->node.count - 1 : -1;
+        }
+
+        if (prev && (tree->cmp(key, prev->node.keys[ppos], tree->cl) == 0)) {
+            if (mode == XBPTREE_PUT_REPLACE) {
+                if (old_value) {
+                    *old_value = prev->values[ppos];
+                }
+                prev->values[ppos] = value;
+            }
+            else if (mode == XBPTREE_PUT_DEEP_REPLACE) {
+                XMEM_FREE(prev->values[ppos]);
+                prev->values[ppos] = value;
+            }
+            return 0;
+        }
+    }
+
+    if (leaf->node.count < XBPTREE_MAX_KEYS) {
+        int count = leaf->node.count;
+        memmove(leaf->node.keys + pos + 1, leaf->node.keys + pos, (count - pos) * sizeof(void*));
+        memmove(leaf->values + pos + 1, leaf->values + pos, (count - pos) * sizeof(void*));
+
+        leaf->node.keys[pos] = key;
+        leaf->values[pos] = value;
+        ++leaf->node.count;
+
+        return 1;
+    }
+
+    /* full : split into two leaves */
+    {
+        void *keys[XBPTREE_MAX_KEYS + 1];
+        void *values[XBPTREE_MAX_KEYS + 1];
+        int left = (XBPTREE_MAX_KEYS + 1) / 2;
+
+        XBPTree_Leaf_PT nleaf = xbptree_new_leaf(tree);
+        if (!nleaf) {
+            return -1;
+        }
+
+        memcpy(keys, leaf->node.keys, pos * sizeof(void*));
+        memcpy(values, leaf->values, pos * sizeof(void*));
+        keys[pos] = key;
+        values[pos] = value;
+        memcpy(keys + pos + 1, leaf->node.keys + pos, (XBPTREE_MAX_KEYS - pos) * sizeof(void*));
+        memcpy(values + pos + 1, leaf->values + pos, (XBPTREE_MAX_KEYS - pos) * sizeof(void*));
+
+        memcpy(leaf->node.keys, keys, left * sizeof(void*));
+        memcpy(leaf->values, values, left * sizeof(void*));
+        leaf->node.count = left;
+
+        memcpy(nleaf->node.keys, keys + left, (XBPTREE_MAX_KEYS + 1 - left) * sizeof(void*));
+        memcpy(nleaf->values, values + left, (XBPTREE_MAX_KEYS + 1 - left) * sizeof(void*));
+        nleaf->node.count = XBPTREE_MAX_KEYS + 1 - left;
+
+        nleaf->prev = leaf;
+        nleaf->next = leaf->next;
+        if (leaf->next) {
+            leaf->next->prev = nleaf;
+        }
+        else {
+            tree->tail = nleaf;
+        }
+        leaf->next = nleaf;
+
+        *split_key = nleaf->node.keys[0];
+        *split = (XBPTree_Node_PT)nleaf;
+
+        return 1;
+    }
+}
+
+static
+int xbptree_put_impl(XBPTree_PT tree, XBPTree_Node_PT node, void *key, void *value, int mode, void **old_value, void **split_key, XBPTree_Node_PT *split) {
+    if (node->leaf) {
+        return xbptree_put_leaf(tree, (XBPTree_Leaf_PT)node, key, value, mode, old_value, split_key, split);
+    }
+
+    {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        int i = xbptree_node_bound(tree, node, key, true);
+
+        void *child_key = NULL;
+        XBPTree_Node_PT child_split = NULL;
+
+        /* a full node must be split if its child is split, alloc the new one first to keep the tree unchanged on failure */
+        XBPTree_Inner_PT ninner = NULL;
+        if (node->count == XBPTREE_MAX_KEYS) {
+            ninner = xbptree_new_inner(tree);
+            if (!ninner) {
+                return -1;
+            }
+        }
+
+        {
+            int ret = xbptree_put_impl(tree, inner->children[i], key, value, mode, old_value, &child_key, &child_split);
+            if ((ret <= 0) || !child_split) {
+                if (ret == 1) {
+                    ++inner->counts[i];
+                }
+                xbptree_free_node(tree, (XBPTree_Node_PT)ninner);
+                return ret;
+            }
+        }
+
+        if (node->count < XBPTREE_MAX_KEYS) {
+            int count = node->count;
+            memmove(node->keys + i + 1, node->keys + i, (count - i) * sizeof(void*));
+            memmove(inner->children + i + 2, inner->children + i + 1, (count - i) * sizeof(XBPTree_Node_PT));
+            memmove(inner->counts + i + 2, inner->counts + i + 1, (count - i) * sizeof(int));
+
+            node->keys[i] = child_key;
+            inner->children[i + 1] = child_split;
+            inner->counts[i] = xbptree_node_size(inner->children[i]);
+            inner->counts[i + 1] = xbptree_node_size(child_split);
+            ++node->count;
+
+            return 1;
+        }
+
+        /* full : split into two nodes, the middle key goes up */
+        {
+            void *keys[XBPTREE_MAX_KEYS + 1];
+            XBPTree_Node_PT children[XBPTREE_MAX_KEYS + 2];
+            int counts[XBPTREE_MAX_KEYS + 2];
+            int mid = XBPTREE_MAX_KEYS / 2;
+            int right = XBPTREE_MAX_KEYS - mid;
+
+            memcpy(keys, node->keys, i * sizeof(void*));
+            keys[i] = child_key;
+            memcpy(keys + i + 1, node->keys + i, (XBPTREE_MAX_KEYS - i) * sizeof(void*));
+
+            memcpy(children, inner->children, (i + 1) * sizeof(XBPTree_Node_PT));
+            memcpy(counts, inner->counts, (i + 1) * sizeof(int));
+            children[i + 1] = child_split;
+            counts[i] = xbptree_node_size(children[i]);
+            counts[i + 1] = xbptree_node_size(child_split);
+            memcpy(children + i + 2, inner->children + i + 1, (XBPTREE_MAX_KEYS - i) * sizeof(XBPTree_Node_PT));
+            memcpy(counts + i + 2, inner->counts + i + 1, (XBPTREE_MAX_KEYS - i) * sizeof(int));
+
+            memcpy(node->keys, keys, mid * sizeof(void*));
+            memcpy(inner->children, children, (mid + 1) * sizeof(XBPTree_Node_PT));
+            memcpy(inner->counts, counts, (mid + 1) * sizeof(int));
+            node->count = mid;
+
+            memcpy(ninner->node.keys, keys + mid + 1, right * sizeof(void*));
+            memcpy(ninner->children, children + mid + 1, (right + 1) * sizeof(XBPTree_Node_PT));
+            memcpy(ninner->counts, counts + mid + 1, (right + 1) * sizeof(int));
+            ninner->node.count = right;
+
+            *split_key = keys[mid];
+            *split = (XBPTree_Node_PT)ninner;
+
+            return 1;
+        }
+    }
+}
+
+static
+bool xbptree_put_root(XBPTree_PT tree, void *key, void *value, int mode, void **old_value) {
+    if (!tree->root) {
+        XBPTree_Leaf_PT leaf = xbptree_new_leaf(tree);
+        if (!leaf) {
+            return false;
+        }
+
+        leaf->node.keys[0] = key;
+        leaf->values[0] = value;
+        leaf->node.count = 1;
+
+        tree->root = (XBPTree_Node_PT)leaf;
+        tree->head = leaf;
+        tree->tail = leaf;
+        tree->size = 1;
+        tree->height = 1;
+
+        return true;
+    }
+
+    {
+        void *split_key = NULL;
+        XBPTree_Node_PT split = NULL;
+
+        /* the root may be split, alloc the new root first */
+        XBPTree_Inner_PT nroot = NULL;
+        if (tree->root->count == XBPTREE_MAX_KEYS) {
+            nroot = xbptree_new_inner(tree);
+            if (!nroot) {
+                return false;
+            }
+        }
+
+        {
+            int ret = xbptree_put_impl(tree, tree->root, key, value, mode, old_value, &split_key, &split);
+            if (ret < 0) {
+                xbptree_free_node(tree, (XBPTree_Node_PT)nroot);
+                return false;
+            }
+            if (ret == 1) {
+                ++tree->size;
+            }
+        }
+
+        if (!split) {
+            xbptree_free_node(tree, (XBPTree_Node_PT)nroot);
+            return true;
+        }
+
+        nroot->node.keys[0] = split_key;
+        nroot->node.count = 1;
+        nroot->children[0] = tree->root;
+        nroot->children[1] = split;
+        nroot->counts[0] = xbptree_node_size(tree->root);
+        nroot->counts[1] = xbptree_node_size(split);
+
+        tree->root = (XBPTree_Node_PT)nroot;
+        ++tree->height;
+
+        return true;
+    }
+}
+
+/* bulk load : fill the leaves from left to right, then build the inner nodes level by level,
+ * the nodes of one level share the keys (or children) evenly to keep at least XBPTREE_MIN_KEYS keys
+ */
+bool xbptree_build_sorted(XBPTree_PT tree, void **keys, void **values, int count) {
+    xassert(tree);
+    xassert(!tree->root);
+    xassert(keys || (count == 0));
+    xassert(0 <= count);
+
+    if (!tree || tree->root || (!keys && (0 < count)) || (count < 0)) {
+        return false;
+    }
+
+    for (int i = 1; i < count; ++i) {
+        if (0 < tree->cmp(keys[i - 1], keys[i], tree->cl)) {
+            return false;
+        }
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    {
+        int num = (count + XBPTREE_MAX_KEYS - 1) / XBPTREE_MAX_KEYS;
+
+        XBPTree_Node_PT *nodes = XMEM_CALLOC(num, sizeof(XBPTree_Node_PT));
+        void **mins = XMEM_CALLOC(num, sizeof(void*));
+        int *sizes = XMEM_CALLOC(num, sizeof(int));
+        int height = 1;
+
+        if (!nodes || !mins || !sizes) {
+            XMEM_FREE(nodes);
+            XMEM_FREE(mins);
+            XMEM_FREE(sizes);
+            return false;
+        }
+
+        /* leaves */
+        {
+            XBPTree_Leaf_PT last = NULL;
+
+            for (int i = 0, start = 0; i < num; ++i) {
+                int n = count / num + ((i < count % num) ? 1 : 0);
+
+                XBPTree_Leaf_PT leaf = xbptree_new_leaf(tree);
+                if (!leaf) {
+                    for (int j = 0; j < i; ++j) {
+                        xbptree_free_node(tree, nodes[j]);
+                    }
+                    XMEM_FREE(nodes);
+                    XMEM_FREE(mins);
+                    XMEM_FREE(sizes);
+                    return false;
+                }
+
+                memcpy(leaf->node.keys, keys + start, n * sizeof(void*));
+                if (values) {
+                    memcpy(leaf->values, values + start, n * sizeof(void*));
+                }
+                leaf->node.count = n;
+
+                leaf->prev = last;
+                if (last) {
+                    last->next = leaf;
+                }
+                last = leaf;
+
+                nodes[i] = (XBPTree_Node_PT)leaf;
+                mins[i] = keys[start];
+                sizes[i] = n;
+                start += n;
+            }
+
+            tree->head = (XBPTree_Leaf_PT)nodes[0];
+            tree->tail = last;
+        }
+
+        /* inner levels, the parents are saved in the front of the same arrays */
+        while (1 < num) {
+            int pnum = (num + XBPTREE_MAX_KEYS) / (XBPTREE_MAX_KEYS + 1);
+
+            for (int p = 0, start = 0; p < pnum; ++p) {
+                int n = num / pnum + ((p < num % pnum) ? 1 : 0);
+
+                XBPTree_Inner_PT inner = xbptree_new_inner(tree);
+                if (!inner) {
+                    for (int j = 0; j < p; ++j) {
+                        xbptree_free_impl(tree, nodes[j], false, NULL, NULL);
+                    }
+                    for (int j = start; j < num; ++j) {
+                        xbptree_free_impl(tree, nodes[j], false, NULL, NULL);
+                    }
+                    tree->head = NULL;
+                    tree->tail = NULL;
+                    XMEM_FREE(nodes);
+                    XMEM_FREE(mins);
+                    XMEM_FREE(sizes);
+                    return false;
+                }
+
+                {
+                    void *min = mins[start];
+                    int size = 0;
+
+                    for (int i = 0; i < n; ++i) {
+                        inner->children[i] = nodes[start + i];
+                        inner->counts[i] = sizes[start + i];
+                        if (0 < i) {
+                            inner->node.keys[i - 1] = mins[start + i];
+                        }
+                        size += sizes[start + i];
+                    }
+                    inner->node.count = n - 1;
+
+                    nodes[p] = (XBPTree_Node_PT)inner;
+                    mins[p] = min;
+                    sizes[p] = size;
+                }
+
+                start += n;
+            }
+
+            num = pnum;
+            ++height;
+        }
+
+        tree->root = nodes[0];
+        tree->size = count;
+        tree->height = height;
+
+        XMEM_FREE(nodes);
+        XMEM_FREE(mins);
+        XMEM_FREE(sizes);
+
+        return true;
+    }
+}
+
+bool xbptree_build_sorted_parray(XBPTree_PT tree, XPArray_PT keys, XPArray_PT values) {
+    xassert(keys);
+    xassert(!values || (xparray_size(keys) <= xparray_size(values)));
+
+    if (!keys || (values && (xparray_size(values) < xparray_size(keys)))) {
+        return false;
+    }
+
+    return xbptree_build_sorted(tree, keys->datas, (values ? values->datas : NULL), keys->size);
+}
+
+bool xbptree_put_repeat(XBPTree_PT tree, void *key, void *value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xbptree_put_root(tree, key, value, XBPTREE_PUT_REPEAT, NULL);
+}
+
+bool xbptree_put_unique(XBPTree_PT tree, void *key, void *value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xbptree_put_root(tree, key, value, XBPTREE_PUT_UNIQUE, NULL);
+}
+
+bool xbptree_put_replace(XBPTree_PT tree, void *key, void *value, void **old_value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xbptree_put_root(tree, key, value, XBPTREE_PUT_REPLACE, old_value);
+}
+
+bool xbptree_put_deep_replace(XBPTree_PT tree, void *key, void *value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xbptree_put_root(tree, key, value, XBPTREE_PUT_DEEP_REPLACE, NULL);
+}
+
+void* xbptree_min(XBPTree_PT tree) {
+    return (tree && tree->head) ? tree->head->node.keys[0] : NULL;
+}
+
+void* xbptree_max(XBPTree_PT tree) {
+    return (tree && tree->tail) ? tree->tail->node.keys[tree->tail->node.count - 1] : NULL;
+}
+
+void* xbptree_floor(XBPTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        int pos = 0;
+        XBPTree_Leaf_PT leaf = xbptree_floor_impl(tree, key, &pos);
+        return leaf ? leaf->node.keys[pos] : NULL;
+    }
+}
+
+void* xbptree_ceiling(XBPTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        int pos = 0;
+        XBPTree_Leaf_PT leaf = xbptree_lower_bound(tree, key, &pos, NULL);
+        return leaf ? leaf->node.keys[pos] : NULL;
+    }
+}
+
+void* xbptree_select(XBPTree_PT tree, int k) {
+    xassert(tree);
+    xassert(0 <= k);
+    xassert(k < xbptree_size(tree));
+
+    if (!tree || (k < 0) || (xbptree_size(tree) <= k)) {
+        return NULL;
+    }
+
+    {
+        int pos = 0;
+        XBPTree_Leaf_PT leaf = xbptree_select_impl(tree, k, &pos);
+        return leaf->node.keys[pos];
+    }
+}
+
+/* element number of the key : 0, 1, 2, ... */
+int xbptree_rank(XBPTree_PT tree, void *key) {
+    if (!tree || !key) {
+        return -1;
+    }
+
+    {
+        int pos = 0;
+        int rank = -1;
+        return xbptree_get_impl(tree, key, &pos, &rank) ? rank : -1;
+    }
+}
+
+void* xbptree_get(XBPTree_PT tree, void *key) {
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        int pos = 0;
+        XBPTree_Leaf_PT leaf = xbptree_get_impl(tree, key, &pos, NULL);
+        return leaf ? leaf->values[pos] : NULL;
+    }
+}
+
+bool xbptree_find(XBPTree_PT tree, void *key) {
+    if (!tree || !key) {
+        return false;
+    }
+
+    {
+        int pos = 0;
+        return xbptree_get_impl(tree, key, &pos, NULL) ? true : false;
+    }
+}
+
+static
+bool xbptree_find_replace_impl(XBPTree_PT tree, void *key, void *value, void **old_value, bool deep) {
+    int pos = 0;
+    XBPTree_Leaf_PT leaf = xbptree_get_impl(tree, key, &pos, NULL);
+    if (!leaf) {
+        return false;
+    }
+
+    if (deep) {
+        XMEM_FREE(leaf->values[pos]);
+    }
+    else if (old_value) {
+        *old_value = leaf->values[pos];
+    }
+    leaf->values[pos] = value;
+
+    return true;
+}
+
+bool xbptree_find_replace(XBPTree_PT tree, void *key, void *value, void **old_value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xbptree_find_replace_impl(tree, key, value, old_value, false);
+}
+
+bool xbptree_find_deep_replace(XBPTree_PT tree, void *key, void *value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    return xbptree_find_replace_impl(tree, key, value, NULL, true);
+}
+
+static
+bool xbptree_index_replace_impl(XBPTree_PT tree, int k, void *value, void **old_value, bool deep) {
+    int pos = 0;
+    XBPTree_Leaf_PT leaf = xbptree_select_impl(tree, k, &pos);
+
+    if (deep) {
+        XMEM_FREE(leaf->values[pos]);
+    }
+    else if (old_value) {
+        *old_value = leaf->values[pos];
+    }
+    leaf->values[pos] = value;
+
+    return true;
+}
+
+bool xbptree_index_replace(XBPTree_PT tree, int k, void *value, void **old_value) {
+    xassert(tree);
+    xassert(0 <= k);
+    xassert(k < xbptree_size(tree));
+
+    if (!tree || (k < 0) || (xbptree_size(tree) <= k)) {
+        return false;
+    }
+
+    return xbptree_index_replace_impl(tree, k, value, old_value, false);
+}
+
+bool xbptree_index_deep_replace(XBPTree_PT tree, int k, void *value) {
+    xassert(tree);
+    xassert(0 <= k);
+    xassert(k < xbptree_size(tree));
+
+    if (!tree || (k < 0) || (xbptree_size(tree) <= k)) {
+        return false;
+    }
+
+    return xbptree_index_replace_impl(tree, k, value, NULL, true);
+}
+
+XSList_PT xbptree_keys(XBPTree_PT tree, void *low, void *high) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+
+    if (!tree || !low || !high) {
+        return NULL;
+    }
+
+    {
+        XSList_PT list = xslist_new();
+        if (!list) {
+            return NULL;
+        }
+
+        if (0 < tree->cmp(low, high, tree->cl)) {
+            void *tmp = low;
+            low = high;
+            high = tmp;
+        }
+
+        {
+            int pos = 0;
+            XBPTree_Leaf_PT leaf = xbptree_lower_bound(tree, low, &pos, NULL);
+
+            for (; leaf; leaf = leaf->next, pos = 0) {
+                for (; pos < leaf->node.count; ++pos) {
+                    if (0 < tree->cmp(leaf->node.keys[pos], high, tree->cl)) {
+                        return list;
+                    }
+
+                    if (!xslist_push_back_repeat(list, leaf->node.keys[pos])) {
+                        xslist_free(&list);
+                        return NULL;
+                    }
+                }
+            }
+        }
+
+        return list;
+    }
+}
+
+void xbptree_clear(XBPTree_PT tree) {
+    if (tree) {
+        xbptree_free_impl(tree, tree->root, false, NULL, NULL);
+        tree->root = NULL;
+        tree->head = NULL;
+        tree->tail = NULL;
+        tree->size = 0;
+        tree->height = 0;
+    }
+}
+
+void xbptree_clear_apply(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (tree) {
+        xbptree_free_impl(tree, tree->root, false, apply, cl);
+        tree->root = NULL;
+        tree->head = NULL;
+        tree->tail = NULL;
+        tree->size = 0;
+        tree->height = 0;
+    }
+}
+
+void xbptree_deep_clear(XBPTree_PT tree) {
+    if (tree) {
+        xbptree_free_impl(tree, tree->root, true, NULL, NULL);
+        tree->root = NULL;
+        tree->head = NULL;
+        tree->tail = NULL;
+        tree->size = 0;
+        tree->height = 0;
+    }
+}
+
+void xbptree_free(XBPTree_PT *ptree) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xbptree_clear(*ptree);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
+}
+
+void xbptree_free_apply(XBPTree_PT *ptree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xbptree_clear_apply(*ptree, apply, cl);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
+}
+
+void xbptree_deep_free(XBPTree_PT *ptree) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xbptree_deep_clear(*ptree);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
+}
+
+/* merge children[i + 1] into children[i] of inner, children[i + 1] is freed */
+static
+void xbptree_merge_children(XBPTree_PT tree, XBPTree_Inner_PT inner, int i) {
+    XBPTree_Node_PT left = inner->children[i];
+    XBPTree_Node_PT right = inner->children[i + 1];
+
+    if (left->leaf) {
+        XBPTree_Leaf_PT lleaf = (XBPTree_Leaf_PT)left;
+        XBPTree_Leaf_PT rleaf = (XBPTree_Leaf_PT)right;
+
+        memcpy(left->keys + left->count, right->keys, right->count * sizeof(void*));
+        memcpy(lleaf->values + left->count, rleaf->values, right->count * sizeof(void*));
+        left->count += right->count;
+
+        lleaf->next = rleaf->next;
+        if (rleaf->next) {
+            rleaf->next->prev = lleaf;
+        }
+        else {
+            tree->tail = lleaf;
+        }
+    }
+    else {
+        XBPTree_Inner_PT linner = (XBPTree_Inner_PT)left;
+        XBPTree_Inner_PT rinner = (XBPTree_Inner_PT)right;
+
+        left->keys[left->count] = inner->node.keys[i];
+        memcpy(left->keys + left->count + 1, right->keys, right->count * sizeof(void*));
+        memcpy(linner->children + left->count + 1, rinner->children, (right->count + 1) * sizeof(XBPTree_Node_PT));
+        memcpy(linner->counts + left->count + 1, rinner->counts, (right->count + 1) * sizeof(int));
+        left->count += right->count + 1;
+    }
+
+    inner->counts[i] += inner->counts[i + 1];
+
+    {
+        int count = inner->node.count;
+        memmove(inner->node.keys + i, inner->node.keys + i + 1, (count - i - 1) * sizeof(void*));
+        memmove(inner->children + i + 1, inner->children + i + 2, (count - i - 1) * sizeof(XBPTree_Node_PT));
+        memmove(inner->counts + i + 1, inner->counts + i + 2, (count - i - 1) * sizeof(int));
+        --inner->node.count;
+    }
+
+    xbptree_free_node(tree, right);
+}
+
+/* move the last key of children[i] to the front of children[i + 1] */
+static
+void xbptree_shift_right(XBPTree_Inner_PT inner, int i) {
+    XBPTree_Node_PT left = inner->children[i];
+    XBPTree_Node_PT right = inner->children[i + 1];
+    int moved = 1;
+
+    memmove(right->keys + 1, right->keys, right->count * sizeof(void*));
+
+    if (left->leaf) {
+        XBPTree_Leaf_PT lleaf = (XBPTree_Leaf_PT)left;
+        XBPTree_Leaf_PT rleaf = (XBPTree_Leaf_PT)right;
+
+        memmove(rleaf->values + 1, rleaf->values, right->count * sizeof(void*));
+        right->keys[0] = left->keys[left->count - 1];
+        rleaf->values[0] = lleaf->values[left->count - 1];
+
+        inner->node.keys[i] = right->keys[0];
+    }
+    else {
+        XBPTree_Inner_PT linner = (XBPTree_Inner_PT)left;
+        XBPTree_Inner_PT rinner = (XBPTree_Inner_PT)right;
+
+        memmove(rinner->children + 1, rinner->children, (right->count + 1) * sizeof(XBPTree_Node_PT));
+        memmove(rinner->counts + 1, rinner->counts, (right->count + 1) * sizeof(int));
+
+        right->keys[0] = inner->node.keys[i];
+        rinner->children[0] = linner->children[left->count];
+        rinner->counts[0] = linner->counts[left->count];
+        moved = rinner->counts[0];
+
+        inner->node.keys[i] = left->keys[left->count - 1];
+    }
+
+    --left->count;
+    ++right->count;
+
+    inner->counts[i] -= moved;
+    inner->counts[i + 1] += moved;
+}
+
+/* move the first key of children[i + 1] to the end of children[i] */
+static
+void xbptree_shift_left(XBPTree_Inner_PT inner, int i) {
+    XBPTree_Node_PT left = inner->children[i];
+    XBPTree_Node_PT right = inner->children[i + 1];
+    int moved = 1;
+
+    if (left->leaf) {
+        XBPTree_Leaf_PT lleaf = (XBPTree_Leaf_PT)left;
+        XBPTree_Leaf_PT rleaf = (XBPTree_Leaf_PT)right;
+
+        left->keys[left->count] = right->keys[0];
+        lleaf->values[left->count] = rleaf->values[0];
+
+        memmove(right->keys, right->keys + 1, (right->count - 1) * sizeof(void*));
+        memmove(rleaf->values, rleaf->values + 1, (right->count - 1) * sizeof(void*));
+
+        inner->node.keys[i] = right->keys[0];
+    }
+    else {
+        XBPTree_Inner_PT linner = (XBPTree_Inner_PT)left;
+        XBPTree_Inner_PT rinner = (XBPTree_Inner_PT)right;
+
+        left->keys[left->count] = inner->node.keys[i];
+        linner->children[left->count + 1] = rinner->children[0];
+        linner->counts[left->count + 1] = rinner->counts[0];
+        moved = rinner->counts[0];
+
+        inner->node.keys[i] = right->keys[0];
+
+        memmove(right->keys, right->keys + 1, (right->count - 1) * sizeof(void*));
+        memmove(rinner->children, rinner->children + 1, right->count * sizeof(XBPTree_Node_PT));
+        memmove(rinner->counts, rinner->counts + 1, right->count * sizeof(int));
+    }
+
+    ++left->count;
+    --right->count;
+
+    inner->counts[i] += moved;
+    inner->counts[i + 1] -= moved;
+}
+
+/* children[i] has too few keys : borrow one from a sibling, or merge with it */
+static
+void xbptree_fix_child(XBPTree_PT tree, XBPTree_Inner_PT inner, int i) {
+    if ((0 < i) && (XBPTREE_MIN_KEYS < inner->children[i - 1]->count)) {
+        xbptree_shift_right(inner, i - 1);
+    }
+    else if ((i < inner->node.count) && (XBPTREE_MIN_KEYS < inner->children[i + 1]->count)) {
+        xbptree_shift_left(inner, i);
+    }
+    else if (0 < i) {
+        xbptree_merge_children(tree, inner, i - 1);
+    }
+    else {
+        xbptree_merge_children(tree, inner, i);
+    }
+}
+
+static
+void xbptree_remove_impl(XBPTree_PT tree, XBPTree_Node_PT node, int k, void **key, void **value) {
+    if (node->leaf) {
+        XBPTree_Leaf_PT leaf = (XBPTree_Leaf_PT)node;
+
+        *key = node->keys[k];
+        *value = leaf->values[k];
+
+        memmove(node->keys + k, node->keys + k + 1, (node->count - k - 1) * sizeof(void*));
+        memmove(leaf->values + k, leaf->values + k + 1, (node->count - k - 1) * sizeof(void*));
+        --node->count;
+
+        return;
+    }
+
+    {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        int i = 0;
+        while (inner->counts[i] <= k) {
+            k -= inner->counts[i];
+            ++i;
+        }
+
+        xbptree_remove_impl(tree, inner->children[i], k, key, value);
+        --inner->counts[i];
+
+        if (inner->children[i]->count < XBPTREE_MIN_KEYS) {
+            xbptree_fix_child(tree, inner, i);
+        }
+    }
+}
+
+/* remove the kth key */
+static
+void xbptree_remove_index_impl(XBPTree_PT tree, int k, void **key, void **value, bool deep) {
+    void *tkey = NULL;
+    void *tvalue = NULL;
+
+    xbptree_remove_impl(tree, tree->root, k, &tkey, &tvalue);
+    --tree->size;
+
+    if (tree->root->leaf) {
+        if (tree->root->count == 0) {
+            xbptree_free_node(tree, tree->root);
+            tree->root = NULL;
+            tree->head = NULL;
+            tree->tail = NULL;
+            tree->height = 0;
+        }
+    }
+    else if (tree->root->count == 0) {
+        XBPTree_Node_PT root = tree->root;
+        tree->root = ((XBPTree_Inner_PT)root)->children[0];
+        xbptree_free_node(tree, root);
+        --tree->height;
+    }
+
+    if (deep) {
+        XMEM_FREE(tkey);
+        XMEM_FREE(tvalue);
+    }
+    else {
+        if (key) {
+            *key = tkey;
+        }
+        if (value) {
+            *value = tvalue;
+        }
+    }
+}
+
+void xbptree_remove_min(XBPTree_PT tree) {
+    if (tree && tree->root) {
+        xbptree_remove_index_impl(tree, 0, NULL, NULL, false);
+    }
+}
+
+void xbptree_remove_max(XBPTree_PT tree) {
+    if (tree && tree->root) {
+        xbptree_remove_index_impl(tree, tree->size - 1, NULL, NULL, false);
+    }
+}
+
+void xbptree_remove_save_min(XBPTree_PT tree, void **key, void **value) {
+    if (tree && tree->root) {
+        xbptree_remove_index_impl(tree, 0, key, value, false);
+    }
+}
+
+void xbptree_remove_save_max(XBPTree_PT tree, void **key, void **value) {
+    if (tree && tree->root) {
+        xbptree_remove_index_impl(tree, tree->size - 1, key, value, false);
+    }
+}
+
+void xbptree_deep_remove_min(XBPTree_PT tree) {
+    if (tree && tree->root) {
+        xbptree_remove_index_impl(tree, 0, NULL, NULL, true);
+    }
+}
+
+void xbptree_deep_remove_max(XBPTree_PT tree) {
+    if (tree && tree->root) {
+        xbptree_remove_index_impl(tree, tree->size - 1, NULL, NULL, true);
+    }
+}
+
+/* remove the first one of the keys equal to key, return the removed number */
+static
+int xbptree_remove_key_impl(XBPTree_PT tree, void *key, void **value, bool deep) {
+    int pos = 0;
+    int rank = 0;
+
+    if (!xbptree_get_impl(tree, key, &pos, &rank)) {
+        return 0;
+    }
+
+    xbptree_remove_index_impl(tree, rank, NULL, value, deep);
+    return 1;
+}
+
+int xbptree_remove(XBPTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return 0;
+    }
+
+    return xbptree_remove_key_impl(tree, key, NULL, false);
+}
+
+int xbptree_remove_save(XBPTree_PT tree, void *key, void **value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return 0;
+    }
+
+    return xbptree_remove_key_impl(tree, key, value, false);
+}
+
+int xbptree_deep_remove(XBPTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return 0;
+    }
+
+    return xbptree_remove_key_impl(tree, key, NULL, true);
+}
+
+/* for internal use : change the key, the node is moved to keep the keys in order */
+/* move the keys of rank [lo, hi) to a new tree :
+*    the moved keys are built into the new tree in O(K), then they are removed from the tree one by one in O(KlgN),
+*    or the tree is rebuilt with the rest keys in O(N) if that's cheaper
+*/
+static
+XBPTree_PT xbptree_remove_rank_range_impl(XBPTree_PT tree, int lo, int hi) {
+    XBPTree_PT ntree = xbptree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+    if (!ntree) {
+        return NULL;
+    }
+
+    if (hi <= lo) {
+        return ntree;
+    }
+
+    {
+        int count = hi - lo;
+        int size = tree->size;
+
+        int lgn = 1;
+        for (int k = size; 1 < k; k /= 2) {
+            ++lgn;
+        }
+
+        {
+            bool rebuild = (size < (long)count * lgn);
+
+            /* keys[0, count) : the moved keys,  keys[count, size) : the rest keys (only for rebuilding) */
+            int total = rebuild ? size : count;
+            void **keys = XMEM_MALLOC(2 * total * sizeof(void*));
+            void **values = keys + total;
+            if (!keys) {
+                xbptree_free(&ntree);
+                return NULL;
+            }
+
+            {
+                int pos = 0;
+                int rank = rebuild ? 0 : lo;
+                int rest = count;
+
+                XBPTree_Leaf_PT leaf = rebuild ? tree->head : xbptree_select_impl(tree, lo, &pos);
+                for (; leaf && (rank < (rebuild ? size : hi)); ++rank) {
+                    int i = ((lo <= rank) && (rank < hi)) ? (rank - lo) : rest++;
+                    keys[i] = leaf->node.keys[pos];
+                    values[i] = leaf->values[pos];
+
+                    ++pos;
+                    leaf = xbptree_normalize_pos(leaf, &pos);
+                }
+            }
+
+            if (!xbptree_build_sorted(ntree, keys, values, count)) {
+                XMEM_FREE(keys);
+                xbptree_free(&ntree);
+                return NULL;
+            }
+
+            if (rebuild) {
+                XBPTree_PT rtree = xbptree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+                if (!rtree || !xbptree_build_sorted(rtree, keys + count, values + count, size - count)) {
+                    xbptree_free(&rtree);
+                    XMEM_FREE(keys);
+                    xbptree_free(&ntree);
+                    return NULL;
+                }
+
+                /* rtree takes the old nodes away */
+                xbptree_swap(tree, rtree);
+                xbptree_free(&rtree);
+            }
+            else {
+                for (int i = 0; i < count; ++i) {
+                    xbptree_remove_index_impl(tree, lo, NULL, NULL, false);
+                }
+            }
+
+            XMEM_FREE(keys);
+        }
+    }
+
+    return ntree;
+}
+
+XBPTree_PT xbptree_split(XBPTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        int pos = 0;
+        int lo = 0;
+
+        xbptree_bound_impl(tree, key, false, &pos, &lo);
+        return xbptree_remove_rank_range_impl(tree, lo, tree->size);
+    }
+}
+
+XBPTree_PT xbptree_remove_range(XBPTree_PT tree, void *low, void *high) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+
+    if (!tree || !low || !high) {
+        return NULL;
+    }
+
+    if (0 < tree->cmp(low, high, tree->cl)) {
+        void *tmp = low;
+        low = high;
+        high = tmp;
+    }
+
+    {
+        int pos = 0;
+        int lo = 0;
+        int hi = 0;
+
+        xbptree_bound_impl(tree, low, false, &pos, &lo);
+        xbptree_bound_impl(tree, high, true, &pos, &hi);
+        return xbptree_remove_rank_range_impl(tree, lo, hi);
+    }
+}
+
+void xbptree_replace_key(XBPTree_PT tree, void *old_key, void *new_key) {
+    void *value = NULL;
+
+    if (tree && old_key && new_key && xbptree_remove_save(tree, old_key, &value)) {
+        xbptree_put_repeat(tree, new_key, value);
+    }
+}
+
+/* visit from leaf[pos] to the max (or min) key, stop if high is set and key is greater than high,
+ * return the apply true number, *broken is set if break_if and apply returns break_true
+ */
+static
+int xbptree_map_impl(XBPTree_PT tree, XBPTree_Leaf_PT leaf, int pos, void *high, bool min_to_max, bool break_if, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl, bool *broken) {
+    int count = 0;
+
+    while (leaf) {
+        if (min_to_max) {
+            for (; pos < leaf->node.count; ++pos) {
+                if (high && (0 < tree->cmp(leaf->node.keys[pos], high, tree->cl))) {
+                    return count;
+                }
+
+                {
+                    bool ret = apply(leaf->node.keys[pos], &leaf->values[pos], cl);
+                    if (ret) {
+                        ++count;
+                    }
+                    if (break_if && (ret == break_true)) {
+                        *broken = true;
+                        return count;
+                    }
+                }
+            }
+
+            leaf = leaf->next;
+            pos = 0;
+        }
+        else {
+            for (; 0 <= pos; --pos) {
+                bool ret = apply(leaf->node.keys[pos], &leaf->values[pos], cl);
+                if (ret) {
+                    ++count;
+                }
+                if (break_if && (ret == break_true)) {
+                    *broken = true;
+                    return count;
+                }
+            }
+
+            leaf = leaf->prev;
+            pos = leaf ? leaf->node.count - 1 : 0;
+        }
+    }
+
+    return count;
+}
+
+int xbptree_map_min_to_max(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply) {
+        return 0;
+    }
+
+    {
+        bool broken = false;
+        return xbptree_map_impl(tree, tree->head, 0, NULL, true, false, false, apply, cl, &broken);
+    }
+}
+
+bool xbptree_map_min_to_max_break_if_true(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply) {
+        return false;
+    }
+
+    {
+        bool broken = false;
+        xbptree_map_impl(tree, tree->head, 0, NULL, true, true, true, apply, cl, &broken);
+        return broken;
+    }
+}
+
+bool xbptree_map_min_to_max_break_if_false(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply) {
+        return false;
+    }
+
+    {
+        bool broken = false;
+        xbptree_map_impl(tree, tree->head, 0, NULL, true, true, false, apply, cl, &broken);
+        return broken;
+    }
+}
+
+int xbptree_map_max_to_min(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply || !tree->tail) {
+        return 0;
+    }
+
+    {
+        bool broken = false;
+        return xbptree_map_impl(tree, tree->tail, tree->tail->node.count - 1, NULL, false, false, false, apply, cl, &broken);
+    }
+}
+
+bool xbptree_map_max_to_min_break_if_true(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply || !tree->tail) {
+        return false;
+    }
+
+    {
+        bool broken = false;
+        xbptree_map_impl(tree, tree->tail, tree->tail->node.count - 1, NULL, false, true, true, apply, cl, &broken);
+        return broken;
+    }
+}
+
+bool xbptree_map_max_to_min_break_if_false(XBPTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply || !tree->tail) {
+        return false;
+    }
+
+    {
+        bool broken = false;
+        xbptree_map_impl(tree, tree->tail, tree->tail->node.count - 1, NULL, false, true, false, apply, cl, &broken);
+        return broken;
+    }
+}
+
+static
+int xbptree_scope_map_impl(XBPTree_PT tree, void *low, void *high, bool break_if, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl, bool *broken) {
+    if (0 < tree->cmp(low, high, tree->cl)) {
+        void *tmp = low;
+        low = high;
+        high = tmp;
+    }
+
+    {
+        int pos = 0;
+        XBPTree_Leaf_PT leaf = xbptree_lower_bound(tree, low, &pos, NULL);
+        return xbptree_map_impl(tree, leaf, pos, high, true, break_if, break_true, apply, cl, broken);
+    }
+}
+
+int xbptree_scope_map_min_to_max(XBPTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+    xassert(apply);
+
+    if (!tree || !low || !high || !apply) {
+        return 0;
+    }
+
+    {
+        bool broken = false;
+        return xbptree_scope_map_impl(tree, low, high, false, false, apply, cl, &broken);
+    }
+}
+
+bool xbptree_scope_map_min_to_max_break_if_true(XBPTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+    xassert(apply);
+
+    if (!tree || !low || !high || !apply) {
+        return false;
+    }
+
+    {
+        bool broken = false;
+        xbptree_scope_map_impl(tree, low, high, true, true, apply, cl, &broken);
+        return broken;
+    }
+}
+
+bool xbptree_scope_map_min_to_max_break_if_false(XBPTree_PT tree, void *low, void *high, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+    xassert(apply);
+
+    if (!tree || !low || !high || !apply) {
+        return false;
+    }
+
+    {
+        bool broken = false;
+        xbptree_scope_map_impl(tree, low, high, true, false, apply, cl, &broken);
+        return broken;
+    }
+}
+
+void xbptree_cursor_init(XBPTree_Cursor_PT cursor, XBPTree_PT tree) {
+    xassert(cursor);
+    xassert(tree);
+
+    if (!cursor) {
+        return;
+    }
+
+    cursor->tree = tree;
+    cursor->leaf = NULL;
+    cursor->pos = 0;
+}
+
+bool xbptree_cursor_first(XBPTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->leaf = cursor->tree->head;
+    cursor->pos = 0;
+    return cursor->leaf != NULL;
+}
+
+bool xbptree_cursor_last(XBPTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->leaf = cursor->tree->tail;
+    cursor->pos = cursor->tree->tail ? cursor->tree->tail->node.count - 1 : 0;
+    return cursor->leaf != NULL;
+}
+
+bool xbptree_cursor_seek(XBPTree_Cursor_PT cursor, void *key) {
+    xassert(cursor);
+    xassert(key);
+
+    if (!cursor || !cursor->tree || !key) {
+        return false;
+    }
+
+    cursor->pos = 0;
+    cursor->leaf = xbptree_lower_bound(cursor->tree, key, &cursor->pos, NULL);
+    return cursor->leaf != NULL;
+}
+
+bool xbptree_cursor_next(XBPTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->leaf) {
+        return false;
+    }
+
+    ++cursor->pos;
+    cursor->leaf = xbptree_normalize_pos((XBPTree_Leaf_PT)cursor->leaf, &cursor->pos);
+    return cursor->leaf != NULL;
+}
+
+bool xbptree_cursor_prev(XBPTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->leaf) {
+        return false;
+    }
+
+    if (0 < cursor->pos) {
+        --cursor->pos;
+        return true;
+    }
+
+    {
+        XBPTree_Leaf_PT leaf = ((XBPTree_Leaf_PT)cursor->leaf)->prev;
+        cursor->leaf = leaf;
+        cursor->pos = leaf ? leaf->node.count - 1 : 0;
+        return leaf != NULL;
+    }
+}
+
+bool xbptree_cursor_valid(XBPTree_Cursor_PT cursor) {
+    return cursor ? (cursor->leaf != NULL) : false;
+}
+
+void* xbptree_cursor_key(XBPTree_Cursor_PT cursor) {
+    return (cursor && cursor->leaf) ? ((XBPTree_Leaf_PT)cursor->leaf)->node.keys[cursor->pos] : NULL;
+}
+
+void* xbptree_cursor_value(XBPTree_Cursor_PT cursor) {
+    return (cursor && cursor->leaf) ? ((XBPTree_Leaf_PT)cursor->leaf)->values[cursor->pos] : NULL;
+}
+
+bool xbptree_swap(XBPTree_PT tree1, XBPTree_PT tree2) {
+    xassert(tree1);
+    xassert(tree2);
+    xassert(tree1->allocator == tree2->allocator);
+
+    if (!tree1 || !tree2 || (tree1->allocator != tree2->allocator)) {
+        return false;
+    }
+
+    {
+        struct XBPTree tmp = *tree1;
+        *tree1 = *tree2;
+        *tree2 = tmp;
+    }
+
+    return true;
+}
+
+int xbptree_size(XBPTree_PT tree) {
+    return tree ? tree->size : 0;
+}
+
+bool xbptree_is_empty(XBPTree_PT tree) {
+    return tree ? (tree->size == 0) : true;
+}
+
+int xbptree_keys_size(XBPTree_PT tree, void *low, void *high) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+
+    if (!tree || !tree->root || !low || !high) {
+        return 0;
+    }
+
+    if (0 < tree->cmp(low, high, tree->cl)) {
+        void *tmp = low;
+        low = high;
+        high = tmp;
+    }
+
+    {
+        int pos = 0;
+        int low_rank = 0;
+        int high_rank = 0;
+
+        xbptree_bound_impl(tree, low, false, &pos, &low_rank);
+        xbptree_bound_impl(tree, high, true, &pos, &high_rank);
+
+        return high_rank - low_rank;
+    }
+}
+
+int xbptree_height(XBPTree_PT tree) {
+    return tree ? tree->height : 0;
+}
+
+/* check the sub tree : keys are in [low, high] (if set), counts are right and all leaves are in the same depth */
+static
+bool xbptree_is_bptree_impl(XBPTree_PT tree, XBPTree_Node_PT node, void *low, void *high, int depth, bool root, XBPTree_Leaf_PT *last) {
+    if ((XBPTREE_MAX_KEYS < node->count) || (node->count < (root ? 1 : XBPTREE_MIN_KEYS))) {
+        return false;
+    }
+
+    for (int i = 0; i < node->count; ++i) {
+        if ((0 < i) && (tree->cmp(node->keys[i], node->keys[i - 1], tree->cl) < 0)) {
+            return false;
+        }
+        if (low && (tree->cmp(node->keys[i], low, tree->cl) < 0)) {
+            return false;
+        }
+        if (high && (0 < tree->cmp(node->keys[i], high, tree->cl))) {
+            return false;
+        }
+    }
+
+    if (node->leaf) {
+        XBPTree_Leaf_PT leaf = (XBPTree_Leaf_PT)node;
+        if ((depth != tree->height) || (leaf->prev != *last) || (*last && ((*last)->next != leaf)) || (!*last && (tree->head != leaf))) {
+            return false;
+        }
+
+        *last = leaf;
+        return true;
+    }
+
+    {
+        XBPTree_Inner_PT inner = (XBPTree_Inner_PT)node;
+        for (int i = 0; i <= node->count; ++i) {
+            void *clow = (0 < i) ? node->keys[i - 1] : low;
+            void *chigh = (i < node->count) ? node->keys[i] : high;
+
+            if (inner->counts[i] != xbptree_node_size(inner->children[i])) {
+                return false;
+            }
+            if (!xbptree_is_bptree_impl(tree, inner->children[i], clow, chigh, depth + 1, false, last)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool xbptree_is_bptree(XBPTree_PT tree) {
+    if (!tree) {
+        return false;
+    }
+
+    if (!tree->root) {
+        return (tree->size == 0) && (tree->height == 0) && !tree->head && !tree->tail;
+    }
+
+    {
+        XBPTree_Leaf_PT last = NULL;
+        if (!xbptree_is_bptree_impl(tree, tree->root, NULL, NULL, 1, true, &last)) {
+            return false;
+        }
+
+        return (last == tree->tail) && (tree->size == xbptree_node_size(tree->root)) && !tree->head->prev && !tree->tail->next;
+    }
+}
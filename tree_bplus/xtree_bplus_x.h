@@ -0,0 +1,83 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XBPTREEX_INCLUDED
+#define XBPTREEX_INCLUDED
+
+#include "../include/xtree_bplus.h"
+
+/* Note :
+*    1. all keys and values are saved in leaves, leaves are linked from min to max (and back) for range scanning.
+*    2. inner nodes save separators only : keys of children[i] <= keys[i] <= keys of children[i + 1],
+*       "repeat" keys may cross several leaves.
+*    3. inner nodes save the key number of each child in counts[], select and rank need no more node visits.
+*    4. the keys array of one node takes XBPTREE_MAX_KEYS pointers (4 cache lines on 64 bits system),
+*       all the nodes (except the root) keep [XBPTREE_MAX_KEYS / 2, XBPTREE_MAX_KEYS] keys.
+*/
+
+/* must be an even number (>= 4) */
+#define XBPTREE_MAX_KEYS      32
+#define XBPTREE_MIN_KEYS      (XBPTREE_MAX_KEYS / 2)
+
+typedef struct XBPTree_Node        XBPTree_Node_T;
+typedef struct XBPTree_Node*       XBPTree_Node_PT;
+
+typedef struct XBPTree_Leaf        XBPTree_Leaf_T;
+typedef struct XBPTree_Leaf*       XBPTree_Leaf_PT;
+
+typedef struct XBPTree_Inner       XBPTree_Inner_T;
+typedef struct XBPTree_Inner*      XBPTree_Inner_PT;
+
+struct XBPTree_Node {
+    bool             leaf;
+    int              count;                           /* key number */
+
+    void            *keys[XBPTREE_MAX_KEYS];
+};
+
+struct XBPTree_Leaf {
+    XBPTree_Node_T   node;
+
+    void            *values[XBPTREE_MAX_KEYS];
+
+    XBPTree_Leaf_PT  prev;
+    XBPTree_Leaf_PT  next;
+};
+
+struct XBPTree_Inner {
+    XBPTree_Node_T   node;
+
+    int              counts[XBPTREE_MAX_KEYS + 1];    /* key number in each child */
+    XBPTree_Node_PT  children[XBPTREE_MAX_KEYS + 1];
+};
+
+struct XBPTree {
+    XBPTree_Node_PT  root;
+
+    XBPTree_Leaf_PT  head;                            /* leaf with the min key */
+    XBPTree_Leaf_PT  tail;                            /* leaf with the max key */
+
+    int              size;
+    int              height;                          /* 0 : empty, 1 : root is a leaf */
+
+    int (*cmp)(void *key1, void *key2, void *cl);
+    void *cl;
+
+    XMem_Allocator_PT allocator;                      /* the tree and its nodes come from it, NULL : XMEM */
+};
+
+/* for internal use */
+
+/* O(lgN) */
+extern void xbptree_replace_key(XBPTree_PT tree, void *old_key, void *new_key);
+
+#endif
@@ -10,125 +10,198 @@
 *   If not, see <https://mit-license.org/>.
 */
 
-#include "../tree_redblack/xtree_redblack_x.h"
 #include "xtree_map_x.h"
 
+#ifdef XMAP_BPTREE
+#define XMAP_IMPL(name)  xbptree_##name
+#else
+#define XMAP_IMPL(name)  xrbtree_##name
+#endif
+
 XMap_PT xmap_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
-    return xrbtree_new(cmp, cl);
+    return XMAP_IMPL(new)(cmp, cl);
+}
+
+XMap_PT xmap_new_allocator(int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    return XMAP_IMPL(new_allocator)(cmp, cl, allocator);
 }
 
 XMap_PT xmap_copy(XMap_PT map) {
-    return xrbtree_copy(map);
+    return XMAP_IMPL(copy)(map);
 }
 
 XMap_PT xmap_deep_copy(XMap_PT map, int key_size, int value_size) {
-    return xrbtree_deep_copy(map, key_size, value_size);
+    return XMAP_IMPL(deep_copy)(map, key_size, value_size);
 }
 
 bool xmap_put_repeat(XMap_PT map, void *key, void *value) {
-    return xrbtree_put_repeat(map, key, value);
+    return XMAP_IMPL(put_repeat)(map, key, value);
 }
 
 bool xmap_put_unique(XMap_PT map, void *key, void *value) {
-    return xrbtree_put_unique(map, key, value);
+    return XMAP_IMPL(put_unique)(map, key, value);
 }
 
 bool xmap_put_replace(XMap_PT map, void *key, void *value, void **old_value) {
-    return xrbtree_put_replace(map, key, value, old_value);
+    return XMAP_IMPL(put_replace)(map, key, value, old_value);
 }
 
 bool xmap_put_deep_replace(XMap_PT map, void *key, void *value) {
-    return xrbtree_put_deep_replace(map, key, value);
+    return XMAP_IMPL(put_deep_replace)(map, key, value);
+}
+
+bool xmap_build_sorted(XMap_PT map, void **keys, void **values, int count) {
+    return XMAP_IMPL(build_sorted)(map, keys, values, count);
+}
+
+bool xmap_build_sorted_parray(XMap_PT map, XPArray_PT keys, XPArray_PT values) {
+    return XMAP_IMPL(build_sorted_parray)(map, keys, values);
+}
+
+void* xmap_min(XMap_PT map) {
+    return XMAP_IMPL(min)(map);
 }
 
+void* xmap_max(XMap_PT map) {
+    return XMAP_IMPL(max)(map);
+}
+
+#if defined(XMAP_BPTREE) || !defined(XRBTREE_NO_SIZE)
 void* xmap_select(XMap_PT map, int k) {
-    return xrbtree_select(map, k);
+    return XMAP_IMPL(select)(map, k);
 }
+#endif
 
 void* xmap_get(XMap_PT map, void *key) {
-    return xrbtree_get(map, key);
+    return XMAP_IMPL(get)(map, key);
 }
 
 bool xmap_find(XMap_PT map, void *key) {
-    return xrbtree_find(map, key);
+    return XMAP_IMPL(find)(map, key);
 }
 
 bool xmap_find_replace(XMap_PT map, void *key, void *value, void **old_value) {
-    return xrbtree_find_replace(map, key, value, old_value);
+    return XMAP_IMPL(find_replace)(map, key, value, old_value);
 }
 
 bool xmap_find_deep_replace(XMap_PT map, void *key, void *value) {
-    return xrbtree_find_deep_replace(map, key, value);
+    return XMAP_IMPL(find_deep_replace)(map, key, value);
 }
 
 void xmap_replace_key(XMap_PT map, void *old_key, void *new_key) {
-    xrbtree_replace_key(map, old_key, new_key);
+    XMAP_IMPL(replace_key)(map, old_key, new_key);
 }
 
 void xmap_clear(XMap_PT map) {
-    xrbtree_clear(map);
+    XMAP_IMPL(clear)(map);
 }
 
 void xmap_clear_apply(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    xrbtree_clear_apply(map, apply, cl);
+    XMAP_IMPL(clear_apply)(map, apply, cl);
 }
 
 void xmap_deep_clear(XMap_PT map) {
-    xrbtree_deep_clear(map);
+    XMAP_IMPL(deep_clear)(map);
 }
 
 void xmap_free(XMap_PT *pmap) {
-    xrbtree_free(pmap);
+    XMAP_IMPL(free)(pmap);
 }
 
 void xmap_free_apply(XMap_PT *pmap, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    xrbtree_free_apply(pmap, apply, cl);
+    XMAP_IMPL(free_apply)(pmap, apply, cl);
 }
 
 void xmap_deep_free(XMap_PT *pmap) {
-    xrbtree_deep_free(pmap);
+    XMAP_IMPL(deep_free)(pmap);
 }
 
 void xmap_remove(XMap_PT map, void *key) {
-    xrbtree_remove(map, key);
+    XMAP_IMPL(remove)(map, key);
 }
 
 void xmap_remove_save(XMap_PT map, void *key, void **value) {
-    xrbtree_remove_save(map, key, value);
+    XMAP_IMPL(remove_save)(map, key, value);
 }
 
 void xmap_deep_remove(XMap_PT map, void *key) {
-    xrbtree_deep_remove(map, key);
+    XMAP_IMPL(deep_remove)(map, key);
+}
+
+#if defined(XMAP_BPTREE) || !defined(XRBTREE_NO_SIZE)
+XMap_PT xmap_split(XMap_PT map, void *key) {
+    return XMAP_IMPL(split)(map, key);
 }
 
+XMap_PT xmap_remove_range(XMap_PT map, void *low, void *high) {
+    return XMAP_IMPL(remove_range)(map, low, high);
+}
+#endif
+
 int xmap_map(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    return xrbtree_map_min_to_max(map, apply, cl);
+    return XMAP_IMPL(map_min_to_max)(map, apply, cl);
 }
 
 bool xmap_map_break_if_true(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    return xrbtree_map_min_to_max_break_if_true(map, apply, cl);
+    return XMAP_IMPL(map_min_to_max_break_if_true)(map, apply, cl);
 }
 
 bool xmap_map_break_if_false(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    return xrbtree_map_min_to_max_break_if_false(map, apply, cl);
+    return XMAP_IMPL(map_min_to_max_break_if_false)(map, apply, cl);
 }
 
 int xmap_map_min_to_max(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    return xrbtree_map_min_to_max(map, apply, cl);
+    return XMAP_IMPL(map_min_to_max)(map, apply, cl);
 }
 
 int xmap_map_max_to_min(XMap_PT map, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    return xrbtree_map_max_to_min(map, apply, cl);
+    return XMAP_IMPL(map_max_to_min)(map, apply, cl);
+}
+
+void xmap_cursor_init(XMap_Cursor_PT cursor, XMap_PT map) {
+    XMAP_IMPL(cursor_init)(cursor, map);
+}
+
+bool xmap_cursor_first(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_first)(cursor);
+}
+
+bool xmap_cursor_last(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_last)(cursor);
+}
+
+bool xmap_cursor_seek(XMap_Cursor_PT cursor, void *key) {
+    return XMAP_IMPL(cursor_seek)(cursor, key);
+}
+
+bool xmap_cursor_next(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_next)(cursor);
+}
+
+bool xmap_cursor_prev(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_prev)(cursor);
+}
+
+bool xmap_cursor_valid(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_valid)(cursor);
+}
+
+void* xmap_cursor_key(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_key)(cursor);
+}
+
+void* xmap_cursor_value(XMap_Cursor_PT cursor) {
+    return XMAP_IMPL(cursor_value)(cursor);
 }
 
 bool xmap_swap(XMap_PT map1, XMap_PT map2) {
-    return xrbtree_swap(map1, map2);
+    return XMAP_IMPL(swap)(map1, map2);
 }
 
 int xmap_size(XMap_PT map) {
-    return xrbtree_size(map);
+    return XMAP_IMPL(size)(map);
 }
 
 bool xmap_is_empty(XMap_PT map) {
-    return xrbtree_is_empty(map);
+    return XMAP_IMPL(is_empty)(map);
 }
@@ -14,6 +14,8 @@
 #define XMAPX_INCLUDED
 
 #include "../include/xtree_map.h"
+#include "../tree_redblack/xtree_redblack_x.h"
+#include "../tree_bplus/xtree_bplus_x.h"
 
 /* for internal use */
 
@@ -12,11 +12,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../include/xassert.h"
 #include "../include/xmem.h"
 #include "../utils/xutils.h"
 #include "../include/xqueue_fifo.h"
+#include "../array_pointer/xarray_pointer_x.h"
 #include "xtree_redblack_x.h"
 
 static const bool xrbtree_color_red = false;
@@ -24,12 +26,52 @@ static const bool xrbtree_color_black = true;
 
 static
 bool xrbtree_node_color_red(XRBTree_Node_PT node) {
-    return node ? (node->color == xrbtree_color_red) : false;
+    return node ? (xrbtree_node_color(node) == xrbtree_color_red) : false;
 }
 
 static
 bool xrbtree_node_color_black(XRBTree_Node_PT node) {
-    return node ? (node->color == xrbtree_color_black) : true;
+    return node ? (xrbtree_node_color(node) == xrbtree_color_black) : true;
+}
+
+/* the summary of the node's subtree is saved just after the node, only used if tree->augment is set */
+static
+void* xrbtree_node_aux(XRBTree_Node_PT node) {
+    return node ? (void*)(node + 1) : NULL;
+}
+
+/* recompute the size (and the summary) of the node from its children */
+static
+void xrbtree_update_node(XRBTree_PT tree, XRBTree_Node_PT node) {
+#ifndef XRBTREE_NO_SIZE
+    node->size = 1 + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
+#endif
+
+    if (tree->augment) {
+        tree->augment(node->key, node->value, xrbtree_node_aux(node), xrbtree_node_aux(node->left), xrbtree_node_aux(node->right), tree->augment_cl);
+    }
+}
+
+/* the key or value of node is changed in place, the summaries of all its ancestors are changed too */
+static
+void xrbtree_update_to_root(XRBTree_PT tree, XRBTree_Node_PT node) {
+    if (!tree->augment) {
+        return;
+    }
+
+    for (; node; node = xrbtree_node_parent(node)) {
+        xrbtree_update_node(tree, node);
+    }
+}
+
+/* compare key (hash is its hash code) with node->key, hash codes are compared first in hashed trees */
+static
+int xrbtree_cmp_node(XRBTree_PT tree, void *key, int hash, XRBTree_Node_PT node) {
+    if (tree->hashed && (hash != xrbtree_node_hash(node))) {
+        return (hash < xrbtree_node_hash(node)) ? -1 : 1;
+    }
+
+    return tree->cmp(key, node->key, tree->cl);
 }
 
 static
@@ -58,14 +100,13 @@ XRBTree_Node_PT xrbtree_max_impl(XRBTree_PT tree, XRBTree_Node_PT node) {
     return node;
 }
 
-static
-XRBTree_Node_PT xrbtree_get_impl(XRBTree_PT tree, XRBTree_Node_PT node, void *key) {
+XRBTree_Node_PT xrbtree_get_hash_impl(XRBTree_PT tree, XRBTree_Node_PT node, void *key, int hash) {
     if (!tree || !key) {
         return NULL;
     }
 
     while (node) {
-        int ret = tree->cmp(key, node->key, tree->cl);
+        int ret = xrbtree_cmp_node(tree, key, hash, node);
         if (ret == 0) {
             return node;
         }
@@ -80,6 +121,11 @@ XRBTree_Node_PT xrbtree_get_impl(XRBTree_PT tree, XRBTree_Node_PT node, void *ke
     return NULL;
 }
 
+static
+XRBTree_Node_PT xrbtree_get_impl(XRBTree_PT tree, XRBTree_Node_PT node, void *key) {
+    return xrbtree_get_hash_impl(tree, node, key, 0);
+}
+
 static
 XRBTree_Node_PT xrbtree_prev_node(XRBTree_PT tree, XRBTree_Node_PT node) {
     if (node->left) {
@@ -94,10 +140,10 @@ XRBTree_Node_PT xrbtree_prev_node(XRBTree_PT tree, XRBTree_Node_PT node) {
         *        / \
         *       H   S
         */
-        XRBTree_Node_PT parent = node->parent;
+        XRBTree_Node_PT parent = xrbtree_node_parent(node);
         while (parent && (node == parent->left)) {
             node = parent;
-            parent = parent->parent;
+            parent = xrbtree_node_parent(parent);
         }
 
         return parent;
@@ -118,10 +164,10 @@ XRBTree_Node_PT xrbtree_next_node(XRBTree_PT tree, XRBTree_Node_PT node) {
         *      \
         *       R
         */
-        XRBTree_Node_PT parent = node->parent;
+        XRBTree_Node_PT parent = xrbtree_node_parent(node);
         while (parent && (node == parent->right)) {
             node = parent;
-            parent = parent->parent;
+            parent = xrbtree_node_parent(parent);
         }
 
         return parent;
@@ -143,12 +189,12 @@ XRBTree_Node_PT xrbtree_next_node(XRBTree_PT tree, XRBTree_Node_PT node) {
 */
 static
 void xrbtree_flip_color(XRBTree_Node_PT node_N) {
-    node_N->color = !node_N->color;
+    xrbtree_node_set_color(node_N, !xrbtree_node_color(node_N));
     if (node_N->left) {
-        node_N->left->color = !node_N->left->color;
+        xrbtree_node_set_color(node_N->left, !xrbtree_node_color(node_N->left));
     }
     if (node_N->right) {
-        node_N->right->color = !node_N->right->color;
+        xrbtree_node_set_color(node_N->right, !xrbtree_node_color(node_N->right));
     }
 }
 
@@ -162,32 +208,32 @@ void xrbtree_flip_color(XRBTree_Node_PT node_N) {
 *       F    T        D    F
 */
 static
-XRBTree_Node_PT xrbtree_rotate_left(XRBTree_Node_PT node_N) {
+XRBTree_Node_PT xrbtree_rotate_left(XRBTree_PT tree, XRBTree_Node_PT node_N) {
     XRBTree_Node_PT x = node_N->right;
 
     node_N->right = x->left;
     if (x->left) {
-        x->left->parent = node_N;
+        xrbtree_node_set_parent(x->left, node_N);
     }
 
-    x->parent = node_N->parent;
+    xrbtree_node_set_parent(x, xrbtree_node_parent(node_N));
 
-    if (node_N->parent) {
-        if (node_N == node_N->parent->left) {
-            node_N->parent->left = x;
+    if (xrbtree_node_parent(node_N)) {
+        if (node_N == xrbtree_node_parent(node_N)->left) {
+            xrbtree_node_parent(node_N)->left = x;
         }
         else {
-            node_N->parent->right = x;
+            xrbtree_node_parent(node_N)->right = x;
         }
     }
 
     x->left = node_N;
-    node_N->parent = x;
+    xrbtree_node_set_parent(node_N, x);
 
-    x->color = node_N->color;
-    node_N->color = xrbtree_color_red;
-    x->size = node_N->size;
-    node_N->size = 1 + (node_N->left ? node_N->left->size : 0) + (node_N->right ? node_N->right->size : 0);
+    xrbtree_node_set_color(x, xrbtree_node_color(node_N));
+    xrbtree_node_set_color(node_N, xrbtree_color_red);
+    xrbtree_update_node(tree, node_N);
+    xrbtree_update_node(tree, x);
 
     return x;
 }
@@ -202,38 +248,38 @@ XRBTree_Node_PT xrbtree_rotate_left(XRBTree_Node_PT node_N) {
 *    D    F                  F    T
 */
 static
-XRBTree_Node_PT xrbtree_rotate_right(XRBTree_Node_PT node_N) {
+XRBTree_Node_PT xrbtree_rotate_right(XRBTree_PT tree, XRBTree_Node_PT node_N) {
     XRBTree_Node_PT x = node_N->left;
 
     node_N->left = x->right;
     if (x->right) {
-        x->right->parent = node_N;
+        xrbtree_node_set_parent(x->right, node_N);
     }
 
-    x->parent = node_N->parent;
+    xrbtree_node_set_parent(x, xrbtree_node_parent(node_N));
 
-    if (node_N->parent) {
-        if (node_N == node_N->parent->left) {
-            node_N->parent->left = x;
+    if (xrbtree_node_parent(node_N)) {
+        if (node_N == xrbtree_node_parent(node_N)->left) {
+            xrbtree_node_parent(node_N)->left = x;
         }
         else {
-            node_N->parent->right = x;
+            xrbtree_node_parent(node_N)->right = x;
         }
     }
 
     x->right = node_N;
-    node_N->parent = x;
+    xrbtree_node_set_parent(node_N, x);
 
-    x->color = node_N->color;
-    node_N->color = xrbtree_color_red;
-    x->size = node_N->size;
-    node_N->size = 1 + (node_N->left ? node_N->left->size : 0) + (node_N->right ? node_N->right->size : 0);
+    xrbtree_node_set_color(x, xrbtree_node_color(node_N));
+    xrbtree_node_set_color(node_N, xrbtree_color_red);
+    xrbtree_update_node(tree, node_N);
+    xrbtree_update_node(tree, x);
      
     return x;
 }
 
 static
-XRBTree_Node_PT xrbtree_balance(XRBTree_Node_PT node_N) {
+XRBTree_Node_PT xrbtree_balance(XRBTree_PT tree, XRBTree_Node_PT node_N) {
     /* 1. node_N->left is red, node_N->right is black */
     if (xrbtree_node_color_red(node_N->left) && xrbtree_node_color_black(node_N->right)) {
         /* 1.1 node_N->left->right is red, left rotate at first, then right rotate as step 1.2 :
@@ -245,7 +291,7 @@ XRBTree_Node_PT xrbtree_balance(XRBTree_Node_PT node_N) {
         *       F(R)           D(R)
         */
         if (xrbtree_node_color_black(node_N->left->left) && xrbtree_node_color_red(node_N->left->right)) {
-            node_N->left = xrbtree_rotate_left(node_N->left);
+            node_N->left = xrbtree_rotate_left(tree, node_N->left);
         }
 
         /* 1.2 node_N->left->left is red, right rotate :
@@ -257,7 +303,7 @@ XRBTree_Node_PT xrbtree_balance(XRBTree_Node_PT node_N) {
         *   D(R)                          X
         */
         if (xrbtree_node_color_red(node_N->left->left) && xrbtree_node_color_black(node_N->left->right)) {
-            node_N = xrbtree_rotate_right(node_N);
+            node_N = xrbtree_rotate_right(tree, node_N);
         }
     }
 
@@ -272,7 +318,7 @@ XRBTree_Node_PT xrbtree_balance(XRBTree_Node_PT node_N) {
         *         U(R)                   X(R)
         */
         if (xrbtree_node_color_red(node_N->right->left) && xrbtree_node_color_black(node_N->right->right)) {
-            node_N->right = xrbtree_rotate_right(node_N->right);
+            node_N->right = xrbtree_rotate_right(tree, node_N->right);
         }
 
         /* 2.2 node_N->right->right is red, left rotate :
@@ -284,7 +330,7 @@ XRBTree_Node_PT xrbtree_balance(XRBTree_Node_PT node_N) {
         *             X(R)      D
         */
         if (xrbtree_node_color_black(node_N->right->left) && xrbtree_node_color_red(node_N->right->right)) {
-            node_N = xrbtree_rotate_left(node_N);
+            node_N = xrbtree_rotate_left(tree, node_N);
         }
     }
 
@@ -298,14 +344,45 @@ XRBTree_Node_PT xrbtree_balance(XRBTree_Node_PT node_N) {
         xrbtree_flip_color(node_N);
     }
 
-    node_N->size = 1 + (node_N->left ? node_N->left->size : 0) + (node_N->right ? node_N->right->size : 0);
+    xrbtree_update_node(tree, node_N);
 
     return node_N;
 }
 
+/* the node returned is zeroed */
+static
+XRBTree_Node_PT xrbtree_alloc_node(XRBTree_PT tree) {
+    if (!tree->slab) {
+        tree->slab = xslab_new_allocator((int)sizeof(struct XRBTree_Node) + tree->aux_size, tree->allocator);
+        if (!tree->slab) {
+            return NULL;
+        }
+    }
+
+    {
+        XRBTree_Node_PT node = (XRBTree_Node_PT)xslab_alloc(tree->slab);
+#ifdef XRBTREE_NO_SIZE
+        if (node) {
+            ++tree->count;
+        }
+#endif
+        return node;
+    }
+}
+
+static
+void xrbtree_free_node(XRBTree_PT tree, XRBTree_Node_PT *pnode) {
+#ifdef XRBTREE_NO_SIZE
+    if (*pnode) {
+        --tree->count;
+    }
+#endif
+    xslab_freep(tree->slab, (void**)pnode);
+}
+
 static
-XRBTree_Node_PT xrbtree_new_node(void *key, void *value, bool color) {
-    XRBTree_Node_PT node = XMEM_CALLOC(1, sizeof(*node));
+XRBTree_Node_PT xrbtree_new_node(XRBTree_PT tree, void *key, void *value, bool color) {
+    XRBTree_Node_PT node = xrbtree_alloc_node(tree);
     if (!node) {
         return NULL;
     }
@@ -313,8 +390,8 @@ XRBTree_Node_PT xrbtree_new_node(void *key, void *value, bool color) {
     node->key = key;
     node->value = value;
 
-    node->size = 1;
-    node->color = color;
+    xrbtree_node_set_color(node, color);
+    xrbtree_update_node(tree, node);
 
     //node->parent = NULL;
     //node->left = NULL;
@@ -324,6 +401,10 @@ XRBTree_Node_PT xrbtree_new_node(void *key, void *value, bool color) {
 }
 
 XRBTree_PT xrbtree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    return xrbtree_new_allocator(cmp, cl, NULL);
+}
+
+XRBTree_PT xrbtree_new_allocator(int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     xassert(cmp);
     
     if (!cmp) {
@@ -331,34 +412,84 @@ XRBTree_PT xrbtree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
     }
 
     {
-        XRBTree_PT tree = XMEM_CALLOC(1, sizeof(*tree));
+        XRBTree_PT tree = XMEM_ALLOC_BY(allocator, sizeof(*tree));
         if (!tree) {
             return NULL;
         }
 
         tree->cmp = cmp;
         tree->cl = cl;
+        tree->allocator = allocator;
         //tree->root = NULL;
 
         return tree;
     }
 }
 
+bool xrbtree_set_augment(XRBTree_PT tree, int aux_size, void (*augment)(void *key, void *value, void *aux, void *left_aux, void *right_aux, void *cl), void *cl) {
+    xassert(tree);
+    xassert(!tree->root);
+    xassert(!tree->hashed);
+    xassert(0 < aux_size);
+    xassert(augment);
+
+    if (!tree || tree->root || tree->hashed || (aux_size <= 0) || !augment) {
+        return false;
+    }
+
+    tree->augment = augment;
+    tree->augment_cl = cl;
+    tree->aux_size = aux_size;
+
+    /* the nodes are bigger now */
+    xslab_free(&tree->slab);
+
+    return true;
+}
+
+/* the new tree uses the same summary as tree */
+static
+void xrbtree_copy_augment(XRBTree_PT ntree, XRBTree_PT tree) {
+    ntree->augment = tree->augment;
+    ntree->augment_cl = tree->augment_cl;
+    ntree->aux_size = tree->aux_size;
+}
+
+/* recompute the summaries of all the nodes from the bottom up */
+static
+void xrbtree_update_all(XRBTree_PT tree, XRBTree_Node_PT node) {
+    if (!tree->augment || !node) {
+        return;
+    }
+
+    xrbtree_update_all(tree, node->left);
+    xrbtree_update_all(tree, node->right);
+    xrbtree_update_node(tree, node);
+}
+
 static
 XRBTree_Node_PT xrbtree_copy_node(XRBTree_Node_PT node, XRBTree_Node_PT nparent, bool *false_found, void *cl) {
-    XRBTree_Node_PT nnode = XMEM_CALLOC(1, sizeof(*nnode));
+    XRBTree_PT ntree = (XRBTree_PT)cl;
+
+    XRBTree_Node_PT nnode = xrbtree_alloc_node(ntree);
     if (!nnode) {
         *false_found = true;
         return NULL;
     }
 
+    if (0 < ntree->aux_size) {
+        memcpy(xrbtree_node_aux(nnode), xrbtree_node_aux(node), ntree->aux_size);
+    }
+
     nnode->key = node->key;
     nnode->value = node->value;
 
+#ifndef XRBTREE_NO_SIZE
     nnode->size = node->size;
-    nnode->color = node->color;
+#endif
+    xrbtree_node_set_color(nnode, xrbtree_node_color(node));
 
-    nnode->parent = nparent;
+    xrbtree_node_set_parent(nnode, nparent);
     //nnode->left = NULL;
     //nnode->right = NULL;
 
@@ -408,12 +539,15 @@ XRBTree_PT xrbtree_copy(XRBTree_PT tree) {
     {
         bool false_found = false;
 
-        XRBTree_PT ntree = xrbtree_new(tree->cmp, tree->cl);
+        XRBTree_PT ntree = xrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
         if (!ntree) {
             return NULL;
         }
 
-        xrbtree_copy_break_if_false_impl(tree, tree->root, ntree, NULL, true, false, &false_found, xrbtree_copy_node, NULL);
+        ntree->hashed = tree->hashed;
+        xrbtree_copy_augment(ntree, tree);
+
+        xrbtree_copy_break_if_false_impl(tree, tree->root, ntree, NULL, true, false, &false_found, xrbtree_copy_node, (void*)ntree);
         if (false_found) {
             xrbtree_free(&ntree);
             return NULL;
@@ -429,16 +563,20 @@ static
 XRBTree_Node_PT xrbtree_deep_copy_node(XRBTree_Node_PT node, XRBTree_Node_PT nparent, bool *false_found, void *cl) {
     XRBTree_3Paras_PT paras = (XRBTree_3Paras_PT)cl;
 
-    XRBTree_Node_PT nnode = XMEM_CALLOC(1, sizeof(*nnode));
+    XRBTree_Node_PT nnode = xrbtree_alloc_node(paras->tree);
     if (!nnode) {
         *false_found = true;
         return NULL;
     }
 
+    if (0 < paras->tree->aux_size) {
+        memcpy(xrbtree_node_aux(nnode), xrbtree_node_aux(node), paras->tree->aux_size);
+    }
+
     nnode->key = xutils_deep_copy(node->key, *((int*)paras->para1));
     if (!nnode->key) {
         *false_found = true;
-        XMEM_FREE(nnode);
+        xrbtree_free_node(paras->tree, &nnode);
         return NULL;
     }
 
@@ -447,7 +585,7 @@ XRBTree_Node_PT xrbtree_deep_copy_node(XRBTree_Node_PT node, XRBTree_Node_PT npa
         if (node->value && !nnode->value) {
             *false_found = true;
             XMEM_FREE(nnode->key);
-            XMEM_FREE(nnode);
+            xrbtree_free_node(paras->tree, &nnode);
             return NULL;
         }
     }
@@ -455,10 +593,12 @@ XRBTree_Node_PT xrbtree_deep_copy_node(XRBTree_Node_PT node, XRBTree_Node_PT npa
         nnode->value = NULL;
     }
 
+#ifndef XRBTREE_NO_SIZE
     nnode->size = node->size;
-    nnode->color = node->color;
+#endif
+    xrbtree_node_set_color(nnode, xrbtree_node_color(node));
 
-    nnode->parent = nparent;
+    xrbtree_node_set_parent(nnode, nparent);
     //nnode->left = NULL;
     //nnode->right = NULL;
 
@@ -475,11 +615,14 @@ XRBTree_PT xrbtree_deep_copy(XRBTree_PT tree, int key_size, int value_size) {
     }
 
     {
-        XRBTree_PT ntree = xrbtree_new(tree->cmp, tree->cl);
+        XRBTree_PT ntree = xrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
         if (!ntree) {
             return NULL;
         }
 
+        ntree->hashed = tree->hashed;
+        xrbtree_copy_augment(ntree, tree);
+
         {
             XRBTree_3Paras_T paras = { ntree, (void*)&key_size, (void*)&value_size, NULL };
 
@@ -491,6 +634,9 @@ XRBTree_PT xrbtree_deep_copy(XRBTree_PT tree, int key_size, int value_size) {
             }
         }
 
+        /* the summaries may use the addresses of the keys or values */
+        xrbtree_update_all(ntree, ntree->root);
+
         xassert(xrbtree_size(tree) == xrbtree_size(ntree));
 
         return ntree;
@@ -501,14 +647,14 @@ static
 XRBTree_Node_PT xrbtree_put_repeat_impl(XRBTree_PT tree, XRBTree_Node_PT parent, XRBTree_Node_PT node, XRBTree_Node_PT new_node, void *key, bool unique) {
     /* reach the leaf node, return the new created new_node */
     if (!node) {
-        new_node->parent = parent;
+        xrbtree_node_set_parent(new_node, parent);
         return new_node;
     }
 
     {
-        int ret = tree->cmp(key, node->key, tree->cl);
+        int ret = xrbtree_cmp_node(tree, key, tree->hashed ? xrbtree_node_hash(new_node) : 0, node);
         if (unique && (ret == 0)) {
-            XMEM_FREE(new_node);
+            xrbtree_free_node(tree, &new_node);
             return node;
         }
 
@@ -521,11 +667,11 @@ XRBTree_Node_PT xrbtree_put_repeat_impl(XRBTree_PT tree, XRBTree_Node_PT parent,
         }
 
         /* make the tree balance again */
-        return xrbtree_balance(node);
+        return xrbtree_balance(tree, node);
     }
 }
 
-bool xrbtree_put_repeat(XRBTree_PT tree, void *key, void *value) {
+bool xrbtree_put_repeat_hash(XRBTree_PT tree, void *key, void *value, int hash, bool unique) {
     xassert(tree);
     xassert(key);
 
@@ -535,49 +681,40 @@ bool xrbtree_put_repeat(XRBTree_PT tree, void *key, void *value) {
 
     {
         /* always insert the new node with red color */
-        XRBTree_Node_PT nnode = xrbtree_new_node(key, value, xrbtree_color_red);
+        XRBTree_Node_PT nnode = xrbtree_new_node(tree, key, value, xrbtree_color_red);
         if (!nnode) {
             return false;
         }
 
-        tree->root = xrbtree_put_repeat_impl(tree, NULL, tree->root, nnode, key, false);
-        tree->root->color = xrbtree_color_black;
+        if (tree->hashed) {
+            xrbtree_node_set_hash(nnode, hash);
+        }
+
+        tree->root = xrbtree_put_repeat_impl(tree, NULL, tree->root, nnode, key, unique);
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 
     return true;
 }
 
-bool xrbtree_put_unique(XRBTree_PT tree, void *key, void *value) {
-    xassert(tree);
-    xassert(key);
-
-    if (!tree || !key) {
-        return false;
-    }
-
-    {
-        XRBTree_Node_PT nnode = xrbtree_new_node(key, value, xrbtree_color_red);
-        if (!nnode) {
-            return false;
-        }
-
-        tree->root = xrbtree_put_repeat_impl(tree, NULL, tree->root, nnode, key, true);
-        tree->root->color = xrbtree_color_black;
-    }
+bool xrbtree_put_repeat(XRBTree_PT tree, void *key, void *value) {
+    return xrbtree_put_repeat_hash(tree, key, value, 0, false);
+}
 
-    return true;
+bool xrbtree_put_unique(XRBTree_PT tree, void *key, void *value) {
+    return xrbtree_put_repeat_hash(tree, key, value, 0, true);
 }
 
 static 
 XRBTree_Node_PT xrbtree_put_replace_impl(XRBTree_PT tree, XRBTree_Node_PT parent, XRBTree_Node_PT node, XRBTree_Node_PT new_node, void *key, void *value, void **old_value, bool deep) {
     /* reach the leaf node, return the new created new_node */
     if (!node) {
-        new_node->parent = parent;
+        xrbtree_node_set_parent(new_node, parent);
         return new_node;
     }
 
     {
-        int ret = tree->cmp(key, node->key, tree->cl);
+        int ret = xrbtree_cmp_node(tree, key, tree->hashed ? xrbtree_node_hash(new_node) : 0, node);
         /* find the equal key, replace the value */
         if (ret == 0) {
             if (deep) {
@@ -588,7 +725,10 @@ XRBTree_Node_PT xrbtree_put_replace_impl(XRBTree_PT tree, XRBTree_Node_PT parent
             }
 
             node->value = value;
-            XMEM_FREE(new_node);
+            xrbtree_free_node(tree, &new_node);
+
+            /* the ancestors are balanced (updated) by the callers */
+            xrbtree_update_node(tree, node);
             return node;
         }
         /* find the right branch to insert the new node */
@@ -600,11 +740,11 @@ XRBTree_Node_PT xrbtree_put_replace_impl(XRBTree_PT tree, XRBTree_Node_PT parent
         }
 
         /* make the tree balance again */
-        return xrbtree_balance(node);
+        return xrbtree_balance(tree, node);
     }
 }
 
-bool xrbtree_put_replace(XRBTree_PT tree, void *key, void *value, void **old_value) {
+bool xrbtree_put_replace_hash(XRBTree_PT tree, void *key, void *value, int hash, void **old_value, bool deep) {
     xassert(tree);
     xassert(key);
 
@@ -613,37 +753,28 @@ bool xrbtree_put_replace(XRBTree_PT tree, void *key, void *value, void **old_val
     }
 
     {
-        XRBTree_Node_PT nnode = xrbtree_new_node(key, value, xrbtree_color_red);
+        XRBTree_Node_PT nnode = xrbtree_new_node(tree, key, value, xrbtree_color_red);
         if (!nnode) {
             return false;
         }
 
-        tree->root = xrbtree_put_replace_impl(tree, NULL, tree->root, nnode, key, value, old_value, false);
-        tree->root->color = xrbtree_color_black;
+        if (tree->hashed) {
+            xrbtree_node_set_hash(nnode, hash);
+        }
+
+        tree->root = xrbtree_put_replace_impl(tree, NULL, tree->root, nnode, key, value, old_value, deep);
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 
     return true;
 }
 
-bool xrbtree_put_deep_replace(XRBTree_PT tree, void *key, void *value) {
-    xassert(tree);
-    xassert(key);
-
-    if (!tree || !key) {
-        return false;
-    }
-
-    {
-        XRBTree_Node_PT nnode = xrbtree_new_node(key, value, xrbtree_color_red);
-        if (!nnode) {
-            return false;
-        }
-
-        tree->root = xrbtree_put_replace_impl(tree, NULL, tree->root, nnode, key, value, NULL, true);
-        tree->root->color = xrbtree_color_black;
-    }
+bool xrbtree_put_replace(XRBTree_PT tree, void *key, void *value, void **old_value) {
+    return xrbtree_put_replace_hash(tree, key, value, 0, old_value, false);
+}
 
-    return true;
+bool xrbtree_put_deep_replace(XRBTree_PT tree, void *key, void *value) {
+    return xrbtree_put_replace_hash(tree, key, value, 0, NULL, true);
 }
 
 void* xrbtree_min(XRBTree_PT tree) {
@@ -722,6 +853,7 @@ void* xrbtree_ceiling(XRBTree_PT tree, void *key) {
     return ceiling ? ceiling->key : NULL;
 }
 
+#ifndef XRBTREE_NO_SIZE
 static
 XRBTree_Node_PT xrbtree_select_impl(XRBTree_PT tree, XRBTree_Node_PT node, int k) {
     while (node) {
@@ -768,6 +900,7 @@ void xrbtree_index_replace_impl(XRBTree_PT tree, int k, void *value, void **old_
     }
     node->value = value;
 
+    xrbtree_update_to_root(tree, node);
     return;
 }
 
@@ -829,25 +962,26 @@ int xrbtree_rank_impl(XRBTree_PT tree, XRBTree_Node_PT node, void *key) {
 int xrbtree_rank(XRBTree_PT tree, void *key) {
     return xrbtree_rank_impl(tree, (tree ? tree->root : NULL), key);
 }
+#endif
 
 void* xrbtree_get(XRBTree_PT tree, void *key) {
     XRBTree_Node_PT node = xrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
     return node ? node->value : NULL;
 }
 
-XSList_PT xrbtree_get_all(XRBTree_PT tree, void *key) {
+XSList_PT xrbtree_get_all_hash(XRBTree_PT tree, void *key, int hash) {
     XSList_PT list = xslist_new();
     if (!list) {
         return NULL;
     }
 
     {
-        XRBTree_Node_PT node = xrbtree_get_impl(tree, tree->root, key);
+        XRBTree_Node_PT node = xrbtree_get_hash_impl(tree, tree->root, key, hash);
         if (node) {
             /* the equal keys may be saved in pre nodes */
             XRBTree_Node_PT tnode = xrbtree_prev_node(tree, node);
             while (tnode) {
-                if (tree->cmp(node->key, tnode->key, tree->cl) == 0) {
+                if (xrbtree_cmp_node(tree, key, hash, tnode) == 0) {
                     if (!xslist_push_back_repeat(list, tnode->value)) {
                         xslist_free(&list);
                         return NULL;
@@ -857,7 +991,7 @@ XSList_PT xrbtree_get_all(XRBTree_PT tree, void *key) {
             }
         }
 
-        while (node && (tree->cmp(node->key, key, tree->cl) <= 0)) {
+        while (node && (0 <= xrbtree_cmp_node(tree, key, hash, node))) {
             if (!xslist_push_back_repeat(list, node->value)) {
                 xslist_free(&list);
                 return NULL;
@@ -869,6 +1003,10 @@ XSList_PT xrbtree_get_all(XRBTree_PT tree, void *key) {
     return list;
 }
 
+XSList_PT xrbtree_get_all(XRBTree_PT tree, void *key) {
+    return xrbtree_get_all_hash(tree, key, 0);
+}
+
 bool xrbtree_find(XRBTree_PT tree, void *key) {
     return xrbtree_get_impl(tree, (tree ? tree->root : NULL), key) ? true : false;
 }
@@ -880,6 +1018,8 @@ bool xrbtree_find_replace(XRBTree_PT tree, void *key, void *value, void **old_va
             *old_value = node->value;
         }
         node->value = value;
+
+        xrbtree_update_to_root(tree, node);
         return true;
     }
 
@@ -891,6 +1031,8 @@ bool xrbtree_find_deep_replace(XRBTree_PT tree, void *key, void *value) {
     if (node) {
         XMEM_FREE(node->value);
         node->value = value;
+
+        xrbtree_update_to_root(tree, node);
         return true;
     }
 
@@ -898,7 +1040,7 @@ bool xrbtree_find_deep_replace(XRBTree_PT tree, void *key, void *value) {
 }
 
 static 
-void xrbtree_switch_key_value(XRBTree_Node_PT node1, XRBTree_Node_PT node2) {
+void xrbtree_switch_key_value(XRBTree_PT tree, XRBTree_Node_PT node1, XRBTree_Node_PT node2) {
     void *key = node1->key;
     void *value = node1->value;
 
@@ -907,19 +1049,28 @@ void xrbtree_switch_key_value(XRBTree_Node_PT node1, XRBTree_Node_PT node2) {
 
     node2->key = key;
     node2->value = value;
+
+    if (tree->hashed) {
+        int hash = xrbtree_node_hash(node1);
+        xrbtree_node_set_hash(node1, xrbtree_node_hash(node2));
+        xrbtree_node_set_hash(node2, hash);
+    }
 }
 
 void xrbtree_replace_key(XRBTree_PT tree, void *old_key, void *new_key) {
     XRBTree_Node_PT node = xrbtree_get_impl(tree, (tree ? tree->root : NULL), old_key);
     if (node) {
         node->key = new_key;
+        xrbtree_update_to_root(tree, node);
 
         {
             bool balanced = false;
 
             XRBTree_Node_PT prev = xrbtree_prev_node(tree, node);
             while (prev && (tree->cmp(node->key, prev->key, tree->cl) < 0)) {
-                xrbtree_switch_key_value(prev, node);
+                xrbtree_switch_key_value(tree, prev, node);
+                xrbtree_update_to_root(tree, node);
+                xrbtree_update_to_root(tree, prev);
                 balanced = true;
 
                 node = prev;
@@ -929,7 +1080,9 @@ void xrbtree_replace_key(XRBTree_PT tree, void *old_key, void *new_key) {
             if (!balanced) {
                 XRBTree_Node_PT next = xrbtree_next_node(tree, node);
                 while (next && (tree->cmp(next->key, node->key, tree->cl) < 0)) {
-                    xrbtree_switch_key_value(next, node);
+                    xrbtree_switch_key_value(tree, next, node);
+                    xrbtree_update_to_root(tree, node);
+                    xrbtree_update_to_root(tree, next);
 
                     node = next;
                     next = xrbtree_next_node(tree, node);
@@ -1005,28 +1158,42 @@ void xrbtree_free_impl(XRBTree_PT tree, XRBTree_Node_PT node, bool deep, bool (*
     else if (apply) {
         apply(node->key, &node->value, cl);
     }
-    XMEM_FREE(node);
+    xrbtree_free_node(tree, &node);
 }
 
-void xrbtree_clear(XRBTree_PT tree) {
-    xrbtree_free_impl(tree, (tree ? tree->root : NULL), false, NULL, NULL);
-    if (tree) {
-        tree->root = NULL;
+/* the nodes are walked only when their keys or values need to be handled, or the slab is shared with others,
+ * else they are all released at once with the slab
+ */
+static
+void xrbtree_clear_impl(XRBTree_PT tree, bool deep, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!tree) {
+        return;
+    }
+
+    if (deep || apply || xslab_is_shared(tree->slab)) {
+        xrbtree_free_impl(tree, tree->root, deep, apply, cl);
     }
+
+    if (tree->slab && !xslab_is_shared(tree->slab)) {
+        xslab_clear(tree->slab);
+    }
+
+    tree->root = NULL;
+#ifdef XRBTREE_NO_SIZE
+    tree->count = 0;
+#endif
+}
+
+void xrbtree_clear(XRBTree_PT tree) {
+    xrbtree_clear_impl(tree, false, NULL, NULL);
 }
 
 void xrbtree_clear_apply(XRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    xrbtree_free_impl(tree, (tree ? tree->root : NULL), false, apply, cl);
-    if (tree) {
-        tree->root = NULL;
-    }
+    xrbtree_clear_impl(tree, false, apply, cl);
 }
 
 void xrbtree_deep_clear(XRBTree_PT tree) {
-    xrbtree_free_impl(tree, (tree ? tree->root : NULL), true, NULL, NULL);
-    if (tree) {
-        tree->root = NULL;
-    }
+    xrbtree_clear_impl(tree, true, NULL, NULL);
 }
 
 void xrbtree_free(XRBTree_PT *ptree) {
@@ -1034,8 +1201,9 @@ void xrbtree_free(XRBTree_PT *ptree) {
         return;
     }
 
-    xrbtree_free_impl(*ptree, (*ptree)->root, false, NULL, NULL);
-    XMEM_FREE(*ptree);
+    xrbtree_clear_impl(*ptree, false, NULL, NULL);
+    xslab_free(&(*ptree)->slab);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
 }
 
 void xrbtree_free_apply(XRBTree_PT *ptree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
@@ -1043,8 +1211,9 @@ void xrbtree_free_apply(XRBTree_PT *ptree, bool (*apply)(void *key, void **value
         return;
     }
 
-    xrbtree_free_impl(*ptree, (*ptree)->root, false, apply, cl);
-    XMEM_FREE(*ptree);
+    xrbtree_clear_impl(*ptree, false, apply, cl);
+    xslab_free(&(*ptree)->slab);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
 }
 
 void xrbtree_deep_free(XRBTree_PT *ptree) {
@@ -1052,8 +1221,88 @@ void xrbtree_deep_free(XRBTree_PT *ptree) {
         return;
     }
 
-    xrbtree_free_impl(*ptree, (*ptree)->root, true, NULL, NULL);
-    XMEM_FREE(*ptree);
+    xrbtree_clear_impl(*ptree, true, NULL, NULL);
+    xslab_free(&(*ptree)->slab);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
+}
+
+/* build the balanced tree with keys[lo, hi], only the nodes at the deepest level (red_depth) are red */
+static
+XRBTree_Node_PT xrbtree_build_sorted_impl(XRBTree_PT tree, XRBTree_Node_PT parent, void **keys, void **values, int lo, int hi, int depth, int red_depth, bool *false_found) {
+    if (hi < lo) {
+        return NULL;
+    }
+
+    {
+        int mid = lo + (hi - lo) / 2;
+
+        XRBTree_Node_PT node = xrbtree_alloc_node(tree);
+        if (!node) {
+            *false_found = true;
+            return NULL;
+        }
+
+        xrbtree_node_set_parent(node, parent);
+        node->key = keys[mid];
+        node->value = values ? values[mid] : NULL;
+        xrbtree_node_set_color(node, ((0 < depth) && (depth == red_depth)) ? xrbtree_color_red : xrbtree_color_black);
+
+        node->left = xrbtree_build_sorted_impl(tree, node, keys, values, lo, mid - 1, depth + 1, red_depth, false_found);
+        if (!*false_found) {
+            node->right = xrbtree_build_sorted_impl(tree, node, keys, values, mid + 1, hi, depth + 1, red_depth, false_found);
+        }
+
+        if (*false_found) {
+            xrbtree_free_impl(tree, node, false, NULL, NULL);
+            return NULL;
+        }
+
+        xrbtree_update_node(tree, node);
+        return node;
+    }
+}
+
+bool xrbtree_build_sorted(XRBTree_PT tree, void **keys, void **values, int count) {
+    xassert(tree);
+    xassert(!tree->root);
+    xassert(!tree->hashed);
+    xassert(keys || (count == 0));
+    xassert(0 <= count);
+
+    if (!tree || tree->root || tree->hashed || (!keys && (0 < count)) || (count < 0)) {
+        return false;
+    }
+
+    for (int i = 1; i < count; ++i) {
+        if (0 < tree->cmp(keys[i - 1], keys[i], tree->cl)) {
+            return false;
+        }
+    }
+
+    {
+        /* the height of the balanced tree is lg(count) */
+        int red_depth = 0;
+        for (int n = count; 1 < n; n /= 2) {
+            ++red_depth;
+        }
+
+        {
+            bool false_found = false;
+            tree->root = xrbtree_build_sorted_impl(tree, NULL, keys, values, 0, count - 1, 0, red_depth, &false_found);
+            return !false_found;
+        }
+    }
+}
+
+bool xrbtree_build_sorted_parray(XRBTree_PT tree, XPArray_PT keys, XPArray_PT values) {
+    xassert(keys);
+    xassert(!values || (xparray_size(keys) <= xparray_size(values)));
+
+    if (!keys || (values && (xparray_size(values) < xparray_size(keys)))) {
+        return false;
+    }
+
+    return xrbtree_build_sorted(tree, keys->datas, (values ? values->datas : NULL), keys->size);
 }
 
 /* move one key from node_N's right branch to left branch :
@@ -1065,7 +1314,7 @@ void xrbtree_deep_free(XRBTree_PT *ptree) {
 *  D   F  P  S  U       D  F  P S   U
 */
 static
-XRBTree_Node_PT xrbtree_move_red_left(XRBTree_Node_PT node_N) {
+XRBTree_Node_PT xrbtree_move_red_left(XRBTree_PT tree, XRBTree_Node_PT node_N) {
     if (node_N->right && (xrbtree_node_color_red(node_N->right->left) || xrbtree_node_color_red(node_N->right->right))) {
         /*
         *          |                  |                     |                  |
@@ -1091,7 +1340,7 @@ XRBTree_Node_PT xrbtree_move_red_left(XRBTree_Node_PT node_N) {
             *          / \                       / \
             *         P   S                     S   U
             */
-            node_N->right = xrbtree_rotate_right(node_N->right);
+            node_N->right = xrbtree_rotate_right(tree, node_N->right);
         }
 
         if (xrbtree_node_color_red(node_N->right->right)) {
@@ -1105,7 +1354,7 @@ XRBTree_Node_PT xrbtree_move_red_left(XRBTree_Node_PT node_N) {
             *               / \         /  \
             *              S   U       D    F
             */
-            node_N = xrbtree_rotate_left(node_N);
+            node_N = xrbtree_rotate_left(tree, node_N);
         }
 
         /*
@@ -1134,7 +1383,7 @@ XRBTree_Node_PT xrbtree_move_red_left(XRBTree_Node_PT node_N) {
 *  D  H  M   Q   U       D   H M  Q  U
 */
 static
-XRBTree_Node_PT xrbtree_move_red_right(XRBTree_Node_PT node_N) {
+XRBTree_Node_PT xrbtree_move_red_right(XRBTree_PT tree, XRBTree_Node_PT node_N) {
     if (node_N->left && (xrbtree_node_color_red(node_N->left->right) || xrbtree_node_color_red(node_N->left->left))) {
         /*
         *          |                   |                         |                   |
@@ -1160,7 +1409,7 @@ XRBTree_Node_PT xrbtree_move_red_right(XRBTree_Node_PT node_N) {
             *        / \            / \
             *       H   M          D   H
             */
-            node_N->left = xrbtree_rotate_left(node_N->left);
+            node_N->left = xrbtree_rotate_left(tree, node_N->left);
         }
 
         if (xrbtree_node_color_red(node_N->left->left)) {
@@ -1174,7 +1423,7 @@ XRBTree_Node_PT xrbtree_move_red_right(XRBTree_Node_PT node_N) {
             *   / \                             / \
             *  D   H                           Q   U
             */
-            node_N = xrbtree_rotate_right(node_N);
+            node_N = xrbtree_rotate_right(tree, node_N);
         }
 
         /*
@@ -1200,10 +1449,10 @@ XRBTree_Node_PT xrbtree_remove_min_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
     if (!node_N->left) {
         XRBTree_Node_PT right = node_N->right;
         if (right) {
-            right->parent = node_N->parent;
+            xrbtree_node_set_parent(right, xrbtree_node_parent(node_N));
             /* keep the black node numbers not changed */
             if (xrbtree_node_color_black(node_N)) {
-                right->color = node_N->color;
+                xrbtree_node_set_color(right, xrbtree_node_color(node_N));
             }
         }
 
@@ -1219,7 +1468,7 @@ XRBTree_Node_PT xrbtree_remove_min_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
                 *old_value = node_N->value;
             }
         }
-        XMEM_FREE(node_N);
+        xrbtree_free_node(tree, &node_N);
 
         return right;
     }
@@ -1242,7 +1491,7 @@ XRBTree_Node_PT xrbtree_remove_min_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
         *                         D(B)
         */
         if (xrbtree_node_color_red(node_N->right)) {
-            node_N = xrbtree_rotate_left(node_N);
+            node_N = xrbtree_rotate_left(tree, node_N);
         }
         else {
             /* node->right has 2 or 3 keys, move one to left
@@ -1256,7 +1505,7 @@ XRBTree_Node_PT xrbtree_remove_min_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
             *          P   S             D(B)  F
             */
             if (node_N->right && (xrbtree_node_color_red(node_N->right->left) || xrbtree_node_color_red(node_N->right->right))) {
-                node_N = xrbtree_move_red_left(node_N);
+                node_N = xrbtree_move_red_left(tree, node_N);
             }
             else {
                 /* node->right is black
@@ -1276,7 +1525,7 @@ XRBTree_Node_PT xrbtree_remove_min_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
     /* node->left has 2 or 3 keys now */
     node_N->left = xrbtree_remove_min_impl(tree, node_N->left, old_key, old_value, deep);
 
-    return xrbtree_balance(node_N);
+    return xrbtree_balance(tree, node_N);
 }
 
 void xrbtree_remove_min(XRBTree_PT tree) {
@@ -1287,12 +1536,12 @@ void xrbtree_remove_min(XRBTree_PT tree) {
     }
 
     if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xrbtree_color_red;
+        xrbtree_node_set_color(tree->root, xrbtree_color_red);
     }
 
     tree->root = xrbtree_remove_min_impl(tree, tree->root, NULL, NULL, false);
     if (tree->root) {
-        tree->root->color = xrbtree_color_black;
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 }
 
@@ -1304,12 +1553,12 @@ void xrbtree_remove_save_min(XRBTree_PT tree, void **key, void **value) {
     }
 
     if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xrbtree_color_red;
+        xrbtree_node_set_color(tree->root, xrbtree_color_red);
     }
 
     tree->root = xrbtree_remove_min_impl(tree, tree->root, key, value, false);
     if (tree->root) {
-        tree->root->color = xrbtree_color_black;
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 }
 
@@ -1321,12 +1570,12 @@ void xrbtree_deep_remove_min(XRBTree_PT tree) {
     }
 
     if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xrbtree_color_red;
+        xrbtree_node_set_color(tree->root, xrbtree_color_red);
     }
 
     tree->root = xrbtree_remove_min_impl(tree, tree->root, NULL, NULL, true);
     if (tree->root) {
-        tree->root->color = xrbtree_color_black;
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 }
 
@@ -1336,10 +1585,10 @@ XRBTree_Node_PT xrbtree_remove_max_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
     if (!node_N->right) {
         XRBTree_Node_PT left = node_N->left;
         if (left) {
-            left->parent = node_N->parent;
+            xrbtree_node_set_parent(left, xrbtree_node_parent(node_N));
             /* keep the black node numbers not changed */
             if (xrbtree_node_color_black(node_N)) {
-                left->color = node_N->color;
+                xrbtree_node_set_color(left, xrbtree_node_color(node_N));
             }
         }
 
@@ -1355,7 +1604,7 @@ XRBTree_Node_PT xrbtree_remove_max_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
                 *old_value = node_N->value;
             }
         }
-        XMEM_FREE(node_N);
+        xrbtree_free_node(tree, &node_N);
 
         return left;
     }
@@ -1378,7 +1627,7 @@ XRBTree_Node_PT xrbtree_remove_max_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
         *                                            U(B)
         */
         if (xrbtree_node_color_red(node_N->left)) {
-            node_N = xrbtree_rotate_right(node_N);
+            node_N = xrbtree_rotate_right(tree, node_N);
         }
         else {
             /* node->left has 2 or 3 keys, move one to right
@@ -1392,7 +1641,7 @@ XRBTree_Node_PT xrbtree_remove_max_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
             *      D   F                                 U(B)
             */
             if (node_N->left && (xrbtree_node_color_red(node_N->left->left) || xrbtree_node_color_red(node_N->left->right))) {
-                node_N = xrbtree_move_red_right(node_N);
+                node_N = xrbtree_move_red_right(tree, node_N);
             }
             else {
                 /* node->left is black
@@ -1413,7 +1662,7 @@ XRBTree_Node_PT xrbtree_remove_max_impl(XRBTree_PT tree, XRBTree_Node_PT node_N,
     /* node->right has 2 or 3 keys now */
     node_N->right = xrbtree_remove_max_impl(tree, node_N->right, old_key, old_value, deep);
 
-    return xrbtree_balance(node_N);
+    return xrbtree_balance(tree, node_N);
 }
 
 void xrbtree_remove_max(XRBTree_PT tree) {
@@ -1424,12 +1673,12 @@ void xrbtree_remove_max(XRBTree_PT tree) {
     }
 
     if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xrbtree_color_red;
+        xrbtree_node_set_color(tree->root, xrbtree_color_red);
     }
 
     tree->root = xrbtree_remove_max_impl(tree, tree->root, NULL, NULL, false);
     if (tree->root) {
-        tree->root->color = xrbtree_color_black;
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 }
 
@@ -1441,12 +1690,12 @@ void xrbtree_remove_save_max(XRBTree_PT tree, void **key, void **value) {
     }
 
     if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xrbtree_color_red;
+        xrbtree_node_set_color(tree->root, xrbtree_color_red);
     }
 
     tree->root = xrbtree_remove_max_impl(tree, tree->root, key, value, false);
     if (tree->root) {
-        tree->root->color = xrbtree_color_black;
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 }
 
@@ -1458,33 +1707,33 @@ void xrbtree_deep_remove_max(XRBTree_PT tree) {
     }
 
     if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xrbtree_color_red;
+        xrbtree_node_set_color(tree->root, xrbtree_color_red);
     }
 
     tree->root = xrbtree_remove_max_impl(tree, tree->root, NULL, NULL, true);
     if (tree->root) {
-        tree->root->color = xrbtree_color_black;
+        xrbtree_node_set_color(tree->root, xrbtree_color_black);
     }
 }
 
 static
-XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, void *key, void **old_value, bool deep) {
+XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, void *key, int hash, void **old_value, bool deep) {
     /* can't find the node to remove */
     if (!node_N) {
         return NULL;
     }
 
     {
-        int ret = tree->cmp(key, node_N->key, tree->cl);
+        int ret = xrbtree_cmp_node(tree, key, hash, node_N);
         if (ret == 0) {
             /* no left or right branch */
             if (!node_N->left || !node_N->right) {
                 XRBTree_Node_PT ret_node = node_N->left ? node_N->left : node_N->right;
                 if (ret_node) {
-                    ret_node->parent = node_N->parent;
+                    xrbtree_node_set_parent(ret_node, xrbtree_node_parent(node_N));
                     /* keep the black node numbers not changed */
                     if (xrbtree_node_color_black(node_N)) {
-                        ret_node->color = node_N->color;
+                        xrbtree_node_set_color(ret_node, xrbtree_node_color(node_N));
                     }
                 }
 
@@ -1496,7 +1745,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                     *old_value = node_N->value;
                 }
 
-                XMEM_FREE(node_N);
+                xrbtree_free_node(tree, &node_N);
                 return ret_node;
             }
 
@@ -1524,7 +1773,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                     *    A    E                          E     T(B)
                     */
                     if (xrbtree_node_color_red(node_N->left)) {
-                        node_N = xrbtree_rotate_right(node_N);
+                        node_N = xrbtree_rotate_right(tree, node_N);
                     }
                     else {
                         /* node_N->left has 2 or 3 keys, move one to right
@@ -1538,7 +1787,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                         *      D   F
                         */
                         if (node_N->left && (xrbtree_node_color_red(node_N->left->left) || xrbtree_node_color_red(node_N->left->right))) {
-                            node_N = xrbtree_move_red_right(node_N);
+                            node_N = xrbtree_move_red_right(tree, node_N);
                         }
                         else {
                             /* node_N->left is black
@@ -1556,9 +1805,11 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
 
                 /* node->right has 2 or 3 keys now */
 
-                if (0 == tree->cmp(key, node_N->key, tree->cl)) {
+                if (0 == xrbtree_cmp_node(tree, key, hash, node_N)) {
                     /* delete the min key of node_N->right */
                     void *min_key = NULL, *min_value = NULL;
+                    XRBTree_Node_PT min_node = xrbtree_min_impl(tree, node_N->right);
+                    int min_hash = tree->hashed ? xrbtree_node_hash(min_node) : 0;
                     node_N->right = xrbtree_remove_min_impl(tree, node_N->right, &min_key, &min_value, false);
 
                     if (deep) {
@@ -1571,9 +1822,12 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
 
                     node_N->key = min_key;
                     node_N->value = min_value;
+                    if (tree->hashed) {
+                        xrbtree_node_set_hash(node_N, min_hash);
+                    }
                 }
                 else {
-                    node_N->right = xrbtree_remove_impl(tree, node_N->right, key, old_value, deep);
+                    node_N->right = xrbtree_remove_impl(tree, node_N->right, key, hash, old_value, deep);
                 }
             }
         }
@@ -1599,7 +1853,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                 *             S    U        E(B)   S
                 */
                 if (xrbtree_node_color_red(node_N->right)) {
-                    node_N = xrbtree_rotate_left(node_N);
+                    node_N = xrbtree_rotate_left(tree, node_N);
                 }
                 else {
                     /* node_N->right has 2 or 3 keys, move one to left
@@ -1613,7 +1867,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                     *          P   S
                     */
                     if (node_N->right && (xrbtree_node_color_red(node_N->right->left) || xrbtree_node_color_red(node_N->right->right))) {
-                        node_N = xrbtree_move_red_left(node_N);
+                        node_N = xrbtree_move_red_left(tree, node_N);
                     }
                     else {
                         /* node_N->right is black
@@ -1629,7 +1883,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
             }
 
             /* node_N->left has 2 or 3 keys now */
-            node_N->left = xrbtree_remove_impl(tree, node_N->left, key, old_value, deep);
+            node_N->left = xrbtree_remove_impl(tree, node_N->left, key, hash, old_value, deep);
         }
         else {
             /* key should be in right branch, but right branch is empty */
@@ -1653,7 +1907,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                 *    A    E                          E     T(B)
                 */
                 if (xrbtree_node_color_red(node_N->left)) {
-                    node_N = xrbtree_rotate_right(node_N);
+                    node_N = xrbtree_rotate_right(tree, node_N);
                 }
                 else {
                     /* node_N->left has 2 or 3 keys, move one to right
@@ -1667,7 +1921,7 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
                     *      D   F
                     */
                     if (node_N->left && (xrbtree_node_color_red(node_N->left->left) || xrbtree_node_color_red(node_N->left->right))) {
-                        node_N = xrbtree_move_red_right(node_N);
+                        node_N = xrbtree_move_red_right(tree, node_N);
                     }
                     else {
                         /* node_N->left is black
@@ -1684,44 +1938,52 @@ XRBTree_Node_PT xrbtree_remove_impl(XRBTree_PT tree, XRBTree_Node_PT node_N, voi
             }
 
             /* node->right has 2 or 3 keys now */
-            node_N->right = xrbtree_remove_impl(tree, node_N->right, key, old_value, deep);
+            node_N->right = xrbtree_remove_impl(tree, node_N->right, key, hash, old_value, deep);
         }
 
-        return xrbtree_balance(node_N);
+        return xrbtree_balance(tree, node_N);
     }
 }
 
-int xrbtree_remove(XRBTree_PT tree, void *key) {
+int xrbtree_remove_hash(XRBTree_PT tree, void *key, int hash, bool deep) {
     if (!tree || !key || !tree->root) {
         return 0;
     }
 
     {
-        int total = tree->root->size;
+        int total = xrbtree_size(tree);
 
         if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xrbtree_color_red;
+            xrbtree_node_set_color(tree->root, xrbtree_color_red);
         }
 
-        tree->root = xrbtree_remove_impl(tree, tree->root, key, NULL, false);
+        tree->root = xrbtree_remove_impl(tree, tree->root, key, hash, NULL, deep);
         if (tree->root) {
-            tree->root->color = xrbtree_color_black;
+            xrbtree_node_set_color(tree->root, xrbtree_color_black);
         }
 
         return (total - xrbtree_size(tree));
     }
 }
 
-int xrbtree_remove_all(XRBTree_PT tree, void *key) {
+int xrbtree_remove_all_hash(XRBTree_PT tree, void *key, int hash, bool deep) {
     int count = 0;
 
-    while (0 < xrbtree_remove(tree, key)) {
+    while (0 < xrbtree_remove_hash(tree, key, hash, deep)) {
         ++count;
     }
 
     return count;
 }
 
+int xrbtree_remove(XRBTree_PT tree, void *key) {
+    return xrbtree_remove_hash(tree, key, 0, false);
+}
+
+int xrbtree_remove_all(XRBTree_PT tree, void *key) {
+    return xrbtree_remove_all_hash(tree, key, 0, false);
+}
+
 int xrbtree_remove_save(XRBTree_PT tree, void *key, void **value) {
     xassert(tree);
     xassert(key);
@@ -1731,15 +1993,15 @@ int xrbtree_remove_save(XRBTree_PT tree, void *key, void **value) {
     }
 
     {
-        int total = tree->root->size;
+        int total = xrbtree_size(tree);
 
         if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xrbtree_color_red;
+            xrbtree_node_set_color(tree->root, xrbtree_color_red);
         }
 
-        tree->root = xrbtree_remove_impl(tree, tree->root, key, value, false);
+        tree->root = xrbtree_remove_impl(tree, tree->root, key, 0, value, false);
         if (tree->root) {
-            tree->root->color = xrbtree_color_black;
+            xrbtree_node_set_color(tree->root, xrbtree_color_black);
         }
 
         return (total - xrbtree_size(tree));
@@ -1750,79 +2012,372 @@ int xrbtree_deep_remove(XRBTree_PT tree, void *key) {
     xassert(tree);
     xassert(key);
 
-    if (!tree || !key || !tree->root) {
-        return 0;
-    }
+    return xrbtree_remove_hash(tree, key, 0, true);
+}
 
-    {
-        int total = tree->root->size;
+int xrbtree_deep_remove_all(XRBTree_PT tree, void *key) {
+    return xrbtree_remove_all_hash(tree, key, 0, true);
+}
 
-        if (xrbtree_node_color_black(tree->root->left) && xrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xrbtree_color_red;
-        }
+#ifndef XRBTREE_NO_SIZE
+/* the number of black nodes from node to its leaves */
+static
+int xrbtree_black_height(XRBTree_Node_PT node) {
+    int height = 0;
 
-        tree->root = xrbtree_remove_impl(tree, tree->root, key, NULL, true);
-        if (tree->root) {
-            tree->root->color = xrbtree_color_black;
+    for (; node; node = node->left) {
+        if (xrbtree_node_color_black(node)) {
+            ++height;
         }
-
-        return (total - xrbtree_size(tree));
     }
+
+    return height;
 }
 
-int xrbtree_deep_remove_all(XRBTree_PT tree, void *key) {
-    int count = 0;
+/* fix the "red-red" nodes from the new red node up to the root, returns the new root */
+static
+XRBTree_Node_PT xrbtree_join_fixup(XRBTree_PT tree, XRBTree_Node_PT root, XRBTree_Node_PT node) {
+    while (xrbtree_node_color_red(xrbtree_node_parent(node))) {
+        XRBTree_Node_PT parent = xrbtree_node_parent(node);
+        XRBTree_Node_PT grand = xrbtree_node_parent(parent);  /* parent is red, so it's not the root */
+        XRBTree_Node_PT uncle = (parent == grand->left) ? grand->right : grand->left;
+
+        if (xrbtree_node_color_red(uncle)) {
+            xrbtree_node_set_color(parent, xrbtree_color_black);
+            xrbtree_node_set_color(uncle, xrbtree_color_black);
+            xrbtree_node_set_color(grand, xrbtree_color_red);
+            node = grand;
+            continue;
+        }
+
+        /* rotations keep the black color on the top node, and make the other one red */
+        if (parent == grand->left) {
+            if (node == parent->right) {
+                xrbtree_rotate_left(tree, parent);
+            }
+            node = xrbtree_rotate_right(tree, grand);
+        }
+        else {
+            if (node == parent->left) {
+                xrbtree_rotate_right(tree, parent);
+            }
+            node = xrbtree_rotate_left(tree, grand);
+        }
 
-    while (0 < xrbtree_deep_remove(tree, key)) {
-        ++count;
+        if (!xrbtree_node_parent(node)) {
+            root = node;
+        }
+        break;
     }
 
-    return count;
+    return root;
 }
 
-static 
-int xrbtree_map_preorder_impl(XRBTree_PT tree, XRBTree_Node_PT node, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    if (!node) {
-        return 0;
-    }
-
-    {
-        int count = 0;
+/* join the trees "left", "mid" and "right" (all keys of left <= mid->key <= all keys of right) :
+*    the roots of left and right must be black, left_height and right_height are their black heights
+*    *height saves the black height of the joined tree
+*    O(|left_height - right_height| + 1)
+*/
+static
+XRBTree_Node_PT xrbtree_join_impl(XRBTree_PT tree, XRBTree_Node_PT left, int left_height, XRBTree_Node_PT mid, XRBTree_Node_PT right, int right_height, int *height) {
+    if (left_height == right_height) {
+        mid->left = left;
+        mid->right = right;
+        xrbtree_node_set_parent(mid, NULL);
+        xrbtree_node_set_color(mid, xrbtree_color_black);
 
-        if (apply(node->key, &(node->value), cl)) {
-            count++;
+        if (left) {
+            xrbtree_node_set_parent(left, mid);
+        }
+        if (right) {
+            xrbtree_node_set_parent(right, mid);
         }
 
-        count += xrbtree_map_preorder_impl(tree, node->left, apply, cl);
-        count += xrbtree_map_preorder_impl(tree, node->right, apply, cl);
+        xrbtree_update_node(tree, mid);
 
-        return count;
+        *height = left_height + 1;
+        return mid;
     }
-}
-
-int xrbtree_map_preorder(XRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    xassert(apply);
 
-    if (!apply) {
-        return 0;
-    }
+    {
+        /* walk down the right side of the higher left tree (or the left side of the higher right tree) */
+        bool higher_right = (left_height < right_height);
 
-    return xrbtree_map_preorder_impl(tree, (tree ? tree->root : NULL), apply, cl);
-}
+        XRBTree_Node_PT root = higher_right ? right : left;
+        XRBTree_Node_PT parent = NULL;
+        XRBTree_Node_PT node = root;
 
-static 
-int xrbtree_map_inorder_impl(XRBTree_PT tree, XRBTree_Node_PT node, bool (*apply)(void *key, void **value, void *cl), void *cl) {
-    if (!node) {
-        return 0;
-    }
+        int node_height = higher_right ? right_height : left_height;
+        int lower_height = higher_right ? left_height : right_height;
 
-    {
-        int count = 0;
+        /* find the black node which has the same black height as the lower tree */
+        while (xrbtree_node_color_red(node) || (lower_height < node_height)) {
+            if (xrbtree_node_color_black(node)) {
+                --node_height;
+            }
 
-        count += xrbtree_map_inorder_impl(tree, node->left, apply, cl);
+            parent = node;
+            node = higher_right ? node->left : node->right;
+        }
 
-        if (apply(node->key, &(node->value), cl)) {
-            count++;
+        xrbtree_node_set_color(mid, xrbtree_color_red);
+        xrbtree_node_set_parent(mid, parent);
+        if (higher_right) {
+            mid->left = left;
+            mid->right = node;
+            parent->left = mid;
+        }
+        else {
+            mid->left = node;
+            mid->right = right;
+            parent->right = mid;
+        }
+
+        if (mid->left) {
+            xrbtree_node_set_parent(mid->left, mid);
+        }
+        if (mid->right) {
+            xrbtree_node_set_parent(mid->right, mid);
+        }
+
+        for (XRBTree_Node_PT step = mid; step; step = xrbtree_node_parent(step)) {
+            xrbtree_update_node(tree, step);
+        }
+
+        root = xrbtree_join_fixup(tree, root, mid);
+
+        *height = higher_right ? right_height : left_height;
+        if (xrbtree_node_color_red(root)) {
+            xrbtree_node_set_color(root, xrbtree_color_black);
+            ++*height;
+        }
+
+        return root;
+    }
+}
+
+/* take the children of node away as two trees with black roots */
+static
+void xrbtree_split_children(XRBTree_Node_PT node, int height, XRBTree_Node_PT *left, int *left_height, XRBTree_Node_PT *right, int *right_height) {
+    int child_height = height - (xrbtree_node_color_black(node) ? 1 : 0);
+
+    *left = node->left;
+    *right = node->right;
+    *left_height = child_height;
+    *right_height = child_height;
+
+    if (*left) {
+        xrbtree_node_set_parent((*left), NULL);
+        if (xrbtree_node_color_red(*left)) {
+            xrbtree_node_set_color((*left), xrbtree_color_black);
+            ++*left_height;
+        }
+    }
+
+    if (*right) {
+        xrbtree_node_set_parent((*right), NULL);
+        if (xrbtree_node_color_red(*right)) {
+            xrbtree_node_set_color((*right), xrbtree_color_black);
+            ++*right_height;
+        }
+    }
+
+    node->left = NULL;
+    node->right = NULL;
+}
+
+/* split the tree into *left (keys < key, or keys <= key if "upper" is true) and *right, O(lgN) */
+static
+void xrbtree_split_impl(XRBTree_PT tree, XRBTree_Node_PT node, int height, void *key, bool upper, XRBTree_Node_PT *left, int *left_height, XRBTree_Node_PT *right, int *right_height) {
+    if (!node) {
+        *left = NULL;
+        *right = NULL;
+        *left_height = 0;
+        *right_height = 0;
+        return;
+    }
+
+    {
+        XRBTree_Node_PT lchild = NULL, rchild = NULL, middle = NULL;
+        int lchild_height = 0, rchild_height = 0, middle_height = 0;
+
+        int ret = tree->cmp(node->key, key, tree->cl);
+
+        xrbtree_split_children(node, height, &lchild, &lchild_height, &rchild, &rchild_height);
+
+        if ((ret < 0) || (upper && (ret == 0))) {
+            xrbtree_split_impl(tree, rchild, rchild_height, key, upper, &middle, &middle_height, right, right_height);
+            *left = xrbtree_join_impl(tree, lchild, lchild_height, node, middle, middle_height, left_height);
+        }
+        else {
+            xrbtree_split_impl(tree, lchild, lchild_height, key, upper, left, left_height, &middle, &middle_height);
+            *right = xrbtree_join_impl(tree, middle, middle_height, node, rchild, rchild_height, right_height);
+        }
+    }
+}
+
+/* split the max node away from the tree, *rest saves the other nodes, O(lgN) */
+static
+XRBTree_Node_PT xrbtree_split_max_impl(XRBTree_PT tree, XRBTree_Node_PT node, int height, XRBTree_Node_PT *rest, int *rest_height) {
+    XRBTree_Node_PT lchild = NULL, rchild = NULL;
+    int lchild_height = 0, rchild_height = 0;
+
+    xrbtree_split_children(node, height, &lchild, &lchild_height, &rchild, &rchild_height);
+
+    if (!rchild) {
+        *rest = lchild;
+        *rest_height = lchild_height;
+        return node;
+    }
+
+    {
+        XRBTree_Node_PT middle = NULL;
+        int middle_height = 0;
+
+        XRBTree_Node_PT max = xrbtree_split_max_impl(tree, rchild, rchild_height, &middle, &middle_height);
+        *rest = xrbtree_join_impl(tree, lchild, lchild_height, node, middle, middle_height, rest_height);
+        return max;
+    }
+}
+
+/* join two trees without middle node, O(lgN) */
+static
+XRBTree_Node_PT xrbtree_join2_impl(XRBTree_PT tree, XRBTree_Node_PT left, int left_height, XRBTree_Node_PT right, int right_height, int *height) {
+    if (!left) {
+        *height = right_height;
+        return right;
+    }
+
+    {
+        XRBTree_Node_PT rest = NULL;
+        int rest_height = 0;
+
+        XRBTree_Node_PT max = xrbtree_split_max_impl(tree, left, left_height, &rest, &rest_height);
+        return xrbtree_join_impl(tree, rest, rest_height, max, right, right_height, height);
+    }
+}
+
+XRBTree_PT xrbtree_split(XRBTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    /* keys of hashed trees are not in order */
+    xassert(!tree->hashed);
+
+    {
+        XRBTree_PT ntree = xrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+        if (!ntree) {
+            return NULL;
+        }
+
+        xrbtree_copy_augment(ntree, tree);
+        /* the nodes moved into ntree stay in the slab of tree */
+        if (tree->slab) {
+            ntree->slab = xslab_share(tree->slab);
+        }
+
+        {
+            int left_height = 0, right_height = 0;
+            xrbtree_split_impl(tree, tree->root, xrbtree_black_height(tree->root), key, false, &tree->root, &left_height, &ntree->root, &right_height);
+        }
+
+        return ntree;
+    }
+}
+
+XRBTree_PT xrbtree_remove_range(XRBTree_PT tree, void *low, void *high) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+
+    if (!tree || !low || !high) {
+        return NULL;
+    }
+
+    /* keys of hashed trees are not in order */
+    xassert(!tree->hashed);
+
+    if (0 < tree->cmp(low, high, tree->cl)) {
+        void *tmp = low;
+        low = high;
+        high = tmp;
+    }
+
+    {
+        XRBTree_PT ntree = xrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+        if (!ntree) {
+            return NULL;
+        }
+
+        xrbtree_copy_augment(ntree, tree);
+        /* the nodes moved into ntree stay in the slab of tree */
+        if (tree->slab) {
+            ntree->slab = xslab_share(tree->slab);
+        }
+
+        {
+            XRBTree_Node_PT left = NULL, right = NULL;
+            int left_height = 0, middle_height = 0, right_height = 0, height = 0;
+
+            /* left : keys < low,  ntree : low <= keys <= high,  right : high < keys */
+            xrbtree_split_impl(tree, tree->root, xrbtree_black_height(tree->root), low, false, &left, &left_height, &right, &right_height);
+            xrbtree_split_impl(tree, right, right_height, high, true, &ntree->root, &middle_height, &right, &right_height);
+
+            tree->root = xrbtree_join2_impl(tree, left, left_height, right, right_height, &height);
+        }
+
+        return ntree;
+    }
+}
+#endif
+
+static 
+int xrbtree_map_preorder_impl(XRBTree_PT tree, XRBTree_Node_PT node, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!node) {
+        return 0;
+    }
+
+    {
+        int count = 0;
+
+        if (apply(node->key, &(node->value), cl)) {
+            count++;
+        }
+
+        count += xrbtree_map_preorder_impl(tree, node->left, apply, cl);
+        count += xrbtree_map_preorder_impl(tree, node->right, apply, cl);
+
+        return count;
+    }
+}
+
+int xrbtree_map_preorder(XRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(apply);
+
+    if (!apply) {
+        return 0;
+    }
+
+    return xrbtree_map_preorder_impl(tree, (tree ? tree->root : NULL), apply, cl);
+}
+
+static 
+int xrbtree_map_inorder_impl(XRBTree_PT tree, XRBTree_Node_PT node, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    if (!node) {
+        return 0;
+    }
+
+    {
+        int count = 0;
+
+        count += xrbtree_map_inorder_impl(tree, node->left, apply, cl);
+
+        if (apply(node->key, &(node->value), cl)) {
+            count++;
         }
 
         count += xrbtree_map_inorder_impl(tree, node->right, apply, cl);
@@ -2295,11 +2850,403 @@ bool xrbtree_scope_map_min_to_max_break_if_false(XRBTree_PT tree, void *low, voi
     return false;
 }
 
+static
+int xrbtree_augment_map_impl(XRBTree_PT tree, XRBTree_Node_PT node, bool (*enter)(void *aux, void *cl), bool (*apply)(void *key, void *value, void *aux, void *cl), void *cl) {
+    int count = 0;
+
+    while (node && enter(xrbtree_node_aux(node), cl)) {
+        count += xrbtree_augment_map_impl(tree, node->left, enter, apply, cl);
+
+        if (apply(node->key, node->value, xrbtree_node_aux(node), cl)) {
+            ++count;
+        }
+
+        node = node->right;
+    }
+
+    return count;
+}
+
+int xrbtree_augment_map_min_to_max(XRBTree_PT tree, bool (*enter)(void *aux, void *cl), bool (*apply)(void *key, void *value, void *aux, void *cl), void *cl) {
+    xassert(tree);
+    xassert(tree->augment);
+    xassert(enter);
+    xassert(apply);
+
+    if (!tree || !tree->augment || !enter || !apply) {
+        return 0;
+    }
+
+    return xrbtree_augment_map_impl(tree, tree->root, enter, apply, cl);
+}
+
+#if defined(__linux__) && !defined(XRBTREE_NO_SIZE)
+
+/* a range has XRBTREE_PARALLEL_MIN_RANGE keys at least, and each thread takes XRBTREE_PARALLEL_RANGES_PER_THREAD ranges on average */
+#define XRBTREE_PARALLEL_MIN_RANGE          1024
+#define XRBTREE_PARALLEL_RANGES_PER_THREAD  4
+
+static
+XRBTree_Parallel_PT xrbtree_parallel_new(XRBTree_PT tree, XSThreadPool_PT pool) {
+    XRBTree_Parallel_PT paras = XMEM_CALLOC(1, sizeof(*paras));
+    if (!paras) {
+        return NULL;
+    }
+
+    {
+        /* the caller does the ranges too */
+        int threads = (pool ? xsthreadpool_num_threads_alive(pool) : 0) + 1;
+        int ranges = xrbtree_size(tree) / XRBTREE_PARALLEL_MIN_RANGE;
+
+        if (threads * XRBTREE_PARALLEL_RANGES_PER_THREAD < ranges) {
+            ranges = threads * XRBTREE_PARALLEL_RANGES_PER_THREAD;
+        }
+
+        paras->tree = tree;
+        paras->ranges = (ranges < 1) ? 1 : ranges;
+        paras->refs = 1;
+    }
+
+    if (pthread_mutex_init(&paras->lock, NULL) != 0) {
+        XMEM_FREE(paras);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&paras->all_done, NULL) != 0) {
+        pthread_mutex_destroy(&paras->lock);
+        XMEM_FREE(paras);
+        return NULL;
+    }
+
+    return paras;
+}
+
+static
+void xrbtree_parallel_release(XRBTree_Parallel_PT paras) {
+    bool last = false;
+
+    pthread_mutex_lock(&paras->lock);
+    last = (--paras->refs == 0);
+    pthread_mutex_unlock(&paras->lock);
+
+    if (last) {
+        pthread_cond_destroy(&paras->all_done);
+        pthread_mutex_destroy(&paras->lock);
+        XMEM_FREE(paras);
+    }
+}
+
+static
+void xrbtree_parallel_do_range(XRBTree_Parallel_PT paras, int range) {
+    XRBTree_PT tree = paras->tree;
+    int size = xrbtree_size(tree);
+    int start = (int)((long long)size * range / paras->ranges);
+    int end = (int)((long long)size * (range + 1) / paras->ranges);
+    int count = 0;
+
+    XRBTree_Node_PT node = (start < end) ? xrbtree_select_impl(tree, tree->root, start) : NULL;
+    for (int i = start; i < end; ++i) {
+        if (paras->apply) {
+            if (paras->apply(node->key, &node->value, paras->cl)) {
+                ++count;
+            }
+        }
+        else {
+            paras->accumulate(paras->accs + range * paras->acc_size, node->key, node->value, paras->cl);
+        }
+
+        node = xrbtree_next_node(tree, node);
+    }
+
+    pthread_mutex_lock(&paras->lock);
+    paras->count += count;
+    if (++paras->done == paras->ranges) {
+        pthread_cond_broadcast(&paras->all_done);
+    }
+    pthread_mutex_unlock(&paras->lock);
+}
+
+static
+void xrbtree_parallel_do_ranges(XRBTree_Parallel_PT paras) {
+    while (true) {
+        int range = -1;
+
+        pthread_mutex_lock(&paras->lock);
+        if (paras->next < paras->ranges) {
+            range = paras->next++;
+        }
+        pthread_mutex_unlock(&paras->lock);
+
+        if (range < 0) {
+            return;
+        }
+
+        xrbtree_parallel_do_range(paras, range);
+    }
+}
+
+static
+void xrbtree_parallel_job(void *arg) {
+    XRBTree_Parallel_PT paras = (XRBTree_Parallel_PT)arg;
+
+    xrbtree_parallel_do_ranges(paras);
+    xrbtree_parallel_release(paras);
+}
+
+/* add jobs to the pool, do the ranges together with them, then wait until all the ranges are done */
+static
+void xrbtree_parallel_run(XRBTree_Parallel_PT paras, XSThreadPool_PT pool) {
+    int jobs = pool ? xsthreadpool_num_threads_alive(pool) : 0;
+    if (paras->ranges - 1 < jobs) {
+        jobs = paras->ranges - 1;
+    }
+
+    for (int i = 0; i < jobs; ++i) {
+        pthread_mutex_lock(&paras->lock);
+        ++paras->refs;
+        pthread_mutex_unlock(&paras->lock);
+
+        if (!xsthreadpool_add_work(pool, xrbtree_parallel_job, (void*)paras)) {
+            /* the caller still holds its own reference here */
+            pthread_mutex_lock(&paras->lock);
+            --paras->refs;
+            pthread_mutex_unlock(&paras->lock);
+            break;
+        }
+    }
+
+    xrbtree_parallel_do_ranges(paras);
+
+    pthread_mutex_lock(&paras->lock);
+    while (paras->done < paras->ranges) {
+        pthread_cond_wait(&paras->all_done, &paras->lock);
+    }
+    pthread_mutex_unlock(&paras->lock);
+}
+
+int xrbtree_parallel_map(XRBTree_PT tree, XSThreadPool_PT pool, bool (*apply)(void *key, void **value, void *cl), void *cl) {
+    xassert(tree);
+    xassert(apply);
+
+    if (!tree || !apply || !tree->root) {
+        return 0;
+    }
+
+    {
+        int count = 0;
+
+        XRBTree_Parallel_PT paras = xrbtree_parallel_new(tree, pool);
+        if (!paras) {
+            return xrbtree_map_min_to_max_impl(tree, apply, cl);
+        }
+
+        paras->apply = apply;
+        paras->cl = cl;
+
+        xrbtree_parallel_run(paras, pool);
+
+        count = paras->count;
+        xrbtree_parallel_release(paras);
+
+        return count;
+    }
+}
+
+bool xrbtree_parallel_reduce(XRBTree_PT tree, XSThreadPool_PT pool, void *result, int acc_size, void (*accumulate)(void *acc, void *key, void *value, void *cl), void (*combine)(void *result, void *acc, void *cl), void *cl) {
+    xassert(tree);
+    xassert(result);
+    xassert(0 < acc_size);
+    xassert(accumulate);
+    xassert(combine);
+
+    if (!tree || !result || (acc_size <= 0) || !accumulate || !combine) {
+        return false;
+    }
+
+    if (!tree->root) {
+        return true;
+    }
+
+    {
+        XRBTree_Parallel_PT paras = xrbtree_parallel_new(tree, pool);
+        if (!paras) {
+            return false;
+        }
+
+        paras->accs = XMEM_MALLOC(paras->ranges * acc_size);
+        if (!paras->accs) {
+            xrbtree_parallel_release(paras);
+            return false;
+        }
+
+        for (int i = 0; i < paras->ranges; ++i) {
+            memcpy(paras->accs + i * acc_size, result, acc_size);
+        }
+
+        paras->accumulate = accumulate;
+        paras->acc_size = acc_size;
+        paras->cl = cl;
+
+        xrbtree_parallel_run(paras, pool);
+
+        /* no job uses the accumulators after all the ranges are done */
+        for (int i = 0; i < paras->ranges; ++i) {
+            combine(result, paras->accs + i * acc_size, cl);
+        }
+
+        XMEM_FREE(paras->accs);
+        xrbtree_parallel_release(paras);
+
+        return true;
+    }
+}
+
+#endif
+
+void xrbtree_cursor_init(XRBTree_Cursor_PT cursor, XRBTree_PT tree) {
+    xassert(cursor);
+    xassert(tree);
+
+    if (!cursor) {
+        return;
+    }
+
+    cursor->tree = tree;
+    cursor->node = NULL;
+}
+
+bool xrbtree_cursor_first(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->node = xrbtree_min_impl(cursor->tree, cursor->tree->root);
+    return cursor->node != NULL;
+}
+
+bool xrbtree_cursor_last(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->node = xrbtree_max_impl(cursor->tree, cursor->tree->root);
+    return cursor->node != NULL;
+}
+
+bool xrbtree_cursor_seek(XRBTree_Cursor_PT cursor, void *key) {
+    xassert(cursor);
+    xassert(key);
+
+    if (!cursor || !cursor->tree || !key) {
+        return false;
+    }
+
+    /* the keys of hashed trees are not in order */
+    xassert(!cursor->tree->hashed);
+
+    {
+        XRBTree_PT tree = cursor->tree;
+        XRBTree_Node_PT node = tree->root;
+        XRBTree_Node_PT result = NULL;
+
+        /* not xrbtree_ceiling_impl : the first one of the "repeat" keys is needed */
+        while (node) {
+            if (tree->cmp(node->key, key, tree->cl) < 0) {
+                node = node->right;
+            }
+            else {
+                result = node;
+                node = node->left;
+            }
+        }
+
+        cursor->node = result;
+        return result != NULL;
+    }
+}
+
+bool xrbtree_cursor_next(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    cursor->node = xrbtree_next_node(cursor->tree, (XRBTree_Node_PT)cursor->node);
+    return cursor->node != NULL;
+}
+
+bool xrbtree_cursor_prev(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    cursor->node = xrbtree_prev_node(cursor->tree, (XRBTree_Node_PT)cursor->node);
+    return cursor->node != NULL;
+}
+
+bool xrbtree_cursor_valid(XRBTree_Cursor_PT cursor) {
+    return cursor ? (cursor->node != NULL) : false;
+}
+
+void* xrbtree_cursor_key(XRBTree_Cursor_PT cursor) {
+    return (cursor && cursor->node) ? ((XRBTree_Node_PT)cursor->node)->key : NULL;
+}
+
+void* xrbtree_cursor_value(XRBTree_Cursor_PT cursor) {
+    return (cursor && cursor->node) ? ((XRBTree_Node_PT)cursor->node)->value : NULL;
+}
+
+bool xrbtree_cursor_root(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->tree) {
+        return false;
+    }
+
+    cursor->node = cursor->tree->root;
+    return cursor->node != NULL;
+}
+
+bool xrbtree_cursor_left(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    cursor->node = ((XRBTree_Node_PT)cursor->node)->left;
+    return cursor->node != NULL;
+}
+
+bool xrbtree_cursor_right(XRBTree_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    cursor->node = ((XRBTree_Node_PT)cursor->node)->right;
+    return cursor->node != NULL;
+}
+
+void* xrbtree_cursor_aux(XRBTree_Cursor_PT cursor) {
+    return (cursor && cursor->node && cursor->tree->augment) ? xrbtree_node_aux((XRBTree_Node_PT)cursor->node) : NULL;
+}
+
 bool xrbtree_swap(XRBTree_PT tree1, XRBTree_PT tree2) {
     xassert(tree1);
     xassert(tree2);
+    /* nodes and slab can't move to a tree which allocates from another allocator */
+    xassert(tree1->allocator == tree2->allocator);
 
-    if (!tree1 || !tree2) {
+    if (!tree1 || !tree2 || (tree1->allocator != tree2->allocator)) {
         return false;
     }
 
@@ -2321,6 +3268,38 @@ bool xrbtree_swap(XRBTree_PT tree1, XRBTree_PT tree2) {
             tree1->cl = tree2->cl;
             tree2->cl = cl;
         }
+
+        {
+            void (*augment)(void *key, void *value, void *aux, void *left_aux, void *right_aux, void *cl) = tree1->augment;
+            tree1->augment = tree2->augment;
+            tree2->augment = augment;
+        }
+
+        {
+            void *augment_cl = tree1->augment_cl;
+            tree1->augment_cl = tree2->augment_cl;
+            tree2->augment_cl = augment_cl;
+        }
+
+        {
+            int aux_size = tree1->aux_size;
+            tree1->aux_size = tree2->aux_size;
+            tree2->aux_size = aux_size;
+        }
+
+        {
+            XSlab_PT slab = tree1->slab;
+            tree1->slab = tree2->slab;
+            tree2->slab = slab;
+        }
+
+#ifdef XRBTREE_NO_SIZE
+        {
+            int count = tree1->count;
+            tree1->count = tree2->count;
+            tree2->count = count;
+        }
+#endif
     }
 
     return true;
@@ -2367,12 +3346,47 @@ int xrbtree_keys_size(XRBTree_PT tree, void *low, void *high) {
     }
 }
 
+int xrbtree_key_size_hash(XRBTree_PT tree, void *key, int hash) {
+    if (!tree || !(tree->root) || !key) {
+        return 0;
+    }
+
+    {
+        int count = 0;
+
+        XRBTree_Node_PT node = xrbtree_get_hash_impl(tree, tree->root, key, hash);
+        if (node) {
+            /* the equal keys may be saved in pre nodes */
+            XRBTree_Node_PT tnode = xrbtree_prev_node(tree, node);
+            while (tnode && (xrbtree_cmp_node(tree, key, hash, tnode) == 0)) {
+                ++count;
+                tnode = xrbtree_prev_node(tree, tnode);
+            }
+        }
+
+        while (node && (xrbtree_cmp_node(tree, key, hash, node) == 0)) {
+            ++count;
+            node = xrbtree_next_node(tree, node);
+        }
+
+        return count;
+    }
+}
+
 int xrbtree_size(XRBTree_PT tree) {
+#ifdef XRBTREE_NO_SIZE
+    return (tree ? tree->count : 0);
+#else
     return (tree ? (tree->root ? tree->root->size : 0) : 0);
+#endif
+}
+
+void* xrbtree_aux(XRBTree_PT tree) {
+    return (tree && tree->augment) ? xrbtree_node_aux(tree->root) : NULL;
 }
 
 bool xrbtree_is_empty(XRBTree_PT tree) {
-    return (tree ? (tree->root ? (tree->root->size == 0) : true) : true);
+    return (tree ? !tree->root : true);
 }
 
 static
@@ -2401,7 +3415,7 @@ int xrbtree_count_black_to_root(XRBTree_PT tree, XRBTree_Node_PT node) {
         if (xrbtree_node_color_black(node)) {
             ++count;
         }
-        node = node->parent;
+        node = xrbtree_node_parent(node);
     }
 
     return count + 1;  /* 1 means tree->root is black */
@@ -2448,10 +3462,12 @@ bool xrbtree_is_rbtree(XRBTree_PT tree) {
                 return false;
             }
 
+#ifndef XRBTREE_NO_SIZE
             /* node->size = 1 + node->left->size + node->right->size */
             if (node->size != (1 + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0))) {
                 return false;
             }
+#endif
 
             /* the black node number from every leaf node to root must be the same */
             if (!node->left && !node->right && (black != xrbtree_count_black_to_root(tree, node))) {
@@ -2461,8 +3477,8 @@ bool xrbtree_is_rbtree(XRBTree_PT tree) {
             node = xrbtree_next_node(tree, node);
         }
 
-        /* total node number is the same with the size saved in root */
-        if (count != tree->root->size) {
+        /* total node number is the same with the size saved */
+        if (count != xrbtree_size(tree)) {
             return false;
         }
     }
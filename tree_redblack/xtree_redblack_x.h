@@ -14,29 +14,120 @@
 #define XRBTREEX_INCLUDED
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "../include/xtree_redblack.h"
+#include "../include/xmem_slab.h"
 
 typedef struct XRBTree_Node* XRBTree_Node_PT;
 
+/* node sizes on 64 bits platforms (before the summary of augmented trees or the hash code of hashed trees) :
+ *    default                                      : 48 bytes
+ *    XRBTREE_COMPACT_NODE                         : 48 bytes, the color is saved in the lowest bit of the parent pointer
+ *                                                   (nodes are at least 2 bytes aligned), the padding is still taken by size
+ *    XRBTREE_NO_SIZE                              : 48 bytes, the size of subtree is not saved, select/rank/split are not built
+ *    XRBTREE_COMPACT_NODE and XRBTREE_NO_SIZE     : 40 bytes
+ */
 struct XRBTree_Node {
+#ifdef XRBTREE_COMPACT_NODE
+    uintptr_t       parent_color;
+#else
     XRBTree_Node_PT parent;
+#endif
     XRBTree_Node_PT left;
     XRBTree_Node_PT right;
 
     void *key;
     void *value;
 
-    int   size;
+#ifndef XRBTREE_NO_SIZE
+    int   size;       /* count of nodes in the subtree */
+#endif
+#ifndef XRBTREE_COMPACT_NODE
     bool  color;      /* red : false,  black : true */
+#endif
 };
 
+/* O(1) : always use them to access the parent and color of node */
+static inline
+XRBTree_Node_PT xrbtree_node_parent(XRBTree_Node_PT node) {
+#ifdef XRBTREE_COMPACT_NODE
+    return (XRBTree_Node_PT)(node->parent_color & ~(uintptr_t)1);
+#else
+    return node->parent;
+#endif
+}
+
+static inline
+void xrbtree_node_set_parent(XRBTree_Node_PT node, XRBTree_Node_PT parent) {
+#ifdef XRBTREE_COMPACT_NODE
+    node->parent_color = (uintptr_t)parent | (node->parent_color & 1);
+#else
+    node->parent = parent;
+#endif
+}
+
+static inline
+bool xrbtree_node_color(XRBTree_Node_PT node) {
+#ifdef XRBTREE_COMPACT_NODE
+    return (node->parent_color & 1) != 0;
+#else
+    return node->color;
+#endif
+}
+
+static inline
+void xrbtree_node_set_color(XRBTree_Node_PT node, bool color) {
+#ifdef XRBTREE_COMPACT_NODE
+    node->parent_color = (node->parent_color & ~(uintptr_t)1) | (color ? 1 : 0);
+#else
+    node->color = color;
+#endif
+}
+
+/* hashed trees save the hash code of key just after each node, so the nodes of the other trees don't pay for it */
+#define XRBTREE_HASHED_NODE_SIZE  ((int)(sizeof(struct XRBTree_Node) + sizeof(int)))
+
+static inline
+int xrbtree_node_hash(XRBTree_Node_PT node) {
+    return *(int*)(node + 1);
+}
+
+static inline
+void xrbtree_node_set_hash(XRBTree_Node_PT node, int hash) {
+    *(int*)(node + 1) = hash;
+}
+
 struct XRBTree {
     XRBTree_Node_PT root;
 
     int (*cmp)(void *key1, void *key2, void *cl);
     void *cl;
+
+    bool hashed;      /* true : ordered by hash code first, then by cmp, used as the buckets of hash tables */
+
+    /* the summary of each subtree, aux_size bytes are saved just after each node,
+     * hashed trees save the hash code of key there instead (they can't be augmented)
+     */
+    void (*augment)(void *key, void *value, void *aux, void *left_aux, void *right_aux, void *cl);
+    void *augment_cl;
+    int   aux_size;
+
+    XSlab_PT slab;    /* all the nodes come from it, created with the first node, may be shared with the trees split from this one */
+
+    XMem_Allocator_PT allocator;  /* the tree and its slab come from it, NULL : XMEM */
+
+#ifdef XRBTREE_NO_SIZE
+    int count;        /* count of nodes, kept here since the nodes don't save the size of their subtrees */
+#endif
 };
 
+/* O(1) : make the empty tree a hashed one, must be called before the first node is put */
+static inline
+void xrbtree_set_hashed(XRBTree_PT tree) {
+    tree->hashed = true;
+    tree->aux_size = (int)sizeof(int);
+}
+
 /* used for internal implementations */
 typedef struct XRBTree_3Paras  XRBTree_3Paras_T;
 typedef struct XRBTree_3Paras* XRBTree_3Paras_PT;
@@ -49,6 +140,54 @@ struct XRBTree_3Paras {
     void      *para3;
 };
 
+#if defined(__linux__) && !defined(XRBTREE_NO_SIZE)
+#include <pthread.h>
+
+/* shared by the caller and the jobs of xrbtree_parallel_map and xrbtree_parallel_reduce,
+ * the keys are split into "ranges" ranges by rank, both the caller and the jobs take the ranges one by one,
+ * so the caller never waits for a job which is not started (or dropped) by the pool
+ */
+typedef struct XRBTree_Parallel  XRBTree_Parallel_T;
+typedef struct XRBTree_Parallel* XRBTree_Parallel_PT;
+
+struct XRBTree_Parallel {
+    XRBTree_PT      tree;
+
+    int             ranges;
+    int             next;       /* the next range to be taken */
+    int             done;       /* the count of the finished ranges */
+    int             refs;       /* the caller and the jobs not finished, the last one frees it */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  all_done;
+
+    /* xrbtree_parallel_map */
+    bool          (*apply)(void *key, void **value, void *cl);
+    int             count;      /* the count of apply returns true */
+
+    /* xrbtree_parallel_reduce */
+    void          (*accumulate)(void *acc, void *key, void *value, void *cl);
+    int             acc_size;
+    char           *accs;       /* one accumulator for each range */
+
+    void           *cl;
+};
+#endif
+
+/* O(lgN) : interfaces for hashed trees, hash is the hash code of key (ignored if tree->hashed is false),
+ *          cmp is called only when the hash codes are equal.
+ *          Note : the interfaces compare keys in order (floor, ceiling, rank, keys ...) can't be used with hashed trees
+ */
+extern XRBTree_Node_PT xrbtree_get_hash_impl           (XRBTree_PT tree, XRBTree_Node_PT node, void *key, int hash);
+extern bool      xrbtree_put_repeat_hash               (XRBTree_PT tree, void *key, void *value, int hash, bool unique);
+extern bool      xrbtree_put_replace_hash              (XRBTree_PT tree, void *key, void *value, int hash, void **old_value, bool deep);
+extern int       xrbtree_remove_hash                   (XRBTree_PT tree, void *key, int hash, bool deep);
+
+/* O(NlgN) */
+extern XSList_PT xrbtree_get_all_hash                  (XRBTree_PT tree, void *key, int hash);
+extern int       xrbtree_remove_all_hash               (XRBTree_PT tree, void *key, int hash, bool deep);
+extern int       xrbtree_key_size_hash                 (XRBTree_PT tree, void *key, int hash);
+
 /* O(N) */
 extern int   xrbtree_map_min_to_max_impl               (XRBTree_PT tree, bool (*apply)(void *key, void **value, void *cl), void *cl);
 extern bool  xrbtree_map_min_to_max_break_if_impl      (XRBTree_PT tree, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl);
@@ -12,11 +12,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../include/xassert.h"
 #include "../include/xmem.h"
 #include "../utils/xutils.h"
-#include "../list_s_raw/xlist_s_raw_x.h"
 #include "../list_s/xlist_s_x.h"
 #include "../include/xqueue_fifo.h"
 #include "xtree_redblack_list_x.h"
@@ -34,12 +34,189 @@ static const bool xlistrbtree_color_black = true;
 
 static
 bool xlistrbtree_node_color_red(XListRBTree_Node_PT node) {
-    return node ? (node->color == xlistrbtree_color_red) : false;
+    return node ? (xlistrbtree_node_color(node) == xlistrbtree_color_red) : false;
 }
 
 static
 bool xlistrbtree_node_color_black(XListRBTree_Node_PT node) {    
-    return node ? (node->color == xlistrbtree_color_black) : true;  /* NULL node is black */
+    return node ? (xlistrbtree_node_color(node) == xlistrbtree_color_black) : true;  /* NULL node is black */
+}
+
+/* move the values to a new storage which can save "capacity" values at least, "capacity" is 0 for "inline_values" */
+static
+bool xlistrbtree_values_move(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, int capacity) {
+    void **array = xlistrbtree_values_array(values);
+
+    xassert(values->count <= ((0 < capacity) ? capacity : XLISTRBTREE_INLINE_VALUES));
+
+    if (0 < capacity) {
+        void **narray = XMEM_ALLOC_BY(allocator, capacity * sizeof(void*));
+        if (!narray) {
+            return false;
+        }
+
+        memcpy(narray, array, values->count * sizeof(void*));
+        if (0 < values->capacity) {
+            XMEM_FREE_BY(allocator, array, values->capacity * sizeof(void*));
+        }
+        values->store.array = narray;
+    }
+    else if (0 < values->capacity) {
+        /* "array" and "inline_values" share the same memory */
+        memcpy(values->store.inline_values, array, values->count * sizeof(void*));
+        XMEM_FREE_BY(allocator, array, values->capacity * sizeof(void*));
+    }
+
+    values->capacity = capacity;
+    return true;
+}
+
+bool xlistrbtree_values_push_front(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, void *value) {
+    int capacity = (0 < values->capacity) ? values->capacity : XLISTRBTREE_INLINE_VALUES;
+
+    if (values->count == capacity) {
+        if (!xlistrbtree_values_move(allocator, values, capacity * 2)) {
+            return false;
+        }
+    }
+
+    xlistrbtree_values_array(values)[values->count++] = value;
+    return true;
+}
+
+/* the storage is moved back to "inline_values" if the values can be saved in it, then an empty node never keeps an array */
+static
+void xlistrbtree_values_shrink(XMem_Allocator_PT allocator, XListRBTree_Values_PT values) {
+    if ((0 < values->capacity) && (values->count <= XLISTRBTREE_INLINE_VALUES)) {
+        xlistrbtree_values_move(allocator, values, 0);
+    }
+}
+
+void* xlistrbtree_values_pop_kth(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, int k) {
+    xassert(0 <= k);
+    xassert(k < values->count);
+
+    if ((k < 0) || (values->count <= k)) {
+        return NULL;
+    }
+
+    {
+        void **array = xlistrbtree_values_array(values);
+        int index = values->count - 1 - k;
+        void *value = array[index];
+
+        memmove(array + index, array + index + 1, k * sizeof(void*));
+        --values->count;
+
+        xlistrbtree_values_shrink(allocator, values);
+
+        return value;
+    }
+}
+
+int xlistrbtree_values_free_except_front(XMem_Allocator_PT allocator, XListRBTree_Values_PT values) {
+    if (values->count <= 1) {
+        return 0;
+    }
+
+    {
+        void **array = xlistrbtree_values_array(values);
+        int count = values->count - 1;
+
+        array[0] = array[count];
+        values->count = 1;
+
+        xlistrbtree_values_shrink(allocator, values);
+
+        return count;
+    }
+}
+
+static
+bool xlistrbtree_values_copy_impl(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues, int value_size) {
+    int capacity = 0;
+
+    if (XLISTRBTREE_INLINE_VALUES < values->count) {
+        capacity = values->count;
+        nvalues->store.array = XMEM_ALLOC_BY(allocator, capacity * sizeof(void*));
+        if (!nvalues->store.array) {
+            return false;
+        }
+    }
+
+    nvalues->capacity = capacity;
+    nvalues->count = 0;
+
+    {
+        void **array = xlistrbtree_values_array(values);
+        void **narray = xlistrbtree_values_array(nvalues);
+
+        for (int i = 0; i < values->count; ++i) {
+            if (0 < value_size) {
+                narray[i] = xutils_deep_copy(array[i], value_size);
+                if (!narray[i]) {
+                    xlistrbtree_values_free(allocator, nvalues, true);
+                    return false;
+                }
+            }
+            else {
+                narray[i] = array[i];
+            }
+            ++nvalues->count;
+        }
+    }
+
+    return true;
+}
+
+bool xlistrbtree_values_copy(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues) {
+    return xlistrbtree_values_copy_impl(allocator, values, nvalues, 0);
+}
+
+bool xlistrbtree_values_deep_copy(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues, int value_size) {
+    return xlistrbtree_values_copy_impl(allocator, values, nvalues, value_size);
+}
+
+bool xlistrbtree_values_merge_copy(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues) {
+    int count = values->count + nvalues->count;
+    int capacity = (0 < values->capacity) ? values->capacity : XLISTRBTREE_INLINE_VALUES;
+
+    if (nvalues->count == 0) {
+        return true;
+    }
+
+    if (capacity < count) {
+        if (!xlistrbtree_values_move(allocator, values, count)) {
+            return false;
+        }
+    }
+
+    {
+        void **array = xlistrbtree_values_array(values);
+
+        /* values of "nvalues" are all behind the back one of "values" */
+        memmove(array + nvalues->count, array, values->count * sizeof(void*));
+        memcpy(array, xlistrbtree_values_array(nvalues), nvalues->count * sizeof(void*));
+        values->count = count;
+    }
+
+    return true;
+}
+
+void xlistrbtree_values_free(XMem_Allocator_PT allocator, XListRBTree_Values_PT values, bool deep) {
+    if (deep) {
+        void **array = xlistrbtree_values_array(values);
+        for (int i = 0; i < values->count; ++i) {
+            XMEM_FREE(array[i]);
+        }
+    }
+
+    if (0 < values->capacity) {
+        XMEM_FREE_BY(allocator, values->store.array, values->capacity * sizeof(void*));
+    }
+
+    values->count = 0;
+    values->capacity = 0;
 }
 
 XListRBTree_Node_PT xlistrbtree_min_impl(XListRBTree_PT tree, XListRBTree_Node_PT node) {
@@ -100,10 +277,10 @@ XListRBTree_Node_PT xlistrbtree_prev_node(XListRBTree_PT tree, XListRBTree_Node_
         *        / \
         *       H   S
         */
-        XListRBTree_Node_PT parent = node->parent;
+        XListRBTree_Node_PT parent = xlistrbtree_node_parent(node);
         while (parent && (node == parent->left)) {
             node = parent;
-            parent = parent->parent;
+            parent = xlistrbtree_node_parent(parent);
         }
 
         return parent;
@@ -123,10 +300,10 @@ XListRBTree_Node_PT xlistrbtree_next_node(XListRBTree_PT tree, XListRBTree_Node_
         *      \
         *       R
         */
-        XListRBTree_Node_PT parent = node->parent;
+        XListRBTree_Node_PT parent = xlistrbtree_node_parent(node);
         while (parent && (node == parent->right)) {
             node = parent;
-            parent = parent->parent;
+            parent = xlistrbtree_node_parent(parent);
         }
 
         return parent;
@@ -148,12 +325,12 @@ XListRBTree_Node_PT xlistrbtree_next_node(XListRBTree_PT tree, XListRBTree_Node_
 */
 static
 void xlistrbtree_flip_color(XListRBTree_Node_PT node_N) {
-    node_N->color = !node_N->color;
+    xlistrbtree_node_set_color(node_N, !xlistrbtree_node_color(node_N));
     if (node_N->left) {
-        node_N->left->color = !node_N->left->color;
+        xlistrbtree_node_set_color(node_N->left, !xlistrbtree_node_color(node_N->left));
     }
     if (node_N->right) {
-        node_N->right->color = !node_N->right->color;
+        xlistrbtree_node_set_color(node_N->right, !xlistrbtree_node_color(node_N->right));
     }
 }
 
@@ -172,25 +349,25 @@ XListRBTree_Node_PT xlistrbtree_rotate_left(XListRBTree_Node_PT node_N) {
 
     node_N->right = x->left;
     if (x->left) {
-        x->left->parent = node_N;
+        xlistrbtree_node_set_parent(x->left, node_N);
     }
 
-    x->parent = node_N->parent;
+    xlistrbtree_node_set_parent(x, xlistrbtree_node_parent(node_N));
 
-    if (node_N->parent) {
-        if (node_N == node_N->parent->left) {
-            node_N->parent->left = x;
+    if (xlistrbtree_node_parent(node_N)) {
+        if (node_N == xlistrbtree_node_parent(node_N)->left) {
+            xlistrbtree_node_parent(node_N)->left = x;
         }
         else {
-            node_N->parent->right = x;
+            xlistrbtree_node_parent(node_N)->right = x;
         }
     }
 
     x->left = node_N;
-    node_N->parent = x;
+    xlistrbtree_node_set_parent(node_N, x);
 
-    x->color = node_N->color;
-    node_N->color = xlistrbtree_color_red;
+    xlistrbtree_node_set_color(x, xlistrbtree_node_color(node_N));
+    xlistrbtree_node_set_color(node_N, xlistrbtree_color_red);
     x->size = node_N->size;
     node_N->size = node_N->node_size + (node_N->left ? node_N->left->size : 0) + (node_N->right ? node_N->right->size : 0);
 
@@ -212,25 +389,25 @@ XListRBTree_Node_PT xlistrbtree_rotate_right(XListRBTree_Node_PT node_N) {
 
     node_N->left = x->right;
     if (x->right) {
-        x->right->parent = node_N;
+        xlistrbtree_node_set_parent(x->right, node_N);
     }
 
-    x->parent = node_N->parent;
+    xlistrbtree_node_set_parent(x, xlistrbtree_node_parent(node_N));
 
-    if (node_N->parent) {
-        if (node_N == node_N->parent->left) {
-            node_N->parent->left = x;
+    if (xlistrbtree_node_parent(node_N)) {
+        if (node_N == xlistrbtree_node_parent(node_N)->left) {
+            xlistrbtree_node_parent(node_N)->left = x;
         }
         else {
-            node_N->parent->right = x;
+            xlistrbtree_node_parent(node_N)->right = x;
         }
     }
 
     x->right = node_N;
-    node_N->parent = x;
+    xlistrbtree_node_set_parent(node_N, x);
 
-    x->color = node_N->color;
-    node_N->color = xlistrbtree_color_red;
+    xlistrbtree_node_set_color(x, xlistrbtree_node_color(node_N));
+    xlistrbtree_node_set_color(node_N, xlistrbtree_color_red);
     x->size = node_N->size;
     node_N->size = node_N->node_size + (node_N->left ? node_N->left->size : 0) + (node_N->right ? node_N->right->size : 0);
 
@@ -309,24 +486,24 @@ XListRBTree_Node_PT xlistrbtree_balance(XListRBTree_Node_PT node_N) {
 }
 
 static
-XListRBTree_Node_PT xlistrbtree_new_node(void *key, void *value, bool color) {
-    XListRBTree_Node_PT node = XMEM_CALLOC(1, sizeof(*node));
+XListRBTree_Node_PT xlistrbtree_new_node(XListRBTree_PT tree, void *key, void *value, bool color) {
+    XListRBTree_Node_PT node = XMEM_ALLOC_BY(tree->allocator, sizeof(*node));
     if (!node) {
         return NULL;
     }
 
     node->key = key;
     if (value) {
-        node->values = xrslist_new(value);
-        if (!node->values) {
-            XMEM_FREE(node);
+        /* always true since the first value is saved in the node itself */
+        if (!xlistrbtree_values_push_front(tree->allocator, &node->values, value)) {
+            XMEM_FREE_BY(tree->allocator, node, sizeof(*node));
             return NULL;
         }
     }
 
     node->node_size = 1;
     node->size = 1;
-    node->color = color;
+    xlistrbtree_node_set_color(node, color);
 
     //node->parent = NULL;
     //node->left = NULL;
@@ -336,18 +513,18 @@ XListRBTree_Node_PT xlistrbtree_new_node(void *key, void *value, bool color) {
 }
 
 static
-XListRBTree_Node_PT xlistrbtree_new_node_with_list(void *key, XRSList_PT values, int size, bool color) {
-    XListRBTree_Node_PT node = XMEM_CALLOC(1, sizeof(*node));
+XListRBTree_Node_PT xlistrbtree_new_node_with_values(XListRBTree_PT tree, void *key, XListRBTree_Values_PT values, int size, bool color) {
+    XListRBTree_Node_PT node = XMEM_ALLOC_BY(tree->allocator, sizeof(*node));
     if (!node) {
         return NULL;
     }
 
     node->key = key;
-    node->values = values;
+    node->values = *values;  /* "values" are moved to the node */
 
     node->node_size = size;
     node->size = size;
-    node->color = color;
+    xlistrbtree_node_set_color(node, color);
 
     //node->parent = NULL;
     //node->left = NULL;
@@ -357,6 +534,10 @@ XListRBTree_Node_PT xlistrbtree_new_node_with_list(void *key, XRSList_PT values,
 }
 
 XListRBTree_PT xlistrbtree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    return xlistrbtree_new_allocator(cmp, cl, NULL);
+}
+
+XListRBTree_PT xlistrbtree_new_allocator(int (*cmp)(void *key1, void *key2, void *cl), void *cl, XMem_Allocator_PT allocator) {
     xassert(cmp);
     
     if (!cmp) {
@@ -364,13 +545,14 @@ XListRBTree_PT xlistrbtree_new(int (*cmp)(void *key1, void *key2, void *cl), voi
     }
 
     {
-        XListRBTree_PT tree = XMEM_CALLOC(1, sizeof(*tree));
+        XListRBTree_PT tree = XMEM_ALLOC_BY(allocator, sizeof(*tree));
         if (!tree) {
             return NULL;
         }
 
         tree->cmp = cmp;
         tree->cl = cl;
+        tree->allocator = allocator;
         //tree->root = NULL;
 
         return tree;
@@ -379,25 +561,26 @@ XListRBTree_PT xlistrbtree_new(int (*cmp)(void *key1, void *key2, void *cl), voi
 
 static
 XListRBTree_Node_PT xlistrbtree_copy_node(XListRBTree_Node_PT node, XListRBTree_Node_PT nparent, bool *false_found, void *cl) {
-    XListRBTree_Node_PT nnode = XMEM_CALLOC(1, sizeof(*nnode));
+    XListRBTree_PT ntree = (XListRBTree_PT)cl;
+
+    XListRBTree_Node_PT nnode = XMEM_ALLOC_BY(ntree->allocator, sizeof(*nnode));
     if (!nnode) {
         *false_found = true;
         return NULL;
     }
 
     nnode->key = node->key;
-    nnode->values = xrslist_copy(node->values);
-    if (node->values && !nnode->values) {
+    if (!xlistrbtree_values_copy(ntree->allocator, &node->values, &nnode->values)) {
         *false_found = true;
-        XMEM_FREE(nnode);
+        XMEM_FREE_BY(ntree->allocator, nnode, sizeof(*nnode));
         return NULL;
     }
 
     nnode->node_size = node->node_size;
     nnode->size = node->size;
-    nnode->color = node->color;
+    xlistrbtree_node_set_color(nnode, xlistrbtree_node_color(node));
 
-    nnode->parent = nparent;
+    xlistrbtree_node_set_parent(nnode, nparent);
     //nnode->left = NULL;
     //nnode->right = NULL;
 
@@ -446,12 +629,12 @@ XListRBTree_PT xlistrbtree_copy(XListRBTree_PT tree) {
     {
         bool false_found = false;
 
-        XListRBTree_PT ntree = xlistrbtree_new(tree->cmp, tree->cl);
+        XListRBTree_PT ntree = xlistrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
         if (!ntree) {
             return NULL;
         }
 
-        xlistrbtree_copy_break_if_false_impl(tree, tree->root, ntree, NULL, true, false, &false_found, xlistrbtree_copy_node, NULL);
+        xlistrbtree_copy_break_if_false_impl(tree, tree->root, ntree, NULL, true, false, &false_found, xlistrbtree_copy_node, (void*)ntree);
         if (false_found) {
             xlistrbtree_free(&ntree);
             return NULL;
@@ -467,7 +650,7 @@ static
 XListRBTree_Node_PT xlistrbtree_deep_copy_node(XListRBTree_Node_PT node, XListRBTree_Node_PT nparent, bool *false_found, void *cl) {
     XListRBTree_3Paras_PT paras = (XListRBTree_3Paras_PT)cl;
 
-    XListRBTree_Node_PT nnode = XMEM_CALLOC(1, sizeof(*nnode));
+    XListRBTree_Node_PT nnode = XMEM_ALLOC_BY(paras->tree->allocator, sizeof(*nnode));
     if (!nnode) {
         *false_found = true;
         return NULL;
@@ -476,23 +659,22 @@ XListRBTree_Node_PT xlistrbtree_deep_copy_node(XListRBTree_Node_PT node, XListRB
     nnode->key = xutils_deep_copy(node->key, *((int*)paras->para1));
     if (!nnode->key) {
         *false_found = true;
-        XMEM_FREE(nnode);
+        XMEM_FREE_BY(paras->tree->allocator, nnode, sizeof(*nnode));
         return NULL;
     }
 
-    nnode->values = xrslist_deep_copy(node->values, *((int*)paras->para2));
-    if (node->values && !nnode->values) {
+    if (!xlistrbtree_values_deep_copy(paras->tree->allocator, &node->values, &nnode->values, *((int*)paras->para2))) {
         *false_found = true;
         XMEM_FREE(nnode->key);
-        XMEM_FREE(nnode);
+        XMEM_FREE_BY(paras->tree->allocator, nnode, sizeof(*nnode));
         return NULL;
     }
 
     nnode->node_size = node->node_size;
     nnode->size = node->size;
-    nnode->color = node->color;
+    xlistrbtree_node_set_color(nnode, xlistrbtree_node_color(node));
 
-    nnode->parent = nparent;
+    xlistrbtree_node_set_parent(nnode, nparent);
     //nnode->left = NULL;
     //nnode->right = NULL;
 
@@ -509,7 +691,7 @@ XListRBTree_PT xlistrbtree_deep_copy(XListRBTree_PT tree, int key_size, int valu
     }
 
     {
-        XListRBTree_PT ntree = xlistrbtree_new(tree->cmp, tree->cl);
+        XListRBTree_PT ntree = xlistrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
         if (!ntree) {
             return NULL;
         }
@@ -535,12 +717,12 @@ static
 XListRBTree_Node_PT xlistrbtree_put_repeat_impl(XListRBTree_PT tree, XListRBTree_Node_PT parent, XListRBTree_Node_PT node, void *key, void *value, bool *false_found, bool unique) {
     /* reach the leaf node, return the new created new_node */
     if (!node) {
-        XListRBTree_Node_PT nnode = xlistrbtree_new_node(key, value, xlistrbtree_color_red);
+        XListRBTree_Node_PT nnode = xlistrbtree_new_node(tree, key, value, xlistrbtree_color_red);
         if (!nnode) {
             *false_found = true;
         }
         else {
-            nnode->parent = parent;
+            xlistrbtree_node_set_parent(nnode, parent);
         }
         return nnode;
     }
@@ -555,21 +737,17 @@ XListRBTree_Node_PT xlistrbtree_put_repeat_impl(XListRBTree_PT tree, XListRBTree
             /* if value is NULL, it will be ignored here since node->values has elements already */
 
             if (value) {
-                if (node->values) {
-                    if (!xrslist_push_front_repeat(&node->values, value)) {
-                        *false_found = true;
-                        return node;
-                    }
+                bool has_values = (0 < node->values.count);
+                if (!xlistrbtree_values_push_front(tree->allocator, &node->values, value)) {
+                    *false_found = true;
+                    return node;
+                }
+
+                /* no need to increase node_size if it has no values since it's 1 already */
+                if (has_values) {
                     ++node->node_size;
                     ++node->size;
                 }
-                else {
-                    node->values = xrslist_new(value);
-                    if (!node->values) {
-                        *false_found = true;
-                    }
-                    /* no need to increase node_size since it's 1 already */
-                }
             }
 
             return node;
@@ -601,7 +779,7 @@ bool xlistrbtree_put_repeat(XListRBTree_PT tree, void *key, void *value) {
 
         tree->root = xlistrbtree_put_repeat_impl(tree, NULL, tree->root, key, value, &false_found, false);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return !false_found;
@@ -621,7 +799,7 @@ bool xlistrbtree_put_unique(XListRBTree_PT tree, void *key, void *value) {
 
         tree->root = xlistrbtree_put_repeat_impl(tree, NULL, tree->root, key, value, &false_found, true);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return !false_found;
@@ -633,12 +811,12 @@ static
 XListRBTree_Node_PT xlistrbtree_put_replace_impl(XListRBTree_PT tree, XListRBTree_Node_PT parent, XListRBTree_Node_PT node, void *key, void *value, void **old_value, bool *false_found, bool deep) {
     /* reach the leaf node, return the new created new_node */
     if (!node) {
-        XListRBTree_Node_PT nnode = xlistrbtree_new_node(key, value, xlistrbtree_color_red);
+        XListRBTree_Node_PT nnode = xlistrbtree_new_node(tree, key, value, xlistrbtree_color_red);
         if (!nnode) {
             *false_found = true;
         }
         else {
-            nnode->parent = parent;
+            xlistrbtree_node_set_parent(nnode, parent);
         }
         return nnode;
     }
@@ -646,23 +824,24 @@ XListRBTree_Node_PT xlistrbtree_put_replace_impl(XListRBTree_PT tree, XListRBTre
     {
         int ret = tree->cmp(key, node->key, tree->cl);
         if (ret == 0) {
-            if (node->values) {
+            if (0 < node->values.count) {
+                void **front = &xlistrbtree_values_array(&node->values)[node->values.count - 1];
                 if (value) {
                     if (deep) {
-                        XMEM_FREE(node->values->value);
+                        XMEM_FREE(*front);
                     }
                     else if (old_value) {
-                        *old_value = node->values->value;
+                        *old_value = *front;
                     }
-                    node->values->value = value;
+                    *front = value;
                 }
                 else {                    
-                    void* t = xrslist_pop_front(&node->values);
+                    void* t = xlistrbtree_values_pop_kth(tree->allocator, &node->values, 0);
                     if (old_value) {
                         *old_value = t;
                     }
 
-                    if (node->values) {
+                    if (0 < node->values.count) {
                         --node->node_size;
                         --node->size;
                     }
@@ -670,8 +849,7 @@ XListRBTree_Node_PT xlistrbtree_put_replace_impl(XListRBTree_PT tree, XListRBTre
             }
             else {
                 if (value) {
-                    node->values = xrslist_new(value);
-                    if (!node->values) {
+                    if (!xlistrbtree_values_push_front(tree->allocator, &node->values, value)) {
                         *false_found = true;
                     }
                 }
@@ -706,7 +884,7 @@ bool xlistrbtree_put_replace(XListRBTree_PT tree, void *key, void *value, void *
 
         tree->root = xlistrbtree_put_replace_impl(tree, NULL, tree->root, key, value, old_value, &false_found, false);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return !false_found;
@@ -726,7 +904,7 @@ bool xlistrbtree_put_deep_replace(XListRBTree_PT tree, void *key, void *value) {
 
         tree->root = xlistrbtree_put_replace_impl(tree, NULL, tree->root, key, value, NULL, &false_found, true);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return !false_found;
@@ -735,14 +913,14 @@ bool xlistrbtree_put_deep_replace(XListRBTree_PT tree, void *key, void *value) {
 
 void xlistrbtree_key_unique(XListRBTree_PT tree, void *key) {
     XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
-    if (node && node->values) {
-        int count = xrslist_free_except_front(node->values);
+    if (node) {
+        int count = xlistrbtree_values_free_except_front(tree->allocator, &node->values);
         if (0 < count) {
             node->node_size = 1;
 
             while (node) {
                 node->size -= count;
-                node = node->parent;
+                node = xlistrbtree_node_parent(node);
             }
         }
     }
@@ -773,12 +951,12 @@ bool xlistrbtree_unique_impl(XListRBTree_PT tree, XListRBTree_PT set) {
         //uniq the keys at first
         XListRBTree_Node_PT node = xlistrbtree_min_impl(tree, tree->root);
         while (node) {
-            if (node->values) {
-                if (1 <= xrslist_free_except_front(node->values)) {
+            if (0 < node->values.count) {
+                if (1 <= xlistrbtree_values_free_except_front(tree->allocator, &node->values)) {
                     node->node_size = 1;
                     updated = true;
 
-                    if (set && !xlistrbtree_put_repeat(set, xrslist_front(node->values), xrslist_front(node->values))) {
+                    if (set && !xlistrbtree_put_repeat(set, xlistrbtree_values_front(&node->values), xlistrbtree_values_front(&node->values))) {
                         xlistrbtree_unique_correct_size_impl(tree, tree->root);
                         return false;
                     }
@@ -807,7 +985,7 @@ XListRBTree_PT xlistrbtree_unique_return_uniqued(XListRBTree_PT tree) {
     }
 
     {
-        XListRBTree_PT set = xlistrbtree_new(tree->cmp, tree->cl);
+        XListRBTree_PT set = xlistrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
         if (!set) {
             return NULL;
         }
@@ -833,12 +1011,12 @@ bool xlistrbtree_unique_except_impl(XListRBTree_PT tree, void *key, XListRBTree_
         //uniq the keys at first
         XListRBTree_Node_PT node = xlistrbtree_min_impl(tree, tree->root);
         while (node) {
-            if (node->values && (0 != tree->cmp(key, xrslist_front(node->values), tree->cl))) {
-                if (1 <= xrslist_free_except_front(node->values)) {
+            if ((0 < node->values.count) && (0 != tree->cmp(key, xlistrbtree_values_front(&node->values), tree->cl))) {
+                if (1 <= xlistrbtree_values_free_except_front(tree->allocator, &node->values)) {
                     node->node_size = 1;
                     updated = true;
 
-                    if (set && !xlistrbtree_put_repeat(set, xrslist_front(node->values), xrslist_front(node->values))) {
+                    if (set && !xlistrbtree_put_repeat(set, xlistrbtree_values_front(&node->values), xlistrbtree_values_front(&node->values))) {
                         xlistrbtree_unique_correct_size_impl(tree, tree->root);
                         return false;
                     }
@@ -867,7 +1045,7 @@ XListRBTree_PT xlistrbtree_unique_except_return_uniqued(XListRBTree_PT tree, voi
     }
 
     {
-        XListRBTree_PT set = xlistrbtree_new(tree->cmp, tree->cl);
+        XListRBTree_PT set = xlistrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
         if (!set) {
             return NULL;
         }
@@ -884,7 +1062,7 @@ XListRBTree_PT xlistrbtree_unique_except_return_uniqued(XListRBTree_PT tree, voi
 bool xlistrbtree_has_repeat_keys_except(XListRBTree_PT tree, void *key) {
     XListRBTree_Node_PT node = xlistrbtree_min_impl(tree, (tree ? tree->root : NULL));
     while (node) {
-        if (node->values && (0 != tree->cmp(key, xrslist_front(node->values), tree->cl))) {
+        if ((0 < node->values.count) && (0 != tree->cmp(key, xlistrbtree_values_front(&node->values), tree->cl))) {
             if (1 < node->node_size) {
                 return true;
             }
@@ -901,7 +1079,7 @@ int xlistrbtree_repeat_keys_size_except(XListRBTree_PT tree, void *key) {
 
     XListRBTree_Node_PT node = xlistrbtree_min_impl(tree, (tree ? tree->root : NULL));
     while (node) {
-        if (node->values && (0 != tree->cmp(key, xrslist_front(node->values), tree->cl))) {
+        if ((0 < node->values.count) && (0 != tree->cmp(key, xlistrbtree_values_front(&node->values), tree->cl))) {
             if (1 < node->node_size) {
                 count += node->node_size;
             }
@@ -956,7 +1134,6 @@ void* xlistrbtree_floor(XListRBTree_PT tree, void *key) {
     return floor ? floor->key : NULL;
 }
 
-static
 XListRBTree_Node_PT xlistrbtree_ceiling_impl(XListRBTree_PT tree, XListRBTree_Node_PT node, void *key) {
     if (!key) {
         return NULL;
@@ -989,7 +1166,6 @@ void* xlistrbtree_ceiling(XListRBTree_PT tree, void *key) {
     return ceiling ? ceiling->key : NULL;
 }
 
-static 
 XListRBTree_Node_PT xlistrbtree_select_impl(XListRBTree_PT tree, XListRBTree_Node_PT node, int k) {
     while (node) {
         int t = node->left ? node->left->size : 0;
@@ -1032,7 +1208,7 @@ void* xlistrbtree_select(XListRBTree_PT tree, int k) {
 }
 
 static
-bool xlistrbtree_node_value_replace_impl(XListRBTree_Node_PT node, int k, void *value, void **old_value, bool deep) {
+bool xlistrbtree_node_value_replace_impl(XListRBTree_PT tree, XListRBTree_Node_PT node, int k, void *value, void **old_value, bool deep) {
     xassert(node);
 
     if (!node) {
@@ -1042,19 +1218,19 @@ bool xlistrbtree_node_value_replace_impl(XListRBTree_Node_PT node, int k, void *
     {
         bool size_change = false;
 
-        if (node->values) {
-            XRSList_PT tnode = xrslist_get_kth(node->values, k);
+        if (0 < node->values.count) {
+            void **kth = &xlistrbtree_values_array(&node->values)[node->values.count - 1 - k];
             if (value) {
                 if (deep) {
-                    XMEM_FREE(tnode->value);
+                    XMEM_FREE(*kth);
                 }
                 else if (old_value) {
-                    *old_value = tnode->value;
+                    *old_value = *kth;
                 }
-                tnode->value = value;
+                *kth = value;
             }
             else {
-                void* t = xrslist_pop_kth(&node->values, k);
+                void* t = xlistrbtree_values_pop_kth(tree->allocator, &node->values, k);
                 if (old_value) {
                     *old_value = t;
                 }
@@ -1062,7 +1238,7 @@ bool xlistrbtree_node_value_replace_impl(XListRBTree_Node_PT node, int k, void *
                 if (deep) {
                     XMEM_FREE(*old_value);
                 }
-                if (node->values) {
+                if (0 < node->values.count) {
                     --node->node_size;
                     --node->size;
                     size_change = true;
@@ -1071,8 +1247,7 @@ bool xlistrbtree_node_value_replace_impl(XListRBTree_Node_PT node, int k, void *
         }
         else {
             if (value) {
-                node->values = xrslist_new(value);
-                if (!node->values) {
+                if (!xlistrbtree_values_push_front(tree->allocator, &node->values, value)) {
                     return false;
                 }
             }
@@ -1080,10 +1255,10 @@ bool xlistrbtree_node_value_replace_impl(XListRBTree_Node_PT node, int k, void *
 
         /* correct the node size */
         if (size_change) {
-            node = node->parent;
+            node = xlistrbtree_node_parent(node);
             while (node) {
                 --node->size;
-                node = node->parent;
+                node = xlistrbtree_node_parent(node);
             }
         }
     }
@@ -1100,7 +1275,7 @@ bool xlistrbtree_index_replace(XListRBTree_PT tree, int k, void *value, void **o
     }
 
     XListRBTree_Node_PT node = xlistrbtree_select_impl(tree, (tree ? tree->root : NULL), k);
-    return xlistrbtree_node_value_replace_impl(node, (k - (node->left ? node->left->size : 0)), value, old_value, false);
+    return xlistrbtree_node_value_replace_impl(tree, node, (k - (node->left ? node->left->size : 0)), value, old_value, false);
 }
 
 bool xlistrbtree_index_deep_replace(XListRBTree_PT tree, int k, void *value) {
@@ -1112,7 +1287,7 @@ bool xlistrbtree_index_deep_replace(XListRBTree_PT tree, int k, void *value) {
     }
 
     XListRBTree_Node_PT node = xlistrbtree_select_impl(tree, (tree ? tree->root : NULL), k);
-    return xlistrbtree_node_value_replace_impl(node, (k - (node->left ? node->left->size : 0)), value, NULL, true);
+    return xlistrbtree_node_value_replace_impl(tree, node, (k - (node->left ? node->left->size : 0)), value, NULL, true);
 }
 
 static
@@ -1148,20 +1323,51 @@ int xlistrbtree_rank(XListRBTree_PT tree, void *key) {
 
 void* xlistrbtree_get(XListRBTree_PT tree, void *key) {
     XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
-    return node ? (node->values ? node->values->value : NULL) : NULL;
+    return node ? xlistrbtree_values_front(&node->values) : NULL;
 }
 
 XSList_PT xlistrbtree_get_all(XListRBTree_PT tree, void *key) {
-    XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
-    if (node) {
-        XRSList_PT list = xrslist_copy(node->values);
+    int count = 0;
+    void **values = xlistrbtree_get_all_view(tree, key, &count);
+    if (!values) {
+        return NULL;
+    }
+
+    {
+        XSList_PT list = xslist_new();
         if (!list) {
             return NULL;
         }
-        return xslist_new_with_rslist(list);
+
+        /* from the front one to the back one */
+        for (int i = count - 1; 0 <= i; --i) {
+            if (!xslist_push_back_repeat(list, values[i])) {
+                xslist_free(&list);
+                return NULL;
+            }
+        }
+
+        return list;
     }
+}
 
-    return NULL;
+void** xlistrbtree_get_all_view(XListRBTree_PT tree, void *key, int *count) {
+    xassert(count);
+
+    if (!count) {
+        return NULL;
+    }
+
+    {
+        XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
+        if (!node || (node->values.count == 0)) {
+            *count = 0;
+            return NULL;
+        }
+
+        *count = node->values.count;
+        return xlistrbtree_values_array(&node->values);
+    }
 }
 
 bool xlistrbtree_find(XListRBTree_PT tree, void *key) {
@@ -1170,12 +1376,12 @@ bool xlistrbtree_find(XListRBTree_PT tree, void *key) {
 
 bool xlistrbtree_find_replace(XListRBTree_PT tree, void *key, void *value, void **old_value) {
     XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
-    return xlistrbtree_node_value_replace_impl(node, 0, value, old_value, false);
+    return xlistrbtree_node_value_replace_impl(tree, node, 0, value, old_value, false);
 }
 
 bool xlistrbtree_find_deep_replace(XListRBTree_PT tree, void *key, void *value) {
     XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, (tree ? tree->root : NULL), key);
-    return xlistrbtree_node_value_replace_impl(node, 0, value, NULL, true);
+    return xlistrbtree_node_value_replace_impl(tree, node, 0, value, NULL, true);
 }
 
 XSList_PT xlistrbtree_keys_impl(XListRBTree_PT tree, void *low, void *high) {
@@ -1228,12 +1434,9 @@ void xlistrbtree_free_impl(XListRBTree_PT tree, XListRBTree_Node_PT node, bool d
 
     if (deep) {
         XMEM_FREE(node->key);
-        xrslist_deep_free(&node->values);
     }
-    else {
-        xrslist_free(&node->values);
-    }
-    XMEM_FREE(node);
+    xlistrbtree_values_free(tree->allocator, &node->values, deep);
+    XMEM_FREE_BY(tree->allocator, node, sizeof(*node));
 }
 
 void xlistrbtree_clear(XListRBTree_PT tree) {
@@ -1256,7 +1459,7 @@ void xlistrbtree_free(XListRBTree_PT *ptree) {
     }
 
     xlistrbtree_free_impl(*ptree, (*ptree)->root, false, NULL, NULL);
-    XMEM_FREE(*ptree);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
 }
 
 void xlistrbtree_deep_free(XListRBTree_PT *ptree) {
@@ -1265,7 +1468,104 @@ void xlistrbtree_deep_free(XListRBTree_PT *ptree) {
     }
 
     xlistrbtree_free_impl(*ptree, (*ptree)->root, true, NULL, NULL);
-    XMEM_FREE(*ptree);
+    XMEM_FREE_BY((*ptree)->allocator, *ptree, sizeof(**ptree));
+}
+
+/* build the balanced tree with the next n distinct keys from keys[*pos], all the "same" keys are saved in one node,
+ * only the nodes at the deepest level (red_depth) are red
+ */
+static
+XListRBTree_Node_PT xlistrbtree_build_sorted_impl(XListRBTree_PT tree, XListRBTree_Node_PT parent, void **keys, void **values, int count, int *pos, int n, int depth, int red_depth, bool *false_found) {
+    if (n <= 0) {
+        return NULL;
+    }
+
+    {
+        XListRBTree_Node_PT node = XMEM_ALLOC_BY(tree->allocator, sizeof(*node));
+        if (!node) {
+            *false_found = true;
+            return NULL;
+        }
+
+        xlistrbtree_node_set_parent(node, parent);
+        xlistrbtree_node_set_color(node, ((0 < depth) && (depth == red_depth)) ? xlistrbtree_color_red : xlistrbtree_color_black);
+
+        node->left = xlistrbtree_build_sorted_impl(tree, node, keys, values, count, pos, (n - 1) / 2, depth + 1, red_depth, false_found);
+        if (*false_found) {
+            xlistrbtree_free_impl(tree, node, false, NULL, NULL);
+            return NULL;
+        }
+
+        /* the same way as xlistrbtree_put_repeat : values are pushed to the front one by one */
+        node->key = keys[*pos];
+        node->node_size = 1;
+        for (int start = *pos; (*pos < count) && (tree->cmp(keys[start], keys[*pos], tree->cl) == 0); ++*pos) {
+            if (!values || !values[*pos]) {
+                continue;
+            }
+
+            if (!xlistrbtree_values_push_front(tree->allocator, &node->values, values[*pos])) {
+                *false_found = true;
+                break;
+            }
+            if (1 < node->values.count) {
+                ++node->node_size;
+            }
+        }
+
+        if (!*false_found) {
+            node->right = xlistrbtree_build_sorted_impl(tree, node, keys, values, count, pos, n - 1 - (n - 1) / 2, depth + 1, red_depth, false_found);
+        }
+
+        if (*false_found) {
+            xlistrbtree_free_impl(tree, node, false, NULL, NULL);
+            return NULL;
+        }
+
+        node->size = node->node_size + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
+
+        return node;
+    }
+}
+
+bool xlistrbtree_build_sorted(XListRBTree_PT tree, void **keys, void **values, int count) {
+    xassert(tree);
+    xassert(!tree->root);
+    xassert(keys || (count == 0));
+    xassert(0 <= count);
+
+    if (!tree || tree->root || (!keys && (0 < count)) || (count < 0)) {
+        return false;
+    }
+
+    {
+        /* distinct keys number */
+        int nodes = (0 < count) ? 1 : 0;
+
+        for (int i = 1; i < count; ++i) {
+            int ret = tree->cmp(keys[i - 1], keys[i], tree->cl);
+            if (0 < ret) {
+                return false;
+            }
+            if (ret < 0) {
+                ++nodes;
+            }
+        }
+
+        {
+            int red_depth = 0;
+            for (int n = nodes; 1 < n; n /= 2) {
+                ++red_depth;
+            }
+
+            {
+                bool false_found = false;
+                int pos = 0;
+                tree->root = xlistrbtree_build_sorted_impl(tree, NULL, keys, values, count, &pos, nodes, 0, red_depth, &false_found);
+                return !false_found;
+            }
+        }
+    }
 }
 
 /* move one key from node_N's right branch to left branch :
@@ -1412,14 +1712,14 @@ XListRBTree_Node_PT xlistrbtree_remove_min_impl(XListRBTree_PT tree, XListRBTree
     if (!node_N->left) {
         XListRBTree_Node_PT right = node_N->right;
 
-        if (node_N->values) {
-            void* ovalue = xrslist_pop_front(&node_N->values);
+        if (0 < node_N->values.count) {
+            void* ovalue = xlistrbtree_values_pop_kth(tree->allocator, &node_N->values, 0);
             --node_N->node_size;
             --node_N->size;
 
             if (deep) {
                 XMEM_FREE(ovalue);
-                if (!node_N->values) {
+                if (node_N->values.count == 0) {
                     XMEM_FREE(node_N->key);
                 }
             }
@@ -1441,16 +1741,16 @@ XListRBTree_Node_PT xlistrbtree_remove_min_impl(XListRBTree_PT tree, XListRBTree
             }
         }
 
-        if (!node_N->values) {
+        if (node_N->values.count == 0) {
             if (right) {
-                right->parent = node_N->parent;
+                xlistrbtree_node_set_parent(right, xlistrbtree_node_parent(node_N));
                 /* keep the black node numbers not changed */
                 if (xlistrbtree_node_color_black(node_N)) {
-                    right->color = node_N->color;
+                    xlistrbtree_node_set_color(right, xlistrbtree_node_color(node_N));
                 }
             }
 
-            XMEM_FREE(node_N);
+            XMEM_FREE_BY(tree->allocator, node_N, sizeof(*node_N));
             return right;
         }
 
@@ -1520,12 +1820,12 @@ void xlistrbtree_remove_min(XListRBTree_PT tree) {
     }
 
     if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xlistrbtree_color_red;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
     }
 
     tree->root = xlistrbtree_remove_min_impl(tree, tree->root, NULL, NULL, false);
     if (tree->root) {
-        tree->root->color = xlistrbtree_color_black;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
     }
 }
 
@@ -1537,12 +1837,12 @@ void xlistrbtree_remove_save_min(XListRBTree_PT tree, void **key, void **value)
     }
 
     if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xlistrbtree_color_red;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
     }
 
     tree->root = xlistrbtree_remove_min_impl(tree, tree->root, key, value, false);
     if (tree->root) {
-        tree->root->color = xlistrbtree_color_black;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
     }
 }
 
@@ -1554,12 +1854,12 @@ void xlistrbtree_deep_remove_min(XListRBTree_PT tree) {
     }
 
     if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xlistrbtree_color_red;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
     }
 
     tree->root = xlistrbtree_remove_min_impl(tree, tree->root, NULL, NULL, true);
     if (tree->root) {
-        tree->root->color = xlistrbtree_color_black;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
     }
 }
 
@@ -1569,14 +1869,14 @@ XListRBTree_Node_PT xlistrbtree_remove_max_impl(XListRBTree_PT tree, XListRBTree
     if (!node_N->right) {
         XListRBTree_Node_PT left = node_N->left;
 
-        if (node_N->values) {
-            void* ovalue = xrslist_pop_front(&node_N->values);
+        if (0 < node_N->values.count) {
+            void* ovalue = xlistrbtree_values_pop_kth(tree->allocator, &node_N->values, 0);
             --node_N->node_size;
             --node_N->size;
 
             if (deep) {
                 XMEM_FREE(ovalue);
-                if (!node_N->values) {
+                if (node_N->values.count == 0) {
                     XMEM_FREE(node_N->key);
                 }
             }
@@ -1598,16 +1898,16 @@ XListRBTree_Node_PT xlistrbtree_remove_max_impl(XListRBTree_PT tree, XListRBTree
             }
         }
 
-        if (!node_N->values) {
+        if (node_N->values.count == 0) {
             if (left) {
-                left->parent = node_N->parent;
+                xlistrbtree_node_set_parent(left, xlistrbtree_node_parent(node_N));
                 /* keep the black node numbers not changed */
                 if (xlistrbtree_node_color_black(node_N)) {
-                    left->color = node_N->color;
+                    xlistrbtree_node_set_color(left, xlistrbtree_node_color(node_N));
                 }
             }
 
-            XMEM_FREE(node_N);
+            XMEM_FREE_BY(tree->allocator, node_N, sizeof(*node_N));
             return left;
         }
 
@@ -1678,12 +1978,12 @@ void xlistrbtree_remove_max(XListRBTree_PT tree) {
     }
 
     if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xlistrbtree_color_red;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
     }
 
     tree->root = xlistrbtree_remove_max_impl(tree, tree->root, NULL, NULL, false);
     if (tree->root) {
-        tree->root->color = xlistrbtree_color_black;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
     }
 }
 
@@ -1695,12 +1995,12 @@ void xlistrbtree_remove_save_max(XListRBTree_PT tree, void **key, void **value)
     }
 
     if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xlistrbtree_color_red;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
     }
 
     tree->root = xlistrbtree_remove_max_impl(tree, tree->root, key, value, false);
     if (tree->root) {
-        tree->root->color = xlistrbtree_color_black;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
     }
 }
 
@@ -1712,34 +2012,34 @@ void xlistrbtree_deep_remove_max(XListRBTree_PT tree) {
     }
 
     if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-        tree->root->color = xlistrbtree_color_red;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
     }
 
     tree->root = xlistrbtree_remove_max_impl(tree, tree->root, NULL, NULL, true);
     if (tree->root) {
-        tree->root->color = xlistrbtree_color_black;
+        xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
     }
 }
 
 static
-XListRBTree_Node_PT xlistrbtree_remove_min_node_impl(XListRBTree_PT tree, XListRBTree_Node_PT node_N, void **old_key, XRSList_PT* old_values, int *size) {
+XListRBTree_Node_PT xlistrbtree_remove_min_node_impl(XListRBTree_PT tree, XListRBTree_Node_PT node_N, void **old_key, XListRBTree_Values_PT old_values, int *size) {
     /* if node has no left branch, node is the mimimum one */
     if (!node_N->left) {
         XListRBTree_Node_PT right = node_N->right;
 
         *old_key = node_N->key;
-        *old_values = node_N->values;
+        *old_values = node_N->values;  /* the values are moved to "old_values" */
         *size = node_N->node_size;
 
         if (right) {
-            right->parent = node_N->parent;
+            xlistrbtree_node_set_parent(right, xlistrbtree_node_parent(node_N));
             /* keep the black node numbers not changed */
             if (xlistrbtree_node_color_black(node_N)) {
-                right->color = node_N->color;
+                xlistrbtree_node_set_color(right, xlistrbtree_node_color(node_N));
             }
         }
 
-        XMEM_FREE(node_N);
+        XMEM_FREE_BY(tree->allocator, node_N, sizeof(*node_N));
         return right;
     }
 
@@ -1810,8 +2110,8 @@ XListRBTree_Node_PT xlistrbtree_remove_impl(XListRBTree_PT tree, XListRBTree_Nod
         int ret = tree->cmp(key, node_N->key, tree->cl);
         if (ret == 0) {
             /* 1. more than one value exist */
-            if (node_N->values && node_N->values->next && !remove_all) {
-                void* ovalue = xrslist_pop_front(&node_N->values);
+            if ((1 < node_N->values.count) && !remove_all) {
+                void* ovalue = xlistrbtree_values_pop_kth(tree->allocator, &node_N->values, 0);
                 --node_N->node_size;
                 --node_N->size;
 
@@ -1829,22 +2129,20 @@ XListRBTree_Node_PT xlistrbtree_remove_impl(XListRBTree_PT tree, XListRBTree_Nod
             if (!node_N->left || !node_N->right) {
                 XListRBTree_Node_PT ret_node = node_N->left ? node_N->left : node_N->right;
                 if (ret_node) {
-                    ret_node->parent = node_N->parent;
+                    xlistrbtree_node_set_parent(ret_node, xlistrbtree_node_parent(node_N));
                     /* keep the black node numbers not changed */
                     if (xlistrbtree_node_color_black(node_N)) {
-                        ret_node->color = node_N->color;
+                        xlistrbtree_node_set_color(ret_node, xlistrbtree_node_color(node_N));
                     }
                 }
 
                 if (remove_all) {
-                    if (node_N->values) {
-                        deep ? xrslist_deep_free(&node_N->values) : xrslist_free(&node_N->values);
-                    }
+                    xlistrbtree_values_free(tree->allocator, &node_N->values, deep);
                 }
                 else {
                     /* one value exist */
-                    if (node_N->values) {
-                        void* ovalue = xrslist_pop_front(&node_N->values);
+                    if (0 < node_N->values.count) {
+                        void* ovalue = xlistrbtree_values_pop_kth(tree->allocator, &node_N->values, 0);
 
                         if (deep) {
                             XMEM_FREE(ovalue);
@@ -1858,7 +2156,7 @@ XListRBTree_Node_PT xlistrbtree_remove_impl(XListRBTree_PT tree, XListRBTree_Nod
                 if (deep && !for_set) {
                     XMEM_FREE(node_N->key);
                 }
-                XMEM_FREE(node_N);
+                XMEM_FREE_BY(tree->allocator, node_N, sizeof(*node_N));
 
                 return ret_node;
             }
@@ -1921,18 +2219,16 @@ XListRBTree_Node_PT xlistrbtree_remove_impl(XListRBTree_PT tree, XListRBTree_Nod
                     /* delete the min key of node_N->right */
                     int node_size = 0;
                     void *min_key = NULL;
-                    XRSList_PT min_values = NULL;
+                    XListRBTree_Values_T min_values = { { { NULL } }, 0, 0 };
                     node_N->right = xlistrbtree_remove_min_node_impl(tree, node_N->right, &min_key, &min_values, &node_size);
 
                     if (remove_all) {
-                        if (node_N->values) {
-                            deep ? xrslist_deep_free(&node_N->values) : xrslist_free(&node_N->values);
-                        }
+                        xlistrbtree_values_free(tree->allocator, &node_N->values, deep);
                     }
                     else {
                         /* one value exist */
-                        if (node_N->values) {
-                            void* ovalue = xrslist_pop_front(&node_N->values);
+                        if (0 < node_N->values.count) {
+                            void* ovalue = xlistrbtree_values_pop_kth(tree->allocator, &node_N->values, 0);
 
                             if (deep) {
                                 XMEM_FREE(ovalue);
@@ -2082,12 +2378,12 @@ int xlistrbtree_remove(XListRBTree_PT tree, void *key) {
         int total = tree->root->size;
 
         if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xlistrbtree_color_red;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
         }
 
         tree->root = xlistrbtree_remove_impl(tree, tree->root, key, NULL, false, false, false);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return (total - xlistrbtree_size(tree));
@@ -2103,12 +2399,12 @@ int xlistrbtree_remove_all(XListRBTree_PT tree, void *key) {
         int total = tree->root->size;
 
         if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xlistrbtree_color_red;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
         }
 
         tree->root = xlistrbtree_remove_impl(tree, tree->root, key, NULL, false, true, false);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return (total - xlistrbtree_size(tree));
@@ -2124,12 +2420,12 @@ int xlistrbtree_remove_save(XListRBTree_PT tree, void *key, void **value) {
         int total = tree->root->size;
 
         if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xlistrbtree_color_red;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
         }
 
         tree->root = xlistrbtree_remove_impl(tree, tree->root, key, value, false, false, false);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return (total - xlistrbtree_size(tree));
@@ -2145,12 +2441,12 @@ int xlistrbtree_deep_remove_impl(XListRBTree_PT tree, void *key, bool remove_all
         int total = tree->root->size;
 
         if (xlistrbtree_node_color_black(tree->root->left) && xlistrbtree_node_color_black(tree->root->right)) {
-            tree->root->color = xlistrbtree_color_red;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_red);
         }
 
         tree->root = xlistrbtree_remove_impl(tree, tree->root, key, NULL, true, remove_all, for_set);
         if (tree->root) {
-            tree->root->color = xlistrbtree_color_black;
+            xlistrbtree_node_set_color(tree->root, xlistrbtree_color_black);
         }
 
         return (total - xlistrbtree_size(tree));
@@ -2165,6 +2461,301 @@ int xlistrbtree_deep_remove_all(XListRBTree_PT tree, void *key) {
     return xlistrbtree_deep_remove_impl(tree, key, true, false);
 }
 
+/* the number of black nodes from node to its leaves */
+static
+int xlistrbtree_black_height(XListRBTree_Node_PT node) {
+    int height = 0;
+
+    for (; node; node = node->left) {
+        if (xlistrbtree_node_color_black(node)) {
+            ++height;
+        }
+    }
+
+    return height;
+}
+
+/* fix the "red-red" nodes from the new red node up to the root, returns the new root */
+static
+XListRBTree_Node_PT xlistrbtree_join_fixup(XListRBTree_Node_PT root, XListRBTree_Node_PT node) {
+    while (xlistrbtree_node_color_red(xlistrbtree_node_parent(node))) {
+        XListRBTree_Node_PT parent = xlistrbtree_node_parent(node);
+        XListRBTree_Node_PT grand = xlistrbtree_node_parent(parent);  /* parent is red, so it's not the root */
+        XListRBTree_Node_PT uncle = (parent == grand->left) ? grand->right : grand->left;
+
+        if (xlistrbtree_node_color_red(uncle)) {
+            xlistrbtree_node_set_color(parent, xlistrbtree_color_black);
+            xlistrbtree_node_set_color(uncle, xlistrbtree_color_black);
+            xlistrbtree_node_set_color(grand, xlistrbtree_color_red);
+            node = grand;
+            continue;
+        }
+
+        /* rotations keep the black color on the top node, and make the other one red */
+        if (parent == grand->left) {
+            if (node == parent->right) {
+                xlistrbtree_rotate_left(parent);
+            }
+            node = xlistrbtree_rotate_right(grand);
+        }
+        else {
+            if (node == parent->left) {
+                xlistrbtree_rotate_right(parent);
+            }
+            node = xlistrbtree_rotate_left(grand);
+        }
+
+        if (!xlistrbtree_node_parent(node)) {
+            root = node;
+        }
+        break;
+    }
+
+    return root;
+}
+
+/* join the trees "left", "mid" and "right" (all keys of left <= mid->key <= all keys of right) :
+*    the roots of left and right must be black, left_height and right_height are their black heights
+*    *height saves the black height of the joined tree
+*    O(|left_height - right_height| + 1)
+*/
+static
+XListRBTree_Node_PT xlistrbtree_join_impl(XListRBTree_Node_PT left, int left_height, XListRBTree_Node_PT mid, XListRBTree_Node_PT right, int right_height, int *height) {
+    if (left_height == right_height) {
+        mid->left = left;
+        mid->right = right;
+        xlistrbtree_node_set_parent(mid, NULL);
+        xlistrbtree_node_set_color(mid, xlistrbtree_color_black);
+        mid->size = mid->node_size + (left ? left->size : 0) + (right ? right->size : 0);
+
+        if (left) {
+            xlistrbtree_node_set_parent(left, mid);
+        }
+        if (right) {
+            xlistrbtree_node_set_parent(right, mid);
+        }
+
+        *height = left_height + 1;
+        return mid;
+    }
+
+    {
+        /* walk down the right side of the higher left tree (or the left side of the higher right tree) */
+        bool higher_right = (left_height < right_height);
+
+        XListRBTree_Node_PT root = higher_right ? right : left;
+        XListRBTree_Node_PT parent = NULL;
+        XListRBTree_Node_PT node = root;
+
+        int node_height = higher_right ? right_height : left_height;
+        int lower_height = higher_right ? left_height : right_height;
+
+        /* find the black node which has the same black height as the lower tree */
+        while (xlistrbtree_node_color_red(node) || (lower_height < node_height)) {
+            if (xlistrbtree_node_color_black(node)) {
+                --node_height;
+            }
+
+            parent = node;
+            node = higher_right ? node->left : node->right;
+        }
+
+        xlistrbtree_node_set_color(mid, xlistrbtree_color_red);
+        xlistrbtree_node_set_parent(mid, parent);
+        if (higher_right) {
+            mid->left = left;
+            mid->right = node;
+            parent->left = mid;
+        }
+        else {
+            mid->left = node;
+            mid->right = right;
+            parent->right = mid;
+        }
+
+        if (mid->left) {
+            xlistrbtree_node_set_parent(mid->left, mid);
+        }
+        if (mid->right) {
+            xlistrbtree_node_set_parent(mid->right, mid);
+        }
+
+        for (XListRBTree_Node_PT step = mid; step; step = xlistrbtree_node_parent(step)) {
+            step->size = step->node_size + (step->left ? step->left->size : 0) + (step->right ? step->right->size : 0);
+        }
+
+        root = xlistrbtree_join_fixup(root, mid);
+
+        *height = higher_right ? right_height : left_height;
+        if (xlistrbtree_node_color_red(root)) {
+            xlistrbtree_node_set_color(root, xlistrbtree_color_black);
+            ++*height;
+        }
+
+        return root;
+    }
+}
+
+/* take the children of node away as two trees with black roots */
+static
+void xlistrbtree_split_children(XListRBTree_Node_PT node, int height, XListRBTree_Node_PT *left, int *left_height, XListRBTree_Node_PT *right, int *right_height) {
+    int child_height = height - (xlistrbtree_node_color_black(node) ? 1 : 0);
+
+    *left = node->left;
+    *right = node->right;
+    *left_height = child_height;
+    *right_height = child_height;
+
+    if (*left) {
+        xlistrbtree_node_set_parent((*left), NULL);
+        if (xlistrbtree_node_color_red(*left)) {
+            xlistrbtree_node_set_color((*left), xlistrbtree_color_black);
+            ++*left_height;
+        }
+    }
+
+    if (*right) {
+        xlistrbtree_node_set_parent((*right), NULL);
+        if (xlistrbtree_node_color_red(*right)) {
+            xlistrbtree_node_set_color((*right), xlistrbtree_color_black);
+            ++*right_height;
+        }
+    }
+
+    node->left = NULL;
+    node->right = NULL;
+}
+
+/* split the tree into *left (keys < key, or keys <= key if "upper" is true) and *right, O(lgN) */
+static
+void xlistrbtree_split_impl(XListRBTree_PT tree, XListRBTree_Node_PT node, int height, void *key, bool upper, XListRBTree_Node_PT *left, int *left_height, XListRBTree_Node_PT *right, int *right_height) {
+    if (!node) {
+        *left = NULL;
+        *right = NULL;
+        *left_height = 0;
+        *right_height = 0;
+        return;
+    }
+
+    {
+        XListRBTree_Node_PT lchild = NULL, rchild = NULL, middle = NULL;
+        int lchild_height = 0, rchild_height = 0, middle_height = 0;
+
+        int ret = tree->cmp(node->key, key, tree->cl);
+
+        xlistrbtree_split_children(node, height, &lchild, &lchild_height, &rchild, &rchild_height);
+
+        if ((ret < 0) || (upper && (ret == 0))) {
+            xlistrbtree_split_impl(tree, rchild, rchild_height, key, upper, &middle, &middle_height, right, right_height);
+            *left = xlistrbtree_join_impl(lchild, lchild_height, node, middle, middle_height, left_height);
+        }
+        else {
+            xlistrbtree_split_impl(tree, lchild, lchild_height, key, upper, left, left_height, &middle, &middle_height);
+            *right = xlistrbtree_join_impl(middle, middle_height, node, rchild, rchild_height, right_height);
+        }
+    }
+}
+
+/* split the max node away from the tree, *rest saves the other nodes, O(lgN) */
+static
+XListRBTree_Node_PT xlistrbtree_split_max_impl(XListRBTree_Node_PT node, int height, XListRBTree_Node_PT *rest, int *rest_height) {
+    XListRBTree_Node_PT lchild = NULL, rchild = NULL;
+    int lchild_height = 0, rchild_height = 0;
+
+    xlistrbtree_split_children(node, height, &lchild, &lchild_height, &rchild, &rchild_height);
+
+    if (!rchild) {
+        *rest = lchild;
+        *rest_height = lchild_height;
+        return node;
+    }
+
+    {
+        XListRBTree_Node_PT middle = NULL;
+        int middle_height = 0;
+
+        XListRBTree_Node_PT max = xlistrbtree_split_max_impl(rchild, rchild_height, &middle, &middle_height);
+        *rest = xlistrbtree_join_impl(lchild, lchild_height, node, middle, middle_height, rest_height);
+        return max;
+    }
+}
+
+/* join two trees without middle node, O(lgN) */
+static
+XListRBTree_Node_PT xlistrbtree_join2_impl(XListRBTree_Node_PT left, int left_height, XListRBTree_Node_PT right, int right_height, int *height) {
+    if (!left) {
+        *height = right_height;
+        return right;
+    }
+
+    {
+        XListRBTree_Node_PT rest = NULL;
+        int rest_height = 0;
+
+        XListRBTree_Node_PT max = xlistrbtree_split_max_impl(left, left_height, &rest, &rest_height);
+        return xlistrbtree_join_impl(rest, rest_height, max, right, right_height, height);
+    }
+}
+
+XListRBTree_PT xlistrbtree_split(XListRBTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return NULL;
+    }
+
+    {
+        XListRBTree_PT ntree = xlistrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+        if (!ntree) {
+            return NULL;
+        }
+
+        {
+            int left_height = 0, right_height = 0;
+            xlistrbtree_split_impl(tree, tree->root, xlistrbtree_black_height(tree->root), key, false, &tree->root, &left_height, &ntree->root, &right_height);
+        }
+
+        return ntree;
+    }
+}
+
+XListRBTree_PT xlistrbtree_remove_range(XListRBTree_PT tree, void *low, void *high) {
+    xassert(tree);
+    xassert(low);
+    xassert(high);
+
+    if (!tree || !low || !high) {
+        return NULL;
+    }
+
+    if (0 < tree->cmp(low, high, tree->cl)) {
+        void *tmp = low;
+        low = high;
+        high = tmp;
+    }
+
+    {
+        XListRBTree_PT ntree = xlistrbtree_new_allocator(tree->cmp, tree->cl, tree->allocator);
+        if (!ntree) {
+            return NULL;
+        }
+
+        {
+            XListRBTree_Node_PT left = NULL, right = NULL;
+            int left_height = 0, middle_height = 0, right_height = 0, height = 0;
+
+            /* left : keys < low,  ntree : low <= keys <= high,  right : high < keys */
+            xlistrbtree_split_impl(tree, tree->root, xlistrbtree_black_height(tree->root), low, false, &left, &left_height, &right, &right_height);
+            xlistrbtree_split_impl(tree, right, right_height, high, true, &ntree->root, &middle_height, &right, &right_height);
+
+            tree->root = xlistrbtree_join2_impl(left, left_height, right, right_height, &height);
+        }
+
+        return ntree;
+    }
+}
+
 static 
 int xlistrbtree_map_preorder_impl(XListRBTree_PT tree, XListRBTree_Node_PT node, bool (*apply)(void *key, void **value, void *cl), void *cl) {
     if (!node) {
@@ -2174,9 +2765,10 @@ int xlistrbtree_map_preorder_impl(XListRBTree_PT tree, XListRBTree_Node_PT node,
     {
         int count = 0;
 
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                if (apply(node->key, &(step->value), cl)) {
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                if (apply(node->key, &array[i], cl)) {
                     count++;
                 }
             }
@@ -2215,9 +2807,10 @@ int xlistrbtree_map_inorder_impl(XListRBTree_PT tree, XListRBTree_Node_PT node,
 
         count += xlistrbtree_map_inorder_impl(tree, node->left, apply, cl);
 
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                if (apply(node->key, &(step->value), cl)) {
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                if (apply(node->key, &array[i], cl)) {
                     count++;
                 }
             }
@@ -2256,9 +2849,10 @@ int xlistrbtree_map_postorder_impl(XListRBTree_PT tree, XListRBTree_Node_PT node
         count += xlistrbtree_map_postorder_impl(tree, node->left, apply, cl);
         count += xlistrbtree_map_postorder_impl(tree, node->right, apply, cl);
 
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                if (apply(node->key, &(step->value), cl)) {
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                if (apply(node->key, &array[i], cl)) {
                     count++;
                 }
             }
@@ -2306,9 +2900,10 @@ int xlistrbtree_map_levelorder(XListRBTree_PT tree, bool (*apply)(void *key, voi
 
             while (!xfifo_is_empty(fifo)) {
                 XListRBTree_Node_PT node = (XListRBTree_Node_PT)xfifo_pop(fifo);
-                if (node->values) {
-                    for (XRSList_PT step = node->values; step; step = step->next) {
-                        if (apply(node->key, &(step->value), cl)) {
+                if (0 < node->values.count) {
+                    void **array = xlistrbtree_values_array(&node->values);
+                    for (int i = node->values.count - 1; 0 <= i; --i) {
+                        if (apply(node->key, &array[i], cl)) {
                             count++;
                         }
                     }
@@ -2343,9 +2938,10 @@ int xlistrbtree_map_min_to_max_impl(XListRBTree_PT tree, bool (*apply)(void *key
 
     XListRBTree_Node_PT node = xlistrbtree_min_impl(tree, tree ? tree->root : NULL);
     while (node) {
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                if (apply(node->key, &(step->value), cl)) {
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                if (apply(node->key, &array[i], cl)) {
                     ++count;
                 }
             }
@@ -2375,9 +2971,10 @@ int xlistrbtree_map_min_to_max(XListRBTree_PT tree, bool (*apply)(void *key, voi
 bool xlistrbtree_map_min_to_max_break_if_impl(XListRBTree_PT tree, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl) {
     XListRBTree_Node_PT node = xlistrbtree_min_impl(tree, tree ? tree->root : NULL);
     while (node) {
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                bool ret = apply(node->key, &(step->value), cl);
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                bool ret = apply(node->key, &array[i], cl);
                 if (ret && break_true) {
                     return true;
                 }
@@ -2427,9 +3024,10 @@ int xlistrbtree_map_max_to_min_impl(XListRBTree_PT tree, bool (*apply)(void *key
 
     XListRBTree_Node_PT node = xlistrbtree_max_impl(tree, tree ? tree->root : NULL);
     while (node) {
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                if (apply(node->key, &(step->value), cl)) {
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                if (apply(node->key, &array[i], cl)) {
                     ++count;
                 }
             }
@@ -2459,9 +3057,10 @@ int xlistrbtree_map_max_to_min(XListRBTree_PT tree, bool (*apply)(void *key, voi
 bool xlistrbtree_map_max_to_min_break_if_impl(XListRBTree_PT tree, bool break_true, bool (*apply)(void *key, void **value, void *cl), void *cl) {
     XListRBTree_Node_PT node = xlistrbtree_max_impl(tree, tree ? tree->root : NULL);
     while (node) {
-        if (node->values) {
-            for (XRSList_PT step = node->values; step; step = step->next) {
-                bool ret = apply(node->key, &(step->value), cl);
+        if (0 < node->values.count) {
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                bool ret = apply(node->key, &array[i], cl);
                 if (ret && break_true) {
                     return true;
                 }
@@ -2528,9 +3127,10 @@ int xlistrbtree_scope_map_min_to_max(XListRBTree_PT tree, void *low, void *high,
         {
             XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, tree->root, low);
             while (node && (tree->cmp(node->key, high, tree->cl) <= 0)) {
-                if (node->values) {
-                    for (XRSList_PT step = node->values; step; step = step->next) {
-                        if (apply(node->key, &(step->value), cl)) {
+                if (0 < node->values.count) {
+                    void **array = xlistrbtree_values_array(&node->values);
+                    for (int i = node->values.count - 1; 0 <= i; --i) {
+                        if (apply(node->key, &array[i], cl)) {
                             ++count;
                         }
                     }
@@ -2568,9 +3168,10 @@ bool xlistrbtree_scope_map_min_to_max_break_if_true(XListRBTree_PT tree, void *l
         {
             XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, tree->root, low);
             while (node && (tree->cmp(node->key, high, tree->cl) <= 0)) {
-                if (node->values) {
-                    for (XRSList_PT step = node->values; step; step = step->next) {
-                        if (apply(node->key, &(step->value), cl)) {
+                if (0 < node->values.count) {
+                    void **array = xlistrbtree_values_array(&node->values);
+                    for (int i = node->values.count - 1; 0 <= i; --i) {
+                        if (apply(node->key, &array[i], cl)) {
                             return true;
                         }
                     }
@@ -2608,9 +3209,10 @@ bool xlistrbtree_scope_map_min_to_max_break_if_false(XListRBTree_PT tree, void *
         {
             XListRBTree_Node_PT node = xlistrbtree_get_impl(tree, tree->root, low);
             while (node && (tree->cmp(node->key, high, tree->cl) <= 0)) {
-                if (node->values) {
-                    for (XRSList_PT step = node->values; step; step = step->next) {
-                        if (!apply(node->key, &(step->value), cl)) {
+                if (0 < node->values.count) {
+                    void **array = xlistrbtree_values_array(&node->values);
+                    for (int i = node->values.count - 1; 0 <= i; --i) {
+                        if (!apply(node->key, &array[i], cl)) {
                             return true;
                         }
                     }
@@ -2631,8 +3233,9 @@ bool xlistrbtree_scope_map_min_to_max_break_if_false(XListRBTree_PT tree, void *
 bool xlistrbtree_swap(XListRBTree_PT tree1, XListRBTree_PT tree2) {
     xassert(tree1);
     xassert(tree2);
+    xassert(tree1->allocator == tree2->allocator);
 
-    if (!tree1 || !tree2) {
+    if (!tree1 || !tree2 || (tree1->allocator != tree2->allocator)) {
         return false;
     }
 
@@ -2660,23 +3263,23 @@ bool xlistrbtree_swap(XListRBTree_PT tree1, XListRBTree_PT tree2) {
 }
 
 static
-XListRBTree_Node_PT xlistrbtree_merge_repeat_impl(XListRBTree_PT tree, XListRBTree_Node_PT parent, XListRBTree_Node_PT node, void *key, XRSList_PT values, int size, bool *false_found, bool unique) {
+XListRBTree_Node_PT xlistrbtree_merge_repeat_impl(XListRBTree_PT tree, XListRBTree_Node_PT parent, XListRBTree_Node_PT node, void *key, XListRBTree_Values_PT values, int size, bool *false_found, bool unique) {
     /* reach the leaf node, return the new created new_node */
     if (!node) {
-        XRSList_PT nvalues = xrslist_copy(values);
-        if (!nvalues) {
+        XListRBTree_Values_T nvalues = { { { NULL } }, 0, 0 };
+        if (!xlistrbtree_values_copy(tree->allocator, values, &nvalues)) {
             *false_found = true;
             return NULL;
         }
 
         {
-            XListRBTree_Node_PT nnode = xlistrbtree_new_node_with_list(key, nvalues, size, xlistrbtree_color_red);
+            XListRBTree_Node_PT nnode = xlistrbtree_new_node_with_values(tree, key, &nvalues, size, xlistrbtree_color_red);
             if (!nnode) {
-                xrslist_free(&nvalues);
+                xlistrbtree_values_free(tree->allocator, &nvalues, false);
                 *false_found = true;
             }
             else {
-                nnode->parent = parent;
+                xlistrbtree_node_set_parent(nnode, parent);
             }
             return nnode;
         }
@@ -2689,18 +3292,11 @@ XListRBTree_Node_PT xlistrbtree_merge_repeat_impl(XListRBTree_PT tree, XListRBTr
                 return node;
             }
 
-            if (values) {
-                XRSList_PT nvalues = xrslist_copy(values);
-                if (!nvalues) {
+            if (0 < values->count) {
+                if (!xlistrbtree_values_merge_copy(tree->allocator, &node->values, values)) {
                     *false_found = true;
                     return node;
                 }
-                if (node->values) {
-                    xrslist_merge(node->values, &nvalues);
-                }
-                else {
-                    node->values = nvalues;
-                }
                 node->node_size += size;
                 node->size += size;
             }
@@ -2731,7 +3327,7 @@ bool xlistrbtree_merge_repeat(XListRBTree_PT tree1, XListRBTree_PT *ptree2) {
 
         while (node) {
             bool false_found = false;
-            tree1->root = xlistrbtree_merge_repeat_impl(tree1, NULL, tree1->root, node->key, node->values, node->node_size, &false_found, false);
+            tree1->root = xlistrbtree_merge_repeat_impl(tree1, NULL, tree1->root, node->key, &node->values, node->node_size, &false_found, false);
             if (false_found) {
                 return false;
             }
@@ -2753,7 +3349,7 @@ bool xlistrbtree_merge_unique(XListRBTree_PT tree1, XListRBTree_PT *ptree2) {
 
         while (node) {
             bool false_found = false;
-            tree1->root = xlistrbtree_merge_repeat_impl(tree1, NULL, tree1->root, node->key, node->values, node->node_size, &false_found, true);
+            tree1->root = xlistrbtree_merge_repeat_impl(tree1, NULL, tree1->root, node->key, &node->values, node->node_size, &false_found, true);
             if (false_found) {
                 return false;
             }
@@ -2827,7 +3423,7 @@ int xlistrbtree_count_black_to_root(XListRBTree_PT tree, XListRBTree_Node_PT nod
         if (xlistrbtree_node_color_black(node)) {
             ++count;
         }
-        node = node->parent;
+        node = xlistrbtree_node_parent(node);
     }
 
     return count + 1;  /* 1 means tree->root is black */
@@ -14,29 +14,108 @@
 #define XLISTRBTREEX_INCLUDED
 
 #include <stdbool.h>
-#include "../include/xlist_s_raw.h"
+#include <stdint.h>
 #include "../include/xtree_redblack_list.h"
 
 typedef struct XListRBTree_Node* XListRBTree_Node_PT;
 
+/* the values of the "same keys" are saved in the node itself at first,
+*  they are moved to a growable array only when more than XLISTRBTREE_INLINE_VALUES values are saved
+*/
+#ifndef XLISTRBTREE_INLINE_VALUES
+#define XLISTRBTREE_INLINE_VALUES 2
+#endif
+
+typedef struct XListRBTree_Values  XListRBTree_Values_T;
+typedef struct XListRBTree_Values* XListRBTree_Values_PT;
+
+/* values[count - 1] is the front one (the last saved one), values[0] is the back one */
+struct XListRBTree_Values {
+    union {
+        void  *inline_values[XLISTRBTREE_INLINE_VALUES];  /* capacity == 0 */
+        void **array;                                      /* capacity >  0 */
+    } store;
+
+    int count;
+    int capacity;   /* 0 : all the values are saved in "inline_values" */
+};
+
+/* XRBTREE_COMPACT_NODE : the color is saved in the lowest bit of the parent pointer as XRBTree_Node */
 struct XListRBTree_Node {
+#ifdef XRBTREE_COMPACT_NODE
+    uintptr_t           parent_color;
+#else
     XListRBTree_Node_PT parent;
+#endif
     XListRBTree_Node_PT left;
     XListRBTree_Node_PT right;
 
     void *key;
-    XRSList_PT values;  /* just has one "key" saved for all the "same keys" if "cmp" return true */
+    XListRBTree_Values_T values;  /* just has one "key" saved for all the "same keys" if "cmp" return true */
 
     int   node_size;    /* the element size of the node itself */
     int   size;         /* the element size including its children */
+#ifndef XRBTREE_COMPACT_NODE
     bool  color;        /* red : false,  black : true */
+#endif
 };
 
+/* O(1) : always use them to access the parent and color of node */
+static inline
+XListRBTree_Node_PT xlistrbtree_node_parent(XListRBTree_Node_PT node) {
+#ifdef XRBTREE_COMPACT_NODE
+    return (XListRBTree_Node_PT)(node->parent_color & ~(uintptr_t)1);
+#else
+    return node->parent;
+#endif
+}
+
+static inline
+void xlistrbtree_node_set_parent(XListRBTree_Node_PT node, XListRBTree_Node_PT parent) {
+#ifdef XRBTREE_COMPACT_NODE
+    node->parent_color = (uintptr_t)parent | (node->parent_color & 1);
+#else
+    node->parent = parent;
+#endif
+}
+
+static inline
+bool xlistrbtree_node_color(XListRBTree_Node_PT node) {
+#ifdef XRBTREE_COMPACT_NODE
+    return (node->parent_color & 1) != 0;
+#else
+    return node->color;
+#endif
+}
+
+static inline
+void xlistrbtree_node_set_color(XListRBTree_Node_PT node, bool color) {
+#ifdef XRBTREE_COMPACT_NODE
+    node->parent_color = (node->parent_color & ~(uintptr_t)1) | (color ? 1 : 0);
+#else
+    node->color = color;
+#endif
+}
+
+/* O(1) : the storage of all the values, from the back one to the front one */
+static inline
+void** xlistrbtree_values_array(XListRBTree_Values_PT values) {
+    return (0 < values->capacity) ? values->store.array : values->store.inline_values;
+}
+
+/* O(1) */
+static inline
+void* xlistrbtree_values_front(XListRBTree_Values_PT values) {
+    return (0 < values->count) ? xlistrbtree_values_array(values)[values->count - 1] : NULL;
+}
+
 struct XListRBTree {
     XListRBTree_Node_PT root;
 
     int (*cmp)(void *key1, void *key2, void *cl);
     void *cl;
+
+    XMem_Allocator_PT allocator;  /* the tree, its nodes and their values arrays come from it, NULL : XMEM */
 };
 
 /* used for internal implementations */
@@ -51,6 +130,20 @@ struct XListRBTree_3Paras {
     void      *para3;
 };
 
+/* amortized O(1) */
+extern bool                 xlistrbtree_values_push_front            (XMem_Allocator_PT allocator, XListRBTree_Values_PT values, void *value);
+/* O(K) : "k" starts from the front one (0) */
+extern void*                xlistrbtree_values_pop_kth               (XMem_Allocator_PT allocator, XListRBTree_Values_PT values, int k);
+/* O(1) : return the count of the released values */
+extern int                  xlistrbtree_values_free_except_front     (XMem_Allocator_PT allocator, XListRBTree_Values_PT values);
+/* O(K) */
+extern bool                 xlistrbtree_values_copy                  (XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues);
+extern bool                 xlistrbtree_values_deep_copy             (XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues, int value_size);
+/* O(K) : copies of "nvalues" are saved behind the back one of "values" */
+extern bool                 xlistrbtree_values_merge_copy            (XMem_Allocator_PT allocator, XListRBTree_Values_PT values, XListRBTree_Values_PT nvalues);
+/* O(1), O(K) if deep */
+extern void                 xlistrbtree_values_free                  (XMem_Allocator_PT allocator, XListRBTree_Values_PT values, bool deep);
+
 /* O(NlgN) */
 extern void                 xlistrbtree_copy_break_if_false_impl     (XListRBTree_PT tree, XListRBTree_Node_PT node, XListRBTree_PT ntree, XListRBTree_Node_PT nparent, bool root, bool left, bool *false_found, XListRBTree_Node_PT (*apply)(XListRBTree_Node_PT node, XListRBTree_Node_PT nparent, bool *false_found, void *cl), void *cl);
 extern int                  xlistrbtree_deep_remove_impl             (XListRBTree_PT tree, void *key, bool remove_all, bool for_set);
@@ -69,6 +162,8 @@ extern XListRBTree_Node_PT  xlistrbtree_get_impl                     (XListRBTre
 /* O(lgN) */
 extern XListRBTree_Node_PT  xlistrbtree_min_impl                     (XListRBTree_PT tree, XListRBTree_Node_PT node);
 extern XListRBTree_Node_PT  xlistrbtree_max_impl                     (XListRBTree_PT tree, XListRBTree_Node_PT node);
+extern XListRBTree_Node_PT  xlistrbtree_ceiling_impl                 (XListRBTree_PT tree, XListRBTree_Node_PT node, void *key);
+extern XListRBTree_Node_PT  xlistrbtree_select_impl                  (XListRBTree_PT tree, XListRBTree_Node_PT node, int k);
 
 /* O(1) */
 extern XListRBTree_Node_PT  xlistrbtree_prev_node                    (XListRBTree_PT tree, XListRBTree_Node_PT node);
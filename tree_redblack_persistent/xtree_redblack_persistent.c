@@ -0,0 +1,797 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#if defined(__linux__)
+
+#include <stddef.h>
+
+#include "../include/xassert.h"
+#include "../include/xmem.h"
+#include "xtree_redblack_persistent_x.h"
+
+static const bool xprbtree_color_red = false;
+static const bool xprbtree_color_black = true;
+
+static
+bool xprbtree_node_color_red(XPRBTree_Node_PT node) {
+    return node ? (node->color == xprbtree_color_red) : false;
+}
+
+static
+int xprbtree_node_size(XPRBTree_Node_PT node) {
+    return node ? node->size : 0;
+}
+
+static
+void xprbtree_node_ref(XPRBTree_Node_PT node) {
+    if (node) {
+        __atomic_add_fetch(&node->refs, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* the node (and the children only used by it) is freed if nobody uses it any more */
+static
+void xprbtree_node_unref(XPRBTree_Node_PT node) {
+    while (node && (__atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL) == 0)) {
+        XPRBTree_Node_PT right = node->right;
+
+        xprbtree_node_unref(node->left);
+        XMEM_FREE(node);
+
+        /* no recursion for the right child */
+        node = right;
+    }
+}
+
+XPRBTree_PT xprbtree_new(int (*cmp)(void *key1, void *key2, void *cl), void *cl) {
+    xassert(cmp);
+
+    if (!cmp) {
+        return NULL;
+    }
+
+    {
+        XPRBTree_PT tree = XMEM_CALLOC(1, sizeof(*tree));
+        if (!tree) {
+            return NULL;
+        }
+
+        if (pthread_mutex_init(&tree->write_lock, NULL) != 0) {
+            XMEM_FREE(tree);
+            return NULL;
+        }
+
+        if (pthread_mutex_init(&tree->root_lock, NULL) != 0) {
+            pthread_mutex_destroy(&tree->write_lock);
+            XMEM_FREE(tree);
+            return NULL;
+        }
+
+        tree->cmp = cmp;
+        tree->cl = cl;
+
+        return tree;
+    }
+}
+
+/* allocate all the nodes one update may need before changing anything, then the update never fails :
+*    the height of the tree is not bigger than 2 * (black height) + 1,
+*    one update copies or creates at most 8 nodes for each level on its path
+*/
+static
+bool xprbtree_reserve(XPRBTree_PT tree) {
+    int black_height = 0;
+    for (XPRBTree_Node_PT node = tree->root; node; node = node->left) {
+        if (!xprbtree_node_color_red(node)) {
+            ++black_height;
+        }
+    }
+
+    {
+        int need = 8 * (2 * black_height + 3);
+
+        while (tree->spare_size < need) {
+            XPRBTree_Node_PT node = XMEM_MALLOC(sizeof(*node));
+            if (!node) {
+                return false;
+            }
+
+            node->left = tree->spares;
+            tree->spares = node;
+            ++tree->spare_size;
+        }
+    }
+
+    return true;
+}
+
+static
+XPRBTree_Node_PT xprbtree_spare_node(XPRBTree_PT tree) {
+    XPRBTree_Node_PT node = tree->spares;
+    xassert(node);
+
+    tree->spares = node->left;
+    --tree->spare_size;
+
+    return node;
+}
+
+/* the node is not used any more by the current update, its children must be NULL */
+static
+void xprbtree_release_node(XPRBTree_PT tree, XPRBTree_Node_PT node) {
+    xassert(!node->left && !node->right);
+
+    node->left = tree->spares;
+    tree->spares = node;
+    ++tree->spare_size;
+}
+
+static
+XPRBTree_Node_PT xprbtree_new_node(XPRBTree_PT tree, void *key, void *value) {
+    XPRBTree_Node_PT node = xprbtree_spare_node(tree);
+
+    node->left = NULL;
+    node->right = NULL;
+    node->key = key;
+    node->value = value;
+    node->version = tree->version;
+    node->refs = 1;
+    node->size = 1;
+    node->color = xprbtree_color_red;
+
+    return node;
+}
+
+/* make the node can be changed by the current update : copy it if it's created by an old update */
+static
+XPRBTree_Node_PT xprbtree_own(XPRBTree_PT tree, XPRBTree_Node_PT *pnode) {
+    XPRBTree_Node_PT node = *pnode;
+    if (!node || (node->version == tree->version)) {
+        return node;
+    }
+
+    {
+        XPRBTree_Node_PT nnode = xprbtree_spare_node(tree);
+
+        /* node->refs may be changed by the readers at the same time, don't copy it */
+        nnode->left = node->left;
+        nnode->right = node->right;
+        nnode->key = node->key;
+        nnode->value = node->value;
+        nnode->version = tree->version;
+        nnode->refs = 1;
+        nnode->size = node->size;
+        nnode->color = node->color;
+
+        xprbtree_node_ref(nnode->left);
+        xprbtree_node_ref(nnode->right);
+
+        /* never freed here : the old version still uses it */
+        xprbtree_node_unref(node);
+
+        *pnode = nnode;
+        return nnode;
+    }
+}
+
+/* xprbtree_rotate_left :
+*
+*         |                 |
+*         N                 X
+*       /   \     -->     /   \
+*      D    X(R)        N(R)   T
+*           /  \        /  \
+*          F    T      D    F
+*/
+static
+XPRBTree_Node_PT xprbtree_rotate_left(XPRBTree_PT tree, XPRBTree_Node_PT node_N) {
+    XPRBTree_Node_PT x = xprbtree_own(tree, &node_N->right);
+
+    node_N->right = x->left;
+    x->left = node_N;
+
+    x->color = node_N->color;
+    node_N->color = xprbtree_color_red;
+    x->size = node_N->size;
+    node_N->size = 1 + xprbtree_node_size(node_N->left) + xprbtree_node_size(node_N->right);
+
+    return x;
+}
+
+/* xprbtree_rotate_right :
+*
+*         |                 |
+*         N                 X
+*       /   \     -->     /   \
+*     X(R)   T           D    N(R)
+*     /  \                    /  \
+*    D    F                  F    T
+*/
+static
+XPRBTree_Node_PT xprbtree_rotate_right(XPRBTree_PT tree, XPRBTree_Node_PT node_N) {
+    XPRBTree_Node_PT x = xprbtree_own(tree, &node_N->left);
+
+    node_N->left = x->right;
+    x->right = node_N;
+
+    x->color = node_N->color;
+    node_N->color = xprbtree_color_red;
+    x->size = node_N->size;
+    node_N->size = 1 + xprbtree_node_size(node_N->left) + xprbtree_node_size(node_N->right);
+
+    return x;
+}
+
+static
+void xprbtree_flip_color(XPRBTree_PT tree, XPRBTree_Node_PT node) {
+    XPRBTree_Node_PT left = xprbtree_own(tree, &node->left);
+    XPRBTree_Node_PT right = xprbtree_own(tree, &node->right);
+
+    node->color = !node->color;
+    left->color = !left->color;
+    right->color = !right->color;
+}
+
+static
+XPRBTree_Node_PT xprbtree_balance(XPRBTree_PT tree, XPRBTree_Node_PT node) {
+    if (xprbtree_node_color_red(node->right) && !xprbtree_node_color_red(node->left)) {
+        node = xprbtree_rotate_left(tree, node);
+    }
+
+    if (xprbtree_node_color_red(node->left) && xprbtree_node_color_red(node->left->left)) {
+        node = xprbtree_rotate_right(tree, node);
+    }
+
+    if (xprbtree_node_color_red(node->left) && xprbtree_node_color_red(node->right)) {
+        xprbtree_flip_color(tree, node);
+    }
+
+    node->size = 1 + xprbtree_node_size(node->left) + xprbtree_node_size(node->right);
+
+    return node;
+}
+
+/* node is owned by the current update (or NULL) */
+static
+XPRBTree_Node_PT xprbtree_put_impl(XPRBTree_PT tree, XPRBTree_Node_PT node, void *key, void *value, void **old_value) {
+    if (!node) {
+        return xprbtree_new_node(tree, key, value);
+    }
+
+    {
+        int ret = tree->cmp(key, node->key, tree->cl);
+        if (ret < 0) {
+            node->left = xprbtree_put_impl(tree, xprbtree_own(tree, &node->left), key, value, old_value);
+        }
+        else if (0 < ret) {
+            node->right = xprbtree_put_impl(tree, xprbtree_own(tree, &node->right), key, value, old_value);
+        }
+        else {
+            if (old_value) {
+                *old_value = node->value;
+            }
+            node->value = value;
+        }
+    }
+
+    return xprbtree_balance(tree, node);
+}
+
+static
+XPRBTree_Node_PT xprbtree_move_red_left(XPRBTree_PT tree, XPRBTree_Node_PT node) {
+    xprbtree_flip_color(tree, node);
+
+    if (xprbtree_node_color_red(node->right->left)) {
+        node->right = xprbtree_rotate_right(tree, node->right);
+        node = xprbtree_rotate_left(tree, node);
+        xprbtree_flip_color(tree, node);
+    }
+
+    return node;
+}
+
+static
+XPRBTree_Node_PT xprbtree_move_red_right(XPRBTree_PT tree, XPRBTree_Node_PT node) {
+    xprbtree_flip_color(tree, node);
+
+    if (xprbtree_node_color_red(node->left->left)) {
+        node = xprbtree_rotate_right(tree, node);
+        xprbtree_flip_color(tree, node);
+    }
+
+    return node;
+}
+
+static
+XPRBTree_Node_PT xprbtree_remove_min_impl(XPRBTree_PT tree, XPRBTree_Node_PT node) {
+    if (!node->left) {
+        xprbtree_release_node(tree, node);
+        return NULL;
+    }
+
+    if (!xprbtree_node_color_red(node->left) && !xprbtree_node_color_red(node->left->left)) {
+        node = xprbtree_move_red_left(tree, node);
+    }
+
+    node->left = xprbtree_remove_min_impl(tree, xprbtree_own(tree, &node->left));
+
+    return xprbtree_balance(tree, node);
+}
+
+/* key must be in the tree */
+static
+XPRBTree_Node_PT xprbtree_remove_impl(XPRBTree_PT tree, XPRBTree_Node_PT node, void *key) {
+    if (tree->cmp(key, node->key, tree->cl) < 0) {
+        if (!xprbtree_node_color_red(node->left) && !xprbtree_node_color_red(node->left->left)) {
+            node = xprbtree_move_red_left(tree, node);
+        }
+
+        node->left = xprbtree_remove_impl(tree, xprbtree_own(tree, &node->left), key);
+    }
+    else {
+        if (xprbtree_node_color_red(node->left)) {
+            node = xprbtree_rotate_right(tree, node);
+        }
+
+        if ((tree->cmp(key, node->key, tree->cl) == 0) && !node->right) {
+            xprbtree_release_node(tree, node);
+            return NULL;
+        }
+
+        if (!xprbtree_node_color_red(node->right) && !xprbtree_node_color_red(node->right->left)) {
+            node = xprbtree_move_red_right(tree, node);
+        }
+
+        if (tree->cmp(key, node->key, tree->cl) == 0) {
+            XPRBTree_Node_PT min = node->right;
+            while (min->left) {
+                min = min->left;
+            }
+
+            node->key = min->key;
+            node->value = min->value;
+            node->right = xprbtree_remove_min_impl(tree, xprbtree_own(tree, &node->right));
+        }
+        else {
+            node->right = xprbtree_remove_impl(tree, xprbtree_own(tree, &node->right), key);
+        }
+    }
+
+    return xprbtree_balance(tree, node);
+}
+
+static
+XPRBTree_Node_PT xprbtree_get_impl(XPRBTree_Node_PT node, int (*cmp)(void *key1, void *key2, void *cl), void *cl, void *key) {
+    while (node) {
+        int ret = cmp(key, node->key, cl);
+        if (ret == 0) {
+            return node;
+        }
+
+        node = (ret < 0) ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+/* replace the current version with the new root built by the update */
+static
+void xprbtree_publish(XPRBTree_PT tree, XPRBTree_Node_PT root) {
+    XPRBTree_Node_PT old_root = NULL;
+
+    pthread_mutex_lock(&tree->root_lock);
+    old_root = tree->root;
+    tree->root = root;
+    pthread_mutex_unlock(&tree->root_lock);
+
+    /* the nodes only used by the old version are freed if no snapshot uses it */
+    xprbtree_node_unref(old_root);
+}
+
+bool xprbtree_put_replace(XPRBTree_PT tree, void *key, void *value, void **old_value) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    if (pthread_mutex_lock(&tree->write_lock) != 0) {
+        return false;
+    }
+
+    if (!xprbtree_reserve(tree)) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return false;
+    }
+
+    {
+        /* only writers change tree->root, and they are locked */
+        XPRBTree_Node_PT root = tree->root;
+        xprbtree_node_ref(root);
+
+        ++tree->version;
+
+        root = xprbtree_put_impl(tree, xprbtree_own(tree, &root), key, value, old_value);
+        root->color = xprbtree_color_black;
+
+        xprbtree_publish(tree, root);
+    }
+
+    pthread_mutex_unlock(&tree->write_lock);
+    return true;
+}
+
+bool xprbtree_remove(XPRBTree_PT tree, void *key) {
+    xassert(tree);
+    xassert(key);
+
+    if (!tree || !key) {
+        return false;
+    }
+
+    if (pthread_mutex_lock(&tree->write_lock) != 0) {
+        return false;
+    }
+
+    if (!xprbtree_get_impl(tree->root, tree->cmp, tree->cl, key) || !xprbtree_reserve(tree)) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return false;
+    }
+
+    {
+        XPRBTree_Node_PT root = tree->root;
+        xprbtree_node_ref(root);
+
+        ++tree->version;
+
+        root = xprbtree_own(tree, &root);
+        if (!xprbtree_node_color_red(root->left) && !xprbtree_node_color_red(root->right)) {
+            root->color = xprbtree_color_red;
+        }
+
+        root = xprbtree_remove_impl(tree, root, key);
+        if (root) {
+            root->color = xprbtree_color_black;
+        }
+
+        xprbtree_publish(tree, root);
+    }
+
+    pthread_mutex_unlock(&tree->write_lock);
+    return true;
+}
+
+XPRBTree_Snap_PT xprbtree_snapshot(XPRBTree_PT tree) {
+    xassert(tree);
+
+    if (!tree) {
+        return NULL;
+    }
+
+    {
+        XPRBTree_Snap_PT snap = XMEM_CALLOC(1, sizeof(*snap));
+        if (!snap) {
+            return NULL;
+        }
+
+        snap->cmp = tree->cmp;
+        snap->cl = tree->cl;
+
+        /* the root can't be freed before it's referenced */
+        pthread_mutex_lock(&tree->root_lock);
+        snap->root = tree->root;
+        xprbtree_node_ref(snap->root);
+        pthread_mutex_unlock(&tree->root_lock);
+
+        return snap;
+    }
+}
+
+void xprbtree_snap_free(XPRBTree_Snap_PT *psnap) {
+    if (!psnap || !*psnap) {
+        return;
+    }
+
+    xprbtree_node_unref((*psnap)->root);
+    XMEM_FREE(*psnap);
+}
+
+void* xprbtree_snap_get(XPRBTree_Snap_PT snap, void *key) {
+    xassert(snap);
+    xassert(key);
+
+    if (!snap || !key) {
+        return NULL;
+    }
+
+    {
+        XPRBTree_Node_PT node = xprbtree_get_impl(snap->root, snap->cmp, snap->cl, key);
+        return node ? node->value : NULL;
+    }
+}
+
+bool xprbtree_snap_find(XPRBTree_Snap_PT snap, void *key) {
+    xassert(snap);
+    xassert(key);
+
+    if (!snap || !key) {
+        return false;
+    }
+
+    return xprbtree_get_impl(snap->root, snap->cmp, snap->cl, key) != NULL;
+}
+
+void* xprbtree_snap_min(XPRBTree_Snap_PT snap) {
+    XPRBTree_Node_PT node = snap ? snap->root : NULL;
+    if (!node) {
+        return NULL;
+    }
+
+    while (node->left) {
+        node = node->left;
+    }
+
+    return node->key;
+}
+
+void* xprbtree_snap_max(XPRBTree_Snap_PT snap) {
+    XPRBTree_Node_PT node = snap ? snap->root : NULL;
+    if (!node) {
+        return NULL;
+    }
+
+    while (node->right) {
+        node = node->right;
+    }
+
+    return node->key;
+}
+
+/* the maximum key which is <= key */
+void* xprbtree_snap_floor(XPRBTree_Snap_PT snap, void *key) {
+    xassert(snap);
+    xassert(key);
+
+    if (!snap || !key) {
+        return NULL;
+    }
+
+    {
+        XPRBTree_Node_PT node = snap->root;
+        XPRBTree_Node_PT result = NULL;
+
+        while (node) {
+            int ret = snap->cmp(node->key, key, snap->cl);
+            if (ret == 0) {
+                return node->key;
+            }
+            else if (ret < 0) {
+                result = node;
+                node = node->right;
+            }
+            else {
+                node = node->left;
+            }
+        }
+
+        return result ? result->key : NULL;
+    }
+}
+
+/* the minimum key which is >= key */
+void* xprbtree_snap_ceiling(XPRBTree_Snap_PT snap, void *key) {
+    xassert(snap);
+    xassert(key);
+
+    if (!snap || !key) {
+        return NULL;
+    }
+
+    {
+        XPRBTree_Node_PT node = snap->root;
+        XPRBTree_Node_PT result = NULL;
+
+        while (node) {
+            int ret = snap->cmp(node->key, key, snap->cl);
+            if (ret == 0) {
+                return node->key;
+            }
+            else if (ret < 0) {
+                node = node->right;
+            }
+            else {
+                result = node;
+                node = node->left;
+            }
+        }
+
+        return result ? result->key : NULL;
+    }
+}
+
+void* xprbtree_snap_select(XPRBTree_Snap_PT snap, int k) {
+    xassert(snap);
+    xassert(0 <= k);
+    xassert(k < xprbtree_snap_size(snap));
+
+    if (!snap || (k < 0) || (xprbtree_snap_size(snap) <= k)) {
+        return NULL;
+    }
+
+    {
+        XPRBTree_Node_PT node = snap->root;
+
+        while (node) {
+            int left_size = xprbtree_node_size(node->left);
+            if (k < left_size) {
+                node = node->left;
+            }
+            else if (left_size < k) {
+                k -= left_size + 1;
+                node = node->right;
+            }
+            else {
+                return node->key;
+            }
+        }
+
+        return NULL;
+    }
+}
+
+/* the number of keys < key, -1 if key is not found */
+int xprbtree_snap_rank(XPRBTree_Snap_PT snap, void *key) {
+    xassert(snap);
+    xassert(key);
+
+    if (!snap || !key) {
+        return -1;
+    }
+
+    {
+        XPRBTree_Node_PT node = snap->root;
+        int rank = 0;
+
+        while (node) {
+            int ret = snap->cmp(key, node->key, snap->cl);
+            if (ret < 0) {
+                node = node->left;
+            }
+            else if (0 < ret) {
+                rank += xprbtree_node_size(node->left) + 1;
+                node = node->right;
+            }
+            else {
+                return rank + xprbtree_node_size(node->left);
+            }
+        }
+
+        return -1;
+    }
+}
+
+static
+int xprbtree_snap_map_impl(XPRBTree_Node_PT node, bool (*apply)(void *key, void *value, void *cl), void *cl) {
+    int count = 0;
+
+    while (node) {
+        count += xprbtree_snap_map_impl(node->left, apply, cl);
+
+        if (apply(node->key, node->value, cl)) {
+            ++count;
+        }
+
+        node = node->right;
+    }
+
+    return count;
+}
+
+int xprbtree_snap_map_min_to_max(XPRBTree_Snap_PT snap, bool (*apply)(void *key, void *value, void *cl), void *cl) {
+    xassert(snap);
+    xassert(apply);
+
+    if (!snap || !apply) {
+        return 0;
+    }
+
+    return xprbtree_snap_map_impl(snap->root, apply, cl);
+}
+
+int xprbtree_snap_size(XPRBTree_Snap_PT snap) {
+    return snap ? xprbtree_node_size(snap->root) : 0;
+}
+
+bool xprbtree_snap_is_empty(XPRBTree_Snap_PT snap) {
+    return xprbtree_snap_size(snap) == 0;
+}
+
+/* returns the black height, -1 if it's not a left-leaning red-black tree */
+static
+int xprbtree_is_rbtree_impl(XPRBTree_Snap_PT snap, XPRBTree_Node_PT node, void *low, void *high) {
+    if (!node) {
+        return 0;
+    }
+
+    /* low < node->key < high */
+    if ((low && (0 <= snap->cmp(low, node->key, snap->cl))) || (high && (0 <= snap->cmp(node->key, high, snap->cl)))) {
+        return -1;
+    }
+
+    /* no red right child, no two red nodes in a row */
+    if (xprbtree_node_color_red(node->right) || (xprbtree_node_color_red(node) && xprbtree_node_color_red(node->left))) {
+        return -1;
+    }
+
+    if (node->size != 1 + xprbtree_node_size(node->left) + xprbtree_node_size(node->right)) {
+        return -1;
+    }
+
+    {
+        int left = xprbtree_is_rbtree_impl(snap, node->left, low, node->key);
+        int right = xprbtree_is_rbtree_impl(snap, node->right, node->key, high);
+        if ((left < 0) || (left != right)) {
+            return -1;
+        }
+
+        return left + (xprbtree_node_color_red(node) ? 0 : 1);
+    }
+}
+
+bool xprbtree_snap_is_rbtree(XPRBTree_Snap_PT snap) {
+    if (!snap) {
+        return false;
+    }
+
+    if (xprbtree_node_color_red(snap->root)) {
+        return false;
+    }
+
+    return 0 <= xprbtree_is_rbtree_impl(snap, snap->root, NULL, NULL);
+}
+
+int xprbtree_size(XPRBTree_PT tree) {
+    int size = 0;
+
+    if (tree) {
+        pthread_mutex_lock(&tree->root_lock);
+        size = xprbtree_node_size(tree->root);
+        pthread_mutex_unlock(&tree->root_lock);
+    }
+
+    return size;
+}
+
+bool xprbtree_is_empty(XPRBTree_PT tree) {
+    return xprbtree_size(tree) == 0;
+}
+
+void xprbtree_free(XPRBTree_PT *ptree) {
+    if (!ptree || !*ptree) {
+        return;
+    }
+
+    xprbtree_node_unref((*ptree)->root);
+
+    while ((*ptree)->spares) {
+        XPRBTree_Node_PT node = (*ptree)->spares;
+        (*ptree)->spares = node->left;
+        XMEM_FREE(node);
+    }
+
+    pthread_mutex_destroy(&(*ptree)->write_lock);
+    pthread_mutex_destroy(&(*ptree)->root_lock);
+    XMEM_FREE(*ptree);
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+*   Copyright (C) 2022, Xiaosan Zhai(tom.zhai@aliyun.com)
+*   This file is part of the xalgos library.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*   without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*   See the MIT License for more details.
+*
+*   You should have received a copy of the MIT License along with this program.
+*   If not, see <https://mit-license.org/>.
+*/
+
+#ifndef XPRBTREEX_INCLUDED
+#define XPRBTREEX_INCLUDED
+
+#if defined(__linux__)
+
+#include <pthread.h>
+
+#include "../include/xtree_redblack_persistent.h"
+
+/* Note :
+*    1. it's a left-leaning red-black tree, put and remove are recursive and need no parent pointers,
+*       so a node can be shared by several parents of different versions.
+*    2. a node used by a published version (the tree or a snapshot) is never changed, an update copies the nodes
+*       on its path first, "version" saves the update number which created the node, only these nodes are changed.
+*    3. "refs" is the number of the parents and the roots (tree or snapshots) pointing to the node,
+*       it's changed by atomic operations, the node is freed when it's 0.
+*/
+typedef struct XPRBTree_Node* XPRBTree_Node_PT;
+
+struct XPRBTree_Node {
+    XPRBTree_Node_PT left;
+    XPRBTree_Node_PT right;
+
+    void *key;
+    void *value;
+
+    unsigned long version;
+    int   refs;
+    int   size;
+    bool  color;      /* red : false,  black : true */
+};
+
+struct XPRBTree {
+    XPRBTree_Node_PT root;
+
+    int (*cmp)(void *key1, void *key2, void *cl);
+    void *cl;
+
+    unsigned long    version;     /* update number */
+    XPRBTree_Node_PT spares;      /* nodes allocated before the update, linked by "left" */
+    int              spare_size;
+
+    pthread_mutex_t  write_lock;  /* updates are done one by one */
+    pthread_mutex_t  root_lock;   /* only held to replace the root or take a snapshot */
+};
+
+struct XPRBTree_Snap {
+    XPRBTree_Node_PT root;
+
+    int (*cmp)(void *key1, void *key2, void *cl);
+    void *cl;
+};
+
+#endif
+#endif
@@ -11,11 +11,11 @@
 */
 
 #include <stddef.h>
+#include <string.h>
 
 #include "../include/xassert.h"
 #include "../include/xmem.h"
 #include "../list_s/xlist_s_x.h"
-#include "../list_s_raw/xlist_s_raw_x.h"
 #include "../include/xtree_redblack_list.h"
 #include "../include/xtree_set.h"
 #include "xtree_set_x.h"
@@ -24,6 +24,10 @@ XSet_PT xset_new(int (*cmp)(void *elem1, void *elem2, void *cl), void *cl) {
     return xlistrbtree_new(cmp, cl);
 }
 
+XSet_PT xset_new_allocator(int (*cmp)(void *elem1, void *elem2, void *cl), void *cl, XMem_Allocator_PT allocator) {
+    return xlistrbtree_new_allocator(cmp, cl, allocator);
+}
+
 XSet_PT xset_copy(XSet_PT set) {
     return xlistrbtree_copy(set);
 }
@@ -32,7 +36,7 @@ static
 XSet_Node_PT xset_deep_copy_node(XSet_Node_PT node, XSet_Node_PT nparent, bool *false_found, void *cl) {
     XListRBTree_3Paras_PT paras = (XListRBTree_3Paras_PT)cl;
 
-    XSet_Node_PT nnode = XMEM_CALLOC(1, sizeof(*nnode));
+    XSet_Node_PT nnode = XMEM_ALLOC_BY(paras->tree->allocator, sizeof(*nnode));
     if (!nnode) {
         *false_found = true;
         return NULL;
@@ -42,18 +46,17 @@ XSet_Node_PT xset_deep_copy_node(XSet_Node_PT node, XSet_Node_PT nparent, bool *
     nnode->key = node->key;
 
     /* only need to deep copy the values since all keys saved in it */
-    nnode->values = xrslist_deep_copy(node->values, *((int*)paras->para1));
-    if (node->values && !nnode->values) {
+    if (!xlistrbtree_values_deep_copy(paras->tree->allocator, &node->values, &nnode->values, *((int*)paras->para1))) {
         *false_found = true;
-        XMEM_FREE(nnode);
+        XMEM_FREE_BY(paras->tree->allocator, nnode, sizeof(*nnode));
         return NULL;
     }
 
     nnode->node_size = node->node_size;
     nnode->size = node->size;
-    nnode->color = node->color;
+    xlistrbtree_node_set_color(nnode, xlistrbtree_node_color(node));
 
-    nnode->parent = nparent;
+    xlistrbtree_node_set_parent(nnode, nparent);
     //nnode->left = NULL;
     //nnode->right = NULL;
 
@@ -69,7 +72,7 @@ XSet_PT xset_deep_copy(XSet_PT set, int elem_size) {
     }
 
     {
-        XSet_PT nset = xset_new(set->cmp, set->cl);
+        XSet_PT nset = xset_new_allocator(set->cmp, set->cl, set->allocator);
         if (!nset) {
             return NULL;
         }
@@ -101,8 +104,14 @@ void xset_free_impl(XSet_PT tree, XSet_Node_PT node, bool deep, bool (*apply)(vo
     xset_free_impl(tree, node->right, deep, apply, cl);
 
     /* should not deep free the keys, but only the values */
-    deep ? xrslist_deep_free(&node->values) : (apply ? xrslist_free_apply(&node->values, apply, cl) : xrslist_free(&node->values));
-    XMEM_FREE(node);
+    if (!deep && apply) {
+        void **array = xlistrbtree_values_array(&node->values);
+        for (int i = node->values.count - 1; 0 <= i; --i) {
+            apply(array[i], cl);
+        }
+    }
+    xlistrbtree_values_free(tree->allocator, &node->values, deep);
+    XMEM_FREE_BY(tree->allocator, node, sizeof(*node));
 }
 
 void xset_free(XSet_PT *pset) {
@@ -111,7 +120,7 @@ void xset_free(XSet_PT *pset) {
     }
 
     xset_free_impl(*pset, (*pset)->root, false, NULL, NULL);
-    XMEM_FREE(*pset);
+    XMEM_FREE_BY((*pset)->allocator, *pset, sizeof(**pset));
 }
 
 void xset_free_apply(XSet_PT *pset, bool (*apply)(void *elem, void *cl), void *cl) {
@@ -120,7 +129,7 @@ void xset_free_apply(XSet_PT *pset, bool (*apply)(void *elem, void *cl), void *c
     }
 
     xset_free_impl(*pset, (*pset)->root, false, apply, cl);
-    XMEM_FREE(*pset);
+    XMEM_FREE_BY((*pset)->allocator, *pset, sizeof(**pset));
 }
 
 void xset_deep_free(XSet_PT *pset) {
@@ -129,7 +138,7 @@ void xset_deep_free(XSet_PT *pset) {
     }
 
     xset_free_impl(*pset, (*pset)->root, true, NULL, NULL);
-    XMEM_FREE(*pset);
+    XMEM_FREE_BY((*pset)->allocator, *pset, sizeof(**pset));
 }
 
 void xset_clear(XSet_PT set) {
@@ -169,6 +178,10 @@ bool xset_put_unique(XSet_PT set, void *elem) {
     return xlistrbtree_put_unique(set, elem, elem); /* key must be saved as value too */
 }
 
+bool xset_build_sorted(XSet_PT set, void **elems, int count) {
+    return xlistrbtree_build_sorted(set, elems, elems, count); /* key must be saved as value too */
+}
+
 void xset_elem_unique(XSet_PT set, void *elem) {
     xlistrbtree_key_unique(set, elem);
 }
@@ -217,12 +230,13 @@ XSList_PT xset_elems_impl(XSet_PT tree, void *low, void *high) {
         XSet_Node_PT node = xlistrbtree_get_impl(tree, tree->root, low);
         while (node && (tree->cmp(node->key, high, tree->cl) <= 0)) {
             /* keys are all saved in the values */
-            XRSList_PT rslist = xrslist_copy(node->values);
-            if (!rslist) {
-                xslist_free(&list);
-                return NULL;
+            void **array = xlistrbtree_values_array(&node->values);
+            for (int i = node->values.count - 1; 0 <= i; --i) {
+                if (!xslist_push_back_repeat(list, array[i])) {
+                    xslist_free(&list);
+                    return NULL;
+                }
             }
-            xslist_push_back_rslist(list, rslist);
 
             node = xlistrbtree_next_node(tree, node);
         }
@@ -259,13 +273,22 @@ void xset_deep_remove_all(XSet_PT set, void *elem) {
     xlistrbtree_deep_remove_impl(set, elem, true, true);
 }
 
+XSet_PT xset_split(XSet_PT set, void *elem) {
+    return xlistrbtree_split(set, elem);
+}
+
+XSet_PT xset_remove_range(XSet_PT set, void *low, void *high) {
+    return xlistrbtree_remove_range(set, low, high);
+}
+
 int xset_map_min_to_max_impl(XSet_PT set, bool (*apply)(void *elem, void *cl), void *cl) {
     int count = 0;
 
     XSet_Node_PT node = xlistrbtree_min_impl(set, set ? set->root : NULL);
     while (node) {
-        for (XRSList_PT step = node->values; step; step = step->next) {
-            if (apply(step->value, cl)) {
+        void **array = xlistrbtree_values_array(&node->values);
+        for (int i = node->values.count - 1; 0 <= i; --i) {
+            if (apply(array[i], cl)) {
                 ++count;
             }
         }
@@ -299,8 +322,9 @@ int xset_map_min_to_max(XSet_PT set, bool (*apply)(void *elem, void *cl), void *
 bool xset_map_min_to_max_break_if_impl(XSet_PT set, bool break_true, bool (*apply)(void *elem, void *cl), void *cl) {
     XSet_Node_PT node = xlistrbtree_min_impl(set, set ? set->root : NULL);
     while (node) {
-        for (XRSList_PT step = node->values; step; step = step->next) {
-            bool ret = apply(step->value, cl);
+        void **array = xlistrbtree_values_array(&node->values);
+        for (int i = node->values.count - 1; 0 <= i; --i) {
+            bool ret = apply(array[i], cl);
             if (ret && break_true) {
                 return true;
             }
@@ -340,8 +364,9 @@ int xset_map_max_to_min_impl(XSet_PT set, bool (*apply)(void *elem, void *cl), v
 
     XSet_Node_PT node = xlistrbtree_max_impl(set, set ? set->root : NULL);
     while (node) {
-        for (XRSList_PT step = node->values; step; step = step->next) {
-            if (apply(step->value, cl)) {
+        void **array = xlistrbtree_values_array(&node->values);
+        for (int i = node->values.count - 1; 0 <= i; --i) {
+            if (apply(array[i], cl)) {
                 ++count;
             }
         }
@@ -362,6 +387,131 @@ int xset_map_max_to_min(XSet_PT set, bool (*apply)(void *elem, void *cl), void *
     return xset_map_max_to_min_impl(set, apply, cl);
 }
 
+void xset_cursor_init(XSet_Cursor_PT cursor, XSet_PT set) {
+    xassert(cursor);
+    xassert(set);
+
+    if (!cursor) {
+        return;
+    }
+
+    cursor->set = set;
+    cursor->node = NULL;
+    cursor->elem = NULL;
+}
+
+/* move the cursor to the first (or last) elem of node */
+static
+bool xset_cursor_set_node(XSet_Cursor_PT cursor, XSet_Node_PT node, bool last) {
+    cursor->node = node;
+    cursor->elem = NULL;
+
+    /* "elem" is the slot of the elem in the values, from the front one (the last slot) to the back one (the first slot) */
+    if (node && (0 < node->values.count)) {
+        void **array = xlistrbtree_values_array(&node->values);
+        cursor->elem = last ? (void*)array : (void*)(array + node->values.count - 1);
+    }
+
+    return node != NULL;
+}
+
+bool xset_cursor_first(XSet_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->set) {
+        return false;
+    }
+
+    return xset_cursor_set_node(cursor, xlistrbtree_min_impl(cursor->set, cursor->set->root), false);
+}
+
+bool xset_cursor_last(XSet_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->set) {
+        return false;
+    }
+
+    return xset_cursor_set_node(cursor, xlistrbtree_max_impl(cursor->set, cursor->set->root), true);
+}
+
+bool xset_cursor_seek(XSet_Cursor_PT cursor, void *elem) {
+    xassert(cursor);
+    xassert(elem);
+
+    if (!cursor || !cursor->set || !elem) {
+        return false;
+    }
+
+    {
+        XSet_PT set = cursor->set;
+        XSet_Node_PT node = set->root;
+        XSet_Node_PT result = NULL;
+
+        while (node) {
+            int ret = set->cmp(node->key, elem, set->cl);
+            if (ret == 0) {
+                result = node;
+                break;
+            }
+            else if (ret < 0) {
+                node = node->right;
+            }
+            else {
+                result = node;
+                node = node->left;
+            }
+        }
+
+        return xset_cursor_set_node(cursor, result, false);
+    }
+}
+
+bool xset_cursor_next(XSet_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    if (cursor->elem && (xlistrbtree_values_array(&((XSet_Node_PT)cursor->node)->values) < (void**)cursor->elem)) {
+        cursor->elem = (void**)cursor->elem - 1;
+        return true;
+    }
+
+    return xset_cursor_set_node(cursor, xlistrbtree_next_node(cursor->set, (XSet_Node_PT)cursor->node), false);
+}
+
+bool xset_cursor_prev(XSet_Cursor_PT cursor) {
+    xassert(cursor);
+
+    if (!cursor || !cursor->node) {
+        return false;
+    }
+
+    {
+        XListRBTree_Values_PT values = &((XSet_Node_PT)cursor->node)->values;
+        if (cursor->elem && ((void**)cursor->elem < xlistrbtree_values_array(values) + values->count - 1)) {
+            cursor->elem = (void**)cursor->elem + 1;
+            return true;
+        }
+    }
+
+    return xset_cursor_set_node(cursor, xlistrbtree_prev_node(cursor->set, (XSet_Node_PT)cursor->node), true);
+}
+
+bool xset_cursor_valid(XSet_Cursor_PT cursor) {
+    return cursor ? (cursor->node != NULL) : false;
+}
+
+void* xset_cursor_elem(XSet_Cursor_PT cursor) {
+    if (!cursor || !cursor->node) {
+        return NULL;
+    }
+
+    return cursor->elem ? *((void**)cursor->elem) : ((XSet_Node_PT)cursor->node)->key;
+}
+
 bool xset_swap(XSet_PT set1, XSet_PT set2) {
     return xlistrbtree_swap(set1, set2);
 }
@@ -460,6 +610,538 @@ bool xset_is_empty(XSet_PT set) {
     return xlistrbtree_is_empty(set);
 }
 
+/* build a balanced tree with the copies of the sorted "nodes", the elements are shared with the source sets */
+static
+XSet_Node_PT xset_build_nodes_impl(XSet_PT set, XSet_Node_PT parent, XSet_Node_PT *nodes, int lo, int hi, int depth, int red_depth, bool *false_found) {
+    if (hi < lo) {
+        return NULL;
+    }
+
+    {
+        int mid = lo + (hi - lo) / 2;
+
+        XSet_Node_PT node = XMEM_ALLOC_BY(set->allocator, sizeof(*node));
+        if (!node) {
+            *false_found = true;
+            return NULL;
+        }
+
+        if (!xlistrbtree_values_copy(set->allocator, &nodes[mid]->values, &node->values)) {
+            *false_found = true;
+            XMEM_FREE_BY(set->allocator, node, sizeof(*node));
+            return NULL;
+        }
+
+        node->key = nodes[mid]->key;
+        node->node_size = nodes[mid]->node_size;
+        xlistrbtree_node_set_parent(node, parent);
+        xlistrbtree_node_set_color(node, !((0 < depth) && (depth == red_depth)));  /* red : false,  black : true */
+
+        node->left = xset_build_nodes_impl(set, node, nodes, lo, mid - 1, depth + 1, red_depth, false_found);
+        if (!*false_found) {
+            node->right = xset_build_nodes_impl(set, node, nodes, mid + 1, hi, depth + 1, red_depth, false_found);
+        }
+
+        if (*false_found) {
+            xset_free_impl(set, node, false, NULL, NULL);
+            return NULL;
+        }
+
+        node->size = node->node_size + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
+
+        return node;
+    }
+}
+
+static
+XSet_PT xset_new_from_nodes(XSet_PT set, XSet_Node_PT *nodes, int count) {
+    XSet_PT nset = xset_new_allocator(set->cmp, set->cl, set->allocator);
+    if (!nset) {
+        return NULL;
+    }
+
+    {
+        int red_depth = 0;
+        for (int n = count; 1 < n; n /= 2) {
+            ++red_depth;
+        }
+
+        {
+            bool false_found = false;
+            nset->root = xset_build_nodes_impl(nset, NULL, nodes, 0, count - 1, 0, red_depth, &false_found);
+            if (false_found) {
+                xset_free(&nset);
+                return NULL;
+            }
+        }
+    }
+
+    return nset;
+}
+
+/* searching m elements in a set with n elements costs O(mlgN), merging two sets costs O(M + N) */
+static
+bool xset_search_is_cheaper(int m, int n) {
+    int lgn = 1;
+    for (int k = n; 1 < k; k /= 2) {
+        ++lgn;
+    }
+
+    return (long)m * lgn < (long)m + n;
+}
+
+/* node if it's < high (NULL means the max), or NULL */
+static
+XSet_Node_PT xset_range_node(XSet_PT set, XSet_Node_PT node, void *high) {
+    if (!node || !high) {
+        return node;
+    }
+
+    return (set->cmp(node->key, high, set->cl) < 0) ? node : NULL;
+}
+
+/* walk the two sets in order together from node1 and node2 until the elems >= high (NULL means the max),
+*  "nodes" saves the nodes kept (can be NULL if only the number is needed) :
+*    elem only in set1 : kept if "keep1" is true
+*    elem only in set2 : kept if "keep2" is true
+*    elem in both sets : kept if "keep_both" is true, the node of set1 is kept
+*/
+static
+int xset_merge_range_impl(XSet_PT set1, XSet_Node_PT node1, XSet_PT set2, XSet_Node_PT node2, void *high, bool keep1, bool keep2, bool keep_both, XSet_Node_PT *nodes) {
+    int count = 0;
+
+    node1 = xset_range_node(set1, node1, high);
+    node2 = xset_range_node(set2, node2, high);
+
+    while (node1 || node2) {
+        XSet_Node_PT keep = NULL;
+
+        int ret = !node1 ? 1 : (!node2 ? -1 : set1->cmp(node1->key, node2->key, set1->cl));
+        if (ret < 0) {
+            keep = keep1 ? node1 : NULL;
+            node1 = xlistrbtree_next_node(set1, node1);
+        }
+        else if (0 < ret) {
+            keep = keep2 ? node2 : NULL;
+            node2 = xlistrbtree_next_node(set2, node2);
+        }
+        else {
+            keep = keep_both ? node1 : NULL;
+            node1 = xlistrbtree_next_node(set1, node1);
+            node2 = xlistrbtree_next_node(set2, node2);
+        }
+
+        node1 = xset_range_node(set1, node1, high);
+        node2 = xset_range_node(set2, node2, high);
+
+        if (keep) {
+            if (nodes) {
+                nodes[count] = keep;
+            }
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+static
+int xset_merge_nodes_impl(XSet_PT set1, XSet_PT set2, bool keep1, bool keep2, bool keep_both, XSet_Node_PT *nodes) {
+    return xset_merge_range_impl(set1, xlistrbtree_min_impl(set1, set1->root), set2, xlistrbtree_min_impl(set2, set2->root), NULL, keep1, keep2, keep_both, nodes);
+}
+
+/* walk "walk" in order and search each elem in "other" :
+*    node is kept if it's found (keep_found is true) or not found (keep_found is false) in "other"
+*    keep_other is true  : the node of "other" is kept (only for keep_found)
+*    keep_other is false : the node of "walk" is kept
+*/
+static
+int xset_search_nodes_impl(XSet_PT walk, XSet_PT other, bool keep_found, bool keep_other, XSet_Node_PT *nodes) {
+    int count = 0;
+
+    for (XSet_Node_PT node = xlistrbtree_min_impl(walk, walk->root); node; node = xlistrbtree_next_node(walk, node)) {
+        XSet_Node_PT found = xlistrbtree_get_impl(other, other->root, node->key);
+        if (!found == !keep_found) {
+            nodes[count++] = keep_other ? found : node;
+        }
+    }
+
+    return count;
+}
+
+/* node number of the result is not bigger than "capacity" */
+static
+XSet_PT xset_algebra_impl(XSet_PT set1, XSet_PT set2, int capacity, int (*collect)(XSet_PT set1, XSet_PT set2, XSet_Node_PT *nodes)) {
+    xassert(set1);
+    xassert(set2);
+
+    if (!set1 || !set2 || (set1->cmp != set2->cmp)) {
+        return NULL;
+    }
+
+    if (capacity <= 0) {
+        return xset_new_allocator(set1->cmp, set1->cl, set1->allocator);
+    }
+
+    {
+        XSet_Node_PT *nodes = XMEM_MALLOC(capacity * sizeof(XSet_Node_PT));
+        if (!nodes) {
+            return NULL;
+        }
+
+        {
+            XSet_PT nset = xset_new_from_nodes(set1, nodes, collect(set1, set2, nodes));
+            XMEM_FREE(nodes);
+            return nset;
+        }
+    }
+}
+
+static
+int xset_union_nodes(XSet_PT set1, XSet_PT set2, XSet_Node_PT *nodes) {
+    return xset_merge_nodes_impl(set1, set2, true, true, true, nodes);
+}
+
+static
+int xset_inter_nodes(XSet_PT set1, XSet_PT set2, XSet_Node_PT *nodes) {
+    int size1 = xset_size(set1);
+    int size2 = xset_size(set2);
+
+    if (xset_search_is_cheaper(size1, size2)) {
+        return xset_search_nodes_impl(set1, set2, true, false, nodes);
+    }
+    if (xset_search_is_cheaper(size2, size1)) {
+        return xset_search_nodes_impl(set2, set1, true, true, nodes);
+    }
+
+    return xset_merge_nodes_impl(set1, set2, false, false, true, nodes);
+}
+
+static
+int xset_minus_nodes(XSet_PT set1, XSet_PT set2, XSet_Node_PT *nodes) {
+    if (xset_search_is_cheaper(xset_size(set1), xset_size(set2))) {
+        return xset_search_nodes_impl(set1, set2, false, false, nodes);
+    }
+
+    return xset_merge_nodes_impl(set1, set2, true, false, false, nodes);
+}
+
+static
+int xset_diff_nodes(XSet_PT set1, XSet_PT set2, XSet_Node_PT *nodes) {
+    return xset_merge_nodes_impl(set1, set2, true, true, false, nodes);
+}
+
+XSet_PT xset_union(XSet_PT set1, XSet_PT set2) {
+    return xset_algebra_impl(set1, set2, xset_size(set1) + xset_size(set2), xset_union_nodes);
+}
+
+XSet_PT xset_inter(XSet_PT set1, XSet_PT set2) {
+    int size1 = xset_size(set1);
+    int size2 = xset_size(set2);
+
+    return xset_algebra_impl(set1, set2, (size1 < size2) ? size1 : size2, xset_inter_nodes);
+}
+
+XSet_PT xset_minus(XSet_PT set1, XSet_PT set2) {
+    return xset_algebra_impl(set1, set2, xset_size(set1), xset_minus_nodes);
+}
+
+XSet_PT xset_diff(XSet_PT set1, XSet_PT set2) {
+    return xset_algebra_impl(set1, set2, xset_size(set1) + xset_size(set2), xset_diff_nodes);
+}
+
+bool xset_subset(XSet_PT set1, XSet_PT set2) {
+    xassert(set1);
+    xassert(set2);
+
+    if (!set1 || !set2 || (set1->cmp != set2->cmp)) {
+        return false;
+    }
+
+    if (xset_search_is_cheaper(xset_size(set2), xset_size(set1))) {
+        for (XSet_Node_PT node = xlistrbtree_min_impl(set2, set2->root); node; node = xlistrbtree_next_node(set2, node)) {
+            if (!xlistrbtree_get_impl(set1, set1->root, node->key)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* no elem is only in set2 */
+    return xset_merge_nodes_impl(set1, set2, false, true, false, NULL) == 0;
+}
+
+bool xset_equal(XSet_PT set1, XSet_PT set2) {
+    xassert(set1);
+    xassert(set2);
+
+    if (!set1 || !set2 || (set1->cmp != set2->cmp)) {
+        return false;
+    }
+
+    /* no elem is only in one set */
+    return xset_merge_nodes_impl(set1, set2, true, true, false, NULL) == 0;
+}
+
+#if defined(__linux__)
+
+/* a range has XSET_PARALLEL_MIN_RANGE elems at least, and each thread takes XSET_PARALLEL_RANGES_PER_THREAD ranges on average */
+#define XSET_PARALLEL_MIN_RANGE          4096
+#define XSET_PARALLEL_RANGES_PER_THREAD  4
+
+/* the number of the elems < key */
+static
+int xset_less_size_impl(XSet_PT set, void *key) {
+    int k = 0;
+
+    XSet_Node_PT node = set->root;
+    while (node) {
+        if (set->cmp(node->key, key, set->cl) < 0) {
+            k += node->size - (node->right ? node->right->size : 0);
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+
+    return k;
+}
+
+static
+void xset_parallel_free(XSet_Parallel_PT paras) {
+    XMEM_FREE(paras->lows);
+    XMEM_FREE(paras->offsets);
+    XMEM_FREE(paras->counts);
+    XMEM_FREE(paras->nodes);
+    XMEM_FREE(paras);
+}
+
+static
+XSet_Parallel_PT xset_parallel_new(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool) {
+    XSet_Parallel_PT paras = XMEM_CALLOC(1, sizeof(*paras));
+    if (!paras) {
+        return NULL;
+    }
+
+    {
+        /* the caller does the ranges too */
+        int threads = (pool ? xsthreadpool_num_threads_alive(pool) : 0) + 1;
+        int size1 = xset_size(set1);
+        int size2 = xset_size(set2);
+        int ranges = (size1 + size2) / XSET_PARALLEL_MIN_RANGE;
+
+        if (threads * XSET_PARALLEL_RANGES_PER_THREAD < ranges) {
+            ranges = threads * XSET_PARALLEL_RANGES_PER_THREAD;
+        }
+
+        paras->set1 = set1;
+        paras->set2 = set2;
+        paras->ranges = (ranges < 1) ? 1 : ranges;
+        paras->refs = 1;
+
+        paras->lows = XMEM_CALLOC(paras->ranges + 1, sizeof(void*));
+        paras->offsets = XMEM_CALLOC(paras->ranges, sizeof(int));
+        paras->counts = XMEM_CALLOC(paras->ranges, sizeof(int));
+        paras->nodes = XMEM_MALLOC((size1 + size2) * sizeof(XSet_Node_PT));
+        if (!paras->lows || !paras->offsets || !paras->counts || !paras->nodes) {
+            xset_parallel_free(paras);
+            return NULL;
+        }
+
+        /* the bounds are selected from the bigger set by rank, lows[0] and lows[ranges] stay NULL */
+        {
+            XSet_PT big = (size1 < size2) ? set2 : set1;
+            int size = (size1 < size2) ? size2 : size1;
+
+            for (int i = 1; i < paras->ranges; ++i) {
+                paras->lows[i] = xlistrbtree_select_impl(big, big->root, (int)((long long)size * i / paras->ranges))->key;
+            }
+        }
+    }
+
+    if (pthread_mutex_init(&paras->lock, NULL) != 0) {
+        xset_parallel_free(paras);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&paras->all_done, NULL) != 0) {
+        pthread_mutex_destroy(&paras->lock);
+        xset_parallel_free(paras);
+        return NULL;
+    }
+
+    return paras;
+}
+
+static
+void xset_parallel_release(XSet_Parallel_PT paras) {
+    bool last = false;
+
+    pthread_mutex_lock(&paras->lock);
+    last = (--paras->refs == 0);
+    pthread_mutex_unlock(&paras->lock);
+
+    if (last) {
+        pthread_cond_destroy(&paras->all_done);
+        pthread_mutex_destroy(&paras->lock);
+        xset_parallel_free(paras);
+    }
+}
+
+static
+void xset_parallel_do_range(XSet_Parallel_PT paras, int range) {
+    XSet_PT set1 = paras->set1;
+    XSet_PT set2 = paras->set2;
+    void *low = paras->lows[range];
+    void *high = paras->lows[range + 1];
+
+    XSet_Node_PT node1 = low ? xlistrbtree_ceiling_impl(set1, set1->root, low) : xlistrbtree_min_impl(set1, set1->root);
+    XSet_Node_PT node2 = low ? xlistrbtree_ceiling_impl(set2, set2->root, low) : xlistrbtree_min_impl(set2, set2->root);
+    int offset = low ? (xset_less_size_impl(set1, low) + xset_less_size_impl(set2, low)) : 0;
+
+    int count = xset_merge_range_impl(set1, node1, set2, node2, high, paras->keep1, paras->keep2, paras->keep_both, paras->nodes + offset);
+
+    pthread_mutex_lock(&paras->lock);
+    paras->offsets[range] = offset;
+    paras->counts[range] = count;
+    if (++paras->done == paras->ranges) {
+        pthread_cond_broadcast(&paras->all_done);
+    }
+    pthread_mutex_unlock(&paras->lock);
+}
+
+static
+void xset_parallel_do_ranges(XSet_Parallel_PT paras) {
+    while (true) {
+        int range = -1;
+
+        pthread_mutex_lock(&paras->lock);
+        if (paras->next < paras->ranges) {
+            range = paras->next++;
+        }
+        pthread_mutex_unlock(&paras->lock);
+
+        if (range < 0) {
+            return;
+        }
+
+        xset_parallel_do_range(paras, range);
+    }
+}
+
+static
+void xset_parallel_job(void *arg) {
+    XSet_Parallel_PT paras = (XSet_Parallel_PT)arg;
+
+    xset_parallel_do_ranges(paras);
+    xset_parallel_release(paras);
+}
+
+/* add jobs to the pool, do the ranges together with them, then wait until all the ranges are done */
+static
+void xset_parallel_run(XSet_Parallel_PT paras, XSThreadPool_PT pool) {
+    int jobs = pool ? xsthreadpool_num_threads_alive(pool) : 0;
+    if (paras->ranges - 1 < jobs) {
+        jobs = paras->ranges - 1;
+    }
+
+    for (int i = 0; i < jobs; ++i) {
+        pthread_mutex_lock(&paras->lock);
+        ++paras->refs;
+        pthread_mutex_unlock(&paras->lock);
+
+        if (!xsthreadpool_add_work(pool, xset_parallel_job, (void*)paras)) {
+            /* the caller still holds its own reference here */
+            pthread_mutex_lock(&paras->lock);
+            --paras->refs;
+            pthread_mutex_unlock(&paras->lock);
+            break;
+        }
+    }
+
+    xset_parallel_do_ranges(paras);
+
+    pthread_mutex_lock(&paras->lock);
+    while (paras->done < paras->ranges) {
+        pthread_cond_wait(&paras->all_done, &paras->lock);
+    }
+    pthread_mutex_unlock(&paras->lock);
+}
+
+static
+XSet_PT xset_parallel_algebra_impl(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool, bool keep1, bool keep2, bool keep_both) {
+    xassert(set1);
+    xassert(set2);
+
+    if (!set1 || !set2 || (set1->cmp != set2->cmp)) {
+        return NULL;
+    }
+
+    if (!set1->root && !set2->root) {
+        return xset_new_allocator(set1->cmp, set1->cl, set1->allocator);
+    }
+
+    {
+        XSet_PT nset = NULL;
+        int count = 0;
+
+        XSet_Parallel_PT paras = xset_parallel_new(set1, set2, pool);
+        if (!paras) {
+            return NULL;
+        }
+
+        paras->keep1 = keep1;
+        paras->keep2 = keep2;
+        paras->keep_both = keep_both;
+
+        xset_parallel_run(paras, pool);
+
+        /* concatenate the nodes of the ranges from min to max */
+        for (int i = 0; i < paras->ranges; ++i) {
+            memmove(paras->nodes + count, paras->nodes + paras->offsets[i], paras->counts[i] * sizeof(XSet_Node_PT));
+            count += paras->counts[i];
+        }
+
+        nset = xset_new_from_nodes(set1, paras->nodes, count);
+        xset_parallel_release(paras);
+
+        return nset;
+    }
+}
+
+XSet_PT xset_parallel_union(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool) {
+    return xset_parallel_algebra_impl(set1, set2, pool, true, true, true);
+}
+
+XSet_PT xset_parallel_inter(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool) {
+    if (set1 && set2) {
+        int size1 = xset_size(set1);
+        int size2 = xset_size(set2);
+
+        if (xset_search_is_cheaper(size1, size2) || xset_search_is_cheaper(size2, size1)) {
+            return xset_inter(set1, set2);
+        }
+    }
+
+    return xset_parallel_algebra_impl(set1, set2, pool, false, false, true);
+}
+
+XSet_PT xset_parallel_minus(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool) {
+    if (set1 && set2 && xset_search_is_cheaper(xset_size(set1), xset_size(set2))) {
+        return xset_minus(set1, set2);
+    }
+
+    return xset_parallel_algebra_impl(set1, set2, pool, true, false, false);
+}
+
+XSet_PT xset_parallel_diff(XSet_PT set1, XSet_PT set2, XSThreadPool_PT pool) {
+    return xset_parallel_algebra_impl(set1, set2, pool, true, true, false);
+}
+
+#endif
+
 #if 0
 XHashSet_PT xhashset_union(XHashSet_PT s, XHashSet_PT t) {
     xassert(s && t);
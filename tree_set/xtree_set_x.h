@@ -35,4 +35,38 @@ extern int       xset_repeat_elems_size_except     (XSet_PT set, void *elem);
 /* O(lgN) */
 extern void*     xset_get                          (XSet_PT set, void *elem);
 
+#if defined(__linux__)
+#include <pthread.h>
+
+/* shared by the caller and the jobs of xset_parallel_union, xset_parallel_inter, xset_parallel_minus and xset_parallel_diff,
+ * range i holds the elems in [lows[i], lows[i + 1]) of both sets (NULL means no bound), it saves its nodes
+ * from nodes[offsets[i]] which is the number of the elems < lows[i] in both sets, so the ranges never overlap
+ */
+typedef struct XSet_Parallel  XSet_Parallel_T;
+typedef struct XSet_Parallel* XSet_Parallel_PT;
+
+struct XSet_Parallel {
+    XSet_PT         set1;
+    XSet_PT         set2;
+
+    /* the same as xset_merge_nodes_impl */
+    bool            keep1;
+    bool            keep2;
+    bool            keep_both;
+
+    void          **lows;       /* ranges + 1 keys */
+    int            *offsets;
+    int            *counts;     /* the count of the nodes saved by each range */
+    XSet_Node_PT   *nodes;
+
+    int             ranges;
+    int             next;       /* the next range to be taken */
+    int             done;       /* the count of the finished ranges */
+    int             refs;       /* the caller and the jobs not finished, the last one frees it */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  all_done;
+};
+#endif
+
 #endif
@@ -28,6 +28,31 @@ static const int xutils_hash_primes[] =
     50331653,   100663319
 };
 
+#ifdef XHASH_BUCKETS_POWER_OF_2
+
+static const int xutils_hash_min_buckets_num = 64;
+static const int xutils_hash_max_buckets_num = 1 << 27;
+
+int xutils_hash_buckets_num(int hint) {
+    int num = xutils_hash_min_buckets_num;
+    while ((num < hint) && (num < xutils_hash_max_buckets_num)) {
+        num <<= 1;
+    }
+
+    return num;
+}
+
+int xutils_max_hash_buckets_size(void) {
+    return xutils_hash_max_buckets_num;
+}
+
+/* buckets_num is power of 2 : no division here */
+int xutils_hash_bucket_index(int hash, int buckets_num) {
+    return (int)(xutils_hash_mix32((unsigned int)hash) & (unsigned int)(buckets_num - 1));
+}
+
+#else
+
 int xutils_hash_buckets_num(int hint) {
     int i = 1;
     for (; ((i - 1) < xutils_hash_primes_num) && xutils_hash_primes[i - 1] < hint; ) {
@@ -44,6 +69,12 @@ int xutils_max_hash_buckets_size(void) {
     return xutils_hash_primes[xutils_hash_primes_num - 1];
 }
 
+int xutils_hash_bucket_index(int hash, int buckets_num) {
+    return (int)((unsigned int)hash % (unsigned int)buckets_num);
+}
+
+#endif
+
 int xutils_pointer_equal(void *x, void *y, void *cl) {
     return x == y ? 0 : 1;
 }
@@ -77,36 +108,177 @@ int xutils_hash_generic(void *key) {
     return val;
 }
 
-int xutils_hash_pointer(void *pointer) {
-    return (int)((unsigned long long)(pointer) >> 3);
+/* wyhash final version 4 : https://github.com/wangyi-fudan/wyhash (public domain) */
+static const uint64_t xutils_wyp[4] = { 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL };
+
+static
+void xutils_wymum(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = *a;
+    r *= *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
 }
 
-int xutils_hash_int(int m) {
-    return m;
+static
+uint64_t xutils_wymix(uint64_t a, uint64_t b) {
+    xutils_wymum(&a, &b);
+    return a ^ b;
 }
 
-int xutils_hash_float(float m) {
-    return 1;
+static
+uint64_t xutils_wyr8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
 }
 
-/* SGI STL stl_hash_fun.h */
-int xutils_hash_string(char* str)
-{
-    int h = 0;
-    for (; *str; ++str) {
-        h = 5 * h + *str;
+static
+uint64_t xutils_wyr4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static
+uint64_t xutils_wyr3(const uint8_t *p, size_t k) {
+    return (((uint64_t)p[0]) << 16) | (((uint64_t)p[k >> 1]) << 8) | p[k - 1];
+}
+
+uint64_t xutils_hash64_bytes(const void *key, int len, uint64_t seed) {
+    const uint8_t *p = (const uint8_t*)key;
+    size_t n = (0 < len) ? (size_t)len : 0;
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    seed ^= xutils_wymix(seed ^ xutils_wyp[0], xutils_wyp[1]);
+
+    if (n <= 16) {
+        if (4 <= n) {
+            a = (xutils_wyr4(p) << 32) | xutils_wyr4(p + ((n >> 3) << 2));
+            b = (xutils_wyr4(p + n - 4) << 32) | xutils_wyr4(p + n - 4 - ((n >> 3) << 2));
+        }
+        else if (0 < n) {
+            a = xutils_wyr3(p, n);
+        }
+    }
+    else {
+        size_t i = n;
+
+        if (48 < i) {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+
+            do {
+                seed = xutils_wymix(xutils_wyr8(p) ^ xutils_wyp[1], xutils_wyr8(p + 8) ^ seed);
+                see1 = xutils_wymix(xutils_wyr8(p + 16) ^ xutils_wyp[2], xutils_wyr8(p + 24) ^ see1);
+                see2 = xutils_wymix(xutils_wyr8(p + 32) ^ xutils_wyp[3], xutils_wyr8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (48 < i);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (16 < i) {
+            seed = xutils_wymix(xutils_wyr8(p) ^ xutils_wyp[1], xutils_wyr8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+
+        a = xutils_wyr8(p + i - 16);
+        b = xutils_wyr8(p + i - 8);
     }
 
+    a ^= xutils_wyp[1];
+    b ^= seed;
+    xutils_wymum(&a, &b);
+
+    return xutils_wymix(a ^ xutils_wyp[0] ^ n, b ^ xutils_wyp[1]);
+}
+
+uint64_t xutils_hash64_string(const char *str, uint64_t seed) {
+    return xutils_hash64_bytes(str, (int)strlen(str), seed);
+}
+
+uint64_t xutils_hash64_int(int64_t m, uint64_t seed) {
+    return xutils_wymix((uint64_t)m ^ xutils_wyp[0], seed ^ xutils_wyp[1]);
+}
+
+uint64_t xutils_hash64_float(float f, uint64_t seed) {
+    return xutils_hash64_double((double)f, seed);
+}
+
+uint64_t xutils_hash64_double(double d, uint64_t seed) {
+    uint64_t bits = 0;
+
+    /* 0.0 == -0.0, so they must have the same hash value */
+    if (d == 0.0) {
+        d = 0.0;
+    }
+
+    memcpy(&bits, &d, sizeof(bits));
+    return xutils_wymix(bits ^ xutils_wyp[0], seed ^ xutils_wyp[1]);
+}
+
+uint64_t xutils_hash64_pointer(void *pointer, uint64_t seed) {
+    return xutils_wymix((uint64_t)(uintptr_t)pointer ^ xutils_wyp[0], seed ^ xutils_wyp[1]);
+}
+
+/* lowbias32 : https://nullprogram.com/blog/2018/07/31/ */
+unsigned int xutils_hash_mix32(unsigned int h) {
+    h ^= h >> 16;
+    h *= 0x7feb352dU;
+    h ^= h >> 15;
+    h *= 0x846ca68bU;
+    h ^= h >> 16;
+
     return h;
 }
 
+/* fold the 64 bits hash value into a not negative int */
+static
+int xutils_hash_fold(uint64_t h) {
+    return (int)((h ^ (h >> 32)) & INT_MAX);
+}
+
+int xutils_hash_pointer(void *pointer) {
+    return xutils_hash_fold(xutils_hash64_pointer(pointer, XUTILS_HASH_DEFAULT_SEED));
+}
+
+int xutils_hash_int(int m) {
+    return xutils_hash_fold(xutils_hash64_int(m, XUTILS_HASH_DEFAULT_SEED));
+}
+
+int xutils_hash_float(float f) {
+    return xutils_hash_fold(xutils_hash64_float(f, XUTILS_HASH_DEFAULT_SEED));
+}
+
+int xutils_hash_double(double d) {
+    return xutils_hash_fold(xutils_hash64_double(d, XUTILS_HASH_DEFAULT_SEED));
+}
+
+int xutils_hash_string(char* str) {
+    return xutils_hash_fold(xutils_hash64_string(str, XUTILS_HASH_DEFAULT_SEED));
+}
+
+/* hash at most len chars, stop at '\0' */
 int xutils_hash_const_chars(const char *str, int len) {
-    int h = 0;
-    for (int i = 0; (i < len) && (*str); ++i, ++str) {
-        h = 5 * h + *str;
+    int n = 0;
+    while ((n < len) && str[n]) {
+        ++n;
     }
 
-    return h;
+    return xutils_hash_fold(xutils_hash64_bytes(str, n, XUTILS_HASH_DEFAULT_SEED));
 }
 
 bool xutils_generic_swap(void* x, void* y, int size) {
@@ -14,10 +14,20 @@
 #define XUTILS_INCLUDED
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /* TODO ? : put all below variables into one config file ?? */
 static const int XUTILS_HASH_SLOTS_DEFAULT_HINT      = 6151;
 
+/* Used by incremental resize of hash tables : not empty buckets moved by each put/get/remove,
+ * and at most XUTILS_HASH_REHASH_EMPTY_VISITS times of it empty buckets are skipped
+ */
+static const int XUTILS_HASH_REHASH_STEPS            = 1;
+static const int XUTILS_HASH_REHASH_EMPTY_VISITS     = 10;
+
+/* Used by xxx_get_many/find_many/put_many of hash tables : keys hashed and prefetched together in one batch */
+#define XUTILS_HASH_BATCH_SIZE                         16
+
 static const int XUTILS_MEM_EXPAND_DEFAULT_LENGTH    = 4096;
 
 static const int XUTILS_ARRAY_DEFAULT_LENGTH         = 4096;
@@ -37,6 +47,16 @@ static const int XUTILS_UNLIMITED_BASED_ON_POWER_2   = 64;
 /* Used by xarena.c */
 static const int XUTILS_ARENA_MIN_ALIGN_SIZE         = 8;
 static const int XUTILS_ARENA_MAX_BYTES              = 512;
+static const int XUTILS_ARENA_CACHE_BATCH            = 32;   /* objects moved between a thread cache and the shared free list at once */
+static const int XUTILS_ARENA_CACHE_MAX              = 64;   /* objects of one size kept by a thread cache at most */
+static const int XUTILS_ARENA_REGION_CHUNK_BYTES     = 16384;
+
+/* Used by xmem_slab.c */
+static const int XUTILS_SLAB_MIN_OBJS                = 4;
+static const int XUTILS_SLAB_MAX_BYTES               = 65536;
+
+/* default seed of the 64 bits hash family xutils_hash64_xxx */
+static const uint64_t XUTILS_HASH_DEFAULT_SEED       = 0x243f6a8885a308d3ULL;
 
 /* strategy used when add new element to sequence/queue/deque... */
 static const int XUTILS_QUEUE_STRATEGY_DISCARD_NEW   = 0;
@@ -44,8 +64,20 @@ static const int XUTILS_QUEUE_STRATEGY_DISCARD_FRONT = 1;
 static const int XUTILS_QUEUE_STRATEGY_DISCARD_BACK  = 2;
 static const int XUTILS_QUEUE_STRATEGY_DISCARD_TOP   = 3;
 
+/* load the cache line of addr in advance, do nothing if the compiler does not support it */
+#if defined(__GNUC__) || defined(__clang__)
+#define XUTILS_PREFETCH(addr)      __builtin_prefetch((const void*)(addr))
+#else
+#define XUTILS_PREFETCH(addr)      ((void)(addr))
+#endif
+
+/* macro definition :
+ *   XHASH_BUCKETS_POWER_OF_2 : bucket numbers are power of 2 and bucket index is picked by a final mixer + mask,
+ *                              otherwise bucket numbers are primes and bucket index is "hash % buckets number"
+ */
 extern int       xutils_hash_buckets_num (int hint);
 extern int       xutils_max_hash_buckets_size(void);
+extern int       xutils_hash_bucket_index(int hash, int buckets_num);
 
 extern int       xutils_pointer_equal    (void *x, void *y, void *cl);
 
@@ -55,14 +87,27 @@ extern bool      xutils_match            (void *x, void *y);
 
 extern int       xutils_hash_atom        (void *x);
 
+/* all below hash values are not negative */
 extern int       xutils_hash_int         (int m);
 extern int       xutils_hash_float       (float f);
+extern int       xutils_hash_double      (double d);
 extern int       xutils_hash_string      (char* str);
 extern int       xutils_hash_const_chars (const char *str, int len);
 extern int       xutils_hash_generic     (void *key);
 
 extern int       xutils_hash_pointer     (void *pointer);
 
+/* seeded 64 bits hash family (wyhash), read 8 bytes each time */
+extern uint64_t  xutils_hash64_bytes     (const void *key, int len, uint64_t seed);
+extern uint64_t  xutils_hash64_string    (const char *str, uint64_t seed);
+extern uint64_t  xutils_hash64_int       (int64_t m, uint64_t seed);
+extern uint64_t  xutils_hash64_float     (float f, uint64_t seed);
+extern uint64_t  xutils_hash64_double    (double d, uint64_t seed);
+extern uint64_t  xutils_hash64_pointer   (void *pointer, uint64_t seed);
+
+/* final mixer : every bit of h affects all bits of the result */
+extern unsigned int xutils_hash_mix32    (unsigned int h);
+
 extern bool      xutils_generic_swap     (void *x, void *y, int size);
 
 extern void*     xutils_deep_copy        (void* source, int size);